@@ -0,0 +1,94 @@
+/*******************************************************************************
+  Derived Quantities Benchmark
+
+  File Name:
+    bench_app_meteo.cpp
+
+  Summary:
+    Measures APP_METEO_Compute per sample, against the same formulas in libm.
+
+  Description:
+    Both run over a table of samples across -40..85 degC, 1..100 %RH and
+    300..1100 hPa. The times are those of the host, which computes doubles
+    in hardware, so libm comes out the faster here. They compare the two on
+    the host only, and say nothing of the cycles either takes on the board.
+*******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <math.h>
+
+#include "definitions.h"
+#include "app_meteo.h"
+
+namespace
+{
+
+constexpr size_t kSamples = 256U;
+
+struct Sample
+{
+    int32_t temperature;
+    uint32_t pressure;
+    uint32_t humidity;
+};
+
+Sample samples[kSamples];
+
+void SamplesFill( void )
+{
+    for (size_t i = 0U; i < kSamples; i++)
+    {
+        samples[i].temperature = -4000 + (int32_t)((i * 12500U) / kSamples);
+        samples[i].pressure = (30000U * 256U) + (uint32_t)((i * 80000U * 256U) / kSamples);
+        /* the humidity steps in another order than the temperature */
+        samples[i].humidity = 1024U + (uint32_t)((((i * 37U) % kSamples) * 99U * 1024U) / kSamples);
+    }
+}
+
+void BM_MeteoCompute(benchmark::State& state)
+{
+    APP_METEO_DATA derived;
+
+    SamplesFill();
+    APP_METEO_Initialize();
+
+    for (auto _ : state)
+    {
+        for (const Sample& sample : samples)
+        {
+            APP_METEO_Compute(sample.temperature, sample.pressure, sample.humidity, &derived);
+            benchmark::DoNotOptimize(derived);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t)kSamples);
+}
+BENCHMARK(BM_MeteoCompute);
+
+void BM_MeteoComputeLibm(benchmark::State& state)
+{
+    double derived[4];
+
+    SamplesFill();
+
+    for (auto _ : state)
+    {
+        for (const Sample& sample : samples)
+        {
+            double t = (double)sample.temperature / 100.0;
+            double p = (double)sample.pressure / 256.0;
+            double gamma = log((double)sample.humidity / 102400.0) + ((17.62 * t) / (243.12 + t));
+
+            derived[0] = (243.12 * gamma) / (17.62 - gamma);
+            derived[1] = (611.2 * exp(gamma) * 1.0e6) / (461.5 * (t + 273.15));
+            derived[2] = 44330.77 * (1.0 - pow(p / 101325.0, 0.190263));
+            derived[3] = p * pow(1.0 - ((double)APP_METEO_STATION_ALTITUDE_M / 44330.77), -5.25588);
+            benchmark::DoNotOptimize(derived);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t)kSamples);
+}
+BENCHMARK(BM_MeteoComputeLibm);
+
+}
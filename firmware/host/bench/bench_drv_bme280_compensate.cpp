@@ -0,0 +1,97 @@
+/*******************************************************************************
+  BME280 Compensation Benchmark
+
+  File Name:
+    bench_drv_bme280_compensate.cpp
+
+  Summary:
+    Measures the compensation routines of drv_bme280_compensate.c.
+
+  Description:
+    Each routine runs over a table of raw readings that sweeps the range of
+    the sensor, with the calibration of the BMP280 datasheet example. The
+    times are those of the host, which divides 64-bit integers in hardware,
+    and the 64-bit pressure comes out faster than the 32-bit one here. They
+    do not rank the routines for the board, whose cycles are only measured
+    there, by DRV_BME280_CompensationCyclesGet.
+*******************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "definitions.h"
+
+namespace
+{
+
+constexpr size_t kReadings = 256U;
+
+const DRV_BME280_COMPENSATION_DATA datasheet =
+{
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+    75, 362, 0, 313, 50, 30, 0
+};
+
+DRV_BME280_UNCOMP_DATA readings[kReadings];
+
+/* Raw readings of about -40..85 degC, 300..1100 hPa and 0..100 %RH */
+void ReadingsFill( void )
+{
+    for (size_t i = 0U; i < kReadings; i++)
+    {
+        readings[i].temperature = 0x4E000U + (uint32_t)((i * 0x62000U) / kReadings);
+        readings[i].pressure = 0x30000U + (uint32_t)((i * 0x90000U) / kReadings);
+        readings[i].humidity = 0x4000U + (uint32_t)((i * 0x8000U) / kReadings);
+    }
+}
+
+/* Runs compensate over the readings, after the temperature of each has set
+ * t_fine */
+template <typename Result>
+void CompensateRun( benchmark::State& state, Result (*compensate)(DRV_BME280_UNCOMP_DATA*, DRV_BME280_COMPENSATION_DATA*) )
+{
+    DRV_BME280_COMPENSATION_DATA calib[kReadings];
+
+    ReadingsFill();
+
+    for (size_t i = 0U; i < kReadings; i++)
+    {
+        calib[i] = datasheet;
+        (void) _DRV_BME280_Compensate_T(&readings[i], &calib[i]);
+    }
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0U; i < kReadings; i++)
+        {
+            benchmark::DoNotOptimize(compensate(&readings[i], &calib[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t)kReadings);
+}
+
+void BM_CompensateT(benchmark::State& state)
+{
+    CompensateRun(state, _DRV_BME280_Compensate_T);
+}
+BENCHMARK(BM_CompensateT);
+
+void BM_CompensateP(benchmark::State& state)
+{
+    CompensateRun(state, _DRV_BME280_Compensate_P);
+}
+BENCHMARK(BM_CompensateP);
+
+void BM_CompensateP64(benchmark::State& state)
+{
+    CompensateRun(state, _DRV_BME280_Compensate_P64);
+}
+BENCHMARK(BM_CompensateP64);
+
+void BM_CompensateH(benchmark::State& state)
+{
+    CompensateRun(state, _DRV_BME280_Compensate_H);
+}
+BENCHMARK(BM_CompensateH);
+
+}
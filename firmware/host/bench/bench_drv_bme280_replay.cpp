@@ -0,0 +1,169 @@
+/*******************************************************************************
+  BME280 Trace Replay Benchmark
+
+  File Name:
+    bench_drv_bme280_replay.cpp
+
+  Summary:
+    Measures how fast drv_bme280.c consumes a recording.
+
+  Description:
+    The driver runs on drv_bme280_replay.c, which completes each transaction
+    on its next task rather than after its bus time, so the rate measured is
+    that of the driver's own parsing, compensation and state machine on the
+    host. A sample is a read started by the client, served by the replay and
+    compensated by the driver.
+*******************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "definitions.h"
+#include "driver/bme280/drv_bme280_replay.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" const DRV_BME280_INIT gDrvBME280InitObj[1];
+
+namespace
+{
+
+const DRV_BME280_PLIB_INTERFACE replayInterface =
+{
+    .writeRead = (DRV_BME280_PLIB_WRITE_READ) DRV_BME280_REPLAY_I2C_WriteRead,
+    .write = (DRV_BME280_PLIB_WRITE) DRV_BME280_REPLAY_I2C_Write,
+    .read = (DRV_BME280_PLIB_READ) DRV_BME280_REPLAY_I2C_Read,
+    .errorGet = (DRV_BME280_PLIB_ERROR_GET) DRV_BME280_REPLAY_I2C_ErrorGet,
+    .callbackRegister = (DRV_BME280_PLIB_CALLBACK_REGISTER) DRV_BME280_REPLAY_I2C_CallbackRegister,
+    .transferSetup = (DRV_BME280_PLIB_TRANSFER_SETUP) DRV_BME280_REPLAY_I2C_TransferSetup,
+};
+
+/* The calibration of the BMP280 datasheet example, and readings that sweep
+ * the temperature, pressure and humidity ranges */
+constexpr size_t kReadings = 256U;
+
+DRV_BME280_REPLAY_RECORD recording[4U + kReadings] =
+{
+    { 0U, 0x88U, 6U, { 0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC } },
+    { 0U, 0x8EU, 18U, { 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B, 0x8C, 0x00,
+                        0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17 } },
+    { 0U, 0xA1U, 1U, { 0x4B } },
+    { 0U, 0xE1U, 7U, { 0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E } },
+};
+
+SYS_MODULE_OBJ bme280Object;
+DRV_HANDLE bme280Handle = DRV_HANDLE_INVALID;
+volatile uint32_t completions;
+
+void Bme280Event( DRV_BME280_TRANSFER_STATUS status, uintptr_t context )
+{
+    (void) status;
+    (void) context;
+    completions++;
+}
+
+void RecordingFill( void )
+{
+    for (size_t i = 0U; i < kReadings; i++)
+    {
+        DRV_BME280_REPLAY_RECORD* record = &recording[4U + i];
+        uint32_t pressure = 0x40000U + (uint32_t)((i * 0x60000U) / kReadings);
+        uint32_t temperature = 0x60000U + (uint32_t)((i * 0x30000U) / kReadings);
+        uint32_t humidity = 0x4000U + (uint32_t)((i * 0x6000U) / kReadings);
+
+        record->timestamp = i;
+        record->reg = 0xF7U;
+        record->length = 8U;
+        record->data[0] = (uint8_t)(pressure >> 12);
+        record->data[1] = (uint8_t)(pressure >> 4);
+        record->data[2] = (uint8_t)(pressure << 4);
+        record->data[3] = (uint8_t)(temperature >> 12);
+        record->data[4] = (uint8_t)(temperature >> 4);
+        record->data[5] = (uint8_t)(temperature << 4);
+        record->data[6] = (uint8_t)(humidity >> 8);
+        record->data[7] = (uint8_t)humidity;
+    }
+}
+
+/* The firmware initializes once per process, so the first run of the
+ * benchmark brings the driver up */
+bool Bme280Open( void )
+{
+    DRV_BME280_INIT init = gDrvBME280InitObj[0];
+    uint32_t passes;
+
+    if (bme280Handle != DRV_HANDLE_INVALID)
+    {
+        return true;
+    }
+
+    HOST_Reset();
+    TC0_TimerInitialize();
+    (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+    init.plibInterface = &replayInterface;
+    bme280Object = DRV_BME280_Initialize(DRV_BME280_INSTANCE_0, (SYS_MODULE_INIT*)&init);
+    RecordingFill();
+    DRV_BME280_REPLAY_RecordsSet(recording, sizeof(recording) / sizeof(recording[0]));
+    NVIC_Initialize();
+
+    for (passes = 0U; (passes < 100U) && (DRV_BME280_Status(DRV_BME280_INSTANCE_0) != SYS_STATUS_READY); passes++)
+    {
+        DRV_BME280_REPLAY_Tasks();
+        DRV_BME280_Tasks(bme280Object);
+    }
+
+    bme280Handle = DRV_BME280_Open(DRV_BME280_INSTANCE_0, DRV_IO_INTENT_READWRITE);
+
+    if (bme280Handle == DRV_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    DRV_BME280_ClientEventHandlerSet(bme280Handle, Bme280Event, 0U);
+
+    return true;
+}
+
+void BM_ReplayedSample(benchmark::State& state)
+{
+    int32_t temperature;
+    uint32_t pressure;
+    uint32_t humidity;
+
+    if (Bme280Open() == false)
+    {
+        state.SkipWithError("the driver did not come up on the recording");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        uint32_t done = completions;
+
+        /* start over before the replay runs out of readings */
+        if (DRV_BME280_REPLAY_IsComplete() == true)
+        {
+            DRV_BME280_REPLAY_RecordsSet(recording, sizeof(recording) / sizeof(recording[0]));
+        }
+
+        (void) DRV_BME280_Read(bme280Handle);
+
+        while (completions == done)
+        {
+            DRV_BME280_REPLAY_Tasks();
+            DRV_BME280_Tasks(bme280Object);
+        }
+
+        (void) DRV_BME280_Get_Temperature(bme280Handle, &temperature);
+        (void) DRV_BME280_Get_Pressure(bme280Handle, &pressure);
+        (void) DRV_BME280_Get_Humidity(bme280Handle, &humidity);
+        benchmark::DoNotOptimize(temperature);
+        benchmark::DoNotOptimize(pressure);
+        benchmark::DoNotOptimize(humidity);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplayedSample);
+
+}
@@ -0,0 +1,230 @@
+/*******************************************************************************
+  SD Card Driver Write Benchmark
+
+  File Name:
+    bench_drv_sdmmc.cpp
+
+  Summary:
+    Measures the writes of drv_sdmmc.c on the simulated card, with and
+    without write merging.
+
+  Description:
+    Each iteration writes a run of adjacent blocks as DRV_SDMMC_QUEUE_SIZE_IDX0
+    requests, each from its own buffer. Queued together, the driver merges
+    them into one multi-block write that gathers the buffers through the
+    ADMA2 descriptor table. One at a time, each request waits for the one
+    before it and goes out as a write of its own, as it would with merging
+    off.
+
+    The times are those of the card model of plib_sdhc1_regs_sim.c, in
+    virtual time: the bus clock, the busy time of the card after each write
+    and the command overhead. The rate is reported through manual time, and
+    latency_us is the time from the queueing of a request to its completion
+    event, averaged over the requests. card_writes counts the write commands
+    per run, and descriptor_lines the most ADMA2 lines a write used.
+*******************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" const DRV_SDMMC_INIT drvSDMMC0InitData;
+
+namespace
+{
+
+constexpr uint32_t kBlockSize = 512U;
+constexpr uint32_t kCardBlocks = 65536U;
+constexpr uint32_t kRequests = DRV_SDMMC_QUEUE_SIZE_IDX0;
+constexpr uint32_t kMaxBlocks = 32U;
+constexpr uint64_t kPassNs = HOST_NS_PER_US;
+
+/* A block apart, so that no two buffers follow each other in memory */
+CACHE_ALIGN uint8_t buffers[kRequests][(kMaxBlocks + 1U) * kBlockSize];
+
+SYS_MODULE_OBJ sdmmcObject;
+DRV_HANDLE sdmmcHandle = DRV_HANDLE_INVALID;
+
+DRV_SDMMC_COMMAND_HANDLE commands[kRequests];
+uint64_t queuedNs[kRequests];
+uint64_t doneNs[kRequests];
+uint32_t completed;
+uint32_t failed;
+
+void Tasks( void )
+{
+    DRV_SDMMC_Tasks(sdmmcObject);
+}
+
+void SdmmcEvent( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    (void) context;
+
+    for (uint32_t i = 0U; i < kRequests; i++)
+    {
+        if (commands[i] == commandHandle)
+        {
+            doneNs[i] = HOST_TimeGet();
+        }
+    }
+
+    if (event == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE)
+    {
+        completed++;
+    }
+    else
+    {
+        failed++;
+    }
+}
+
+/* The firmware initializes once per process, so the first run of a
+ * benchmark brings the card up */
+bool SdmmcOpen( void )
+{
+    uint64_t until;
+
+    if (sdmmcHandle != DRV_HANDLE_INVALID)
+    {
+        return true;
+    }
+
+    HOST_Reset();
+    HOST_SDCARD_Create(kCardBlocks, true);
+    HOST_SDCARD_Insert();
+
+    TC0_TimerInitialize();
+    (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+    SDHC1_Initialize();
+    sdmmcObject = DRV_SDMMC_Initialize(DRV_SDMMC_INDEX_0, (SYS_MODULE_INIT*)&drvSDMMC0InitData);
+    NVIC_Initialize();
+
+    sdmmcHandle = DRV_SDMMC_Open(DRV_SDMMC_INDEX_0, DRV_IO_INTENT_READWRITE);
+    if (sdmmcHandle == DRV_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    DRV_SDMMC_EventHandlerSet(sdmmcHandle, (const void*)SdmmcEvent, 0);
+
+    for (until = HOST_TimeGet() + HOST_NS_PER_S; HOST_TimeGet() < until; )
+    {
+        if (DRV_SDMMC_IsAttached(sdmmcHandle) == true)
+        {
+            return true;
+        }
+
+        HOST_Run(Tasks, HOST_TimeGet() + HOST_NS_PER_MS, 10U * kPassNs);
+    }
+
+    return false;
+}
+
+/* Runs the tasks until count requests have ended, at most for a second */
+bool WaitFor( uint32_t count )
+{
+    uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+    while ((completed + failed) < count)
+    {
+        if (HOST_TimeGet() >= until)
+        {
+            return false;
+        }
+
+        HOST_Run(Tasks, HOST_TimeGet() + kPassNs, kPassNs);
+    }
+
+    return true;
+}
+
+bool Queue( uint32_t i, uint32_t blockStart, uint32_t nBlocks )
+{
+    queuedNs[i] = HOST_TimeGet();
+    DRV_SDMMC_AsyncWrite(sdmmcHandle, &commands[i], buffers[i], blockStart, nBlocks);
+
+    return (commands[i] != DRV_SDMMC_COMMAND_HANDLE_INVALID);
+}
+
+/* Arguments: blocks per request, and whether the requests are queued
+ * together for the driver to merge */
+void BM_SdmmcWrite(benchmark::State& state)
+{
+    const uint32_t nBlocks = (uint32_t)state.range(0);
+    const bool isMerged = (state.range(1) != 0);
+    HOST_SDCARD_STATISTICS before;
+    HOST_SDCARD_STATISTICS after;
+    uint64_t latencyNs = 0U;
+    uint32_t blockStart = 0U;
+
+    if (SdmmcOpen() == false)
+    {
+        state.SkipWithError("the card did not come up");
+        return;
+    }
+
+    for (uint32_t i = 0U; i < kRequests; i++)
+    {
+        (void) memset(buffers[i], (int)(0xA0U + i), sizeof(buffers[i]));
+    }
+
+    HOST_SDCARD_StatisticsGet(&before);
+
+    for (auto _ : state)
+    {
+        uint64_t startNs = HOST_TimeGet();
+        bool isDone = true;
+
+        completed = 0U;
+        failed = 0U;
+
+        for (uint32_t i = 0U; (i < kRequests) && (isDone == true); i++)
+        {
+            isDone = Queue(i, blockStart + (i * nBlocks), nBlocks);
+
+            if ((isDone == true) && (isMerged == false))
+            {
+                isDone = WaitFor(i + 1U);
+            }
+        }
+
+        if ((isDone == false) || (WaitFor(kRequests) == false) || (failed != 0U))
+        {
+            state.SkipWithError("a write did not complete");
+            return;
+        }
+
+        for (uint32_t i = 0U; i < kRequests; i++)
+        {
+            latencyNs += doneNs[i] - queuedNs[i];
+        }
+
+        state.SetIterationTime((double)(HOST_TimeGet() - startNs) / (double)HOST_NS_PER_S);
+
+        /* the next run follows on the card, and wraps before its end */
+        blockStart += kRequests * nBlocks;
+        if ((blockStart + (kRequests * nBlocks)) > kCardBlocks)
+        {
+            blockStart = 0U;
+        }
+    }
+
+    HOST_SDCARD_StatisticsGet(&after);
+
+    state.SetBytesProcessed(state.iterations() * (int64_t)(kRequests * nBlocks * kBlockSize));
+    state.counters["latency_us"] = benchmark::Counter((double)latencyNs / 1000.0 /
+                                                      (double)(state.iterations() * kRequests));
+    state.counters["card_writes"] = benchmark::Counter((double)(after.writeCommands - before.writeCommands) /
+                                                       (double)state.iterations());
+    state.counters["descriptor_lines"] = benchmark::Counter((double)after.descriptorLines);
+}
+BENCHMARK(BM_SdmmcWrite)
+    ->ArgNames({ "blocks", "merged" })
+    ->ArgsProduct({ { 1, 8, 32 }, { 0, 1 } })
+    ->UseManualTime();
+
+}
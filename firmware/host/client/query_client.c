@@ -0,0 +1,249 @@
+/*******************************************************************************
+  Logged Data Download Client
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    query_client.c
+
+  Summary:
+    Decoder of the frames app_query.c sends on the console.
+
+  Description:
+    A frame is collected from its sync byte up to the length its header
+    gives. When its CRC does not match, the 0xA5 that started it was text or
+    the frame was damaged on the line: the search starts again at the next
+    0xA5 within it, so a frame that followed is not lost with it.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <string.h>
+#include "query_client.h"
+
+#define QUERY_CLIENT_HEADER_LEN     3U
+#define QUERY_CLIENT_CRC_LEN        2U
+
+#define QUERY_CLIENT_START_LEN      9U
+#define QUERY_CLIENT_END_LEN        21U
+
+/* Set in the milliseconds of a record that has the derived quantities */
+#define QUERY_CLIENT_DERIVED_FLAG   0x8000U
+
+static uint32_t QUERY_CLIENT_Get(const uint8_t* data, size_t size)
+{
+    uint32_t value = 0U;
+
+    while (size-- > 0U)
+    {
+        value = (value << 8) | data[size];
+    }
+
+    return value;
+}
+
+/* Length of the frame in the buffer, once its header is in */
+static size_t QUERY_CLIENT_FrameLength(const QUERY_CLIENT_DECODER* decoder)
+{
+    return QUERY_CLIENT_HEADER_LEN + (size_t)decoder->frame[2] + QUERY_CLIENT_CRC_LEN;
+}
+
+static bool QUERY_CLIENT_CrcMatches(const QUERY_CLIENT_DECODER* decoder)
+{
+    size_t length = QUERY_CLIENT_FrameLength(decoder);
+    uint16_t crc = QUERY_CLIENT_Crc16(0xFFFFU, &decoder->frame[1], length - QUERY_CLIENT_CRC_LEN - 1U);
+
+    return (crc == (uint16_t)QUERY_CLIENT_Get(&decoder->frame[length - QUERY_CLIENT_CRC_LEN], QUERY_CLIENT_CRC_LEN));
+}
+
+/* Drop the sync byte of a damaged frame and keep what follows from the next
+ * sync byte in it */
+static void QUERY_CLIENT_Resync(QUERY_CLIENT_DECODER* decoder)
+{
+    size_t i;
+
+    for (i = 1U; (i < decoder->length) && (decoder->frame[i] != QUERY_CLIENT_SYNC); i++)
+    {
+    }
+
+    decoder->textCount += (uint32_t)i;
+    decoder->length -= i;
+    (void) memmove(decoder->frame, &decoder->frame[i], decoder->length);
+}
+
+uint16_t QUERY_CLIENT_Crc16( uint16_t crc, const uint8_t* data, size_t length )
+{
+    uint8_t bit;
+
+    while (length-- > 0U)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+
+        for (bit = 0U; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+void QUERY_CLIENT_Initialize( QUERY_CLIENT_DECODER* decoder )
+{
+    (void) memset(decoder, 0, sizeof(*decoder));
+}
+
+bool QUERY_CLIENT_Put( QUERY_CLIENT_DECODER* decoder, uint8_t byte )
+{
+    /* The frame completed by the previous byte has been read */
+    if ((decoder->length >= QUERY_CLIENT_HEADER_LEN) && (decoder->length == QUERY_CLIENT_FrameLength(decoder)))
+    {
+        decoder->length = 0U;
+    }
+
+    if ((decoder->length == 0U) && (byte != QUERY_CLIENT_SYNC))
+    {
+        decoder->textCount++;
+        return false;
+    }
+
+    decoder->frame[decoder->length++] = byte;
+
+    /* The bytes kept after a damaged frame may hold a whole one */
+    while ((decoder->length >= QUERY_CLIENT_HEADER_LEN) && (decoder->length >= QUERY_CLIENT_FrameLength(decoder)))
+    {
+        if (QUERY_CLIENT_CrcMatches(decoder) == true)
+        {
+            /* Bytes after it are text that a damaged frame swallowed */
+            decoder->textCount += (uint32_t)(decoder->length - QUERY_CLIENT_FrameLength(decoder));
+            decoder->length = QUERY_CLIENT_FrameLength(decoder);
+            decoder->frameCount++;
+            return true;
+        }
+
+        decoder->crcErrorCount++;
+        QUERY_CLIENT_Resync(decoder);
+    }
+
+    return false;
+}
+
+uint8_t QUERY_CLIENT_TypeGet( const QUERY_CLIENT_DECODER* decoder )
+{
+    if ((decoder->length < QUERY_CLIENT_HEADER_LEN) || (decoder->length != QUERY_CLIENT_FrameLength(decoder)))
+    {
+        return 0U;
+    }
+
+    return decoder->frame[1];
+}
+
+const uint8_t* QUERY_CLIENT_PayloadGet( const QUERY_CLIENT_DECODER* decoder, size_t* length )
+{
+    *length = (QUERY_CLIENT_TypeGet(decoder) != 0U) ? (size_t)decoder->frame[2] : 0U;
+
+    return &decoder->frame[QUERY_CLIENT_HEADER_LEN];
+}
+
+bool QUERY_CLIENT_StartGet( const QUERY_CLIENT_DECODER* decoder, QUERY_CLIENT_START* start )
+{
+    size_t length;
+    const uint8_t* payload = QUERY_CLIENT_PayloadGet(decoder, &length);
+
+    if ((QUERY_CLIENT_TypeGet(decoder) != QUERY_CLIENT_TYPE_START) || (length != QUERY_CLIENT_START_LEN))
+    {
+        return false;
+    }
+
+    start->from = QUERY_CLIENT_Get(&payload[0], 4U);
+    start->to = QUERY_CLIENT_Get(&payload[4], 4U);
+    start->recordLength = payload[8];
+
+    return true;
+}
+
+size_t QUERY_CLIENT_RecordCountGet( const QUERY_CLIENT_DECODER* decoder )
+{
+    size_t length;
+
+    (void) QUERY_CLIENT_PayloadGet(decoder, &length);
+
+    if ((QUERY_CLIENT_TypeGet(decoder) != QUERY_CLIENT_TYPE_DATA) || ((length % QUERY_CLIENT_RECORD_LEN) != 0U))
+    {
+        return 0U;
+    }
+
+    return length / QUERY_CLIENT_RECORD_LEN;
+}
+
+bool QUERY_CLIENT_RecordGet( const QUERY_CLIENT_DECODER* decoder, size_t index, QUERY_CLIENT_RECORD* record )
+{
+    size_t length;
+    const uint8_t* payload = QUERY_CLIENT_PayloadGet(decoder, &length);
+    uint16_t milliseconds;
+
+    if (index >= QUERY_CLIENT_RecordCountGet(decoder))
+    {
+        return false;
+    }
+
+    payload = &payload[index * QUERY_CLIENT_RECORD_LEN];
+    milliseconds = (uint16_t)QUERY_CLIENT_Get(&payload[4], 2U);
+
+    record->time = QUERY_CLIENT_Get(&payload[0], 4U);
+    record->milliseconds = milliseconds & (uint16_t)~QUERY_CLIENT_DERIVED_FLAG;
+    record->isDerived = ((milliseconds & QUERY_CLIENT_DERIVED_FLAG) != 0U);
+    record->temperature = (int16_t)QUERY_CLIENT_Get(&payload[6], 2U);
+    record->pressure = QUERY_CLIENT_Get(&payload[8], 4U);
+    record->humidity = (uint16_t)QUERY_CLIENT_Get(&payload[12], 2U);
+    record->dewPoint = (int16_t)QUERY_CLIENT_Get(&payload[14], 2U);
+    record->absoluteHumidity = (uint16_t)QUERY_CLIENT_Get(&payload[16], 2U);
+    record->pressureAltitude = (int32_t)QUERY_CLIENT_Get(&payload[18], 4U);
+    record->seaLevelPressure = QUERY_CLIENT_Get(&payload[22], 4U);
+
+    return true;
+}
+
+bool QUERY_CLIENT_EndGet( const QUERY_CLIENT_DECODER* decoder, QUERY_CLIENT_END* end )
+{
+    size_t length;
+    const uint8_t* payload = QUERY_CLIENT_PayloadGet(decoder, &length);
+
+    if ((QUERY_CLIENT_TypeGet(decoder) != QUERY_CLIENT_TYPE_END) || (length != QUERY_CLIENT_END_LEN))
+    {
+        return false;
+    }
+
+    end->recordCount = QUERY_CLIENT_Get(&payload[0], 4U);
+    end->fileCount = QUERY_CLIENT_Get(&payload[4], 4U);
+    end->seekCount = QUERY_CLIENT_Get(&payload[8], 4U);
+    end->byteCount = QUERY_CLIENT_Get(&payload[12], 4U);
+    end->elapsedMs = QUERY_CLIENT_Get(&payload[16], 4U);
+    end->status = payload[20];
+
+    return true;
+}
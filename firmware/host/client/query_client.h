@@ -0,0 +1,143 @@
+/*******************************************************************************
+  Logged Data Download Client Interface
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    query_client.h
+
+  Summary:
+    Decoder of the frames app_query.c sends on the console.
+
+  Description:
+    The console carries the frames of a download, and any text the firmware
+    printed before the request, as one byte stream. The decoder takes the
+    stream a byte at a time, finds the frames in it as app_query.h describes
+    and checks their CRC. Bytes outside valid frames are counted and
+    otherwise dropped. The values of the frames are returned as app_query.h
+    defines them, in host byte order.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef QUERY_CLIENT_H
+#define QUERY_CLIENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QUERY_CLIENT_SYNC           0xA5U
+#define QUERY_CLIENT_TYPE_START     'S'
+#define QUERY_CLIENT_TYPE_DATA      'D'
+#define QUERY_CLIENT_TYPE_END       'E'
+
+/* Sync, type and length, the longest payload and the CRC */
+#define QUERY_CLIENT_FRAME_MAX      (3U + 255U + 2U)
+
+/* Size of a record in a data frame */
+#define QUERY_CLIENT_RECORD_LEN     26U
+
+/* Seconds from 1970/01/01 to 2000/01/01, the epoch of the frames */
+#define QUERY_CLIENT_EPOCH_2000     946684800U
+
+/* Start frame */
+typedef struct
+{
+    uint32_t from;
+    uint32_t to;
+    uint8_t  recordLength;
+} QUERY_CLIENT_START;
+
+/* Record of a data frame, in the units of app_query.h */
+typedef struct
+{
+    uint32_t time;
+    uint16_t milliseconds;
+    bool     isDerived;
+    int16_t  temperature;
+    uint32_t pressure;
+    uint16_t humidity;
+    int16_t  dewPoint;
+    uint16_t absoluteHumidity;
+    int32_t  pressureAltitude;
+    uint32_t seaLevelPressure;
+} QUERY_CLIENT_RECORD;
+
+/* End frame */
+typedef struct
+{
+    uint32_t recordCount;
+    uint32_t fileCount;
+    uint32_t seekCount;
+    uint32_t byteCount;
+    uint32_t elapsedMs;
+    uint8_t  status;
+} QUERY_CLIENT_END;
+
+typedef struct
+{
+    /* Frame being received, and the bytes of it so far */
+    uint8_t  frame[QUERY_CLIENT_FRAME_MAX];
+    size_t   length;
+
+    /* Frames decoded, frames dropped for their CRC, and bytes outside
+     * valid frames */
+    uint32_t frameCount;
+    uint32_t crcErrorCount;
+    uint32_t textCount;
+} QUERY_CLIENT_DECODER;
+
+void QUERY_CLIENT_Initialize( QUERY_CLIENT_DECODER* decoder );
+
+/* Takes the next byte of the console. Returns true once it completes a frame
+ * whose CRC matches; the frame can then be read until the next byte. */
+bool QUERY_CLIENT_Put( QUERY_CLIENT_DECODER* decoder, uint8_t byte );
+
+/* Type of the frame completed last, and its payload */
+uint8_t QUERY_CLIENT_TypeGet( const QUERY_CLIENT_DECODER* decoder );
+const uint8_t* QUERY_CLIENT_PayloadGet( const QUERY_CLIENT_DECODER* decoder, size_t* length );
+
+/* Values of the frame completed last. Return false if it is not a frame of
+ * that type or its payload does not have the length of one. */
+bool QUERY_CLIENT_StartGet( const QUERY_CLIENT_DECODER* decoder, QUERY_CLIENT_START* start );
+size_t QUERY_CLIENT_RecordCountGet( const QUERY_CLIENT_DECODER* decoder );
+bool QUERY_CLIENT_RecordGet( const QUERY_CLIENT_DECODER* decoder, size_t index, QUERY_CLIENT_RECORD* record );
+bool QUERY_CLIENT_EndGet( const QUERY_CLIENT_DECODER* decoder, QUERY_CLIENT_END* end );
+
+/* CRC-16/CCITT-FALSE of the frames */
+uint16_t QUERY_CLIENT_Crc16( uint16_t crc, const uint8_t* data, size_t length );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUERY_CLIENT_H */
@@ -0,0 +1,192 @@
+/*******************************************************************************
+  Logged Data Download Client Program
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    query_client_main.c
+
+  Summary:
+    Downloads the records logged in a time range over the console.
+
+  Description:
+    query_client <port> <from> <to>
+
+    sends the download command of app_query.h on the serial port, at the
+    115200 baud 8N1 of the console, and prints the records it receives as
+    CSV, in the units of the log file. The totals of the end frame go to
+    stderr. With "-" as the port, a capture of the console is read from
+    stdin instead and no command is sent. The program gives up after 5 s
+    without a byte.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "query_client.h"
+
+/* Silence on the line after which the download is given up, in 0.1 s */
+#define QUERY_CLIENT_TIMEOUT_DS     50U
+
+static int QUERY_CLIENT_PortOpen(const char* name)
+{
+    struct termios options;
+    int port = open(name, O_RDWR | O_NOCTTY);
+
+    if (port < 0)
+    {
+        return -1;
+    }
+
+    if (tcgetattr(port, &options) != 0)
+    {
+        (void) close(port);
+        return -1;
+    }
+
+    cfmakeraw(&options);
+    (void) cfsetispeed(&options, B115200);
+    (void) cfsetospeed(&options, B115200);
+    options.c_cflag |= (CLOCAL | CREAD);
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = QUERY_CLIENT_TIMEOUT_DS;
+
+    if ((tcsetattr(port, TCSANOW, &options) != 0) || (tcflush(port, TCIOFLUSH) != 0))
+    {
+        (void) close(port);
+        return -1;
+    }
+
+    return port;
+}
+
+static void QUERY_CLIENT_RecordPrint(const QUERY_CLIENT_RECORD* record)
+{
+    time_t seconds = (time_t)record->time + (time_t)QUERY_CLIENT_EPOCH_2000;
+    struct tm time;
+    char date[24];
+
+    (void) gmtime_r(&seconds, &time);
+    (void) strftime(date, sizeof(date), "%Y/%m/%d %H:%M:%S", &time);
+
+    printf("%s.%03u,%.2f,%.2f,%.1f", date, (unsigned)record->milliseconds, record->temperature / 100.0,
+           record->pressure / 100.0, record->humidity / 10.0);
+
+    if (record->isDerived == true)
+    {
+        printf(",%.2f,%.2f,%.2f,%.2f", record->dewPoint / 100.0, record->absoluteHumidity / 100.0,
+               record->pressureAltitude / 100.0, record->seaLevelPressure / 100.0);
+    }
+
+    printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+    static const char* const statusText[] = { "ok", "no index", "read error" };
+    QUERY_CLIENT_DECODER decoder;
+    QUERY_CLIENT_RECORD record;
+    QUERY_CLIENT_END end;
+    uint8_t buffer[256];
+    char command[40];
+    bool isEnd = false;
+    ssize_t count;
+    ssize_t i;
+    size_t n;
+    int port;
+    int length;
+
+    if (argc != 4)
+    {
+        fprintf(stderr, "usage: %s <port> <from> <to>, times as YYYYMMDDhhmmss; - reads a capture from stdin\n",
+                argv[0]);
+        return 2;
+    }
+
+    if (strcmp(argv[1], "-") == 0)
+    {
+        port = STDIN_FILENO;
+    }
+    else
+    {
+        port = QUERY_CLIENT_PortOpen(argv[1]);
+
+        if (port < 0)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+
+        length = snprintf(command, sizeof(command), "2 %s %s\r", argv[2], argv[3]);
+
+        if ((length < 0) || ((size_t)length >= sizeof(command)) ||
+            (write(port, command, (size_t)length) != (ssize_t)length))
+        {
+            fprintf(stderr, "%s: command not sent\n", argv[1]);
+            return 1;
+        }
+    }
+
+    QUERY_CLIENT_Initialize(&decoder);
+
+    while ((isEnd == false) && ((count = read(port, buffer, sizeof(buffer))) > 0))
+    {
+        for (i = 0; (isEnd == false) && (i < count); i++)
+        {
+            if (QUERY_CLIENT_Put(&decoder, buffer[i]) == false)
+            {
+                continue;
+            }
+
+            for (n = 0U; QUERY_CLIENT_RecordGet(&decoder, n, &record) == true; n++)
+            {
+                QUERY_CLIENT_RecordPrint(&record);
+            }
+
+            isEnd = QUERY_CLIENT_EndGet(&decoder, &end);
+        }
+    }
+
+    if (isEnd == false)
+    {
+        fprintf(stderr, "no end frame, %lu frames, %lu with a CRC error\n", (unsigned long)decoder.frameCount,
+                (unsigned long)decoder.crcErrorCount);
+        return 1;
+    }
+
+    fprintf(stderr, "%lu records, %lu files, %lu seeks, %lu bytes read in %lu ms, %s\n",
+            (unsigned long)end.recordCount, (unsigned long)end.fileCount, (unsigned long)end.seekCount,
+            (unsigned long)end.byteCount, (unsigned long)end.elapsedMs,
+            (end.status < (sizeof(statusText) / sizeof(statusText[0]))) ? statusText[end.status] : "unknown");
+
+    return (end.status == 0U) ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/*******************************************************************************
+  Host CMSIS Compiler Definitions
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_cmsis.h
+
+  Summary:
+    Replaces cmsis_gcc.h for builds that run on the development host.
+
+  Description:
+    This header is force-included in every host translation unit. It defines
+    the include guard of cmsis_gcc.h, so the CMSIS headers of the device pack
+    use the definitions below instead of the Cortex-M inline assembly. The
+    interrupt mask, barriers and sleep instructions are routed to the host
+    simulation, which keeps the interrupt state and the virtual time.
+
+    The NVIC functions of core_cm4.h are replaced through CMSIS_NVIC_VIRTUAL
+    by those of host_nvic.h.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef HOST_CMSIS_H
+#define HOST_CMSIS_H
+
+/* Keeps cmsis_compiler.h from including the Cortex-M version */
+#define __CMSIS_GCC_H
+
+#define CMSIS_NVIC_VIRTUAL
+#define CMSIS_NVIC_VIRTUAL_HEADER_FILE  "host_nvic.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Interrupt mask and sleep, implemented by host_sim.c */
+void     HOST_IRQ_Enable( void );
+void     HOST_IRQ_Disable( void );
+uint32_t HOST_IRQ_PrimaskGet( void );
+void     HOST_IRQ_PrimaskSet( uint32_t primask );
+void     HOST_WaitForInterrupt( void );
+uint32_t HOST_MSPGet( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifndef __ASM
+  #define __ASM                                  __asm
+#endif
+#ifndef __INLINE
+  #define __INLINE                               inline
+#endif
+#ifndef __STATIC_INLINE
+  #define __STATIC_INLINE                        static inline
+#endif
+#ifndef __STATIC_FORCEINLINE
+  #define __STATIC_FORCEINLINE                   __attribute__((always_inline)) static inline
+#endif
+#ifndef __NO_RETURN
+  #define __NO_RETURN                            __attribute__((__noreturn__))
+#endif
+#ifndef __USED
+  #define __USED                                 __attribute__((used))
+#endif
+#ifndef __WEAK
+  #define __WEAK                                 __attribute__((weak))
+#endif
+#ifndef __PACKED
+  #define __PACKED                               __attribute__((packed, aligned(1)))
+#endif
+#ifndef __PACKED_STRUCT
+  #define __PACKED_STRUCT                        struct __attribute__((packed, aligned(1)))
+#endif
+#ifndef __PACKED_UNION
+  #define __PACKED_UNION                         union __attribute__((packed, aligned(1)))
+#endif
+#ifndef __ALIGNED
+  #define __ALIGNED(x)                           __attribute__((aligned(x)))
+#endif
+#ifndef __RESTRICT
+  #define __RESTRICT                             __restrict
+#endif
+#ifndef __COMPILER_BARRIER
+  #define __COMPILER_BARRIER()                   __ASM volatile("":::"memory")
+#endif
+
+/* The host is little endian and allows unaligned accesses */
+#define __UNALIGNED_UINT16_READ(addr)            (*(const uint16_t *)(const void *)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val)      (void)(*(uint16_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr)            (*(const uint32_t *)(const void *)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val)      (void)(*(uint32_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32(x)                    (*(uint32_t *)(x))
+
+/* The handlers run on the thread of the firmware and there is no other
+ * master, so a barrier only keeps the compiler from moving accesses across
+ * it. A fence of the host would cost more than the code it guards. */
+#define __ISB()                                  __COMPILER_BARRIER()
+#define __DSB()                                  __COMPILER_BARRIER()
+#define __DMB()                                  __COMPILER_BARRIER()
+#define __NOP()                                  __COMPILER_BARRIER()
+#define __WFI()                                  HOST_WaitForInterrupt()
+#define __WFE()                                  HOST_WaitForInterrupt()
+#define __SEV()
+#define __BKPT(value)                            __builtin_trap()
+
+#define __enable_irq()                           HOST_IRQ_Enable()
+#define __disable_irq()                          HOST_IRQ_Disable()
+#define __get_PRIMASK()                          HOST_IRQ_PrimaskGet()
+#define __set_PRIMASK(priMask)                   HOST_IRQ_PrimaskSet(priMask)
+#define __get_MSP()                              HOST_MSPGet()
+
+#define __REV(value)                             __builtin_bswap32(value)
+#define __REV16(value)                           ((uint32_t)__builtin_bswap32(value) >> 16 | \
+                                                  (uint32_t)__builtin_bswap32(value) << 16)
+#define __CLZ(value)                             (uint8_t)(((value) == 0U) ? 32U : (uint32_t)__builtin_clz(value))
+
+#endif /* HOST_CMSIS_H */
@@ -0,0 +1,80 @@
+/*******************************************************************************
+  Host NVIC Definitions
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_nvic.h
+
+  Summary:
+    NVIC functions of core_cm4.h for host builds.
+
+  Description:
+    core_cm4.h includes this header in place of its own NVIC mapping when
+    CMSIS_NVIC_VIRTUAL is defined. The enable, pending and priority state of
+    each interrupt is kept by host_sim.c, which calls the handler of an
+    enabled pending interrupt whenever the interrupt mask allows it.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef HOST_NVIC_H
+#define HOST_NVIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void     HOST_NVIC_EnableIRQ( IRQn_Type irq );
+void     HOST_NVIC_DisableIRQ( IRQn_Type irq );
+uint32_t HOST_NVIC_GetEnableIRQ( IRQn_Type irq );
+uint32_t HOST_NVIC_GetPendingIRQ( IRQn_Type irq );
+void     HOST_NVIC_SetPendingIRQ( IRQn_Type irq );
+void     HOST_NVIC_ClearPendingIRQ( IRQn_Type irq );
+uint32_t HOST_NVIC_GetActive( IRQn_Type irq );
+void     HOST_NVIC_SetPriority( IRQn_Type irq, uint32_t priority );
+uint32_t HOST_NVIC_GetPriority( IRQn_Type irq );
+void     HOST_NVIC_SystemReset( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#define NVIC_SetPriorityGrouping(group)     ((void)(group))
+#define NVIC_GetPriorityGrouping()          (0U)
+#define NVIC_EnableIRQ                      HOST_NVIC_EnableIRQ
+#define NVIC_GetEnableIRQ                   HOST_NVIC_GetEnableIRQ
+#define NVIC_DisableIRQ                     HOST_NVIC_DisableIRQ
+#define NVIC_GetPendingIRQ                  HOST_NVIC_GetPendingIRQ
+#define NVIC_SetPendingIRQ                  HOST_NVIC_SetPendingIRQ
+#define NVIC_ClearPendingIRQ                HOST_NVIC_ClearPendingIRQ
+#define NVIC_GetActive                      HOST_NVIC_GetActive
+#define NVIC_SetPriority                    HOST_NVIC_SetPriority
+#define NVIC_GetPriority                    HOST_NVIC_GetPriority
+#define NVIC_SystemReset                    HOST_NVIC_SystemReset
+
+#endif /* HOST_NVIC_H */
@@ -0,0 +1,67 @@
+/*******************************************************************************
+  Host Standard I/O Definitions
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_stdio.h
+
+  Summary:
+    Routes the firmware's console I/O to the simulated console USART.
+
+  Description:
+    On the board, newlib's unbuffered stdio hands printf output and getc
+    input to write() and read() of xc32_monitor.c, which drive SERCOM2. The
+    host build forces this header into the firmware sources so that printf
+    and getc reach the same xc32_monitor.c functions, built under the names
+    HOST_MONITOR_write and HOST_MONITOR_read, rather than the host's own
+    stdin and stdout.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef HOST_STDIO_H
+#define HOST_STDIO_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int HOST_CONSOLE_Printf( const char* format, ... ) __attribute__((format(printf, 1, 2)));
+int HOST_CONSOLE_Getc( FILE* stream );
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef getc
+#define printf              HOST_CONSOLE_Printf
+#define getc(stream)        HOST_CONSOLE_Getc(stream)
+
+#endif /* HOST_STDIO_H */
@@ -0,0 +1,93 @@
+/*******************************************************************************
+  Host Device Header
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    same54p20a.h
+
+  Summary:
+    Device pack header for host builds.
+
+  Description:
+    Includes the header of the device pack and moves the registers that
+    firmware outside the simulated PLIBs accesses directly from their device
+    addresses to objects owned by the host simulation: the core debug and
+    DWT registers used for cycle counts, the SCB written by NVIC_Initialize,
+    the CMCC registers of plib_cmcc.c, the NVMCTRL registers and SmartEEPROM
+    window that app_config.c uses besides the NVMCTRL PLIB, and the PORT
+    registers behind the LED0 and SWITCH macros of plib_port.h.
+
+    plib_sdhc1.c is built unchanged as well. Its registers are reached
+    through HOST_SDHC1_RegistersGet, which lets the controller model of
+    plib_sdhc1_regs_sim.c act on each access.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef HOST_SAME54P20A_H
+#define HOST_SAME54P20A_H
+
+#include_next "same54p20a.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern SCB_Type             HOST_SCB;
+extern DWT_Type             HOST_DWT;
+extern CoreDebug_Type       HOST_CoreDebug;
+extern nvmctrl_registers_t  HOST_NVMCTRL_REGS;
+extern cmcc_registers_t     HOST_CMCC_REGS;
+extern port_registers_t     HOST_PORT_REGS;
+extern uint8_t              HOST_SEEPROM[];
+
+sdhc_registers_t* HOST_SDHC1_RegistersGet( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef SCB
+#undef DWT
+#undef CoreDebug
+#undef NVMCTRL_REGS
+#undef CMCC_REGS
+#undef PORT_REGS
+#undef SDHC1_REGS
+#undef SEEPROM_ADDR
+
+#define SCB                 (&HOST_SCB)
+#define DWT                 (&HOST_DWT)
+#define CoreDebug           (&HOST_CoreDebug)
+#define NVMCTRL_REGS        (&HOST_NVMCTRL_REGS)
+#define CMCC_REGS           (&HOST_CMCC_REGS)
+#define PORT_REGS           (&HOST_PORT_REGS)
+#define SDHC1_REGS          (HOST_SDHC1_RegistersGet())
+#define SEEPROM_ADDR        ((uintptr_t)&HOST_SEEPROM[0])
+
+#endif /* HOST_SAME54P20A_H */
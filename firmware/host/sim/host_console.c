@@ -0,0 +1,104 @@
+/*******************************************************************************
+  Host Console
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_console.c
+
+  Summary:
+    printf and getc of the firmware for host builds.
+
+  Description:
+    Stands in for the parts of newlib between the firmware and
+    xc32_monitor.c. With stdout unbuffered, newlib formats each printf into
+    its own buffer and passes it to write() in one call; write() starts the
+    interrupt driven SERCOM2 transfer on that buffer and returns. The next
+    printf may only reuse the buffer once the transfer has finished.
+
+    With stdin unbuffered, getc reads through read() into the one character
+    buffer of stdin. read() starts an interrupt driven SERCOM2 read into it
+    and returns at once, so getc returns the character the previous read
+    received. app.c relies on this: it calls getc only once that read is no
+    longer busy.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "peripheral/sercom/usart/plib_sercom2_usart.h"
+#include "host_stdio.h"
+#include "host_sim.h"
+
+#define HOST_CONSOLE_BUFFER_SIZE        (512U)
+
+int HOST_MONITOR_read( int handle, void* buffer, unsigned int len );
+int HOST_MONITOR_write( int handle, void* buffer, size_t count );
+
+static char hostConsoleBuffer[HOST_CONSOLE_BUFFER_SIZE];
+
+int HOST_CONSOLE_Printf( const char* format, ... )
+{
+    va_list args;
+    int length;
+
+    while (SERCOM2_USART_WriteIsBusy() == true)
+    {
+        HOST_Poll();
+    }
+
+    va_start(args, format);
+    length = vsnprintf(hostConsoleBuffer, sizeof(hostConsoleBuffer), format, args);
+    va_end(args);
+
+    if (length <= 0)
+    {
+        return length;
+    }
+
+    if ((size_t)length >= sizeof(hostConsoleBuffer))
+    {
+        length = (int)sizeof(hostConsoleBuffer) - 1;
+    }
+
+    return HOST_MONITOR_write(1, hostConsoleBuffer, (size_t)length);
+}
+
+int HOST_CONSOLE_Getc( FILE* stream )
+{
+    static unsigned char character;
+
+    (void) stream;
+
+    if (HOST_MONITOR_read(0, &character, 1U) != 1)
+    {
+        return EOF;
+    }
+
+    return (int)character;
+}
@@ -0,0 +1,220 @@
+/*******************************************************************************
+  Host Peripheral Model Interface
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_plib.h
+
+  Summary:
+    Controls of the simulated peripherals for host tests.
+
+  Description:
+    The simulated PLIBs implement the interfaces of the PLIBs that MHC
+    generated for this project, so the firmware builds unchanged against
+    them. This header gives tests the other side of each peripheral: the
+    terminal on the console USART, the contents of the flash and SmartEEPROM,
+    the phase of the RTC's 1 Hz clock and the error of the TC0 clock.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef HOST_PLIB_H
+#define HOST_PLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "host_sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RTC
+// *****************************************************************************
+// *****************************************************************************
+
+/* Moves the 1 Hz clock of the RTC so that the next second starts ns from
+ * now. The calendar keeps its value until then. */
+void HOST_RTC_PhaseSet( uint64_t ns );
+
+/* Virtual time at which the RTC calendar next counts a second */
+uint64_t HOST_RTC_NextSecondGet( void );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TC0
+// *****************************************************************************
+// *****************************************************************************
+
+/* Makes the TC0 clock run fast, or slow for a negative value, against the
+ * virtual time and so against the RTC. TC0_TimerInitialize sets it exact. */
+void HOST_TC0_ClockErrorSet( int32_t ppm );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Console (SERCOM2 USART)
+// *****************************************************************************
+// *****************************************************************************
+
+/* Time one character takes on the line at 115200 baud, 8N1 */
+#define HOST_CONSOLE_CHAR_NS        (86806ULL)
+
+/* Types characters on the terminal. They reach the USART one character time
+ * apart, after those typed before. */
+void HOST_CONSOLE_Input( const void* data, size_t size );
+
+/* Characters the terminal has received, NUL terminated */
+const char* HOST_CONSOLE_OutputGet( size_t* size );
+void HOST_CONSOLE_OutputClear( void );
+
+/* Copies the received characters to the host's stdout as well */
+void HOST_CONSOLE_EchoSet( bool echo );
+
+/* Characters that reached the USART while it could not receive them, because
+ * its clock was stopped or because its receive buffer was full */
+uint32_t HOST_CONSOLE_LostCountGet( void );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: NVMCTRL
+// *****************************************************************************
+// *****************************************************************************
+
+/* Program flash: 1 MB in two banks of 64 blocks of 8 KB */
+#define HOST_NVM_FLASH_SIZE         (0x100000U)
+
+/* Time the NVMCTRL is busy for each command, from the datasheet maxima */
+#define HOST_NVM_QUAD_WORD_NS       (100ULL * HOST_NS_PER_US)
+#define HOST_NVM_PAGE_NS            (2500ULL * HOST_NS_PER_US)
+#define HOST_NVM_BLOCK_ERASE_NS     (200ULL * HOST_NS_PER_MS)
+#define HOST_NVM_SEE_WRITE_NS       (50ULL * HOST_NS_PER_US)
+
+typedef struct
+{
+    uint32_t    quadWordWrites;
+    uint32_t    pageWrites;
+    uint32_t    blockErases;
+
+    /* SmartEEPROM page buffer flushes, and flushes requested while a flash
+     * command was running, which had to wait for it */
+    uint32_t    seeFlushes;
+    uint32_t    seeFlushesDelayed;
+
+    /* Flash commands issued while the NVMCTRL or the SmartEEPROM was busy */
+    uint32_t    busyCommands;
+} HOST_NVM_STATISTICS;
+
+/* Returns the flash and the SmartEEPROM to their erased state and the
+ * SmartEEPROM to the allocation of the fuses. Both keep their contents
+ * across HOST_Reset and NVMCTRL_Initialize, as across a power cycle. */
+void HOST_NVM_Erase( void );
+
+/* Contents of the flash */
+uint8_t* HOST_NVM_FlashGet( void );
+
+/* Allocates the SmartEEPROM as the SEESBLK and SEEPSZ fuses do, keeping its
+ * contents. A zero blocks count leaves it unallocated. */
+void HOST_NVM_SmartEEPROMConfigure( uint32_t blocks, uint32_t pageSize );
+
+/* Contents of the SmartEEPROM as the NVMCTRL keeps them in flash */
+uint8_t* HOST_NVM_SmartEEPROMGet( void );
+
+void HOST_NVM_StatisticsGet( HOST_NVM_STATISTICS* stats );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SD Card (SDHC1)
+// *****************************************************************************
+// *****************************************************************************
+
+/* Time a card is busy programming after the last block of a write */
+#define HOST_SDCARD_WRITE_BUSY_NS   (500ULL * HOST_NS_PER_US)
+
+typedef struct
+{
+    /* Commands the card responded to, and CMD0 resets among them */
+    uint32_t    commands;
+    uint32_t    resets;
+    uint32_t    highSpeedSwitches;
+
+    /* Block commands and the blocks they moved */
+    uint32_t    readCommands;
+    uint32_t    writeCommands;
+    uint32_t    multiBlockWrites;
+    uint32_t    preErases;
+    uint32_t    blocksRead;
+    uint32_t    blocksWritten;
+
+    /* Data phases that ended with a CRC error */
+    uint32_t    dataErrors;
+
+    /* Most ADMA2 descriptor lines a transfer used */
+    uint32_t    descriptorLines;
+
+    /* First block and block count of the last successful write */
+    uint32_t    lastWriteBlock;
+    uint32_t    lastWriteCount;
+} HOST_SDCARD_STATISTICS;
+
+/* Makes a blank card of 512 byte blocks, replacing the last one. An SDHC
+ * card (highCapacity) needs a multiple of 1024 blocks, an SDSC card a
+ * multiple of 512 up to 2 GB. */
+void HOST_SDCARD_Create( uint32_t blocks, bool highCapacity );
+
+/* Puts the card in the slot or takes it out, as the card detect pin sees */
+void HOST_SDCARD_Insert( void );
+void HOST_SDCARD_Remove( void );
+
+/* Contents of the card */
+uint8_t* HOST_SDCARD_DataGet( void );
+
+/* Makes every data phase at High Speed fail its CRC, as a card does on a
+ * board whose traces cannot carry 50 MHz */
+void HOST_SDCARD_HighSpeedErrorsSet( bool errors );
+
+/* Makes the next count writes fail their CRC */
+void HOST_SDCARD_WriteErrorsSet( uint32_t count );
+
+/* Makes the next count writes that cover block fail their CRC */
+void HOST_SDCARD_BlockErrorsSet( uint32_t block, uint32_t count );
+
+/* Cuts the power of the card once it has kept blocks more blocks: the writes
+ * after those still succeed but are lost, the rest of a multi-block write
+ * included. Putting the card back in powers it again. */
+void HOST_SDCARD_PowerCut( uint32_t blocks );
+
+void HOST_SDCARD_StatisticsGet( HOST_SDCARD_STATISTICS* stats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_PLIB_H */
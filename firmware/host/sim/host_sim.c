@@ -0,0 +1,597 @@
+/*******************************************************************************
+  Host Simulation Core
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_sim.c
+
+  Summary:
+    Virtual time, interrupts and sleep modes for host builds.
+
+  Description:
+    Events are kept in a list sorted by time. Letting time pass pops the
+    events that fall due, each at its own time, and services the interrupts
+    they raise. Interrupt handlers do not nest: all interrupts of the firmware
+    run at the same priority.
+
+    The DWT cycle counter follows the virtual time while the CPU runs, and
+    holds while it sleeps, as the core clock is stopped in IDLE and STANDBY.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_sim.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define HOST_IRQ_COUNT              ((uint32_t)PERIPH_MAX_IRQn + 1U)
+#define HOST_STANDBY_HOOKS_MAX      (8U)
+
+/* Device RAM, 256 KB, which app_memory.c reads through the linker symbols
+ * that the host link defines on this array. The stack is at the top. */
+#define HOST_RAM_WORDS              (0x40000U / 4U)
+#define HOST_STACK_WORDS            (0x2000U / 4U)
+
+typedef struct
+{
+    uint64_t            time;
+    HOST_EVENT*         events;
+    uint64_t            horizon;
+
+    /* Nesting of event callbacks and interrupt handlers */
+    uint32_t            depth;
+    bool                inHandler;
+    bool                sleeping;
+
+    /* A handler ran while the core was asleep, which ends the sleep */
+    bool                woken;
+
+    uint32_t            primask;
+    bool                enabled[HOST_IRQ_COUNT];
+    bool                pending[HOST_IRQ_COUNT];
+
+    /* Lines set in pending, so that a PRIMASK clear with none is cheap */
+    uint32_t            pendingCount;
+    uint8_t             priority[HOST_IRQ_COUNT];
+    HOST_IRQ_HANDLER    handlers[HOST_IRQ_COUNT];
+
+    HOST_STANDBY_HOOK   hooks[HOST_STANDBY_HOOKS_MAX];
+    uint32_t            hookCount;
+
+    /* Core cycles counted up to the last time the CPU stopped or started */
+    uint64_t            cycleBase;
+    uint64_t            cycleBaseTime;
+
+    HOST_STATISTICS     stats;
+} HOST_SIM_OBJ;
+
+static HOST_SIM_OBJ hostSim;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Host Device Registers
+// *****************************************************************************
+// *****************************************************************************
+
+SCB_Type            HOST_SCB;
+DWT_Type            HOST_DWT;
+CoreDebug_Type      HOST_CoreDebug;
+nvmctrl_registers_t HOST_NVMCTRL_REGS;
+cmcc_registers_t    HOST_CMCC_REGS;
+
+uint32_t HOST_Ram[HOST_RAM_WORDS] __attribute__((aligned(16)));
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void HOST_CycleCounterUpdate( void )
+{
+    uint64_t cycles = hostSim.cycleBase;
+
+    if (hostSim.sleeping == false)
+    {
+        cycles += (uint64_t)(((unsigned __int128)(hostSim.time - hostSim.cycleBaseTime) * HOST_CPU_FREQUENCY) /
+                             HOST_NS_PER_S);
+    }
+
+    if ((HOST_DWT.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U)
+    {
+        HOST_DWT.CYCCNT = (uint32_t)cycles;
+    }
+}
+
+/* Starts or stops the core clock */
+static void HOST_CpuClockSet( bool sleeping )
+{
+    HOST_CycleCounterUpdate();
+
+    if (hostSim.sleeping == false)
+    {
+        hostSim.cycleBase += (uint64_t)(((unsigned __int128)(hostSim.time - hostSim.cycleBaseTime) * HOST_CPU_FREQUENCY) /
+                                        HOST_NS_PER_S);
+    }
+
+    hostSim.cycleBaseTime = hostSim.time;
+    hostSim.sleeping = sleeping;
+}
+
+static void HOST_TimeSet( uint64_t time )
+{
+    hostSim.time = time;
+    HOST_CycleCounterUpdate();
+}
+
+static bool HOST_IRQ_IsReady( void )
+{
+    uint32_t irq;
+
+    for (irq = 0; irq < HOST_IRQ_COUNT; irq++)
+    {
+        if ((hostSim.pending[irq] == true) && (hostSim.enabled[irq] == true))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Calls the handlers of the enabled pending interrupts, lowest priority
+ * value and then lowest number first, while PRIMASK is clear. */
+static void HOST_IRQ_Dispatch( void )
+{
+    while ((hostSim.primask == 0U) && (hostSim.inHandler == false) && (hostSim.pendingCount > 0U))
+    {
+        uint32_t irq;
+        uint32_t next = HOST_IRQ_COUNT;
+
+        for (irq = 0; irq < HOST_IRQ_COUNT; irq++)
+        {
+            if ((hostSim.pending[irq] == true) && (hostSim.enabled[irq] == true) &&
+                ((next == HOST_IRQ_COUNT) || (hostSim.priority[irq] < hostSim.priority[next])))
+            {
+                next = irq;
+            }
+        }
+
+        if (next == HOST_IRQ_COUNT)
+        {
+            break;
+        }
+
+        hostSim.pending[next] = false;
+        hostSim.pendingCount--;
+
+        if (hostSim.handlers[next] != NULL)
+        {
+            bool sleeping = hostSim.sleeping;
+
+            /* The core runs the handler even when it was asleep */
+            if (sleeping == true)
+            {
+                HOST_CpuClockSet(false);
+            }
+
+            hostSim.inHandler = true;
+            hostSim.depth++;
+            hostSim.stats.interrupts++;
+            hostSim.handlers[next]();
+            hostSim.depth--;
+            hostSim.inHandler = false;
+
+            if (sleeping == true)
+            {
+                HOST_CpuClockSet(true);
+                hostSim.woken = true;
+            }
+        }
+    }
+}
+
+/* Lets time pass up to the given time, running the events on the way */
+static void HOST_RunTo( uint64_t target )
+{
+    while ((hostSim.events != NULL) && (hostSim.events->time <= target))
+    {
+        HOST_EVENT* event = hostSim.events;
+
+        hostSim.events = event->next;
+        event->armed = false;
+        event->next = NULL;
+
+        if (event->time > hostSim.time)
+        {
+            HOST_TimeSet(event->time);
+        }
+
+        hostSim.depth++;
+        event->callback(event->context);
+        hostSim.depth--;
+
+        HOST_IRQ_Dispatch();
+    }
+
+    if (target > hostSim.time)
+    {
+        HOST_TimeSet(target);
+    }
+}
+
+/* Sleeps until an enabled interrupt is pending, or has been taken when
+ * PRIMASK is clear. Returns false if the horizon was reached first. */
+static bool HOST_SleepUntilInterrupt( void )
+{
+    hostSim.woken = false;
+
+    while ((HOST_IRQ_IsReady() == false) && (hostSim.woken == false))
+    {
+        uint64_t next;
+
+        if (hostSim.events != NULL)
+        {
+            next = hostSim.events->time;
+        }
+        else if (hostSim.horizon != 0U)
+        {
+            next = hostSim.horizon;
+        }
+        else
+        {
+            fprintf(stderr, "host_sim: sleep with no event scheduled and no horizon\n");
+            abort();
+        }
+
+        if ((hostSim.horizon != 0U) && (next >= hostSim.horizon))
+        {
+            HOST_RunTo(hostSim.horizon);
+            return (HOST_IRQ_IsReady() == true) || (hostSim.woken == true);
+        }
+
+        HOST_RunTo(next);
+    }
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_Reset( void )
+{
+    (void) memset(&hostSim, 0, sizeof(hostSim));
+    (void) memset(&HOST_SCB, 0, sizeof(HOST_SCB));
+    (void) memset(&HOST_DWT, 0, sizeof(HOST_DWT));
+    (void) memset(&HOST_CoreDebug, 0, sizeof(HOST_CoreDebug));
+
+    /* Reset_Handler runs with interrupts enabled in PRIMASK; all sources are
+     * disabled in the NVIC until NVIC_Initialize. */
+    hostSim.primask = 0U;
+}
+
+uint64_t HOST_TimeGet( void )
+{
+    return hostSim.time;
+}
+
+void HOST_TimeAdvance( uint64_t ns )
+{
+    HOST_RunTo(hostSim.time + ns);
+}
+
+void HOST_Poll( void )
+{
+    if (hostSim.depth == 0U)
+    {
+        HOST_RunTo(hostSim.time + HOST_POLL_NS);
+    }
+}
+
+void HOST_HorizonSet( uint64_t time )
+{
+    hostSim.horizon = time;
+}
+
+void HOST_Run( void (* tasks)( void ), uint64_t until, uint64_t passNs )
+{
+    uint64_t horizon = hostSim.horizon;
+
+    hostSim.horizon = until;
+
+    while (hostSim.time < until)
+    {
+        uint64_t start = hostSim.stats.idleNs + hostSim.stats.standbyNs;
+
+        tasks();
+
+        /* A pass that slept has already let time pass */
+        if ((hostSim.stats.idleNs + hostSim.stats.standbyNs) == start)
+        {
+            HOST_RunTo(((hostSim.time + passNs) < until) ? (hostSim.time + passNs) : until);
+        }
+    }
+
+    hostSim.horizon = horizon;
+}
+
+void HOST_StatisticsGet( HOST_STATISTICS* stats )
+{
+    *stats = hostSim.stats;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Model Interface
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_EventInit( HOST_EVENT* event, HOST_EVENT_CALLBACK callback, uintptr_t context )
+{
+    (void) memset(event, 0, sizeof(*event));
+    event->callback = callback;
+    event->context = context;
+}
+
+void HOST_EventSchedule( HOST_EVENT* event, uint64_t time )
+{
+    HOST_EVENT** link = &hostSim.events;
+
+    HOST_EventCancel(event);
+
+    /* Events at the same time run in the order they were scheduled */
+    while ((*link != NULL) && ((*link)->time <= time))
+    {
+        link = &(*link)->next;
+    }
+
+    event->time = time;
+    event->armed = true;
+    event->next = *link;
+    *link = event;
+}
+
+void HOST_EventCancel( HOST_EVENT* event )
+{
+    HOST_EVENT** link = &hostSim.events;
+
+    if (event->armed == false)
+    {
+        return;
+    }
+
+    while (*link != NULL)
+    {
+        if (*link == event)
+        {
+            *link = event->next;
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    event->armed = false;
+    event->next = NULL;
+}
+
+void HOST_IRQ_HandlerSet( IRQn_Type irq, HOST_IRQ_HANDLER handler )
+{
+    hostSim.handlers[irq] = handler;
+}
+
+void HOST_IRQ_Raise( IRQn_Type irq )
+{
+    if (hostSim.pending[irq] == false)
+    {
+        hostSim.pending[irq] = true;
+        hostSim.pendingCount++;
+    }
+
+    HOST_IRQ_Dispatch();
+}
+
+bool HOST_IRQ_InHandler( void )
+{
+    return hostSim.inHandler;
+}
+
+void HOST_StandbyHookRegister( HOST_STANDBY_HOOK hook )
+{
+    if (hostSim.hookCount < HOST_STANDBY_HOOKS_MAX)
+    {
+        hostSim.hooks[hostSim.hookCount++] = hook;
+    }
+}
+
+void HOST_IdleSleep( void )
+{
+    uint64_t start = hostSim.time;
+
+    HOST_CpuClockSet(true);
+    (void) HOST_SleepUntilInterrupt();
+    HOST_CpuClockSet(false);
+
+    hostSim.stats.idleNs += hostSim.time - start;
+    hostSim.stats.idleEntries++;
+}
+
+void HOST_StandbySleep( void )
+{
+    uint64_t start = hostSim.time;
+    uint32_t hook;
+
+    for (hook = 0; hook < hostSim.hookCount; hook++)
+    {
+        hostSim.hooks[hook](true);
+    }
+
+    HOST_CpuClockSet(true);
+
+    if (HOST_SleepUntilInterrupt() == true)
+    {
+        /* The DPLLs lock again before the core and TC0 get their clock */
+        HOST_RunTo(hostSim.time + HOST_STANDBY_WAKEUP_NS);
+    }
+
+    HOST_CpuClockSet(false);
+
+    for (hook = 0; hook < hostSim.hookCount; hook++)
+    {
+        hostSim.hooks[hook](false);
+    }
+
+    hostSim.stats.standbyNs += hostSim.time - start;
+    hostSim.stats.standbyEntries++;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: CMSIS Core Functions
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_IRQ_Enable( void )
+{
+    hostSim.primask = 0U;
+    HOST_IRQ_Dispatch();
+}
+
+void HOST_IRQ_Disable( void )
+{
+    hostSim.primask = 1U;
+}
+
+uint32_t HOST_IRQ_PrimaskGet( void )
+{
+    return hostSim.primask;
+}
+
+void HOST_IRQ_PrimaskSet( uint32_t primask )
+{
+    hostSim.primask = primask & 1U;
+    HOST_IRQ_Dispatch();
+}
+
+void HOST_WaitForInterrupt( void )
+{
+    HOST_IdleSleep();
+}
+
+uint32_t HOST_MSPGet( void )
+{
+    /* The firmware's stack is not used on the host. Report the bottom of the
+     * 1 KB the startup code and main would occupy. */
+    return (uint32_t)(uintptr_t)&HOST_Ram[HOST_RAM_WORDS - 256U];
+}
+
+void HOST_NVIC_EnableIRQ( IRQn_Type irq )
+{
+    if ((int32_t)irq >= 0)
+    {
+        hostSim.enabled[irq] = true;
+        HOST_IRQ_Dispatch();
+    }
+}
+
+void HOST_NVIC_DisableIRQ( IRQn_Type irq )
+{
+    if ((int32_t)irq >= 0)
+    {
+        hostSim.enabled[irq] = false;
+    }
+}
+
+uint32_t HOST_NVIC_GetEnableIRQ( IRQn_Type irq )
+{
+    return (((int32_t)irq >= 0) && (hostSim.enabled[irq] == true)) ? 1U : 0U;
+}
+
+uint32_t HOST_NVIC_GetPendingIRQ( IRQn_Type irq )
+{
+    return (((int32_t)irq >= 0) && (hostSim.pending[irq] == true)) ? 1U : 0U;
+}
+
+void HOST_NVIC_SetPendingIRQ( IRQn_Type irq )
+{
+    if ((int32_t)irq >= 0)
+    {
+        HOST_IRQ_Raise(irq);
+    }
+}
+
+void HOST_NVIC_ClearPendingIRQ( IRQn_Type irq )
+{
+    if (((int32_t)irq >= 0) && (hostSim.pending[irq] == true))
+    {
+        hostSim.pending[irq] = false;
+        hostSim.pendingCount--;
+    }
+}
+
+uint32_t HOST_NVIC_GetActive( IRQn_Type irq )
+{
+    (void) irq;
+    return (hostSim.inHandler == true) ? 1U : 0U;
+}
+
+void HOST_NVIC_SetPriority( IRQn_Type irq, uint32_t priority )
+{
+    if ((int32_t)irq >= 0)
+    {
+        hostSim.priority[irq] = (uint8_t)priority;
+    }
+}
+
+uint32_t HOST_NVIC_GetPriority( IRQn_Type irq )
+{
+    return ((int32_t)irq >= 0) ? hostSim.priority[irq] : 0U;
+}
+
+void HOST_NVIC_SystemReset( void )
+{
+    fprintf(stderr, "host_sim: system reset requested\n");
+    abort();
+}
@@ -0,0 +1,178 @@
+/*******************************************************************************
+  Host Simulation Core Interface
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    host_sim.h
+
+  Summary:
+    Virtual time, interrupts and sleep modes for host builds.
+
+  Description:
+    The firmware runs on the host against simulated PLIBs. Time does not pass
+    while host code executes; it advances only when the firmware sleeps,
+    polls a busy peripheral or when a test lets it pass, so runs are exactly
+    repeatable. Peripheral models schedule events on the virtual time line and
+    raise interrupts from them. An interrupt that is enabled in the NVIC is
+    serviced as soon as PRIMASK is clear, and ends WFI even when PRIMASK is
+    set, as on the Cortex-M4.
+
+    STANDBY sleep stops the models that register standby hooks, TC0 and the
+    peripherals clocked from the DPLLs, and adds the time the DPLL takes to
+    lock again on wake. The RTC keeps running.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+#define HOST_NS_PER_US              (1000ULL)
+#define HOST_NS_PER_MS              (1000000ULL)
+#define HOST_NS_PER_S               (1000000000ULL)
+
+/* Core clock, which the DWT cycle counter counts */
+#define HOST_CPU_FREQUENCY          (120000000ULL)
+
+/* Time from the STANDBY wake event until the DPLL clocks run again */
+#define HOST_STANDBY_WAKEUP_NS      (50ULL * HOST_NS_PER_US)
+
+/* Time a status poll of a busy peripheral takes */
+#define HOST_POLL_NS                (1ULL * HOST_NS_PER_US)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+typedef void (*HOST_EVENT_CALLBACK)( uintptr_t context );
+
+/* Event on the virtual time line. Owned by the model that schedules it. */
+typedef struct HOST_EVENT
+{
+    uint64_t                time;
+    HOST_EVENT_CALLBACK     callback;
+    uintptr_t               context;
+    bool                    armed;
+    struct HOST_EVENT*      next;
+} HOST_EVENT;
+
+typedef void (*HOST_IRQ_HANDLER)( void );
+
+/* Called when STANDBY is entered and when the clocks run again after wake */
+typedef void (*HOST_STANDBY_HOOK)( bool enter );
+
+typedef struct
+{
+    /* Virtual time spent in each sleep mode */
+    uint64_t    idleNs;
+    uint64_t    standbyNs;
+    uint32_t    idleEntries;
+    uint32_t    standbyEntries;
+
+    /* Interrupt handlers called */
+    uint32_t    interrupts;
+} HOST_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control
+// *****************************************************************************
+// *****************************************************************************
+
+/* Returns the simulation to its power-on state: time zero, no events,
+ * interrupts masked and disabled, no handlers, no hooks. */
+void HOST_Reset( void );
+
+/* Current virtual time in nanoseconds */
+uint64_t HOST_TimeGet( void );
+
+/* Lets time pass with the CPU running: events fall due in order and the
+ * interrupts they raise are serviced when PRIMASK allows. */
+void HOST_TimeAdvance( uint64_t ns );
+
+/* Time a polling loop spends between two reads of a busy status. Does
+ * nothing when called from an event or an interrupt handler. */
+void HOST_Poll( void );
+
+/* Sleeping with nothing scheduled ends at this time instead of never.
+ * Zero removes the limit. */
+void HOST_HorizonSet( uint64_t time );
+
+/* Runs tasks repeatedly, as the super loop does, until the given time. Each
+ * pass that does not sleep costs passNs of CPU time. */
+void HOST_Run( void (* tasks)( void ), uint64_t until, uint64_t passNs );
+
+void HOST_StatisticsGet( HOST_STATISTICS* stats );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Model Interface
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_EventInit( HOST_EVENT* event, HOST_EVENT_CALLBACK callback, uintptr_t context );
+void HOST_EventSchedule( HOST_EVENT* event, uint64_t time );
+void HOST_EventCancel( HOST_EVENT* event );
+
+/* Registers the function the vector table would call for an interrupt */
+void HOST_IRQ_HandlerSet( IRQn_Type irq, HOST_IRQ_HANDLER handler );
+
+/* Makes an interrupt pending, as a peripheral's interrupt flag does */
+void HOST_IRQ_Raise( IRQn_Type irq );
+
+/* Whether the interrupt handler of a model is running */
+bool HOST_IRQ_InHandler( void );
+
+void HOST_StandbyHookRegister( HOST_STANDBY_HOOK hook );
+
+/* Sleep modes of the PM. They return when an enabled interrupt is pending. */
+void HOST_IdleSleep( void );
+void HOST_StandbySleep( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SIM_H */
@@ -0,0 +1,69 @@
+/*******************************************************************************
+  Clock, Port and Event System Peripheral Library Simulation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_clock_sim.c
+
+  Summary:
+    CLOCK, PORT and EVSYS PLIBs for host builds.
+
+  Description:
+    The clock tree, the pin multiplexing and the event channels have no
+    behaviour on the host beyond what the peripheral models assume: GCLK0 at
+    120 MHz and GCLK1 at 60 MHz from the DPLLs, and the RTC on the 32 kHz
+    crystal.
+
+    The PORT registers only hold what is written to them. The SWITCH pin
+    reads high, as its pull-up holds it while the button is not pressed.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <string.h>
+#include "peripheral/clock/plib_clock.h"
+#include "peripheral/port/plib_port.h"
+#include "peripheral/evsys/plib_evsys.h"
+
+void CLOCK_Initialize( void )
+{
+}
+
+port_registers_t HOST_PORT_REGS;
+
+void PORT_Initialize( void )
+{
+    (void) memset(&HOST_PORT_REGS, 0, sizeof(HOST_PORT_REGS));
+
+    /* PORT_IN is read-only to the firmware */
+    *(volatile uint32_t*)&HOST_PORT_REGS.GROUP[1].PORT_IN = ((uint32_t)1U << 31U);
+}
+
+void EVSYS_Initialize( void )
+{
+}
@@ -0,0 +1,451 @@
+/*******************************************************************************
+  NVMCTRL Peripheral Library Simulation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_nvmctrl_sim.c
+
+  Summary:
+    NVMCTRL PLIB for host builds.
+
+  Description:
+    Models the 1 MB program flash and the SmartEEPROM. A write or erase
+    changes the flash when its command is issued and keeps the NVMCTRL busy
+    for the datasheet's maximum time after it; commands issued while it is
+    busy are refused with a programming error. Programming can only clear
+    bits, as in the flash array.
+
+    The SmartEEPROM takes the last 2 * SEESBLK blocks of the flash, out of
+    reach of the flash commands. Its virtual address space is host memory
+    at SEEPROM_ADDR. In buffered mode, what the firmware writes there is kept
+    by the NVMCTRL only once the page buffer is flushed, so a reset loses
+    the words written since; in unbuffered mode every write is kept. A flush
+    while a flash command is running waits for the flash, as the NVMCTRL
+    runs one command at a time, and the SmartEEPROM is busy until both are
+    done. A flash command issued while the SmartEEPROM is busy is refused.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <string.h>
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+/* SEESBLK and SEEPSZ as the fuses in initialization.c program them */
+#define NVMCTRL_SIM_SEE_BLOCKS          (1U)
+#define NVMCTRL_SIM_SEE_PAGE_SIZE       (3U)
+
+#define NVMCTRL_SIM_SEE_SIZE_MAX        (0x10000U)
+
+typedef struct
+{
+    bool                initialized;
+    bool                seeLoaded;
+    uint8_t             flash[HOST_NVM_FLASH_SIZE];
+
+    /* End of a flash command and of a SmartEEPROM flush */
+    uint64_t            flashBusyUntil;
+    uint64_t            seeBusyUntil;
+    uint16_t            intFlag;
+    uint32_t            runlock;
+
+    uint32_t            seeBlocks;
+    uint32_t            seePageSize;
+    uint8_t             seeStore[NVMCTRL_SIM_SEE_SIZE_MAX];
+
+    HOST_NVM_STATISTICS stats;
+} NVMCTRL_SIM_OBJ;
+
+static NVMCTRL_SIM_OBJ nvmctrlSim;
+
+/* SmartEEPROM virtual address space, at SEEPROM_ADDR */
+uint8_t HOST_SEEPROM[NVMCTRL_SIM_SEE_SIZE_MAX] __attribute__((aligned(16)));
+
+static uint32_t nvm_error;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void NVMCTRL_SIM_PowerOn( void )
+{
+    if (nvmctrlSim.initialized == false)
+    {
+        (void) memset(nvmctrlSim.flash, 0xFF, sizeof(nvmctrlSim.flash));
+        (void) memset(nvmctrlSim.seeStore, 0xFF, sizeof(nvmctrlSim.seeStore));
+        nvmctrlSim.seeBlocks = NVMCTRL_SIM_SEE_BLOCKS;
+        nvmctrlSim.seePageSize = NVMCTRL_SIM_SEE_PAGE_SIZE;
+        nvmctrlSim.runlock = 0xFFFFFFFFU;
+        nvmctrlSim.initialized = true;
+    }
+}
+
+static uint32_t NVMCTRL_SIM_SmartEEPROMSize( void )
+{
+    return (nvmctrlSim.seeBlocks == 0U) ? 0U : (512U << nvmctrlSim.seePageSize);
+}
+
+/* Start of the flash the SmartEEPROM sectors take */
+static uint32_t NVMCTRL_SIM_SmartEEPROMStart( void )
+{
+    return HOST_NVM_FLASH_SIZE - (2U * nvmctrlSim.seeBlocks * NVMCTRL_FLASH_BLOCKSIZE);
+}
+
+static bool NVMCTRL_SIM_IsBusy( void )
+{
+    return (HOST_TimeGet() < nvmctrlSim.flashBusyUntil);
+}
+
+/* Checks a flash command before it runs. Returns false if it is refused. */
+static bool NVMCTRL_SIM_CommandStart( uint32_t address, uint32_t size, uint64_t duration )
+{
+    if ((NVMCTRL_SIM_IsBusy() == true) || (HOST_TimeGet() < nvmctrlSim.seeBusyUntil))
+    {
+        nvmctrlSim.stats.busyCommands++;
+        nvmctrlSim.intFlag |= NVMCTRL_INTFLAG_PROGE_Msk;
+        return false;
+    }
+
+    if ((address >= NVMCTRL_SIM_SmartEEPROMStart()) || (size > (NVMCTRL_SIM_SmartEEPROMStart() - address)))
+    {
+        nvmctrlSim.intFlag |= NVMCTRL_INTFLAG_ADDRE_Msk;
+        return false;
+    }
+
+    nvmctrlSim.flashBusyUntil = HOST_TimeGet() + duration;
+    nvmctrlSim.intFlag |= NVMCTRL_INTFLAG_DONE_Msk;
+
+    return true;
+}
+
+static void NVMCTRL_SIM_Program( const uint32_t* data, uint32_t address, uint32_t size )
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        nvmctrlSim.flash[address + i] &= bytes[i];
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Model Control
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_NVM_Erase( void )
+{
+    (void) memset(&nvmctrlSim, 0, sizeof(nvmctrlSim));
+    NVMCTRL_SIM_PowerOn();
+}
+
+uint8_t* HOST_NVM_FlashGet( void )
+{
+    NVMCTRL_SIM_PowerOn();
+
+    return nvmctrlSim.flash;
+}
+
+void HOST_NVM_SmartEEPROMConfigure( uint32_t blocks, uint32_t pageSize )
+{
+    NVMCTRL_SIM_PowerOn();
+
+    nvmctrlSim.seeBlocks = blocks;
+    nvmctrlSim.seePageSize = pageSize;
+}
+
+uint8_t* HOST_NVM_SmartEEPROMGet( void )
+{
+    NVMCTRL_SIM_PowerOn();
+
+    return nvmctrlSim.seeStore;
+}
+
+void HOST_NVM_StatisticsGet( HOST_NVM_STATISTICS* stats )
+{
+    *stats = nvmctrlSim.stats;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: NVMCTRL Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void NVMCTRL_Initialize( void )
+{
+    NVMCTRL_SIM_PowerOn();
+
+    /* In unbuffered mode the SmartEEPROM kept every word as it was written */
+    if ((nvmctrlSim.seeLoaded == true) &&
+        ((HOST_NVMCTRL_REGS.NVMCTRL_SEECFG & NVMCTRL_SEECFG_WMODE_Msk) == 0U))
+    {
+        (void) memcpy(nvmctrlSim.seeStore, HOST_SEEPROM, NVMCTRL_SIM_SmartEEPROMSize());
+    }
+
+    /* A reset ends any command; the NVMCTRL loads the SmartEEPROM from the
+     * flash again */
+    nvmctrlSim.flashBusyUntil = 0U;
+    nvmctrlSim.seeBusyUntil = 0U;
+    nvmctrlSim.intFlag = 0U;
+    nvm_error = 0U;
+    (void) memset(&HOST_NVMCTRL_REGS, 0, sizeof(HOST_NVMCTRL_REGS));
+    (void) memset(HOST_SEEPROM, 0xFF, sizeof(HOST_SEEPROM));
+    (void) memcpy(HOST_SEEPROM, nvmctrlSim.seeStore, NVMCTRL_SIM_SmartEEPROMSize());
+
+    nvmctrlSim.seeLoaded = true;
+
+    HOST_NVMCTRL_REGS.NVMCTRL_CTRLA = (uint16_t)NVMCTRL_CTRLA_RWS(5U) | NVMCTRL_CTRLA_AUTOWS_Msk;
+}
+
+bool NVMCTRL_Read( uint32_t *data, uint32_t length, const uint32_t address )
+{
+    if ((address >= HOST_NVM_FLASH_SIZE) || (length > (HOST_NVM_FLASH_SIZE - address)))
+    {
+        return false;
+    }
+
+    (void) memcpy(data, &nvmctrlSim.flash[address], length);
+
+    return true;
+}
+
+void NVMCTRL_SetWriteMode( NVMCTRL_WRITEMODE mode )
+{
+    HOST_NVMCTRL_REGS.NVMCTRL_CTRLA = (uint16_t)((HOST_NVMCTRL_REGS.NVMCTRL_CTRLA & (~NVMCTRL_CTRLA_WMODE_Msk)) | mode);
+}
+
+bool NVMCTRL_QuadWordWrite( const uint32_t *data, const uint32_t address )
+{
+    nvm_error = 0U;
+
+    if ((address & 0x0FU) != 0U)
+    {
+        return false;
+    }
+
+    if (NVMCTRL_SIM_CommandStart(address, 16U, HOST_NVM_QUAD_WORD_NS) == true)
+    {
+        NVMCTRL_SIM_Program(data, address, 16U);
+        nvmctrlSim.stats.quadWordWrites++;
+    }
+
+    return true;
+}
+
+bool NVMCTRL_DoubleWordWrite( const uint32_t *data, const uint32_t address )
+{
+    nvm_error = 0U;
+
+    if ((address & 0x07U) != 0U)
+    {
+        return false;
+    }
+
+    if (NVMCTRL_SIM_CommandStart(address, 8U, HOST_NVM_QUAD_WORD_NS) == true)
+    {
+        NVMCTRL_SIM_Program(data, address, 8U);
+        nvmctrlSim.stats.quadWordWrites++;
+    }
+
+    return true;
+}
+
+bool NVMCTRL_PageBufferWrite( const uint32_t *data, const uint32_t address )
+{
+    /* Only the automatic write modes are used by this project */
+    (void) data;
+    (void) address;
+    nvm_error = 0U;
+
+    return false;
+}
+
+bool NVMCTRL_PageBufferCommit( const uint32_t address )
+{
+    (void) address;
+    nvm_error = 0U;
+
+    return false;
+}
+
+bool NVMCTRL_PageWrite( const uint32_t *data, const uint32_t address )
+{
+    nvm_error = 0U;
+
+    if ((address % NVMCTRL_FLASH_PAGESIZE) != 0U)
+    {
+        return false;
+    }
+
+    if (NVMCTRL_SIM_CommandStart(address, NVMCTRL_FLASH_PAGESIZE, HOST_NVM_PAGE_NS) == true)
+    {
+        NVMCTRL_SIM_Program(data, address, NVMCTRL_FLASH_PAGESIZE);
+        nvmctrlSim.stats.pageWrites++;
+    }
+
+    return true;
+}
+
+bool NVMCTRL_BlockErase( uint32_t address )
+{
+    nvm_error = 0U;
+
+    address &= ~(NVMCTRL_FLASH_BLOCKSIZE - 1U);
+
+    if (NVMCTRL_SIM_CommandStart(address, NVMCTRL_FLASH_BLOCKSIZE, HOST_NVM_BLOCK_ERASE_NS) == true)
+    {
+        (void) memset(&nvmctrlSim.flash[address], 0xFF, NVMCTRL_FLASH_BLOCKSIZE);
+        nvmctrlSim.stats.blockErases++;
+    }
+
+    return true;
+}
+
+bool NVMCTRL_USER_ROW_PageWrite( uint32_t *data, const uint32_t address )
+{
+    (void) data;
+    (void) address;
+
+    return false;
+}
+
+bool NVMCTRL_USER_ROW_RowErase( uint32_t address )
+{
+    (void) address;
+
+    return false;
+}
+
+uint16_t NVMCTRL_ErrorGet( void )
+{
+    nvm_error |= nvmctrlSim.intFlag;
+    nvmctrlSim.intFlag &= (uint16_t)~nvm_error;
+
+    return (uint16_t)nvm_error;
+}
+
+uint16_t NVMCTRL_StatusGet( void )
+{
+    return (NVMCTRL_SIM_IsBusy() == true) ? 0U : (uint16_t)NVMCTRL_STATUS_READY_Msk;
+}
+
+bool NVMCTRL_IsBusy( void )
+{
+    if (NVMCTRL_SIM_IsBusy() == true)
+    {
+        HOST_Poll();
+        return true;
+    }
+
+    return false;
+}
+
+void NVMCTRL_RegionLock( uint32_t address )
+{
+    nvmctrlSim.runlock &= ~(1UL << (address / (HOST_NVM_FLASH_SIZE / 32U)));
+}
+
+void NVMCTRL_RegionUnlock( uint32_t address )
+{
+    nvmctrlSim.runlock |= (1UL << (address / (HOST_NVM_FLASH_SIZE / 32U)));
+}
+
+uint32_t NVMCTRL_RegionLockStatusGet( void )
+{
+    return nvmctrlSim.runlock;
+}
+
+void NVMCTRL_SecurityBitSet( void )
+{
+}
+
+bool NVMCTRL_SmartEEPROM_IsBusy( void )
+{
+    if (HOST_TimeGet() < nvmctrlSim.seeBusyUntil)
+    {
+        HOST_Poll();
+        return true;
+    }
+
+    return false;
+}
+
+uint32_t NVMCTRL_SmartEEPROMStatusGet( void )
+{
+    uint32_t status = NVMCTRL_SEESTAT_SBLK(nvmctrlSim.seeBlocks) | NVMCTRL_SEESTAT_PSZ(nvmctrlSim.seePageSize);
+
+    if (HOST_TimeGet() < nvmctrlSim.seeBusyUntil)
+    {
+        status |= NVMCTRL_SEESTAT_BUSY_Msk;
+    }
+
+    return status;
+}
+
+bool NVMCTRL_SmartEEPROM_IsActiveSectorFull( void )
+{
+    return false;
+}
+
+void NVMCTRL_BankSwap( void )
+{
+}
+
+void NVMCTRL_SmartEEPROMSectorReallocate( void )
+{
+}
+
+void NVMCTRL_SmartEEPROMFlushPageBuffer( void )
+{
+    uint64_t start = HOST_TimeGet();
+
+    nvm_error = 0U;
+
+    if (nvmctrlSim.seeBlocks == 0U)
+    {
+        return;
+    }
+
+    /* The flush runs after the flash command in progress */
+    if (NVMCTRL_SIM_IsBusy() == true)
+    {
+        nvmctrlSim.stats.seeFlushesDelayed++;
+        start = nvmctrlSim.flashBusyUntil;
+    }
+
+    (void) memcpy(nvmctrlSim.seeStore, HOST_SEEPROM, NVMCTRL_SIM_SmartEEPROMSize());
+    nvmctrlSim.seeBusyUntil = start + HOST_NVM_SEE_WRITE_NS;
+    nvmctrlSim.stats.seeFlushes++;
+}
+
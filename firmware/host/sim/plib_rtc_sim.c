@@ -0,0 +1,380 @@
+/*******************************************************************************
+  RTC Peripheral Library Simulation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_rtc_sim.c
+
+  Summary:
+    RTC clock/calendar PLIB for host builds.
+
+  Description:
+    Models the RTC in MODE2 as MHC configures it: the 1.024 kHz output of
+    OSCULP32K divided by 1024 clocks the calendar once per second, in every
+    sleep mode. The calendar counts from the reference year 2016 with leap
+    years, as the hardware does. ALARM0 is compared with the calendar at each
+    second under MASK0 and sets its interrupt flag on a match.
+
+    Writing the calendar keeps the phase of the prescaler, so the second
+    boundaries stay where they were.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <string.h>
+#include "peripheral/rtc/plib_rtc.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+#define RTC_SIM_REFERENCE_YEAR      (2016)
+#define RTC_SIM_SECONDS_PER_DAY     (86400)
+
+/* Seconds searched for an alarm match before checking again later */
+#define RTC_SIM_ALARM_SEARCH_S      (RTC_SIM_SECONDS_PER_DAY)
+
+typedef struct
+{
+    /* The calendar read baseSeconds, counted from the reference year, at
+     * the second boundary baseTime */
+    int64_t         baseSeconds;
+    uint64_t        baseTime;
+
+    uint32_t        alarm;
+    uint8_t         mask;
+    uint16_t        intFlag;
+    uint16_t        intEnable;
+
+    RTC_OBJECT      rtcObj;
+    HOST_EVENT      alarmEvent;
+} RTC_SIM_OBJ;
+
+static RTC_SIM_OBJ rtcSim;
+
+/* Days from 1970-01-01 to the given civil date */
+static int64_t RTC_SIM_DaysFromCivil( int64_t year, int64_t month, int64_t day )
+{
+    int64_t era;
+    int64_t yoe;
+    int64_t doy;
+    int64_t doe;
+
+    year -= (month <= 2) ? 1 : 0;
+    era = ((year >= 0) ? year : (year - 399)) / 400;
+    yoe = year - (era * 400);
+    doy = (((153 * (month + ((month > 2) ? -3 : 9))) + 2) / 5) + day - 1;
+    doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+
+    return (era * 146097) + doe - 719468;
+}
+
+static void RTC_SIM_CivilFromDays( int64_t days, int* year, int* month, int* day )
+{
+    int64_t era;
+    int64_t doe;
+    int64_t yoe;
+    int64_t doy;
+    int64_t mp;
+
+    days += 719468;
+    era = ((days >= 0) ? days : (days - 146096)) / 146097;
+    doe = days - (era * 146097);
+    yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+    doy = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+    mp = ((5 * doy) + 2) / 153;
+
+    *day = (int)(doy - (((153 * mp) + 2) / 5) + 1);
+    *month = (int)(mp + ((mp < 10) ? 3 : -9));
+    *year = (int)((yoe + (era * 400)) + ((*month <= 2) ? 1 : 0));
+}
+
+static int64_t RTC_SIM_ReferenceDays( void )
+{
+    return RTC_SIM_DaysFromCivil(RTC_SIM_REFERENCE_YEAR, 1, 1);
+}
+
+/* CLOCK register value for seconds since the reference year */
+static uint32_t RTC_SIM_ClockFromSeconds( int64_t seconds )
+{
+    int year;
+    int month;
+    int day;
+    int64_t days = seconds / RTC_SIM_SECONDS_PER_DAY;
+    int64_t second = seconds % RTC_SIM_SECONDS_PER_DAY;
+
+    RTC_SIM_CivilFromDays(days + RTC_SIM_ReferenceDays(), &year, &month, &day);
+
+    return RTC_MODE2_CLOCK_YEAR((uint32_t)(year - RTC_SIM_REFERENCE_YEAR)) |
+           RTC_MODE2_CLOCK_MONTH((uint32_t)month) |
+           RTC_MODE2_CLOCK_DAY((uint32_t)day) |
+           RTC_MODE2_CLOCK_HOUR((uint32_t)(second / 3600)) |
+           RTC_MODE2_CLOCK_MINUTE((uint32_t)((second / 60) % 60)) |
+           RTC_MODE2_CLOCK_SECOND((uint32_t)(second % 60));
+}
+
+static int64_t RTC_SIM_SecondsFromTm( const struct tm* time )
+{
+    int64_t days = RTC_SIM_DaysFromCivil((int64_t)time->tm_year + 1900, (int64_t)time->tm_mon + 1,
+                                         time->tm_mday) - RTC_SIM_ReferenceDays();
+
+    return (days * RTC_SIM_SECONDS_PER_DAY) + ((int64_t)time->tm_hour * 3600) +
+           ((int64_t)time->tm_min * 60) + time->tm_sec;
+}
+
+static uint32_t RTC_SIM_ClockFromTm( const struct tm* time )
+{
+    return RTC_MODE2_CLOCK_YEAR((uint32_t)(time->tm_year + 1900 - RTC_SIM_REFERENCE_YEAR)) |
+           RTC_MODE2_CLOCK_MONTH((uint32_t)(time->tm_mon + 1)) |
+           RTC_MODE2_CLOCK_DAY((uint32_t)time->tm_mday) |
+           RTC_MODE2_CLOCK_HOUR((uint32_t)time->tm_hour) |
+           RTC_MODE2_CLOCK_MINUTE((uint32_t)time->tm_min) |
+           RTC_MODE2_CLOCK_SECOND((uint32_t)time->tm_sec);
+}
+
+static void RTC_SIM_TmFromClock( uint32_t clock, struct tm* time )
+{
+    time->tm_hour = (int)((clock & RTC_MODE2_CLOCK_HOUR_Msk) >> RTC_MODE2_CLOCK_HOUR_Pos);
+    time->tm_min = (int)((clock & RTC_MODE2_CLOCK_MINUTE_Msk) >> RTC_MODE2_CLOCK_MINUTE_Pos);
+    time->tm_sec = (int)((clock & RTC_MODE2_CLOCK_SECOND_Msk) >> RTC_MODE2_CLOCK_SECOND_Pos);
+    time->tm_mon = (int)((clock & RTC_MODE2_CLOCK_MONTH_Msk) >> RTC_MODE2_CLOCK_MONTH_Pos) - 1;
+    time->tm_year = (int)((clock & RTC_MODE2_CLOCK_YEAR_Msk) >> RTC_MODE2_CLOCK_YEAR_Pos) +
+                    RTC_SIM_REFERENCE_YEAR - 1900;
+    time->tm_mday = (int)((clock & RTC_MODE2_CLOCK_DAY_Msk) >> RTC_MODE2_CLOCK_DAY_Pos);
+}
+
+static int64_t RTC_SIM_SecondsAt( uint64_t time )
+{
+    int64_t ns = (int64_t)(time - rtcSim.baseTime);
+    int64_t seconds = ns / (int64_t)HOST_NS_PER_S;
+
+    /* Round towards the past for a time before the base */
+    if ((ns < 0) && ((seconds * (int64_t)HOST_NS_PER_S) != ns))
+    {
+        seconds--;
+    }
+
+    return rtcSim.baseSeconds + seconds;
+}
+
+static bool RTC_SIM_AlarmMatches( int64_t seconds )
+{
+    static const uint32_t masks[] =
+    {
+        0U,
+        RTC_MODE2_CLOCK_SECOND_Msk,
+        RTC_MODE2_CLOCK_SECOND_Msk | RTC_MODE2_CLOCK_MINUTE_Msk,
+        RTC_MODE2_CLOCK_SECOND_Msk | RTC_MODE2_CLOCK_MINUTE_Msk | RTC_MODE2_CLOCK_HOUR_Msk,
+        RTC_MODE2_CLOCK_SECOND_Msk | RTC_MODE2_CLOCK_MINUTE_Msk | RTC_MODE2_CLOCK_HOUR_Msk |
+            RTC_MODE2_CLOCK_DAY_Msk,
+        RTC_MODE2_CLOCK_SECOND_Msk | RTC_MODE2_CLOCK_MINUTE_Msk | RTC_MODE2_CLOCK_HOUR_Msk |
+            RTC_MODE2_CLOCK_DAY_Msk | RTC_MODE2_CLOCK_MONTH_Msk,
+        0xFFFFFFFFU
+    };
+    uint32_t mask;
+
+    if ((rtcSim.mask == 0U) || (rtcSim.mask >= (sizeof(masks) / sizeof(masks[0]))))
+    {
+        return false;
+    }
+
+    mask = masks[rtcSim.mask];
+
+    return (RTC_SIM_ClockFromSeconds(seconds) & mask) == (rtcSim.alarm & mask);
+}
+
+/* Schedules the check of the next second boundaries for an alarm match */
+static void RTC_SIM_AlarmSchedule( void )
+{
+    int64_t now = RTC_SIM_SecondsAt(HOST_TimeGet());
+    int64_t second;
+
+    HOST_EventCancel(&rtcSim.alarmEvent);
+
+    if ((rtcSim.intEnable & RTC_MODE2_INTENSET_ALARM0_Msk) == 0U)
+    {
+        return;
+    }
+
+    for (second = now + 1; second <= (now + RTC_SIM_ALARM_SEARCH_S); second++)
+    {
+        if (RTC_SIM_AlarmMatches(second) == true)
+        {
+            break;
+        }
+    }
+
+    HOST_EventSchedule(&rtcSim.alarmEvent,
+                       rtcSim.baseTime + (uint64_t)((second - rtcSim.baseSeconds) * (int64_t)HOST_NS_PER_S));
+}
+
+static void RTC_SIM_AlarmEvent( uintptr_t context )
+{
+    (void) context;
+
+    if (RTC_SIM_AlarmMatches(RTC_SIM_SecondsAt(HOST_TimeGet())) == true)
+    {
+        rtcSim.intFlag |= (uint16_t)RTC_MODE2_INTFLAG_ALARM0_Msk;
+        HOST_IRQ_Raise(RTC_IRQn);
+    }
+
+    RTC_SIM_AlarmSchedule();
+}
+
+static void RTC_SIM_InterruptHandler( void )
+{
+    rtcSim.rtcObj.intCause = (RTC_CLOCK_INT_MASK)rtcSim.intFlag & (RTC_CLOCK_INT_MASK)rtcSim.intEnable;
+    rtcSim.intFlag = 0U;
+
+    if (rtcSim.rtcObj.alarmCallback != NULL)
+    {
+        rtcSim.rtcObj.alarmCallback(rtcSim.rtcObj.intCause, rtcSim.rtcObj.context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_RTC_PhaseSet( uint64_t ns )
+{
+    int64_t seconds = RTC_SIM_SecondsAt(HOST_TimeGet());
+
+    /* The next second boundary follows in ns */
+    rtcSim.baseSeconds = seconds + 1;
+    rtcSim.baseTime = HOST_TimeGet() + ns;
+    RTC_SIM_AlarmSchedule();
+}
+
+uint64_t HOST_RTC_NextSecondGet( void )
+{
+    return rtcSim.baseTime +
+           (uint64_t)((RTC_SIM_SecondsAt(HOST_TimeGet()) + 1 - rtcSim.baseSeconds) * (int64_t)HOST_NS_PER_S);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RTC Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void RTC_Initialize( void )
+{
+    (void) memset(&rtcSim, 0, sizeof(rtcSim));
+
+    HOST_EventInit(&rtcSim.alarmEvent, RTC_SIM_AlarmEvent, 0);
+    HOST_IRQ_HandlerSet(RTC_IRQn, RTC_SIM_InterruptHandler);
+
+    rtcSim.baseTime = HOST_TimeGet();
+}
+
+bool RTC_PeriodicIntervalHasCompleted( RTC_PERIODIC_INT_MASK period )
+{
+    (void) period;
+    return false;
+}
+
+bool RTC_RTCCTimeSet( struct tm * initialTime )
+{
+    int64_t elapsed = RTC_SIM_SecondsAt(HOST_TimeGet()) - rtcSim.baseSeconds;
+
+    rtcSim.baseTime += (uint64_t)(elapsed * (int64_t)HOST_NS_PER_S);
+    rtcSim.baseSeconds = RTC_SIM_SecondsFromTm(initialTime);
+
+    RTC_SIM_AlarmSchedule();
+
+    return true;
+}
+
+void RTC_RTCCClockSyncEnable( void )
+{
+}
+
+void RTC_RTCCClockSyncDisable( void )
+{
+}
+
+void RTC_RTCCTimeGet( struct tm * currentTime )
+{
+    RTC_SIM_TmFromClock(RTC_SIM_ClockFromSeconds(RTC_SIM_SecondsAt(HOST_TimeGet())), currentTime);
+}
+
+void RTC_BackupRegisterSet( BACKUP_REGISTER reg, uint32_t value )
+{
+    (void) reg;
+    (void) value;
+}
+
+uint32_t RTC_BackupRegisterGet( BACKUP_REGISTER reg )
+{
+    (void) reg;
+    return 0U;
+}
+
+TAMPER_CHANNEL RTC_TamperSourceGet( void )
+{
+    return 0U;
+}
+
+void RTC_RTCCTimeStampGet( struct tm * timeStamp )
+{
+    RTC_SIM_TmFromClock(0U, timeStamp);
+}
+
+bool RTC_RTCCAlarmSet( struct tm * alarmTime, RTC_ALARM_MASK mask )
+{
+    rtcSim.alarm = RTC_SIM_ClockFromTm(alarmTime);
+    rtcSim.mask = (uint8_t)mask;
+
+    /* Clear a stale alarm flag before arming the interrupt */
+    rtcSim.intFlag &= (uint16_t)~RTC_MODE2_INTFLAG_ALARM0_Msk;
+    rtcSim.intEnable |= (uint16_t)RTC_MODE2_INTENSET_ALARM0_Msk;
+
+    RTC_SIM_AlarmSchedule();
+
+    return true;
+}
+
+void RTC_RTCCCallbackRegister( RTC_CALLBACK callback, uintptr_t context )
+{
+    rtcSim.rtcObj.alarmCallback = callback;
+    rtcSim.rtcObj.context = context;
+}
+
+void RTC_RTCCInterruptEnable( RTC_CLOCK_INT_MASK interrupt )
+{
+    rtcSim.intFlag &= (uint16_t)~interrupt;
+    rtcSim.intEnable |= (uint16_t)interrupt;
+    RTC_SIM_AlarmSchedule();
+}
+
+void RTC_RTCCInterruptDisable( RTC_CLOCK_INT_MASK interrupt )
+{
+    rtcSim.intEnable &= (uint16_t)~interrupt;
+    RTC_SIM_AlarmSchedule();
+}
@@ -0,0 +1,1177 @@
+/*******************************************************************************
+  SDHC1 Register Model
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_sdhc1_regs_sim.c
+
+  Summary:
+    Registers of the SD host controller for host builds.
+
+  Description:
+    plib_sdhc1.c is built unchanged for the host. Its accesses to SDHC1_REGS
+    go through HOST_SDHC1_RegistersGet, which first brings the registers up
+    to date with what the firmware wrote since the last access: resets
+    requested in SRR complete at once, the internal clock is stable as soon
+    as it is enabled, status bits written with one are cleared, and a write
+    to CR starts the command. A write is only seen at the next access, so
+    every access also schedules an event at the current time to pick up the
+    last one.
+
+    The command runs for the time its bits take at the SD clock and then
+    sets its status and the SDHC1 interrupt. With no card in the slot, a
+    command gets no response and ends with a command timeout.
+
+    The card in the slot is an SD memory card of version 2.0: an SDHC card
+    that is addressed in blocks or an SDSC card that is addressed in bytes.
+    It answers the commands drv_sdmmc.c sends, switches to High Speed on
+    CMD6 and moves its data through the ADMA2 descriptor table the PLIB
+    points ASAR at. A write keeps the card busy for HOST_SDCARD_WRITE_BUSY_NS
+    after its last block, so a multi-block write costs that once. The data of
+    a write is only kept when the transfer succeeds.
+
+    A test can cut the power of the card after some more blocks: the blocks
+    written after those are lost, while the firmware, which would have lost
+    its power too, carries on. Putting the card back in powers it again.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <stdlib.h>
+#include <string.h>
+#include "device.h"
+#include "peripheral/sdhc/plib_sdhc1.h"
+#include "driver/sdmmc/drv_sdmmc.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+/* Base clock of the PLIB when CA0R.BASECLKF reads zero, and the clock
+ * multiplier the controller reports */
+#define SDHC1_SIM_BASE_CLOCK            (50000000ULL)
+#define SDHC1_SIM_CLKMULT               (3U)
+
+/* CR is never written with this value, so a write of any command shows */
+#define SDHC1_SIM_CR_IDLE               (0xFFFFU)
+
+/* Clocks to the end of a command: the 48 bit command, the response delay
+ * and the response. Without a response the controller gives up 64 clocks
+ * after the command. */
+#define SDHC1_SIM_CMD_CLOCKS            (48U + 8U)
+#define SDHC1_SIM_RESP48_CLOCKS         (48U)
+#define SDHC1_SIM_RESP136_CLOCKS        (136U)
+#define SDHC1_SIM_TIMEOUT_CLOCKS        (64U)
+
+/* Clocks a data block takes besides its data: the access delay, the start
+ * and end bits and the CRC. A written block adds the CRC status token. A
+ * busy response holds DAT0 low for a few clocks. */
+#define SDHC1_SIM_BLOCK_CLOCKS          (8U + 2U + 16U)
+#define SDHC1_SIM_CRC_STATUS_CLOCKS     (8U)
+#define SDHC1_SIM_BUSY_CLOCKS           (8U)
+
+/* Time after which the controller reports a data timeout */
+#define SDHC1_SIM_DATA_TIMEOUT_NS       (1ULL * HOST_NS_PER_MS)
+
+/* Highest SD clock of Default Speed */
+#define SDHC1_SIM_DS_FREQUENCY          (25000000ULL)
+
+/* Registers the firmware can only read */
+#define SDHC1_SIM_PSR                   (*(volatile uint32_t*)&sdhc1Sim.regs.SDHC_PSR)
+#define SDHC1_SIM_CA0R                  (*(volatile uint32_t*)&sdhc1Sim.regs.SDHC_CA0R)
+#define SDHC1_SIM_CA1R                  (*(volatile uint32_t*)&sdhc1Sim.regs.SDHC_CA1R)
+
+/* Card states and card status bits of the SD specification */
+#define SDCARD_STATE_IDLE               (0U)
+#define SDCARD_STATE_READY              (1U)
+#define SDCARD_STATE_IDENT              (2U)
+#define SDCARD_STATE_STBY               (3U)
+#define SDCARD_STATE_TRAN               (4U)
+#define SDCARD_STATE_DATA               (5U)
+#define SDCARD_STATE_RCV                (6U)
+
+#define SDCARD_STATUS_OUT_OF_RANGE      (1UL << 31U)
+#define SDCARD_STATUS_ADDRESS_ERROR     (1UL << 30U)
+#define SDCARD_STATUS_READY_FOR_DATA    (1UL << 8U)
+#define SDCARD_STATUS_APP_CMD           (1UL << 5U)
+
+#define SDCARD_OCR_VOLTAGES             (0x00FF8000UL)
+#define SDCARD_OCR_CCS                  (1UL << 30U)
+#define SDCARD_OCR_READY                (1UL << 31U)
+
+#define SDCARD_RCA                      (0x5A5AU)
+#define SDCARD_BLOCK_SIZE               (512U)
+
+/* Response types of the SD specification, as far as the model needs them */
+typedef enum
+{
+    SDCARD_RESP_NONE,
+    SDCARD_RESP_48,
+    SDCARD_RESP_136,
+} SDCARD_RESP;
+
+typedef struct
+{
+    uint8_t*                data;
+    uint32_t                blocks;
+    bool                    highCapacity;
+    bool                    inserted;
+
+    uint32_t                state;
+    bool                    appCmd;
+    uint16_t                rca;
+    uint32_t                opCondPolls;
+    bool                    highSpeed;
+    bool                    wideBus;
+
+    bool                    highSpeedErrors;
+    uint32_t                writeErrors;
+
+    /* Writes that cover errorBlock fail errorBlockCount more times */
+    uint32_t                errorBlock;
+    uint32_t                errorBlockCount;
+
+    /* Once isPowerCut is set, only powerBlocks more blocks are kept */
+    bool                    isPowerCut;
+    uint32_t                powerBlocks;
+
+    HOST_SDCARD_STATISTICS  stats;
+} SDHC1_SIM_CARD;
+
+/* Data phase of the command in progress */
+typedef struct
+{
+    bool                    active;
+    bool                    read;
+    uint8_t*                staging;
+    uint32_t                size;
+
+    /* Where a successful write goes on the card, NULL for a register */
+    uint8_t*                target;
+    uint32_t                firstBlock;
+    uint32_t                blocks;
+
+    /* Status the data phase ends with */
+    uint16_t                error;
+} SDHC1_SIM_DATA;
+
+typedef struct
+{
+    sdhc_registers_t    regs;
+
+    /* Status as the controller set it; a write to NISTR or EISTR that
+     * differs from it clears the bits written with one */
+    uint16_t            nistr;
+    uint16_t            eistr;
+
+    uint16_t            command;
+    uint32_t            response[4];
+    bool                responded;
+
+    SDHC1_SIM_DATA      data;
+    SDHC1_SIM_CARD      card;
+
+    HOST_EVENT          syncEvent;
+    HOST_EVENT          commandEvent;
+    HOST_EVENT          dataEvent;
+} SDHC1_SIM_OBJ;
+
+static SDHC1_SIM_OBJ sdhc1Sim;
+
+/* Handler of plib_sdhc1.c, called by SDHC1_Handler of interrupts.c */
+void SDHC1_InterruptHandler( void );
+
+static void SDHC1_SIM_Sync( void );
+static void SDHC1_SIM_InterruptHandler( void );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SD Card
+// *****************************************************************************
+// *****************************************************************************
+
+/* Registers of the card, most significant byte first and without the CRC
+ * byte of CID and CSD, which the controller drops */
+static const uint8_t sdcardCid[15] =
+{
+    0x1D, 'A', 'D', 'S', 'I', 'M', 'C', 'D', 0x10, 0x12, 0x34, 0x56, 0x78, 0x01, 0x9A
+};
+
+/* SCR: version 3.0x, 1 and 4 bit bus */
+static const uint8_t sdcardScr[8] = { 0x02, 0x35, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+static void SDHC1_SIM_CardReset( void )
+{
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+
+    card->state = SDCARD_STATE_IDLE;
+    card->appCmd = false;
+    card->rca = 0U;
+    card->opCondPolls = 0U;
+    card->highSpeed = false;
+    card->wideBus = false;
+}
+
+/* CSD of version 2.0 for SDHC, of version 1.0 for SDSC, at 25 MHz with
+ * 512 byte blocks */
+static void SDHC1_SIM_CardCsd( uint8_t* csd )
+{
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+    uint32_t cSize;
+
+    (void) memset(csd, 0, 15);
+
+    csd[1] = 0x0EU;
+    csd[3] = 0x32U;
+    csd[4] = 0x5BU;
+    csd[5] = 0x59U;
+
+    if (card->highCapacity == true)
+    {
+        /* C_SIZE in bits 69:48 counts 512 KB */
+        cSize = (card->blocks / 1024U) - 1U;
+        csd[0] = 0x40U;
+        csd[7] = (uint8_t)((cSize >> 16) & 0x3FU);
+        csd[8] = (uint8_t)(cSize >> 8);
+        csd[9] = (uint8_t)cSize;
+    }
+    else
+    {
+        /* C_SIZE in bits 73:62 counts C_SIZE_MULT 7, 512 blocks */
+        cSize = (card->blocks / 512U) - 1U;
+        csd[6] = (uint8_t)((cSize >> 10) & 0x03U);
+        csd[7] = (uint8_t)(cSize >> 2);
+        csd[8] = (uint8_t)((cSize & 0x03U) << 6);
+        csd[9] = 0x03U;
+        csd[10] = 0x80U;
+    }
+}
+
+/* Places a 136 bit response in RR as the controller does: bits 127:8 of the
+ * register, least significant byte first */
+static void SDHC1_SIM_Response136( const uint8_t* reg )
+{
+    uint32_t i;
+
+    (void) memset(sdhc1Sim.response, 0, sizeof(sdhc1Sim.response));
+
+    for (i = 0U; i < 15U; i++)
+    {
+        sdhc1Sim.response[i / 4U] |= (uint32_t)reg[14U - i] << ((i % 4U) * 8U);
+    }
+}
+
+/* Checks the address of a block command and returns its first block */
+static bool SDHC1_SIM_CardAddress( uint32_t argument, uint32_t blocks, uint32_t* first, uint32_t* status )
+{
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+
+    if (card->highCapacity == true)
+    {
+        *first = argument;
+    }
+    else if ((argument % SDCARD_BLOCK_SIZE) != 0U)
+    {
+        *status |= SDCARD_STATUS_ADDRESS_ERROR;
+        return false;
+    }
+    else
+    {
+        *first = argument / SDCARD_BLOCK_SIZE;
+    }
+
+    if ((*first >= card->blocks) || (blocks > (card->blocks - *first)))
+    {
+        *status |= SDCARD_STATUS_OUT_OF_RANGE;
+        return false;
+    }
+
+    return true;
+}
+
+/* Blocks the controller transfers for the command in TMR, BCR and BSR */
+static uint32_t SDHC1_SIM_BlockCount( void )
+{
+    if (((sdhc1Sim.regs.SDHC_TMR & SDHC_TMR_MSBSEL_Msk) != 0U) && (sdhc1Sim.regs.SDHC_BCR > 1U))
+    {
+        return sdhc1Sim.regs.SDHC_BCR;
+    }
+
+    return 1U;
+}
+
+static uint32_t SDHC1_SIM_BlockSize( void )
+{
+    return (uint32_t)(sdhc1Sim.regs.SDHC_BSR & SDHC_BSR_BLOCKSIZE_Msk) >> SDHC_BSR_BLOCKSIZE_Pos;
+}
+
+static uint64_t SDHC1_SIM_Frequency( void )
+{
+    uint32_t divider = ((uint32_t)(sdhc1Sim.regs.SDHC_CCR & SDHC_CCR_SDCLKFSEL_Msk) >> SDHC_CCR_SDCLKFSEL_Pos) |
+                       (((uint32_t)(sdhc1Sim.regs.SDHC_CCR & SDHC_CCR_USDCLKFSEL_Msk) >> SDHC_CCR_USDCLKFSEL_Pos) << 8U);
+
+    return (SDHC1_SIM_BASE_CLOCK * (SDHC1_SIM_CLKMULT + 1U)) / (divider + 1U);
+}
+
+/* Prepares the data phase of a command with data: a read stages what the
+ * card sends, a write what the DMA fetches. The DMA moves it at the end. */
+static void SDHC1_SIM_DataPrepare( bool read, const uint8_t* source, uint8_t* target, uint32_t size )
+{
+    SDHC1_SIM_DATA* data = &sdhc1Sim.data;
+
+    data->active = true;
+    data->read = read;
+    data->size = size;
+    data->target = target;
+    data->error = 0U;
+    data->staging = malloc(size);
+
+    if (data->staging == NULL)
+    {
+        abort();
+    }
+
+    if (source != NULL)
+    {
+        (void) memcpy(data->staging, source, size);
+    }
+}
+
+/* Runs a command on the card. Returns false if the card does not respond,
+ * as for a command that is illegal in its state. */
+static bool SDHC1_SIM_CardCommand( uint8_t index, uint32_t argument, SDCARD_RESP* type )
+{
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+    uint32_t status = ((uint32_t)card->state << 9) | SDCARD_STATUS_READY_FOR_DATA;
+    bool appCmd = card->appCmd;
+    uint8_t reg[64];
+    uint32_t blocks;
+    uint32_t first = 0U;
+
+    card->appCmd = false;
+    *type = SDCARD_RESP_48;
+
+    if (appCmd == true)
+    {
+        status |= SDCARD_STATUS_APP_CMD;
+
+        switch (index)
+        {
+            case SDHC_CMD_SD_SEND_OP_COND:
+                if (card->state != SDCARD_STATE_IDLE)
+                {
+                    return false;
+                }
+
+                sdhc1Sim.response[0] = SDCARD_OCR_VOLTAGES;
+
+                /* The first inquiry without voltages only reads the OCR;
+                 * the card is busy once more before it is ready */
+                if ((argument & 0x00FFFFFFUL) != 0U)
+                {
+                    card->opCondPolls++;
+
+                    if ((card->opCondPolls >= 2U) &&
+                        ((card->highCapacity == false) || ((argument & SDCARD_OCR_CCS) != 0U)))
+                    {
+                        sdhc1Sim.response[0] |= SDCARD_OCR_READY;
+                        sdhc1Sim.response[0] |= (card->highCapacity == true) ? SDCARD_OCR_CCS : 0U;
+                        card->state = SDCARD_STATE_READY;
+                    }
+                }
+                return true;
+
+            case SDHC_CMD_SET_BUS_WIDTH:
+                if (card->state != SDCARD_STATE_TRAN)
+                {
+                    return false;
+                }
+                card->wideBus = ((argument & 0x03U) == 0x02U);
+                break;
+
+            case SDHC_CMD_READ_SCR:
+                if (card->state != SDCARD_STATE_TRAN)
+                {
+                    return false;
+                }
+                SDHC1_SIM_DataPrepare(true, sdcardScr, NULL, sizeof(sdcardScr));
+                break;
+
+            case SDHC_CMD_SET_WR_BLK_ERASE_COUNT:
+                if (card->state != SDCARD_STATE_TRAN)
+                {
+                    return false;
+                }
+                card->stats.preErases++;
+                break;
+
+            case SDHC_CMD_APP_CMD:
+                card->appCmd = true;
+                break;
+
+            default:
+                return false;
+        }
+
+        sdhc1Sim.response[0] = status;
+        return true;
+    }
+
+    switch (index)
+    {
+        case SDHC_CMD_GO_IDLE_STATE:
+            SDHC1_SIM_CardReset();
+            card->stats.resets++;
+            *type = SDCARD_RESP_NONE;
+            return true;
+
+        case SDHC_CMD_SEND_IF_COND:
+            if (card->state != SDCARD_STATE_IDLE)
+            {
+                return false;
+            }
+            sdhc1Sim.response[0] = argument & 0xFFFU;
+            return true;
+
+        case SDHC_CMD_APP_CMD:
+            card->appCmd = true;
+            sdhc1Sim.response[0] = status | SDCARD_STATUS_APP_CMD;
+            return true;
+
+        case SDHC_CMD_ALL_SEND_CID:
+            if (card->state != SDCARD_STATE_READY)
+            {
+                return false;
+            }
+            card->state = SDCARD_STATE_IDENT;
+            SDHC1_SIM_Response136(sdcardCid);
+            *type = SDCARD_RESP_136;
+            return true;
+
+        case SDHC_CMD_SEND_RCA:
+            if ((card->state != SDCARD_STATE_IDENT) && (card->state != SDCARD_STATE_STBY))
+            {
+                return false;
+            }
+            card->state = SDCARD_STATE_STBY;
+            card->rca = SDCARD_RCA;
+            sdhc1Sim.response[0] = ((uint32_t)card->rca << 16) | (status & 0x1FFFU);
+            return true;
+
+        case SDHC_CMD_SEND_CSD:
+            if ((card->state != SDCARD_STATE_STBY) || ((argument >> 16) != card->rca))
+            {
+                return false;
+            }
+            SDHC1_SIM_CardCsd(reg);
+            SDHC1_SIM_Response136(reg);
+            *type = SDCARD_RESP_136;
+            return true;
+
+        case SDHC_CMD_SELECT_DESELECT_CARD:
+            if ((argument >> 16) != card->rca)
+            {
+                /* Deselected cards do not respond */
+                if (card->state >= SDCARD_STATE_TRAN)
+                {
+                    card->state = SDCARD_STATE_STBY;
+                }
+                *type = SDCARD_RESP_NONE;
+                return true;
+            }
+            if (card->state < SDCARD_STATE_STBY)
+            {
+                return false;
+            }
+            card->state = SDCARD_STATE_TRAN;
+            break;
+
+        case SDHC_CMD_SWITCH:
+            if (card->state != SDCARD_STATE_TRAN)
+            {
+                return false;
+            }
+
+            /* Function group 1 supports Default and High Speed, and the
+             * function the argument selects would be (or was) switched to */
+            (void) memset(reg, 0, sizeof(reg));
+            reg[13] = 0x03U;
+            reg[16] = (uint8_t)(argument & 0x0FU);
+
+            if (((argument & (1UL << 31)) != 0U) && ((argument & 0x0FU) == 0x01U))
+            {
+                card->highSpeed = true;
+                card->stats.highSpeedSwitches++;
+            }
+            SDHC1_SIM_DataPrepare(true, reg, NULL, sizeof(reg));
+            break;
+
+        case SDHC_CMD_SEND_STATUS:
+        case SDHC_CMD_SET_BLOCKLEN:
+            if ((card->state < SDCARD_STATE_STBY) ||
+                ((index == SDHC_CMD_SEND_STATUS) && ((argument >> 16) != card->rca)))
+            {
+                return false;
+            }
+            break;
+
+        case SDHC_CMD_STOP_TRANSMISSION:
+            if ((card->state != SDCARD_STATE_DATA) && (card->state != SDCARD_STATE_RCV))
+            {
+                return false;
+            }
+            card->state = SDCARD_STATE_TRAN;
+            break;
+
+        case SDHC_CMD_READ_SINGLE_BLOCK:
+        case SDHC_CMD_READ_MULTI_BLOCK:
+        case SDHC_CMD_WRITE_SINGLE_BLOCK:
+        case SDHC_CMD_WRITE_MULTI_BLOCK:
+            if (card->state != SDCARD_STATE_TRAN)
+            {
+                return false;
+            }
+
+            blocks = SDHC1_SIM_BlockCount();
+
+            if (SDHC1_SIM_CardAddress(argument, blocks, &first, &status) == false)
+            {
+                /* No data follows; the controller times out waiting */
+                SDHC1_SIM_DataPrepare(true, NULL, NULL, 0U);
+                sdhc1Sim.data.error = SDHC_EISTR_DATTEO_Msk;
+            }
+            else if ((index == SDHC_CMD_READ_SINGLE_BLOCK) || (index == SDHC_CMD_READ_MULTI_BLOCK))
+            {
+                card->stats.readCommands++;
+                card->state = SDCARD_STATE_DATA;
+                SDHC1_SIM_DataPrepare(true, &card->data[first * SDCARD_BLOCK_SIZE], NULL,
+                                      blocks * SDCARD_BLOCK_SIZE);
+            }
+            else
+            {
+                card->stats.writeCommands++;
+                card->stats.multiBlockWrites += (index == SDHC_CMD_WRITE_MULTI_BLOCK) ? 1U : 0U;
+                card->state = SDCARD_STATE_RCV;
+                SDHC1_SIM_DataPrepare(false, NULL, &card->data[first * SDCARD_BLOCK_SIZE],
+                                      blocks * SDCARD_BLOCK_SIZE);
+            }
+
+            sdhc1Sim.data.firstBlock = first;
+            sdhc1Sim.data.blocks = blocks;
+            break;
+
+        default:
+            return false;
+    }
+
+    sdhc1Sim.response[0] = status;
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Controller
+// *****************************************************************************
+// *****************************************************************************
+
+/* Registers after a power on or a SWRSTALL. The card detect pin is not a
+ * register and keeps its level. */
+static void SDHC1_SIM_RegistersReset( void )
+{
+    (void) memset(&sdhc1Sim.regs, 0, sizeof(sdhc1Sim.regs));
+
+    SDHC1_SIM_CA0R = SDHC_CA0R_BASECLKF(0U);
+    SDHC1_SIM_CA1R = SDHC_CA1R_CLKMULT(SDHC1_SIM_CLKMULT);
+    SDHC1_SIM_PSR = SDHC_PSR_CARDSS_Msk | SDHC_PSR_WRPPL_Msk;
+    SDHC1_SIM_PSR |= (sdhc1Sim.card.inserted == true) ? SDHC_PSR_CARDINS_Msk : 0U;
+    sdhc1Sim.regs.SDHC_CR = SDHC1_SIM_CR_IDLE;
+    sdhc1Sim.nistr = 0U;
+    sdhc1Sim.eistr = 0U;
+
+    free(sdhc1Sim.data.staging);
+    (void) memset(&sdhc1Sim.data, 0, sizeof(sdhc1Sim.data));
+
+    HOST_EventCancel(&sdhc1Sim.commandEvent);
+    HOST_EventCancel(&sdhc1Sim.dataEvent);
+}
+
+static uint64_t SDHC1_SIM_ClocksToNs( uint64_t clocks )
+{
+    uint64_t frequency = SDHC1_SIM_Frequency();
+
+    return ((clocks * HOST_NS_PER_S) + frequency - 1U) / frequency;
+}
+
+/* Raises the interrupt if an enabled status is set */
+static void SDHC1_SIM_InterruptUpdate( void )
+{
+    if (sdhc1Sim.eistr != 0U)
+    {
+        sdhc1Sim.nistr |= SDHC_NISTR_ERRINT_Msk;
+    }
+    else
+    {
+        sdhc1Sim.nistr &= (uint16_t)(~SDHC_NISTR_ERRINT_Msk);
+    }
+
+    sdhc1Sim.regs.SDHC_NISTR = sdhc1Sim.nistr;
+    sdhc1Sim.regs.SDHC_EISTR = sdhc1Sim.eistr;
+
+    if (((sdhc1Sim.nistr & sdhc1Sim.regs.SDHC_NISIER) != 0U) ||
+        ((sdhc1Sim.eistr & sdhc1Sim.regs.SDHC_EISIER) != 0U))
+    {
+        HOST_IRQ_Raise(SDHC1_IRQn);
+    }
+}
+
+/* Moves the staged data between the card and the memory the ADMA2
+ * descriptor table describes. The table and the buffers are addressed with
+ * 32 bits, as on the device. */
+static bool SDHC1_SIM_DmaTransfer( void )
+{
+    SDHC1_SIM_DATA* data = &sdhc1Sim.data;
+    const SDHC_ADMA_DESCR* descr = (const SDHC_ADMA_DESCR*)(uintptr_t)sdhc1Sim.regs.SDHC_ASAR[0];
+    uint32_t offset = 0U;
+    uint32_t lines = 0U;
+    bool end = false;
+
+    while ((offset < data->size) && (end == false))
+    {
+        uint32_t length = (descr->length == 0U) ? 65536U : descr->length;
+        uint8_t* memory = (uint8_t*)(uintptr_t)descr->address;
+
+        if ((descr->attribute & SDHC_DESC_TABLE_ATTR_VALID) == 0U)
+        {
+            return false;
+        }
+
+        lines++;
+        end = ((descr->attribute & SDHC_DESC_TABLE_ATTR_END) != 0U);
+
+        if ((descr->attribute & (0x03U << 4U)) == SDHC_DESC_TABLE_ATTR_XFER_DATA)
+        {
+            if (length > (data->size - offset))
+            {
+                length = data->size - offset;
+            }
+
+            if (data->read == true)
+            {
+                (void) memcpy(memory, &data->staging[offset], length);
+            }
+            else
+            {
+                (void) memcpy(&data->staging[offset], memory, length);
+            }
+
+            offset += length;
+        }
+
+        descr++;
+    }
+
+    if (lines > sdhc1Sim.card.stats.descriptorLines)
+    {
+        sdhc1Sim.card.stats.descriptorLines = lines;
+    }
+
+    /* The table ended before the blocks did */
+    return (offset == data->size);
+}
+
+/* Stores the blocks of a write, as far as the power of the card lasts */
+static void SDHC1_SIM_WriteKeep( const SDHC1_SIM_DATA* data, SDHC1_SIM_CARD* card )
+{
+    uint32_t blocks = data->blocks;
+
+    if (card->isPowerCut == true)
+    {
+        blocks = (blocks < card->powerBlocks) ? blocks : card->powerBlocks;
+        card->powerBlocks -= blocks;
+    }
+
+    (void) memcpy(data->target, data->staging, (size_t)blocks * SDCARD_BLOCK_SIZE);
+}
+
+/* End of the data phase, or of the busy signal of an R1b response */
+static void SDHC1_SIM_DataEnd( uintptr_t context )
+{
+    SDHC1_SIM_DATA* data = &sdhc1Sim.data;
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+
+    (void) context;
+
+    SDHC1_SIM_Sync();
+    SDHC1_SIM_PSR &= ~SDHC_PSR_CMDINHD_Msk;
+
+    if (data->active == true)
+    {
+        if ((data->error == 0U) && (SDHC1_SIM_DmaTransfer() == false))
+        {
+            data->error = SDHC_EISTR_ADMA_Msk;
+        }
+
+        if (data->error == 0U)
+        {
+            if (data->read == true)
+            {
+                card->stats.blocksRead += data->blocks;
+            }
+            else if (data->target != NULL)
+            {
+                SDHC1_SIM_WriteKeep(data, card);
+                card->stats.blocksWritten += data->blocks;
+                card->stats.lastWriteBlock = data->firstBlock;
+                card->stats.lastWriteCount = data->blocks;
+            }
+            else
+            {
+                /* Do Nothing */
+            }
+
+            sdhc1Sim.nistr |= SDHC_NISTR_TRFC_Msk;
+        }
+        else
+        {
+            card->stats.dataErrors += (data->error == SDHC_EISTR_DATCRC_Msk) ? 1U : 0U;
+            sdhc1Sim.eistr |= data->error;
+        }
+
+        /* A single block ends the transfer; several wait for CMD12 */
+        if ((card->state >= SDCARD_STATE_DATA) &&
+            ((data->error != 0U) || ((sdhc1Sim.regs.SDHC_TMR & SDHC_TMR_MSBSEL_Msk) == 0U)))
+        {
+            card->state = SDCARD_STATE_TRAN;
+        }
+
+        free(data->staging);
+        (void) memset(data, 0, sizeof(*data));
+    }
+    else
+    {
+        sdhc1Sim.nistr |= SDHC_NISTR_TRFC_Msk;
+    }
+
+    SDHC1_SIM_InterruptUpdate();
+}
+
+/* Starts the data phase that follows the response: the blocks at the SD
+ * clock and bus width, and for a write the programming time */
+static void SDHC1_SIM_DataStart( void )
+{
+    SDHC1_SIM_DATA* data = &sdhc1Sim.data;
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+    bool hostWide = ((sdhc1Sim.regs.SDHC_HC1R & SDHC_HC1R_DW_Msk) == SDHC_HC1R_DW_4BIT);
+    uint32_t blockSize = (data->target != NULL) ? SDCARD_BLOCK_SIZE : SDHC1_SIM_BlockSize();
+    uint32_t blocks = (blockSize == 0U) ? 1U : ((data->size + blockSize - 1U) / blockSize);
+    uint64_t clocks = (uint64_t)blocks * ((((uint64_t)blockSize * 8U) / ((hostWide == true) ? 4U : 1U)) +
+                                          SDHC1_SIM_BLOCK_CLOCKS);
+    uint64_t ns;
+
+    if (data->error == 0U)
+    {
+        if (hostWide != card->wideBus)
+        {
+            data->error = SDHC_EISTR_DATCRC_Msk;
+        }
+        else if ((card->highSpeed == true) && (card->highSpeedErrors == true) &&
+                 (SDHC1_SIM_Frequency() > SDHC1_SIM_DS_FREQUENCY))
+        {
+            data->error = SDHC_EISTR_DATCRC_Msk;
+        }
+        else if ((data->read == false) && (card->writeErrors > 0U))
+        {
+            card->writeErrors--;
+            data->error = SDHC_EISTR_DATCRC_Msk;
+        }
+        else if ((data->read == false) && (data->target != NULL) && (card->errorBlockCount > 0U) &&
+                 (card->errorBlock >= data->firstBlock) &&
+                 (card->errorBlock < (data->firstBlock + data->blocks)))
+        {
+            card->errorBlockCount--;
+            data->error = SDHC_EISTR_DATCRC_Msk;
+        }
+        else
+        {
+            /* Do Nothing */
+        }
+    }
+
+    if (data->read == false)
+    {
+        /* The DMA fetches the data as the blocks go out */
+        if ((data->error == 0U) && (SDHC1_SIM_DmaTransfer() == false))
+        {
+            data->error = SDHC_EISTR_ADMA_Msk;
+        }
+
+        clocks += (uint64_t)blocks * SDHC1_SIM_CRC_STATUS_CLOCKS;
+    }
+
+    if (data->error == SDHC_EISTR_DATTEO_Msk)
+    {
+        ns = SDHC1_SIM_DATA_TIMEOUT_NS;
+    }
+    else
+    {
+        ns = SDHC1_SIM_ClocksToNs(clocks);
+        ns += ((data->read == false) && (data->error == 0U)) ? HOST_SDCARD_WRITE_BUSY_NS : 0U;
+    }
+
+    HOST_EventSchedule(&sdhc1Sim.dataEvent, HOST_TimeGet() + ns);
+}
+
+static void SDHC1_SIM_CommandEnd( uintptr_t context )
+{
+    uint16_t command = sdhc1Sim.command;
+
+    (void) context;
+
+    SDHC1_SIM_Sync();
+
+    SDHC1_SIM_PSR &= ~SDHC_PSR_CMDINHC_Msk;
+
+    if (sdhc1Sim.responded == false)
+    {
+        SDHC1_SIM_PSR &= ~SDHC_PSR_CMDINHD_Msk;
+        sdhc1Sim.eistr |= SDHC_EISTR_CMDTEO_Msk;
+    }
+    else
+    {
+        (void) memcpy((void*)sdhc1Sim.regs.SDHC_RR, sdhc1Sim.response, sizeof(sdhc1Sim.response));
+        sdhc1Sim.nistr |= SDHC_NISTR_CMDC_Msk;
+
+        if ((command & SDHC_CR_DPSEL_Msk) != 0U)
+        {
+            if (sdhc1Sim.data.active == false)
+            {
+                /* The card sends no data for this command */
+                SDHC1_SIM_DataPrepare(true, NULL, NULL, 0U);
+                sdhc1Sim.data.error = SDHC_EISTR_DATTEO_Msk;
+            }
+            SDHC1_SIM_DataStart();
+        }
+        else if ((command & SDHC_CR_RESPTYP_Msk) == SDHC_CR_RESPTYP_48_BIT_BUSY)
+        {
+            HOST_EventSchedule(&sdhc1Sim.dataEvent, HOST_TimeGet() + SDHC1_SIM_ClocksToNs(SDHC1_SIM_BUSY_CLOCKS));
+        }
+        else
+        {
+            SDHC1_SIM_PSR &= ~SDHC_PSR_CMDINHD_Msk;
+        }
+    }
+
+    SDHC1_SIM_InterruptUpdate();
+}
+
+static void SDHC1_SIM_CommandStart( uint16_t command )
+{
+    uint8_t index = (uint8_t)((command & SDHC_CR_CMDIDX_Msk) >> SDHC_CR_CMDIDX_Pos);
+    uint32_t clocks = SDHC1_SIM_CMD_CLOCKS + SDHC1_SIM_TIMEOUT_CLOCKS;
+    SDCARD_RESP type = SDCARD_RESP_NONE;
+
+    sdhc1Sim.command = command;
+    SDHC1_SIM_PSR |= SDHC_PSR_CMDINHC_Msk;
+
+    if (((command & SDHC_CR_DPSEL_Msk) != 0U) ||
+        ((command & SDHC_CR_RESPTYP_Msk) == SDHC_CR_RESPTYP_48_BIT_BUSY))
+    {
+        SDHC1_SIM_PSR |= SDHC_PSR_CMDINHD_Msk;
+    }
+
+    /* The card acts on the command as it receives it */
+    free(sdhc1Sim.data.staging);
+    (void) memset(&sdhc1Sim.data, 0, sizeof(sdhc1Sim.data));
+    sdhc1Sim.responded = false;
+
+    if (sdhc1Sim.card.inserted == true)
+    {
+        sdhc1Sim.responded = SDHC1_SIM_CardCommand(index, sdhc1Sim.regs.SDHC_ARG1R, &type);
+        sdhc1Sim.card.stats.commands += (sdhc1Sim.responded == true) ? 1U : 0U;
+    }
+
+    /* A command that expects no response ends without a timeout */
+    if ((command & SDHC_CR_RESPTYP_Msk) == SDHC_CR_RESPTYP_NONE)
+    {
+        sdhc1Sim.responded = true;
+        clocks = SDHC1_SIM_CMD_CLOCKS;
+    }
+    else if ((sdhc1Sim.responded == true) && (type != SDCARD_RESP_NONE))
+    {
+        clocks = SDHC1_SIM_CMD_CLOCKS +
+                 ((type == SDCARD_RESP_136) ? SDHC1_SIM_RESP136_CLOCKS : SDHC1_SIM_RESP48_CLOCKS);
+    }
+    else
+    {
+        sdhc1Sim.responded = false;
+    }
+
+    HOST_EventSchedule(&sdhc1Sim.commandEvent, HOST_TimeGet() + SDHC1_SIM_ClocksToNs(clocks));
+}
+
+/* Applies what the firmware wrote since the last access */
+static void SDHC1_SIM_Sync( void )
+{
+    sdhc_registers_t* regs = &sdhc1Sim.regs;
+
+    if ((regs->SDHC_SRR & SDHC_SRR_SWRSTALL_Msk) != 0U)
+    {
+        /* SDHC1_Initialize resets the module after each HOST_Reset */
+        SDHC1_SIM_RegistersReset();
+        HOST_IRQ_HandlerSet(SDHC1_IRQn, SDHC1_SIM_InterruptHandler);
+        return;
+    }
+
+    if ((regs->SDHC_SRR & SDHC_SRR_SWRSTCMD_Msk) != 0U)
+    {
+        SDHC1_SIM_PSR &= ~SDHC_PSR_CMDINHC_Msk;
+        HOST_EventCancel(&sdhc1Sim.commandEvent);
+    }
+
+    if ((regs->SDHC_SRR & SDHC_SRR_SWRSTDAT_Msk) != 0U)
+    {
+        SDHC1_SIM_PSR &= ~SDHC_PSR_CMDINHD_Msk;
+        HOST_EventCancel(&sdhc1Sim.dataEvent);
+        free(sdhc1Sim.data.staging);
+        (void) memset(&sdhc1Sim.data, 0, sizeof(sdhc1Sim.data));
+    }
+
+    regs->SDHC_SRR = 0U;
+
+    if ((regs->SDHC_CCR & SDHC_CCR_INTCLKEN_Msk) != 0U)
+    {
+        regs->SDHC_CCR |= SDHC_CCR_INTCLKS_Msk;
+    }
+    else
+    {
+        regs->SDHC_CCR &= (uint16_t)(~SDHC_CCR_INTCLKS_Msk);
+    }
+
+    if (regs->SDHC_NISTR != sdhc1Sim.nistr)
+    {
+        sdhc1Sim.nistr &= (uint16_t)(~regs->SDHC_NISTR);
+    }
+
+    if (regs->SDHC_EISTR != sdhc1Sim.eistr)
+    {
+        sdhc1Sim.eistr &= (uint16_t)(~regs->SDHC_EISTR);
+    }
+
+    if (sdhc1Sim.eistr == 0U)
+    {
+        sdhc1Sim.nistr &= (uint16_t)(~SDHC_NISTR_ERRINT_Msk);
+    }
+
+    regs->SDHC_NISTR = sdhc1Sim.nistr;
+    regs->SDHC_EISTR = sdhc1Sim.eistr;
+
+    if (regs->SDHC_CR != SDHC1_SIM_CR_IDLE)
+    {
+        uint16_t command = regs->SDHC_CR;
+
+        regs->SDHC_CR = SDHC1_SIM_CR_IDLE;
+        SDHC1_SIM_CommandStart(command);
+    }
+}
+
+static void SDHC1_SIM_SyncEvent( uintptr_t context )
+{
+    (void) context;
+
+    SDHC1_SIM_Sync();
+}
+
+/* The PLIB's handler writes back the status it read to clear it. That write
+ * is the value the registers already hold, so it is applied here. */
+static void SDHC1_SIM_InterruptHandler( void )
+{
+    uint16_t nistr;
+    uint16_t eistr;
+
+    SDHC1_SIM_Sync();
+    nistr = sdhc1Sim.nistr;
+    eistr = sdhc1Sim.eistr;
+
+    SDHC1_InterruptHandler();
+
+    SDHC1_SIM_Sync();
+    sdhc1Sim.nistr &= (uint16_t)(~nistr);
+    sdhc1Sim.eistr &= (uint16_t)(~eistr);
+    sdhc1Sim.regs.SDHC_NISTR = sdhc1Sim.nistr;
+    sdhc1Sim.regs.SDHC_EISTR = sdhc1Sim.eistr;
+}
+
+static void SDHC1_SIM_PowerOn( void )
+{
+    static bool powered = false;
+
+    if (powered == false)
+    {
+        powered = true;
+        HOST_EventInit(&sdhc1Sim.syncEvent, SDHC1_SIM_SyncEvent, 0U);
+        HOST_EventInit(&sdhc1Sim.commandEvent, SDHC1_SIM_CommandEnd, 0U);
+        HOST_EventInit(&sdhc1Sim.dataEvent, SDHC1_SIM_DataEnd, 0U);
+        SDHC1_SIM_RegistersReset();
+    }
+}
+
+/* Sets the card detect level and the status of its change */
+static void SDHC1_SIM_CardDetect( bool inserted )
+{
+    SDHC1_SIM_PowerOn();
+    SDHC1_SIM_Sync();
+
+    sdhc1Sim.card.inserted = inserted;
+
+    if (inserted == true)
+    {
+        SDHC1_SIM_CardReset();
+        SDHC1_SIM_PSR |= SDHC_PSR_CARDINS_Msk;
+        sdhc1Sim.nistr |= SDHC_NISTR_CINS_Msk;
+    }
+    else
+    {
+        SDHC1_SIM_PSR &= ~SDHC_PSR_CARDINS_Msk;
+        sdhc1Sim.nistr |= SDHC_NISTR_CREM_Msk;
+
+        /* A transfer on the way loses the card's clock */
+        if (sdhc1Sim.data.active == true)
+        {
+            sdhc1Sim.data.error = SDHC_EISTR_DATTEO_Msk;
+        }
+    }
+
+    SDHC1_SIM_InterruptUpdate();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_SDCARD_Create( uint32_t blocks, bool highCapacity )
+{
+    SDHC1_SIM_CARD* card = &sdhc1Sim.card;
+
+    free(card->data);
+    card->data = calloc(blocks, SDCARD_BLOCK_SIZE);
+
+    if (card->data == NULL)
+    {
+        abort();
+    }
+
+    card->blocks = blocks;
+    card->highCapacity = highCapacity;
+    card->highSpeedErrors = false;
+    card->writeErrors = 0U;
+    card->errorBlockCount = 0U;
+    card->isPowerCut = false;
+    (void) memset(&card->stats, 0, sizeof(card->stats));
+}
+
+void HOST_SDCARD_Insert( void )
+{
+    sdhc1Sim.card.isPowerCut = false;
+    SDHC1_SIM_CardDetect(true);
+}
+
+void HOST_SDCARD_Remove( void )
+{
+    SDHC1_SIM_CardDetect(false);
+}
+
+uint8_t* HOST_SDCARD_DataGet( void )
+{
+    return sdhc1Sim.card.data;
+}
+
+void HOST_SDCARD_HighSpeedErrorsSet( bool errors )
+{
+    sdhc1Sim.card.highSpeedErrors = errors;
+}
+
+void HOST_SDCARD_WriteErrorsSet( uint32_t count )
+{
+    sdhc1Sim.card.writeErrors = count;
+}
+
+void HOST_SDCARD_BlockErrorsSet( uint32_t block, uint32_t count )
+{
+    sdhc1Sim.card.errorBlock = block;
+    sdhc1Sim.card.errorBlockCount = count;
+}
+
+void HOST_SDCARD_PowerCut( uint32_t blocks )
+{
+    sdhc1Sim.card.isPowerCut = true;
+    sdhc1Sim.card.powerBlocks = blocks;
+}
+
+void HOST_SDCARD_StatisticsGet( HOST_SDCARD_STATISTICS* stats )
+{
+    *stats = sdhc1Sim.card.stats;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SDHC1 Register Access
+// *****************************************************************************
+// *****************************************************************************
+
+/* The firmware waits for the controller by reading its registers, so each
+ * access lets the time of a poll pass */
+sdhc_registers_t* HOST_SDHC1_RegistersGet( void )
+{
+    SDHC1_SIM_PowerOn();
+
+    SDHC1_SIM_Sync();
+    HOST_Poll();
+    HOST_EventSchedule(&sdhc1Sim.syncEvent, HOST_TimeGet());
+
+    return &sdhc1Sim.regs;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SD Card Driver Task
+// *****************************************************************************
+// *****************************************************************************
+
+/* The disk layer of FatFs waits for a request by calling the driver's task
+ * in a loop, and the driver waits for the end of a transfer by checking the
+ * flag the SDHC1 interrupt sets, not a register. The host build links the
+ * calls of DRV_SDMMC_Tasks to this function instead (-Wl,--wrap), so that
+ * each pass of such a loop lets the time of a poll pass. */
+void __real_DRV_SDMMC_Tasks( SYS_MODULE_OBJ object );
+void __wrap_DRV_SDMMC_Tasks( SYS_MODULE_OBJ object );
+
+void __wrap_DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
+{
+    HOST_Poll();
+    __real_DRV_SDMMC_Tasks(object);
+}
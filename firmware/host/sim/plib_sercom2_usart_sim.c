@@ -0,0 +1,497 @@
+/*******************************************************************************
+  SERCOM2 USART Peripheral Library Simulation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_sercom2_usart_sim.c
+
+  Summary:
+    Console USART PLIB for host builds.
+
+  Description:
+    Models SERCOM2 as MHC configures it: 115200 baud, 8N1, clocked from
+    GCLK0, with the non-blocking Write and Read of the PLIB completing from
+    its interrupt. A terminal on the other end of the line receives what is
+    written and types what tests give it.
+
+    A character that arrives while no Read is pending waits in the two-level
+    receive buffer; one more is an overflow, which the next Read discards
+    with the buffer, as SERCOM2_USART_ErrorClear does. GCLK0 comes from the
+    DPLL, so in STANDBY the USART has no clock: transmission holds and the
+    characters that arrive are lost.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "peripheral/sercom/usart/plib_sercom2_usart.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+#define SERCOM2_SIM_FREQUENCY           (120000000U)
+#define SERCOM2_SIM_RX_FIFO_SIZE        (2U)
+#define SERCOM2_SIM_INPUT_SIZE          (4096U)
+
+typedef struct
+{
+    bool                    stopped;
+
+    /* Transmitter: the characters of the Write in progress leave one
+     * character time apart from txStart, less the time the clock held */
+    uint8_t*                txBuffer;
+    size_t                  txSize;
+    bool                    txBusy;
+    uint64_t                txStart;
+    size_t                  txSent;
+    HOST_EVENT              txEvent;
+    SERCOM_USART_CALLBACK   txCallback;
+    uintptr_t               txContext;
+
+    /* Receiver */
+    uint8_t*                rxBuffer;
+    size_t                  rxSize;
+    size_t                  rxProcessedSize;
+    bool                    rxBusy;
+    uint8_t                 rxFifo[SERCOM2_SIM_RX_FIFO_SIZE];
+    uint32_t                rxFifoCount;
+    bool                    rxOverflow;
+    USART_ERROR             errorStatus;
+    SERCOM_USART_CALLBACK   rxCallback;
+    uintptr_t               rxContext;
+
+    /* Terminal */
+    uint8_t                 input[SERCOM2_SIM_INPUT_SIZE];
+    size_t                  inputHead;
+    size_t                  inputCount;
+    HOST_EVENT              inputEvent;
+    char*                   output;
+    size_t                  outputLength;
+    size_t                  outputSize;
+    bool                    echo;
+    uint32_t                lostCount;
+} SERCOM2_SIM_OBJ;
+
+static SERCOM2_SIM_OBJ sercom2Sim;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void SERCOM2_SIM_OutputAppend( const uint8_t* data, size_t size )
+{
+    if ((sercom2Sim.outputLength + size + 1U) > sercom2Sim.outputSize)
+    {
+        sercom2Sim.outputSize = (sercom2Sim.outputLength + size + 1U) * 2U;
+        sercom2Sim.output = realloc(sercom2Sim.output, sercom2Sim.outputSize);
+
+        if (sercom2Sim.output == NULL)
+        {
+            abort();
+        }
+    }
+
+    (void) memcpy(&sercom2Sim.output[sercom2Sim.outputLength], data, size);
+    sercom2Sim.outputLength += size;
+    sercom2Sim.output[sercom2Sim.outputLength] = '\0';
+
+    if (sercom2Sim.echo == true)
+    {
+        (void) fwrite(data, 1, size, stdout);
+        (void) fflush(stdout);
+    }
+}
+
+/* Characters of the Write in progress that have left by now */
+static size_t SERCOM2_SIM_TxSentCount( void )
+{
+    uint64_t sent;
+
+    if ((sercom2Sim.txBusy == false) || (sercom2Sim.stopped == true))
+    {
+        return sercom2Sim.txSent;
+    }
+
+    sent = sercom2Sim.txSent + ((HOST_TimeGet() - sercom2Sim.txStart) / HOST_CONSOLE_CHAR_NS);
+
+    return (sent < sercom2Sim.txSize) ? (size_t)sent : sercom2Sim.txSize;
+}
+
+static void SERCOM2_SIM_TxSchedule( void )
+{
+    sercom2Sim.txStart = HOST_TimeGet();
+    HOST_EventSchedule(&sercom2Sim.txEvent, sercom2Sim.txStart +
+                       ((sercom2Sim.txSize - sercom2Sim.txSent) * HOST_CONSOLE_CHAR_NS));
+}
+
+static void SERCOM2_SIM_TxEvent( uintptr_t context )
+{
+    (void) context;
+
+    SERCOM2_SIM_OutputAppend(&sercom2Sim.txBuffer[sercom2Sim.txSent], sercom2Sim.txSize - sercom2Sim.txSent);
+    sercom2Sim.txSent = sercom2Sim.txSize;
+
+    /* The last character leaves DATA: DRE */
+    HOST_IRQ_Raise(SERCOM2_0_IRQn);
+}
+
+static void SERCOM2_SIM_InputSchedule( void )
+{
+    if ((sercom2Sim.inputCount > 0U) && (sercom2Sim.inputEvent.armed == false))
+    {
+        HOST_EventSchedule(&sercom2Sim.inputEvent, HOST_TimeGet() + HOST_CONSOLE_CHAR_NS);
+    }
+}
+
+static void SERCOM2_SIM_InputEvent( uintptr_t context )
+{
+    uint8_t data = sercom2Sim.input[sercom2Sim.inputHead];
+
+    (void) context;
+
+    sercom2Sim.inputHead = (sercom2Sim.inputHead + 1U) % SERCOM2_SIM_INPUT_SIZE;
+    sercom2Sim.inputCount--;
+
+    if (sercom2Sim.stopped == true)
+    {
+        sercom2Sim.lostCount++;
+    }
+    else if (sercom2Sim.rxFifoCount < SERCOM2_SIM_RX_FIFO_SIZE)
+    {
+        sercom2Sim.rxFifo[sercom2Sim.rxFifoCount++] = data;
+
+        /* RXC */
+        if (sercom2Sim.rxBusy == true)
+        {
+            HOST_IRQ_Raise(SERCOM2_2_IRQn);
+        }
+    }
+    else
+    {
+        sercom2Sim.rxOverflow = true;
+        sercom2Sim.lostCount++;
+
+        if (sercom2Sim.rxBusy == true)
+        {
+            HOST_IRQ_Raise(SERCOM2_OTHER_IRQn);
+        }
+    }
+
+    SERCOM2_SIM_InputSchedule();
+}
+
+static void SERCOM2_SIM_ErrorClear( void )
+{
+    if (sercom2Sim.rxOverflow == true)
+    {
+        sercom2Sim.rxOverflow = false;
+        sercom2Sim.lostCount += sercom2Sim.rxFifoCount;
+        sercom2Sim.rxFifoCount = 0U;
+    }
+}
+
+static void SERCOM2_SIM_InterruptHandler( void )
+{
+    if ((sercom2Sim.rxBusy == true) && (sercom2Sim.rxOverflow == true))
+    {
+        sercom2Sim.errorStatus = USART_ERROR_OVERRUN;
+        SERCOM2_SIM_ErrorClear();
+        sercom2Sim.rxBusy = false;
+
+        if (sercom2Sim.rxCallback != NULL)
+        {
+            sercom2Sim.rxCallback(sercom2Sim.rxContext);
+        }
+    }
+
+    if ((sercom2Sim.txBusy == true) && (sercom2Sim.txSent == sercom2Sim.txSize))
+    {
+        sercom2Sim.txBusy = false;
+
+        if (sercom2Sim.txCallback != NULL)
+        {
+            sercom2Sim.txCallback(sercom2Sim.txContext);
+        }
+    }
+
+    while ((sercom2Sim.rxBusy == true) && (sercom2Sim.rxFifoCount > 0U))
+    {
+        sercom2Sim.rxBuffer[sercom2Sim.rxProcessedSize++] = sercom2Sim.rxFifo[0];
+        sercom2Sim.rxFifo[0] = sercom2Sim.rxFifo[1];
+        sercom2Sim.rxFifoCount--;
+
+        if (sercom2Sim.rxProcessedSize == sercom2Sim.rxSize)
+        {
+            sercom2Sim.rxBusy = false;
+            sercom2Sim.rxSize = 0U;
+
+            if (sercom2Sim.rxCallback != NULL)
+            {
+                sercom2Sim.rxCallback(sercom2Sim.rxContext);
+            }
+        }
+    }
+}
+
+static void SERCOM2_SIM_StandbyHook( bool enter )
+{
+    if (enter == true)
+    {
+        sercom2Sim.txSent = SERCOM2_SIM_TxSentCount();
+        sercom2Sim.stopped = true;
+        HOST_EventCancel(&sercom2Sim.txEvent);
+    }
+    else
+    {
+        sercom2Sim.stopped = false;
+
+        if (sercom2Sim.txBusy == true)
+        {
+            SERCOM2_SIM_TxSchedule();
+        }
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Terminal
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_CONSOLE_Input( const void* data, size_t size )
+{
+    const uint8_t* bytes = data;
+    size_t i;
+
+    for (i = 0; (i < size) && (sercom2Sim.inputCount < SERCOM2_SIM_INPUT_SIZE); i++)
+    {
+        sercom2Sim.input[(sercom2Sim.inputHead + sercom2Sim.inputCount) % SERCOM2_SIM_INPUT_SIZE] = bytes[i];
+        sercom2Sim.inputCount++;
+    }
+
+    SERCOM2_SIM_InputSchedule();
+}
+
+const char* HOST_CONSOLE_OutputGet( size_t* size )
+{
+    if (size != NULL)
+    {
+        *size = sercom2Sim.outputLength;
+    }
+
+    return (sercom2Sim.output != NULL) ? sercom2Sim.output : "";
+}
+
+void HOST_CONSOLE_OutputClear( void )
+{
+    sercom2Sim.outputLength = 0U;
+
+    if (sercom2Sim.output != NULL)
+    {
+        sercom2Sim.output[0] = '\0';
+    }
+}
+
+void HOST_CONSOLE_EchoSet( bool echo )
+{
+    sercom2Sim.echo = echo;
+}
+
+uint32_t HOST_CONSOLE_LostCountGet( void )
+{
+    return sercom2Sim.lostCount;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SERCOM2 USART Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void SERCOM2_USART_Initialize( void )
+{
+    char* output = sercom2Sim.output;
+    size_t outputLength = sercom2Sim.outputLength;
+    size_t outputSize = sercom2Sim.outputSize;
+    bool echo = sercom2Sim.echo;
+
+    /* The terminal and its screen stay across a reset of the device */
+    (void) memset(&sercom2Sim, 0, sizeof(sercom2Sim));
+    sercom2Sim.output = output;
+    sercom2Sim.outputLength = outputLength;
+    sercom2Sim.outputSize = outputSize;
+    sercom2Sim.echo = echo;
+
+    HOST_EventInit(&sercom2Sim.txEvent, SERCOM2_SIM_TxEvent, 0);
+    HOST_EventInit(&sercom2Sim.inputEvent, SERCOM2_SIM_InputEvent, 0);
+    HOST_IRQ_HandlerSet(SERCOM2_0_IRQn, SERCOM2_SIM_InterruptHandler);
+    HOST_IRQ_HandlerSet(SERCOM2_1_IRQn, SERCOM2_SIM_InterruptHandler);
+    HOST_IRQ_HandlerSet(SERCOM2_2_IRQn, SERCOM2_SIM_InterruptHandler);
+    HOST_IRQ_HandlerSet(SERCOM2_OTHER_IRQn, SERCOM2_SIM_InterruptHandler);
+    HOST_StandbyHookRegister(SERCOM2_SIM_StandbyHook);
+}
+
+bool SERCOM2_USART_SerialSetup( USART_SERIAL_SETUP * serialSetup, uint32_t clkFrequency )
+{
+    (void) clkFrequency;
+
+    return (serialSetup != NULL) && (serialSetup->baudRate == 115200U);
+}
+
+uint32_t SERCOM2_USART_FrequencyGet( void )
+{
+    return SERCOM2_SIM_FREQUENCY;
+}
+
+USART_ERROR SERCOM2_USART_ErrorGet( void )
+{
+    USART_ERROR errorStatus = sercom2Sim.errorStatus;
+
+    sercom2Sim.errorStatus = USART_ERROR_NONE;
+
+    return errorStatus;
+}
+
+void SERCOM2_USART_TransmitterEnable( void )
+{
+}
+
+void SERCOM2_USART_TransmitterDisable( void )
+{
+}
+
+bool SERCOM2_USART_Write( void *buffer, const size_t size )
+{
+    if (buffer == NULL)
+    {
+        return false;
+    }
+
+    if (sercom2Sim.txBusy == true)
+    {
+        /* The caller polls until the last Write is done */
+        HOST_Poll();
+        return false;
+    }
+
+    sercom2Sim.txBuffer = buffer;
+    sercom2Sim.txSize = size;
+    sercom2Sim.txSent = 0U;
+    sercom2Sim.txBusy = true;
+
+    if (sercom2Sim.stopped == false)
+    {
+        SERCOM2_SIM_TxSchedule();
+    }
+
+    return true;
+}
+
+bool SERCOM2_USART_WriteIsBusy( void )
+{
+    return sercom2Sim.txBusy;
+}
+
+size_t SERCOM2_USART_WriteCountGet( void )
+{
+    return SERCOM2_SIM_TxSentCount();
+}
+
+void SERCOM2_USART_WriteCallbackRegister( SERCOM_USART_CALLBACK callback, uintptr_t context )
+{
+    sercom2Sim.txCallback = callback;
+    sercom2Sim.txContext = context;
+}
+
+bool SERCOM2_USART_TransmitComplete( void )
+{
+    return (sercom2Sim.txBusy == false);
+}
+
+void SERCOM2_USART_ReceiverEnable( void )
+{
+}
+
+void SERCOM2_USART_ReceiverDisable( void )
+{
+}
+
+bool SERCOM2_USART_Read( void *buffer, const size_t size )
+{
+    if ((buffer == NULL) || (sercom2Sim.rxBusy == true))
+    {
+        return false;
+    }
+
+    SERCOM2_SIM_ErrorClear();
+
+    sercom2Sim.rxBuffer = buffer;
+    sercom2Sim.rxSize = size;
+    sercom2Sim.rxProcessedSize = 0U;
+    sercom2Sim.rxBusy = true;
+    sercom2Sim.errorStatus = USART_ERROR_NONE;
+
+    /* Characters already in the receive buffer raise RXC at once */
+    if (sercom2Sim.rxFifoCount > 0U)
+    {
+        HOST_IRQ_Raise(SERCOM2_2_IRQn);
+    }
+
+    return true;
+}
+
+bool SERCOM2_USART_ReadIsBusy( void )
+{
+    return sercom2Sim.rxBusy;
+}
+
+size_t SERCOM2_USART_ReadCountGet( void )
+{
+    return sercom2Sim.rxProcessedSize;
+}
+
+bool SERCOM2_USART_ReadAbort( void )
+{
+    if (sercom2Sim.rxBusy == true)
+    {
+        sercom2Sim.rxBusy = false;
+        sercom2Sim.rxSize = 0U;
+        sercom2Sim.rxProcessedSize = 0U;
+    }
+
+    return true;
+}
+
+void SERCOM2_USART_ReadCallbackRegister( SERCOM_USART_CALLBACK callback, uintptr_t context )
+{
+    sercom2Sim.rxCallback = callback;
+    sercom2Sim.rxContext = context;
+}
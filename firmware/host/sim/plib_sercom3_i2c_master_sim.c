@@ -0,0 +1,246 @@
+/*******************************************************************************
+  SERCOM3 I2C Master Peripheral Library Simulation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_sercom3_i2c_master_sim.c
+
+  Summary:
+    SERCOM3 I2C master PLIB for host builds.
+
+  Description:
+    Puts the simulated BME280 of drv_bme280_sim.c on the SERCOM3 bus, so the
+    driver runs through the same PLIB interface table as on the board. The
+    sensor model times each transaction at the configured bus clock; its
+    completion sets the SERCOM3 interrupt, whose handler counts the outcome
+    as the PLIB does and calls the client's callback. The PLIB's handler
+    entered during a transfer, before its interrupt, would move the transfer
+    on a byte too early; the model ends the transfer with a bus error.
+
+    The sensor is powered by DRV_BME280_SIM_Initialize, which the test calls
+    once SYS_TIME runs. Until then it does not acknowledge its address.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <string.h>
+#include "peripheral/sercom/i2c_master/plib_sercom3_i2c_master.h"
+#include "driver/bme280/drv_bme280_sim.h"
+#include "host_sim.h"
+
+#define SERCOM3_SIM_FREQUENCY           (60000000U)
+
+typedef struct
+{
+    bool                    busy;
+    bool                    isDone;
+    SERCOM_I2C_ERROR        error;
+    uint32_t                writeSize;
+    uint32_t                readSize;
+    SERCOM_I2C_CALLBACK     callback;
+    uintptr_t               context;
+    SERCOM_I2C_STATISTICS   stats;
+} SERCOM3_SIM_OBJ;
+
+static SERCOM3_SIM_OBJ sercom3Sim;
+
+static void SERCOM3_SIM_TransferDone( uintptr_t context )
+{
+    (void) context;
+
+    switch (DRV_BME280_SIM_I2C_ErrorGet())
+    {
+        case DRV_BME280_ERROR_NACK:
+            sercom3Sim.error = SERCOM_I2C_ERROR_NAK;
+            break;
+
+        case DRV_BME280_ERROR_BUS:
+            sercom3Sim.error = SERCOM_I2C_ERROR_BUS;
+            break;
+
+        default:
+            sercom3Sim.error = SERCOM_I2C_ERROR_NONE;
+            break;
+    }
+
+    sercom3Sim.isDone = true;
+    HOST_IRQ_Raise(SERCOM3_1_IRQn);
+}
+
+static void SERCOM3_SIM_InterruptHandler( void )
+{
+    if (sercom3Sim.busy == false)
+    {
+        return;
+    }
+
+    if (sercom3Sim.isDone == false)
+    {
+        sercom3Sim.error = SERCOM_I2C_ERROR_BUS;
+    }
+
+    sercom3Sim.busy = false;
+    sercom3Sim.stats.writeBytes += sercom3Sim.writeSize;
+    sercom3Sim.stats.readBytes += sercom3Sim.readSize;
+
+    if (sercom3Sim.error == SERCOM_I2C_ERROR_NAK)
+    {
+        sercom3Sim.stats.nakCount++;
+    }
+    else if (sercom3Sim.error == SERCOM_I2C_ERROR_BUS)
+    {
+        sercom3Sim.stats.busErrorCount++;
+    }
+    else
+    {
+        sercom3Sim.stats.doneCount++;
+    }
+
+    if (sercom3Sim.callback != NULL)
+    {
+        sercom3Sim.callback(sercom3Sim.context);
+    }
+}
+
+/* Counts a transfer the sensor model accepted or the PLIB refused */
+static bool SERCOM3_SIM_TransferStarted( bool started, uint32_t writeSize, uint32_t readSize )
+{
+    if (started == false)
+    {
+        sercom3Sim.stats.refusedCount++;
+        return false;
+    }
+
+    sercom3Sim.busy = true;
+    sercom3Sim.isDone = false;
+    sercom3Sim.error = SERCOM_I2C_ERROR_NONE;
+    sercom3Sim.writeSize = writeSize;
+    sercom3Sim.readSize = readSize;
+    sercom3Sim.stats.transferCount++;
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: SERCOM3 I2C Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void SERCOM3_I2C_Initialize( void )
+{
+    (void) memset(&sercom3Sim, 0, sizeof(sercom3Sim));
+
+    DRV_BME280_SIM_I2C_CallbackRegister(SERCOM3_SIM_TransferDone, 0);
+    HOST_IRQ_HandlerSet(SERCOM3_0_IRQn, SERCOM3_SIM_InterruptHandler);
+    HOST_IRQ_HandlerSet(SERCOM3_1_IRQn, SERCOM3_SIM_InterruptHandler);
+    HOST_IRQ_HandlerSet(SERCOM3_2_IRQn, SERCOM3_SIM_InterruptHandler);
+    HOST_IRQ_HandlerSet(SERCOM3_OTHER_IRQn, SERCOM3_SIM_InterruptHandler);
+}
+
+bool SERCOM3_I2C_Read( uint16_t address, uint8_t* rdData, uint32_t rdLength )
+{
+    if (sercom3Sim.busy == true)
+    {
+        return SERCOM3_SIM_TransferStarted(false, 0U, 0U);
+    }
+
+    return SERCOM3_SIM_TransferStarted(DRV_BME280_SIM_I2C_Read(address, rdData, rdLength), 0U, rdLength);
+}
+
+bool SERCOM3_I2C_Write( uint16_t address, uint8_t* wrData, uint32_t wrLength )
+{
+    if (sercom3Sim.busy == true)
+    {
+        return SERCOM3_SIM_TransferStarted(false, 0U, 0U);
+    }
+
+    return SERCOM3_SIM_TransferStarted(DRV_BME280_SIM_I2C_Write(address, wrData, wrLength), wrLength, 0U);
+}
+
+bool SERCOM3_I2C_WriteRead( uint16_t address, uint8_t* wrData, uint32_t wrLength, uint8_t* rdData, uint32_t rdLength )
+{
+    if (sercom3Sim.busy == true)
+    {
+        return SERCOM3_SIM_TransferStarted(false, 0U, 0U);
+    }
+
+    return SERCOM3_SIM_TransferStarted(DRV_BME280_SIM_I2C_WriteRead(address, wrData, wrLength, rdData, rdLength),
+                                       wrLength, rdLength);
+}
+
+bool SERCOM3_I2C_IsBusy( void )
+{
+    return sercom3Sim.busy;
+}
+
+SERCOM_I2C_ERROR SERCOM3_I2C_ErrorGet( void )
+{
+    return sercom3Sim.error;
+}
+
+void SERCOM3_I2C_CallbackRegister( SERCOM_I2C_CALLBACK callback, uintptr_t contextHandle )
+{
+    sercom3Sim.callback = callback;
+    sercom3Sim.context = contextHandle;
+}
+
+bool SERCOM3_I2C_TransferSetup( SERCOM_I2C_TRANSFER_SETUP* setup, uint32_t srcClkFreq )
+{
+    DRV_BME280_TRANSFER_SETUP sensorSetup;
+
+    if (setup == NULL)
+    {
+        return false;
+    }
+
+    if (srcClkFreq == 0U)
+    {
+        srcClkFreq = SERCOM3_SIM_FREQUENCY;
+    }
+
+    sensorSetup.clockSpeed = setup->clkSpeed;
+
+    return DRV_BME280_SIM_I2C_TransferSetup(&sensorSetup, srcClkFreq);
+}
+
+void SERCOM3_I2C_TransferAbort( void )
+{
+    if (sercom3Sim.busy == true)
+    {
+        sercom3Sim.stats.abortCount++;
+    }
+
+    sercom3Sim.busy = false;
+    sercom3Sim.error = SERCOM_I2C_ERROR_NONE;
+}
+
+void SERCOM3_I2C_StatisticsGet( SERCOM_I2C_STATISTICS* stats )
+{
+    *stats = sercom3Sim.stats;
+}
@@ -0,0 +1,287 @@
+/*******************************************************************************
+  TC0 Peripheral Library Simulation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    plib_tc0_sim.c
+
+  Summary:
+    TC0 timer PLIB for host builds.
+
+  Description:
+    Models TC0 as MHC configures it: a 32-bit counter at 234375 Hz (GCLK1 of
+    60 MHz divided by 256) in match frequency mode, with the period in CC0
+    and the compare match interrupt MC1. GCLK1 comes from DPLL0, so the
+    counter holds in STANDBY and counts again once the DPLL has locked.
+
+    The DPLL follows the 12 MHz crystal while the RTC runs from the 32 kHz
+    crystal, so a test can make the counter run fast or slow against the
+    RTC by some parts per million.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#include <string.h>
+#include "peripheral/tc/plib_tc0.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+#define TC0_SIM_FREQUENCY       (234375U)
+#define TC0_SIM_PPM             (1000000U)
+
+typedef struct
+{
+    bool                    enabled;
+    bool                    stopped;
+
+    /* The clock has ticked since baseTime, and the counter had the value
+     * baseCount at tick baseTicks. While the counter holds, it has the value
+     * baseCount. */
+    uint64_t                baseTime;
+    uint64_t                baseTicks;
+    uint32_t                baseCount;
+
+    /* Frequency of the clock, in millionths of TC0_SIM_FREQUENCY */
+    uint64_t                rate;
+
+    uint32_t                period;
+    uint32_t                compare;
+    uint8_t                 intFlag;
+    uint8_t                 intEnable;
+
+    TC_TIMER_CALLBACK_OBJ   callbackObj;
+    HOST_EVENT              matchEvent;
+} TC0_SIM_OBJ;
+
+static TC0_SIM_OBJ tc0Sim;
+
+static bool TC0_SIM_IsCounting( void )
+{
+    return (tc0Sim.enabled == true) && (tc0Sim.stopped == false);
+}
+
+static uint64_t TC0_SIM_TicksAt( uint64_t time )
+{
+    return (uint64_t)(((unsigned __int128)(time - tc0Sim.baseTime) * TC0_SIM_FREQUENCY * tc0Sim.rate) /
+                      ((unsigned __int128)HOST_NS_PER_S * TC0_SIM_PPM));
+}
+
+static uint32_t TC0_SIM_Count( void )
+{
+    uint64_t ticks;
+
+    if (TC0_SIM_IsCounting() == false)
+    {
+        return tc0Sim.baseCount;
+    }
+
+    ticks = TC0_SIM_TicksAt(HOST_TimeGet()) - tc0Sim.baseTicks;
+
+    return (uint32_t)(((uint64_t)tc0Sim.baseCount + ticks) % ((uint64_t)tc0Sim.period + 1U));
+}
+
+/* Takes the present count as the base, keeping the phase of the clock */
+static void TC0_SIM_Rebase( void )
+{
+    tc0Sim.baseCount = TC0_SIM_Count();
+    tc0Sim.baseTicks = TC0_SIM_TicksAt(HOST_TimeGet());
+}
+
+/* Starts the clock from the present time */
+static void TC0_SIM_ClockStart( void )
+{
+    tc0Sim.baseTime = HOST_TimeGet();
+    tc0Sim.baseTicks = 0U;
+}
+
+static void TC0_SIM_MatchSchedule( void )
+{
+    uint64_t modulus = (uint64_t)tc0Sim.period + 1U;
+    uint64_t ticks;
+    uint64_t distance;
+    uint64_t time;
+
+    HOST_EventCancel(&tc0Sim.matchEvent);
+
+    if ((TC0_SIM_IsCounting() == false) || (tc0Sim.compare > tc0Sim.period))
+    {
+        return;
+    }
+
+    ticks = TC0_SIM_TicksAt(HOST_TimeGet());
+    distance = (((uint64_t)tc0Sim.compare + modulus) -
+                (((uint64_t)tc0Sim.baseCount + ticks - tc0Sim.baseTicks) % modulus)) % modulus;
+
+    /* The count is at the compare value now; it matched on reaching it */
+    if (distance == 0U)
+    {
+        distance = modulus;
+    }
+
+    /* First time at which the tick count reaches ticks + distance */
+    time = tc0Sim.baseTime + (uint64_t)((((unsigned __int128)(ticks + distance) * HOST_NS_PER_S * TC0_SIM_PPM) +
+                                         ((uint64_t)TC0_SIM_FREQUENCY * tc0Sim.rate) - 1U) /
+                                        ((uint64_t)TC0_SIM_FREQUENCY * tc0Sim.rate));
+
+    HOST_EventSchedule(&tc0Sim.matchEvent, time);
+}
+
+static void TC0_SIM_MatchEvent( uintptr_t context )
+{
+    (void) context;
+
+    tc0Sim.intFlag |= (uint8_t)TC_INTFLAG_MC1_Msk;
+
+    if ((tc0Sim.intEnable & TC_INTENSET_MC1_Msk) != 0U)
+    {
+        HOST_IRQ_Raise(TC0_IRQn);
+    }
+
+    TC0_SIM_MatchSchedule();
+}
+
+static void TC0_SIM_InterruptHandler( void )
+{
+    if (tc0Sim.intEnable != 0U)
+    {
+        TC_TIMER_STATUS status = (TC_TIMER_STATUS) tc0Sim.intFlag;
+
+        tc0Sim.intFlag = 0U;
+
+        if ((status != TC_TIMER_STATUS_NONE) && (tc0Sim.callbackObj.callback != NULL))
+        {
+            tc0Sim.callbackObj.callback(status, tc0Sim.callbackObj.context);
+        }
+    }
+}
+
+static void TC0_SIM_StandbyHook( bool enter )
+{
+    TC0_SIM_Rebase();
+    tc0Sim.stopped = enter;
+    TC0_SIM_ClockStart();
+    TC0_SIM_MatchSchedule();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control
+// *****************************************************************************
+// *****************************************************************************
+
+void HOST_TC0_ClockErrorSet( int32_t ppm )
+{
+    TC0_SIM_Rebase();
+    tc0Sim.rate = (uint64_t)((int64_t)TC0_SIM_PPM + ppm);
+    TC0_SIM_ClockStart();
+    TC0_SIM_MatchSchedule();
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: TC0 Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void TC0_TimerInitialize( void )
+{
+    (void) memset(&tc0Sim, 0, sizeof(tc0Sim));
+
+    HOST_EventInit(&tc0Sim.matchEvent, TC0_SIM_MatchEvent, 0);
+    HOST_IRQ_HandlerSet(TC0_IRQn, TC0_SIM_InterruptHandler);
+    HOST_StandbyHookRegister(TC0_SIM_StandbyHook);
+
+    tc0Sim.rate = TC0_SIM_PPM;
+    tc0Sim.period = 234U;
+    tc0Sim.intEnable = (uint8_t)TC_INTENSET_MC1_Msk;
+}
+
+void TC0_TimerStart( void )
+{
+    TC0_SIM_Rebase();
+    tc0Sim.enabled = true;
+    TC0_SIM_ClockStart();
+    TC0_SIM_MatchSchedule();
+}
+
+void TC0_TimerStop( void )
+{
+    TC0_SIM_Rebase();
+    tc0Sim.enabled = false;
+    TC0_SIM_MatchSchedule();
+}
+
+uint32_t TC0_TimerFrequencyGet( void )
+{
+    return TC0_SIM_FREQUENCY;
+}
+
+void TC0_TimerCommandSet( TC_COMMAND command )
+{
+    (void) command;
+}
+
+/* The firmware waits for time to pass by reading the counter, through
+ * SYS_TIME, so each read lets the time of a poll pass */
+uint32_t TC0_Timer32bitCounterGet( void )
+{
+    HOST_Poll();
+
+    return TC0_SIM_Count();
+}
+
+void TC0_Timer32bitCounterSet( uint32_t count )
+{
+    TC0_SIM_Rebase();
+    tc0Sim.baseCount = count;
+    TC0_SIM_MatchSchedule();
+}
+
+void TC0_Timer32bitPeriodSet( uint32_t period )
+{
+    TC0_SIM_Rebase();
+    tc0Sim.period = period;
+    TC0_SIM_MatchSchedule();
+}
+
+uint32_t TC0_Timer32bitPeriodGet( void )
+{
+    return tc0Sim.period;
+}
+
+void TC0_Timer32bitCompareSet( uint32_t compare )
+{
+    tc0Sim.compare = compare;
+    TC0_SIM_MatchSchedule();
+}
+
+void TC0_TimerCallbackRegister( TC_TIMER_CALLBACK callback, uintptr_t context )
+{
+    tc0Sim.callbackObj.callback = callback;
+    tc0Sim.callbackObj.context = context;
+}
@@ -0,0 +1,305 @@
+/*******************************************************************************
+  SmartEEPROM Settings Host Tests
+
+  File Name:
+    test_app_config.cpp
+
+  Summary:
+    Saves the settings and counters of APP_CONFIG in the two slots of the
+    simulated SmartEEPROM, and loads them back after a reset.
+
+  Description:
+    The NVMCTRL, SYS_TIME, APP_TIMESTAMP, APP_CONFIG and, for the tests that
+    share the NVMCTRL with it, APP_FLASHLOG run. The SmartEEPROM of
+    plib_nvmctrl_sim.c keeps what was flushed across HOST_Reset, so a reset
+    is NVMCTRL_Initialize and APP_CONFIG_Initialize again on the same
+    SmartEEPROM.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "app_config.h"
+#include "app_flashlog.h"
+#include "app_timestamp.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" APP_CONFIG_DATA app_configData;
+extern "C" APP_FLASHLOG_DATA app_flashlogData;
+
+namespace
+{
+
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+
+void Tasks( void )
+{
+    APP_CONFIG_Tasks();
+    APP_FLASHLOG_Tasks();
+}
+
+/* Each test runs in its own process, on a device with its flash erased */
+class AppConfigTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        HOST_Reset();
+        HOST_NVM_Erase();
+        Start();
+    }
+
+    void Start()
+    {
+        NVMCTRL_Initialize();
+        TC0_TimerInitialize();
+        RTC_Initialize();
+        (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+        NVIC_Initialize();
+        APP_TIMESTAMP_Initialize();
+        APP_CONFIG_Initialize();
+        APP_FLASHLOG_Initialize();
+    }
+
+    /* Power cycle: the SmartEEPROM keeps what has been flushed */
+    void Reset()
+    {
+        HOST_Reset();
+        Start();
+    }
+
+    void RunFor( uint64_t ns )
+    {
+        HOST_Run(Tasks, HOST_TimeGet() + ns, kPassNs);
+    }
+
+    /* Runs until the changes are saved */
+    bool Save()
+    {
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        while ((APP_CONFIG_IsIdle() == false) || (app_configData.isCounterChanged == true))
+        {
+            if (HOST_TimeGet() >= until)
+            {
+                return false;
+            }
+
+            RunFor(100U * HOST_NS_PER_US);
+        }
+
+        return true;
+    }
+
+    /* Slot as the NVMCTRL keeps it in flash */
+    APP_CONFIG_SLOT Slot( uint32_t index )
+    {
+        APP_CONFIG_SLOT slot;
+
+        (void) memcpy(&slot, HOST_NVM_SmartEEPROMGet() + (index * sizeof(slot)), sizeof(slot));
+
+        return slot;
+    }
+
+    /* Slot with the higher sequence number */
+    APP_CONFIG_SLOT Newest()
+    {
+        return ((int32_t)(Slot(0U).sequence - Slot(1U).sequence) > 0) ? Slot(0U) : Slot(1U);
+    }
+
+    HOST_NVM_STATISTICS Statistics()
+    {
+        HOST_NVM_STATISTICS stats;
+
+        HOST_NVM_StatisticsGet(&stats);
+
+        return stats;
+    }
+};
+
+TEST_F(AppConfigTest, SavesInTheSlotsInTurn)
+{
+    /* a blank SmartEEPROM: the defaults, saved at the first start */
+    ASSERT_TRUE(Save());
+    EXPECT_EQ(1U, Slot(0U).sequence);
+    EXPECT_EQ(APP_CONFIG_SAMPLE_PERIOD_MS, Slot(0U).values[APP_CONFIG_KEY_SAMPLE_PERIOD_MS]);
+    EXPECT_EQ(1U, Slot(0U).counters[APP_CONFIG_COUNTER_RESETS]);
+
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000U));
+    ASSERT_TRUE(Save());
+    EXPECT_EQ(2U, Slot(1U).sequence);
+    EXPECT_EQ(10000U, Slot(1U).values[APP_CONFIG_KEY_SAMPLE_PERIOD_MS]);
+
+    /* the older slot is written next, the newer one is left as it was */
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SYNC_RECORDS, 20U));
+    ASSERT_TRUE(Save());
+    EXPECT_EQ(3U, Slot(0U).sequence);
+    EXPECT_EQ(20U, Slot(0U).values[APP_CONFIG_KEY_SYNC_RECORDS]);
+    EXPECT_EQ(2U, Slot(1U).sequence);
+
+    /* a setting set to the value it has is not saved again */
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SYNC_RECORDS, 20U));
+    ASSERT_TRUE(Save());
+    EXPECT_EQ(3U, Statistics().seeFlushes);
+
+    /* out of range */
+    EXPECT_FALSE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 99U));
+    EXPECT_EQ(10000U, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+}
+
+TEST_F(AppConfigTest, LoadsTheNewestSlotAfterAReset)
+{
+    ASSERT_TRUE(Save());
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000U));
+    ASSERT_TRUE(Save());
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 20000U));
+    APP_CONFIG_CounterAdd(APP_CONFIG_COUNTER_SAMPLES, 7U);
+    ASSERT_TRUE(Save());
+
+    Reset();
+
+    EXPECT_EQ(20000U, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+    EXPECT_EQ(7U, APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_SAMPLES));
+    EXPECT_EQ(2U, APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_RESETS));
+
+    /* the start is saved over the older slot */
+    ASSERT_TRUE(Save());
+    EXPECT_EQ(4U, Slot(1U).sequence);
+    EXPECT_EQ(2U, Slot(1U).counters[APP_CONFIG_COUNTER_RESETS]);
+    EXPECT_EQ(3U, Slot(0U).sequence);
+}
+
+TEST_F(AppConfigTest, KeepsTheOtherSlotWhenASaveIsCut)
+{
+    ASSERT_TRUE(Save());
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000U));
+    ASSERT_TRUE(Save());
+
+    /* the power fails while the page of the next save is written: half of
+     * it is programmed */
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 20000U));
+    ASSERT_TRUE(Save());
+    (void) memset(HOST_NVM_SmartEEPROMGet() + (sizeof(APP_CONFIG_SLOT) / 2U), 0xFF, sizeof(APP_CONFIG_SLOT) / 2U);
+
+    Reset();
+
+    EXPECT_EQ(10000U, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+    EXPECT_EQ(2U, APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_RESETS));
+
+    /* the damaged slot is the one written next */
+    ASSERT_TRUE(Save());
+    EXPECT_EQ(3U, Slot(0U).sequence);
+    EXPECT_EQ(2U, Slot(1U).sequence);
+}
+
+TEST_F(AppConfigTest, LosesWordsNotFlushedAtAReset)
+{
+    ASSERT_TRUE(Save());
+
+    /* the setting is changed, and the power fails before the next pass */
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000U));
+    Reset();
+
+    EXPECT_EQ(APP_CONFIG_SAMPLE_PERIOD_MS, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+    EXPECT_EQ(2U, APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_RESETS));
+}
+
+TEST_F(AppConfigTest, SavesCountersAtMostEveryCounterSavePeriod)
+{
+    uint64_t periodNs = (uint64_t)APP_CONFIG_COUNTER_SAVE_MS * HOST_NS_PER_MS;
+    uint32_t i;
+
+    ASSERT_TRUE(Save());
+
+    /* a sample every 5 s for most of the period */
+    for (i = 0U; i < 170U; i++)
+    {
+        APP_CONFIG_CounterAdd(APP_CONFIG_COUNTER_SAMPLES, 1U);
+        HOST_TimeAdvance(5U * HOST_NS_PER_S);
+        RunFor(kPassNs);
+    }
+
+    EXPECT_EQ(1U, Statistics().seeFlushes);
+
+    HOST_TimeAdvance(periodNs - (170U * 5U * HOST_NS_PER_S));
+    RunFor(100U * HOST_NS_PER_US);
+
+    EXPECT_EQ(2U, Statistics().seeFlushes);
+    EXPECT_EQ(170U, Slot(1U).counters[APP_CONFIG_COUNTER_SAMPLES]);
+}
+
+TEST_F(AppConfigTest, SavesBetweenTheCommandsOfTheFlashLog)
+{
+    APP_FLASHLOG_RECORD record = {};
+    uint64_t eraseEnd;
+
+    ASSERT_TRUE(Save());
+
+    /* the first record erases a block of the ring, and the setting changes
+     * while the NVMCTRL is busy with it */
+    ASSERT_TRUE(APP_FLASHLOG_Write(&record));
+    RunFor(kPassNs);
+    eraseEnd = HOST_TimeGet() + HOST_NVM_BLOCK_ERASE_NS;
+    ASSERT_TRUE(NVMCTRL_IsBusy());
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000U));
+
+    RunFor(HOST_NVM_BLOCK_ERASE_NS / 2U);
+    EXPECT_EQ(1U, Statistics().seeFlushes);
+
+    /* the save follows the erase, and the flash log goes on after it */
+    ASSERT_TRUE(Save());
+    EXPECT_GE(HOST_TimeGet(), eraseEnd);
+    for (uint32_t i = 1U; i < 20U; i++)
+    {
+        record.time = i;
+        ASSERT_TRUE(APP_FLASHLOG_Write(&record));
+        ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SYNC_RECORDS, i));
+        RunFor(HOST_NVM_QUAD_WORD_NS + HOST_NVM_SEE_WRITE_NS);
+    }
+
+    ASSERT_TRUE(Save());
+    RunFor(HOST_NS_PER_MS);
+
+    EXPECT_TRUE(APP_FLASHLOG_IsIdle());
+    EXPECT_EQ(20U, app_flashlogData.writeCount);
+    EXPECT_EQ(19U, Newest().values[APP_CONFIG_KEY_SYNC_RECORDS]);
+
+    /* no flush waited for a flash command, and no flash command was issued
+     * during a flush */
+    EXPECT_EQ(0U, Statistics().seeFlushesDelayed);
+    EXPECT_EQ(0U, Statistics().busyCommands);
+}
+
+class AppConfigDisabledTest : public AppConfigTest
+{
+protected:
+    void SetUp() override
+    {
+        HOST_Reset();
+        HOST_NVM_Erase();
+        HOST_NVM_SmartEEPROMConfigure(0U, 0U);
+        Start();
+    }
+};
+
+TEST_F(AppConfigDisabledTest, RunsOnTheDefaultsWithoutASmartEEPROM)
+{
+    EXPECT_TRUE(APP_CONFIG_IsIdle());
+    EXPECT_EQ(APP_CONFIG_SAMPLE_PERIOD_MS, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+
+    /* a setting applies until the next reset */
+    ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000U));
+    RunFor(HOST_NS_PER_MS);
+    EXPECT_EQ(10000U, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+    EXPECT_EQ(0U, Statistics().seeFlushes);
+
+    Reset();
+
+    EXPECT_EQ(APP_CONFIG_SAMPLE_PERIOD_MS, APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS));
+    EXPECT_EQ(1U, APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_RESETS));
+}
+
+}
@@ -0,0 +1,174 @@
+/*******************************************************************************
+  Internal Flash Log Host Tests
+
+  File Name:
+    test_app_flashlog.cpp
+
+  Summary:
+    Fills the flash ring of APP_FLASHLOG past its end on the simulated
+    NVMCTRL.
+
+  Description:
+    Only the NVMCTRL and APP_FLASHLOG run. The flash of plib_nvmctrl_sim.c
+    keeps its contents across HOST_Reset, so a reset is
+    NVMCTRL_Initialize and APP_FLASHLOG_Initialize again on the same flash.
+    Each record holds its number in its time, which shows which records
+    the ring kept and in which order it gives them back.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "definitions.h"
+#include "app_flashlog.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" APP_FLASHLOG_DATA app_flashlogData;
+
+namespace
+{
+
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+
+/* A block holds its header and drained mark, then a record per quad word */
+constexpr uint32_t kBlockRecords = (NVMCTRL_FLASH_BLOCKSIZE - 32U) / 16U;
+constexpr uint32_t kRingRecords = APP_FLASHLOG_BLOCKS * kBlockRecords;
+
+/* Each test runs in its own process, on a device with its flash erased */
+class AppFlashlogTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        HOST_Reset();
+        HOST_NVM_Erase();
+        NVMCTRL_Initialize();
+        APP_FLASHLOG_Initialize();
+    }
+
+    /* Power cycle: the flash keeps what has been written */
+    void Reset()
+    {
+        HOST_Reset();
+        NVMCTRL_Initialize();
+        APP_FLASHLOG_Initialize();
+    }
+
+    void RunFor( uint64_t ns )
+    {
+        HOST_Run(APP_FLASHLOG_Tasks, HOST_TimeGet() + ns, kPassNs);
+    }
+
+    /* Runs the flash log until it has written its queue and marks */
+    bool Flush()
+    {
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        while (APP_FLASHLOG_IsIdle() == false)
+        {
+            if (HOST_TimeGet() >= until)
+            {
+                return false;
+            }
+
+            RunFor(100U * HOST_NS_PER_US);
+        }
+
+        return true;
+    }
+
+    /* Writes the records numbered from first, letting the queue empty as a
+     * sample period would */
+    void Write( uint32_t first, uint32_t count )
+    {
+        APP_FLASHLOG_RECORD record = {};
+
+        for (uint32_t i = first; i < (first + count); i++)
+        {
+            record.time = i;
+            record.temperature = (int16_t)(i % 4000U);
+            record.pressure = 100000U + i;
+
+            ASSERT_TRUE(APP_FLASHLOG_Write(&record));
+            ASSERT_TRUE(Flush());
+        }
+    }
+
+    /* Reads up to count records and checks that they are numbered on from
+     * first. Returns the number read. */
+    uint32_t ReadExpect( uint32_t first, uint32_t count )
+    {
+        APP_FLASHLOG_RECORD record;
+        uint32_t n = 0U;
+
+        while ((n < count) && (APP_FLASHLOG_Read(&record, true) == true))
+        {
+            EXPECT_EQ(first + n, record.time);
+            EXPECT_EQ(100000U + first + n, record.pressure);
+            n++;
+        }
+
+        return n;
+    }
+};
+
+TEST_F(AppFlashlogTest, WrapsOverTheOldestBlockWhenFull)
+{
+    /* a ring and a half: each block is erased once, the first half of them
+     * twice */
+    uint32_t count = kRingRecords + (kRingRecords / 2U);
+    uint32_t kept;
+
+    Write(0U, count);
+
+    /* the second half of the ring was erased before it was read */
+    EXPECT_EQ(APP_FLASHLOG_BLOCKS / 2U, app_flashlogData.overwriteCount);
+    EXPECT_EQ(0U, app_flashlogData.droppedCount);
+    EXPECT_EQ(count, app_flashlogData.writeCount);
+
+    /* the ring is full, from the block after the head */
+    kept = kRingRecords;
+    EXPECT_EQ(kept, ReadExpect(count - kept, count));
+    EXPECT_TRUE(APP_FLASHLOG_IsEmpty());
+    EXPECT_EQ(0U, app_flashlogData.invalidCount);
+}
+
+TEST_F(AppFlashlogTest, FindsTheWrappedRingAfterAReset)
+{
+    uint32_t count = (2U * kRingRecords) + 100U;
+    uint32_t kept = ((APP_FLASHLOG_BLOCKS - 1U) * kBlockRecords) + 100U;
+
+    Write(0U, count);
+    Reset();
+
+    /* the head is found by the sequence numbers, which wrapped past block 0
+     * twice, and the end of the log by the first blank quad word */
+    EXPECT_EQ(kept, ReadExpect(count - kept, count));
+    EXPECT_TRUE(APP_FLASHLOG_IsEmpty());
+
+    /* records written after the reset follow on in the same block */
+    Write(count, 10U);
+    EXPECT_EQ(10U, ReadExpect(count, 10U));
+    EXPECT_EQ(0U, app_flashlogData.overwriteCount);
+}
+
+TEST_F(AppFlashlogTest, RepeatsAtMostABlockAfterAResetWhileDraining)
+{
+    uint32_t count = kRingRecords + (3U * kBlockRecords);
+    uint32_t oldest = count - kRingRecords;
+
+    /* the ring wraps, then two blocks and a part are moved to the card and
+     * released, as APP_SDCARD does once they are on it */
+    Write(0U, count);
+    ASSERT_EQ((2U * kBlockRecords) + 50U, ReadExpect(oldest, (2U * kBlockRecords) + 50U));
+    APP_FLASHLOG_Release();
+    ASSERT_TRUE(Flush());
+    Reset();
+
+    /* the drained blocks are not read again; the part read of the third is */
+    EXPECT_EQ(kRingRecords - (2U * kBlockRecords),
+              ReadExpect(oldest + (2U * kBlockRecords), kRingRecords));
+    EXPECT_TRUE(APP_FLASHLOG_IsEmpty());
+}
+
+}
@@ -0,0 +1,187 @@
+/*******************************************************************************
+  Derived Quantities Host Tests
+
+  File Name:
+    test_app_meteo.cpp
+
+  Summary:
+    Checks the fixed point quantities of APP_METEO against libm.
+
+  Description:
+    The references evaluate the formulas listed in app_meteo.h in double
+    precision with libm. The sweeps cover -40..85 degC, 1..100 %RH and
+    30000..110000 Pa, and each test holds the worst error to the bound that
+    app_meteo.h documents. The station is at APP_METEO_STATION_ALTITUDE_M.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "definitions.h"
+#include "app_meteo.h"
+
+namespace
+{
+
+constexpr double kMagnusB = 17.62;
+constexpr double kMagnusC = 243.12;
+constexpr double kMagnusE0 = 611.2;
+constexpr double kVapourR = 461.5;
+constexpr double kIsaHeight = 44330.77;
+constexpr double kIsaExponent = 0.190263;
+constexpr double kIsaP0 = 101325.0;
+
+/* Magnus gamma of a temperature in degC and a humidity in %RH */
+double Gamma( double temperature, double humidity )
+{
+    return log(humidity / 100.0) + ((kMagnusB * temperature) / (kMagnusC + temperature));
+}
+
+/* Dew point in degC */
+double ReferenceDewPoint( double temperature, double humidity )
+{
+    double gamma = Gamma(temperature, humidity);
+
+    return (kMagnusC * gamma) / (kMagnusB - gamma);
+}
+
+/* Absolute humidity in mg/m^3 */
+double ReferenceAbsoluteHumidity( double temperature, double humidity )
+{
+    double vapour = kMagnusE0 * exp(Gamma(temperature, humidity));
+
+    return (vapour / (kVapourR * (temperature + 273.15))) * 1.0e6;
+}
+
+/* Pressure altitude in m of a pressure in Pa */
+double ReferenceAltitude( double pressure )
+{
+    return kIsaHeight * (1.0 - pow(pressure / kIsaP0, kIsaExponent));
+}
+
+/* Sea-level pressure in Pa */
+double ReferenceSeaLevel( double pressure )
+{
+    return pressure * pow(1.0 - ((double)APP_METEO_STATION_ALTITUDE_M / kIsaHeight), -1.0 / kIsaExponent);
+}
+
+/* Worst errors of a sweep of the humidity quantities over temperature and
+ * humidity, at 101325 Pa */
+struct HumidityErrors
+{
+    double dewPoint;
+    double absoluteHumidity;
+};
+
+HumidityErrors HumiditySweep( void )
+{
+    HumidityErrors errors = {};
+    APP_METEO_DATA derived;
+
+    for (int32_t temperature = -4000; temperature <= 8500; temperature += 25)
+    {
+        for (uint32_t humidity = 1024U; humidity <= 102400U; humidity += 512U)
+        {
+            double t = (double)temperature / 100.0;
+            double rh = (double)humidity / 1024.0;
+
+            APP_METEO_Compute(temperature, 101325U * 256U, humidity, &derived);
+
+            errors.dewPoint = fmax(errors.dewPoint, fabs(((double)derived.dewPoint / 100.0) - ReferenceDewPoint(t, rh)));
+            errors.absoluteHumidity = fmax(errors.absoluteHumidity,
+                                           fabs((double)derived.absoluteHumidity - ReferenceAbsoluteHumidity(t, rh)));
+        }
+    }
+
+    return errors;
+}
+
+class AppMeteoTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        APP_METEO_Initialize();
+    }
+};
+
+TEST_F(AppMeteoTest, DewPointIsWithinItsBound)
+{
+    HumidityErrors errors = HumiditySweep();
+
+    RecordProperty("dew_point_max_error_mdegC", (int)(errors.dewPoint * 1000.0));
+    EXPECT_LE(errors.dewPoint, 0.01);
+}
+
+TEST_F(AppMeteoTest, AbsoluteHumidityIsWithinItsBound)
+{
+    HumidityErrors errors = HumiditySweep();
+
+    RecordProperty("absolute_humidity_max_error_ug", (int)(errors.absoluteHumidity * 1000.0));
+    EXPECT_LE(errors.absoluteHumidity, 1.0);
+}
+
+TEST_F(AppMeteoTest, PressureAltitudeIsWithinItsBound)
+{
+    APP_METEO_DATA derived;
+    double maxError = 0.0;
+
+    /* 1/256 Pa steps that do not line up with whole pascals */
+    for (uint32_t pressure = 30000U * 256U; pressure <= 110000U * 256U; pressure += 1021U)
+    {
+        APP_METEO_Compute(2500, pressure, 50U * 1024U, &derived);
+        maxError = fmax(maxError, fabs(((double)derived.pressureAltitude / 100.0) -
+                                       ReferenceAltitude((double)pressure / 256.0)));
+    }
+
+    RecordProperty("pressure_altitude_max_error_mm", (int)(maxError * 1000.0));
+    EXPECT_LE(maxError, 0.02);
+}
+
+TEST_F(AppMeteoTest, SeaLevelPressureIsWithinItsBound)
+{
+    APP_METEO_DATA derived;
+    double maxError = 0.0;
+
+    for (uint32_t pressure = 30000U * 256U; pressure <= 110000U * 256U; pressure += 1021U)
+    {
+        APP_METEO_Compute(2500, pressure, 50U * 1024U, &derived);
+        maxError = fmax(maxError, fabs((double)derived.seaLevelPressure - ReferenceSeaLevel((double)pressure / 256.0)));
+    }
+
+    RecordProperty("sea_level_max_error_mPa", (int)(maxError * 1000.0));
+    EXPECT_LE(maxError, 1.0);
+}
+
+TEST_F(AppMeteoTest, StandardPressureIsAtSeaLevel)
+{
+    APP_METEO_DATA derived;
+
+    APP_METEO_Compute(1500, 101325U * 256U, 50U * 1024U, &derived);
+
+    EXPECT_EQ(0, derived.pressureAltitude);
+}
+
+TEST_F(AppMeteoTest, SaturatedAirIsAtItsDewPoint)
+{
+    APP_METEO_DATA derived;
+
+    for (int32_t temperature = -4000; temperature <= 8500; temperature += 500)
+    {
+        APP_METEO_Compute(temperature, 101325U * 256U, 100U * 1024U, &derived);
+        EXPECT_NEAR(temperature, derived.dewPoint, 1) << "at " << temperature;
+    }
+}
+
+TEST_F(AppMeteoTest, DryAirHasAFiniteDewPoint)
+{
+    APP_METEO_DATA derived;
+
+    /* 0 %RH is computed as 1/1024 %RH */
+    APP_METEO_Compute(2500, 101325U * 256U, 0U, &derived);
+
+    EXPECT_NEAR(ReferenceDewPoint(25.0, 1.0 / 1024.0) * 100.0, (double)derived.dewPoint, 1.0);
+    EXPECT_EQ(0U, derived.absoluteHumidity);
+}
+
+}
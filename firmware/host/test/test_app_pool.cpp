@@ -0,0 +1,248 @@
+/*******************************************************************************
+  Record Pools Host Tests
+
+  File Name:
+    test_app_pool.cpp
+
+  Summary:
+    Checks the exhaustion, watermark and refused frees of APP_POOL.
+
+  Description:
+    Only APP_POOL and the console SERCOM2 and its NVIC line run, over pools
+    set up by the tests themselves. The report is read back from the
+    simulated console.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "app_pool.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" APP_POOL_DATA app_poolData;
+
+namespace
+{
+
+constexpr uint32_t kBlocks = 4U;
+
+struct Record
+{
+    uint32_t time;
+    uint32_t value[3];
+};
+
+/* Each test runs in its own process */
+class AppPoolTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        HOST_Reset();
+        NVIC_Initialize();
+        SERCOM2_USART_Initialize();
+        APP_POOL_Initialize();
+        ASSERT_TRUE(APP_POOL_Create(&pool, "records", records, sizeof(records[0]), kBlocks));
+    }
+
+    APP_POOL pool;
+    alignas(uintptr_t) Record records[kBlocks];
+};
+
+TEST_F(AppPoolTest, GivesEveryBlockOnceThenNone)
+{
+    Record* taken[kBlocks];
+
+    for (uint32_t i = 0U; i < kBlocks; i++)
+    {
+        taken[i] = (Record*)APP_POOL_Alloc(&pool);
+        ASSERT_NE(nullptr, taken[i]);
+
+        /* the first block first, then in order */
+        EXPECT_EQ(&records[i], taken[i]);
+        memset(taken[i], 0xFF, sizeof(Record));
+    }
+
+    EXPECT_EQ(nullptr, APP_POOL_Alloc(&pool));
+    EXPECT_EQ(nullptr, APP_POOL_Alloc(&pool));
+    EXPECT_EQ(2U, pool.exhaustCount);
+    EXPECT_EQ(kBlocks, pool.usedCount);
+
+    /* a block given back is the next one taken */
+    APP_POOL_Free(&pool, taken[2]);
+    EXPECT_EQ(taken[2], APP_POOL_Alloc(&pool));
+    EXPECT_EQ(nullptr, APP_POOL_Alloc(&pool));
+    EXPECT_EQ(3U, pool.exhaustCount);
+    EXPECT_EQ(0U, pool.freeErrorCount);
+}
+
+TEST_F(AppPoolTest, KeepsTheMostBlocksEverInUse)
+{
+    void* first = APP_POOL_Alloc(&pool);
+    void* second = APP_POOL_Alloc(&pool);
+    void* third = APP_POOL_Alloc(&pool);
+
+    EXPECT_EQ(3U, pool.peakCount);
+
+    APP_POOL_Free(&pool, second);
+    APP_POOL_Free(&pool, third);
+    EXPECT_EQ(1U, pool.usedCount);
+    EXPECT_EQ(3U, pool.peakCount);
+
+    /* back to two in use: the watermark stays */
+    second = APP_POOL_Alloc(&pool);
+    EXPECT_EQ(2U, pool.usedCount);
+    EXPECT_EQ(3U, pool.peakCount);
+
+    APP_POOL_Free(&pool, first);
+    APP_POOL_Free(&pool, second);
+    EXPECT_EQ(0U, pool.usedCount);
+    EXPECT_EQ(3U, pool.peakCount);
+    EXPECT_EQ(0U, pool.exhaustCount);
+}
+
+TEST_F(AppPoolTest, RefusesABlockGivenBackTwice)
+{
+    void* first = APP_POOL_Alloc(&pool);
+    void* second = APP_POOL_Alloc(&pool);
+
+    APP_POOL_Free(&pool, first);
+    APP_POOL_Free(&pool, first);
+    EXPECT_EQ(1U, pool.freeErrorCount);
+    EXPECT_EQ(1U, pool.usedCount);
+
+    /* also when it is not the last one given back */
+    APP_POOL_Free(&pool, second);
+    APP_POOL_Free(&pool, first);
+    EXPECT_EQ(2U, pool.freeErrorCount);
+    EXPECT_EQ(0U, pool.usedCount);
+
+    /* the list is whole: every block comes out once */
+    for (uint32_t i = 0U; i < kBlocks; i++)
+    {
+        EXPECT_NE(nullptr, APP_POOL_Alloc(&pool));
+    }
+
+    EXPECT_EQ(nullptr, APP_POOL_Alloc(&pool));
+}
+
+TEST_F(AppPoolTest, RefusesAnAddressThatIsNotABlock)
+{
+    Record other;
+    Record* taken = (Record*)APP_POOL_Alloc(&pool);
+
+    APP_POOL_Free(&pool, &other);
+    APP_POOL_Free(&pool, &taken->value[0]);
+    APP_POOL_Free(&pool, &records[kBlocks]);
+    APP_POOL_Free(&pool, nullptr);
+
+    EXPECT_EQ(3U, pool.freeErrorCount);
+    EXPECT_EQ(1U, pool.usedCount);
+
+    APP_POOL_Free(&pool, taken);
+    EXPECT_EQ(3U, pool.freeErrorCount);
+    EXPECT_EQ(0U, pool.usedCount);
+}
+
+TEST_F(AppPoolTest, FreesABlockWhateverItHolds)
+{
+    uintptr_t* taken = (uintptr_t*)APP_POOL_Alloc(&pool);
+
+    /* every word of the block looks like a free one's link or check */
+    for (size_t i = 0U; i < (sizeof(Record) / sizeof(uintptr_t)); i++)
+    {
+        taken[i] = (i == 0U) ? (uintptr_t)&records[1] : ~(uintptr_t)taken;
+    }
+
+    APP_POOL_Free(&pool, taken);
+    EXPECT_EQ(0U, pool.freeErrorCount);
+    EXPECT_EQ(0U, pool.usedCount);
+
+    /* given back once, taken again once */
+    APP_POOL_Free(&pool, taken);
+    EXPECT_EQ(1U, pool.freeErrorCount);
+    EXPECT_EQ((void*)taken, APP_POOL_Alloc(&pool));
+    EXPECT_EQ(1U, pool.usedCount);
+}
+
+TEST_F(AppPoolTest, RefusesBlocksTooSmallForTheFreeLink)
+{
+    uintptr_t words[8];
+    APP_POOL small;
+
+    EXPECT_FALSE(APP_POOL_Create(&small, "small", words, sizeof(uintptr_t) / 2U, 16U));
+    EXPECT_FALSE(APP_POOL_Create(&small, "odd", words, sizeof(uintptr_t) + 1U, 4U));
+    EXPECT_EQ(1U, app_poolData.poolCount);
+
+    /* a single link is enough */
+    EXPECT_TRUE(APP_POOL_Create(&small, "words", words, sizeof(uintptr_t), 8U));
+    EXPECT_EQ(&words[0], APP_POOL_Alloc(&small));
+}
+
+TEST_F(AppPoolTest, RefusesMoreBlocksThanItsFreeMapHolds)
+{
+    uintptr_t words[APP_POOL_BLOCKS_MAX + 1U];
+    APP_POOL large;
+
+    EXPECT_FALSE(APP_POOL_Create(&large, "large", words, sizeof(uintptr_t), APP_POOL_BLOCKS_MAX + 1U));
+    EXPECT_EQ(1U, app_poolData.poolCount);
+
+    /* the most blocks, each given out once */
+    ASSERT_TRUE(APP_POOL_Create(&large, "most", words, sizeof(uintptr_t), APP_POOL_BLOCKS_MAX));
+
+    for (uint32_t i = 0U; i < APP_POOL_BLOCKS_MAX; i++)
+    {
+        EXPECT_EQ(&words[i], APP_POOL_Alloc(&large));
+    }
+
+    EXPECT_EQ(nullptr, APP_POOL_Alloc(&large));
+    APP_POOL_Free(&large, &words[APP_POOL_BLOCKS_MAX - 1U]);
+    APP_POOL_Free(&large, &words[APP_POOL_BLOCKS_MAX - 1U]);
+    EXPECT_EQ(1U, large.freeErrorCount);
+}
+
+TEST_F(AppPoolTest, ReportsEveryPool)
+{
+    uintptr_t words[2U * 3U];
+    APP_POOL pairs;
+    const char* output;
+    void* taken;
+
+    ASSERT_TRUE(APP_POOL_Create(&pairs, "pairs", words, 2U * sizeof(uintptr_t), 3U));
+
+    taken = APP_POOL_Alloc(&pool);
+    (void) APP_POOL_Alloc(&pool);
+    APP_POOL_Free(&pool, taken);
+    APP_POOL_Free(&pool, taken);
+    (void) APP_POOL_Alloc(&pairs);
+
+    /* the last line is still on the line when the report returns */
+    APP_POOL_Report();
+    HOST_TimeAdvance(20U * HOST_NS_PER_MS);
+    output = HOST_CONSOLE_OutputGet(NULL);
+
+    EXPECT_NE(nullptr, strstr(output, "Pool records: 1 of 4 blocks of 16 bytes in use, peak 2, "
+                                      "exhausted 0 times, 1 bad frees"));
+    EXPECT_NE(nullptr, strstr(output, "Pool pairs: 1 of 3 blocks of"));
+}
+
+TEST_F(AppPoolTest, ListsNoMoreThanTheMostPools)
+{
+    uintptr_t words[APP_POOL_MAX][1];
+    APP_POOL pools[APP_POOL_MAX];
+
+    /* the fixture's pool is the first */
+    for (uint32_t i = 1U; i < APP_POOL_MAX; i++)
+    {
+        EXPECT_TRUE(APP_POOL_Create(&pools[i], "more", words[i], sizeof(words[i]), 1U));
+    }
+
+    /* set up, but not listed */
+    EXPECT_FALSE(APP_POOL_Create(&pools[0], "last", words[0], sizeof(words[0]), 1U));
+    EXPECT_EQ(APP_POOL_MAX, app_poolData.poolCount);
+    EXPECT_EQ(&words[0][0], APP_POOL_Alloc(&pools[0]));
+}
+
+}
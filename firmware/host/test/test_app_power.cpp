@@ -0,0 +1,239 @@
+/*******************************************************************************
+  Low Power Task Host Tests
+
+  File Name:
+    test_app_power.cpp
+
+  Summary:
+    Runs the whole firmware in virtual time and checks how it sleeps.
+
+  Description:
+    SYS_Initialize and SYS_Tasks run unchanged on the simulated PLIBs, with no
+    SD card inserted. TC0 stops in STANDBY as on the board, so SYS_TIME keeps
+    the true time only through the compensation that APP_POWER measures
+    against the RTC.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <time.h>
+
+#include "definitions.h"
+#include "app_config.h"
+#include "app_power.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+namespace
+{
+
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+
+/* Each test runs in its own process, on a device that has just powered up */
+class AppPowerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        HOST_Reset();
+        HOST_NVM_Erase();
+        SYS_Initialize(NULL);
+        DRV_BME280_SIM_Initialize(0x76, NULL);
+    }
+
+    void RunFor( uint64_t ns )
+    {
+        HOST_Run(SYS_Tasks, HOST_TimeGet() + ns, kPassNs);
+    }
+
+    /* Difference between the time SYS_TIME keeps and the virtual time */
+    int64_t ClockErrorNs()
+    {
+        uint64_t count = SYS_TIME_Counter64Get();
+        uint64_t ns = (count * HOST_NS_PER_S) / SYS_TIME_FrequencyGet();
+
+        return (int64_t)ns - (int64_t)HOST_TimeGet();
+    }
+
+    void PeriodSet( uint32_t ms )
+    {
+        ASSERT_TRUE(APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, ms));
+    }
+
+    uint32_t Samples()
+    {
+        return APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_SAMPLES);
+    }
+};
+
+TEST_F(AppPowerTest, SleepsInIdleWithoutACard)
+{
+    HOST_STATISTICS stats;
+
+    RunFor(20U * HOST_NS_PER_S);
+    HOST_StatisticsGet(&stats);
+
+    /* waiting for a card does not keep the core awake */
+    EXPECT_GT(stats.idleNs, 18U * HOST_NS_PER_S);
+    EXPECT_EQ(0U, stats.standbyEntries);
+    EXPECT_GE(Samples(), 3U);
+}
+
+TEST_F(AppPowerTest, KeyPressedInIdleIsServed)
+{
+    size_t size;
+
+    RunFor(3U * HOST_NS_PER_S);
+    HOST_CONSOLE_OutputClear();
+
+    HOST_CONSOLE_Input("5", 1);
+    RunFor(100U * HOST_NS_PER_MS);
+
+    (void) HOST_CONSOLE_OutputGet(&size);
+    EXPECT_GT(size, 0U);
+    EXPECT_EQ(0U, HOST_CONSOLE_LostCountGet());
+}
+
+TEST_F(AppPowerTest, IrqReportLeavesTheSensorTransfersAlone)
+{
+    DRV_BME280_STATISTICS stats;
+    const char* output;
+    uint32_t samples;
+    uint32_t i;
+
+    PeriodSet(100U);
+    RunFor(HOST_NS_PER_S);
+    samples = Samples();
+    HOST_CONSOLE_OutputClear();
+
+    /* reports asked for as the sensor transfers start */
+    for (i = 0U; i < 10U; i++)
+    {
+        while (SERCOM3_I2C_IsBusy() == false)
+        {
+            RunFor(kPassNs);
+        }
+
+        HOST_CONSOLE_Input("6", 1);
+        RunFor(100U * HOST_NS_PER_MS);
+    }
+
+    /* SERCOM3 is left out while it is busy */
+    output = HOST_CONSOLE_OutputGet(NULL);
+    EXPECT_NE(nullptr, strstr(output, "IRQ: SERCOM2 "));
+    EXPECT_EQ(nullptr, strstr(output, "IRQ: SERCOM3 "));
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+    EXPECT_EQ(0U, stats.nackCount);
+    EXPECT_EQ(0U, stats.busErrorCount);
+    EXPECT_GE(Samples(), samples + 9U);
+
+    /* and measured between the samples */
+    PeriodSet(10000U);
+    RunFor(200U * HOST_NS_PER_MS);
+    HOST_CONSOLE_Input("6", 1);
+    RunFor(100U * HOST_NS_PER_MS);
+    EXPECT_NE(nullptr, strstr(HOST_CONSOLE_OutputGet(NULL), "IRQ: SERCOM3 "));
+}
+
+TEST_F(AppPowerTest, SleepsAfterASensorReadFails)
+{
+    DRV_BME280_STATISTICS sensor;
+    HOST_STATISTICS before;
+    HOST_STATISTICS after;
+    uint32_t samples;
+
+    RunFor(3U * HOST_NS_PER_S);
+    samples = Samples();
+
+    /* the sensor does not acknowledge the next sample read */
+    DRV_BME280_SIM_FaultSet(DRV_BME280_SIM_FAULT_NACK, 0U, 1U);
+    HOST_StatisticsGet(&before);
+    RunFor(20U * HOST_NS_PER_S);
+    HOST_StatisticsGet(&after);
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &sensor));
+    EXPECT_EQ(1U, sensor.nackCount);
+
+    /* the failed read keeps the core awake no longer than a good one, and
+     * the reads after it are logged */
+    EXPECT_GT(after.idleNs - before.idleNs, 18U * HOST_NS_PER_S);
+    EXPECT_GE(Samples(), samples + 2U);
+}
+
+TEST_F(AppPowerTest, StandbyIsOffByDefault)
+{
+    HOST_STATISTICS stats;
+
+    PeriodSet(10000U);
+    RunFor(30U * HOST_NS_PER_S);
+    HOST_StatisticsGet(&stats);
+
+    EXPECT_EQ(0U, stats.standbyEntries);
+}
+
+TEST_F(AppPowerTest, StandbyKeepsTheSystemTime)
+{
+    HOST_STATISTICS stats;
+    APP_POWER_STATISTICS power;
+
+    PeriodSet(10000U);
+    APP_POWER_StandbyEnable(true);
+    RunFor(65U * HOST_NS_PER_S);
+
+    HOST_StatisticsGet(&stats);
+    APP_POWER_StatisticsGet(&power);
+    ASSERT_GE(stats.standbyEntries, 4U);
+    EXPECT_EQ(stats.standbyEntries, power.standbyEntries);
+    EXPECT_GT(stats.standbyNs, 40U * HOST_NS_PER_S);
+
+    /* the compensation is measured in whole RTC seconds, so only the wake
+     * latency is estimated */
+    EXPECT_LT(llabs(ClockErrorNs()), (long long)(stats.standbyEntries * 20U * HOST_NS_PER_US));
+    EXPECT_GE(Samples(), 6U);
+}
+
+TEST_F(AppPowerTest, StandbyAcrossTheMinuteWrapsTheRtcSeconds)
+{
+    struct tm now;
+    HOST_STATISTICS stats;
+
+    RTC_RTCCTimeGet(&now);
+    now.tm_sec = 55;
+    RTC_RTCCTimeSet(&now);
+
+    PeriodSet(10000U);
+    APP_POWER_StandbyEnable(true);
+    RunFor(35U * HOST_NS_PER_S);
+
+    HOST_StatisticsGet(&stats);
+    ASSERT_GE(stats.standbyEntries, 2U);
+
+    /* an alarm set for second 60 or more never matches, and a wrong modulo
+     * in the measured time would throw the clock off by a minute */
+    EXPECT_LT(llabs(ClockErrorNs()), (long long)(stats.standbyEntries * 20U * HOST_NS_PER_US));
+    EXPECT_GE(Samples(), 3U);
+}
+
+TEST_F(AppPowerTest, StandbyLastsAt59SecondsAtMost)
+{
+    HOST_STATISTICS stats;
+    uint32_t samples;
+
+    PeriodSet(300000U);
+    APP_POWER_StandbyEnable(true);
+    RunFor(5U * HOST_NS_PER_S);
+    samples = Samples();
+
+    RunFor(600U * HOST_NS_PER_S);
+    HOST_StatisticsGet(&stats);
+
+    /* RTC_ALARM_MASK_SS matches the seconds only, so each STANDBY is cut at
+     * APP_POWER_STANDBY_MAX_S and the gap between samples takes several */
+    ASSERT_GE(stats.standbyEntries, 10U);
+    EXPECT_LE(stats.standbyNs / stats.standbyEntries, (uint64_t)APP_POWER_STANDBY_MAX_S * HOST_NS_PER_S);
+    EXPECT_EQ(samples + 2U, Samples());
+    EXPECT_LT(llabs(ClockErrorNs()), (long long)(stats.standbyEntries * 20U * HOST_NS_PER_US));
+}
+
+}
@@ -0,0 +1,543 @@
+/*******************************************************************************
+  Logged Data Download Host Tests
+
+  File Name:
+    test_app_query.cpp
+
+  Summary:
+    Downloads logged records over the simulated console and decodes them
+    with the host client.
+
+  Description:
+    The command is typed on the terminal of plib_sercom2_usart_sim.c and the
+    frames the terminal receives go through the decoder of query_client.c.
+    The range search runs on log files and an index written by the test, in
+    the format of app_sdcard.c, so that the parts the query may skip and the
+    values it must encode are known. The console test runs the whole logger.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#include "definitions.h"
+#include "app_sdcard.h"
+#include "host_sim.h"
+#include "host_plib.h"
+#include "query_client.h"
+
+extern "C" APP_SDCARD_DATA app_sdcardData;
+
+namespace
+{
+
+constexpr const char* kMount = SYS_FS_MEDIA_IDX0_MOUNT_NAME_VOLUME_IDX0;
+constexpr uint32_t kCardBlocks = 131072U;
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+constexpr uint64_t kSampleNs = (uint64_t)APP_CONFIG_SAMPLE_PERIOD_MS * HOST_NS_PER_MS;
+
+/* Records of the test's log files, and index entries every kStride of them */
+constexpr uint32_t kFirstRecords = 400U;
+constexpr uint32_t kSecondRecords = 200U;
+constexpr uint32_t kStride = 50U;
+
+/* Seconds from 2000/01/01 of a time in UTC */
+uint32_t Seconds( int year, int month, int day, int hour, int minute, int second )
+{
+    struct tm time = {};
+
+    time.tm_year = year - 1900;
+    time.tm_mon = month - 1;
+    time.tm_mday = day;
+    time.tm_hour = hour;
+    time.tm_min = minute;
+    time.tm_sec = second;
+
+    return (uint32_t)(timegm(&time) - (time_t)QUERY_CLIENT_EPOCH_2000);
+}
+
+/* A record of the test's logs, with the values the query should send */
+struct Record
+{
+    QUERY_CLIENT_RECORD values;
+    std::string line;
+};
+
+/* The values sweep through zero, so that the signs are encoded too */
+Record RecordMake( uint32_t time, uint32_t i, bool isDerived )
+{
+    Record record = {};
+    time_t seconds = (time_t)time + (time_t)QUERY_CLIENT_EPOCH_2000;
+    struct tm date;
+    char line[160];
+    int length;
+
+    record.values.time = time;
+    record.values.milliseconds = (uint16_t)((i * 37U) % 1000U);
+    record.values.isDerived = isDerived;
+    record.values.temperature = (int16_t)(-1000 + (int32_t)(7U * i));
+    record.values.pressure = 95000U + (13U * i);
+    record.values.humidity = (uint16_t)(200U + (i % 700U));
+
+    (void) gmtime_r(&seconds, &date);
+    length = snprintf(line, sizeof(line), "[%04d/%02d/%02d %02d:%02d:%02d.%03u] %6.2f %7.2f %5.1f",
+                      date.tm_year + 1900, date.tm_mon + 1, date.tm_mday, date.tm_hour, date.tm_min, date.tm_sec,
+                      (unsigned)record.values.milliseconds, record.values.temperature / 100.0,
+                      record.values.pressure / 100.0, record.values.humidity / 10.0);
+
+    if (isDerived == true)
+    {
+        record.values.dewPoint = (int16_t)(-1500 + (int32_t)(5U * i));
+        record.values.absoluteHumidity = (uint16_t)(150U + (3U * i));
+        record.values.pressureAltitude = -12050 + (int32_t)(125U * i);
+        record.values.seaLevelPressure = 100000U + (11U * i);
+        length += snprintf(&line[length], sizeof(line) - (size_t)length, " %6.2f %6.2f %8.2f %7.2f",
+                           record.values.dewPoint / 100.0, record.values.absoluteHumidity / 100.0,
+                           record.values.pressureAltitude / 100.0, record.values.seaLevelPressure / 100.0);
+    }
+
+    /* the seal of a journaled record */
+    (void) snprintf(&line[length], sizeof(line) - (size_t)length, " *0000002A %04X\r\n", i);
+    record.line = line;
+
+    return record;
+}
+
+/* A log file the test writes, and its index entries */
+struct LogFile
+{
+    std::string name;
+    std::string data;
+    std::vector<Record> records;
+};
+
+std::string HeaderMake( size_t length )
+{
+    char header[40];
+
+    (void) snprintf(header, sizeof(header), "#LOG len=%010lu s=%08lX\r\n", (unsigned long)length, 0x2AUL);
+
+    return header;
+}
+
+std::string IndexLineMake( const LogFile& file, size_t record, size_t offset, bool isReset )
+{
+    time_t seconds = (time_t)file.records[record].values.time + (time_t)QUERY_CLIENT_EPOCH_2000;
+    struct tm date;
+    char line[96];
+
+    (void) gmtime_r(&seconds, &date);
+    (void) snprintf(line, sizeof(line), "%04d/%02d/%02d %02d:%02d:%02d %s %lu%s\r\n", date.tm_year + 1900,
+                    date.tm_mon + 1, date.tm_mday, date.tm_hour, date.tm_min, date.tm_sec, file.name.c_str(),
+                    (unsigned long)offset, (isReset == true) ? " " APP_SDCARD_INDEX_RESET : "");
+
+    return line;
+}
+
+/* What the terminal received for a download */
+struct Download
+{
+    bool isStarted;
+    bool isEnded;
+    QUERY_CLIENT_START start;
+    QUERY_CLIENT_END end;
+    std::vector<QUERY_CLIENT_RECORD> records;
+
+    /* Bytes outside frames between the start and the end frame, and frames
+     * dropped for their CRC */
+    uint32_t textCount;
+    uint32_t crcErrorCount;
+};
+
+/* Each test runs in its own process, on a device that has just powered up
+ * with a blank card in the slot. The device does not enter STANDBY, which
+ * would stop the console. */
+class AppQueryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        /* The firmware's times are UTC, whatever the time zone of the C
+         * library */
+        (void) setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+        tzset();
+
+        HOST_Reset();
+        HOST_NVM_Erase();
+        HOST_SDCARD_Create(kCardBlocks, true);
+        HOST_SDCARD_Insert();
+        SYS_Initialize(NULL);
+        DRV_BME280_SIM_Initialize(DRV_BME280_I2C_ADDRESS, NULL);
+        APP_POWER_StandbyEnable(false);
+    }
+
+    void RunFor( uint64_t ns )
+    {
+        HOST_Run(SYS_Tasks, HOST_TimeGet() + ns, kPassNs);
+    }
+
+    /* Runs the firmware until the blank card is mounted and formats it. The
+     * log does not start until the card is put back. */
+    bool FormatOnly()
+    {
+        SYS_FS_FORMAT_PARAM opt = {};
+        static uint8_t work[512];
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        opt.fmt = SYS_FS_FORMAT_FAT;
+
+        while (SYS_FS_DriveFormat(kMount, &opt, work, sizeof(work)) != SYS_FS_RES_SUCCESS)
+        {
+            if (HOST_TimeGet() >= until)
+            {
+                return false;
+            }
+
+            RunFor(HOST_NS_PER_MS);
+        }
+
+        return true;
+    }
+
+    /* Puts the card back and runs the firmware until the log file is open */
+    bool Reinsert()
+    {
+        uint64_t until;
+
+        HOST_SDCARD_Remove();
+        RunFor(100U * HOST_NS_PER_MS);
+        HOST_SDCARD_Insert();
+
+        for (until = HOST_TimeGet() + HOST_NS_PER_S; HOST_TimeGet() < until; RunFor(HOST_NS_PER_MS))
+        {
+            if (app_sdcardData.state == APP_SDCARD_STATE_WRITE)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool FileWrite( const std::string& name, const std::string& data )
+    {
+        std::string path = std::string(kMount) + "/" + name;
+        SYS_FS_HANDLE file = SYS_FS_FileOpen(path.c_str(), SYS_FS_FILE_OPEN_WRITE);
+        bool isWritten;
+
+        if (file == SYS_FS_HANDLE_INVALID)
+        {
+            return false;
+        }
+
+        isWritten = (SYS_FS_FileWrite(file, data.data(), data.size()) == data.size());
+
+        return (SYS_FS_FileClose(file) == SYS_FS_RES_SUCCESS) && (isWritten == true);
+    }
+
+    /* Writes the log file of the records and lists it in the index every
+     * kStride records, and at reset, the first record whose time goes back */
+    void LogWrite( LogFile& file, std::string& index, size_t reset )
+    {
+        std::vector<size_t> offsets;
+        std::string body;
+
+        for (const Record& record : file.records)
+        {
+            offsets.push_back(body.size());
+            body += record.line;
+        }
+
+        file.data = HeaderMake(HeaderMake(0U).size() + body.size()) + body;
+
+        for (size_t i = 0U; i < file.records.size(); i++)
+        {
+            if (((i % kStride) == 0U) || (i == reset))
+            {
+                index += IndexLineMake(file, i, HeaderMake(0U).size() + offsets[i], i == reset);
+            }
+        }
+
+        ASSERT_TRUE(FileWrite(file.name, file.data));
+    }
+
+    /* Writes the test's logs: a day of records with the derived quantities,
+     * then a day without them whose clock was set back halfway */
+    void LogsWrite( LogFile& first, LogFile& second )
+    {
+        std::string index;
+
+        first.name = "data_20261001_100000.txt";
+        for (uint32_t i = 0U; i < kFirstRecords; i++)
+        {
+            first.records.push_back(RecordMake(Seconds(2026, 10, 1, 10, 0, 0) + (5U * i), i, true));
+        }
+
+        second.name = "data_20261002_080000.txt";
+        for (uint32_t i = 0U; i < kSecondRecords; i++)
+        {
+            uint32_t start = (i < (kSecondRecords / 2U)) ? Seconds(2026, 10, 2, 8, 0, 0) :
+                             Seconds(2026, 10, 2, 6, 0, 0) - (5U * (kSecondRecords / 2U));
+
+            second.records.push_back(RecordMake(start + (5U * i), i, false));
+        }
+
+        LogWrite(first, index, SIZE_MAX);
+        LogWrite(second, index, kSecondRecords / 2U);
+        ASSERT_TRUE(FileWrite(APP_SDCARD_INDEX_FILE, index));
+    }
+
+    /* Types the download command and decodes what the terminal receives
+     * until the end frame, or for at most a minute. Text follows the
+     * command on the line when given. */
+    Download Query( const char* range, const char* text = "" )
+    {
+        std::string command = std::string("2 ") + range + "\r" + text;
+        Download download = {};
+        QUERY_CLIENT_DECODER decoder;
+        QUERY_CLIENT_RECORD record;
+        uint32_t textCount = 0U;
+        uint64_t until = HOST_TimeGet() + (60U * HOST_NS_PER_S);
+        size_t position = 0U;
+        size_t size = 0U;
+        const char* output;
+
+        QUERY_CLIENT_Initialize(&decoder);
+        HOST_CONSOLE_OutputClear();
+        HOST_CONSOLE_Input(command.data(), command.size());
+
+        while ((download.isEnded == false) && (HOST_TimeGet() < until))
+        {
+            RunFor(HOST_NS_PER_MS);
+            output = HOST_CONSOLE_OutputGet(&size);
+
+            for (; (download.isEnded == false) && (position < size); position++)
+            {
+                if (QUERY_CLIENT_Put(&decoder, (uint8_t)output[position]) == false)
+                {
+                    continue;
+                }
+
+                if (QUERY_CLIENT_StartGet(&decoder, &download.start) == true)
+                {
+                    download.isStarted = true;
+                    textCount = decoder.textCount;
+                }
+
+                for (size_t i = 0U; QUERY_CLIENT_RecordGet(&decoder, i, &record) == true; i++)
+                {
+                    download.records.push_back(record);
+                }
+
+                download.isEnded = QUERY_CLIENT_EndGet(&decoder, &download.end);
+            }
+        }
+
+        download.textCount = decoder.textCount - textCount;
+        download.crcErrorCount = decoder.crcErrorCount;
+
+        return download;
+    }
+
+    /* Checks the records sent against those of the logs in [from, to], in
+     * the order of the logs */
+    void RecordsExpect( const Download& download, const std::vector<const LogFile*>& files, uint32_t from,
+                        uint32_t to )
+    {
+        size_t n = 0U;
+
+        for (const LogFile* file : files)
+        {
+            for (const Record& expected : file->records)
+            {
+                if ((expected.values.time < from) || (expected.values.time > to))
+                {
+                    continue;
+                }
+
+                ASSERT_LT(n, download.records.size()) << expected.line;
+
+                const QUERY_CLIENT_RECORD& record = download.records[n++];
+
+                EXPECT_EQ(expected.values.time, record.time) << expected.line;
+                EXPECT_EQ(expected.values.milliseconds, record.milliseconds) << expected.line;
+                EXPECT_EQ(expected.values.isDerived, record.isDerived) << expected.line;
+                EXPECT_EQ(expected.values.temperature, record.temperature) << expected.line;
+                EXPECT_EQ(expected.values.pressure, record.pressure) << expected.line;
+                EXPECT_EQ(expected.values.humidity, record.humidity) << expected.line;
+                EXPECT_EQ(expected.values.dewPoint, record.dewPoint) << expected.line;
+                EXPECT_EQ(expected.values.absoluteHumidity, record.absoluteHumidity) << expected.line;
+                EXPECT_EQ(expected.values.pressureAltitude, record.pressureAltitude) << expected.line;
+                EXPECT_EQ(expected.values.seaLevelPressure, record.seaLevelPressure) << expected.line;
+            }
+        }
+
+        EXPECT_EQ(n, download.records.size());
+    }
+};
+
+TEST(QueryClient, DropsDamagedFramesAndKeepsTheNextOne)
+{
+    /* an end frame with no totals, and a start frame, as app_query.c
+     * frames them */
+    std::vector<uint8_t> end = { QUERY_CLIENT_SYNC, QUERY_CLIENT_TYPE_END, 21U };
+    std::vector<uint8_t> start = { QUERY_CLIENT_SYNC, QUERY_CLIENT_TYPE_START, 9U, 1U, 0U, 0U, 0U, 2U, 0U, 0U, 0U,
+                                   QUERY_CLIENT_RECORD_LEN };
+    std::vector<uint8_t> stream = { 'o', 'k', ' ', QUERY_CLIENT_SYNC, '\r', '\n' };
+    QUERY_CLIENT_DECODER decoder;
+    QUERY_CLIENT_START values = {};
+    uint32_t frames = 0U;
+    uint16_t crc;
+
+    end.resize(3U + 21U, 0U);
+    for (std::vector<uint8_t>* frame : { &end, &start })
+    {
+        crc = QUERY_CLIENT_Crc16(0xFFFFU, &(*frame)[1], frame->size() - 1U);
+        frame->push_back((uint8_t)crc);
+        frame->push_back((uint8_t)(crc >> 8));
+    }
+
+    /* a damaged end frame runs into the start frame, then both come whole */
+    end[10] ^= 0x01U;
+    stream.insert(stream.end(), end.begin(), end.end() - 8);
+    stream.insert(stream.end(), start.begin(), start.end());
+    end[10] ^= 0x01U;
+    stream.insert(stream.end(), end.begin(), end.end());
+    stream.insert(stream.end(), start.begin(), start.end());
+
+    QUERY_CLIENT_Initialize(&decoder);
+
+    for (uint8_t byte : stream)
+    {
+        if (QUERY_CLIENT_Put(&decoder, byte) == true)
+        {
+            frames++;
+        }
+    }
+
+    /* "ok ", the stray sync byte and the damaged frame are not frames */
+    EXPECT_EQ(3U, frames);
+    EXPECT_EQ(3U, decoder.frameCount);
+    EXPECT_LE(1U, decoder.crcErrorCount);
+    EXPECT_EQ(3U + 3U + end.size() - 8U, decoder.textCount);
+    ASSERT_TRUE(QUERY_CLIENT_StartGet(&decoder, &values));
+    EXPECT_EQ(1U, values.from);
+    EXPECT_EQ(2U, values.to);
+    EXPECT_EQ(QUERY_CLIENT_RECORD_LEN, values.recordLength);
+}
+
+TEST_F(AppQueryTest, EncodesEveryRecordOfTheLogs)
+{
+    LogFile first;
+    LogFile second;
+    Download download;
+
+    ASSERT_TRUE(FormatOnly());
+    LogsWrite(first, second);
+
+    download = Query("20261001000000 20261002235959");
+
+    ASSERT_TRUE(download.isStarted);
+    ASSERT_TRUE(download.isEnded);
+    EXPECT_EQ(Seconds(2026, 10, 1, 0, 0, 0), download.start.from);
+    EXPECT_EQ(Seconds(2026, 10, 2, 23, 59, 59), download.start.to);
+    EXPECT_EQ(QUERY_CLIENT_RECORD_LEN, download.start.recordLength);
+    EXPECT_EQ((uint8_t)APP_QUERY_STATUS_OK, download.end.status);
+    EXPECT_EQ(kFirstRecords + kSecondRecords, download.end.recordCount);
+    EXPECT_EQ(2U, download.end.fileCount);
+    EXPECT_EQ(first.data.size() + second.data.size(), download.end.byteCount);
+    EXPECT_EQ(0U, download.crcErrorCount);
+    RecordsExpect(download, { &first, &second }, 0U, UINT32_MAX);
+}
+
+TEST_F(AppQueryTest, ReadsOnlyThePartsInRange)
+{
+    LogFile first;
+    LogFile second;
+    Download download;
+    uint32_t from = Seconds(2026, 10, 1, 10, 12, 35);
+    uint32_t to = Seconds(2026, 10, 1, 10, 13, 20);
+    size_t part = 0U;
+
+    ASSERT_TRUE(FormatOnly());
+    LogsWrite(first, second);
+
+    /* records 151 to 160, in the part of the fourth index entry */
+    download = Query("20261001101235 20261001101320");
+
+    for (size_t i = 3U * kStride; i < (4U * kStride); i++)
+    {
+        part += first.records[i].line.size();
+    }
+
+    ASSERT_TRUE(download.isEnded);
+    EXPECT_EQ(10U, download.end.recordCount);
+    EXPECT_EQ(1U, download.end.fileCount);
+    EXPECT_EQ(1U, download.end.seekCount);
+    EXPECT_LE(download.end.byteCount, part + 512U);
+    RecordsExpect(download, { &first }, from, to);
+}
+
+TEST_F(AppQueryTest, FindsTheRecordsAfterTheClockWasSetBack)
+{
+    LogFile first;
+    LogFile second;
+    Download download;
+
+    ASSERT_TRUE(FormatOnly());
+    LogsWrite(first, second);
+
+    /* the index entry before the reset is later than the range, and the
+     * records after it earlier than that entry. The last part of the first
+     * file may hold records up to the time of the second file's first: it
+     * and the part after the reset are read. */
+    download = Query("20261002060000 20261002060100");
+
+    ASSERT_TRUE(download.isEnded);
+    EXPECT_EQ(13U, download.end.recordCount);
+    EXPECT_EQ(2U, download.end.fileCount);
+    EXPECT_EQ(2U, download.end.seekCount);
+    EXPECT_LT(download.end.byteCount, (first.data.size() + second.data.size()) / 4U);
+    RecordsExpect(download, { &second }, Seconds(2026, 10, 2, 6, 0, 0), Seconds(2026, 10, 2, 6, 1, 0));
+}
+
+TEST_F(AppQueryTest, KeepsConsoleTextOutOfTheDownload)
+{
+    struct tm morning = {};
+    Download download;
+    size_t size;
+
+    morning.tm_year = 2026 - 1900;
+    morning.tm_mon = 9;
+    morning.tm_mday = 19;
+    morning.tm_hour = 9;
+    RTC_RTCCTimeSet(&morning);
+
+    ASSERT_TRUE(FormatOnly());
+    ASSERT_TRUE(Reinsert());
+    RunFor(40U * kSampleNs);
+
+    /* the report of key 5 is printed while the frames are sent, and each
+     * new record is echoed */
+    download = Query("20261019000000 20261019235959", "5");
+
+    ASSERT_TRUE(download.isStarted);
+    ASSERT_TRUE(download.isEnded);
+    EXPECT_EQ((uint8_t)APP_QUERY_STATUS_OK, download.end.status);
+    EXPECT_LE(30U, download.end.recordCount);
+    EXPECT_EQ(download.end.recordCount, download.records.size());
+    EXPECT_EQ(0U, download.textCount);
+    EXPECT_EQ(0U, download.crcErrorCount);
+
+    /* the console prints again once the download is over */
+    HOST_CONSOLE_OutputClear();
+    HOST_CONSOLE_Input("5", 1U);
+    RunFor(HOST_NS_PER_S);
+    EXPECT_NE(nullptr, strstr(HOST_CONSOLE_OutputGet(&size), "I2C:"));
+}
+
+}
@@ -0,0 +1,782 @@
+/*******************************************************************************
+  SD Card Log Host Tests
+
+  File Name:
+    test_app_sdcard.cpp
+
+  Summary:
+    Runs the whole firmware with a simulated SD card and checks the log.
+
+  Description:
+    SYS_Initialize and SYS_Tasks run unchanged on the simulated PLIBs. The card
+    of plib_sdhc1_regs_sim.c starts blank: it is formatted through SYS_FS once
+    the automount has found no file system on it, then taken out and put back
+    so that APP_SDCARD sees it mounted, as it would a card formatted elsewhere.
+
+    The tests read the log files back through SYS_FS. A power cut of the card
+    loses the blocks written after it, which the journal recovers from when
+    the card comes back.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "definitions.h"
+#include "app_sdcard.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" APP_SDCARD_DATA app_sdcardData;
+
+namespace
+{
+
+constexpr const char* kMount = SYS_FS_MEDIA_IDX0_MOUNT_NAME_VOLUME_IDX0;
+constexpr uint32_t kCardBlocks = 131072U;
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+constexpr uint64_t kSampleNs = (uint64_t)APP_CONFIG_SAMPLE_PERIOD_MS * HOST_NS_PER_MS;
+
+/* Fixed size header line of a log file, "#LOG len=... s=...\r\n" */
+constexpr size_t kHeaderLength = 32U;
+
+/* Each test runs in its own process, on a device that has just powered up
+ * with a blank card in the slot */
+class AppSdcardTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        SetUpWith(kCardBlocks);
+    }
+
+    void SetUpWith( uint32_t cardBlocks )
+    {
+        /* The firmware's times are UTC, whatever the time zone of the C
+         * library */
+        (void) setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+        tzset();
+
+        HOST_Reset();
+        HOST_NVM_Erase();
+        HOST_SDCARD_Create(cardBlocks, true);
+        HOST_SDCARD_Insert();
+        SYS_Initialize(NULL);
+        DRV_BME280_SIM_Initialize(DRV_BME280_I2C_ADDRESS, NULL);
+    }
+
+    void RunFor( uint64_t ns )
+    {
+        HOST_Run(SYS_Tasks, HOST_TimeGet() + ns, kPassNs);
+    }
+
+    /* Runs the firmware until the blank card is mounted, formats it and
+     * puts it back. Returns once the log file is open. */
+    bool Format()
+    {
+        return (FormatOnly() == true) && (Reinsert() == true);
+    }
+
+    bool FormatOnly()
+    {
+        SYS_FS_FORMAT_PARAM opt = {};
+        static uint8_t work[512];
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        opt.fmt = SYS_FS_FORMAT_FAT;
+
+        while (SYS_FS_DriveFormat(kMount, &opt, work, sizeof(work)) != SYS_FS_RES_SUCCESS)
+        {
+            if (HOST_TimeGet() >= until)
+            {
+                return false;
+            }
+
+            RunFor(HOST_NS_PER_MS);
+        }
+
+        return true;
+    }
+
+    /* Takes the card out and puts it back, and runs the firmware until the
+     * log file is open again */
+    bool Reinsert()
+    {
+        Swap();
+
+        return WaitForLog();
+    }
+
+    void Swap()
+    {
+        ASSERT_TRUE(Unplug());
+        HOST_SDCARD_Insert();
+    }
+
+    /* Takes the card out and runs the firmware until the log has let go of
+     * it. In STANDBY the firmware only sees the card gone at its next
+     * sample. */
+    bool Unplug()
+    {
+        uint64_t until = HOST_TimeGet() + (2U * kSampleNs);
+
+        HOST_SDCARD_Remove();
+        RunFor(100U * HOST_NS_PER_MS);
+
+        while (app_sdcardData.state != APP_SDCARD_STATE_MOUNT_WAIT)
+        {
+            if (HOST_TimeGet() >= until)
+            {
+                return false;
+            }
+
+            RunFor(HOST_NS_PER_MS);
+        }
+
+        return true;
+    }
+
+    bool WaitForLog()
+    {
+        return WaitFor(APP_SDCARD_STATE_WRITE, HOST_NS_PER_S);
+    }
+
+    /* Runs the firmware until the task reaches state, for no more than ns */
+    bool WaitFor( APP_SDCARD_STATES state, uint64_t ns )
+    {
+        uint64_t until = HOST_TimeGet() + ns;
+
+        while (HOST_TimeGet() < until)
+        {
+            if (app_sdcardData.state == state)
+            {
+                return true;
+            }
+
+            RunFor(HOST_NS_PER_MS);
+        }
+
+        return false;
+    }
+
+    /* Contents of a file on the card, or "" if it cannot be read. FatFs
+     * does not open a file twice, so the open log is read through
+     * APP_SDCARD_LogRead, up to its valid length. */
+    std::string FileRead( const char* name )
+    {
+        std::string path = std::string(kMount) + "/" + name;
+        std::string data;
+        SYS_FS_HANDLE file;
+        static char chunk[512];
+        int32_t length;
+        size_t count;
+
+        if (strcmp(name, app_sdcardData.fileName) == 0)
+        {
+            while ((length = APP_SDCARD_LogRead(name, (uint32_t)data.size(), chunk, sizeof(chunk))) > 0)
+            {
+                data.append(chunk, (size_t)length);
+            }
+
+            return data;
+        }
+
+        file = SYS_FS_FileOpen(path.c_str(), SYS_FS_FILE_OPEN_READ);
+
+        if (file == SYS_FS_HANDLE_INVALID)
+        {
+            return data;
+        }
+
+        while ((count = SYS_FS_FileRead(file, chunk, sizeof(chunk))) != (size_t)-1)
+        {
+            if (count == 0U)
+            {
+                break;
+            }
+
+            data.append(chunk, count);
+        }
+
+        (void) SYS_FS_FileClose(file);
+
+        return data;
+    }
+
+    bool FileExists( const char* name )
+    {
+        std::string path = std::string(kMount) + "/" + name;
+        SYS_FS_FSTAT stat = {};
+
+        return (SYS_FS_FileStat(path.c_str(), &stat) == SYS_FS_RES_SUCCESS);
+    }
+
+    /* Number of the log files on the card */
+    uint32_t LogFileCount()
+    {
+        SYS_FS_HANDLE dir = SYS_FS_DirOpen(kMount);
+        SYS_FS_FSTAT stat = {};
+        uint32_t count = 0U;
+
+        if (dir == SYS_FS_HANDLE_INVALID)
+        {
+            return 0U;
+        }
+
+        while ((SYS_FS_DirRead(dir, &stat) == SYS_FS_RES_SUCCESS) && (stat.fname[0] != '\0'))
+        {
+            if (strncmp(stat.fname, "data_", 5) == 0)
+            {
+                count++;
+            }
+        }
+
+        (void) SYS_FS_DirClose(dir);
+
+        return count;
+    }
+
+    /* Writes a file of size bytes, made of text lines */
+    bool FileWrite( const char* name, uint32_t size )
+    {
+        std::string path = std::string(kMount) + "/" + name;
+        static char chunk[512];
+        SYS_FS_HANDLE file;
+        bool isWritten = true;
+
+        (void) memset(chunk, 'x', sizeof(chunk));
+        chunk[sizeof(chunk) - 2U] = '\r';
+        chunk[sizeof(chunk) - 1U] = '\n';
+
+        file = SYS_FS_FileOpen(path.c_str(), SYS_FS_FILE_OPEN_WRITE);
+
+        if (file == SYS_FS_HANDLE_INVALID)
+        {
+            return false;
+        }
+
+        for (uint32_t written = 0U; (isWritten == true) && (written < size); written += sizeof(chunk))
+        {
+            isWritten = (SYS_FS_FileWrite(file, chunk, sizeof(chunk)) == sizeof(chunk));
+        }
+
+        return (SYS_FS_FileClose(file) == SYS_FS_RES_SUCCESS) && (isWritten == true);
+    }
+
+    /* Free space of the card in KB */
+    uint32_t FreeKbGet()
+    {
+        uint32_t totalSectors = 0U;
+        uint32_t freeSectors = 0U;
+
+        (void) SYS_FS_DriveSectorGet(kMount, &totalSectors, &freeSectors);
+
+        return freeSectors / 2U;
+    }
+
+    /* First block of the data area of the FAT16 volume, which holds the
+     * first cluster of the first file written after the format */
+    static uint32_t DataBlockGet()
+    {
+        const uint8_t* card = HOST_SDCARD_DataGet();
+        const uint8_t* boot;
+        uint32_t partition = 0U;
+
+        /* The volume is in the partition of an MBR, or alone on the card */
+        if ((memcmp(&card[0x36], "FAT", 3) != 0) && (memcmp(&card[0x52], "FAT", 3) != 0))
+        {
+            partition = Little32(&card[0x1BE + 8]);
+        }
+
+        boot = &card[(size_t)partition * 512U];
+
+        return partition + Little16(&boot[14]) + (boot[16] * (uint32_t)Little16(&boot[22])) +
+               (((uint32_t)Little16(&boot[17]) * 32U) + 511U) / 512U;
+    }
+
+    static uint32_t Little16( const uint8_t* data )
+    {
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+    }
+
+    static uint32_t Little32( const uint8_t* data )
+    {
+        return Little16(data) | (Little16(&data[2]) << 16);
+    }
+
+    /* Checks the seals of the records of a log against its session: their
+     * sequence numbers count up from zero, and their CRC-16/CCITT covers the
+     * session number and the record. Returns the number of records. */
+    static uint32_t JournalCheck( const std::string& log )
+    {
+        uint32_t session = 0U;
+        uint32_t sequence = 0U;
+        size_t start = log.find("\r\n");
+
+        EXPECT_EQ(1, sscanf(log.c_str(), "#LOG len=%*u s=%8x", &session));
+
+        for (size_t end = log.find("\r\n", start + 2U); end != std::string::npos;
+             start = end, end = log.find("\r\n", end + 2U))
+        {
+            std::string record = log.substr(start + 2U, end - start);
+            uint32_t number = 0U;
+            uint32_t crc = 0U;
+            uint8_t bytes[4] = { (uint8_t)(session >> 24), (uint8_t)(session >> 16),
+                                 (uint8_t)(session >> 8), (uint8_t)session };
+
+            EXPECT_EQ(2, sscanf(record.c_str() + record.size() - 17U, " *%8x %4x", &number, &crc)) << record;
+            EXPECT_EQ(sequence, number) << record;
+            EXPECT_EQ(Crc16(Crc16(0xFFFFU, bytes, sizeof(bytes)), (const uint8_t*)record.data(), record.size() - 7U),
+                      crc) << record;
+            sequence++;
+        }
+
+        return sequence;
+    }
+
+    static uint32_t Crc16( uint32_t crc, const uint8_t* data, size_t length )
+    {
+        for (size_t i = 0U; i < length; i++)
+        {
+            crc ^= (uint32_t)data[i] << 8;
+
+            for (uint32_t bit = 0U; bit < 8U; bit++)
+            {
+                crc = ((crc & 0x8000U) != 0U) ? (((crc << 1) ^ 0x1021U) & 0xFFFFU) : ((crc << 1) & 0xFFFFU);
+            }
+        }
+
+        return crc;
+    }
+
+    /* Lines of text that end with \r\n */
+    static uint32_t LineCount( const std::string& text )
+    {
+        uint32_t count = 0U;
+
+        for (size_t at = text.find("\r\n"); at != std::string::npos; at = text.find("\r\n", at + 2U))
+        {
+            count++;
+        }
+
+        return count;
+    }
+};
+
+TEST_F(AppSdcardTest, LogsTheSamplesToTheCard)
+{
+    ASSERT_TRUE(Format());
+    RunFor(20U * kSampleNs);
+
+    std::string log = FileRead(app_sdcardData.fileName);
+
+    /* The log reads up to the last sync, after the header */
+    ASSERT_FALSE(log.empty());
+    EXPECT_EQ(0U, log.find("#LOG len="));
+    EXPECT_EQ(1U + APP_SDCARD_JOURNAL_SYNC_RECORDS, LineCount(log));
+    EXPECT_NE(std::string::npos, FileRead(APP_SDCARD_INDEX_FILE).find(app_sdcardData.fileName));
+}
+
+TEST_F(AppSdcardTest, FailedLogCreateLeavesNoFileBehind)
+{
+    ASSERT_TRUE(FormatOnly());
+
+    /* The header of the new log file fails to go to the card, after its
+     * directory entry did: once at High Speed, which the driver retries at
+     * Default Speed, then once more, which fails the journal sync */
+    HOST_SDCARD_BlockErrorsSet(DataBlockGet(), 2U);
+    Swap();
+
+    for (uint32_t i = 0U; (app_sdcardData.sdCardMounted == false) || (app_sdcardData.sdCardMountFlag == true) ||
+                          (app_sdcardData.state != APP_SDCARD_STATE_MOUNT_WAIT); i++)
+    {
+        ASSERT_LT(i, 1000U);
+        RunFor(HOST_NS_PER_MS);
+    }
+
+    EXPECT_EQ(SYS_FS_HANDLE_INVALID, app_sdcardData.fileHandle);
+    EXPECT_EQ(0U, LogFileCount());
+
+    /* The card is still mounted: the next sample gives it a log file, the
+     * only one on it */
+    ASSERT_TRUE(WaitFor(APP_SDCARD_STATE_WRITE, 2U * kSampleNs));
+    RunFor(kSampleNs);
+
+    EXPECT_EQ(1U, LogFileCount());
+    EXPECT_TRUE(FileExists(app_sdcardData.fileName));
+}
+
+TEST_F(AppSdcardTest, LogResumesOnACardThatFailedWhileMounted)
+{
+    APP_POWER_STATISTICS before;
+    APP_POWER_STATISTICS after;
+
+    ASSERT_TRUE(Format());
+    RunFor(2U * APP_SDCARD_JOURNAL_SYNC_RECORDS * kSampleNs);
+
+    /* The card stays in the slot and mounted, but its writes fail, the
+     * retry at Default Speed included */
+    HOST_SDCARD_WriteErrorsSet(8U);
+    ASSERT_TRUE(WaitFor(APP_SDCARD_STATE_MOUNT_WAIT, 2U * APP_SDCARD_JOURNAL_SYNC_RECORDS * kSampleNs));
+
+    /* Nothing to do until the next sample: the system sleeps */
+    APP_POWER_StatisticsGet(&before);
+    RunFor(kSampleNs / 2U);
+    APP_POWER_StatisticsGet(&after);
+
+    EXPECT_TRUE(SDHC1_IsCardAttached());
+    EXPECT_TRUE(APP_SDCARD_IsIdle());
+    EXPECT_LT(before.idleEntries + before.standbyEntries, after.idleEntries + after.standbyEntries);
+
+    /* Once the errors are spent a sample opens the log again, and the
+     * records logged since go to the card */
+    ASSERT_TRUE(WaitFor(APP_SDCARD_STATE_WRITE, 4U * kSampleNs));
+    RunFor(2U * APP_SDCARD_JOURNAL_SYNC_RECORDS * kSampleNs);
+
+    uint32_t records = JournalCheck(FileRead(app_sdcardData.fileName));
+
+    EXPECT_LT(0U, records);
+    EXPECT_LE(records, app_sdcardData.sequence);
+    EXPECT_GE(records + app_sdcardData.syncRecords, app_sdcardData.sequence);
+}
+
+TEST_F(AppSdcardTest, JournalResumesAfterPowerCuts)
+{
+    /* samples logged after the cut, and blocks the card still keeps */
+    const uint32_t cuts[][2] = { { 1U, 0U }, { 5U, 1U }, { 12U, 2U }, { 13U, 0U }, { 20U, 3U }, { 7U, 5U } };
+    std::string fileName;
+
+    ASSERT_TRUE(Format());
+    fileName = app_sdcardData.fileName;
+
+    for (const auto& cut : cuts)
+    {
+        std::string durable = FileRead(app_sdcardData.fileName);
+        std::string resumed;
+
+        HOST_SDCARD_PowerCut(cut[1]);
+        RunFor(cut[0] * kSampleNs);
+        ASSERT_TRUE(Unplug());
+        HOST_SDCARD_Insert();
+        ASSERT_TRUE(WaitForLog()) << "samples " << cut[0] << ", blocks " << cut[1];
+
+        /* the records on the card at the cut are still there, followed by
+         * those that reached it after the cut, if any, in one journal */
+        resumed = FileRead(app_sdcardData.fileName);
+
+        EXPECT_EQ(fileName, app_sdcardData.fileName);
+        EXPECT_EQ(0, resumed.compare(kHeaderLength, durable.size() - kHeaderLength, durable, kHeaderLength))
+            << "samples " << cut[0] << ", blocks " << cut[1];
+        EXPECT_LE(JournalCheck(durable), JournalCheck(resumed));
+        EXPECT_LE(JournalCheck(resumed), app_sdcardData.sequence);
+    }
+
+    /* the records logged since the last cut continue the journal */
+    RunFor(2U * APP_SDCARD_JOURNAL_SYNC_RECORDS * kSampleNs);
+
+    uint32_t records = JournalCheck(FileRead(app_sdcardData.fileName));
+
+    EXPECT_LE(records, app_sdcardData.sequence);
+    EXPECT_GE(records + app_sdcardData.syncRecords, app_sdcardData.sequence);
+}
+
+TEST_F(AppSdcardTest, RotatesTheLogAtMidnight)
+{
+    struct tm evening = {};
+    std::string first;
+    std::string closed;
+    std::string index;
+    uint32_t length = 0U;
+
+    evening.tm_year = 2026 - 1900;
+    evening.tm_mon = 9;
+    evening.tm_mday = 19;
+    evening.tm_hour = 23;
+    evening.tm_min = 59;
+    evening.tm_sec = 30;
+    RTC_RTCCTimeSet(&evening);
+
+    ASSERT_TRUE(Format());
+    first = app_sdcardData.fileName;
+    EXPECT_EQ(0U, first.find("data_20261019_2359"));
+
+    RunFor(12U * kSampleNs);
+
+    /* the new day has a file of its own, listed in the index after the
+     * first, and the first is closed at its last record */
+    EXPECT_EQ(0, strncmp(app_sdcardData.fileName, "data_20261020_0000", 18)) << app_sdcardData.fileName;
+    EXPECT_EQ(2U, LogFileCount());
+
+    index = FileRead(APP_SDCARD_INDEX_FILE);
+    EXPECT_LT(index.find(first), index.find(app_sdcardData.fileName));
+
+    closed = FileRead(first.c_str());
+    ASSERT_EQ(1, sscanf(closed.c_str(), "#LOG len=%u", &length));
+    EXPECT_EQ(closed.size(), length);
+    EXPECT_LT(0U, JournalCheck(closed));
+    EXPECT_EQ(std::string::npos, closed.find("[2026/10/20"));
+
+    /* the journal of the new file starts over */
+    RunFor(APP_SDCARD_JOURNAL_SYNC_RECORDS * kSampleNs);
+    EXPECT_LT(0U, JournalCheck(FileRead(app_sdcardData.fileName)));
+}
+
+TEST_F(AppSdcardTest, RotatesTheLogAtItsSizeLimit)
+{
+    /* Longest record with its seal, and the pressure the pushed records
+     * start from, far from that of the sensor's own samples */
+    constexpr uint32_t kRecordMax = 160U;
+    constexpr uint32_t kRotations = 3U;
+    constexpr double kPressureBase = 2000.0;
+    APP_METEO_DATA derived = {};
+    std::vector<std::string> files;
+    std::string index;
+    uint32_t pushed = 0U;
+    uint32_t expected = 0U;
+    struct tm night = {};
+
+    /* the records of all the files fit in the day */
+    night.tm_year = 2026 - 1900;
+    night.tm_mon = 9;
+    night.tm_mday = 19;
+    night.tm_hour = 1;
+    RTC_RTCCTimeSet(&night);
+
+    ASSERT_TRUE(Format());
+    files.push_back(app_sdcardData.fileName);
+
+    /* Records back to back, each with its number in the pressure, until the
+     * log has rotated kRotations times */
+    while (files.size() <= kRotations)
+    {
+        if (app_sdcardData.sampleCount < APP_SDCARD_SAMPLE_RECORDS)
+        {
+            APP_SDCARD_Notify(APP_TIMESTAMP_CountToUS(SYS_TIME_Counter64Get()), 20.0,
+                              kPressureBase + ((double)pushed / 100.0), 50.0, &derived);
+            pushed++;
+        }
+
+        RunFor(100U * HOST_NS_PER_US);
+        ASSERT_NE(APP_SDCARD_STATE_MOUNT_WAIT, app_sdcardData.state);
+        ASSERT_NE(APP_SDCARD_STATE_ERROR, app_sdcardData.state);
+        ASSERT_GT(60000U, pushed);
+
+        if (files.back() != app_sdcardData.fileName)
+        {
+            files.push_back(app_sdcardData.fileName);
+        }
+    }
+
+    /* the records still queued reach the card, and its journal is synced */
+    RunFor((uint64_t)APP_SDCARD_JOURNAL_SYNC_MS * HOST_NS_PER_MS);
+    ASSERT_EQ(0U, app_sdcardData.sampleCount);
+    EXPECT_EQ(kRotations + 1U, LogFileCount());
+    index = FileRead(APP_SDCARD_INDEX_FILE);
+
+    for (size_t i = 0U; i < files.size(); i++)
+    {
+        std::string log = FileRead(files[i].c_str());
+        std::string name = " " + files[i] + " ";
+        size_t offset = 0U;
+
+        EXPECT_LE(log.size(), (size_t)APP_SDCARD_ROTATE_SIZE) << files[i];
+        EXPECT_LT(0U, JournalCheck(log)) << files[i];
+
+        /* every pushed record follows the one before, across files */
+        for (size_t start = kHeaderLength, end; (end = log.find("\r\n", start)) != std::string::npos;
+             start = end + 2U)
+        {
+            double pressure = 0.0;
+
+            ASSERT_EQ(1, sscanf(log.c_str() + start, "[%*[^]]] %*f %lf", &pressure)) << files[i];
+
+            if (pressure >= kPressureBase)
+            {
+                EXPECT_EQ(expected, (uint32_t)(((pressure - kPressureBase) * 100.0) + 0.5))
+                    << files[i] << " at " << start;
+                expected++;
+            }
+        }
+
+        /* The index lists the file at its first record, after the files
+         * before it, then at a record about every APP_SDCARD_INDEX_STRIDE
+         * bytes. A sensor sample queued behind a pushed record goes back in
+         * time, and is listed as a reset wherever it falls. */
+        for (size_t at = index.find(name); at != std::string::npos; at = index.find(name, at + 1U))
+        {
+            char* end = NULL;
+            size_t entry = (size_t)strtoul(index.c_str() + at + name.size(), &end, 10);
+
+            if (offset == 0U)
+            {
+                EXPECT_EQ(kHeaderLength, entry) << files[i];
+                EXPECT_TRUE((i == 0U) || (index.rfind(" " + files[i - 1U] + " ") < at)) << files[i];
+            }
+            else if (strncmp(end, " " APP_SDCARD_INDEX_RESET, strlen(APP_SDCARD_INDEX_RESET) + 1U) == 0)
+            {
+                EXPECT_LT(offset, entry) << files[i];
+            }
+            else
+            {
+                EXPECT_GE(entry, offset + APP_SDCARD_INDEX_STRIDE) << files[i];
+                EXPECT_LT(entry, offset + APP_SDCARD_INDEX_STRIDE + kRecordMax) << files[i];
+            }
+
+            ASSERT_LT(entry, log.size()) << files[i];
+            EXPECT_EQ('[', log[entry]) << files[i] << " at " << entry;
+            offset = entry;
+        }
+
+        /* each file but the last, just opened, is listed up to its end */
+        EXPECT_TRUE(((i + 1U) == files.size()) ||
+                    ((offset + APP_SDCARD_INDEX_STRIDE + kRecordMax) > APP_SDCARD_ROTATE_SIZE)) << files[i];
+    }
+
+    /* none lost and none written twice */
+    EXPECT_EQ(pushed, expected);
+}
+
+TEST_F(AppSdcardTest, WritesAlignedSectorsWithoutCopies)
+{
+    constexpr uint32_t kSectors = 4U;
+    static uint8_t CACHE_ALIGN data[(kSectors + 1U) * 512U];
+    std::string path = std::string(kMount) + "/aligned.bin";
+    SYS_FS_MEDIA_WRITE_STATISTICS before = {};
+    SYS_FS_MEDIA_WRITE_STATISTICS after = {};
+    SYS_FS_HANDLE file;
+
+    ASSERT_TRUE(Format());
+    (void) memset(data, 'a', sizeof(data));
+
+    /* the new directory entry goes to the card first */
+    file = SYS_FS_FileOpen(path.c_str(), SYS_FS_FILE_OPEN_WRITE);
+    ASSERT_NE(SYS_FS_HANDLE_INVALID, file);
+    ASSERT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileSync(file));
+
+    /* Whole sectors from a cache-aligned buffer, at a sector of the file:
+     * FatFs hands the buffer down and the driver's DMA takes it from there */
+    for (uint32_t i = 0U; i < 2U; i++)
+    {
+        ASSERT_TRUE(SYS_FS_MEDIA_MANAGER_WriteStatisticsGet(0U, &before));
+        ASSERT_EQ(kSectors * 512U, SYS_FS_FileWrite(file, data, kSectors * 512U));
+        ASSERT_TRUE(SYS_FS_MEDIA_MANAGER_WriteStatisticsGet(0U, &after));
+
+        EXPECT_EQ(before.bytesWritten + (kSectors * 512U), after.bytesWritten);
+        EXPECT_EQ(before.bytesCopied, after.bytesCopied);
+    }
+
+    /* The same sectors from a buffer off the cache lines are gathered
+     * first, and reach the card at the next flush */
+    ASSERT_TRUE(SYS_FS_MEDIA_MANAGER_WriteStatisticsGet(0U, &before));
+    ASSERT_EQ(kSectors * 512U, SYS_FS_FileWrite(file, &data[1], kSectors * 512U));
+    ASSERT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileSync(file));
+    ASSERT_TRUE(SYS_FS_MEDIA_MANAGER_WriteStatisticsGet(0U, &after));
+
+    EXPECT_LE(before.bytesCopied + (kSectors * 512U), after.bytesCopied);
+    EXPECT_LE(before.bytesWritten + (kSectors * 512U), after.bytesWritten);
+
+    EXPECT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileClose(file));
+}
+
+/* A card of 24 MB, which old logs fill past the free space retention keeps */
+class AppSdcardSmallTest : public AppSdcardTest
+{
+protected:
+    void SetUp() override
+    {
+        SetUpWith(49152U);
+    }
+
+    /* Counts the days of data_202610DD_000000.txt still on the card, checking
+     * that only the oldest are gone */
+    uint32_t KeptCount( uint32_t days )
+    {
+        char name[32];
+        uint32_t kept = 0U;
+
+        for (uint32_t day = 1U; day <= days; day++)
+        {
+            (void) snprintf(name, sizeof(name), "data_202610%02u_000000.txt", day);
+
+            if (FileExists(name) == true)
+            {
+                kept++;
+            }
+            else
+            {
+                EXPECT_EQ(0U, kept) << name << " deleted after a newer log was kept";
+            }
+        }
+
+        return kept;
+    }
+};
+
+TEST_F(AppSdcardSmallTest, RetentionDeletesTheOldestLogs)
+{
+    constexpr uint32_t kOldLogs = 10U;
+    constexpr uint32_t kOldLogSize = 1024U * 1024U;
+    std::string index;
+    char name[32];
+    uint32_t kept = 0U;
+    struct tm evening = {};
+
+    /* a few minutes before the day rolls over */
+    evening.tm_year = 2026 - 1900;
+    evening.tm_mon = 9;
+    evening.tm_mday = 19;
+    evening.tm_hour = 23;
+    evening.tm_min = 57;
+    RTC_RTCCTimeSet(&evening);
+
+    ASSERT_TRUE(FormatOnly());
+
+    /* A card that logged for some days already; the index lists each
+     * file more than once */
+    for (uint32_t day = 1U; day <= kOldLogs; day++)
+    {
+        (void) snprintf(name, sizeof(name), "data_202610%02u_000000.txt", day);
+        ASSERT_TRUE(FileWrite(name, kOldLogSize));
+        index += "2026/10/" + std::string(&name[11], 2) + " 00:00:00 " + name + " 32 reset\r\n";
+        index += "2026/10/" + std::string(&name[11], 2) + " 12:00:00 " + name + " 65568\r\n";
+    }
+
+    {
+        std::string path = std::string(kMount) + "/" + APP_SDCARD_INDEX_FILE;
+        SYS_FS_HANDLE file = SYS_FS_FileOpen(path.c_str(), SYS_FS_FILE_OPEN_WRITE);
+
+        ASSERT_NE(SYS_FS_HANDLE_INVALID, file);
+        ASSERT_EQ(index.size(), SYS_FS_FileWrite(file, index.data(), index.size()));
+        ASSERT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileClose(file));
+    }
+
+    ASSERT_LT(FreeKbGet(), APP_SDCARD_RETAIN_FREE_MIN_KB);
+    ASSERT_TRUE(Reinsert());
+
+    /* The oldest logs are gone, the newer ones all kept */
+    kept = KeptCount(kOldLogs);
+    EXPECT_LT(kept, kOldLogs);
+    EXPECT_LT(0U, kept);
+    EXPECT_EQ(kept + 1U, LogFileCount());
+
+    /* The log of the next day starts from the oldest log still on the
+     * card, once the card has filled up some more */
+    ASSERT_TRUE(FileWrite("filler.bin", 2U * kOldLogSize));
+
+    for (uint32_t i = 0U; (i < 60U) && (strncmp(app_sdcardData.fileName, "data_20261020", 13) != 0); i++)
+    {
+        RunFor(kSampleNs);
+    }
+
+    ASSERT_EQ(0, strncmp(app_sdcardData.fileName, "data_20261020_0000", 18)) << app_sdcardData.fileName;
+    EXPECT_LT(KeptCount(kOldLogs), kept);
+    EXPECT_LT(0U, KeptCount(kOldLogs));
+    EXPECT_EQ(KeptCount(kOldLogs) + 2U, LogFileCount());
+    EXPECT_GE(FreeKbGet() + (APP_SDCARD_LOG_EXTENT_SIZE / 1024U), APP_SDCARD_RETAIN_FREE_MIN_KB);
+}
+
+}
@@ -0,0 +1,205 @@
+/*******************************************************************************
+  Timestamp Service Host Tests
+
+  File Name:
+    test_app_timestamp.cpp
+
+  Summary:
+    Checks the 64-bit SYS_TIME counter and the RTC anchor of APP_TIMESTAMP.
+
+  Description:
+    Only TC0, the RTC, SYS_TIME and APP_TIMESTAMP run. The task loop sleeps
+    in IDLE whenever APP_TIMESTAMP is idle, as APP_POWER would, so hours of
+    virtual time take few passes.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "definitions.h"
+#include "app_timestamp.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" APP_TIMESTAMP_DATA app_timestampData;
+
+namespace
+{
+
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+constexpr uint64_t kResyncNs = (uint64_t)APP_TIMESTAMP_RESYNC_MS * HOST_NS_PER_MS;
+
+uint32_t ticks;
+
+void Tasks( void )
+{
+    APP_TIMESTAMP_Tasks();
+
+    if (APP_TIMESTAMP_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+}
+
+void TickHandler( uintptr_t context )
+{
+    (void) context;
+    ticks++;
+}
+
+/* Each test runs in its own process */
+class AppTimestampTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        struct tm start = {};
+
+        /* The firmware's times are UTC, whatever the time zone of the C
+         * library */
+        (void) setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+        tzset();
+
+        HOST_Reset();
+        ticks = 0U;
+
+        TC0_TimerInitialize();
+        RTC_Initialize();
+        (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+
+        start.tm_year = 2026 - 1900;
+        start.tm_mon = 9;
+        start.tm_mday = 19;
+        start.tm_hour = 12;
+        RTC_RTCCTimeSet(&start);
+        HOST_RTC_PhaseSet(300U * HOST_NS_PER_MS);
+
+        NVIC_Initialize();
+    }
+
+    /* Counts of TC0 since it started, from the virtual time */
+    uint64_t ExpectedCount( int32_t ppm )
+    {
+        return (uint64_t)(((unsigned __int128)HOST_TimeGet() * SYS_TIME_FrequencyGet() * (1000000 + ppm)) /
+                          ((unsigned __int128)HOST_NS_PER_S * 1000000U));
+    }
+
+    /* Wall clock time of the RTC now, in microseconds */
+    int64_t RtcWallUs()
+    {
+        struct tm now;
+        uint64_t next = HOST_RTC_NextSecondGet();
+
+        RTC_RTCCTimeGet(&now);
+
+        return ((int64_t)timegm(&now) * 1000000) + 1000000 - (int64_t)((next - HOST_TimeGet()) / HOST_NS_PER_US);
+    }
+
+    /* Wall clock time APP_TIMESTAMP gives for now, in microseconds */
+    int64_t TimestampWallUs()
+    {
+        struct tm wall;
+        uint32_t microseconds;
+
+        EXPECT_TRUE(APP_TIMESTAMP_ToTime(APP_TIMESTAMP_US_Get(), &wall, &microseconds));
+
+        return ((int64_t)timegm(&wall) * 1000000) + microseconds;
+    }
+};
+
+TEST_F(AppTimestampTest, Counter64CarriesOverThe32BitWrap)
+{
+    SYS_TIME_HANDLE handle;
+    uint64_t wrapNs = ((1ULL << 32) * HOST_NS_PER_S) / SYS_TIME_FrequencyGet();
+
+    handle = SYS_TIME_CallbackRegisterMS(TickHandler, 0, 1000U, SYS_TIME_PERIODIC);
+    ASSERT_NE(SYS_TIME_HANDLE_INVALID, handle);
+
+    HOST_TimeAdvance(wrapNs - HOST_NS_PER_S);
+    EXPECT_LT(SYS_TIME_Counter64Get(), 1ULL << 32);
+
+    HOST_TimeAdvance(2U * HOST_NS_PER_S);
+    uint64_t count = SYS_TIME_Counter64Get();
+
+    EXPECT_GE(count, 1ULL << 32);
+    EXPECT_LE(count - ExpectedCount(0), 1U);
+
+    /* the periodic timer neither lost nor gained a period at the wrap */
+    EXPECT_EQ(HOST_TimeGet() / HOST_NS_PER_S, (uint64_t)ticks);
+}
+
+TEST_F(AppTimestampTest, EqualCounterValuesElapseNothing)
+{
+    HOST_TimeAdvance(3U * HOST_NS_PER_S);
+    TC0_TimerStop();
+
+    uint64_t first = SYS_TIME_Counter64Get();
+    uint64_t second = SYS_TIME_Counter64Get();
+
+    /* an unchanged hardware count is no time, not a full counter period */
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first, SYS_TIME_Counter64Get());
+}
+
+TEST_F(AppTimestampTest, AnchorsAtTheFirstRtcSecond)
+{
+    APP_TIMESTAMP_Initialize();
+    HOST_Run(Tasks, 2U * HOST_NS_PER_S, kPassNs);
+
+    ASSERT_TRUE(app_timestampData.isSynced);
+    EXPECT_LT(llabs(TimestampWallUs() - RtcWallUs()), 20);
+}
+
+TEST_F(AppTimestampTest, LearnsTheDriftOfTheCounter)
+{
+    HOST_TC0_ClockErrorSet(50);
+    APP_TIMESTAMP_Initialize();
+
+    HOST_Run(Tasks, (3U * kResyncNs) + (5U * HOST_NS_PER_S), kPassNs);
+
+    /* TC0 runs 50 ppm fast, so its microseconds are 50000 ppb too long */
+    EXPECT_NEAR(-50000, app_timestampData.driftPpb, 500);
+    EXPECT_EQ(0U, app_timestampData.stepCount);
+
+    /* and the wall time follows the RTC, not TC0 */
+    EXPECT_LT(llabs(TimestampWallUs() - RtcWallUs()), 1000);
+
+    /* between resyncs, uncorrected, TC0 would be 30 ms off */
+    HOST_Run(Tasks, HOST_TimeGet() + kResyncNs - (10U * HOST_NS_PER_S), kPassNs);
+    EXPECT_LT(llabs(TimestampWallUs() - RtcWallUs()), 1000);
+}
+
+TEST_F(AppTimestampTest, StepsWhenTheRtcIsSet)
+{
+    struct tm now;
+
+    APP_TIMESTAMP_Initialize();
+    HOST_Run(Tasks, kResyncNs + (5U * HOST_NS_PER_S), kPassNs);
+    ASSERT_EQ(0U, app_timestampData.stepCount);
+
+    RTC_RTCCTimeGet(&now);
+    now.tm_hour += 1;
+    RTC_RTCCTimeSet(&now);
+
+    HOST_Run(Tasks, HOST_TimeGet() + kResyncNs, kPassNs);
+
+    EXPECT_EQ(1U, app_timestampData.stepCount);
+    EXPECT_LT(llabs(TimestampWallUs() - RtcWallUs()), 1000);
+}
+
+TEST_F(AppTimestampTest, TimeToSecondsIsTheInverseOfGmtime)
+{
+    /* every day from 1970 to 2106, where the seconds no longer fit in the
+     * 32 bits of a flash log record, at a time that moves through the day */
+    for (time_t seconds = 0; seconds < (time_t)UINT32_MAX; seconds += 86400 + 3607)
+    {
+        struct tm wall;
+
+        (void) gmtime_r(&seconds, &wall);
+        ASSERT_EQ((int64_t)seconds, APP_TIMESTAMP_TimeToSeconds(&wall)) << asctime(&wall);
+    }
+}
+
+}
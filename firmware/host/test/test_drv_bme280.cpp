@@ -0,0 +1,343 @@
+/*******************************************************************************
+  BME280 Driver Host Tests
+
+  File Name:
+    test_drv_bme280.cpp
+
+  Summary:
+    Runs drv_bme280.c against the simulated sensor on the SERCOM3 bus.
+
+  Description:
+    The driver is built unchanged and reaches the sensor through the PLIB
+    interface table of initialization.c, as on the board: SERCOM3, modeled
+    by plib_sercom3_i2c_master_sim.c, carries each transaction to the sensor
+    of drv_bme280_sim.c, whose completions are timed by SYS_TIME on TC0.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "definitions.h"
+#include "driver/bme280/drv_bme280_sim.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" const DRV_BME280_INIT gDrvBME280InitObj[1];
+
+namespace
+{
+
+SYS_MODULE_OBJ bme280Object;
+uint32_t completions;
+DRV_BME280_TRANSFER_STATUS lastStatus;
+uint64_t lastTime;
+
+void Bme280Tasks( void )
+{
+    DRV_BME280_Tasks(bme280Object);
+}
+
+void Bme280Event( DRV_BME280_TRANSFER_STATUS status, uintptr_t context )
+{
+    (void) context;
+    completions++;
+    lastStatus = status;
+    lastTime = HOST_TimeGet();
+}
+
+/* Brings up what the driver needs, in the order of SYS_Initialize. Each test
+ * runs in its own process, so this is the first initialization. */
+class DrvBme280Test : public ::testing::Test
+{
+protected:
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+
+    void SetUp() override
+    {
+        HOST_Reset();
+        completions = 0U;
+
+        TC0_TimerInitialize();
+        SERCOM3_I2C_Initialize();
+        (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+        bme280Object = DRV_BME280_Initialize(DRV_BME280_INSTANCE_0, (SYS_MODULE_INIT*)&gDrvBME280InitObj[0]);
+        DRV_BME280_SIM_Initialize(DRV_BME280_I2C_ADDRESS, NULL);
+        DRV_BME280_SIM_ScriptSet(NULL, 0U, false);
+        DRV_BME280_SIM_FaultSet(DRV_BME280_SIM_FAULT_NACK, 0U, 0U);
+        NVIC_Initialize();
+    }
+
+    /* Runs the driver until it is idle, as SYS_Tasks would */
+    void RunUntilReady( uint64_t timeoutNs )
+    {
+        uint64_t until = HOST_TimeGet() + timeoutNs;
+
+        while ((DRV_BME280_Status(DRV_BME280_INSTANCE_0) != SYS_STATUS_READY) && (HOST_TimeGet() < until))
+        {
+            HOST_Run(Bme280Tasks, HOST_TimeGet() + (100U * HOST_NS_PER_US), 10U * HOST_NS_PER_US);
+        }
+    }
+
+    void OpenClient()
+    {
+        RunUntilReady(100U * HOST_NS_PER_MS);
+        ASSERT_EQ(SYS_STATUS_READY, DRV_BME280_Status(DRV_BME280_INSTANCE_0));
+
+        handle = DRV_BME280_Open(DRV_BME280_INSTANCE_0, DRV_IO_INTENT_READWRITE);
+        ASSERT_NE(DRV_HANDLE_INVALID, handle);
+        DRV_BME280_ClientEventHandlerSet(handle, Bme280Event, 0U);
+    }
+};
+
+TEST_F(DrvBme280Test, InitializesThroughSercom3)
+{
+    SERCOM_I2C_STATISTICS sercom;
+    DRV_BME280_STATISTICS stats;
+
+    RunUntilReady(100U * HOST_NS_PER_MS);
+
+    EXPECT_EQ(SYS_STATUS_READY, DRV_BME280_Status(DRV_BME280_INSTANCE_0));
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+    SERCOM3_I2C_StatisticsGet(&sercom);
+
+    /* reset, ID, three calibration reads and the configuration writes */
+    EXPECT_GE(stats.transactionCount, 6U);
+    EXPECT_EQ(stats.transactionCount, stats.doneCount);
+    EXPECT_EQ(0U, stats.nackCount);
+    EXPECT_EQ(stats.transactionCount, sercom.transferCount);
+    EXPECT_EQ(stats.doneCount, sercom.doneCount);
+    EXPECT_EQ(stats.writeBytes, sercom.writeBytes);
+    EXPECT_EQ(stats.readBytes, sercom.readBytes);
+}
+
+TEST_F(DrvBme280Test, ReadsTheScriptedEnvironment)
+{
+    int32_t temperature = 0;
+    uint32_t pressure = 0U;
+    uint32_t humidity = 0U;
+    uint64_t timestamp = 0U;
+
+    OpenClient();
+
+    /* the first conversion of normal mode ends within 10 ms */
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (50U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+
+    ASSERT_EQ(1U, completions);
+    EXPECT_EQ(DRV_BME280_TRANSFER_STATUS_COMPLETED, lastStatus);
+
+    ASSERT_TRUE(DRV_BME280_Get_Temperature(handle, &temperature));
+    ASSERT_TRUE(DRV_BME280_Get_Pressure(handle, &pressure));
+    ASSERT_TRUE(DRV_BME280_Get_Humidity(handle, &humidity));
+    ASSERT_TRUE(DRV_BME280_Get_Timestamp(handle, &timestamp));
+
+    /* default environment: 25 degC, 101325 Pa, 50 %RH */
+    EXPECT_NEAR(2500, temperature, 2);
+    EXPECT_NEAR(101325.0, (double)pressure, 3.0);
+    EXPECT_NEAR(50.0 * 1024.0, (double)humidity, 0.2 * 1024.0);
+    EXPECT_GT(timestamp, 0U);
+}
+
+TEST_F(DrvBme280Test, CountsANackOnTheBus)
+{
+    DRV_BME280_STATISTICS stats;
+    SERCOM_I2C_STATISTICS sercom;
+
+    OpenClient();
+    DRV_BME280_SIM_FaultSet(DRV_BME280_SIM_FAULT_NACK, 0U, 1U);
+
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+    SERCOM3_I2C_StatisticsGet(&sercom);
+
+    EXPECT_EQ(1U, completions);
+    EXPECT_EQ(DRV_BME280_TRANSFER_STATUS_ERROR, lastStatus);
+    EXPECT_EQ(1U, stats.nackCount);
+    EXPECT_EQ(1U, sercom.nakCount);
+
+    /* the failed read leaves the driver ready for the next one */
+    EXPECT_EQ(SYS_STATUS_READY, DRV_BME280_Status(DRV_BME280_INSTANCE_0));
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+
+    EXPECT_EQ(2U, completions);
+    EXPECT_EQ(DRV_BME280_TRANSFER_STATUS_COMPLETED, lastStatus);
+}
+
+
+TEST_F(DrvBme280Test, FollowsTheScriptedEnvironment)
+{
+    static const DRV_BME280_SIM_POINT ramp[] =
+    {
+        { 0U, 2000, 100000U, 40U * 1024U },
+        { 1000U, 3000, 102000U, 60U * 1024U },
+    };
+    int32_t temperature = 0;
+    uint32_t pressure = 0U;
+    uint32_t humidity = 0U;
+
+    OpenClient();
+    DRV_BME280_SIM_ScriptSet(ramp, sizeof(ramp) / sizeof(ramp[0]), false);
+
+    /* halfway up the ramp; the sample read was latched by the last
+     * conversion, under 10 ms before */
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (500U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+    ASSERT_EQ(1U, completions);
+
+    ASSERT_TRUE(DRV_BME280_Get_Temperature(handle, &temperature));
+    ASSERT_TRUE(DRV_BME280_Get_Pressure(handle, &pressure));
+    ASSERT_TRUE(DRV_BME280_Get_Humidity(handle, &humidity));
+
+    EXPECT_NEAR(2500, temperature, 15);
+    EXPECT_NEAR(101000.0, (double)pressure, 30.0);
+    EXPECT_NEAR(50.0 * 1024.0, (double)humidity, 0.3 * 1024.0);
+
+    /* and held after the last point */
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + HOST_NS_PER_S, 10U * HOST_NS_PER_US);
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+    ASSERT_EQ(2U, completions);
+
+    ASSERT_TRUE(DRV_BME280_Get_Temperature(handle, &temperature));
+    EXPECT_NEAR(3000, temperature, 2);
+}
+
+TEST_F(DrvBme280Test, TakesTheBusTimeOfTheDataRead)
+{
+    DRV_BME280_SIM_STATISTICS before;
+    DRV_BME280_SIM_STATISTICS after;
+    uint64_t start;
+
+    /* a write of the register and a read of 8 bytes: 11 bytes of 9 bits,
+     * START, repeated START and STOP, at 400 kHz */
+    const uint64_t busUs = ((11U * 9U) + 3U) * 1000000U / 400000U;
+
+    OpenClient();
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (50U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+    DRV_BME280_SIM_StatisticsGet(&before);
+
+    start = HOST_TimeGet();
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, start + (10U * HOST_NS_PER_MS), HOST_NS_PER_US);
+    ASSERT_EQ(1U, completions);
+
+    DRV_BME280_SIM_StatisticsGet(&after);
+
+    EXPECT_EQ(1U, after.transactions - before.transactions);
+    EXPECT_EQ(11U, after.bytes - before.bytes);
+    EXPECT_EQ(busUs, (uint64_t)(after.busTimeUs - before.busTimeUs));
+
+    /* the client hears of the sample once the bus is done with it, and
+     * the driver has compensated it on its next task. SYS_TIME times the
+     * end of the transfer in whole counts of TC0, rounding down. */
+    EXPECT_GE(lastTime - start, (busUs * HOST_NS_PER_US) - (HOST_NS_PER_S / TC0_TimerFrequencyGet()));
+    EXPECT_LT(lastTime - start, (busUs + 50U) * HOST_NS_PER_US);
+}
+
+TEST_F(DrvBme280Test, TimesATransferFromItsStartWhenAnotherIsRefused)
+{
+    DRV_BME280_STATISTICS before;
+    DRV_BME280_STATISTICS after;
+
+    /* the data read of TakesTheBusTimeOfTheDataRead */
+    const uint64_t busCycles = (((11U * 9U) + 3U) * (uint64_t)CPU_CLOCK_FREQUENCY) / 400000U;
+    const uint64_t byteCycles = (9U * (uint64_t)CPU_CLOCK_FREQUENCY) / 400000U;
+
+    OpenClient();
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (50U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &before));
+
+    /* a second read while the first is on the bus is refused */
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_TimeAdvance(200U * HOST_NS_PER_US);
+    ASSERT_FALSE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), HOST_NS_PER_US);
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &after));
+
+    EXPECT_EQ(1U, after.transactionCount - before.transactionCount);
+    EXPECT_EQ(1U, after.refusedCount - before.refusedCount);
+    EXPECT_EQ(1U, after.doneCount - before.doneCount);
+
+    /* the latency is that of the read on the bus, from its own start: the
+     * PLIB calls back before the STOP, within a byte of the end */
+    EXPECT_GE(after.totalCycles - before.totalCycles, busCycles - byteCycles);
+    EXPECT_LE(after.totalCycles - before.totalCycles, busCycles);
+}
+
+TEST_F(DrvBme280Test, RefusedReadLeavesTheInitializationAlone)
+{
+    DRV_BME280_STATISTICS stats;
+    int32_t temperature = 0;
+    uint32_t pressure = 0U;
+    uint32_t humidity = 0U;
+
+    /* a client can open the driver between the transfers of the
+     * initialization */
+    handle = DRV_BME280_Open(DRV_BME280_INSTANCE_0, DRV_IO_INTENT_READWRITE);
+    ASSERT_NE(DRV_HANDLE_INVALID, handle);
+    DRV_BME280_ClientEventHandlerSet(handle, Bme280Event, 0U);
+
+    /* run until the temperature calibration read, after the reset and the
+     * ID read, is on the bus */
+    do
+    {
+        HOST_Run(Bme280Tasks, HOST_TimeGet() + HOST_NS_PER_US, HOST_NS_PER_US);
+        ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+        ASSERT_LT(HOST_TimeGet(), 100U * HOST_NS_PER_MS);
+    } while ((stats.transactionCount < 3U) || (SERCOM3_I2C_IsBusy() == false));
+
+    EXPECT_FALSE(DRV_BME280_Read(handle));
+
+    RunUntilReady(100U * HOST_NS_PER_MS);
+    ASSERT_EQ(SYS_STATUS_READY, DRV_BME280_Status(DRV_BME280_INSTANCE_0));
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+
+    EXPECT_EQ(0U, completions);
+    EXPECT_EQ(1U, stats.refusedCount);
+    EXPECT_EQ(stats.transactionCount, stats.doneCount);
+
+    /* the sample is compensated with the whole calibration */
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (50U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+
+    ASSERT_EQ(1U, completions);
+    ASSERT_TRUE(DRV_BME280_Get_Temperature(handle, &temperature));
+    ASSERT_TRUE(DRV_BME280_Get_Pressure(handle, &pressure));
+    ASSERT_TRUE(DRV_BME280_Get_Humidity(handle, &humidity));
+    EXPECT_NEAR(2500, temperature, 2);
+    EXPECT_NEAR(101325.0, (double)pressure, 3.0);
+    EXPECT_NEAR(50.0 * 1024.0, (double)humidity, 0.2 * 1024.0);
+}
+
+TEST_F(DrvBme280Test, CountsABusErrorOnTheBus)
+{
+    DRV_BME280_STATISTICS stats;
+    DRV_BME280_SIM_STATISTICS sim;
+
+    OpenClient();
+    DRV_BME280_SIM_FaultSet(DRV_BME280_SIM_FAULT_BUS, 0U, 1U);
+
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    HOST_Run(Bme280Tasks, HOST_TimeGet() + (10U * HOST_NS_PER_MS), 10U * HOST_NS_PER_US);
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+    DRV_BME280_SIM_StatisticsGet(&sim);
+
+    EXPECT_EQ(1U, completions);
+    EXPECT_EQ(DRV_BME280_TRANSFER_STATUS_ERROR, lastStatus);
+    EXPECT_EQ(SYS_STATUS_READY, DRV_BME280_Status(DRV_BME280_INSTANCE_0));
+    EXPECT_EQ(1U, stats.busErrorCount);
+    EXPECT_EQ(0U, stats.nackCount);
+    EXPECT_EQ(1U, sim.busErrors);
+}
+
+}
@@ -0,0 +1,254 @@
+/*******************************************************************************
+  BME280 Compensation Host Tests
+
+  File Name:
+    test_drv_bme280_compensate.cpp
+
+  Summary:
+    Checks the integer compensation of drv_bme280_compensate.c against the
+    floating point formulas of the BME280 datasheet.
+
+  Description:
+    The raw readings sweep the ranges of the sensor with four calibrations:
+    that of the compensation example of the BMP280 datasheet, section 3.12,
+    which the BME280 shares for temperature and pressure and the simulator
+    models, then three read from other parts. The references are the double
+    precision formulas of the BME280 datasheet, section 8.1, fed with the
+    t_fine of the integer temperature as the datasheet does. Every result
+    is checked against its reference; the bounds are the largest errors
+    measured over the sweeps, rounded up.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+#include "definitions.h"
+
+namespace
+{
+
+/* Points of a sweep over a raw range, both ends included */
+constexpr uint32_t kPoints = 257U;
+
+/* Raw temperatures of about -40, -15, 25, 65 and 85 degC */
+const uint32_t temperatures[] = { 0x4E000U, 0x60000U, 0x7EED0U, 0xA0000U, 0xB0000U };
+
+const DRV_BME280_COMPENSATION_DATA datasheet =
+{
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+    75, 362, 0, 313, 50, 30, 0
+};
+
+const DRV_BME280_COMPENSATION_DATA calibrations[] =
+{
+    datasheet,
+    { 28485, 26735, 50, 39148, -10489, 3024, 8616, -140, -7, 15500, -14600, 6000,
+      75, 352, 0, 338, 0, 30, 0 },
+    { 27836, 26483, 50, 37832, -10478, 3024, 5957, -40, -7, 9900, -10230, 4285,
+      75, 367, 0, 300, 50, 30, 0 },
+    { 28170, 26601, 50, 36873, -10599, 3024, 6850, 9, -7, 9900, -10230, 4285,
+      75, 359, 0, 321, 25, 30, 0 },
+};
+
+/* Temperature in degC */
+double ReferenceT( uint32_t adc, const DRV_BME280_COMPENSATION_DATA& calib )
+{
+    double var1 = (((double)adc / 16384.0) - ((double)calib.dig_T1 / 1024.0)) * (double)calib.dig_T2;
+    double var2 = ((double)adc / 131072.0) - ((double)calib.dig_T1 / 8192.0);
+
+    var2 = var2 * var2 * (double)calib.dig_T3;
+
+    return fmin(fmax((var1 + var2) / 5120.0, -40.0), 85.0);
+}
+
+/* Pressure in Pa, clamped as the driver does */
+double ReferenceP( uint32_t adc, const DRV_BME280_COMPENSATION_DATA& calib )
+{
+    double var1 = ((double)calib.t_fine / 2.0) - 64000.0;
+    double var2 = var1 * var1 * (double)calib.dig_P6 / 32768.0;
+    double pressure;
+
+    var2 = var2 + (var1 * (double)calib.dig_P5 * 2.0);
+    var2 = (var2 / 4.0) + ((double)calib.dig_P4 * 65536.0);
+    var1 = (((double)calib.dig_P3 * var1 * var1 / 524288.0) + ((double)calib.dig_P2 * var1)) / 524288.0;
+    var1 = (1.0 + (var1 / 32768.0)) * (double)calib.dig_P1;
+
+    pressure = 1048576.0 - (double)adc;
+    pressure = (pressure - (var2 / 4096.0)) * 6250.0 / var1;
+    var1 = (double)calib.dig_P9 * pressure * pressure / 2147483648.0;
+    var2 = pressure * (double)calib.dig_P8 / 32768.0;
+    pressure = pressure + ((var1 + var2 + (double)calib.dig_P7) / 16.0);
+
+    return fmin(fmax(pressure, 30000.0), 110000.0);
+}
+
+/* Relative humidity in %RH, clamped as the driver does */
+double ReferenceH( uint32_t adc, const DRV_BME280_COMPENSATION_DATA& calib )
+{
+    double var1 = (double)calib.t_fine - 76800.0;
+    double humidity;
+
+    humidity = ((double)adc - (((double)calib.dig_H4 * 64.0) + ((double)calib.dig_H5 / 16384.0 * var1))) *
+               ((double)calib.dig_H2 / 65536.0 *
+                (1.0 + ((double)calib.dig_H6 / 67108864.0 * var1 * (1.0 + ((double)calib.dig_H3 / 67108864.0 * var1)))));
+    humidity = humidity * (1.0 - ((double)calib.dig_H1 * humidity / 524288.0));
+
+    return fmin(fmax(humidity, 0.0), 100.0);
+}
+
+/* Largest differences from the references over the sweeps of every
+ * calibration: the temperature over its raw range, the pressure and the
+ * humidity over theirs at each of the temperatures. In degC, Pa and %RH. */
+struct Errors
+{
+    double t;
+    double p32;
+    double p64;
+    double h;
+};
+
+Errors Sweep( void )
+{
+    DRV_BME280_UNCOMP_DATA uncomp = {};
+    Errors errors = {};
+
+    for (const DRV_BME280_COMPENSATION_DATA& calibSet : calibrations)
+    {
+        DRV_BME280_COMPENSATION_DATA calib = calibSet;
+
+        for (uint32_t i = 0U; i < kPoints; i++)
+        {
+            uncomp.temperature = (i * 0xFFFFFU) / (kPoints - 1U);
+
+            double t = (double)_DRV_BME280_Compensate_T(&uncomp, &calib) / 100.0;
+
+            errors.t = fmax(errors.t, fabs(t - ReferenceT(uncomp.temperature, calib)));
+        }
+
+        for (uint32_t temperature : temperatures)
+        {
+            uncomp.temperature = temperature;
+            (void) _DRV_BME280_Compensate_T(&uncomp, &calib);
+
+            for (uint32_t i = 0U; i < kPoints; i++)
+            {
+                uncomp.pressure = (i * 0xFFFFFU) / (kPoints - 1U);
+                uncomp.humidity = (i * 0xFFFFU) / (kPoints - 1U);
+
+                double reference = ReferenceP(uncomp.pressure, calib);
+                double p32 = (double)_DRV_BME280_Compensate_P(&uncomp, &calib);
+                double p64 = (double)_DRV_BME280_Compensate_P64(&uncomp, &calib) / 256.0;
+                double h = (double)_DRV_BME280_Compensate_H(&uncomp, &calib) / 1024.0;
+
+                errors.p32 = fmax(errors.p32, fabs(p32 - reference));
+                errors.p64 = fmax(errors.p64, fabs(p64 - reference));
+                errors.h = fmax(errors.h, fabs(h - ReferenceH(uncomp.humidity, calib)));
+            }
+        }
+    }
+
+    return errors;
+}
+
+TEST(DrvBme280Compensate, MatchesTheDatasheetExample)
+{
+    DRV_BME280_COMPENSATION_DATA calib = datasheet;
+    DRV_BME280_UNCOMP_DATA uncomp = {};
+
+    /* The table of the example, computed with arithmetic shifts. The driver
+     * divides, as the BME280 API of Bosch does, which truncates the negative
+     * var2 of t_fine towards zero: one more in t_fine, and 4/256 Pa more in
+     * the pressure that follows from it. */
+    uncomp.temperature = 519888U;
+    uncomp.pressure = 415148U;
+
+    EXPECT_EQ(2508, _DRV_BME280_Compensate_T(&uncomp, &calib));
+    EXPECT_EQ(128422 + 1, calib.t_fine);
+    EXPECT_EQ(100653U + 1U, _DRV_BME280_Compensate_P(&uncomp, &calib));
+    EXPECT_EQ(25767236U + 4U, _DRV_BME280_Compensate_P64(&uncomp, &calib));
+}
+
+TEST(DrvBme280Compensate, TemperatureMatchesTheFormulas)
+{
+    Errors errors = Sweep();
+
+    RecordProperty("t_max_error_mdegC", (int)(errors.t * 1000.0));
+
+    /* a step of 0.01 degC, and the truncating divisions of t_fine: 0.013
+     * degC at most */
+    EXPECT_LE(errors.t, 0.015);
+}
+
+TEST(DrvBme280Compensate, Pressure32IsWithinItsResolution)
+{
+    Errors errors = Sweep();
+
+    RecordProperty("p32_max_error_mPa", (int)(errors.p32 * 1000.0));
+
+    /* the 32-bit algorithm drops the low bits of its intermediate terms:
+     * 5.9 Pa at most, below 0 degC */
+    EXPECT_LE(errors.p32, 6.0);
+}
+
+TEST(DrvBme280Compensate, Pressure64IsWithinItsResolution)
+{
+    Errors errors = Sweep();
+
+    RecordProperty("p64_max_error_mPa", (int)(errors.p64 * 1000.0));
+
+    /* the result is truncated to a 1/256 Pa step, and the truncating
+     * divisions of its terms add about one more: 2.06/256 Pa at most */
+    EXPECT_LE(errors.p64, 2.5 / 256.0);
+}
+
+TEST(DrvBme280Compensate, HumidityMatchesTheFormulas)
+{
+    Errors errors = Sweep();
+
+    RecordProperty("h_max_error_mpercent", (int)(errors.h * 1000.0));
+
+    /* the shifts of its intermediate terms drop more than the 1/1024 %RH
+     * step of the result: 6.4/1024 %RH at most */
+    EXPECT_LE(errors.h, 7.0 / 1024.0);
+}
+
+TEST(DrvBme280Compensate, ClampsPressureToTheRangeOfTheSensor)
+{
+    DRV_BME280_COMPENSATION_DATA calib = datasheet;
+    DRV_BME280_UNCOMP_DATA uncomp = {};
+
+    uncomp.temperature = 519888U;
+    (void) _DRV_BME280_Compensate_T(&uncomp, &calib);
+
+    /* a raw pressure past the low end must not wrap to the high one */
+    uncomp.pressure = 0xFFFFFU;
+    EXPECT_EQ(30000U, _DRV_BME280_Compensate_P(&uncomp, &calib));
+    EXPECT_EQ(30000U * 256U, _DRV_BME280_Compensate_P64(&uncomp, &calib));
+
+    uncomp.pressure = 0U;
+    EXPECT_EQ(110000U, _DRV_BME280_Compensate_P(&uncomp, &calib));
+    EXPECT_EQ(110000U * 256U, _DRV_BME280_Compensate_P64(&uncomp, &calib));
+}
+
+TEST(DrvBme280Compensate, Pressure64ResolvesOneAdcStep)
+{
+    DRV_BME280_COMPENSATION_DATA calib = datasheet;
+    DRV_BME280_UNCOMP_DATA uncomp = {};
+    uint32_t first;
+    uint32_t second;
+
+    uncomp.temperature = 519888U;
+    (void) _DRV_BME280_Compensate_T(&uncomp, &calib);
+
+    /* one step of the 20-bit ADC is 0.17 Pa at this pressure, under the
+     * 1 Pa step of the 32-bit algorithm */
+    uncomp.pressure = 415148U;
+    first = _DRV_BME280_Compensate_P64(&uncomp, &calib);
+    uncomp.pressure = 415147U;
+    second = _DRV_BME280_Compensate_P64(&uncomp, &calib);
+
+    EXPECT_GT(second, first);
+    EXPECT_LT(second - first, 256U);
+}
+
+}
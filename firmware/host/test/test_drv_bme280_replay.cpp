@@ -0,0 +1,189 @@
+/*******************************************************************************
+  BME280 Trace Replay Host Tests
+
+  File Name:
+    test_drv_bme280_replay.cpp
+
+  Summary:
+    Runs drv_bme280.c on a recording served by drv_bme280_replay.c.
+
+  Description:
+    The driver is built unchanged and initialized with the replay routines in
+    its PLIB interface table, as initialization.c does when DRV_BME280_REPLAY
+    is 1. The recording holds the calibration and the raw readings of the
+    compensation example of the Bosch BMP280 datasheet, section 3.12, with a
+    humidity calibration of a BME280, so the compensated values can be
+    checked against the datasheet's.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "definitions.h"
+#include "driver/bme280/drv_bme280_replay.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" const DRV_BME280_INIT gDrvBME280InitObj[1];
+
+namespace
+{
+
+const DRV_BME280_PLIB_INTERFACE replayInterface =
+{
+    .writeRead = (DRV_BME280_PLIB_WRITE_READ) DRV_BME280_REPLAY_I2C_WriteRead,
+    .write = (DRV_BME280_PLIB_WRITE) DRV_BME280_REPLAY_I2C_Write,
+    .read = (DRV_BME280_PLIB_READ) DRV_BME280_REPLAY_I2C_Read,
+    .errorGet = (DRV_BME280_PLIB_ERROR_GET) DRV_BME280_REPLAY_I2C_ErrorGet,
+    .callbackRegister = (DRV_BME280_PLIB_CALLBACK_REGISTER) DRV_BME280_REPLAY_I2C_CallbackRegister,
+    .transferSetup = (DRV_BME280_PLIB_TRANSFER_SETUP) DRV_BME280_REPLAY_I2C_TransferSetup,
+};
+
+/* dig_T1..T3 = 27504, 26435, -1000; dig_P1..P9 = 36477, -10685, 3024, 2855,
+ * 140, -7, 15500, -14600, 6000; dig_H1..H6 = 75, 362, 0, 313, 50, 30.
+ * The readings are adc_T = 519888 and adc_P = 415148, then adc_H = 30000 and
+ * 25000. */
+const DRV_BME280_REPLAY_RECORD recording[] =
+{
+    { 10U, 0x88U, 6U, { 0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC } },
+    { 20U, 0x8EU, 18U, { 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B, 0x8C, 0x00,
+                         0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17 } },
+    { 30U, 0xA1U, 1U, { 0x4B } },
+    { 40U, 0xE1U, 7U, { 0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E } },
+    { 1000U, 0xF7U, 8U, { 0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x75, 0x30 } },
+    { 2000U, 0xF7U, 8U, { 0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00, 0x61, 0xA8 } },
+};
+
+constexpr size_t kRecords = sizeof(recording) / sizeof(recording[0]);
+
+SYS_MODULE_OBJ bme280Object;
+uint32_t completions;
+uint32_t failures;
+
+void Bme280Tasks( void )
+{
+    DRV_BME280_REPLAY_Tasks();
+    DRV_BME280_Tasks(bme280Object);
+}
+
+void Bme280Event( DRV_BME280_TRANSFER_STATUS status, uintptr_t context )
+{
+    (void) context;
+
+    if (status == DRV_BME280_TRANSFER_STATUS_COMPLETED)
+    {
+        completions++;
+    }
+    else
+    {
+        failures++;
+    }
+}
+
+/* Each test runs in its own process, so this is the first initialization */
+class DrvBme280ReplayTest : public ::testing::Test
+{
+protected:
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+
+    void SetUp() override
+    {
+        DRV_BME280_INIT init = gDrvBME280InitObj[0];
+
+        HOST_Reset();
+        completions = 0U;
+        failures = 0U;
+
+        TC0_TimerInitialize();
+        (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+        init.plibInterface = &replayInterface;
+        bme280Object = DRV_BME280_Initialize(DRV_BME280_INSTANCE_0, (SYS_MODULE_INIT*)&init);
+        DRV_BME280_REPLAY_RecordsSet(recording, kRecords);
+        NVIC_Initialize();
+    }
+
+    void RunPasses( uint32_t passes )
+    {
+        HOST_Run(Bme280Tasks, HOST_TimeGet() + ((uint64_t)passes * HOST_NS_PER_US), HOST_NS_PER_US);
+    }
+
+    void OpenClient()
+    {
+        /* reset, ID, four calibration reads and two writes, a pass each
+         * to start and to complete */
+        RunPasses(100U);
+        ASSERT_EQ(SYS_STATUS_READY, DRV_BME280_Status(DRV_BME280_INSTANCE_0));
+
+        handle = DRV_BME280_Open(DRV_BME280_INSTANCE_0, DRV_IO_INTENT_READWRITE);
+        ASSERT_NE(DRV_HANDLE_INVALID, handle);
+        DRV_BME280_ClientEventHandlerSet(handle, Bme280Event, 0U);
+    }
+};
+
+TEST_F(DrvBme280ReplayTest, CompensatesTheDatasheetExample)
+{
+    int32_t temperature = 0;
+    uint32_t pressure = 0U;
+    uint32_t humidity = 0U;
+
+    OpenClient();
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    RunPasses(10U);
+
+    ASSERT_EQ(1U, completions);
+    ASSERT_TRUE(DRV_BME280_Get_Temperature(handle, &temperature));
+    ASSERT_TRUE(DRV_BME280_Get_Pressure(handle, &pressure));
+    ASSERT_TRUE(DRV_BME280_Get_Humidity(handle, &humidity));
+
+    /* the datasheet gives 25.08 degC and 100653.27 Pa; the 32-bit
+     * algorithm resolves 1 Pa */
+    EXPECT_EQ(2508, temperature);
+    EXPECT_NEAR(100653.27, (double)pressure, 1.0);
+
+    /* the floating point formula of the BME280 datasheet, section 8.1,
+     * gives 55.00 %RH for this calibration */
+    EXPECT_NEAR(55.00 * 1024.0, (double)humidity, 0.01 * 1024.0);
+}
+
+TEST_F(DrvBme280ReplayTest, ServesTheReadingsInOrder)
+{
+    uint32_t first = 0U;
+    uint32_t second = 0U;
+
+    OpenClient();
+    EXPECT_FALSE(DRV_BME280_REPLAY_IsComplete());
+
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    RunPasses(10U);
+    ASSERT_TRUE(DRV_BME280_Get_Humidity(handle, &first));
+    EXPECT_FALSE(DRV_BME280_REPLAY_IsComplete());
+
+    ASSERT_TRUE(DRV_BME280_Read(handle));
+    RunPasses(10U);
+    ASSERT_TRUE(DRV_BME280_Get_Humidity(handle, &second));
+
+    EXPECT_EQ(2U, completions);
+    EXPECT_TRUE(DRV_BME280_REPLAY_IsComplete());
+    EXPECT_LT(second, first);
+}
+
+TEST_F(DrvBme280ReplayTest, DoesNotAcknowledgeReadsPastTheEnd)
+{
+    DRV_BME280_STATISTICS stats;
+
+    OpenClient();
+
+    for (size_t i = 0U; i < 3U; i++)
+    {
+        ASSERT_TRUE(DRV_BME280_Read(handle));
+        RunPasses(10U);
+    }
+
+    ASSERT_TRUE(DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats));
+
+    EXPECT_EQ(2U, completions);
+    EXPECT_EQ(1U, failures);
+    EXPECT_EQ(1U, stats.nackCount);
+}
+
+}
@@ -0,0 +1,470 @@
+/*******************************************************************************
+  RAM Disk Driver Host Tests
+
+  File Name:
+    test_drv_ramdisk.cpp
+
+  Summary:
+    Mounts a FAT volume on drv_ramdisk.c, injects media faults and counts
+    the FAT accesses of a log file.
+
+  Description:
+    The RAM disk registers with the media manager as /dev/rama1, so SYS_FS
+    and FatFs run on it unchanged. Its latency is timed by SYS_TIME on TC0,
+    which lets virtual time pass while FatFs waits for each request.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "driver/ramdisk/drv_ramdisk.h"
+#include "driver/ramdisk/src/drv_ramdisk_local.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C" const SYS_TIME_INIT sysTimeInitData;
+extern "C" const SYS_FS_REGISTRATION_TABLE sysFSInit[SYS_FS_MAX_FILE_SYSTEM_TYPE];
+
+namespace
+{
+
+constexpr uint32_t kBlocks = 256U;
+constexpr uint32_t kReadLatencyUs = 200U;
+constexpr uint32_t kWriteLatencyUs = 1000U;
+constexpr const char* kDevice = "/dev/rama1";
+constexpr const char* kMount = "/mnt/ram";
+
+uint8_t disk[kBlocks * DRV_RAMDISK_BLOCK_SIZE];
+DRV_RAMDISK_CLIENT_OBJ clients[2];
+DRV_RAMDISK_BUFFER_OBJ buffers[4];
+SYS_MODULE_OBJ ramdiskObject;
+
+const DRV_RAMDISK_INIT ramdiskInit =
+{
+    .storage = disk,
+    .store = NULL,
+    .numBlocks = kBlocks,
+    .clientObjPool = (uintptr_t)&clients[0],
+    .numClients = 2,
+    .bufferObjPool = (uintptr_t)&buffers[0],
+    .bufferObjPoolSize = 4,
+    .readLatencyUs = kReadLatencyUs,
+    .writeLatencyUs = kWriteLatencyUs,
+    .isFsEnabled = true,
+};
+
+/* Block range of the FATs, once the volume is formatted, and the accesses
+ * to it through the backing store */
+uint32_t fatStart;
+uint32_t fatEnd;
+uint32_t fatAccesses;
+
+void FatCount( uint32_t blockStart, uint32_t nBlock )
+{
+    for (uint32_t block = blockStart; block < (blockStart + nBlock); block++)
+    {
+        if ((block >= fatStart) && (block < fatEnd))
+        {
+            fatAccesses++;
+        }
+    }
+}
+
+bool StoreRead( uintptr_t context, uint8_t* buffer, uint32_t blockStart, uint32_t nBlock )
+{
+    (void) context;
+    FatCount(blockStart, nBlock);
+    (void) memcpy(buffer, &disk[blockStart * DRV_RAMDISK_BLOCK_SIZE], nBlock * DRV_RAMDISK_BLOCK_SIZE);
+    return true;
+}
+
+bool StoreWrite( uintptr_t context, const uint8_t* buffer, uint32_t blockStart, uint32_t nBlock )
+{
+    (void) context;
+    FatCount(blockStart, nBlock);
+    (void) memcpy(&disk[blockStart * DRV_RAMDISK_BLOCK_SIZE], buffer, nBlock * DRV_RAMDISK_BLOCK_SIZE);
+    return true;
+}
+
+const DRV_RAMDISK_STORE_INTERFACE countingStore =
+{
+    .read = StoreRead,
+    .write = StoreWrite,
+    .context = 0U,
+};
+
+const DRV_RAMDISK_INIT countingInit =
+{
+    .storage = NULL,
+    .store = &countingStore,
+    .numBlocks = kBlocks,
+    .clientObjPool = (uintptr_t)&clients[0],
+    .numClients = 2,
+    .bufferObjPool = (uintptr_t)&buffers[0],
+    .bufferObjPoolSize = 4,
+    .readLatencyUs = kReadLatencyUs,
+    .writeLatencyUs = kWriteLatencyUs,
+    .isFsEnabled = true,
+};
+
+uint32_t events;
+SYS_MEDIA_BLOCK_EVENT lastEvent;
+
+void Tasks( void )
+{
+    SYS_FS_Tasks();
+    DRV_RAMDISK_Tasks(ramdiskObject);
+}
+
+void RamdiskEvent( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    (void) commandHandle;
+    (void) context;
+    events++;
+    lastEvent = event;
+}
+
+/* Each test runs in its own process, on a disk that starts erased */
+class DrvRamdiskTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        SetUpWith(&ramdiskInit);
+    }
+
+    void SetUpWith( const DRV_RAMDISK_INIT* init )
+    {
+        HOST_Reset();
+        (void) memset(disk, 0, sizeof(disk));
+        events = 0U;
+
+        TC0_TimerInitialize();
+        (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+        ramdiskObject = DRV_RAMDISK_Initialize(DRV_RAMDISK_INDEX_0, (SYS_MODULE_INIT*)init);
+        ASSERT_NE(SYS_MODULE_OBJ_INVALID, ramdiskObject);
+        (void) SYS_FS_Initialize((const void*)sysFSInit);
+        NVIC_Initialize();
+    }
+
+    bool Mount()
+    {
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        while (HOST_TimeGet() < until)
+        {
+            if (SYS_FS_Mount(kDevice, kMount, FAT, 0, NULL) == SYS_FS_RES_SUCCESS)
+            {
+                return true;
+            }
+
+            HOST_Run(Tasks, HOST_TimeGet() + HOST_NS_PER_MS, 10U * HOST_NS_PER_US);
+        }
+
+        return false;
+    }
+
+    void Format()
+    {
+        SYS_FS_FORMAT_PARAM opt = {};
+        static uint8_t work[512];
+
+        opt.fmt = SYS_FS_FORMAT_FAT;
+        ASSERT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_DriveFormat(kMount, &opt, work, sizeof(work)));
+    }
+
+    bool WriteFile( const char* path, const uint8_t* data, size_t size )
+    {
+        SYS_FS_HANDLE file = SYS_FS_FileOpen(path, SYS_FS_FILE_OPEN_WRITE);
+
+        if (file == SYS_FS_HANDLE_INVALID)
+        {
+            return false;
+        }
+
+        bool ok = (SYS_FS_FileWrite(file, data, size) == size);
+
+        return (SYS_FS_FileClose(file) == SYS_FS_RES_SUCCESS) && ok;
+    }
+
+    void Pattern( uint8_t* data, size_t size, uint8_t seed )
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            data[i] = (uint8_t)((i * 7U) + seed);
+        }
+    }
+
+    DRV_HANDLE OpenDriver()
+    {
+        DRV_HANDLE handle = DRV_RAMDISK_Open(DRV_RAMDISK_INDEX_0, DRV_IO_INTENT_READWRITE);
+
+        if (handle != DRV_HANDLE_INVALID)
+        {
+            DRV_RAMDISK_EventHandlerSet(handle, (const void*)RamdiskEvent, 0U);
+        }
+
+        return handle;
+    }
+
+    void WaitEvent()
+    {
+        uint32_t start = events;
+        uint64_t until = HOST_TimeGet() + (100U * HOST_NS_PER_MS);
+
+        while ((events == start) && (HOST_TimeGet() < until))
+        {
+            HOST_Run(Tasks, HOST_TimeGet() + (100U * HOST_NS_PER_US), 10U * HOST_NS_PER_US);
+        }
+    }
+};
+
+TEST_F(DrvRamdiskTest, MountsFormatsAndReadsBackAFile)
+{
+    static uint8_t written[3000];
+    static uint8_t read[3000];
+    DRV_RAMDISK_STATISTICS stats;
+
+    ASSERT_TRUE(Mount());
+    Format();
+
+    Pattern(written, sizeof(written), 0x5AU);
+    uint64_t start = HOST_TimeGet();
+    ASSERT_TRUE(WriteFile("/mnt/ram/data.bin", written, sizeof(written)));
+    uint64_t elapsed = HOST_TimeGet() - start;
+
+    SYS_FS_HANDLE file = SYS_FS_FileOpen("/mnt/ram/data.bin", SYS_FS_FILE_OPEN_READ);
+    ASSERT_NE(SYS_FS_HANDLE_INVALID, file);
+    EXPECT_EQ((int32_t)sizeof(written), SYS_FS_FileSize(file));
+    EXPECT_EQ((size_t)sizeof(read), SYS_FS_FileRead(file, read, sizeof(read)));
+    EXPECT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileClose(file));
+    EXPECT_EQ(0, memcmp(written, read, sizeof(written)));
+
+    ASSERT_TRUE(DRV_RAMDISK_StatisticsGet(DRV_RAMDISK_INDEX_0, &stats));
+    EXPECT_EQ(0U, stats.failedCommands);
+    EXPECT_GE(stats.blocksWritten, (uint32_t)((sizeof(written) + 511U) / 512U));
+
+    /* every write of the file waited out the write latency */
+    EXPECT_GE(elapsed, (uint64_t)kWriteLatencyUs * HOST_NS_PER_US);
+}
+
+TEST_F(DrvRamdiskTest, DataSurvivesARemount)
+{
+    static uint8_t written[1024];
+    static uint8_t read[1024];
+
+    ASSERT_TRUE(Mount());
+    Format();
+    Pattern(written, sizeof(written), 3U);
+    ASSERT_TRUE(WriteFile("/mnt/ram/keep.bin", written, sizeof(written)));
+    ASSERT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_Unmount(kMount));
+
+    ASSERT_TRUE(Mount());
+    SYS_FS_HANDLE file = SYS_FS_FileOpen("/mnt/ram/keep.bin", SYS_FS_FILE_OPEN_READ);
+    ASSERT_NE(SYS_FS_HANDLE_INVALID, file);
+    EXPECT_EQ((size_t)sizeof(read), SYS_FS_FileRead(file, read, sizeof(read)));
+    EXPECT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileClose(file));
+    EXPECT_EQ(0, memcmp(written, read, sizeof(written)));
+}
+
+TEST_F(DrvRamdiskTest, FailedWriteLeavesTheBlockUnchanged)
+{
+    static uint8_t block[DRV_RAMDISK_BLOCK_SIZE] __attribute__((aligned(4)));
+    DRV_RAMDISK_COMMAND_HANDLE command;
+    DRV_RAMDISK_STATISTICS stats;
+    DRV_RAMDISK_FAULT fault = {};
+
+    HOST_Run(Tasks, HOST_TimeGet() + HOST_NS_PER_MS, 10U * HOST_NS_PER_US);
+    DRV_HANDLE handle = OpenDriver();
+    ASSERT_NE(DRV_HANDLE_INVALID, handle);
+
+    fault.operations = DRV_RAMDISK_FAULT_WRITE;
+    fault.blockStart = 10U;
+    fault.nBlock = 1U;
+    fault.skipCount = 1U;
+    fault.failCount = 1U;
+    DRV_RAMDISK_FaultSet(DRV_RAMDISK_INDEX_0, &fault);
+
+    /* the first matching write goes through, the second fails */
+    Pattern(block, sizeof(block), 1U);
+    DRV_RAMDISK_AsyncWrite(handle, &command, block, 10U, 1U);
+    ASSERT_NE(DRV_RAMDISK_COMMAND_HANDLE_INVALID, command);
+    WaitEvent();
+    EXPECT_EQ(SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE, lastEvent);
+    EXPECT_EQ(0, memcmp(block, &disk[10U * DRV_RAMDISK_BLOCK_SIZE], sizeof(block)));
+
+    Pattern(block, sizeof(block), 2U);
+    DRV_RAMDISK_AsyncWrite(handle, &command, block, 9U, 2U);
+    WaitEvent();
+    EXPECT_EQ(SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR, lastEvent);
+
+    Pattern(block, sizeof(block), 1U);
+    EXPECT_EQ(0, memcmp(block, &disk[10U * DRV_RAMDISK_BLOCK_SIZE], sizeof(block)));
+
+    /* outside the range, and once the fault is used up, writes succeed */
+    DRV_RAMDISK_AsyncWrite(handle, &command, block, 20U, 1U);
+    WaitEvent();
+    EXPECT_EQ(SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE, lastEvent);
+    DRV_RAMDISK_AsyncWrite(handle, &command, block, 10U, 1U);
+    WaitEvent();
+    EXPECT_EQ(SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE, lastEvent);
+
+    ASSERT_TRUE(DRV_RAMDISK_StatisticsGet(DRV_RAMDISK_INDEX_0, &stats));
+    EXPECT_EQ(4U, stats.writeCommands);
+    EXPECT_EQ(1U, stats.failedCommands);
+    EXPECT_EQ(3U, stats.blocksWritten);
+}
+
+TEST_F(DrvRamdiskTest, FailedReadLeavesTheBufferUnchanged)
+{
+    static uint8_t block[DRV_RAMDISK_BLOCK_SIZE] __attribute__((aligned(4)));
+    DRV_RAMDISK_COMMAND_HANDLE command;
+    DRV_RAMDISK_FAULT fault = {};
+
+    HOST_Run(Tasks, HOST_TimeGet() + HOST_NS_PER_MS, 10U * HOST_NS_PER_US);
+    DRV_HANDLE handle = OpenDriver();
+    ASSERT_NE(DRV_HANDLE_INVALID, handle);
+
+    (void) memset(&disk[5U * DRV_RAMDISK_BLOCK_SIZE], 0xA5, DRV_RAMDISK_BLOCK_SIZE);
+    (void) memset(block, 0x11, sizeof(block));
+
+    fault.operations = DRV_RAMDISK_FAULT_READ;
+    fault.failCount = 1U;
+    DRV_RAMDISK_FaultSet(DRV_RAMDISK_INDEX_0, &fault);
+
+    uint64_t start = HOST_TimeGet();
+    DRV_RAMDISK_AsyncRead(handle, &command, block, 5U, 1U);
+    WaitEvent();
+    EXPECT_EQ(SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR, lastEvent);
+    EXPECT_EQ(0x11U, block[0]);
+    EXPECT_EQ(0x11U, block[sizeof(block) - 1U]);
+    EXPECT_GE(HOST_TimeGet() - start, (uint64_t)kReadLatencyUs * HOST_NS_PER_US);
+
+    DRV_RAMDISK_AsyncRead(handle, &command, block, 5U, 1U);
+    WaitEvent();
+    EXPECT_EQ(SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE, lastEvent);
+    EXPECT_EQ(0xA5U, block[0]);
+}
+
+TEST_F(DrvRamdiskTest, FileSystemSeesAFailedWrite)
+{
+    static uint8_t written[2048];
+    DRV_RAMDISK_FAULT fault = {};
+    DRV_RAMDISK_STATISTICS stats;
+
+    ASSERT_TRUE(Mount());
+    Format();
+
+    ASSERT_TRUE(DRV_RAMDISK_StatisticsGet(DRV_RAMDISK_INDEX_0, &stats));
+    uint32_t blocksWritten = stats.blocksWritten;
+
+    fault.operations = DRV_RAMDISK_FAULT_WRITE;
+    fault.failCount = 1000U;
+    DRV_RAMDISK_FaultSet(DRV_RAMDISK_INDEX_0, &fault);
+
+    Pattern(written, sizeof(written), 9U);
+    EXPECT_FALSE(WriteFile("/mnt/ram/lost.bin", written, sizeof(written)));
+
+    ASSERT_TRUE(DRV_RAMDISK_StatisticsGet(DRV_RAMDISK_INDEX_0, &stats));
+    EXPECT_GE(stats.failedCommands, 1U);
+    EXPECT_EQ(blocksWritten, stats.blocksWritten);
+}
+
+TEST_F(DrvRamdiskTest, DetachedDiskDoesNotMount)
+{
+    DRV_RAMDISK_AttachSet(DRV_RAMDISK_INDEX_0, false);
+    EXPECT_FALSE(Mount());
+
+    DRV_RAMDISK_AttachSet(DRV_RAMDISK_INDEX_0, true);
+    EXPECT_TRUE(Mount());
+}
+
+/* The disk is kept through a backing store that counts the accesses to the
+ * FATs */
+class DrvRamdiskStoreTest : public DrvRamdiskTest
+{
+protected:
+    void SetUp() override
+    {
+        fatStart = 0U;
+        fatEnd = 0U;
+        SetUpWith(&countingInit);
+    }
+
+    /* Finds the FATs from the boot sector, after a partition table if
+     * the format wrote one */
+    void FatFind()
+    {
+        const uint8_t* sector = disk;
+        uint32_t volume = 0U;
+        uint32_t fatSize;
+
+        if ((sector[0] != 0xEBU) && (sector[0] != 0xE9U))
+        {
+            volume = sector[0x1C6] | (sector[0x1C7] << 8) | (sector[0x1C8] << 16) | ((uint32_t)sector[0x1C9] << 24);
+            sector = &disk[volume * DRV_RAMDISK_BLOCK_SIZE];
+        }
+
+        fatSize = sector[22] | (sector[23] << 8);
+        if (fatSize == 0U)
+        {
+            fatSize = sector[36] | (sector[37] << 8) | (sector[38] << 16) | ((uint32_t)sector[39] << 24);
+        }
+
+        fatStart = volume + (sector[14] | (sector[15] << 8));
+        fatEnd = fatStart + (sector[16] * fatSize);
+    }
+
+    /* Appends records to a new file, each made durable by a sync as the
+     * log journal does, and returns the FAT accesses of the appends */
+    uint32_t Append( const char* path, uint32_t records, bool isExpanded )
+    {
+        uint8_t record[kRecordSize];
+        SYS_FS_HANDLE file = SYS_FS_FileOpen(path, SYS_FS_FILE_OPEN_WRITE);
+        uint32_t start;
+
+        EXPECT_NE(SYS_FS_HANDLE_INVALID, file);
+        if (isExpanded == true)
+        {
+            EXPECT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileExpand(file, records * kRecordSize));
+        }
+
+        start = fatAccesses;
+        for (uint32_t i = 0U; i < records; i++)
+        {
+            Pattern(record, sizeof(record), (uint8_t)i);
+            EXPECT_EQ(sizeof(record), SYS_FS_FileWrite(file, record, sizeof(record)));
+            EXPECT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileSync(file));
+        }
+
+        uint32_t accesses = fatAccesses - start;
+        EXPECT_EQ(SYS_FS_RES_SUCCESS, SYS_FS_FileClose(file));
+
+        return accesses;
+    }
+
+    static constexpr uint32_t kRecordSize = 48U;
+};
+
+TEST_F(DrvRamdiskStoreTest, PreallocatedFileAppendsWithoutTheFat)
+{
+    constexpr uint32_t kRecords = 200U;
+    uint32_t grown;
+    uint32_t expanded;
+
+    ASSERT_TRUE(Mount());
+    Format();
+    FatFind();
+    ASSERT_LT(fatStart, fatEnd);
+
+    grown = Append("/mnt/ram/grown.log", kRecords, false);
+    expanded = Append("/mnt/ram/expanded.log", kRecords, true);
+
+    /* a file that grows reads and writes the FAT as it gets clusters; the
+     * appends to the preallocated extent find them in the link map */
+    EXPECT_LT(0U, grown);
+    EXPECT_LT(expanded * 10U, grown) << grown << " growing, " << expanded << " preallocated";
+}
+
+}
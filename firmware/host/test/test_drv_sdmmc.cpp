@@ -0,0 +1,565 @@
+/*******************************************************************************
+  SD Card Driver Host Tests
+
+  File Name:
+    test_drv_sdmmc.cpp
+
+  Summary:
+    Runs drv_sdmmc.c and the SDHC1 PLIB against the simulated SD card.
+
+  Description:
+    The card model of plib_sdhc1_regs_sim.c answers the driver's commands at
+    the SD clock the PLIB sets and moves the data through the ADMA2
+    descriptor table. The driver tests queue requests with DRV_SDMMC_Async*
+    directly; the SYS_FS tests call the FatFs disk layer of diskio.c, which
+    blocks on the media manager until each request is done.
+
+    The DMA addresses are 32 bits wide, so every buffer the card reads or
+    writes is static.
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "host_sim.h"
+#include "host_plib.h"
+
+extern "C"
+{
+#include "system/fs/fat_fs/hardware_access/diskio.h"
+
+extern const SYS_TIME_INIT sysTimeInitData;
+extern const DRV_SDMMC_INIT drvSDMMC0InitData;
+extern const SYS_FS_REGISTRATION_TABLE sysFSInit[SYS_FS_MAX_FILE_SYSTEM_TYPE];
+}
+
+namespace
+{
+
+constexpr uint32_t kBlockSize = 512U;
+constexpr uint32_t kCardBlocks = 32768U;
+constexpr uint64_t kPassNs = 10U * HOST_NS_PER_US;
+
+/* SDHC1_DMA_NUM_DESCR_LINES lines of SDHC1_DMA_DESCR_MAX_LENGTH bytes each */
+constexpr uint32_t kDescriptorLines = 8U;
+constexpr uint32_t kLineBytes = 65536U;
+constexpr uint32_t kChainBlocks = (kDescriptorLines * kLineBytes) / kBlockSize;
+
+CACHE_ALIGN uint8_t blocks[4][16U * kBlockSize];
+CACHE_ALIGN uint8_t readBack[16U * kBlockSize];
+CACHE_ALIGN uint8_t chain[(kChainBlocks + 1U) * kBlockSize];
+
+SYS_MODULE_OBJ sdmmcObject;
+bool fsEnabled;
+
+uint32_t completed;
+uint32_t failed;
+
+void Tasks( void )
+{
+    if (fsEnabled == true)
+    {
+        SYS_FS_Tasks();
+    }
+
+    DRV_SDMMC_Tasks(sdmmcObject);
+}
+
+void SdmmcEvent( SYS_MEDIA_BLOCK_EVENT event, SYS_MEDIA_BLOCK_COMMAND_HANDLE commandHandle, uintptr_t context )
+{
+    (void) commandHandle;
+    (void) context;
+
+    if (event == SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE)
+    {
+        completed++;
+    }
+    else
+    {
+        failed++;
+    }
+}
+
+void Fill( uint8_t* data, size_t size, uint8_t seed )
+{
+    for (size_t i = 0U; i < size; i++)
+    {
+        data[i] = (uint8_t)(seed + (i * 7U) + (i >> 9));
+    }
+}
+
+const uint8_t* CardBlock( uint32_t block )
+{
+    return HOST_SDCARD_DataGet() + ((size_t)block * kBlockSize);
+}
+
+HOST_SDCARD_STATISTICS CardStatistics()
+{
+    HOST_SDCARD_STATISTICS stats;
+
+    HOST_SDCARD_StatisticsGet(&stats);
+
+    return stats;
+}
+
+/* Each test runs in its own process, with a blank card in the slot */
+class DrvSdmmcTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        SetUpWith(kCardBlocks, true, false);
+    }
+
+    void SetUpWith( uint32_t cardBlocks, bool highCapacity, bool fs )
+    {
+        HOST_Reset();
+        completed = 0U;
+        failed = 0U;
+        fsEnabled = fs;
+
+        HOST_SDCARD_Create(cardBlocks, highCapacity);
+        HOST_SDCARD_Insert();
+
+        TC0_TimerInitialize();
+        (void) SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT*)&sysTimeInitData);
+        SDHC1_Initialize();
+        sdmmcObject = DRV_SDMMC_Initialize(DRV_SDMMC_INDEX_0, (SYS_MODULE_INIT*)&drvSDMMC0InitData);
+        ASSERT_NE(SYS_MODULE_OBJ_INVALID, sdmmcObject);
+
+        if (fs == true)
+        {
+            (void) SYS_FS_Initialize((const void*)sysFSInit);
+        }
+
+        NVIC_Initialize();
+
+        if (fs == false)
+        {
+            handle = DRV_SDMMC_Open(DRV_SDMMC_INDEX_0, DRV_IO_INTENT_READWRITE);
+            ASSERT_NE(DRV_HANDLE_INVALID, handle);
+            DRV_SDMMC_EventHandlerSet(handle, (const void*)SdmmcEvent, 0);
+        }
+    }
+
+    /* Runs the tasks until the card is initialized, at most for a second */
+    bool Attach()
+    {
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        while (HOST_TimeGet() < until)
+        {
+            if ((fsEnabled == true) &&
+                (SYS_FS_MEDIA_MANAGER_MediaStatusGet(SYS_FS_MEDIA_IDX0_DEVICE_NAME_VOLUME_IDX0) == true))
+            {
+                /* The blank card has no volume to mount, so the disk layer
+                 * is started as a mount would */
+                HOST_Run(Tasks, HOST_TimeGet() + (100U * HOST_NS_PER_MS), kPassNs);
+                return (disk_initialize(0) == 0);
+            }
+
+            if ((fsEnabled == false) && (DRV_SDMMC_IsAttached(handle) == true))
+            {
+                return true;
+            }
+
+            HOST_Run(Tasks, HOST_TimeGet() + HOST_NS_PER_MS, kPassNs);
+        }
+
+        return false;
+    }
+
+    /* Runs the tasks until count requests have ended, at most for a second */
+    bool WaitFor( uint32_t count )
+    {
+        uint64_t until = HOST_TimeGet() + HOST_NS_PER_S;
+
+        while ((completed + failed) < count)
+        {
+            if (HOST_TimeGet() >= until)
+            {
+                return false;
+            }
+
+            HOST_Run(Tasks, HOST_TimeGet() + (100U * HOST_NS_PER_US), kPassNs);
+        }
+
+        return true;
+    }
+
+    void Write( uint8_t* data, uint32_t block, uint32_t count )
+    {
+        DRV_SDMMC_COMMAND_HANDLE command;
+
+        DRV_SDMMC_AsyncWrite(handle, &command, data, block, count);
+        ASSERT_NE(DRV_SDMMC_COMMAND_HANDLE_INVALID, command);
+    }
+
+    void Read( uint8_t* data, uint32_t block, uint32_t count )
+    {
+        DRV_SDMMC_COMMAND_HANDLE command;
+
+        DRV_SDMMC_AsyncRead(handle, &command, data, block, count);
+        ASSERT_NE(DRV_SDMMC_COMMAND_HANDLE_INVALID, command);
+    }
+
+    DRV_SDMMC_BUS_INFO BusInfo()
+    {
+        DRV_SDMMC_BUS_INFO info = {};
+
+        EXPECT_TRUE(DRV_SDMMC_BusInfoGet(handle, &info));
+
+        return info;
+    }
+
+    DRV_HANDLE handle = DRV_HANDLE_INVALID;
+};
+
+class DrvSdmmcStandardTest : public DrvSdmmcTest
+{
+protected:
+    void SetUp() override
+    {
+        SetUpWith(kCardBlocks, false, false);
+    }
+};
+
+class DrvSdmmcDiskTest : public DrvSdmmcTest
+{
+protected:
+    void SetUp() override
+    {
+        SetUpWith(kCardBlocks, true, true);
+    }
+};
+
+// *****************************************************************************
+// Card initialization and write merging
+
+TEST_F(DrvSdmmcTest, InitializesTheCardAtHighSpeed)
+{
+    ASSERT_TRUE(Attach());
+
+    DRV_SDMMC_BUS_INFO info = BusInfo();
+    SYS_MEDIA_GEOMETRY* geometry = DRV_SDMMC_GeometryGet(handle);
+
+    EXPECT_EQ(DRV_SDMMC_SPEED_MODE_HIGH, info.speedMode);
+    EXPECT_EQ(50000000U, info.busClock);
+    EXPECT_EQ(1U, CardStatistics().highSpeedSwitches);
+    ASSERT_NE(nullptr, geometry);
+    EXPECT_EQ(kCardBlocks, geometry->geometryTable[SYS_MEDIA_GEOMETRY_TABLE_WRITE_ENTRY].numBlocks);
+}
+
+TEST_F(DrvSdmmcTest, MergesQueuedWritesToAdjacentBlocks)
+{
+    ASSERT_TRUE(Attach());
+
+    Fill(blocks[0], 2U * kBlockSize, 1U);
+    Fill(blocks[1], 3U * kBlockSize, 2U);
+    Fill(blocks[2], 1U * kBlockSize, 3U);
+
+    Write(blocks[0], 100U, 2U);
+    Write(blocks[1], 102U, 3U);
+    Write(blocks[2], 105U, 1U);
+    ASSERT_TRUE(WaitFor(3U));
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    EXPECT_EQ(3U, completed);
+    EXPECT_EQ(1U, stats.writeCommands);
+    EXPECT_EQ(1U, stats.multiBlockWrites);
+    EXPECT_EQ(1U, stats.preErases);
+    EXPECT_EQ(100U, stats.lastWriteBlock);
+    EXPECT_EQ(6U, stats.lastWriteCount);
+
+    EXPECT_EQ(0, memcmp(blocks[0], CardBlock(100U), 2U * kBlockSize));
+    EXPECT_EQ(0, memcmp(blocks[1], CardBlock(102U), 3U * kBlockSize));
+    EXPECT_EQ(0, memcmp(blocks[2], CardBlock(105U), 1U * kBlockSize));
+}
+
+TEST_F(DrvSdmmcTest, DoesNotMergeWritesThatLeaveAGap)
+{
+    ASSERT_TRUE(Attach());
+
+    Fill(blocks[0], kBlockSize, 1U);
+    Fill(blocks[1], kBlockSize, 2U);
+
+    Write(blocks[0], 100U, 1U);
+    Write(blocks[1], 102U, 1U);
+    ASSERT_TRUE(WaitFor(2U));
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    EXPECT_EQ(2U, completed);
+    EXPECT_EQ(2U, stats.writeCommands);
+    EXPECT_EQ(0U, stats.multiBlockWrites);
+    EXPECT_EQ(0, memcmp(blocks[1], CardBlock(102U), kBlockSize));
+}
+
+// *****************************************************************************
+// Fallback from High Speed to Default Speed
+
+TEST_F(DrvSdmmcTest, RequeuesMergedWritesAtDefaultSpeed)
+{
+    ASSERT_TRUE(Attach());
+    HOST_SDCARD_HighSpeedErrorsSet(true);
+
+    Fill(blocks[0], 2U * kBlockSize, 1U);
+    Fill(blocks[1], 3U * kBlockSize, 2U);
+    Fill(blocks[2], 1U * kBlockSize, 3U);
+
+    Write(blocks[0], 100U, 2U);
+    Write(blocks[1], 102U, 3U);
+    Write(blocks[2], 105U, 1U);
+    ASSERT_TRUE(WaitFor(3U));
+
+    DRV_SDMMC_BUS_INFO info = BusInfo();
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    /* The merged write failed once, and went out whole again at 25 MHz */
+    EXPECT_EQ(3U, completed);
+    EXPECT_EQ(0U, failed);
+    EXPECT_EQ(1U, info.speedFallbacks);
+    EXPECT_EQ(DRV_SDMMC_SPEED_MODE_DEFAULT, info.speedMode);
+    EXPECT_EQ(25000000U, info.busClock);
+    EXPECT_EQ(1U, stats.dataErrors);
+    EXPECT_EQ(100U, stats.lastWriteBlock);
+    EXPECT_EQ(6U, stats.lastWriteCount);
+
+    EXPECT_EQ(0, memcmp(blocks[0], CardBlock(100U), 2U * kBlockSize));
+    EXPECT_EQ(0, memcmp(blocks[1], CardBlock(102U), 3U * kBlockSize));
+    EXPECT_EQ(0, memcmp(blocks[2], CardBlock(105U), 1U * kBlockSize));
+}
+
+TEST_F(DrvSdmmcStandardTest, RequeueRestoresTheBlockAddress)
+{
+    ASSERT_TRUE(Attach());
+    HOST_SDCARD_HighSpeedErrorsSet(true);
+
+    /* A standard capacity card takes byte addresses; the retry would go
+     * past the end of the card if the block address were not restored */
+    Fill(blocks[0], 2U * kBlockSize, 4U);
+    Write(blocks[0], 200U, 2U);
+    ASSERT_TRUE(WaitFor(1U));
+
+    EXPECT_EQ(1U, completed);
+    EXPECT_EQ(1U, BusInfo().speedFallbacks);
+    EXPECT_EQ(200U, CardStatistics().lastWriteBlock);
+    EXPECT_EQ(0, memcmp(blocks[0], CardBlock(200U), 2U * kBlockSize));
+
+    Read(readBack, 201U, 1U);
+    ASSERT_TRUE(WaitFor(2U));
+
+    EXPECT_EQ(2U, completed);
+    EXPECT_EQ(0, memcmp(blocks[0] + kBlockSize, readBack, kBlockSize));
+}
+
+TEST_F(DrvSdmmcStandardTest, RequeuesAFailedReadAtDefaultSpeed)
+{
+    ASSERT_TRUE(Attach());
+
+    Fill(blocks[0], 4U * kBlockSize, 6U);
+    Write(blocks[0], 300U, 4U);
+    ASSERT_TRUE(WaitFor(1U));
+
+    HOST_SDCARD_HighSpeedErrorsSet(true);
+    Read(readBack, 300U, 4U);
+    ASSERT_TRUE(WaitFor(2U));
+
+    EXPECT_EQ(2U, completed);
+    EXPECT_EQ(1U, BusInfo().speedFallbacks);
+    EXPECT_EQ(0, memcmp(blocks[0], readBack, 4U * kBlockSize));
+}
+
+// *****************************************************************************
+// ADMA2 descriptor table
+
+TEST(Sdhc1DmaChainTest, FitsAtMostOneLinePerDescriptor)
+{
+    SDHC_DMA_SEGMENT segments[kDescriptorLines + 1U];
+
+    for (uint32_t i = 0U; i <= kDescriptorLines; i++)
+    {
+        segments[i].buffer = &chain[i * kBlockSize];
+        segments[i].numBytes = kBlockSize;
+    }
+
+    EXPECT_TRUE(SDHC1_DmaChainSetup(segments, kDescriptorLines, SDHC_DATA_TRANSFER_DIR_WRITE));
+    EXPECT_FALSE(SDHC1_DmaChainSetup(segments, kDescriptorLines + 1U, SDHC_DATA_TRANSFER_DIR_WRITE));
+
+    /* A segment longer than a line takes several */
+    segments[0].buffer = chain;
+    segments[0].numBytes = kDescriptorLines * kLineBytes;
+    EXPECT_TRUE(SDHC1_DmaChainSetup(segments, 1U, SDHC_DATA_TRANSFER_DIR_WRITE));
+
+    segments[0].numBytes += 4U;
+    EXPECT_FALSE(SDHC1_DmaChainSetup(segments, 1U, SDHC_DATA_TRANSFER_DIR_WRITE));
+
+    /* ADMA2 takes word aligned addresses only */
+    segments[0].buffer = &chain[2];
+    segments[0].numBytes = kBlockSize;
+    EXPECT_FALSE(SDHC1_DmaChainSetup(segments, 1U, SDHC_DATA_TRANSFER_DIR_WRITE));
+}
+
+TEST_F(DrvSdmmcTest, WritesTheLongestChainInOneTransfer)
+{
+    ASSERT_TRUE(Attach());
+
+    Fill(chain, (size_t)kChainBlocks * kBlockSize, 7U);
+    Write(chain, 1000U, kChainBlocks);
+    ASSERT_TRUE(WaitFor(1U));
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    EXPECT_EQ(1U, completed);
+    EXPECT_EQ(kDescriptorLines, stats.descriptorLines);
+    EXPECT_EQ(kChainBlocks, stats.lastWriteCount);
+    EXPECT_EQ(0, memcmp(chain, CardBlock(1000U), (size_t)kChainBlocks * kBlockSize));
+}
+
+TEST_F(DrvSdmmcTest, FailsAWriteThatNeedsOneLineTooMany)
+{
+    ASSERT_TRUE(Attach());
+    uint32_t writes = CardStatistics().writeCommands;
+
+    Fill(chain, (size_t)(kChainBlocks + 1U) * kBlockSize, 8U);
+    Write(chain, 1000U, kChainBlocks + 1U);
+    ASSERT_TRUE(WaitFor(1U));
+
+    /* The request fails before any data goes to the card */
+    EXPECT_EQ(1U, failed);
+    EXPECT_EQ(writes, CardStatistics().writeCommands);
+    EXPECT_NE(0, memcmp(chain, CardBlock(1000U), kBlockSize));
+
+    /* and the driver goes on with the next one */
+    Write(chain, 1000U, 2U);
+    ASSERT_TRUE(WaitFor(2U));
+
+    EXPECT_EQ(1U, completed);
+    EXPECT_EQ(0, memcmp(chain, CardBlock(1000U), 2U * kBlockSize));
+}
+
+TEST_F(DrvSdmmcTest, GathersMergedWritesFromTheirBuffers)
+{
+    ASSERT_TRUE(Attach());
+
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        Fill(blocks[i], kBlockSize, (uint8_t)(10U + i));
+        Write(blocks[i], 400U + i, 1U);
+    }
+
+    ASSERT_TRUE(WaitFor(4U));
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    /* One write, one descriptor line per buffer */
+    EXPECT_EQ(4U, completed);
+    EXPECT_EQ(1U, stats.writeCommands);
+    EXPECT_EQ(4U, stats.descriptorLines);
+
+    for (uint32_t i = 0U; i < 4U; i++)
+    {
+        EXPECT_EQ(0, memcmp(blocks[i], CardBlock(400U + i), kBlockSize));
+    }
+}
+
+// *****************************************************************************
+// Write gathering of the disk layer
+
+TEST_F(DrvSdmmcDiskTest, GathersConsecutiveSectorsIntoOneWrite)
+{
+    ASSERT_TRUE(Attach());
+    uint32_t writes = CardStatistics().writeCommands;
+
+    for (uint32_t i = 0U; i < SYS_FS_FAT_WRITE_GATHER_SECTORS; i++)
+    {
+        Fill(blocks[0], kBlockSize, (uint8_t)i);
+        ASSERT_EQ(RES_OK, disk_write(0, blocks[0], 300U + i, 1U));
+
+        if (i < (SYS_FS_FAT_WRITE_GATHER_SECTORS - 1U))
+        {
+            EXPECT_EQ(writes, CardStatistics().writeCommands);
+        }
+    }
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    /* The full run went out by itself, as one write */
+    EXPECT_EQ(writes + 1U, stats.writeCommands);
+    EXPECT_EQ(300U, stats.lastWriteBlock);
+    EXPECT_EQ((uint32_t)SYS_FS_FAT_WRITE_GATHER_SECTORS, stats.lastWriteCount);
+    EXPECT_EQ(0, memcmp(blocks[0], CardBlock(300U + SYS_FS_FAT_WRITE_GATHER_SECTORS - 1U), kBlockSize));
+}
+
+TEST_F(DrvSdmmcDiskTest, NonContiguousWriteFlushesTheRun)
+{
+    ASSERT_TRUE(Attach());
+    uint32_t writes = CardStatistics().writeCommands;
+
+    Fill(blocks[0], 2U * kBlockSize, 1U);
+    Fill(blocks[1], kBlockSize, 2U);
+
+    ASSERT_EQ(RES_OK, disk_write(0, blocks[0], 300U, 1U));
+    ASSERT_EQ(RES_OK, disk_write(0, blocks[0] + kBlockSize, 301U, 1U));
+    EXPECT_EQ(writes, CardStatistics().writeCommands);
+
+    ASSERT_EQ(RES_OK, disk_write(0, blocks[1], 400U, 1U));
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    EXPECT_EQ(writes + 1U, stats.writeCommands);
+    EXPECT_EQ(300U, stats.lastWriteBlock);
+    EXPECT_EQ(2U, stats.lastWriteCount);
+    EXPECT_EQ(0, memcmp(blocks[0], CardBlock(300U), 2U * kBlockSize));
+
+    /* The new run waits for the next flush */
+    EXPECT_NE(0, memcmp(blocks[1], CardBlock(400U), kBlockSize));
+}
+
+TEST_F(DrvSdmmcDiskTest, OverlappingReadFlushesTheRunFirst)
+{
+    ASSERT_TRUE(Attach());
+    uint32_t writes = CardStatistics().writeCommands;
+
+    Fill(blocks[0], 3U * kBlockSize, 5U);
+
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        ASSERT_EQ(RES_OK, disk_write(0, blocks[0] + (i * kBlockSize), 300U + i, 1U));
+    }
+
+    /* A read elsewhere leaves the run alone */
+    ASSERT_EQ(RES_OK, disk_read(0, readBack, 500U, 1U));
+    EXPECT_EQ(writes, CardStatistics().writeCommands);
+
+    /* A read of its last sector gets the data just written */
+    ASSERT_EQ(RES_OK, disk_read(0, readBack, 302U, 2U));
+
+    HOST_SDCARD_STATISTICS stats = CardStatistics();
+
+    EXPECT_EQ(writes + 1U, stats.writeCommands);
+    EXPECT_EQ(3U, stats.lastWriteCount);
+    EXPECT_EQ(0, memcmp(blocks[0] + (2U * kBlockSize), readBack, kBlockSize));
+}
+
+TEST_F(DrvSdmmcDiskTest, CtrlSyncFlushesTheRun)
+{
+    ASSERT_TRUE(Attach());
+    uint32_t writes = CardStatistics().writeCommands;
+
+    Fill(blocks[0], kBlockSize, 9U);
+    ASSERT_EQ(RES_OK, disk_write(0, blocks[0], 300U, 1U));
+    EXPECT_EQ(writes, CardStatistics().writeCommands);
+
+    ASSERT_EQ(RES_OK, disk_ioctl(0, CTRL_SYNC, NULL));
+    EXPECT_EQ(writes + 1U, CardStatistics().writeCommands);
+    EXPECT_EQ(0, memcmp(blocks[0], CardBlock(300U), kBlockSize));
+
+    /* Nothing is left to write */
+    ASSERT_EQ(RES_OK, disk_ioctl(0, CTRL_SYNC, NULL));
+    EXPECT_EQ(writes + 1U, CardStatistics().writeCommands);
+}
+
+}
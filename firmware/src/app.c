@@ -29,7 +29,14 @@
 
 #include "app.h"
 #include "app_sdcard.h"
+#include "app_config.h"
+#include "app_memory.h"
+#include "app_meteo.h"
+#include "app_query.h"
+#include "app_timestamp.h"
 #include "driver/bme280/drv_bme280.h"
+#include "driver/bme280/drv_bme280_replay.h"
+#include "peripheral/sercom/i2c_master/plib_sercom3_i2c_master.h"
 #include "peripheral/sercom/usart/plib_sercom2_usart.h"
 #include "system/time/sys_time.h"
 #include "peripheral/port/plib_port.h"
@@ -40,11 +47,19 @@
 // *****************************************************************************
 // *****************************************************************************
 
+/* Interrupts pended for each figure of the interrupt cycles report */
+#define APP_IRQ_CYCLES_RUNS     16U
+
 const uint8_t main_menu[] = 
 {
     "*** BME280 Weather Sensor Demonstration ***\r\n"
     "Connect BME280 Mikroe Click board to EXT1\r\n"
     "1: Read data from BME280\r\n"  
+    "2 <from> <to>: Download logged data, times as YYYYMMDDhhmmss\r\n"
+    "3 [<name> <value>]: Change a setting, print the settings and counters\r\n"
+    "4: Print the use of the RAM, the stack and the buffer pools\r\n"
+    "5: Print the I2C transaction counters of the sensor\r\n"
+    "6: Print the interrupt entry and exit cycles\r\n"
     "Press any key to clear screen and print menu\r\n\r\n"
 };
 
@@ -91,7 +106,6 @@ void APP_SENSOR_TimerEventHandler(uintptr_t context)
     APP_DATA* pApp = (APP_DATA*) context;
     
     /* request a read of the weather */
-    pApp->sampleCount++;
     DRV_BME280_Read(pApp->drvBME280);    
 }
 
@@ -101,8 +115,135 @@ void APP_SENSOR_TimerEventHandler(uintptr_t context)
 // *****************************************************************************
 // *****************************************************************************
 
-/* TODO:  Add any necessary local functions.
-*/
+/* (Re)start the periodic sample timer with the period of the settings */
+static void APP_SampleTimerStart(void)
+{
+    if (appData.sampleTimer != SYS_TIME_HANDLE_INVALID)
+    {
+        SYS_TIME_TimerDestroy(appData.sampleTimer);
+    }
+
+    appData.samplePeriodMs = APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS);
+    appData.sampleTimer = SYS_TIME_CallbackRegisterMS(APP_SENSOR_TimerEventHandler, (uintptr_t) &appData,
+            appData.samplePeriodMs, SYS_TIME_PERIODIC);
+}
+
+/* Print the I2C counters of the driver and, on the board, of the PLIB */
+static void APP_I2CReport(void)
+{
+    DRV_BME280_STATISTICS stats;
+    uint32_t cyclesPerUs = SYS_TIME_CPU_CLOCK_FREQUENCY / 1000000U;
+    uint32_t endCount;
+
+    if (DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats) == false)
+    {
+        return;
+    }
+
+    endCount = stats.doneCount + stats.nackCount + stats.busErrorCount;
+
+    printf("I2C: %lu transactions, %lu in progress, %lu refused, %lu bytes written, %lu read \r\n",
+           (unsigned long)stats.transactionCount,
+           (unsigned long)((stats.transactionCount > endCount) ? (stats.transactionCount - endCount) : 0U),
+           (unsigned long)stats.refusedCount, (unsigned long)stats.writeBytes, (unsigned long)stats.readBytes);
+    printf("I2C: %lu done, %lu NACK, %lu bus errors \r\n",
+           (unsigned long)stats.doneCount, (unsigned long)stats.nackCount, (unsigned long)stats.busErrorCount);
+
+    if (endCount > 0U)
+    {
+        printf("I2C: latency %lu us least, %lu mean, %lu most \r\n",
+               (unsigned long)(stats.minCycles / cyclesPerUs),
+               (unsigned long)((stats.totalCycles / endCount) / cyclesPerUs),
+               (unsigned long)(stats.maxCycles / cyclesPerUs));
+    }
+
+#if (DRV_BME280_SIMULATION == 0) && (DRV_BME280_REPLAY == 0)
+    {
+        SERCOM_I2C_STATISTICS plibStats;
+
+        SERCOM3_I2C_StatisticsGet(&plibStats);
+        printf("SERCOM3: %lu transfers, %lu refused, %lu done, %lu NAK, %lu bus errors (%lu arbitration lost), "
+               "%lu aborted \r\n",
+               (unsigned long)plibStats.transferCount, (unsigned long)plibStats.refusedCount,
+               (unsigned long)plibStats.doneCount, (unsigned long)plibStats.nakCount,
+               (unsigned long)plibStats.busErrorCount, (unsigned long)plibStats.arbitrationLostCount,
+               (unsigned long)plibStats.abortCount);
+    }
+#endif
+}
+
+/* Least core cycles from pending an interrupt to the return from its
+ * handler, less those of the same sequence with nothing pended. The handler
+ * finds no flag to serve, so this is the exception entry, the vector fetch,
+ * the flag checks and the exit: the path RAMFUNC takes out of the flash.
+ * Runs where the handler would have work to do are skipped. */
+static uint32_t APP_IrqCycles(IRQn_Type irq, bool isPended)
+{
+    uint32_t least = UINT32_MAX;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t run;
+
+    for (run = 0; run < APP_IRQ_CYCLES_RUNS; run++)
+    {
+        __disable_irq();
+
+        /* Entered during a transfer, the SERCOM3 handler would move the
+         * transfer on */
+        if ((irq == SERCOM3_0_IRQn) && (SERCOM3_I2C_IsBusy() == true))
+        {
+            __enable_irq();
+            continue;
+        }
+
+        start = DWT->CYCCNT;
+
+        if (isPended == true)
+        {
+            NVIC_SetPendingIRQ(irq);
+        }
+
+        __enable_irq();
+        __ISB();
+        cycles = DWT->CYCCNT - start;
+
+        if (cycles < least)
+        {
+            least = cycles;
+        }
+    }
+
+    return least;
+}
+
+/* Print the interrupt cycles of the console, the sensor and the system
+ * timer. Build with RAMFUNC_DISABLE for the figures with the handlers in
+ * flash. */
+static void APP_IrqReport(void)
+{
+    uint32_t base = APP_IrqCycles(SERCOM2_0_IRQn, false);
+    uint32_t sercom2 = APP_IrqCycles(SERCOM2_0_IRQn, true);
+    uint32_t tc0 = APP_IrqCycles(TC0_IRQn, true);
+    uint32_t sercom3;
+
+    /* The sample timer starts the transfers of the sensor */
+    NVIC_DisableIRQ(TC0_IRQn);
+    sercom3 = APP_IrqCycles(SERCOM3_0_IRQn, true);
+    NVIC_EnableIRQ(TC0_IRQn);
+
+    printf("IRQ: cycles from pending to return, handlers in %s \r\n",
+#ifdef RAMFUNC_DISABLE
+           "flash");
+#else
+           "SRAM");
+#endif
+    printf("IRQ: SERCOM2 %lu, TC0 %lu \r\n", (unsigned long)(sercom2 - base), (unsigned long)(tc0 - base));
+
+    if (sercom3 != UINT32_MAX)
+    {
+        printf("IRQ: SERCOM3 %lu \r\n", (unsigned long)(sercom3 - base));
+    }
+}
 
 // *****************************************************************************
 // *****************************************************************************
@@ -122,7 +263,9 @@ void APP_Initialize ( void )
 {
     /* Place the App state machine in its initial state. */
     appData.state = APP_STATE_INIT;
-    appData.sampleCount = 0;
+    appData.sampleTimer = SYS_TIME_HANDLE_INVALID;
+    appData.samplePeriodMs = 0;
+    appData.commandLength = 0;
 }
 
 
@@ -139,8 +282,11 @@ void APP_Tasks ( void )
     uint8_t inChar;
     int32_t temperature;
     uint32_t pressure;
+    uint32_t pressureQ8;
     uint32_t humidity;
     double fTemperature, fPressure, fHumidity;
+    uint64_t timestamp;
+    APP_METEO_DATA derived;
     
     /* Check the application's current state. */
     switch ( appData.state )
@@ -156,12 +302,14 @@ void APP_Tasks ( void )
                 return;
             }
 
+#if (DRV_BME280_REPLAY == 0)
             /* register a callback for reading the weather */
-            SYS_TIME_CallbackRegisterMS(APP_SENSOR_TimerEventHandler, (uintptr_t) &appData,
-                    5000, SYS_TIME_PERIODIC);
+            APP_SampleTimerStart();
+#endif
             
             printf("\33[H\33[2J");
             printf("%s", main_menu);
+            APP_MEMORY_Report();
     
             /* register a callback with the BME280 driver for when new data is available */
             DRV_BME280_ClientEventHandlerSet(appData.drvBME280, appDRVBME280EventHandler, (uintptr_t) &appData);
@@ -176,16 +324,72 @@ void APP_Tasks ( void )
             break;
             
         case APP_STATE_IDLE:
+#if (DRV_BME280_REPLAY == 1)
+            /* replay samples back to back, each once the last one is logged */
+            if ((DRV_BME280_REPLAY_IsComplete() == false) && (APP_SDCARD_IsIdle() == true))
+            {
+                appData.state = APP_STATE_READ_WEATHER;
+                DRV_BME280_Read(appData.drvBME280);
+                break;
+            }
+#else
+            /* the sample period setting has been changed */
+            if (APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS) != appData.samplePeriodMs)
+            {
+                APP_SampleTimerStart();
+            }
+#endif
             /* check for a key press and act accordingly */
             if (SERCOM2_USART_ReadIsBusy() == false)
             {
                 inChar = getc(stdin); 
-                if (inChar == '1')
+                if (appData.commandLength > 0U)
+                {
+                    /* collect a command line up to its end */
+                    if ((inChar == '\r') || (inChar == '\n'))
+                    {
+                        appData.command[appData.commandLength] = '\0';
+                        appData.commandLength = 0;
+
+                        if (appData.command[0] == '3')
+                        {
+                            if (APP_CONFIG_Request(&appData.command[1]) == false)
+                            {
+                                printf("Setting not changed \r\n");
+                            }
+                        }
+                        else if (APP_QUERY_Request(&appData.command[1]) == false)
+                        {
+                            printf("Download not started \r\n");
+                        }
+                    }
+                    else if (appData.commandLength < (APP_COMMAND_SIZE - 1U))
+                    {
+                        appData.command[appData.commandLength++] = (char)inChar;
+                    }
+                }
+                else if (inChar == '1')
                 {
                     appData.state = APP_STATE_READ_WEATHER;
                     /* request a read of the weather */
                     DRV_BME280_Read(appData.drvBME280);
                 }
+                else if (inChar == '4')
+                {
+                    APP_MEMORY_Report();
+                }
+                else if (inChar == '5')
+                {
+                    APP_I2CReport();
+                }
+                else if (inChar == '6')
+                {
+                    APP_IrqReport();
+                }
+                else if ((inChar == '2') || (inChar == '3'))
+                {
+                    appData.command[appData.commandLength++] = (char)inChar;
+                }
             }
             break;     
             
@@ -198,14 +402,18 @@ void APP_Tasks ( void )
             DRV_BME280_Get_Temperature(appData.drvBME280, &temperature);
             DRV_BME280_Get_Pressure(appData.drvBME280, &pressure);
             DRV_BME280_Get_Humidity(appData.drvBME280, &humidity);
+            DRV_BME280_Get_Timestamp(appData.drvBME280, &timestamp);
+            DRV_BME280_Get_PressureQ8(appData.drvBME280, &pressureQ8);
+            APP_METEO_Compute(temperature, pressureQ8, humidity, &derived);
+            APP_CONFIG_CounterAdd(APP_CONFIG_COUNTER_SAMPLES, 1);
             fTemperature = ((double) temperature) / 100.0f;
             fPressure = ((double) pressure) / 100.0f;
             fHumidity = ((double) humidity) / 1024.0f;
             //printf("%6ld\tTemperature = %6.2f\tPressure = %7.2f\tHumidity = %5.1f\r\n",
-            //        appData.sampleCount, fTemperature, fPressure, fHumidity);
+            //        APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_SAMPLES), fTemperature, fPressure, fHumidity);
             
             /* log the temperature if SD card is present */
-            APP_SDCARD_Notify(fTemperature, fPressure, fHumidity);
+            APP_SDCARD_Notify(APP_TIMESTAMP_CountToUS(timestamp), fTemperature, fPressure, fHumidity, &derived);
             appData.state = APP_STATE_IDLE;
             break;
 
@@ -216,6 +424,21 @@ void APP_Tasks ( void )
 }
 
 
+/******************************************************************************
+  Function:
+    bool APP_IsIdle ( void )
+
+  Remarks:
+    See prototype in app.h.
+ */
+
+bool APP_IsIdle ( void )
+{
+    /* A pending key press completes the USART read and wakes the core */
+    return (appData.state == APP_STATE_IDLE) && (SERCOM2_USART_ReadIsBusy() == true);
+}
+
+
 /*******************************************************************************
  End of File
  */
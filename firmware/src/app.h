@@ -33,6 +33,7 @@
 #include <stdlib.h>
 #include "configuration.h"
 #include "config/default/driver/driver_common.h"
+#include "system/time/sys_time.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -42,6 +43,15 @@ extern "C" {
 #endif
 // DOM-IGNORE-END
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+/* Longest console command line, "2 <from> <to>" with room for extra spaces */
+#define APP_COMMAND_SIZE    40U
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Type Definitions
@@ -89,8 +99,14 @@ typedef struct
     APP_STATES  state;
 
     DRV_HANDLE  drvBME280;
-    
-    uint32_t    sampleCount;
+
+    /* Periodic sample timer, and the period it runs with */
+    SYS_TIME_HANDLE sampleTimer;
+    uint32_t    samplePeriodMs;
+
+    /* Console command line being entered */
+    char        command[APP_COMMAND_SIZE];
+    uint32_t    commandLength;
 } APP_DATA;
 
 // *****************************************************************************
@@ -173,6 +189,42 @@ void APP_Initialize ( void );
 
 void APP_Tasks( void );
 
+
+/*******************************************************************************
+  Function:
+    bool APP_IsIdle ( void )
+
+  Summary:
+    Reports whether the application task is waiting for an event
+
+  Description:
+    The application is idle while it waits for a console key press, that is
+    when the BME280 has been opened and no read is in progress.
+
+  Precondition:
+    APP_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if the task has no work until the next interrupt or timer event.
+
+  Example:
+    <code>
+    if (APP_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task. Call it with interrupts disabled so that the
+    result cannot change before the device goes to sleep.
+ */
+
+bool APP_IsIdle( void );
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
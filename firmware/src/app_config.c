@@ -0,0 +1,426 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_config.c
+
+  Summary:
+    This file contains the source code for the settings and counters kept in
+    the SmartEEPROM.
+
+  Description:
+    The SmartEEPROM is allocated by the NVMCTRL_SEESBLK and NVMCTRL_SEEPSZ
+    fuses at the end of the flash, with 32 byte pages. It is used in buffered
+    mode: the words of a slot collect in the page buffer and are written to
+    the flash in one go when the buffer is flushed.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_config.h"
+#include "app_timestamp.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* "CFG1", changed when the slot layout changes */
+#define APP_CONFIG_SLOT_TAG         0x31474643U
+
+#define APP_CONFIG_SLOT_WORDS       (sizeof(APP_CONFIG_SLOT) / sizeof(uint32_t))
+#define APP_CONFIG_SLOTS            2U
+
+/* Slots at the start of the SmartEEPROM, one page each */
+#define APP_CONFIG_SLOT_ADDRESS(slot)   ((volatile uint32_t*)(SEEPROM_ADDR + ((slot) * sizeof(APP_CONFIG_SLOT))))
+
+/* Name, default and range of a setting */
+typedef struct
+{
+    const char* name;
+    uint32_t    defaultValue;
+    uint32_t    minValue;
+    uint32_t    maxValue;
+} APP_CONFIG_KEY_INFO;
+
+static const APP_CONFIG_KEY_INFO app_configKeys[APP_CONFIG_KEYS] =
+{
+    [APP_CONFIG_KEY_SAMPLE_PERIOD_MS] = { "period",       APP_CONFIG_SAMPLE_PERIOD_MS,      100U,  86400000U },
+    [APP_CONFIG_KEY_SYNC_RECORDS]     = { "sync_records", APP_SDCARD_JOURNAL_SYNC_RECORDS,  1U,    10000U },
+    [APP_CONFIG_KEY_SYNC_MS]          = { "sync_ms",      APP_SDCARD_JOURNAL_SYNC_MS,       1000U, 86400000U },
+};
+
+static const char* const app_configCounterNames[APP_CONFIG_COUNTERS] =
+{
+    [APP_CONFIG_COUNTER_SAMPLES] = "samples",
+    [APP_CONFIG_COUNTER_RESETS]  = "resets",
+};
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds settings data
+
+  Description:
+    This structure holds the settings' data.
+
+  Remarks:
+    This structure should be initialized by the APP_CONFIG_Initialize
+    function.
+*/
+
+APP_CONFIG_DATA app_configData;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t APP_CONFIG_Crc16(const uint8_t* data, size_t length)
+{
+    uint16_t crc = 0xFFFFU;
+    uint8_t bit;
+
+    while (length-- > 0U)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static uint32_t APP_CONFIG_SlotCrc(const APP_CONFIG_SLOT* slot)
+{
+    return APP_CONFIG_Crc16((const uint8_t*)slot, offsetof(APP_CONFIG_SLOT, crc));
+}
+
+/* Copy a slot out of the SmartEEPROM. Returns false if it is not valid. */
+static bool APP_CONFIG_SlotRead(uint32_t index, APP_CONFIG_SLOT* slot)
+{
+    volatile uint32_t* address = APP_CONFIG_SLOT_ADDRESS(index);
+    uint32_t* data = (uint32_t*)slot;
+    uint32_t word;
+
+    for (word = 0; word < APP_CONFIG_SLOT_WORDS; word++)
+    {
+        data[word] = address[word];
+    }
+
+    return ((slot->tag == APP_CONFIG_SLOT_TAG) && (slot->crc == APP_CONFIG_SlotCrc(slot)));
+}
+
+static bool APP_CONFIG_IsEnabled(void)
+{
+    return ((NVMCTRL_SmartEEPROMStatusGet() & NVMCTRL_SEESTAT_SBLK_Msk) != 0U);
+}
+
+/* Start saving the settings and counters in the older slot */
+static void APP_CONFIG_SaveStart(void)
+{
+    app_configData.slot.sequence++;
+    app_configData.save = app_configData.slot;
+    app_configData.save.crc = APP_CONFIG_SlotCrc(&app_configData.save);
+
+    app_configData.isValueChanged = false;
+    app_configData.isCounterChanged = false;
+    app_configData.saveTimeUs = APP_TIMESTAMP_US_Get();
+    app_configData.state = APP_CONFIG_STATE_SAVE;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_CONFIG_Initialize ( void )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+void APP_CONFIG_Initialize ( void )
+{
+    APP_CONFIG_SLOT slot;
+    uint32_t index;
+    uint32_t key;
+    bool isFound = false;
+
+    memset(&app_configData, 0, sizeof(app_configData));
+    app_configData.state = APP_CONFIG_STATE_DISABLED;
+
+    if (APP_CONFIG_IsEnabled() == true)
+    {
+        /* The words of a slot are written to the flash together */
+        NVMCTRL_REGS->NVMCTRL_SEECFG = NVMCTRL_SEECFG_WMODE_BUFFERED;
+
+        for (index = 0; index < APP_CONFIG_SLOTS; index++)
+        {
+            if ((APP_CONFIG_SlotRead(index, &slot) == true) &&
+                ((isFound == false) || ((int32_t)(slot.sequence - app_configData.slot.sequence) > 0)))
+            {
+                app_configData.slot = slot;
+                app_configData.slotIndex = (index + 1U) % APP_CONFIG_SLOTS;
+                isFound = true;
+            }
+        }
+
+        app_configData.state = APP_CONFIG_STATE_IDLE;
+    }
+
+    if (isFound == false)
+    {
+        memset(&app_configData.slot, 0, sizeof(app_configData.slot));
+        app_configData.slot.tag = APP_CONFIG_SLOT_TAG;
+    }
+
+    for (key = 0; key < APP_CONFIG_KEYS; key++)
+    {
+        if ((isFound == false) || (app_configData.slot.values[key] < app_configKeys[key].minValue) ||
+            (app_configData.slot.values[key] > app_configKeys[key].maxValue))
+        {
+            app_configData.slot.values[key] = app_configKeys[key].defaultValue;
+        }
+    }
+
+    app_configData.slot.counters[APP_CONFIG_COUNTER_RESETS]++;
+    app_configData.isValueChanged = true;
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_CONFIG_Tasks ( void )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+void APP_CONFIG_Tasks ( void )
+{
+    volatile uint32_t* address;
+    const uint32_t* data;
+    uint32_t word;
+
+    switch (app_configData.state)
+    {
+        case APP_CONFIG_STATE_IDLE:
+        {
+            if ((app_configData.isValueChanged == true) ||
+                ((app_configData.isCounterChanged == true) &&
+                 ((APP_TIMESTAMP_US_Get() - app_configData.saveTimeUs) >= (APP_CONFIG_COUNTER_SAVE_MS * 1000ULL))))
+            {
+                APP_CONFIG_SaveStart();
+            }
+            break;
+        }
+
+        case APP_CONFIG_STATE_SAVE:
+        {
+            /* The NVMCTRL runs one command at a time: the slot goes to the
+             * page buffer and is written between two commands of the flash
+             * log, which waits for the SmartEEPROM in turn. A write while
+             * the SmartEEPROM is busy would stall the bus. */
+            if ((NVMCTRL_IsBusy() == true) || (NVMCTRL_SmartEEPROM_IsBusy() == true))
+            {
+                break;
+            }
+
+            address = APP_CONFIG_SLOT_ADDRESS(app_configData.slotIndex);
+            data = (const uint32_t*)&app_configData.save;
+
+            for (word = 0; word < APP_CONFIG_SLOT_WORDS; word++)
+            {
+                address[word] = data[word];
+            }
+
+            NVMCTRL_SmartEEPROMFlushPageBuffer();
+
+            app_configData.slotIndex = (app_configData.slotIndex + 1U) % APP_CONFIG_SLOTS;
+            app_configData.state = APP_CONFIG_STATE_IDLE;
+            break;
+        }
+
+        case APP_CONFIG_STATE_DISABLED:
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_CONFIG_IsIdle ( void )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+bool APP_CONFIG_IsIdle ( void )
+{
+    if (app_configData.state == APP_CONFIG_STATE_DISABLED)
+    {
+        return true;
+    }
+
+    return ((app_configData.state == APP_CONFIG_STATE_IDLE) && (app_configData.isValueChanged == false) &&
+            (NVMCTRL_SmartEEPROM_IsBusy() == false));
+}
+
+
+/******************************************************************************
+  Function:
+    uint32_t APP_CONFIG_Get ( APP_CONFIG_KEY key )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+uint32_t APP_CONFIG_Get ( APP_CONFIG_KEY key )
+{
+    return app_configData.slot.values[key];
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_CONFIG_Set ( APP_CONFIG_KEY key, uint32_t value )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+bool APP_CONFIG_Set ( APP_CONFIG_KEY key, uint32_t value )
+{
+    if ((key >= APP_CONFIG_KEYS) || (value < app_configKeys[key].minValue) ||
+        (value > app_configKeys[key].maxValue))
+    {
+        return false;
+    }
+
+    if (app_configData.slot.values[key] != value)
+    {
+        app_configData.slot.values[key] = value;
+        app_configData.isValueChanged = true;
+    }
+
+    return true;
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_CONFIG_CounterAdd ( APP_CONFIG_COUNTER counter, uint32_t count )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+void APP_CONFIG_CounterAdd ( APP_CONFIG_COUNTER counter, uint32_t count )
+{
+    app_configData.slot.counters[counter] += count;
+    app_configData.isCounterChanged = true;
+}
+
+
+/******************************************************************************
+  Function:
+    uint32_t APP_CONFIG_CounterGet ( APP_CONFIG_COUNTER counter )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+uint32_t APP_CONFIG_CounterGet ( APP_CONFIG_COUNTER counter )
+{
+    return app_configData.slot.counters[counter];
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_CONFIG_Request ( const char* line )
+
+  Remarks:
+    See prototype in app_config.h.
+ */
+
+bool APP_CONFIG_Request ( const char* line )
+{
+    char* end;
+    uint32_t key;
+    uint32_t value;
+    size_t length;
+    bool isChanged = true;
+
+    while (*line == ' ')
+    {
+        line++;
+    }
+
+    if (*line != '\0')
+    {
+        length = strcspn(line, " ");
+
+        for (key = 0; key < APP_CONFIG_KEYS; key++)
+        {
+            if ((strlen(app_configKeys[key].name) == length) &&
+                (strncmp(app_configKeys[key].name, line, length) == 0))
+            {
+                break;
+            }
+        }
+
+        value = (uint32_t)strtoul(&line[length], &end, 10);
+
+        isChanged = ((key < APP_CONFIG_KEYS) && (end != &line[length]) &&
+                     (APP_CONFIG_Set((APP_CONFIG_KEY)key, value) == true));
+    }
+
+    for (key = 0; key < APP_CONFIG_KEYS; key++)
+    {
+        printf("%-14s %10lu  (%lu to %lu) \r\n", app_configKeys[key].name,
+               (unsigned long)app_configData.slot.values[key],
+               (unsigned long)app_configKeys[key].minValue, (unsigned long)app_configKeys[key].maxValue);
+    }
+
+    for (key = 0; key < APP_CONFIG_COUNTERS; key++)
+    {
+        printf("%-14s %10lu \r\n", app_configCounterNames[key], (unsigned long)app_configData.slot.counters[key]);
+    }
+
+    if (app_configData.state == APP_CONFIG_STATE_DISABLED)
+    {
+        printf("No SmartEEPROM allocated, settings are lost on reset \r\n");
+    }
+
+    return isChanged;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
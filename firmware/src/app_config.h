@@ -0,0 +1,459 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_config.h
+
+  Summary:
+    This header file provides prototypes and definitions for the settings
+    and counters kept in the SmartEEPROM.
+
+  Description:
+    The settings and counters are kept in RAM and saved in one of two slots
+    of the SmartEEPROM, in turn. Each slot is a SmartEEPROM page holding a
+    sequence number and a CRC, so a reset during a save leaves the other
+    slot intact, and the slot with the newest sequence is loaded at startup.
+
+    A changed setting is saved at once. Counters change often, so they are
+    saved with the next setting or after APP_CONFIG_COUNTER_SAVE_MS, at most.
+    A save is a single page write of the SmartEEPROM, through its page
+    buffer.
+
+    The console command
+
+        3 [<name> <value>]
+
+    changes a setting and prints the settings and counters.
+
+    The NVMCTRL_SEESBLK = 1 and NVMCTRL_SEEPSZ = 3 fuses of initialization.c
+    give the SmartEEPROM the last two blocks of bank B, from 0x000FC000. The
+    flash log of app_flashlog.h ends at 0x000E0000, below them, but both
+    are in bank B and the NVMCTRL runs one of their writes at a time: a save
+    waits for a flash log write or erase to end, and the flash log waits for
+    the page write of a save.
+
+    The fuses are in the user page, which neither a bootloader nor a
+    firmware update writes. A device programmed with the previous fuses,
+    without a SmartEEPROM, keeps running on the defaults and saves nothing
+    until its user page is programmed with these fuses by a programmer.
+    Its first start after that finds no valid slot: the defaults are loaded
+    and the counters start from 0.
+*******************************************************************************/
+
+#ifndef _APP_CONFIG_H
+#define _APP_CONFIG_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Settings states enumeration
+
+  Description:
+    This enumeration defines the valid settings states.
+*/
+
+typedef enum
+{
+    /* Wait for a change to save */
+    APP_CONFIG_STATE_IDLE,
+
+    /* Copy the slot to the page buffer, then write it */
+    APP_CONFIG_STATE_SAVE,
+
+    /* No SmartEEPROM is allocated; the settings are not kept */
+    APP_CONFIG_STATE_DISABLED,
+} APP_CONFIG_STATES;
+
+
+// *****************************************************************************
+/* Settings
+
+  Summary:
+    Settings kept in the SmartEEPROM
+*/
+
+typedef enum
+{
+    /* Time between two samples, in ms */
+    APP_CONFIG_KEY_SAMPLE_PERIOD_MS = 0,
+
+    /* SD card journal sync, in records and in ms */
+    APP_CONFIG_KEY_SYNC_RECORDS,
+    APP_CONFIG_KEY_SYNC_MS,
+
+    APP_CONFIG_KEYS
+} APP_CONFIG_KEY;
+
+
+// *****************************************************************************
+/* Counters
+
+  Summary:
+    Counters kept in the SmartEEPROM
+*/
+
+typedef enum
+{
+    /* Samples taken */
+    APP_CONFIG_COUNTER_SAMPLES = 0,
+
+    /* Starts of the firmware */
+    APP_CONFIG_COUNTER_RESETS,
+
+    APP_CONFIG_COUNTERS
+} APP_CONFIG_COUNTER;
+
+
+// *****************************************************************************
+/* Slot
+
+  Summary:
+    Settings and counters as saved in the SmartEEPROM
+
+  Description:
+    A slot fills one 32 byte SmartEEPROM page.
+*/
+
+typedef struct
+{
+    /* "CFG1", and the number of the save */
+    uint32_t    tag;
+    uint32_t    sequence;
+
+    uint32_t    values[APP_CONFIG_KEYS];
+    uint32_t    counters[APP_CONFIG_COUNTERS];
+
+    /* CRC-16/CCITT-FALSE of the words above */
+    uint32_t    crc;
+} APP_CONFIG_SLOT;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds settings data
+
+  Description:
+    This structure holds the settings' data.
+ */
+
+typedef struct
+{
+    /* Settings' current state */
+    APP_CONFIG_STATES   state;
+
+    /* Settings and counters in use, and the copy being saved */
+    APP_CONFIG_SLOT     slot;
+    APP_CONFIG_SLOT     save;
+
+    /* Slot written by the next save */
+    uint32_t            slotIndex;
+
+    /* Changes not saved yet */
+    bool                isValueChanged;
+    bool                isCounterChanged;
+
+    /* APP_TIMESTAMP time of the last save, in microseconds */
+    uint64_t            saveTimeUs;
+} APP_CONFIG_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_CONFIG_Initialize ( void )
+
+  Summary:
+     Settings initialization routine.
+
+  Description:
+    This function loads the newest valid slot of the SmartEEPROM, or the
+    default settings if there is none, and counts the start.
+
+  Precondition:
+    NVMCTRL_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_CONFIG_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function, before
+    the initialization of the tasks that use the settings.
+*/
+
+void APP_CONFIG_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_CONFIG_Tasks ( void )
+
+  Summary:
+    Settings tasks function
+
+  Description:
+    Saves the settings and counters when they have changed.
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_CONFIG_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine.
+ */
+
+void APP_CONFIG_Tasks( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_CONFIG_IsIdle ( void )
+
+  Summary:
+    Reports whether the settings are waiting for an event
+
+  Description:
+    The settings are busy while a changed setting is not saved yet. Counters
+    waiting for their next save do not keep the device awake.
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if nothing has to be saved now.
+
+  Example:
+    <code>
+    if (APP_CONFIG_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task.
+ */
+
+bool APP_CONFIG_IsIdle( void );
+
+
+/*******************************************************************************
+  Function:
+    uint32_t APP_CONFIG_Get ( APP_CONFIG_KEY key )
+
+  Summary:
+    Returns a setting
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    key - Setting to return
+
+  Returns:
+    The value of the setting.
+
+  Example:
+    <code>
+    period = APP_CONFIG_Get(APP_CONFIG_KEY_SAMPLE_PERIOD_MS);
+    </code>
+
+  Remarks:
+    None.
+ */
+
+uint32_t APP_CONFIG_Get( APP_CONFIG_KEY key );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_CONFIG_Set ( APP_CONFIG_KEY key, uint32_t value )
+
+  Summary:
+    Changes a setting
+
+  Description:
+    The setting is used at once and saved by APP_CONFIG_Tasks.
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    key   - Setting to change
+    value - New value
+
+  Returns:
+    false if the value is outside the range of the setting.
+
+  Example:
+    <code>
+    APP_CONFIG_Set(APP_CONFIG_KEY_SAMPLE_PERIOD_MS, 10000);
+    </code>
+
+  Remarks:
+    None.
+ */
+
+bool APP_CONFIG_Set( APP_CONFIG_KEY key, uint32_t value );
+
+
+/*******************************************************************************
+  Function:
+    void APP_CONFIG_CounterAdd ( APP_CONFIG_COUNTER counter, uint32_t count )
+
+  Summary:
+    Adds to a counter
+
+  Description:
+    The counter is saved with the next save.
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    counter - Counter to add to
+    count   - Number to add
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_CONFIG_CounterAdd(APP_CONFIG_COUNTER_SAMPLES, 1);
+    </code>
+
+  Remarks:
+    Not to be called from an interrupt.
+ */
+
+void APP_CONFIG_CounterAdd( APP_CONFIG_COUNTER counter, uint32_t count );
+
+
+/*******************************************************************************
+  Function:
+    uint32_t APP_CONFIG_CounterGet ( APP_CONFIG_COUNTER counter )
+
+  Summary:
+    Returns a counter
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    counter - Counter to return
+
+  Returns:
+    The value of the counter.
+
+  Example:
+    <code>
+    printf("%lu samples \r\n", (unsigned long)APP_CONFIG_CounterGet(APP_CONFIG_COUNTER_SAMPLES));
+    </code>
+
+  Remarks:
+    None.
+ */
+
+uint32_t APP_CONFIG_CounterGet( APP_CONFIG_COUNTER counter );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_CONFIG_Request ( const char* line )
+
+  Summary:
+    Runs the settings console command
+
+  Description:
+    Changes the setting named in the line, if any, then prints the settings
+    and counters.
+
+  Precondition:
+    APP_CONFIG_Initialize should have been called.
+
+  Parameters:
+    line - "<name> <value>", or an empty line to only print them
+
+  Returns:
+    false if the name is not known or the value is not valid.
+
+  Example:
+    <code>
+    if (APP_CONFIG_Request("period 10000") == false)
+    {
+        printf("Setting not changed \r\n");
+    }
+    </code>
+
+  Remarks:
+    None.
+ */
+
+bool APP_CONFIG_Request( const char* line );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_CONFIG_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,236 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_dmabuf.c
+
+  Summary:
+    This file contains the source code for the DMA buffer pool.
+
+  Description:
+    The pool is a single cache aligned array. A buffer is a range of it,
+    recorded in a small table, and a new buffer goes in the first gap that
+    fits, so buffers that are released and acquired again during a download
+    do not fragment the pool.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include "app_dmabuf.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_DMABUF_POOL_LENGTH      ((uint32_t)CACHE_ALIGNED_SIZE_GET(APP_DMABUF_POOL_SIZE))
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds the pool data
+
+  Description:
+    This structure holds the pool's data.
+
+  Remarks:
+    This structure should be initialized by the APP_DMABUF_Initialize function.
+*/
+
+APP_DMABUF_DATA app_dmabufData;
+
+static uint8_t CACHE_ALIGN app_dmabufPool[APP_DMABUF_POOL_LENGTH];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Whether a range of the pool overlaps no buffer in use */
+static bool APP_DMABUF_IsFree(uint32_t offset, uint32_t length)
+{
+    const APP_DMABUF_BUFFER* buffer;
+    uint32_t i;
+
+    if (length > (APP_DMABUF_POOL_LENGTH - offset))
+    {
+        return false;
+    }
+
+    for (i = 0; i < APP_DMABUF_BUFFERS; i++)
+    {
+        buffer = &app_dmabufData.buffers[i];
+
+        if ((buffer->isUsed == true) && (offset < (buffer->offset + buffer->length)) &&
+            (buffer->offset < (offset + length)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and Buffer Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_DMABUF_Initialize ( void )
+
+  Remarks:
+    See prototype in app_dmabuf.h.
+ */
+
+void APP_DMABUF_Initialize ( void )
+{
+    uint32_t i;
+
+    for (i = 0; i < APP_DMABUF_BUFFERS; i++)
+    {
+        app_dmabufData.buffers[i].isUsed = false;
+    }
+
+    app_dmabufData.usedLength = 0;
+    app_dmabufData.peakLength = 0;
+}
+
+
+/******************************************************************************
+  Function:
+    void* APP_DMABUF_Acquire ( size_t size )
+
+  Remarks:
+    See prototype in app_dmabuf.h.
+ */
+
+void* APP_DMABUF_Acquire( size_t size )
+{
+    APP_DMABUF_BUFFER* entry = NULL;
+    const APP_DMABUF_BUFFER* buffer;
+    uint32_t length;
+    uint32_t offset;
+    uint32_t i;
+
+    if ((size == 0U) || (size > APP_DMABUF_POOL_LENGTH))
+    {
+        return NULL;
+    }
+
+    length = (uint32_t)CACHE_ALIGNED_SIZE_GET(size);
+
+    for (i = 0; i < APP_DMABUF_BUFFERS; i++)
+    {
+        if (app_dmabufData.buffers[i].isUsed == false)
+        {
+            entry = &app_dmabufData.buffers[i];
+            break;
+        }
+    }
+
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+
+    /* The first gap starts at the pool or right after a buffer */
+    offset = 0;
+
+    if (APP_DMABUF_IsFree(offset, length) == false)
+    {
+        offset = APP_DMABUF_POOL_LENGTH;
+
+        for (i = 0; i < APP_DMABUF_BUFFERS; i++)
+        {
+            buffer = &app_dmabufData.buffers[i];
+
+            if ((buffer->isUsed == true) && ((buffer->offset + buffer->length) < offset) &&
+                (APP_DMABUF_IsFree(buffer->offset + buffer->length, length) == true))
+            {
+                offset = buffer->offset + buffer->length;
+            }
+        }
+
+        if (offset == APP_DMABUF_POOL_LENGTH)
+        {
+            return NULL;
+        }
+    }
+
+    entry->offset = offset;
+    entry->length = length;
+    entry->isUsed = true;
+
+    app_dmabufData.usedLength += length;
+    if (app_dmabufData.usedLength > app_dmabufData.peakLength)
+    {
+        app_dmabufData.peakLength = app_dmabufData.usedLength;
+    }
+
+    return &app_dmabufPool[offset];
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_DMABUF_Release ( void* buffer )
+
+  Remarks:
+    See prototype in app_dmabuf.h.
+ */
+
+void APP_DMABUF_Release( void* buffer )
+{
+    uint32_t i;
+
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < APP_DMABUF_BUFFERS; i++)
+    {
+        if ((app_dmabufData.buffers[i].isUsed == true) &&
+            (&app_dmabufPool[app_dmabufData.buffers[i].offset] == (uint8_t*)buffer))
+        {
+            app_dmabufData.buffers[i].isUsed = false;
+            app_dmabufData.usedLength -= app_dmabufData.buffers[i].length;
+            return;
+        }
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_DMABUF_Report ( void )
+
+  Remarks:
+    See prototype in app_dmabuf.h.
+ */
+
+void APP_DMABUF_Report( void )
+{
+    printf("DMA buffers: %lu of %lu bytes in use, peak %lu \r\n",
+           (unsigned long)app_dmabufData.usedLength, (unsigned long)APP_DMABUF_POOL_LENGTH,
+           (unsigned long)app_dmabufData.peakLength);
+}
+
+
+/*******************************************************************************
+ End of File
+ */
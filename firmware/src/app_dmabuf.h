@@ -0,0 +1,231 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_dmabuf.h
+
+  Summary:
+    This header file provides prototypes and definitions for the DMA buffer
+    pool.
+
+  Description:
+    Buffers that the SDHC reads or writes by DMA are taken from a pool in
+    SRAM. Each buffer starts on a cache line and is a whole number of cache
+    lines long.
+
+    The buffers need no cache maintenance around a transfer: the CMCC only
+    caches the code region, the flash and the QSPI memory, never the SRAM.
+    SYS_Initialize can therefore enable the data cache, as SYS_DCACHE_ENABLE
+    sets. The one coherency hazard it brings is the flash log reading back
+    flash the NVMCTRL has just written or erased; app_flashlog.c invalidates
+    the lines it reads after such a write.
+*******************************************************************************/
+
+#ifndef _APP_DMABUF_H
+#define _APP_DMABUF_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Buffer
+
+  Summary:
+    Part of the pool handed out by APP_DMABUF_Acquire
+*/
+
+typedef struct
+{
+    /* Offset and length in the pool, in bytes, whole cache lines */
+    uint32_t    offset;
+    uint32_t    length;
+
+    /* The buffer has been acquired and not released */
+    bool        isUsed;
+} APP_DMABUF_BUFFER;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds the pool data
+
+  Description:
+    This structure holds the pool's data.
+ */
+
+typedef struct
+{
+    APP_DMABUF_BUFFER   buffers[APP_DMABUF_BUFFERS];
+
+    /* Bytes of the pool in use, and the most ever in use */
+    uint32_t            usedLength;
+    uint32_t            peakLength;
+} APP_DMABUF_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and Buffer Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_DMABUF_Initialize ( void )
+
+  Summary:
+     DMA buffer pool initialization routine.
+
+  Description:
+    This function releases every buffer of the pool.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_DMABUF_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function, before
+    the initialization of the tasks that acquire buffers.
+*/
+
+void APP_DMABUF_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void* APP_DMABUF_Acquire ( size_t size )
+
+  Summary:
+    Takes a buffer from the pool
+
+  Description:
+    The buffer is the first free part of the pool that is large enough. It
+    belongs to the CPU.
+
+  Precondition:
+    APP_DMABUF_Initialize should have been called.
+
+  Parameters:
+    size - Bytes needed, rounded up to whole cache lines
+
+  Returns:
+    The cache line aligned buffer, or NULL if the pool has no room for it.
+
+  Example:
+    <code>
+    buffer = APP_DMABUF_Acquire(APP_SDCARD_LOG_BUFFER_SIZE);
+    </code>
+
+  Remarks:
+    Not to be called from an interrupt.
+ */
+
+void* APP_DMABUF_Acquire( size_t size );
+
+
+/*******************************************************************************
+  Function:
+    void APP_DMABUF_Release ( void* buffer )
+
+  Summary:
+    Gives a buffer back to the pool
+
+  Precondition:
+    The buffer was returned by APP_DMABUF_Acquire and belongs to the CPU.
+
+  Parameters:
+    buffer - Buffer to release. NULL is ignored.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_DMABUF_Release(buffer);
+    buffer = NULL;
+    </code>
+
+  Remarks:
+    Not to be called from an interrupt.
+ */
+
+void APP_DMABUF_Release( void* buffer );
+
+
+/*******************************************************************************
+  Function:
+    void APP_DMABUF_Report ( void )
+
+  Summary:
+    Prints the use of the pool
+
+  Description:
+    Bytes in use, size of the pool and the most ever in use.
+
+  Precondition:
+    APP_DMABUF_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_DMABUF_Report();
+    </code>
+
+  Remarks:
+    Part of the memory report.
+ */
+
+void APP_DMABUF_Report( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_DMABUF_H */
+
+/*******************************************************************************
+ End of File
+ */
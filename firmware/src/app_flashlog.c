@@ -0,0 +1,645 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_flashlog.c
+
+  Summary:
+    This file contains the source code for the internal flash log.
+
+  Description:
+    The flash is only written in quad words, through NVMCTRL_QuadWordWrite,
+    and erased a block at a time. Each task call starts at most one
+    operation and returns while the NVMCTRL runs it. The ring is placed in
+    the second flash bank, so the program keeps running from the first one
+    during an erase.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include "app_flashlog.h"
+#include "peripheral/nvmctrl/plib_nvmctrl.h"
+#include "device_cache.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_FLASHLOG_QUAD_WORD_SIZE     16U
+
+/* Layout of a block: header, drained mark, then records */
+#define APP_FLASHLOG_HEADER_OFFSET      0U
+#define APP_FLASHLOG_MARK_OFFSET        16U
+#define APP_FLASHLOG_RECORD_OFFSET      32U
+
+/* First words of the header and of the drained mark, "FLOG" and "DRND" */
+#define APP_FLASHLOG_HEADER_TAG         0x474F4C46U
+#define APP_FLASHLOG_MARK_TAG           0x444E5244U
+
+#define APP_FLASHLOG_NVM_ERRORS         (NVMCTRL_INTFLAG_ADDRE_Msk | NVMCTRL_INTFLAG_PROGE_Msk | \
+                                         NVMCTRL_INTFLAG_LOCKE_Msk | NVMCTRL_INTFLAG_NVME_Msk)
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds flash log data
+
+  Description:
+    This structure holds the flash log's data.
+
+  Remarks:
+    This structure should be initialized by the APP_FLASHLOG_Initialize
+    function.
+*/
+
+APP_FLASHLOG_DATA app_flashlogData;
+
+/* What is known of each block of the ring */
+static APP_FLASHLOG_BLOCK app_flashlogBlocks[APP_FLASHLOG_BLOCKS];
+
+/* Records waiting for the flash */
+static APP_FLASHLOG_RECORD app_flashlogQueue[APP_FLASHLOG_QUEUE_RECORDS];
+
+/* The flash written or erased since the data cache was last invalidated,
+ * from app_flashlogStaleStart up to app_flashlogStaleEnd */
+static bool app_flashlogIsCacheStale = false;
+static uint32_t app_flashlogStaleStart;
+static uint32_t app_flashlogStaleEnd;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint32_t APP_FLASHLOG_BlockAddress(uint32_t block)
+{
+    return APP_FLASHLOG_ADDRESS + (block * NVMCTRL_FLASH_BLOCKSIZE);
+}
+
+static uint32_t APP_FLASHLOG_BlockNext(uint32_t block)
+{
+    return ((block + 1U) == APP_FLASHLOG_BLOCKS) ? 0U : (block + 1U);
+}
+
+/* Add the flash about to be written or erased to the range to invalidate */
+static void APP_FLASHLOG_CacheStale(uint32_t address, uint32_t size)
+{
+    if (app_flashlogIsCacheStale == false)
+    {
+        app_flashlogStaleStart = address;
+        app_flashlogStaleEnd = address + size;
+        app_flashlogIsCacheStale = true;
+        return;
+    }
+
+    if (address < app_flashlogStaleStart)
+    {
+        app_flashlogStaleStart = address;
+    }
+
+    if ((address + size) > app_flashlogStaleEnd)
+    {
+        app_flashlogStaleEnd = address + size;
+    }
+}
+
+static void APP_FLASHLOG_QuadWordRead(uint32_t address, uint32_t* data)
+{
+    /* The CMCC data cache may hold the flash as it was before the last
+     * writes or erase. The lines stay stale until the NVMCTRL is done. */
+    if (app_flashlogIsCacheStale == true)
+    {
+        DCACHE_INVALIDATE_BY_ADDR(app_flashlogStaleStart, app_flashlogStaleEnd - app_flashlogStaleStart);
+        app_flashlogIsCacheStale = NVMCTRL_IsBusy();
+    }
+
+    NVMCTRL_Read(data, APP_FLASHLOG_QUAD_WORD_SIZE, address);
+}
+
+static bool APP_FLASHLOG_IsBlank(const uint32_t* data)
+{
+    return ((data[0] & data[1] & data[2] & data[3]) == 0xFFFFFFFFU);
+}
+
+/* Write a header or a mark: tag, sequence number, value and check word */
+static void APP_FLASHLOG_TagWrite(uint32_t address, uint32_t tag, uint32_t sequence, uint32_t value)
+{
+    uint32_t data[4];
+
+    data[0] = tag;
+    data[1] = sequence;
+    data[2] = value;
+    data[3] = ~(tag ^ sequence ^ value);
+
+    NVMCTRL_QuadWordWrite(data, address);
+    APP_FLASHLOG_CacheStale(address, APP_FLASHLOG_QUAD_WORD_SIZE);
+}
+
+static bool APP_FLASHLOG_TagCheck(const uint32_t* data, uint32_t tag)
+{
+    return ((data[0] == tag) && (data[3] == ~(data[0] ^ data[1] ^ data[2])));
+}
+
+static uint16_t APP_FLASHLOG_Crc16(const uint8_t* data, size_t length)
+{
+    uint16_t crc = 0xFFFFU;
+    uint8_t bit;
+
+    while (length-- > 0U)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static uint16_t APP_FLASHLOG_RecordCrc(const APP_FLASHLOG_RECORD* record)
+{
+    return APP_FLASHLOG_Crc16((const uint8_t*)record, offsetof(APP_FLASHLOG_RECORD, crc));
+}
+
+/* Whether every record written has been read. The tail may still be at the
+ * end of the block before the head. */
+static bool APP_FLASHLOG_IsReadEnd(void)
+{
+    uint32_t block = app_flashlogData.tailBlock;
+    uint32_t offset = app_flashlogData.tailOffset;
+
+    if ((offset >= NVMCTRL_FLASH_BLOCKSIZE) && (block != app_flashlogData.headBlock))
+    {
+        block = APP_FLASHLOG_BlockNext(block);
+        offset = APP_FLASHLOG_RECORD_OFFSET;
+    }
+
+    return ((block == app_flashlogData.headBlock) && (offset >= app_flashlogData.headOffset));
+}
+
+/* Erase the block after the head for the next records. If it holds records
+ * not yet read, the ring is full and they are lost. */
+static void APP_FLASHLOG_BlockStart(void)
+{
+    uint32_t block = APP_FLASHLOG_BlockNext(app_flashlogData.headBlock);
+
+    /* A tail at the end of a block stands for the start of the next one */
+    if ((app_flashlogData.tailOffset >= NVMCTRL_FLASH_BLOCKSIZE) &&
+        (app_flashlogData.tailBlock != app_flashlogData.headBlock))
+    {
+        if (app_flashlogBlocks[app_flashlogData.tailBlock].state == APP_FLASHLOG_BLOCK_DATA)
+        {
+            app_flashlogBlocks[app_flashlogData.tailBlock].state = APP_FLASHLOG_BLOCK_READ;
+        }
+
+        app_flashlogData.tailBlock = APP_FLASHLOG_BlockNext(app_flashlogData.tailBlock);
+        app_flashlogData.tailOffset = APP_FLASHLOG_RECORD_OFFSET;
+    }
+
+    if ((app_flashlogData.tailBlock == block) && (APP_FLASHLOG_IsReadEnd() == false))
+    {
+        app_flashlogData.overwriteCount++;
+        app_flashlogData.tailBlock = APP_FLASHLOG_BlockNext(block);
+        app_flashlogData.tailOffset = APP_FLASHLOG_RECORD_OFFSET;
+    }
+
+    app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_DATA;
+    app_flashlogBlocks[block].sequence = app_flashlogData.sequence++;
+    app_flashlogBlocks[block].eraseCount++;
+
+    app_flashlogData.headBlock = block;
+    app_flashlogData.headOffset = APP_FLASHLOG_RECORD_OFFSET;
+
+    NVMCTRL_BlockErase(APP_FLASHLOG_BlockAddress(block));
+    APP_FLASHLOG_CacheStale(APP_FLASHLOG_BlockAddress(block), NVMCTRL_FLASH_BLOCKSIZE);
+
+    app_flashlogData.state = APP_FLASHLOG_STATE_ERASE;
+}
+
+/* Write the drained mark of one released block. Returns false if there is
+ * none. */
+static bool APP_FLASHLOG_MarkWrite(void)
+{
+    uint32_t block;
+
+    for (block = 0; block < APP_FLASHLOG_BLOCKS; block++)
+    {
+        if (app_flashlogBlocks[block].state == APP_FLASHLOG_BLOCK_RELEASE)
+        {
+            APP_FLASHLOG_TagWrite(APP_FLASHLOG_BlockAddress(block) + APP_FLASHLOG_MARK_OFFSET,
+                                  APP_FLASHLOG_MARK_TAG, app_flashlogBlocks[block].sequence, 0);
+
+            app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_DRAINED;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_FLASHLOG_Initialize ( void )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+void APP_FLASHLOG_Initialize ( void )
+{
+    uint32_t data[4];
+    uint32_t block;
+    uint32_t address;
+    uint32_t eraseCountMax = 0;
+    uint32_t newestSequence = 0;
+    uint32_t newestBlock = 0;
+    bool isFound = false;
+    uint32_t i;
+
+    memset(&app_flashlogData, 0, sizeof(app_flashlogData));
+    app_flashlogData.state = APP_FLASHLOG_STATE_READY;
+
+    /* The newest block has the highest sequence number */
+    for (block = 0; block < APP_FLASHLOG_BLOCKS; block++)
+    {
+        address = APP_FLASHLOG_BlockAddress(block);
+        APP_FLASHLOG_QuadWordRead(address + APP_FLASHLOG_HEADER_OFFSET, data);
+
+        if (APP_FLASHLOG_TagCheck(data, APP_FLASHLOG_HEADER_TAG) == false)
+        {
+            app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_FREE;
+            continue;
+        }
+
+        app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_DATA;
+        app_flashlogBlocks[block].sequence = data[1];
+        app_flashlogBlocks[block].eraseCount = data[2];
+
+        if (data[2] > eraseCountMax)
+        {
+            eraseCountMax = data[2];
+        }
+
+        if ((isFound == false) || ((int32_t)(data[1] - newestSequence) > 0))
+        {
+            newestSequence = data[1];
+            newestBlock = block;
+            isFound = true;
+        }
+
+        /* The mark is only written once the records are on the card, so a
+         * mark cut short by a reset counts as well */
+        APP_FLASHLOG_QuadWordRead(address + APP_FLASHLOG_MARK_OFFSET, data);
+
+        if (APP_FLASHLOG_IsBlank(data) == false)
+        {
+            app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_DRAINED;
+        }
+    }
+
+    /* The erase count of a block without a header is not known. Take the
+     * highest one, so that it is not under counted. */
+    for (block = 0; block < APP_FLASHLOG_BLOCKS; block++)
+    {
+        if (app_flashlogBlocks[block].state == APP_FLASHLOG_BLOCK_FREE)
+        {
+            app_flashlogBlocks[block].eraseCount = eraseCountMax;
+        }
+    }
+
+    if (isFound == false)
+    {
+        /* Blank ring: the first record erases block 0 */
+        app_flashlogData.headBlock = APP_FLASHLOG_BLOCKS - 1U;
+        app_flashlogData.headOffset = NVMCTRL_FLASH_BLOCKSIZE;
+        app_flashlogData.tailBlock = app_flashlogData.headBlock;
+        app_flashlogData.tailOffset = app_flashlogData.headOffset;
+        return;
+    }
+
+    app_flashlogData.sequence = newestSequence + 1U;
+    app_flashlogData.headBlock = newestBlock;
+    block = newestBlock;
+
+    /* The log ends at the first blank quad word of the newest block. A
+     * drained block is not written again. */
+    app_flashlogData.headOffset = NVMCTRL_FLASH_BLOCKSIZE;
+
+    if (app_flashlogBlocks[block].state != APP_FLASHLOG_BLOCK_DRAINED)
+    {
+        address = APP_FLASHLOG_BlockAddress(block);
+
+        for (i = APP_FLASHLOG_RECORD_OFFSET; i < NVMCTRL_FLASH_BLOCKSIZE; i += APP_FLASHLOG_QUAD_WORD_SIZE)
+        {
+            APP_FLASHLOG_QuadWordRead(address + i, data);
+
+            if (APP_FLASHLOG_IsBlank(data) == true)
+            {
+                app_flashlogData.headOffset = i;
+                break;
+            }
+        }
+    }
+
+    /* Reading starts at the oldest block not drained, or at the head */
+    app_flashlogData.tailBlock = app_flashlogData.headBlock;
+    app_flashlogData.tailOffset = app_flashlogData.headOffset;
+
+    for (i = 1; i <= APP_FLASHLOG_BLOCKS; i++)
+    {
+        block = (app_flashlogData.headBlock + i) % APP_FLASHLOG_BLOCKS;
+
+        if (app_flashlogBlocks[block].state == APP_FLASHLOG_BLOCK_DATA)
+        {
+            app_flashlogData.tailBlock = block;
+            app_flashlogData.tailOffset = APP_FLASHLOG_RECORD_OFFSET;
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_FLASHLOG_Tasks ( void )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+void APP_FLASHLOG_Tasks ( void )
+{
+    uint32_t data[4];
+
+    /* The NVMCTRL runs one command at a time, the SmartEEPROM writes of
+     * APP_CONFIG among them */
+    if ((app_flashlogData.state == APP_FLASHLOG_STATE_ERROR) || (NVMCTRL_IsBusy() == true) ||
+        (NVMCTRL_SmartEEPROM_IsBusy() == true))
+    {
+        return;
+    }
+
+    if ((NVMCTRL_ErrorGet() & APP_FLASHLOG_NVM_ERRORS) != 0U)
+    {
+        printf("Flash log error, records are no longer stored \r\n");
+        app_flashlogData.state = APP_FLASHLOG_STATE_ERROR;
+        return;
+    }
+
+    switch (app_flashlogData.state)
+    {
+        case APP_FLASHLOG_STATE_ERASE:
+        {
+            APP_FLASHLOG_TagWrite(APP_FLASHLOG_BlockAddress(app_flashlogData.headBlock) + APP_FLASHLOG_HEADER_OFFSET,
+                                  APP_FLASHLOG_HEADER_TAG, app_flashlogBlocks[app_flashlogData.headBlock].sequence,
+                                  app_flashlogBlocks[app_flashlogData.headBlock].eraseCount);
+
+            app_flashlogData.state = APP_FLASHLOG_STATE_READY;
+            break;
+        }
+
+        case APP_FLASHLOG_STATE_READY:
+        {
+            /* Marks go first, so that none is left for a block about to be
+             * erased */
+            if ((APP_FLASHLOG_MarkWrite() == true) || (app_flashlogData.queueCount == 0U))
+            {
+                break;
+            }
+
+            if (app_flashlogData.headOffset >= NVMCTRL_FLASH_BLOCKSIZE)
+            {
+                APP_FLASHLOG_BlockStart();
+                break;
+            }
+
+            memcpy(data, &app_flashlogQueue[app_flashlogData.queueOut], sizeof(data));
+            NVMCTRL_QuadWordWrite(data, APP_FLASHLOG_BlockAddress(app_flashlogData.headBlock) +
+                                  app_flashlogData.headOffset);
+            APP_FLASHLOG_CacheStale(APP_FLASHLOG_BlockAddress(app_flashlogData.headBlock) +
+                                    app_flashlogData.headOffset, APP_FLASHLOG_QUAD_WORD_SIZE);
+
+            app_flashlogData.headOffset += APP_FLASHLOG_QUAD_WORD_SIZE;
+            app_flashlogData.queueOut = (app_flashlogData.queueOut + 1U) % APP_FLASHLOG_QUEUE_RECORDS;
+            app_flashlogData.queueCount--;
+            app_flashlogData.writeCount++;
+            break;
+        }
+
+        case APP_FLASHLOG_STATE_ERROR:
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_FLASHLOG_IsIdle ( void )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+bool APP_FLASHLOG_IsIdle ( void )
+{
+    uint32_t block;
+
+    if (app_flashlogData.state == APP_FLASHLOG_STATE_ERROR)
+    {
+        return true;
+    }
+
+    if ((app_flashlogData.state != APP_FLASHLOG_STATE_READY) || (app_flashlogData.queueCount > 0U) ||
+        (NVMCTRL_IsBusy() == true))
+    {
+        return false;
+    }
+
+    for (block = 0; block < APP_FLASHLOG_BLOCKS; block++)
+    {
+        if (app_flashlogBlocks[block].state == APP_FLASHLOG_BLOCK_RELEASE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_FLASHLOG_Write ( APP_FLASHLOG_RECORD* record )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+bool APP_FLASHLOG_Write ( APP_FLASHLOG_RECORD* record )
+{
+    if ((app_flashlogData.state == APP_FLASHLOG_STATE_ERROR) ||
+        (app_flashlogData.queueCount == APP_FLASHLOG_QUEUE_RECORDS))
+    {
+        app_flashlogData.droppedCount++;
+        return false;
+    }
+
+    record->crc = APP_FLASHLOG_RecordCrc(record);
+
+    app_flashlogQueue[app_flashlogData.queueIn] = *record;
+    app_flashlogData.queueIn = (app_flashlogData.queueIn + 1U) % APP_FLASHLOG_QUEUE_RECORDS;
+    app_flashlogData.queueCount++;
+
+    return true;
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_FLASHLOG_Read ( APP_FLASHLOG_RECORD* record, bool isConsumed )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+bool APP_FLASHLOG_Read ( APP_FLASHLOG_RECORD* record, bool isConsumed )
+{
+    uint32_t tailBlock = app_flashlogData.tailBlock;
+    uint32_t tailOffset = app_flashlogData.tailOffset;
+    uint32_t data[4];
+    bool isFound = false;
+
+    while ((app_flashlogData.tailBlock != app_flashlogData.headBlock) ||
+           (app_flashlogData.tailOffset < app_flashlogData.headOffset))
+    {
+        if (app_flashlogData.tailOffset >= NVMCTRL_FLASH_BLOCKSIZE)
+        {
+            if ((isConsumed == true) &&
+                (app_flashlogBlocks[app_flashlogData.tailBlock].state == APP_FLASHLOG_BLOCK_DATA))
+            {
+                app_flashlogBlocks[app_flashlogData.tailBlock].state = APP_FLASHLOG_BLOCK_READ;
+            }
+
+            app_flashlogData.tailBlock = APP_FLASHLOG_BlockNext(app_flashlogData.tailBlock);
+            app_flashlogData.tailOffset = APP_FLASHLOG_RECORD_OFFSET;
+            continue;
+        }
+
+        APP_FLASHLOG_QuadWordRead(APP_FLASHLOG_BlockAddress(app_flashlogData.tailBlock) +
+                                  app_flashlogData.tailOffset, data);
+
+        if (APP_FLASHLOG_IsBlank(data) == true)
+        {
+            /* The end of a block closed before it was full */
+            app_flashlogData.tailOffset = NVMCTRL_FLASH_BLOCKSIZE;
+            continue;
+        }
+
+        app_flashlogData.tailOffset += APP_FLASHLOG_QUAD_WORD_SIZE;
+        memcpy(record, data, sizeof(data));
+
+        if (record->crc == APP_FLASHLOG_RecordCrc(record))
+        {
+            isFound = true;
+            break;
+        }
+
+        if (isConsumed == true)
+        {
+            /* Written when the power failed */
+            app_flashlogData.invalidCount++;
+        }
+    }
+
+    if (isConsumed == false)
+    {
+        app_flashlogData.tailBlock = tailBlock;
+        app_flashlogData.tailOffset = tailOffset;
+    }
+    else if (isFound == true)
+    {
+        app_flashlogData.readCount++;
+    }
+
+    return isFound;
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_FLASHLOG_Release ( void )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+void APP_FLASHLOG_Release ( void )
+{
+    uint32_t block;
+
+    for (block = 0; block < APP_FLASHLOG_BLOCKS; block++)
+    {
+        if (app_flashlogBlocks[block].state == APP_FLASHLOG_BLOCK_READ)
+        {
+            app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_RELEASE;
+        }
+    }
+
+    /* Close the newest block once all its records are read and none is
+     * queued. The records that follow start the next block. */
+    block = app_flashlogData.headBlock;
+
+    if ((app_flashlogBlocks[block].state == APP_FLASHLOG_BLOCK_DATA) &&
+        (app_flashlogData.state == APP_FLASHLOG_STATE_READY) && (app_flashlogData.queueCount == 0U) &&
+        (app_flashlogData.headOffset > APP_FLASHLOG_RECORD_OFFSET) && (APP_FLASHLOG_IsReadEnd() == true))
+    {
+        app_flashlogBlocks[block].state = APP_FLASHLOG_BLOCK_RELEASE;
+        app_flashlogData.headOffset = NVMCTRL_FLASH_BLOCKSIZE;
+        app_flashlogData.tailBlock = block;
+        app_flashlogData.tailOffset = NVMCTRL_FLASH_BLOCKSIZE;
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_FLASHLOG_IsEmpty ( void )
+
+  Remarks:
+    See prototype in app_flashlog.h.
+ */
+
+bool APP_FLASHLOG_IsEmpty ( void )
+{
+    return ((app_flashlogData.queueCount == 0U) && (APP_FLASHLOG_IsReadEnd() == true));
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,465 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_flashlog.h
+
+  Summary:
+    This header file provides prototypes and definitions for the internal
+    flash log.
+
+  Description:
+    Samples taken while no SD card is mounted are kept in a ring of
+    APP_FLASHLOG_BLOCKS erase blocks of the internal flash, starting at
+    APP_FLASHLOG_ADDRESS, and moved to the SD log once a card is mounted.
+
+    Each block starts with two quad words: a header holding the block's
+    sequence number and erase count, written when the block is erased, and a
+    mark written once its records are on the card. Records of one quad word
+    each fill the rest of the block. A quad word is written once between
+    erases, so a record reaches the flash as soon as it is taken and a reset
+    costs at most the records still queued in RAM.
+
+    Blocks are erased in turn as the ring wraps, which spreads the erases
+    evenly. When the ring is full, the oldest block is erased and its
+    records are lost. At initialization the headers and marks give back the
+    oldest block not yet moved to the card and the newest block, and the
+    first blank quad word of the newest block gives the end of the log. A
+    reset while records are moved repeats at most the records of one block.
+*******************************************************************************/
+
+#ifndef _APP_FLASHLOG_H
+#define _APP_FLASHLOG_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Flash log states enumeration
+
+  Description:
+    This enumeration defines the valid flash log states.
+*/
+
+typedef enum
+{
+    /* Write the queued records and drained marks */
+    APP_FLASHLOG_STATE_READY,
+
+    /* Wait for a block erase, then write the block header */
+    APP_FLASHLOG_STATE_ERASE,
+
+    /* The flash reported an error; records are no longer stored */
+    APP_FLASHLOG_STATE_ERROR,
+} APP_FLASHLOG_STATES;
+
+
+// *****************************************************************************
+/* Block states
+
+  Summary:
+    State of a block of the ring, kept in RAM
+*/
+
+typedef enum
+{
+    /* Erased, or not holding a valid header */
+    APP_FLASHLOG_BLOCK_FREE,
+
+    /* Holds records not yet read */
+    APP_FLASHLOG_BLOCK_DATA,
+
+    /* All records read, but not yet on the card */
+    APP_FLASHLOG_BLOCK_READ,
+
+    /* Records on the card, drained mark to be written */
+    APP_FLASHLOG_BLOCK_RELEASE,
+
+    /* Drained mark written */
+    APP_FLASHLOG_BLOCK_DRAINED,
+} APP_FLASHLOG_BLOCK_STATES;
+
+
+// *****************************************************************************
+/* Flash Log Record
+
+  Summary:
+    One sample, as stored in a quad word of the flash
+
+  Description:
+    The values are kept at the resolution the sensor driver returns them, so
+    that the log reads the same as if the card had been mounted. The derived
+    quantities are not stored; they are computed again from the values when
+    the record is moved to the SD log.
+*/
+
+/* Bit of the milliseconds holding bit 16 of the humidity */
+#define APP_FLASHLOG_HUMIDITY_BIT16     (0x8000U)
+
+typedef struct
+{
+    /* Acquisition time, in seconds since 1970/01/01 00:00:00, and
+     * milliseconds. Bit 15 of the milliseconds is bit 16 of the humidity. */
+    uint32_t    time;
+    uint16_t    milliseconds;
+
+    /* Temperature in 0.01 degC, pressure in Pa, and the low 16 bits of the
+     * relative humidity in 1/1024 %RH */
+    int16_t     temperature;
+    uint32_t    pressure;
+    uint16_t    humidity;
+
+    /* CRC-16/CCITT-FALSE of the bytes above */
+    uint16_t    crc;
+} APP_FLASHLOG_RECORD;
+
+
+// *****************************************************************************
+/* Block Data
+
+  Summary:
+    RAM copy of what is known of a block of the ring
+*/
+
+typedef struct
+{
+    APP_FLASHLOG_BLOCK_STATES   state;
+
+    /* Sequence number and erase count from the header */
+    uint32_t                    sequence;
+    uint32_t                    eraseCount;
+} APP_FLASHLOG_BLOCK;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds flash log data
+
+  Description:
+    This structure holds the flash log's data.
+
+  Remarks:
+    The blocks and the record queue are defined outside this structure.
+ */
+
+typedef struct
+{
+    /* Flash log's current state */
+    APP_FLASHLOG_STATES state;
+
+    /* Block and offset of the next record to write */
+    uint32_t            headBlock;
+    uint32_t            headOffset;
+
+    /* Block and offset of the next record to read */
+    uint32_t            tailBlock;
+    uint32_t            tailOffset;
+
+    /* Sequence number of the next block erased */
+    uint32_t            sequence;
+
+    /* Records queued for writing */
+    uint32_t            queueIn;
+    uint32_t            queueOut;
+    uint32_t            queueCount;
+
+    /* Counts since initialization: records written and read, records
+     * dropped because the queue was full or failed their CRC, and blocks
+     * erased before their records were read */
+    uint32_t            writeCount;
+    uint32_t            readCount;
+    uint32_t            droppedCount;
+    uint32_t            invalidCount;
+    uint32_t            overwriteCount;
+} APP_FLASHLOG_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_FLASHLOG_Initialize ( void )
+
+  Summary:
+     Flash log initialization routine.
+
+  Description:
+    This function reads the block headers and marks of the ring and finds
+    the records not yet moved to the SD log.
+
+  Precondition:
+    NVMCTRL_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_FLASHLOG_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void APP_FLASHLOG_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_FLASHLOG_Tasks ( void )
+
+  Summary:
+    Flash log tasks function
+
+  Description:
+    Writes the queued records and the drained marks, and erases the next
+    block when the newest one is full. One flash operation is started per
+    call; the call returns while it runs.
+
+  Precondition:
+    APP_FLASHLOG_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_FLASHLOG_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine, after
+    APP_SDCARD_Tasks.
+ */
+
+void APP_FLASHLOG_Tasks( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_FLASHLOG_IsIdle ( void )
+
+  Summary:
+    Reports whether the flash log is waiting for an event
+
+  Description:
+    The flash log is busy while records or marks are queued or a flash
+    operation runs.
+
+  Precondition:
+    APP_FLASHLOG_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if nothing is left to write.
+
+  Example:
+    <code>
+    if (APP_FLASHLOG_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task.
+ */
+
+bool APP_FLASHLOG_IsIdle( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_FLASHLOG_Write ( APP_FLASHLOG_RECORD* record )
+
+  Summary:
+    Queues a record for writing
+
+  Description:
+    Sets the CRC of the record and queues it. It is written by
+    APP_FLASHLOG_Tasks.
+
+  Precondition:
+    APP_FLASHLOG_Initialize should have been called.
+
+  Parameters:
+    record - Record to store; its crc member is set
+
+  Returns:
+    false if the queue is full or the flash log is in error; the record is
+    dropped.
+
+  Example:
+    <code>
+    if (APP_FLASHLOG_Write(&record) == false)
+    {
+        printf("Sample dropped \r\n");
+    }
+    </code>
+
+  Remarks:
+    None.
+ */
+
+bool APP_FLASHLOG_Write( APP_FLASHLOG_RECORD* record );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_FLASHLOG_Read ( APP_FLASHLOG_RECORD* record, bool isConsumed )
+
+  Summary:
+    Reads the oldest record not yet read
+
+  Description:
+    Copies the oldest record from the flash. Records that fail their CRC are
+    skipped. Records still queued are not seen until they are written.
+
+  Precondition:
+    APP_FLASHLOG_Initialize should have been called.
+
+  Parameters:
+    record     - Receives the record
+    isConsumed - true to move on to the next record, false to only look at
+                 this one
+
+  Returns:
+    false if there is no record to read.
+
+  Example:
+    <code>
+    while (APP_FLASHLOG_Read(&record, true) == true)
+    {
+        // Append the record to the log
+    }
+    APP_FLASHLOG_Release();
+    </code>
+
+  Remarks:
+    A block whose records have been read is not marked as drained until
+    APP_FLASHLOG_Release is called; its records are read again after a
+    reset until then.
+ */
+
+bool APP_FLASHLOG_Read( APP_FLASHLOG_RECORD* record, bool isConsumed );
+
+
+/*******************************************************************************
+  Function:
+    void APP_FLASHLOG_Release ( void )
+
+  Summary:
+    Marks the blocks read so far as drained
+
+  Description:
+    Call once the records read have been committed to the SD card. The
+    drained marks are written by APP_FLASHLOG_Tasks. When every record has
+    been read, the newest block is closed, so that it can be marked and the
+    next record starts a new block.
+
+  Precondition:
+    APP_FLASHLOG_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    See APP_FLASHLOG_Read.
+
+  Remarks:
+    None.
+ */
+
+void APP_FLASHLOG_Release( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_FLASHLOG_IsEmpty ( void )
+
+  Summary:
+    Reports whether every stored record has been read
+
+  Description:
+    Records still queued count as not read.
+
+  Precondition:
+    APP_FLASHLOG_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if no record is waiting to be read.
+
+  Example:
+    <code>
+    if (APP_FLASHLOG_IsEmpty() == false)
+    {
+        // Keep the records in order behind the stored ones
+        APP_FLASHLOG_Write(&record);
+    }
+    </code>
+
+  Remarks:
+    None.
+ */
+
+bool APP_FLASHLOG_IsEmpty( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_FLASHLOG_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,138 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_memory.c
+
+  Summary:
+    This file contains the source code for the memory report.
+
+  Description:
+    The XC32 linker places the static data, the heap and the stack in the
+    RAM region, and defines _splim and _stack around the stack, _heap at the
+    start of the heap and _min_heap_size from the heap size of the project.
+    __ram_start and __ram_end are defined by the linker script. The static
+    data is what the heap and the stack leave of the region.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include "app_memory.h"
+#include "app_dmabuf.h"
+#include "app_pool.h"
+#include "device.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_MEMORY_STACK_PAINT      (0xC5C5C5C5U)
+
+/* Linker defined symbols; only their addresses are used */
+extern uint32_t __ram_start;
+extern uint32_t __ram_end;
+extern uint32_t _splim;
+extern uint32_t _stack;
+extern uint32_t _heap;
+extern uint32_t _min_heap_size;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Called by Reset_Handler before the data is initialized and the C library
+ * started. Interrupts are not enabled yet, and everything below the stack
+ * pointer is free. */
+void __attribute__((long_call)) _on_reset(void)
+{
+    uint32_t* word = &_splim;
+    uint32_t* end = (uint32_t*)__get_MSP();
+
+    while (word < end)
+    {
+        *word++ = APP_MEMORY_STACK_PAINT;
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Memory Report Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    uint32_t APP_MEMORY_StackSizeGet ( void )
+
+  Remarks:
+    See prototype in app_memory.h.
+ */
+
+uint32_t APP_MEMORY_StackSizeGet( void )
+{
+    return (uint32_t)&_stack - (uint32_t)&_splim;
+}
+
+
+/******************************************************************************
+  Function:
+    uint32_t APP_MEMORY_StackPeakGet ( void )
+
+  Remarks:
+    See prototype in app_memory.h.
+ */
+
+uint32_t APP_MEMORY_StackPeakGet( void )
+{
+    const uint32_t* word = &_splim;
+
+    while ((word < &_stack) && (*word == APP_MEMORY_STACK_PAINT))
+    {
+        word++;
+    }
+
+    return (uint32_t)&_stack - (uint32_t)word;
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_MEMORY_Report ( void )
+
+  Remarks:
+    See prototype in app_memory.h.
+ */
+
+void APP_MEMORY_Report( void )
+{
+    uint32_t ramSize = (uint32_t)&__ram_end - (uint32_t)&__ram_start;
+    uint32_t heapSize = (uint32_t)&_min_heap_size;
+    uint32_t stackSize = APP_MEMORY_StackSizeGet();
+
+    printf("RAM: %lu bytes, static data %lu, heap %lu at 0x%08lx, stack %lu at 0x%08lx \r\n",
+           (unsigned long)ramSize, (unsigned long)(ramSize - heapSize - stackSize),
+           (unsigned long)heapSize, (unsigned long)(uint32_t)&_heap,
+           (unsigned long)stackSize, (unsigned long)(uint32_t)&_splim);
+    printf("Stack: %lu of %lu bytes used at most \r\n",
+           (unsigned long)APP_MEMORY_StackPeakGet(), (unsigned long)stackSize);
+
+    APP_DMABUF_Report();
+    APP_POOL_Report();
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,156 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_memory.h
+
+  Summary:
+    This header file provides prototypes for the memory report.
+
+  Description:
+    The stack is painted with a known word at reset, before the C runtime is
+    initialized. The words still painted at the bottom of the stack have
+    never been used, so the deepest use since reset is found by scanning up
+    from the stack limit until the first changed word.
+
+    The report lists the RAM taken by the static data, the heap and the
+    stack, from the symbols of the linker, the deepest use of the stack, the
+    use of the DMA buffer pool and that of every record pool. It is printed
+    at start up and by the console command
+
+        4
+*******************************************************************************/
+
+#ifndef _APP_MEMORY_H
+#define _APP_MEMORY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Memory Report Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    uint32_t APP_MEMORY_StackSizeGet ( void )
+
+  Summary:
+    Returns the size of the stack
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    Bytes between the stack limit and the top of the stack.
+
+  Example:
+    <code>
+    size = APP_MEMORY_StackSizeGet();
+    </code>
+
+  Remarks:
+    None.
+ */
+
+uint32_t APP_MEMORY_StackSizeGet( void );
+
+
+/*******************************************************************************
+  Function:
+    uint32_t APP_MEMORY_StackPeakGet ( void )
+
+  Summary:
+    Returns the deepest use of the stack since reset
+
+  Description:
+    Scans the stack from its limit up to the first word that is no longer
+    painted.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    Bytes of the stack used at most since reset.
+
+  Example:
+    <code>
+    if (APP_MEMORY_StackPeakGet() > (APP_MEMORY_StackSizeGet() / 2U))
+    {
+        printf("Stack more than half used \r\n");
+    }
+    </code>
+
+  Remarks:
+    The scan reads the unused part of the stack, a word at a time. A word
+    that happened to be written with the paint value is taken as unused.
+ */
+
+uint32_t APP_MEMORY_StackPeakGet( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_MEMORY_Report ( void )
+
+  Summary:
+    Prints the memory report
+
+  Precondition:
+    APP_POOL_Initialize and APP_DMABUF_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_MEMORY_Report();
+    </code>
+
+  Remarks:
+    Runs the console command 4.
+ */
+
+void APP_MEMORY_Report( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_MEMORY_H */
+
+/*******************************************************************************
+ End of File
+ */
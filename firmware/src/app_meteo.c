@@ -0,0 +1,229 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_meteo.c
+
+  Summary:
+    This file contains the source code for the derived meteorological
+    quantities.
+
+  Description:
+    Logarithms are taken in base 2 by normalizing the argument and squaring
+    the mantissa, one result bit per squaring. Powers are formed from a 16
+    entry table of 2^(k/16) and a third order series for the remainder.
+    Values are carried in Q24 between the two, which keeps every intermediate
+    within 64 bits.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "app_meteo.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_METEO_Q24_ONE           (16777216LL)
+#define APP_METEO_Q30_ONE           (1073741824ULL)
+
+/* Constants in Q24 */
+#define APP_METEO_LN2               (11629080LL)
+#define APP_METEO_LOG2_E            (24204406LL)
+
+/* Magnus coefficients. b in Q24, c in 0.01 degC */
+#define APP_METEO_MAGNUS_B          (295614546LL)
+#define APP_METEO_MAGNUS_C          (24312LL)
+
+/* log2 of 100 %RH in 1/1024 %RH, and of the Magnus saturation pressure at
+ * 0 degC, 611.2 Pa, in Q24 */
+#define APP_METEO_LOG2_RH_FULL      (279237570LL)
+#define APP_METEO_LOG2_E0           (155281535LL)
+
+/* mg/m^3 per Pa of vapour pressure, times the temperature in 0.01 K:
+ * 10^6 / 461.5 J/(kg K) * 100 */
+#define APP_METEO_AH_FACTOR         (216685ULL)
+#define APP_METEO_ZERO_CELSIUS      (27315)
+
+/* ICAO standard atmosphere: scale height in cm, exponent and its inverse in
+ * Q24, and log2 of the reference pressure of 101325 Pa in 1/256 Pa in Q24 */
+#define APP_METEO_ISA_HEIGHT_CM     (4433077LL)
+#define APP_METEO_ISA_EXPONENT      (3192083LL)
+#define APP_METEO_ISA_INV_EXPONENT  (88179034LL)
+#define APP_METEO_LOG2_P0           (413199856LL)
+
+/* ln(2) in Q30 */
+#define APP_METEO_LN2_Q30           (744261118ULL)
+
+/* 2^(k/16) in Q30 */
+static const uint32_t app_meteoExp2Table[16] =
+{
+    1073741824U, 1121280436U, 1170923762U, 1222764986U,
+    1276901417U, 1333434672U, 1392470869U, 1454120821U,
+    1518500250U, 1585730000U, 1655936265U, 1729250827U,
+    1805811301U, 1885761398U, 1969251188U, 2056437387U,
+};
+
+/* Sea-level reduction factor of the station altitude, in Q30 */
+static uint64_t app_meteoSeaLevelFactor;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Quotient rounded to the nearest integer. d must be positive. */
+static int64_t APP_METEO_DivRound(int64_t n, int64_t d)
+{
+    return (n >= 0) ? ((n + (d / 2)) / d) : ((n - (d / 2)) / d);
+}
+
+/* log2(x) in Q24, x > 0 */
+static int32_t APP_METEO_Log2(uint32_t x)
+{
+    int32_t n = 31 - __builtin_clz(x);
+    int32_t result = n * (int32_t)APP_METEO_Q24_ONE;
+    int32_t bit;
+    uint64_t m;
+
+    /* Mantissa in [1, 2) in Q30 */
+    m = (n <= 30) ? ((uint64_t)x << (30 - n)) : ((uint64_t)x >> 1);
+
+    /* Squaring doubles the fractional part of the logarithm. A square of 2
+     * or more carries the next bit into the integer part. */
+    for (bit = (int32_t)(APP_METEO_Q24_ONE / 2); bit != 0; bit /= 2)
+    {
+        m = (m * m) >> 30;
+
+        if (m >= (2U * APP_METEO_Q30_ONE))
+        {
+            m >>= 1;
+            result += bit;
+        }
+    }
+
+    return result;
+}
+
+/* 2^y in Q30, y in Q24 */
+static uint64_t APP_METEO_Exp2(int32_t y)
+{
+    int32_t n = y / (int32_t)APP_METEO_Q24_ONE;
+    int32_t f = y - (n * (int32_t)APP_METEO_Q24_ONE);
+    uint64_t x;
+    uint64_t x2;
+    uint64_t x3;
+    uint64_t m;
+
+    if (f < 0)
+    {
+        f += (int32_t)APP_METEO_Q24_ONE;
+        n--;
+    }
+
+    if (n < -62)
+    {
+        return 0;
+    }
+
+    if (n > 32)
+    {
+        return UINT64_MAX;
+    }
+
+    /* 2^f = 2^(k/16) * e^(r ln2) with r < 1/16 */
+    x = ((uint64_t)(f & 0xFFFFF) * APP_METEO_LN2_Q30) >> 24;
+    x2 = (x * x) >> 30;
+    x3 = (x2 * x) >> 30;
+    m = APP_METEO_Q30_ONE + x + (x2 / 2U) + (x3 / 6U);
+    m = ((uint64_t)app_meteoExp2Table[f >> 20] * m) >> 30;
+
+    return (n >= 0) ? (m << n) : (m >> -n);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and Computation Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_METEO_Initialize ( void )
+
+  Remarks:
+    See prototype in app_meteo.h.
+ */
+
+void APP_METEO_Initialize ( void )
+{
+    int64_t ratio;
+    int64_t log2Ratio;
+
+    /* (1 - h / H)^-1/exponent, through the logarithm of the ratio in Q30 */
+    ratio = (int64_t)APP_METEO_Q30_ONE -
+            APP_METEO_DivRound((int64_t)APP_METEO_STATION_ALTITUDE_M * 100 * (int64_t)APP_METEO_Q30_ONE,
+                               APP_METEO_ISA_HEIGHT_CM);
+    log2Ratio = (int64_t)APP_METEO_Log2((uint32_t)ratio) - (30 * APP_METEO_Q24_ONE);
+
+    app_meteoSeaLevelFactor = APP_METEO_Exp2((int32_t)((-log2Ratio * APP_METEO_ISA_INV_EXPONENT) / APP_METEO_Q24_ONE));
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_METEO_Compute ( int32_t temperature, uint32_t pressure,
+                             uint32_t humidity, APP_METEO_DATA* derived )
+
+  Remarks:
+    See prototype in app_meteo.h.
+ */
+
+void APP_METEO_Compute( int32_t temperature, uint32_t pressure, uint32_t humidity, APP_METEO_DATA* derived )
+{
+    int64_t gamma;
+    int64_t ratio;
+    uint64_t vapour;
+
+    if (humidity == 0U)
+    {
+        humidity = 1U;
+    }
+
+    /* Magnus: gamma = ln(RH) + b T / (c + T), in Q24. The vapour pressure
+     * is e0 exp(gamma) and the dew point c gamma / (b - gamma). */
+    gamma = (((int64_t)APP_METEO_Log2(humidity) - APP_METEO_LOG2_RH_FULL) * APP_METEO_LN2) / APP_METEO_Q24_ONE;
+    gamma += (APP_METEO_MAGNUS_B * temperature) / (APP_METEO_MAGNUS_C + temperature);
+
+    derived->dewPoint = (int32_t)APP_METEO_DivRound(APP_METEO_MAGNUS_C * gamma, APP_METEO_MAGNUS_B - gamma);
+
+    /* Vapour pressure in Pa in Q30, then rho = e / (Rv T) */
+    vapour = APP_METEO_Exp2((int32_t)(((gamma * APP_METEO_LOG2_E) / APP_METEO_Q24_ONE) + APP_METEO_LOG2_E0));
+    derived->absoluteHumidity = (uint32_t)((((vapour * APP_METEO_AH_FACTOR) /
+                                (uint64_t)(temperature + APP_METEO_ZERO_CELSIUS)) + (APP_METEO_Q30_ONE / 2U)) >> 30);
+
+    /* h = H (1 - (p / p0)^exponent) */
+    ratio = (int64_t)APP_METEO_Exp2((int32_t)((((int64_t)APP_METEO_Log2(pressure) - APP_METEO_LOG2_P0) *
+                                              APP_METEO_ISA_EXPONENT) / APP_METEO_Q24_ONE));
+    derived->pressureAltitude = (int32_t)APP_METEO_DivRound(APP_METEO_ISA_HEIGHT_CM * ((int64_t)APP_METEO_Q30_ONE - ratio),
+                                                            (int64_t)APP_METEO_Q30_ONE);
+
+    /* p in 1/256 Pa times the factor in Q30 */
+    derived->seaLevelPressure = (uint32_t)((((uint64_t)pressure * app_meteoSeaLevelFactor) +
+                                           (1ULL << 37)) >> 38);
+}
+
+
+/*******************************************************************************
+ End of File
+ */
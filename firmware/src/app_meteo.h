@@ -0,0 +1,178 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_meteo.h
+
+  Summary:
+    This header file provides prototypes and definitions for the derived
+    meteorological quantities.
+
+  Description:
+    Dew point, absolute humidity, pressure altitude and sea-level pressure are
+    derived from each compensated sample in fixed point. Logarithms and powers
+    are evaluated with integer base 2 routines, so no libm call or floating
+    point operation is made per sample.
+
+    Formulas and worst-case errors against the same formulas in double
+    precision, over -40..85 degC, 1..100 %RH and 30000..110000 Pa:
+
+      dew point          Magnus, b = 17.62, c = 243.12 degC    0.01 degC
+      absolute humidity  e / (461.5 J/(kg K) * T)               1 mg/m^3
+      pressure altitude  ISA, 44330.77 m * (1 - (p/p0)^0.190263)
+                         with p0 = 101325 Pa                    2 cm
+      sea-level pressure p * (1 - h/44330.77 m)^-5.25588        1 Pa
+
+    The errors are mostly those of the final rounding; the base 2 logarithm
+    is within 2^-23 and the power within 2^-22 relative. test_app_meteo.cpp
+    of the host build holds the quantities to these bounds. The formulas
+    themselves are approximations of the atmosphere; the Magnus fit for
+    instance is within 0.35 degC of the WMO saturation curve between -45 and
+    60 degC.
+*******************************************************************************/
+
+#ifndef _APP_METEO_H
+#define _APP_METEO_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Derived Quantities
+
+  Summary:
+    Quantities derived from one sample
+
+  Description:
+    Units are chosen so that each value is an integer with the resolution of
+    the sensor.
+*/
+
+typedef struct
+{
+    /* Dew point, in 0.01 degC */
+    int32_t     dewPoint;
+
+    /* Absolute humidity, in mg/m^3 */
+    uint32_t    absoluteHumidity;
+
+    /* Pressure altitude in the ICAO standard atmosphere, in cm */
+    int32_t     pressureAltitude;
+
+    /* Pressure reduced to sea level from APP_METEO_STATION_ALTITUDE_M, in Pa */
+    uint32_t    seaLevelPressure;
+} APP_METEO_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and Computation Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_METEO_Initialize ( void )
+
+  Summary:
+     Derived quantities initialization routine.
+
+  Description:
+    This function computes the sea-level reduction factor of the station
+    altitude once, so that each sample costs a single multiply for it.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_METEO_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void APP_METEO_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_METEO_Compute ( int32_t temperature, uint32_t pressure,
+                             uint32_t humidity, APP_METEO_DATA* derived )
+
+  Summary:
+    Derives the meteorological quantities of a sample
+
+  Description:
+    Takes the values returned by the BME280 driver and computes the derived
+    quantities. The saturation term of the Magnus formula is shared by the
+    dew point and the absolute humidity.
+
+  Precondition:
+    APP_METEO_Initialize should have been called.
+
+  Parameters:
+    temperature - Temperature, in 0.01 degC
+    pressure    - Pressure, in 1/256 Pa as returned by DRV_BME280_Get_PressureQ8
+    humidity    - Relative humidity, in 1/1024 %RH
+    derived     - Receives the derived quantities
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_METEO_DATA derived;
+
+    APP_METEO_Compute(temperature, pressure, humidity, &derived);
+    </code>
+
+  Remarks:
+    A relative humidity of 0 is computed as 1/1024 %RH, as its logarithm is
+    not defined.
+ */
+
+void APP_METEO_Compute( int32_t temperature, uint32_t pressure, uint32_t humidity, APP_METEO_DATA* derived );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_METEO_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,239 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_pool.c
+
+  Summary:
+    This file contains the source code for the record pools.
+
+  Description:
+    Alloc and Free only move the head of the free list and update the free
+    map and the counters, with interrupts disabled, so that an interrupt
+    taking or giving back a block of the same pool cannot corrupt the list.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include "app_pool.h"
+#include "system/int/sys_int.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Word and bit of a block in the free map */
+#define APP_POOL_MAP_WORD(index)    ((index) / 32U)
+#define APP_POOL_MAP_BIT(index)     (1UL << ((index) % 32U))
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds the pools' data
+
+  Description:
+    This structure lists the pools created.
+
+  Remarks:
+    This structure should be initialized by the APP_POOL_Initialize function.
+*/
+
+APP_POOL_DATA app_poolData;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and Pool Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_POOL_Initialize ( void )
+
+  Remarks:
+    See prototype in app_pool.h.
+ */
+
+void APP_POOL_Initialize ( void )
+{
+    app_poolData.poolCount = 0;
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_POOL_Create ( APP_POOL* pool, const char* name, void* storage,
+                           size_t blockSize, uint32_t blockCount )
+
+  Remarks:
+    See prototype in app_pool.h.
+ */
+
+bool APP_POOL_Create( APP_POOL* pool, const char* name, void* storage, size_t blockSize, uint32_t blockCount )
+{
+    APP_POOL_FREE* block;
+    uint32_t i;
+
+    if ((blockSize < sizeof(APP_POOL_FREE)) || ((blockSize % sizeof(APP_POOL_FREE*)) != 0U) ||
+        (blockCount > APP_POOL_BLOCKS_MAX))
+    {
+        return false;
+    }
+
+    pool->name = name;
+    pool->storage = (uint8_t*)storage;
+    pool->blockSize = (uint32_t)blockSize;
+    pool->blockCount = blockCount;
+    pool->freeList = NULL;
+    pool->usedCount = 0;
+    pool->peakCount = 0;
+    pool->exhaustCount = 0;
+    pool->freeErrorCount = 0;
+
+    for (i = 0; i < APP_POOL_MAP_WORDS; i++)
+    {
+        pool->freeMap[i] = 0U;
+    }
+
+    /* Listed from the last block, so that the first one is taken first */
+    for (i = blockCount; i > 0U; i--)
+    {
+        block = (APP_POOL_FREE*)&pool->storage[(i - 1U) * pool->blockSize];
+        block->next = pool->freeList;
+        pool->freeList = block;
+        pool->freeMap[APP_POOL_MAP_WORD(i - 1U)] |= APP_POOL_MAP_BIT(i - 1U);
+    }
+
+    if (app_poolData.poolCount == APP_POOL_MAX)
+    {
+        return false;
+    }
+
+    app_poolData.pools[app_poolData.poolCount++] = pool;
+
+    return true;
+}
+
+
+/******************************************************************************
+  Function:
+    void* APP_POOL_Alloc ( APP_POOL* pool )
+
+  Remarks:
+    See prototype in app_pool.h.
+ */
+
+void* APP_POOL_Alloc( APP_POOL* pool )
+{
+    APP_POOL_FREE* block;
+    uint32_t index;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    block = pool->freeList;
+
+    if (block == NULL)
+    {
+        pool->exhaustCount++;
+    }
+    else
+    {
+        pool->freeList = block->next;
+        index = (uint32_t)(((uint8_t*)block - pool->storage) / pool->blockSize);
+        pool->freeMap[APP_POOL_MAP_WORD(index)] &= ~APP_POOL_MAP_BIT(index);
+
+        pool->usedCount++;
+        if (pool->usedCount > pool->peakCount)
+        {
+            pool->peakCount = pool->usedCount;
+        }
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return block;
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_POOL_Free ( APP_POOL* pool, void* block )
+
+  Remarks:
+    See prototype in app_pool.h.
+ */
+
+void APP_POOL_Free( APP_POOL* pool, void* block )
+{
+    APP_POOL_FREE* freeBlock = (APP_POOL_FREE*)block;
+    uintptr_t offset = (uintptr_t)block - (uintptr_t)pool->storage;
+    uint32_t index = (uint32_t)(offset / pool->blockSize);
+    bool interruptState;
+
+    if (block == NULL)
+    {
+        return;
+    }
+
+    interruptState = SYS_INT_Disable();
+
+    /* Not a block of this pool, or one already given back */
+    if (((uintptr_t)block < (uintptr_t)pool->storage) ||
+        (offset >= ((uintptr_t)pool->blockSize * pool->blockCount)) ||
+        ((offset % pool->blockSize) != 0U) ||
+        ((pool->freeMap[APP_POOL_MAP_WORD(index)] & APP_POOL_MAP_BIT(index)) != 0U))
+    {
+        pool->freeErrorCount++;
+        SYS_INT_Restore(interruptState);
+        return;
+    }
+
+    freeBlock->next = pool->freeList;
+    pool->freeList = freeBlock;
+    pool->freeMap[APP_POOL_MAP_WORD(index)] |= APP_POOL_MAP_BIT(index);
+    pool->usedCount--;
+
+    SYS_INT_Restore(interruptState);
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_POOL_Report ( void )
+
+  Remarks:
+    See prototype in app_pool.h.
+ */
+
+void APP_POOL_Report( void )
+{
+    const APP_POOL* pool;
+    uint32_t i;
+
+    for (i = 0; i < app_poolData.poolCount; i++)
+    {
+        pool = app_poolData.pools[i];
+
+        printf("Pool %s: %lu of %lu blocks of %lu bytes in use, peak %lu, exhausted %lu times, %lu bad frees \r\n",
+               pool->name, (unsigned long)pool->usedCount, (unsigned long)pool->blockCount,
+               (unsigned long)pool->blockSize, (unsigned long)pool->peakCount,
+               (unsigned long)pool->exhaustCount, (unsigned long)pool->freeErrorCount);
+    }
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,316 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_pool.h
+
+  Summary:
+    This header file provides prototypes and definitions for the record
+    pools.
+
+  Description:
+    A record pool hands out blocks of one size from a static array, so
+    records passed along the sample pipeline need no heap and cannot
+    fragment the RAM. Free blocks are kept in a list threaded through the
+    blocks themselves, so a block is taken or given back in constant time,
+    with interrupts disabled only for the few instructions that update the
+    list. The pools can be used from interrupts.
+
+    Each pool also keeps a bit per block, set while the block is free, so
+    giving back a block twice, or an address that is not a block of the
+    pool, is refused and counted instead of corrupting the list. Nothing
+    in a block taken is read back, whatever its data.
+
+    Each pool counts its blocks in use, the most ever in use and the times
+    it had none to give. They are printed for every pool in the memory
+    report of the console command 4.
+*******************************************************************************/
+
+#ifndef _APP_POOL_H
+#define _APP_POOL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Words of the free map of a pool */
+#define APP_POOL_MAP_WORDS      ((APP_POOL_BLOCKS_MAX + 31U) / 32U)
+
+// *****************************************************************************
+/* Free Block
+
+  Summary:
+    Link stored at the start of a free block
+
+  Description:
+    The block is overwritten by its user once taken.
+*/
+
+typedef struct APP_POOL_FREE
+{
+    struct APP_POOL_FREE*   next;
+} APP_POOL_FREE;
+
+
+// *****************************************************************************
+/* Record Pool
+
+  Summary:
+    Holds the data of one pool
+
+  Description:
+    The structure is defined by the user of the pool and set up by
+    APP_POOL_Create.
+*/
+
+typedef struct
+{
+    /* Name printed by APP_POOL_Report */
+    const char*         name;
+
+    /* Blocks of the pool, and their size and number */
+    uint8_t*            storage;
+    uint32_t            blockSize;
+    uint32_t            blockCount;
+
+    /* First free block, and a bit per block, set while it is free */
+    APP_POOL_FREE*      freeList;
+    uint32_t            freeMap[APP_POOL_MAP_WORDS];
+
+    /* Blocks in use, the most ever in use, the allocations that failed and
+     * the blocks refused by APP_POOL_Free */
+    volatile uint32_t   usedCount;
+    volatile uint32_t   peakCount;
+    volatile uint32_t   exhaustCount;
+    volatile uint32_t   freeErrorCount;
+} APP_POOL;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds the pools' data
+
+  Description:
+    This structure lists the pools created, for the report.
+ */
+
+typedef struct
+{
+    APP_POOL*   pools[APP_POOL_MAX];
+    uint32_t    poolCount;
+} APP_POOL_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and Pool Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_POOL_Initialize ( void )
+
+  Summary:
+     Record pools initialization routine.
+
+  Description:
+    This function empties the list of pools.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POOL_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function, before
+    the initialization of the tasks that create pools.
+*/
+
+void APP_POOL_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_POOL_Create ( APP_POOL* pool, const char* name, void* storage,
+                           size_t blockSize, uint32_t blockCount )
+
+  Summary:
+    Sets up a pool over an array of blocks
+
+  Description:
+    Every block is put in the free list and the pool is added to the report.
+
+  Precondition:
+    APP_POOL_Initialize should have been called.
+
+  Parameters:
+    pool       - Pool to set up
+    name       - Name of the pool in the report
+    storage    - Array of blockCount blocks, aligned for a pointer
+    blockSize  - Bytes of a block, a multiple of the size of a pointer
+    blockCount - Number of blocks, at most APP_POOL_BLOCKS_MAX
+
+  Returns:
+    false if a block cannot hold the free link, there are more than
+    APP_POOL_BLOCKS_MAX blocks or APP_POOL_MAX pools have been created. The
+    pool is set up, but not reported, in the last case.
+
+  Example:
+    <code>
+    static APP_SDCARD_SAMPLE samples[APP_SDCARD_SAMPLE_RECORDS];
+
+    APP_POOL_Create(&samplePool, "samples", samples, sizeof(samples[0]),
+                    APP_SDCARD_SAMPLE_RECORDS);
+    </code>
+
+  Remarks:
+    Not to be called from an interrupt.
+ */
+
+bool APP_POOL_Create( APP_POOL* pool, const char* name, void* storage, size_t blockSize, uint32_t blockCount );
+
+
+/*******************************************************************************
+  Function:
+    void* APP_POOL_Alloc ( APP_POOL* pool )
+
+  Summary:
+    Takes a block from a pool
+
+  Precondition:
+    APP_POOL_Create should have been called for the pool.
+
+  Parameters:
+    pool - Pool to take the block from
+
+  Returns:
+    The block, or NULL if every block is in use.
+
+  Example:
+    <code>
+    sample = APP_POOL_Alloc(&samplePool);
+
+    if (sample == NULL)
+    {
+        return;
+    }
+    </code>
+
+  Remarks:
+    Can be called from an interrupt.
+ */
+
+void* APP_POOL_Alloc( APP_POOL* pool );
+
+
+/*******************************************************************************
+  Function:
+    void APP_POOL_Free ( APP_POOL* pool, void* block )
+
+  Summary:
+    Gives a block back to its pool
+
+  Description:
+    A block that is already free, or an address that is not the start of a
+    block of the pool, is left alone and counted in freeErrorCount.
+
+  Precondition:
+    The block was returned by APP_POOL_Alloc for this pool.
+
+  Parameters:
+    pool  - Pool the block was taken from
+    block - Block to give back. NULL is ignored.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POOL_Free(&samplePool, sample);
+    </code>
+
+  Remarks:
+    Can be called from an interrupt.
+ */
+
+void APP_POOL_Free( APP_POOL* pool, void* block );
+
+
+/*******************************************************************************
+  Function:
+    void APP_POOL_Report ( void )
+
+  Summary:
+    Prints the use of every pool
+
+  Description:
+    One line per pool: blocks in use, number and size of the blocks, the
+    most ever in use, the allocations that failed and the blocks refused
+    when given back.
+
+  Precondition:
+    APP_POOL_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POOL_Report();
+    </code>
+
+  Remarks:
+    Part of the memory report.
+ */
+
+void APP_POOL_Report( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_POOL_H */
+
+/*******************************************************************************
+ End of File
+ */
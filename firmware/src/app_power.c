@@ -0,0 +1,358 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_power.c
+
+  Summary:
+    This file contains the source code for the low power idle task.
+
+  Description:
+    This file implements tickless idle for the application. Instead of spinning
+    in the super loop, the CPU sleeps until the next SYS_TIME timer deadline or
+    a peripheral interrupt.
+
+    Short gaps use IDLE sleep: TC0 keeps counting so SYS_TIME stays exact and
+    any interrupt (UART receive, I2C, SDHC) wakes the core. Long gaps use
+    STANDBY, which stops the DPLL and therefore TC0. The RTC, clocked from the
+    always-on 1.024 kHz oscillator, is then the only time base. To measure the
+    stopped time exactly, the task first waits in IDLE for an RTC second
+    boundary, records the TC0 count at that boundary, then sleeps in STANDBY
+    until an RTC alarm a whole number of seconds later and credits SYS_TIME
+    with the counts TC0 missed.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "app_power.h"
+#include "app.h"
+#include "app_sdcard.h"
+#include "app_timestamp.h"
+#include "app_trace.h"
+#include "app_query.h"
+#include "app_flashlog.h"
+#include "app_config.h"
+#include "driver/bme280/drv_bme280.h"
+#include "peripheral/pm/plib_pm.h"
+#include "peripheral/rtc/plib_rtc.h"
+#include "peripheral/sercom/usart/plib_sercom2_usart.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_POWER_ALARM_INT     RTC_MODE2_INTENSET_ALARM0_Msk
+
+/* RTC_ALARM_MASK_SS only matches the seconds field, so an alarm must be less
+ * than one minute ahead of the reference second. */
+#define APP_POWER_SECONDS_PER_MINUTE    60U
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds low power task data
+
+  Description:
+    This structure holds the low power task's data.
+
+  Remarks:
+    This structure should be initialized by the APP_POWER_Initialize function.
+*/
+
+APP_POWER_DATA app_powerData;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void APP_POWER_RTCEventHandler(RTC_CLOCK_INT_MASK intCause, uintptr_t context)
+{
+    APP_POWER_DATA* pPower = (APP_POWER_DATA*) context;
+
+    if ((intCause & APP_POWER_ALARM_INT) != 0U)
+    {
+        /* Capture TC0 as close to the second boundary as possible */
+        pPower->alignCount = SYS_TIME_CounterGet();
+        pPower->alarmFired = true;
+
+        RTC_RTCCInterruptDisable(APP_POWER_ALARM_INT);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Must be called with interrupts disabled, so that no event can make work
+ * pending between this check and the WFI instruction. */
+static bool APP_POWER_SystemIsIdle(void)
+{
+    return ((APP_IsIdle() == true) && (APP_SDCARD_IsIdle() == true) &&
+            (APP_TIMESTAMP_IsIdle() == true) && (APP_TRACE_IsIdle() == true) &&
+            (APP_QUERY_IsIdle() == true) && (APP_FLASHLOG_IsIdle() == true) &&
+            (APP_CONFIG_IsIdle() == true) &&
+            (DRV_BME280_Status(DRV_BME280_INSTANCE_0) != SYS_STATUS_BUSY));
+}
+
+/* Must be called with interrupts disabled. An interrupt that becomes pending
+ * still ends WFI and is serviced once interrupts are restored. */
+static void APP_POWER_IdleSleep(void)
+{
+    uint32_t startCount;
+
+    if (SYS_TIME_DeadlineCountGet() < SYS_TIME_USToCount(APP_POWER_IDLE_MIN_US))
+    {
+        return;
+    }
+
+    startCount = SYS_TIME_CounterGet();
+
+    PM_IdleModeEnter();
+
+    app_powerData.stats.idleCount += (SYS_TIME_CounterGet() - startCount);
+    app_powerData.stats.idleEntries++;
+}
+
+/* Arms the RTC alarm for the next second boundary. */
+static void APP_POWER_AlignmentStart(void)
+{
+    struct tm now;
+
+    do
+    {
+        RTC_RTCCTimeGet(&now);
+
+        app_powerData.alignTime = now;
+        app_powerData.alignTime.tm_sec = (now.tm_sec + 1) % (int)APP_POWER_SECONDS_PER_MINUTE;
+        app_powerData.alarmFired = false;
+
+        (void) RTC_RTCCAlarmSet(&app_powerData.alignTime, RTC_ALARM_MASK_SS);
+
+        /* If the second rolled over while arming, the alarm would not match
+         * for another minute. Arm it again for the new boundary. */
+        RTC_RTCCTimeGet(&app_powerData.alignTime);
+
+    } while (app_powerData.alignTime.tm_sec != now.tm_sec);
+
+    app_powerData.alignTime.tm_sec = (now.tm_sec + 1) % (int)APP_POWER_SECONDS_PER_MINUTE;
+}
+
+/* Must be called with interrupts disabled, right after the alignment alarm. */
+static void APP_POWER_StandbySleep(void)
+{
+    struct tm wakeTime;
+    uint32_t frequency = SYS_TIME_FrequencyGet();
+    uint32_t deadline = SYS_TIME_DeadlineCountGet();
+    uint32_t sinceAlign = SYS_TIME_CounterGet() - app_powerData.alignCount;
+    uint32_t wakeLatency = SYS_TIME_USToCount(APP_POWER_STANDBY_WAKE_LATENCY_US);
+    uint32_t seconds;
+    uint32_t entryCount;
+    uint32_t elapsed;
+    uint32_t stopped;
+
+    /* Whole seconds from the boundary that still end before the deadline */
+    if (deadline == SYS_TIME_DEADLINE_NONE)
+    {
+        seconds = APP_POWER_STANDBY_MAX_S;
+    }
+    else if ((deadline + sinceAlign) > wakeLatency)
+    {
+        seconds = (uint32_t)(((uint64_t)deadline + sinceAlign - wakeLatency) / frequency);
+    }
+    else
+    {
+        seconds = 0;
+    }
+
+    if (seconds > APP_POWER_STANDBY_MAX_S)
+    {
+        seconds = APP_POWER_STANDBY_MAX_S;
+    }
+
+    /* STANDBY stops the SERCOM clock. Let pending console output drain. */
+    if ((seconds == 0U) || (SERCOM2_USART_WriteIsBusy() == true))
+    {
+        APP_POWER_IdleSleep();
+        return;
+    }
+
+    wakeTime = app_powerData.alignTime;
+    wakeTime.tm_sec = (int)((app_powerData.alignTime.tm_sec + seconds) % APP_POWER_SECONDS_PER_MINUTE);
+    app_powerData.alarmFired = false;
+    (void) RTC_RTCCAlarmSet(&wakeTime, RTC_ALARM_MASK_SS);
+
+    entryCount = SYS_TIME_CounterGet();
+
+    PM_StandbyModeEnter();
+
+    /* The alarm is the only enabled wake source in STANDBY, but measure the
+     * RTC anyway in case another interrupt ended the sleep early. */
+    RTC_RTCCTimeGet(&wakeTime);
+    RTC_RTCCInterruptDisable(APP_POWER_ALARM_INT);
+
+    elapsed = (uint32_t)(((int)APP_POWER_SECONDS_PER_MINUTE + wakeTime.tm_sec - app_powerData.alignTime.tm_sec) %
+                        (int)APP_POWER_SECONDS_PER_MINUTE) * frequency;
+
+    /* TC0 ran from the boundary until STANDBY was entered, and restarts only
+     * after the DPLL has locked again. */
+    if (elapsed > (entryCount - app_powerData.alignCount))
+    {
+        stopped = elapsed - (entryCount - app_powerData.alignCount) + wakeLatency;
+
+        SYS_TIME_SleepCompensate(stopped);
+
+        app_powerData.stats.standbyCount += stopped;
+    }
+
+    app_powerData.stats.standbyEntries++;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_POWER_Initialize ( void )
+
+  Remarks:
+    See prototype in app_power.h.
+ */
+
+void APP_POWER_Initialize ( void )
+{
+    app_powerData.state = APP_POWER_STATE_RUN;
+    app_powerData.alarmFired = false;
+    app_powerData.startCount = SYS_TIME_Counter64Get();
+    app_powerData.standbyEnable = APP_POWER_STANDBY_ENABLE;
+
+    (void) memset(&app_powerData.stats, 0, sizeof(app_powerData.stats));
+
+    RTC_RTCCCallbackRegister(APP_POWER_RTCEventHandler, (uintptr_t) &app_powerData);
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_POWER_Tasks ( void )
+
+  Remarks:
+    See prototype in app_power.h.
+ */
+
+void APP_POWER_Tasks ( void )
+{
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    if (APP_POWER_SystemIsIdle() == false)
+    {
+        if (app_powerData.state == APP_POWER_STATE_ALIGN_WAIT)
+        {
+            /* Work arrived while aligning. Give up on STANDBY for now. */
+            RTC_RTCCInterruptDisable(APP_POWER_ALARM_INT);
+            app_powerData.state = APP_POWER_STATE_RUN;
+        }
+
+        SYS_INT_Restore(interruptState);
+        return;
+    }
+
+    switch (app_powerData.state)
+    {
+        case APP_POWER_STATE_RUN:
+        {
+            if ((app_powerData.standbyEnable == true) &&
+                (SYS_TIME_DeadlineCountGet() >= SYS_TIME_MSToCount(APP_POWER_STANDBY_MIN_MS)))
+            {
+                APP_POWER_AlignmentStart();
+                app_powerData.state = APP_POWER_STATE_ALIGN_WAIT;
+            }
+
+            APP_POWER_IdleSleep();
+            break;
+        }
+
+        case APP_POWER_STATE_ALIGN_WAIT:
+        {
+            if (app_powerData.alarmFired == true)
+            {
+                app_powerData.state = APP_POWER_STATE_RUN;
+                APP_POWER_StandbySleep();
+            }
+            else
+            {
+                APP_POWER_IdleSleep();
+            }
+            break;
+        }
+
+        default:
+        {
+            app_powerData.state = APP_POWER_STATE_RUN;
+            break;
+        }
+    }
+
+    SYS_INT_Restore(interruptState);
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_POWER_StatisticsGet ( APP_POWER_STATISTICS * stats )
+
+  Remarks:
+    See prototype in app_power.h.
+ */
+
+void APP_POWER_StatisticsGet( APP_POWER_STATISTICS * stats )
+{
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    *stats = app_powerData.stats;
+    stats->totalCount = SYS_TIME_Counter64Get() - app_powerData.startCount;
+
+    SYS_INT_Restore(interruptState);
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_POWER_StandbyEnable ( bool enable )
+
+  Remarks:
+    See prototype in app_power.h.
+ */
+
+void APP_POWER_StandbyEnable( bool enable )
+{
+    app_powerData.standbyEnable = enable;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
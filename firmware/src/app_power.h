@@ -0,0 +1,287 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_power.h
+
+  Summary:
+    This header file provides prototypes and definitions for the low power
+    idle task.
+
+  Description:
+    This header file provides function prototypes and data type definitions for
+    the low power idle task. The task runs last in SYS_Tasks and puts the
+    device to sleep until the next SYS_TIME deadline whenever every other task
+    is waiting for an event.
+*******************************************************************************/
+
+#ifndef _APP_POWER_H
+#define _APP_POWER_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Low power task states enumeration
+
+  Description:
+    This enumeration defines the valid low power task states.
+*/
+
+typedef enum
+{
+    /* Sleep in IDLE mode until the next deadline or interrupt */
+    APP_POWER_STATE_RUN,
+
+    /* An RTC alarm is armed for the next second boundary. Waiting for it
+     * before STANDBY so that the stopped time can be measured exactly. */
+    APP_POWER_STATE_ALIGN_WAIT,
+} APP_POWER_STATES;
+
+
+// *****************************************************************************
+/* Sleep statistics
+
+  Summary:
+    Holds the time spent awake and asleep
+
+  Description:
+    All times are in SYS_TIME counts (see SYS_TIME_FrequencyGet). The ratio
+    of idleCount + standbyCount to totalCount is the fraction of time the CPU
+    spent asleep since APP_POWER_Initialize.
+*/
+
+typedef struct
+{
+    /* Counts elapsed since the task was initialized */
+    uint64_t    totalCount;
+
+    /* Counts spent in IDLE sleep */
+    uint64_t    idleCount;
+
+    /* Counts spent in STANDBY, as measured against the RTC */
+    uint64_t    standbyCount;
+
+    /* Number of times each sleep mode was entered */
+    uint32_t    idleEntries;
+    uint32_t    standbyEntries;
+} APP_POWER_STATISTICS;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds low power task data
+
+  Description:
+    This structure holds the low power task's data.
+*/
+
+typedef struct
+{
+    /* Task's current state */
+    APP_POWER_STATES        state;
+
+    /* Second at which the alignment alarm fires */
+    struct tm               alignTime;
+
+    /* SYS_TIME counter captured in the alarm interrupt */
+    volatile uint32_t       alignCount;
+
+    /* Set by the RTC alarm interrupt */
+    volatile bool           alarmFired;
+
+    /* SYS_TIME counter at APP_POWER_Initialize */
+    uint64_t                startCount;
+
+    /* Long gaps are spent in STANDBY */
+    bool                    standbyEnable;
+
+    APP_POWER_STATISTICS    stats;
+} APP_POWER_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_POWER_Initialize ( void )
+
+  Summary:
+     Low power task initialization routine.
+
+  Description:
+    This function registers the RTC alarm callback and clears the sleep
+    statistics.
+
+  Precondition:
+    RTC_Initialize and SYS_TIME_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POWER_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void APP_POWER_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_POWER_Tasks ( void )
+
+  Summary:
+    Low power task function
+
+  Description:
+    When the application and SD card tasks are idle and the BME280 driver is
+    ready, this routine sleeps until the next SYS_TIME deadline. Gaps shorter
+    than APP_POWER_STANDBY_MIN_MS are spent in IDLE mode, where TC0 and all
+    peripheral interrupts keep running. Longer gaps are spent in STANDBY with
+    the RTC alarm as the wake source, after which the system counter is
+    advanced by the time TC0 was stopped.
+
+  Precondition:
+    APP_POWER_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POWER_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be the last call in SYS_Tasks().
+ */
+
+void APP_POWER_Tasks( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_POWER_StatisticsGet ( APP_POWER_STATISTICS * stats )
+
+  Summary:
+    Returns the sleep statistics
+
+  Description:
+    Copies the time spent asleep in each mode and the total elapsed time into
+    the given structure.
+
+  Precondition:
+    APP_POWER_Initialize should have been called.
+
+  Parameters:
+    stats - Destination of the statistics
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POWER_STATISTICS stats;
+    APP_POWER_StatisticsGet(&stats);
+    printf("asleep %lu%%\r\n",
+           (uint32_t)(((stats.idleCount + stats.standbyCount) * 100) / stats.totalCount));
+    </code>
+
+  Remarks:
+    None.
+ */
+
+void APP_POWER_StatisticsGet( APP_POWER_STATISTICS * stats );
+
+
+/*******************************************************************************
+  Function:
+    void APP_POWER_StandbyEnable ( bool enable )
+
+  Summary:
+    Allows or forbids STANDBY
+
+  Description:
+    With STANDBY allowed, gaps of at least APP_POWER_STANDBY_MIN_MS are spent
+    in STANDBY. Otherwise every gap is spent in IDLE mode. The task starts
+    with APP_POWER_STANDBY_ENABLE.
+
+  Precondition:
+    APP_POWER_Initialize should have been called.
+
+  Parameters:
+    enable - true to allow STANDBY
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_POWER_StandbyEnable(true);
+    </code>
+
+  Remarks:
+    The console USART and the SDHC are stopped in STANDBY: a key pressed then
+    is lost, and a card inserted then is seen at the next wake, at most
+    APP_POWER_STANDBY_MAX_S seconds away.
+ */
+
+void APP_POWER_StandbyEnable( bool enable );
+
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_POWER_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,873 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_query.c
+
+  Summary:
+    This file contains the source code for the download of logged data over
+    the console.
+
+  Description:
+    The index is read a few lines at a time and closed in between, so that
+    the SD card task can append to it. Each part of the log that may hold
+    records in range is read in sector aligned blocks into a cache aligned
+    buffer, which FatFs hands to the card's DMA directly. The text records
+    are converted to fixed point and packed into frames, two of which are
+    used in turn so that one is filled while the other is sent.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_query.h"
+#include "app_dmabuf.h"
+#include "app_sdcard.h"
+#include "app_timestamp.h"
+#include "peripheral/sercom/usart/plib_sercom2_usart.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_QUERY_MOUNT_NAME        SYS_FS_MEDIA_IDX0_MOUNT_NAME_VOLUME_IDX0
+#define APP_QUERY_INDEX_PATH        APP_QUERY_MOUNT_NAME "/" APP_SDCARD_INDEX_FILE
+
+/* Index lines read per call of the task */
+#define APP_QUERY_INDEX_LINES       32U
+
+/* Longest record or index line, and the path of a log file */
+#define APP_QUERY_LINE_LEN          128U
+#define APP_QUERY_PATH_LEN          64U
+
+#define APP_QUERY_SECTOR_LEN        512U
+#define APP_QUERY_HEADER_LEN        32U
+#define APP_QUERY_HEADER_TAG        "#LOG len="
+
+#define APP_QUERY_SYNC              0xA5U
+#define APP_QUERY_TYPE_START        'S'
+#define APP_QUERY_TYPE_DATA         'D'
+#define APP_QUERY_TYPE_END          'E'
+#define APP_QUERY_FRAME_HEADER_LEN  3U
+#define APP_QUERY_FRAME_CRC_LEN     2U
+#define APP_QUERY_RECORD_LEN        26U
+#define APP_QUERY_FRAME_SIZE        (APP_QUERY_FRAME_HEADER_LEN + (APP_QUERY_FRAME_RECORDS * APP_QUERY_RECORD_LEN) + \
+                                     APP_QUERY_FRAME_CRC_LEN)
+
+/* Set in the milliseconds of a record that has the derived quantities */
+#define APP_QUERY_DERIVED_FLAG      0x8000U
+
+/* Logged values: temperature, pressure, humidity, then dew point, absolute
+ * humidity, pressure altitude and sea-level pressure */
+#define APP_QUERY_VALUES            7U
+#define APP_QUERY_VALUES_BASIC      3U
+
+/* Days from 0000/03/01 to 2000/01/01 in the proleptic Gregorian calendar */
+#define APP_QUERY_DAYS_TO_2000      730425U
+#define APP_QUERY_SECONDS_PER_DAY   86400U
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds query data
+
+  Description:
+    This structure holds the query's data.
+
+  Remarks:
+    This structure should be initialized by the APP_QUERY_Initialize function.
+*/
+
+APP_QUERY_DATA app_queryData;
+
+/* The start of a record cut by the end of a block is moved in front of the
+ * next block, which is read at APP_QUERY_LINE_LEN, a multiple of the cache
+ * line. The buffer is taken from the DMA buffer pool for a download. */
+static uint8_t* app_queryBuffer = NULL;
+
+static uint8_t app_queryFrame[2][APP_QUERY_FRAME_SIZE];
+
+/* Decimals of each logged value */
+static const uint8_t app_queryDecimals[APP_QUERY_VALUES] = { 2, 2, 1, 2, 2, 2, 2 };
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint16_t APP_QUERY_Crc16(uint16_t crc, const uint8_t* data, size_t length)
+{
+    uint8_t bit;
+
+    while (length-- > 0U)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* Parse "YYYY/MM/DD hh:mm:ss" as YYYYMMDDhhmmss */
+static bool APP_QUERY_TimeParse(const char* text, uint64_t* time)
+{
+    static const char format[] = "0000/00/00 00:00:00";
+    uint32_t i;
+
+    *time = 0;
+
+    for (i = 0; format[i] != '\0'; i++)
+    {
+        if (format[i] == '0')
+        {
+            if ((text[i] < '0') || (text[i] > '9'))
+            {
+                return false;
+            }
+
+            *time = (*time * 10U) + (uint64_t)(text[i] - '0');
+        }
+        else if (text[i] != format[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Parse a number of exactly count digits */
+static bool APP_QUERY_DigitsParse(const char* text, uint32_t count, uint64_t* value)
+{
+    *value = 0;
+
+    while (count-- > 0U)
+    {
+        if ((*text < '0') || (*text > '9'))
+        {
+            return false;
+        }
+
+        *value = (*value * 10U) + (uint64_t)(*text++ - '0');
+    }
+
+    return true;
+}
+
+/* Parse a number printed with the given decimals, as an integer in units of
+ * its last decimal */
+static bool APP_QUERY_FixedParse(const char** text, uint32_t decimals, int32_t* value)
+{
+    const char* c = *text;
+    bool isNegative = false;
+    uint32_t count = 0;
+
+    *value = 0;
+
+    while (*c == ' ')
+    {
+        c++;
+    }
+
+    if (*c == '-')
+    {
+        isNegative = true;
+        c++;
+    }
+
+    if ((*c < '0') || (*c > '9'))
+    {
+        return false;
+    }
+
+    while ((*c >= '0') && (*c <= '9'))
+    {
+        *value = (*value * 10) + (*c++ - '0');
+    }
+
+    if (*c == '.')
+    {
+        c++;
+
+        while ((count < decimals) && (*c >= '0') && (*c <= '9'))
+        {
+            *value = (*value * 10) + (*c++ - '0');
+            count++;
+        }
+    }
+
+    while (count++ < decimals)
+    {
+        *value *= 10;
+    }
+
+    if (isNegative == true)
+    {
+        *value = -*value;
+    }
+
+    *text = c;
+
+    return true;
+}
+
+/* Seconds from 2000/01/01 00:00:00 to a YYYYMMDDhhmmss time, or 0 before */
+static uint32_t APP_QUERY_Seconds(uint64_t time)
+{
+    uint32_t second = (uint32_t)(time % 100U);
+    uint32_t minute = (uint32_t)((time / 100U) % 100U);
+    uint32_t hour = (uint32_t)((time / 10000U) % 100U);
+    uint32_t day = (uint32_t)((time / 1000000U) % 100U);
+    uint32_t month = (uint32_t)((time / 100000000U) % 100U);
+    uint32_t year = (uint32_t)(time / 10000000000ULL);
+    uint32_t days;
+
+    if (year < 2000U)
+    {
+        return 0;
+    }
+
+    /* Count the years from March, so that the leap day ends them */
+    if (month <= 2U)
+    {
+        year--;
+        month += 12U;
+    }
+
+    days = (365U * year) + (year / 4U) - (year / 100U) + (year / 400U) +
+           (((153U * (month - 3U)) + 2U) / 5U) + day - 1U - APP_QUERY_DAYS_TO_2000;
+
+    return (days * APP_QUERY_SECONDS_PER_DAY) + (hour * 3600U) + (minute * 60U) + second;
+}
+
+static void APP_QUERY_FramePut(uint32_t value, uint32_t size)
+{
+    uint8_t* frame = app_queryFrame[app_queryData.frameIndex];
+
+    while (size-- > 0U)
+    {
+        frame[app_queryData.frameLength++] = (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+static void APP_QUERY_FrameBegin(uint8_t type)
+{
+    uint8_t* frame = app_queryFrame[app_queryData.frameIndex];
+
+    frame[0] = APP_QUERY_SYNC;
+    frame[1] = type;
+    app_queryData.frameLength = APP_QUERY_FRAME_HEADER_LEN;
+}
+
+/* Complete the frame, which is sent once the previous one is out */
+static void APP_QUERY_FrameSend(APP_QUERY_STATES nextState)
+{
+    uint8_t* frame = app_queryFrame[app_queryData.frameIndex];
+
+    frame[2] = (uint8_t)(app_queryData.frameLength - APP_QUERY_FRAME_HEADER_LEN);
+    APP_QUERY_FramePut(APP_QUERY_Crc16(0xFFFFU, &frame[1], app_queryData.frameLength - 1U), APP_QUERY_FRAME_CRC_LEN);
+
+    app_queryData.frameRecords = 0;
+    app_queryData.nextState = nextState;
+    app_queryData.state = APP_QUERY_STATE_SEND;
+}
+
+/* Add a record to the data frame if it is in range */
+static void APP_QUERY_RecordAdd(const char* line)
+{
+    int32_t value[APP_QUERY_VALUES] = { 0 };
+    uint64_t time;
+    uint64_t milliseconds;
+    uint32_t count;
+    const char* text;
+
+    /* "[YYYY/MM/DD hh:mm:ss.mmm]" */
+    if ((line[0] != '[') || (APP_QUERY_TimeParse(&line[1], &time) == false) || (line[20] != '.') ||
+        (APP_QUERY_DigitsParse(&line[21], 3, &milliseconds) == false) || (line[24] != ']'))
+    {
+        return;
+    }
+
+    if ((time < app_queryData.from) || (time > app_queryData.to))
+    {
+        return;
+    }
+
+    /* The seal of a journaled record is not a number */
+    text = &line[25];
+    for (count = 0; count < APP_QUERY_VALUES; count++)
+    {
+        if (APP_QUERY_FixedParse(&text, app_queryDecimals[count], &value[count]) == false)
+        {
+            break;
+        }
+    }
+
+    if (count < APP_QUERY_VALUES_BASIC)
+    {
+        return;
+    }
+
+    /* The derived quantities are left at 0 if they are not logged */
+    if (count == APP_QUERY_VALUES)
+    {
+        milliseconds |= APP_QUERY_DERIVED_FLAG;
+    }
+
+    if (app_queryData.frameRecords == 0U)
+    {
+        APP_QUERY_FrameBegin(APP_QUERY_TYPE_DATA);
+    }
+
+    APP_QUERY_FramePut(APP_QUERY_Seconds(time), 4);
+    APP_QUERY_FramePut((uint32_t)milliseconds, 2);
+    APP_QUERY_FramePut((uint32_t)value[0], 2);
+    APP_QUERY_FramePut((uint32_t)value[1], 4);
+    APP_QUERY_FramePut((uint32_t)value[2], 2);
+    APP_QUERY_FramePut((uint32_t)value[3], 2);
+    APP_QUERY_FramePut((uint32_t)value[4], 2);
+    APP_QUERY_FramePut((uint32_t)value[5], 4);
+    APP_QUERY_FramePut((uint32_t)value[6], 4);
+
+    app_queryData.frameRecords++;
+    app_queryData.recordCount++;
+}
+
+/* Frame the complete records in the read buffer. Returns true when the frame
+ * is full. */
+static bool APP_QUERY_RecordsFrame(void)
+{
+    uint8_t* start;
+    uint8_t* end;
+    uint32_t length;
+
+    while (app_queryData.frameRecords < APP_QUERY_FRAME_RECORDS)
+    {
+        start = &app_queryBuffer[app_queryData.dataStart];
+        length = app_queryData.dataEnd - app_queryData.dataStart;
+        end = memchr(start, '\n', length);
+
+        if (end == NULL)
+        {
+            /* Keep the start of the next record in front of the next block.
+             * A longer line is not a record. */
+            if (length >= APP_QUERY_LINE_LEN)
+            {
+                length = 0;
+            }
+
+            memmove(&app_queryBuffer[APP_QUERY_LINE_LEN - length], &app_queryBuffer[app_queryData.dataEnd - length],
+                    length);
+            app_queryData.dataStart = APP_QUERY_LINE_LEN - length;
+            app_queryData.dataEnd = APP_QUERY_LINE_LEN;
+
+            return false;
+        }
+
+        *end = '\0';
+        APP_QUERY_RecordAdd((const char*)start);
+        app_queryData.dataStart = (uint32_t)(end + 1 - app_queryBuffer);
+    }
+
+    return true;
+}
+
+static void APP_QUERY_FileClose(void)
+{
+    if (app_queryData.fileHandle != SYS_FS_HANDLE_INVALID)
+    {
+        SYS_FS_FileClose(app_queryData.fileHandle);
+        app_queryData.fileHandle = SYS_FS_HANDLE_INVALID;
+    }
+
+    app_queryData.fileName[0] = '\0';
+    app_queryData.isFileMissing = false;
+}
+
+/* Open a log file that is not being logged to. Its valid length is in its
+ * header. */
+static bool APP_QUERY_FileOpen(void)
+{
+    char path[APP_QUERY_PATH_LEN];
+    char header[APP_QUERY_HEADER_LEN + 1U];
+
+    sprintf(path, APP_QUERY_MOUNT_NAME "/%s", app_queryData.fileName);
+    app_queryData.fileHandle = SYS_FS_FileOpen(path, (SYS_FS_FILE_OPEN_READ));
+
+    if (app_queryData.fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    header[APP_QUERY_HEADER_LEN] = '\0';
+
+    if ((SYS_FS_FileRead(app_queryData.fileHandle, header, APP_QUERY_HEADER_LEN) == APP_QUERY_HEADER_LEN) &&
+        (strncmp(header, APP_QUERY_HEADER_TAG, strlen(APP_QUERY_HEADER_TAG)) == 0))
+    {
+        app_queryData.fileLength = (uint32_t)strtoul(&header[strlen(APP_QUERY_HEADER_TAG)], NULL, 10);
+        app_queryData.filePosition = APP_QUERY_HEADER_LEN;
+    }
+    else
+    {
+        app_queryData.fileLength = (uint32_t)SYS_FS_FileSize(app_queryData.fileHandle);
+        app_queryData.filePosition = UINT32_MAX;
+    }
+
+    return true;
+}
+
+/* Read from the log file being queried. The file being logged to is read
+ * through the SD card task, as FatFs does not open a file being written. */
+static int32_t APP_QUERY_FileRead(uint32_t offset, uint8_t* buffer, uint32_t size)
+{
+    int32_t length;
+
+    if (app_queryData.isFileMissing == true)
+    {
+        return 0;
+    }
+
+    if (app_queryData.fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        length = APP_SDCARD_LogRead(app_queryData.fileName, offset, buffer, size);
+
+        if (length >= 0)
+        {
+            return length;
+        }
+
+        /* Deleted files stay in the index */
+        if (APP_QUERY_FileOpen() == false)
+        {
+            app_queryData.isFileMissing = true;
+            return 0;
+        }
+    }
+
+    if (offset >= app_queryData.fileLength)
+    {
+        return 0;
+    }
+
+    if (size > (app_queryData.fileLength - offset))
+    {
+        size = app_queryData.fileLength - offset;
+    }
+
+    if ((offset != app_queryData.filePosition) &&
+        (SYS_FS_FileSeek(app_queryData.fileHandle, (int32_t)offset, SYS_FS_SEEK_SET) == -1))
+    {
+        return -1;
+    }
+
+    if (SYS_FS_FileRead(app_queryData.fileHandle, buffer, size) != size)
+    {
+        app_queryData.filePosition = UINT32_MAX;
+        return -1;
+    }
+
+    app_queryData.filePosition = offset + size;
+
+    return (int32_t)size;
+}
+
+/* Read the log from an index entry up to an offset */
+static void APP_QUERY_PartStart(const APP_QUERY_INDEX_ENTRY* entry, uint32_t endOffset)
+{
+    if (strcmp(entry->name, app_queryData.fileName) != 0)
+    {
+        APP_QUERY_FileClose();
+        strcpy(app_queryData.fileName, entry->name);
+        app_queryData.readOffset = UINT32_MAX;
+        app_queryData.endOffset = UINT32_MAX;
+        app_queryData.fileCount++;
+    }
+
+    /* Reads end on a sector, past the end of the part. A part that starts
+     * in what has been read follows on from it; the records read past the
+     * end of the last part are outside the range. */
+    if ((entry->offset < app_queryData.endOffset) || (entry->offset > app_queryData.readOffset))
+    {
+        app_queryData.readOffset = entry->offset & ~(APP_QUERY_SECTOR_LEN - 1U);
+        app_queryData.skipLength = entry->offset - app_queryData.readOffset;
+        app_queryData.dataStart = APP_QUERY_LINE_LEN;
+        app_queryData.dataEnd = APP_QUERY_LINE_LEN;
+        app_queryData.seekCount++;
+    }
+
+    app_queryData.endOffset = endOffset;
+    app_queryData.state = APP_QUERY_STATE_READ;
+}
+
+/* Start reading the part of the log from an entry to the next one, if it
+ * may hold records in range. Times only go back at a reset, which is marked
+ * in the index, so the records of a part are no earlier than its entry and,
+ * unless the next entry follows a reset, no later than the next one. */
+static bool APP_QUERY_PartSelect(const APP_QUERY_INDEX_ENTRY* entry, const APP_QUERY_INDEX_ENTRY* next)
+{
+    bool isSameFile = (next != NULL) && (strcmp(entry->name, next->name) == 0);
+
+    if (entry->time > app_queryData.to)
+    {
+        return false;
+    }
+
+    if ((next != NULL) && (next->isReset == false) && (next->time < app_queryData.from))
+    {
+        return false;
+    }
+
+    if ((app_queryData.isFileMissing == true) && (strcmp(entry->name, app_queryData.fileName) == 0))
+    {
+        return false;
+    }
+
+    APP_QUERY_PartStart(entry, (isSameFile == true) ? next->offset : UINT32_MAX);
+
+    return true;
+}
+
+/* "YYYY/MM/DD hh:mm:ss <name> <offset>", followed by a tag after a reset */
+static bool APP_QUERY_IndexParse(const char* line, APP_QUERY_INDEX_ENTRY* entry)
+{
+    char tag[sizeof(APP_SDCARD_INDEX_RESET)];
+    unsigned long offset;
+    int count;
+
+    if (APP_QUERY_TimeParse(line, &entry->time) == false)
+    {
+        return false;
+    }
+
+    count = sscanf(&line[19], " %31s %lu %5s", entry->name, &offset, tag);
+
+    if (count < 2)
+    {
+        return false;
+    }
+
+    entry->offset = (uint32_t)offset;
+    entry->isReset = (count == 3) && (strcmp(tag, APP_SDCARD_INDEX_RESET) == 0);
+
+    return true;
+}
+
+/* Read the index up to the next part to send */
+static void APP_QUERY_IndexNext(void)
+{
+    SYS_FS_HANDLE handle;
+    APP_QUERY_INDEX_ENTRY next;
+    char line[APP_QUERY_LINE_LEN];
+    uint32_t count = 0;
+    int32_t position;
+    bool isEnd = false;
+    bool isPart = false;
+
+    handle = SYS_FS_FileOpen(APP_QUERY_INDEX_PATH, (SYS_FS_FILE_OPEN_READ));
+
+    if (handle == SYS_FS_HANDLE_INVALID)
+    {
+        app_queryData.status = APP_QUERY_STATUS_NO_INDEX;
+        app_queryData.state = APP_QUERY_STATE_END;
+        return;
+    }
+
+    if (SYS_FS_FileSeek(handle, (int32_t)app_queryData.indexPosition, SYS_FS_SEEK_SET) == -1)
+    {
+        isEnd = true;
+    }
+
+    while ((isEnd == false) && (isPart == false) && (count < APP_QUERY_INDEX_LINES))
+    {
+        if ((SYS_FS_FileEOF(handle) == true) ||
+            (SYS_FS_FileStringGet(handle, line, sizeof(line)) != SYS_FS_RES_SUCCESS))
+        {
+            isEnd = true;
+            break;
+        }
+
+        count++;
+
+        if (APP_QUERY_IndexParse(line, &next) == false)
+        {
+            continue;
+        }
+
+        if (app_queryData.isEntryValid == true)
+        {
+            isPart = APP_QUERY_PartSelect(&app_queryData.entry, &next);
+        }
+
+        app_queryData.entry = next;
+        app_queryData.isEntryValid = true;
+    }
+
+    position = SYS_FS_FileTell(handle);
+    SYS_FS_FileClose(handle);
+
+    if (position != -1)
+    {
+        app_queryData.indexPosition = (uint32_t)position;
+    }
+
+    if ((isEnd == true) && (isPart == false))
+    {
+        /* The last entry's part runs to the end of its file */
+        if ((app_queryData.isEntryValid == false) || (APP_QUERY_PartSelect(&app_queryData.entry, NULL) == false))
+        {
+            app_queryData.state = APP_QUERY_STATE_END;
+        }
+
+        app_queryData.isEntryValid = false;
+    }
+}
+
+/* Parse a YYYYMMDDhhmmss time of the request */
+static bool APP_QUERY_RangeTimeParse(const char** text, uint64_t* time)
+{
+    const char* c = *text;
+
+    while (*c == ' ')
+    {
+        c++;
+    }
+
+    if ((APP_QUERY_DigitsParse(c, 14, time) == false) || ((c[14] >= '0') && (c[14] <= '9')))
+    {
+        return false;
+    }
+
+    *text = c + 14;
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_QUERY_Initialize ( void )
+
+  Remarks:
+    See prototype in app_query.h.
+ */
+
+void APP_QUERY_Initialize ( void )
+{
+    app_queryData.state = APP_QUERY_STATE_IDLE;
+    app_queryData.nextState = APP_QUERY_STATE_IDLE;
+    app_queryData.fileHandle = SYS_FS_HANDLE_INVALID;
+    app_queryData.fileName[0] = '\0';
+    app_queryData.isFileMissing = false;
+    app_queryData.frameIndex = 0;
+    app_queryData.frameLength = 0;
+    app_queryData.frameRecords = 0;
+}
+
+
+/*******************************************************************************
+  Function:
+    bool APP_QUERY_Request ( const char* range )
+
+  Remarks:
+    See prototype in app_query.h.
+ */
+
+bool APP_QUERY_Request ( const char* range )
+{
+    uint64_t from;
+    uint64_t to;
+
+    if ((app_queryData.state != APP_QUERY_STATE_IDLE) ||
+        (APP_QUERY_RangeTimeParse(&range, &from) == false) ||
+        (APP_QUERY_RangeTimeParse(&range, &to) == false) || (from > to))
+    {
+        return false;
+    }
+
+    app_queryBuffer = APP_DMABUF_Acquire(APP_QUERY_LINE_LEN + APP_QUERY_READ_SIZE);
+
+    if (app_queryBuffer == NULL)
+    {
+        return false;
+    }
+
+    app_queryData.from = from;
+    app_queryData.to = to;
+    app_queryData.indexPosition = 0;
+    app_queryData.isEntryValid = false;
+    app_queryData.readOffset = UINT32_MAX;
+    app_queryData.recordCount = 0;
+    app_queryData.fileCount = 0;
+    app_queryData.seekCount = 0;
+    app_queryData.byteCount = 0;
+    app_queryData.status = APP_QUERY_STATUS_OK;
+    app_queryData.startTimeUs = APP_TIMESTAMP_US_Get();
+    APP_QUERY_FileClose();
+
+    APP_QUERY_FrameBegin(APP_QUERY_TYPE_START);
+    APP_QUERY_FramePut(APP_QUERY_Seconds(from), 4);
+    APP_QUERY_FramePut(APP_QUERY_Seconds(to), 4);
+    APP_QUERY_FramePut(APP_QUERY_RECORD_LEN, 1);
+    APP_QUERY_FrameSend(APP_QUERY_STATE_INDEX);
+
+    return true;
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_QUERY_Tasks ( void )
+
+  Remarks:
+    See prototype in app_query.h.
+ */
+
+void APP_QUERY_Tasks ( void )
+{
+    uint32_t size;
+    int32_t length;
+
+    switch (app_queryData.state)
+    {
+        case APP_QUERY_STATE_INDEX:
+        {
+            APP_QUERY_IndexNext();
+            break;
+        }
+
+        case APP_QUERY_STATE_READ:
+        {
+            if (APP_QUERY_RecordsFrame() == true)
+            {
+                APP_QUERY_FrameSend(APP_QUERY_STATE_READ);
+                break;
+            }
+
+            if (app_queryData.readOffset >= app_queryData.endOffset)
+            {
+                app_queryData.state = APP_QUERY_STATE_INDEX;
+                break;
+            }
+
+            /* Up to the end of the sector that holds the end of the part, so
+             * that the next block starts on a sector too and FatFs reads
+             * its whole sectors into the aligned buffer */
+            size = APP_QUERY_READ_SIZE;
+            if ((app_queryData.endOffset - app_queryData.readOffset) < APP_QUERY_READ_SIZE)
+            {
+                size = (app_queryData.endOffset - app_queryData.readOffset + APP_QUERY_SECTOR_LEN - 1U) &
+                       ~(APP_QUERY_SECTOR_LEN - 1U);
+            }
+
+            length = APP_QUERY_FileRead(app_queryData.readOffset, &app_queryBuffer[APP_QUERY_LINE_LEN], size);
+
+            if (length < 0)
+            {
+                app_queryData.status = APP_QUERY_STATUS_READ_ERROR;
+                app_queryData.state = APP_QUERY_STATE_END;
+                break;
+            }
+
+            if (length == 0)
+            {
+                /* End of the valid data of the file */
+                app_queryData.state = APP_QUERY_STATE_INDEX;
+                break;
+            }
+
+            app_queryData.byteCount += (uint32_t)length;
+            app_queryData.readOffset += (uint32_t)length;
+            app_queryData.dataEnd = APP_QUERY_LINE_LEN + (uint32_t)length;
+            app_queryData.dataStart += app_queryData.skipLength;
+            app_queryData.skipLength = 0;
+
+            if (app_queryData.dataStart > app_queryData.dataEnd)
+            {
+                app_queryData.dataStart = app_queryData.dataEnd;
+            }
+            break;
+        }
+
+        case APP_QUERY_STATE_SEND:
+        {
+            /* Fails while the previous frame or console text is sent */
+            if (SERCOM2_USART_Write(app_queryFrame[app_queryData.frameIndex], app_queryData.frameLength) == true)
+            {
+                app_queryData.frameIndex ^= 1U;
+                app_queryData.state = app_queryData.nextState;
+            }
+            break;
+        }
+
+        case APP_QUERY_STATE_END:
+        {
+            if (app_queryData.frameRecords > 0U)
+            {
+                APP_QUERY_FrameSend(APP_QUERY_STATE_END);
+                break;
+            }
+
+            APP_QUERY_FileClose();
+            APP_DMABUF_Release(app_queryBuffer);
+            app_queryBuffer = NULL;
+
+            APP_QUERY_FrameBegin(APP_QUERY_TYPE_END);
+            APP_QUERY_FramePut(app_queryData.recordCount, 4);
+            APP_QUERY_FramePut(app_queryData.fileCount, 4);
+            APP_QUERY_FramePut(app_queryData.seekCount, 4);
+            APP_QUERY_FramePut(app_queryData.byteCount, 4);
+            APP_QUERY_FramePut((uint32_t)((APP_TIMESTAMP_US_Get() - app_queryData.startTimeUs) / 1000U), 4);
+            APP_QUERY_FramePut((uint32_t)app_queryData.status, 1);
+            APP_QUERY_FrameSend(APP_QUERY_STATE_IDLE);
+            break;
+        }
+
+        case APP_QUERY_STATE_IDLE:
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_QUERY_IsIdle ( void )
+
+  Remarks:
+    See prototype in app_query.h.
+ */
+
+bool APP_QUERY_IsIdle ( void )
+{
+    return (app_queryData.state == APP_QUERY_STATE_IDLE);
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,367 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_query.h
+
+  Summary:
+    This header file provides prototypes and definitions for the download of
+    logged data over the console.
+
+  Description:
+    The console command
+
+        2 <from> <to>
+
+    with both times as YYYYMMDDhhmmss sends the records logged between the two
+    times, both included, in binary frames on the console. The line ends
+    with a carriage return or a line feed. Frames have the form
+
+        0xA5 <type> <length> <payload> <CRC>
+
+    The length is that of the payload, up to 255 bytes. The CRC is the
+    CRC-16/CCITT-FALSE of the type, length and payload, sent least
+    significant byte first. Console text printed from the request until the
+    end frame has been queued is dropped, so only frames follow the command.
+    A client still looks for 0xA5, as text printed before the request may be
+    on its way, and drops frames whose CRC does not match. All values are
+    little endian. firmware/host/client/query_client.c is such a client.
+
+      'S' start    from and to, as uint32 seconds since 2000/01/01 00:00:00,
+                   and the size of a record in bytes
+      'D' data     up to APP_QUERY_FRAME_RECORDS records of 26 bytes:
+                     uint32 time, seconds since 2000/01/01 00:00:00
+                     uint16 milliseconds; bit 15 set if the derived
+                            quantities are logged
+                     int16  temperature, 0.01 degC
+                     uint32 pressure, Pa
+                     uint16 relative humidity, 0.1 %RH
+                     int16  dew point, 0.01 degC
+                     uint16 absolute humidity, 0.01 g/m^3
+                     int32  pressure altitude, cm
+                     uint32 sea-level pressure, Pa
+      'E' end      uint32 records sent, log files visited, seeks within
+                   them and bytes read from the card, uint32 time taken in
+                   ms, and a status byte, one of APP_QUERY_STATUS
+
+    The log index is used to skip the parts of the log that are outside the
+    range. Each entry starts a part that ends at the next entry in the same
+    file. Only the parts that may hold records in range are read, in blocks
+    of APP_QUERY_READ_SIZE bytes aligned on the card's sectors. Records still
+    in the SD card task's staging buffer are not sent.
+*******************************************************************************/
+
+#ifndef _APP_QUERY_H
+#define _APP_QUERY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+#include "system/fs/sys_fs.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Query states enumeration
+
+  Description:
+    This enumeration defines the valid query states.
+*/
+
+typedef enum
+{
+    /* No query in progress */
+    APP_QUERY_STATE_IDLE,
+
+    /* Read the index up to the next part of the log to send */
+    APP_QUERY_STATE_INDEX,
+
+    /* Read the part of the log and frame its records in range */
+    APP_QUERY_STATE_READ,
+
+    /* Send the frame once the previous one is out */
+    APP_QUERY_STATE_SEND,
+
+    /* Send the last records and the end frame */
+    APP_QUERY_STATE_END,
+} APP_QUERY_STATES;
+
+
+// *****************************************************************************
+/* Query status
+
+  Summary:
+    Status sent in the end frame
+*/
+
+typedef enum
+{
+    APP_QUERY_STATUS_OK = 0,
+
+    /* The log index could not be read */
+    APP_QUERY_STATUS_NO_INDEX,
+
+    /* A log file could not be read */
+    APP_QUERY_STATUS_READ_ERROR,
+} APP_QUERY_STATUS;
+
+
+// *****************************************************************************
+/* Index Entry
+
+  Summary:
+    One line of the log index
+*/
+
+typedef struct
+{
+    /* Time of the record at the offset, as YYYYMMDDhhmmss */
+    uint64_t    time;
+
+    /* Log file and offset of the record in it */
+    char        name[32];
+    uint32_t    offset;
+
+    /* First entry after a reset */
+    bool        isReset;
+} APP_QUERY_INDEX_ENTRY;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds query data
+
+  Description:
+    This structure holds the query's data.
+
+  Remarks:
+    The read buffer and frames are defined outside this structure.
+ */
+
+typedef struct
+{
+    /* Query's current state, and the state that follows a frame */
+    APP_QUERY_STATES    state;
+    APP_QUERY_STATES    nextState;
+
+    /* Time range, as YYYYMMDDhhmmss */
+    uint64_t            from;
+    uint64_t            to;
+
+    /* Offset of the next line of the index, and the entry read last */
+    uint32_t            indexPosition;
+    APP_QUERY_INDEX_ENTRY entry;
+    bool                isEntryValid;
+
+    /* Log file being read. The handle is only opened if the file is not
+     * the one being logged to. */
+    char                fileName[32];
+    SYS_FS_HANDLE       fileHandle;
+    bool                isFileMissing;
+
+    /* Valid length of the file, and file offset of its handle */
+    uint32_t            fileLength;
+    uint32_t            filePosition;
+
+    /* File offset of the next block and end of the part being read */
+    uint32_t            readOffset;
+    uint32_t            endOffset;
+
+    /* Unparsed data in the read buffer, and bytes to skip in the next
+     * block to reach the start of a part */
+    uint32_t            dataStart;
+    uint32_t            dataEnd;
+    uint32_t            skipLength;
+
+    /* Frame being filled, and the number of records in it */
+    uint32_t            frameIndex;
+    uint32_t            frameLength;
+    uint32_t            frameRecords;
+
+    /* Totals sent in the end frame */
+    uint32_t            recordCount;
+    uint32_t            fileCount;
+    uint32_t            seekCount;
+    uint32_t            byteCount;
+    APP_QUERY_STATUS    status;
+
+    /* APP_TIMESTAMP time of the request, in microseconds */
+    uint64_t            startTimeUs;
+} APP_QUERY_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_QUERY_Initialize ( void )
+
+  Summary:
+     Query initialization routine.
+
+  Description:
+    This function places the query in its idle state.
+
+  Precondition:
+    None.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_QUERY_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void APP_QUERY_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_QUERY_Request ( const char* range )
+
+  Summary:
+    Starts sending the records logged in a time range
+
+  Description:
+    Parses the range and queues the start frame. The records follow as
+    APP_QUERY_Tasks reads them.
+
+  Precondition:
+    APP_QUERY_Initialize should have been called.
+
+  Parameters:
+    range - "<from> <to>", both as YYYYMMDDhhmmss
+
+  Returns:
+    false if the range is not valid, a query is in progress or the DMA
+    buffer pool has no room for the read buffer.
+
+  Example:
+    <code>
+    if (APP_QUERY_Request("20260101000000 20260131235959") == false)
+    {
+        printf("Query not started \r\n");
+    }
+    </code>
+
+  Remarks:
+    None.
+ */
+
+bool APP_QUERY_Request( const char* range );
+
+
+/*******************************************************************************
+  Function:
+    void APP_QUERY_Tasks ( void )
+
+  Summary:
+    Query tasks function
+
+  Description:
+    Reads the index and the log and sends the frames of a query.
+
+  Precondition:
+    APP_QUERY_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_QUERY_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine, after
+    APP_SDCARD_Tasks.
+ */
+
+void APP_QUERY_Tasks( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_QUERY_IsIdle ( void )
+
+  Summary:
+    Reports whether the query is waiting for an event
+
+  Description:
+    The query is busy from the request until its end frame has been sent.
+
+  Precondition:
+    APP_QUERY_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if no query is in progress.
+
+  Example:
+    <code>
+    if (APP_QUERY_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task.
+ */
+
+bool APP_QUERY_IsIdle( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_QUERY_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -28,9 +28,15 @@
 // *****************************************************************************
 
 #include "app_sdcard.h"
+#include "app_config.h"
+#include "app_dmabuf.h"
+#include "app_flashlog.h"
+#include "app_timestamp.h"
 #include "peripheral/rtc/plib_rtc.h"
 #include "peripheral/port/plib_port.h"
+#include "peripheral/sdhc/plib_sdhc1.h"
 #include "system/fs/sys_fs.h"
+#include "system/time/sys_time.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -39,7 +45,8 @@
 // *****************************************************************************
 #define SDCARD_MOUNT_NAME    SYS_FS_MEDIA_IDX0_MOUNT_NAME_VOLUME_IDX0
 #define SDCARD_DEV_NAME      SYS_FS_MEDIA_IDX0_DEVICE_NAME_VOLUME_IDX0
-#define SDCARD_FILE_NAME     "data_log.txt"
+#define SDCARD_FILE_PREFIX   "data_"
+#define SDCARD_FILE_SUFFIX   ".txt"
 
 #define BUILD_TIME_HOUR     ((__TIME__[0] - '0') * 10 + __TIME__[1] - '0')
 #define BUILD_TIME_MIN      ((__TIME__[3] - '0') * 10 + __TIME__[4] - '0')
@@ -49,6 +56,28 @@
 #define LOG_TEMP_LEN        18
 #define LOG_LEN             (LOG_TIME_LEN + LOG_TEMP_LEN)
 
+/* The log file starts with a fixed size text line holding the number of valid
+ * bytes in the file and the session number of the file. The file is
+ * preallocated, so its size on the card is not the amount of data written
+ * until it is closed. */
+#define LOG_HEADER_LEN      32
+#define LOG_HEADER_TAG      "#LOG len="
+
+#define LOG_SECTOR_LEN      512U
+#define LOG_RECORD_LEN      128
+#define LOG_PATH_LEN        64
+
+/* Date of a struct tm as YYYYMMDD */
+#define LOG_DATE(t)         ((uint32_t)(((t)->tm_year + 1900) * 10000) + (uint32_t)(((t)->tm_mon + 1) * 100) + \
+                             (uint32_t)(t)->tm_mday)
+
+/* Journaled records end with a seal, " *SSSSSSSS CCCC\r\n", holding their
+ * sequence number and the CRC-16/CCITT of the session number followed by the
+ * record up to the end of the sequence number. Records from an earlier
+ * session left in reused clusters fail the CRC. */
+#define LOG_SEAL_LEN        17
+#define LOG_SEAL_CRC_LEN    7
+
 // *****************************************************************************
 /* Application Data
 
@@ -66,19 +95,41 @@
 
 APP_SDCARD_DATA app_sdcardData;
 
+/* Records are staged here until a whole buffer can be written. The buffer
+ * comes from the DMA buffer pool and mirrors the file from a sector
+ * boundary, so FatFs passes it to the card's DMA directly instead of copying
+ * it through its sector window. */
+static uint8_t* app_sdcardLogBuffer = NULL;
+
+/* Blocks of the sample pool */
+static APP_SDCARD_SAMPLE app_sdcardSamples[APP_SDCARD_SAMPLE_RECORDS];
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Application Callback Functions
 // *****************************************************************************
 // *****************************************************************************
-void APP_SDCARD_Notify(double temperature, double pressure, double humidity)
+void APP_SDCARD_Notify(uint64_t timestamp, double temperature, double pressure, double humidity,
+                       const APP_METEO_DATA* derived)
 {
+    APP_SDCARD_SAMPLE* sample = APP_POOL_Alloc(&app_sdcardData.samplePool);
+
+    /* The pool holds as many samples as the queue */
+    if (sample == NULL)
+    {
+        return;
+    }
+
     /* New weather data ready */
-    app_sdcardData.temperature = temperature;
-    app_sdcardData.pressure = pressure;
-    app_sdcardData.humidity = humidity;
-    
-    app_sdcardData.isDataReady = true;
+    sample->timestamp = timestamp;
+    sample->temperature = temperature;
+    sample->pressure = pressure;
+    sample->humidity = humidity;
+    sample->derived = *derived;
+
+    app_sdcardData.sampleQueue[app_sdcardData.sampleIn] = sample;
+    app_sdcardData.sampleIn = (app_sdcardData.sampleIn + 1U) % APP_SDCARD_SAMPLE_RECORDS;
+    app_sdcardData.sampleCount++;
 }
 
 // *****************************************************************************
@@ -86,6 +137,949 @@ void APP_SDCARD_Notify(double temperature, double pressure, double humidity)
 // Section: Application Local Functions
 // *****************************************************************************
 // *****************************************************************************
+static void APP_SDCARD_HeaderFormat(uint8_t* header, uint32_t validLength)
+{
+    char line[LOG_HEADER_LEN + 1];
+
+    sprintf(line, LOG_HEADER_TAG "%010lu s=%08lX\r\n", (unsigned long)validLength,
+            (unsigned long)app_sdcardData.session);
+    memcpy(header, line, LOG_HEADER_LEN);
+}
+
+static bool APP_SDCARD_HexParse(const char* text, uint32_t digits, uint32_t* value)
+{
+    char c;
+
+    *value = 0;
+
+    while (digits-- > 0U)
+    {
+        c = *text++;
+
+        if ((c >= '0') && (c <= '9'))
+        {
+            *value = (*value << 4) | (uint32_t)(c - '0');
+        }
+        else if ((c >= 'A') && (c <= 'F'))
+        {
+            *value = (*value << 4) | (uint32_t)(c - 'A' + 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool APP_SDCARD_HeaderParse(const uint8_t* header, uint32_t* validLength, uint32_t* session)
+{
+    const char* line = (const char*)header;
+    uint32_t i;
+
+    if (strncmp(line, LOG_HEADER_TAG, strlen(LOG_HEADER_TAG)) != 0)
+    {
+        return false;
+    }
+
+    *validLength = 0;
+
+    for (i = strlen(LOG_HEADER_TAG); i < (strlen(LOG_HEADER_TAG) + 10U); i++)
+    {
+        if ((line[i] < '0') || (line[i] > '9'))
+        {
+            return false;
+        }
+
+        *validLength = (*validLength * 10U) + (uint32_t)(line[i] - '0');
+    }
+
+    if ((strncmp(&line[i], " s=", 3) != 0) || (APP_SDCARD_HexParse(&line[i + 3U], 8, session) == false))
+    {
+        return false;
+    }
+
+    return (*validLength >= LOG_HEADER_LEN);
+}
+
+/* Rewrite the header with the current valid length and move the file pointer
+ * back to the end of the valid data */
+static bool APP_SDCARD_HeaderUpdate(void)
+{
+    uint8_t header[LOG_HEADER_LEN];
+
+    APP_SDCARD_HeaderFormat(header, app_sdcardData.validLength);
+
+    if (SYS_FS_FileSeek(app_sdcardData.fileHandle, 0, SYS_FS_SEEK_SET) == -1)
+    {
+        return false;
+    }
+
+    if (SYS_FS_FileWrite(app_sdcardData.fileHandle, header, LOG_HEADER_LEN) != LOG_HEADER_LEN)
+    {
+        return false;
+    }
+
+    if (SYS_FS_FileSeek(app_sdcardData.fileHandle, (int32_t)app_sdcardData.validLength, SYS_FS_SEEK_SET) == -1)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* Write the staging buffer to its place in the file and update the header.
+ * A full buffer is then released for the records that follow it. */
+static bool APP_SDCARD_BufferFlush(void)
+{
+    uint32_t length = app_sdcardData.bufferLength;
+    bool isWritten;
+
+    if (app_sdcardData.bufferOffset == 0U)
+    {
+        /* The first buffer holds the header. Write it with its final value,
+         * or, in a journal, with the current one until the records are on
+         * the card. */
+        APP_SDCARD_HeaderFormat(app_sdcardLogBuffer,
+                                (APP_SDCARD_JOURNAL_ENABLE == true) ? app_sdcardData.validLength : length);
+    }
+
+    if (SYS_FS_FileSeek(app_sdcardData.fileHandle, (int32_t)app_sdcardData.bufferOffset, SYS_FS_SEEK_SET) == -1)
+    {
+        return false;
+    }
+
+    isWritten = (SYS_FS_FileWrite(app_sdcardData.fileHandle, app_sdcardLogBuffer, length) == length);
+
+    if (isWritten == false)
+    {
+        return false;
+    }
+
+    app_sdcardData.validLength = app_sdcardData.bufferOffset + length;
+
+    if (((app_sdcardData.bufferOffset != 0U) || (APP_SDCARD_JOURNAL_ENABLE == true)) &&
+        (APP_SDCARD_HeaderUpdate() == false))
+    {
+        return false;
+    }
+
+    if (length == APP_SDCARD_LOG_BUFFER_SIZE)
+    {
+        app_sdcardData.bufferOffset += length;
+        app_sdcardData.bufferLength = 0;
+    }
+
+    return true;
+}
+
+static bool APP_SDCARD_RecordAppend(const char* record, uint32_t length)
+{
+    uint32_t count;
+
+    while (length > 0U)
+    {
+        count = APP_SDCARD_LOG_BUFFER_SIZE - app_sdcardData.bufferLength;
+        if (count > length)
+        {
+            count = length;
+        }
+
+        memcpy(&app_sdcardLogBuffer[app_sdcardData.bufferLength], record, count);
+        app_sdcardData.bufferLength += count;
+        record += count;
+        length -= count;
+
+        if ((app_sdcardData.bufferLength == APP_SDCARD_LOG_BUFFER_SIZE) &&
+            (APP_SDCARD_BufferFlush() == false))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint16_t APP_SDCARD_Crc16(uint16_t crc, const uint8_t* data, size_t length)
+{
+    uint8_t bit;
+
+    while (length-- > 0U)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static uint16_t APP_SDCARD_RecordCrc(const char* record, size_t length)
+{
+    uint8_t session[4];
+
+    session[0] = (uint8_t)(app_sdcardData.session >> 24);
+    session[1] = (uint8_t)(app_sdcardData.session >> 16);
+    session[2] = (uint8_t)(app_sdcardData.session >> 8);
+    session[3] = (uint8_t)app_sdcardData.session;
+
+    return APP_SDCARD_Crc16(APP_SDCARD_Crc16(0xFFFFU, session, sizeof(session)), (const uint8_t*)record, length);
+}
+
+/* Replace the line end of a record with its seal. Returns the new length. */
+static size_t APP_SDCARD_RecordSeal(char* record, size_t length)
+{
+    length -= 2U;
+    length += (size_t)sprintf(&record[length], " *%08lX", (unsigned long)app_sdcardData.sequence);
+    length += (size_t)sprintf(&record[length], " %04X\r\n", APP_SDCARD_RecordCrc(record, length));
+
+    app_sdcardData.sequence++;
+
+    return length;
+}
+
+/* Check the seal of a record read back from the file */
+static bool APP_SDCARD_RecordCheck(const char* record, size_t length, uint32_t* sequence)
+{
+    const char* seal;
+    uint32_t crc;
+
+    if (length < LOG_SEAL_LEN)
+    {
+        return false;
+    }
+
+    seal = &record[length - LOG_SEAL_LEN];
+
+    if ((seal[0] != ' ') || (seal[1] != '*') || (seal[10] != ' ') || (seal[15] != '\r') || (seal[16] != '\n'))
+    {
+        return false;
+    }
+
+    if ((APP_SDCARD_HexParse(&seal[2], 8, sequence) == false) ||
+        (APP_SDCARD_HexParse(&seal[11], 4, &crc) == false))
+    {
+        return false;
+    }
+
+    return (crc == APP_SDCARD_RecordCrc(record, length - LOG_SEAL_CRC_LEN));
+}
+
+/* Write the records in the buffer and commit the file size and cluster chain
+ * to the directory entry and the FAT. Until then, a power loss leaves the
+ * directory entry as it was at the previous sync. */
+static bool APP_SDCARD_JournalSync(void)
+{
+    if ((APP_SDCARD_BufferFlush() == false) ||
+        (SYS_FS_FileSync(app_sdcardData.fileHandle) != SYS_FS_RES_SUCCESS))
+    {
+        return false;
+    }
+
+    app_sdcardData.syncRecords = 0;
+    app_sdcardData.syncTimeUs = APP_TIMESTAMP_US_Get();
+
+    return true;
+}
+
+/* Find the end of the journal. The header length is written after the data it
+ * covers, so the records that end before it are on the card. It can fall
+ * inside a record, as the buffer is written in fixed size blocks. The records
+ * of a buffer written before a power loss can follow; they are accepted while
+ * they continue the sequence with a valid seal. The file is extended over
+ * them first, as the size in the directory entry is that of the last sync. */
+static bool APP_SDCARD_JournalScan(uint32_t headerLength, uint32_t* recoveredCount)
+{
+    char record[LOG_RECORD_LEN];
+    size_t recordLength = 0;
+    uint32_t recordStart;
+    uint32_t position;
+    uint32_t end = headerLength + APP_SDCARD_LOG_BUFFER_SIZE;
+    uint32_t sequence;
+    size_t count;
+    size_t i;
+    bool isRecordStart;
+    bool isValid;
+    bool isFound;
+
+    /* Start early enough to read a whole record ending before the header
+     * length, for its sequence number */
+    position = (headerLength > (LOG_HEADER_LEN + (2U * LOG_RECORD_LEN))) ?
+               (headerLength - (2U * LOG_RECORD_LEN)) : LOG_HEADER_LEN;
+    recordStart = position;
+    isRecordStart = (position == LOG_HEADER_LEN);
+    isFound = isRecordStart;
+
+    if ((SYS_FS_FileSeek(app_sdcardData.fileHandle, (int32_t)end, SYS_FS_SEEK_SET) == -1) ||
+        (SYS_FS_FileSeek(app_sdcardData.fileHandle, (int32_t)position, SYS_FS_SEEK_SET) == -1))
+    {
+        return false;
+    }
+
+    app_sdcardData.validLength = LOG_HEADER_LEN;
+    app_sdcardData.sequence = 0;
+    *recoveredCount = 0;
+
+    while (position < end)
+    {
+        count = end - position;
+        if (count > APP_SDCARD_LOG_BUFFER_SIZE)
+        {
+            count = APP_SDCARD_LOG_BUFFER_SIZE;
+        }
+
+        count = SYS_FS_FileRead(app_sdcardData.fileHandle, app_sdcardLogBuffer, count);
+        if ((count == (size_t)-1) || (count == 0U))
+        {
+            return false;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            position++;
+
+            if (isRecordStart == false)
+            {
+                /* Skip to the end of the first partial record */
+                if (app_sdcardLogBuffer[i] == (uint8_t)'\n')
+                {
+                    isRecordStart = true;
+                    recordStart = position;
+                }
+                continue;
+            }
+
+            if (recordLength == LOG_RECORD_LEN)
+            {
+                /* No record is that long */
+                return isFound;
+            }
+
+            record[recordLength++] = (char)app_sdcardLogBuffer[i];
+
+            if (app_sdcardLogBuffer[i] != (uint8_t)'\n')
+            {
+                continue;
+            }
+
+            isValid = APP_SDCARD_RecordCheck(record, recordLength, &sequence);
+
+            if (position <= headerLength)
+            {
+                if (isValid == true)
+                {
+                    app_sdcardData.validLength = position;
+                    app_sdcardData.sequence = sequence + 1U;
+                    isFound = true;
+                }
+            }
+            else if ((isFound == true) && (isValid == true) &&
+                     (recordStart == app_sdcardData.validLength) &&
+                     (sequence == app_sdcardData.sequence))
+            {
+                app_sdcardData.validLength = position;
+                app_sdcardData.sequence++;
+                (*recoveredCount)++;
+            }
+            else
+            {
+                return isFound;
+            }
+
+            recordLength = 0;
+            recordStart = position;
+        }
+    }
+
+    return isFound;
+}
+
+static void APP_SDCARD_PathMake(char* path, const char* name)
+{
+    sprintf(path, SDCARD_MOUNT_NAME "/%s", name);
+}
+
+/* Get the wall time of a timestamp. Fall back to the RTC until the timestamp
+ * service has synchronized. */
+static void APP_SDCARD_TimeGet(uint64_t timestamp, struct tm* time, uint32_t* microseconds)
+{
+    if (APP_TIMESTAMP_ToTime(timestamp, time, microseconds) == false)
+    {
+        RTC_RTCCTimeGet(time);
+        *microseconds = 0;
+    }
+}
+
+/* List the record at offset in the log file in the index. The index is closed
+ * after each entry, which commits it to the card. */
+static void APP_SDCARD_IndexAppend(const struct tm* time, uint32_t offset, bool isReset)
+{
+    SYS_FS_HANDLE handle;
+    char line[LOG_RECORD_LEN];
+    size_t length;
+    bool isWritten = false;
+
+    handle = SYS_FS_FileOpen(SDCARD_MOUNT_NAME"/"APP_SDCARD_INDEX_FILE, (SYS_FS_FILE_OPEN_APPEND));
+
+    if (handle != SYS_FS_HANDLE_INVALID)
+    {
+        length = (size_t)sprintf(line, "%04d/%02d/%02d %02d:%02d:%02d %s %lu%s\r\n", time->tm_year + 1900,
+                                 time->tm_mon + 1, time->tm_mday, time->tm_hour, time->tm_min, time->tm_sec,
+                                 app_sdcardData.fileName, (unsigned long)offset,
+                                 (isReset == true) ? " " APP_SDCARD_INDEX_RESET : "");
+
+        isWritten = (SYS_FS_FileWrite(handle, line, length) == length);
+
+        if (SYS_FS_FileClose(handle) != SYS_FS_RES_SUCCESS)
+        {
+            isWritten = false;
+        }
+    }
+
+    if (isWritten == false)
+    {
+        /* The log does not depend on its index */
+        printf("Log index not updated \r\n");
+    }
+
+    app_sdcardData.indexOffset = offset;
+}
+
+/* Get the log file and date of the last index entry, which is the file being
+ * written when the card was removed */
+static bool APP_SDCARD_IndexLastGet(void)
+{
+    SYS_FS_HANDLE handle;
+    char line[LOG_RECORD_LEN];
+    char name[sizeof(app_sdcardData.fileName)];
+    int32_t size;
+    int year;
+    int month;
+    int day;
+    bool isFound = false;
+
+    handle = SYS_FS_FileOpen(SDCARD_MOUNT_NAME"/"APP_SDCARD_INDEX_FILE, (SYS_FS_FILE_OPEN_READ));
+
+    if (handle == SYS_FS_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    /* The entries are shorter than a record. The partial entry read first is
+     * followed by a whole one. */
+    size = SYS_FS_FileSize(handle);
+    if ((size > LOG_RECORD_LEN) && (SYS_FS_FileSeek(handle, size - LOG_RECORD_LEN, SYS_FS_SEEK_SET) == -1))
+    {
+        size = 0;
+    }
+
+    while ((size > 0) && (SYS_FS_FileEOF(handle) == false) &&
+           (SYS_FS_FileStringGet(handle, line, sizeof(line)) == SYS_FS_RES_SUCCESS))
+    {
+        if (sscanf(line, "%d/%d/%d %*d:%*d:%*d %31s", &year, &month, &day, name) == 4)
+        {
+            strcpy(app_sdcardData.fileName, name);
+            app_sdcardData.fileDate = (uint32_t)((year * 10000) + (month * 100) + day);
+            isFound = true;
+        }
+    }
+
+    SYS_FS_FileClose(handle);
+
+    return isFound;
+}
+
+/* Get the oldest log file listed in the index that is still on the card,
+ * other than the current one. The entries before indexOldest list deleted
+ * files only, so retention reads each entry about once per card. */
+static bool APP_SDCARD_IndexOldestGet(char* name)
+{
+    SYS_FS_HANDLE handle;
+    SYS_FS_FSTAT stat = { 0 };
+    char line[LOG_RECORD_LEN];
+    char path[LOG_PATH_LEN];
+    int32_t position;
+    bool isLive;
+    bool isLiveFound = false;
+    bool isFound = false;
+
+    handle = SYS_FS_FileOpen(SDCARD_MOUNT_NAME"/"APP_SDCARD_INDEX_FILE, (SYS_FS_FILE_OPEN_READ));
+
+    if (handle == SYS_FS_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    if (SYS_FS_FileSeek(handle, (int32_t)app_sdcardData.indexOldest, SYS_FS_SEEK_SET) == -1)
+    {
+        SYS_FS_FileClose(handle);
+        return false;
+    }
+
+    while ((isFound == false) && (SYS_FS_FileEOF(handle) == false))
+    {
+        position = SYS_FS_FileTell(handle);
+
+        if ((position == -1) || (SYS_FS_FileStringGet(handle, line, sizeof(line)) != SYS_FS_RES_SUCCESS))
+        {
+            break;
+        }
+
+        if (sscanf(line, "%*d/%*d/%*d %*d:%*d:%*d %31s", name) != 1)
+        {
+            continue;
+        }
+
+        APP_SDCARD_PathMake(path, name);
+        isLive = (SYS_FS_FileStat(path, &stat) == SYS_FS_RES_SUCCESS);
+
+        if ((isLive == true) && (isLiveFound == false))
+        {
+            app_sdcardData.indexOldest = (uint32_t)position;
+            isLiveFound = true;
+        }
+
+        isFound = ((isLive == true) && (strcmp(name, app_sdcardData.fileName) != 0));
+    }
+
+    SYS_FS_FileClose(handle);
+
+    return isFound;
+}
+
+/* Delete the oldest log files while the free space is below the minimum */
+static void APP_SDCARD_Retain(void)
+{
+    uint32_t totalSectors;
+    uint32_t freeSectors;
+    char name[sizeof(app_sdcardData.fileName)];
+    char path[LOG_PATH_LEN];
+
+    /* Sectors are 512 bytes */
+    while ((SYS_FS_DriveSectorGet(SDCARD_MOUNT_NAME, &totalSectors, &freeSectors) == SYS_FS_RES_SUCCESS) &&
+           ((freeSectors / 2U) < APP_SDCARD_RETAIN_FREE_MIN_KB))
+    {
+        if (APP_SDCARD_IndexOldestGet(name) == false)
+        {
+            printf("Card full, no log file to delete \r\n");
+            return;
+        }
+
+        APP_SDCARD_PathMake(path, name);
+
+        if (SYS_FS_FileDirectoryRemove(path) != SYS_FS_RES_SUCCESS)
+        {
+            return;
+        }
+
+        printf("Log file %s deleted \r\n", name);
+    }
+}
+
+/* Name a new log file after time. A suffix keeps the name unique when the
+ * clock has been set back or files are started within a second. */
+static bool APP_SDCARD_FileNameMake(const struct tm* time)
+{
+    SYS_FS_FSTAT stat = { 0 };
+    char path[LOG_PATH_LEN];
+    char* suffix;
+    uint32_t count;
+    int length;
+
+    length = snprintf(app_sdcardData.fileName, sizeof(app_sdcardData.fileName),
+                      SDCARD_FILE_PREFIX "%04d%02d%02d_%02d%02d%02d", time->tm_year + 1900, time->tm_mon + 1,
+                      time->tm_mday, time->tm_hour, time->tm_min, time->tm_sec);
+
+    /* The name and its longest suffix fit unless the year does not */
+    if ((length < 0) || ((size_t)length > (sizeof(app_sdcardData.fileName) - sizeof("_00" SDCARD_FILE_SUFFIX))))
+    {
+        return false;
+    }
+
+    suffix = &app_sdcardData.fileName[length];
+
+    for (count = 0; count < 100U; count++)
+    {
+        if (count == 0U)
+        {
+            strcpy(suffix, SDCARD_FILE_SUFFIX);
+        }
+        else
+        {
+            (void) snprintf(suffix, sizeof(app_sdcardData.fileName) - (size_t)length, "_%02lu" SDCARD_FILE_SUFFIX, (unsigned long)count);
+        }
+
+        APP_SDCARD_PathMake(path, app_sdcardData.fileName);
+
+        if (SYS_FS_FileStat(path, &stat) != SYS_FS_RES_SUCCESS)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Open the log file of the last index entry and continue it after its last
+ * valid record, whose time is that of the first record to follow */
+static bool APP_SDCARD_LogResume(const struct tm* time)
+{
+    uint8_t header[LOG_HEADER_LEN];
+    char path[LOG_PATH_LEN];
+    uint32_t headerLength;
+    uint32_t recoveredCount;
+    bool isRead;
+
+    if (APP_SDCARD_IndexLastGet() == false)
+    {
+        return false;
+    }
+
+    APP_SDCARD_PathMake(path, app_sdcardData.fileName);
+    app_sdcardData.fileHandle = SYS_FS_FileOpen(path, (SYS_FS_FILE_OPEN_READ_PLUS));
+
+    if (app_sdcardData.fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    if ((SYS_FS_FileRead(app_sdcardData.fileHandle, header, LOG_HEADER_LEN) != LOG_HEADER_LEN) ||
+        (APP_SDCARD_HeaderParse(header, &headerLength, &app_sdcardData.session) == false) ||
+        (APP_SDCARD_JournalScan(headerLength, &recoveredCount) == false))
+    {
+        printf("Log file %s not recovered \r\n", app_sdcardData.fileName);
+        SYS_FS_FileClose(app_sdcardData.fileHandle);
+        app_sdcardData.fileHandle = SYS_FS_HANDLE_INVALID;
+        return false;
+    }
+
+    /* Reload the buffer from the sector holding the end of the log */
+    app_sdcardData.bufferOffset = app_sdcardData.validLength & ~(LOG_SECTOR_LEN - 1U);
+    app_sdcardData.bufferLength = app_sdcardData.validLength - app_sdcardData.bufferOffset;
+
+    isRead = ((SYS_FS_FileSeek(app_sdcardData.fileHandle, (int32_t)app_sdcardData.bufferOffset, SYS_FS_SEEK_SET) != -1) &&
+              (SYS_FS_FileRead(app_sdcardData.fileHandle, app_sdcardLogBuffer, app_sdcardData.bufferLength) ==
+               app_sdcardData.bufferLength));
+
+    if ((isRead == false) || (APP_SDCARD_JournalSync() == false))
+    {
+        SYS_FS_FileClose(app_sdcardData.fileHandle);
+        app_sdcardData.fileHandle = SYS_FS_HANDLE_INVALID;
+        return false;
+    }
+
+    printf("Log %s resumed at record %lu, %lu records recovered \r\n", app_sdcardData.fileName,
+           (unsigned long)app_sdcardData.sequence, (unsigned long)recoveredCount);
+
+    app_sdcardData.recordTime = 0;
+    APP_SDCARD_IndexAppend(time, app_sdcardData.validLength, true);
+
+    return true;
+}
+
+/* Create a new log file named after time, at a reset or a rotation */
+static bool APP_SDCARD_LogCreate(const struct tm* time, bool isReset)
+{
+    char path[LOG_PATH_LEN];
+
+    if (APP_SDCARD_FileNameMake(time) == false)
+    {
+        printf("No free log file name \r\n");
+        return false;
+    }
+
+    APP_SDCARD_PathMake(path, app_sdcardData.fileName);
+    app_sdcardData.fileHandle = SYS_FS_FileOpen(path, (SYS_FS_FILE_OPEN_WRITE_PLUS));
+
+    if (app_sdcardData.fileHandle == SYS_FS_HANDLE_INVALID)
+    {
+        /* Could not open the file. Error out*/
+        return false;
+    }
+
+    /* Preallocate a contiguous extent so that appending records does
+     * not walk or extend the FAT chain. Without it, log as before. */
+    if (SYS_FS_FileExpand(app_sdcardData.fileHandle, APP_SDCARD_LOG_EXTENT_SIZE) != SYS_FS_RES_SUCCESS)
+    {
+        printf("Log file not preallocated \r\n");
+    }
+
+    /* Records left in reused clusters by an earlier file must not pass as
+     * records of this one */
+    app_sdcardData.session = (uint32_t)SYS_TIME_Counter64Get();
+    app_sdcardData.sequence = 0;
+
+    app_sdcardData.validLength = LOG_HEADER_LEN;
+    app_sdcardData.recordTime = 0;
+
+    /* The header is the first thing in the staging buffer */
+    app_sdcardData.bufferOffset = 0;
+    app_sdcardData.bufferLength = LOG_HEADER_LEN;
+
+    /* Record the extent in the directory entry so that it can be found after
+     * a power loss. A file that got no header is of no use; do not leave it
+     * open, nor on the card. */
+    if ((APP_SDCARD_HeaderUpdate() == false) ||
+        ((APP_SDCARD_JOURNAL_ENABLE == true) && (APP_SDCARD_JournalSync() == false)))
+    {
+        (void) SYS_FS_FileClose(app_sdcardData.fileHandle);
+        app_sdcardData.fileHandle = SYS_FS_HANDLE_INVALID;
+        (void) SYS_FS_FileDirectoryRemove(path);
+        return false;
+    }
+
+    app_sdcardData.fileDate = LOG_DATE(time);
+    APP_SDCARD_IndexAppend(time, LOG_HEADER_LEN, isReset);
+
+    printf("Logging to %s \r\n", app_sdcardData.fileName);
+
+    return true;
+}
+
+/* Write the records still in the buffer and record the final length, then
+ * release the unused part of the extent so the file reads as plain text */
+static bool APP_SDCARD_LogClose(void)
+{
+    bool isClosed = false;
+
+    if ((APP_SDCARD_BufferFlush() == true) && (APP_SDCARD_HeaderUpdate() == true))
+    {
+        isClosed = (SYS_FS_FileTruncate(app_sdcardData.fileHandle) == SYS_FS_RES_SUCCESS);
+    }
+
+    if (SYS_FS_FileClose(app_sdcardData.fileHandle) != SYS_FS_RES_SUCCESS)
+    {
+        isClosed = false;
+    }
+
+    app_sdcardData.fileHandle = SYS_FS_HANDLE_INVALID;
+
+    return isClosed;
+}
+
+/* Start a new log file for a record of length bytes at time, if the record
+ * would make the file too large or starts a new day */
+static bool APP_SDCARD_LogRotate(const struct tm* time, size_t length)
+{
+    if (((app_sdcardData.bufferOffset + app_sdcardData.bufferLength + length) <= APP_SDCARD_ROTATE_SIZE) &&
+        ((APP_SDCARD_ROTATE_DAILY == false) || (LOG_DATE(time) == app_sdcardData.fileDate)))
+    {
+        return true;
+    }
+
+    if (APP_SDCARD_LogClose() == false)
+    {
+        return false;
+    }
+
+    APP_SDCARD_Retain();
+
+    return APP_SDCARD_LogCreate(time, false);
+}
+
+/* Format a sample as a log record and append it. A new file is started or
+ * the record listed in the index first when due. */
+static bool APP_SDCARD_RecordLog(const struct tm* time, uint32_t microseconds, double temperature,
+                                 double pressure, double humidity, const APP_METEO_DATA* derived, bool isEcho)
+{
+    char log_date[34];
+    char log_data[LOG_RECORD_LEN];
+    size_t log_len;
+    uint64_t recordTime;
+    int length;
+
+    /* A time with a field out of its range makes no record */
+    length = snprintf(log_date, sizeof(log_date), "[%04d/%02d/%02d %02d:%02d:%02d.%03lu]", time->tm_year + 1900,
+                      time->tm_mon + 1, time->tm_mday, time->tm_hour, time->tm_min, time->tm_sec,
+                      (unsigned long)(microseconds / 1000U));
+    if ((length < 0) || ((size_t)length >= sizeof(log_date)))
+    {
+        return false;
+    }
+
+    log_len = (size_t)sprintf(log_data, "%s %6.2f %7.2f %5.1f\r\n", log_date, temperature, pressure, humidity);
+
+    /* Dew point in degC, absolute humidity in g/m^3, pressure altitude in m
+     * and sea-level pressure in hPa */
+    if (APP_METEO_LOG_ENABLE == true)
+    {
+        log_len -= 2U;
+        log_len += (size_t)sprintf(&log_data[log_len], " %6.2f %6.2f %8.2f %7.2f\r\n",
+                ((double) derived->dewPoint) / 100.0,
+                ((double) derived->absoluteHumidity) / 1000.0,
+                ((double) derived->pressureAltitude) / 100.0,
+                ((double) derived->seaLevelPressure) / 100.0);
+    }
+
+    /* The seal belongs to the file the record goes to */
+    if (APP_SDCARD_LogRotate(time, (APP_SDCARD_JOURNAL_ENABLE == true) ?
+                             (log_len + LOG_SEAL_LEN - 2U) : log_len) == false)
+    {
+        return false;
+    }
+
+    if (APP_SDCARD_JOURNAL_ENABLE == true)
+    {
+        log_len = APP_SDCARD_RecordSeal(log_data, log_len);
+    }
+
+    /* Time goes back after the clock is set back, or between records kept in
+     * the internal flash across a reset. The record is then listed as the
+     * first after a reset. */
+    recordTime = ((uint64_t)LOG_DATE(time) * 1000000U) +
+                 (uint64_t)(uint32_t)((time->tm_hour * 10000) + (time->tm_min * 100) + time->tm_sec);
+
+    if (recordTime < app_sdcardData.recordTime)
+    {
+        APP_SDCARD_IndexAppend(time, app_sdcardData.bufferOffset + app_sdcardData.bufferLength, true);
+    }
+    else if ((app_sdcardData.bufferOffset + app_sdcardData.bufferLength - app_sdcardData.indexOffset) >=
+             APP_SDCARD_INDEX_STRIDE)
+    {
+        APP_SDCARD_IndexAppend(time, app_sdcardData.bufferOffset + app_sdcardData.bufferLength, false);
+    }
+
+    app_sdcardData.recordTime = recordTime;
+
+    if (isEcho == true)
+    {
+        printf("%s", log_data);
+    }
+
+    /* Log System time and temperature value to log file. The header is
+     * updated each time the buffer is written. */
+    if (APP_SDCARD_RecordAppend(log_data, log_len) == false)
+    {
+        return false;
+    }
+
+    app_sdcardData.syncRecords++;
+
+    return true;
+}
+
+/* Take the oldest waiting sample as the values to log, and give its block
+ * back. Returns false if no sample is waiting. */
+static bool APP_SDCARD_SampleGet(void)
+{
+    APP_SDCARD_SAMPLE* sample;
+
+    if (app_sdcardData.sampleCount == 0U)
+    {
+        return false;
+    }
+
+    sample = app_sdcardData.sampleQueue[(app_sdcardData.sampleIn + APP_SDCARD_SAMPLE_RECORDS -
+                                         app_sdcardData.sampleCount) % APP_SDCARD_SAMPLE_RECORDS];
+    app_sdcardData.sampleCount--;
+
+    app_sdcardData.timestamp = sample->timestamp;
+    app_sdcardData.temperature = sample->temperature;
+    app_sdcardData.pressure = sample->pressure;
+    app_sdcardData.humidity = sample->humidity;
+    app_sdcardData.derived = sample->derived;
+
+    APP_POOL_Free(&app_sdcardData.samplePool, sample);
+
+    return true;
+}
+
+static int32_t APP_SDCARD_Round(double value)
+{
+    return (int32_t)((value >= 0.0) ? (value + 0.5) : (value - 0.5));
+}
+
+/* Keep the sample in the internal flash log. It is dropped if the flash log
+ * cannot take it. */
+static void APP_SDCARD_FlashStore(void)
+{
+    APP_FLASHLOG_RECORD record;
+    struct tm time;
+    uint32_t microseconds;
+    uint32_t humidity;
+
+    APP_SDCARD_TimeGet(app_sdcardData.timestamp, &time, &microseconds);
+
+    humidity = (uint32_t)APP_SDCARD_Round(app_sdcardData.humidity * 1024.0);
+
+    record.time = (uint32_t)APP_TIMESTAMP_TimeToSeconds(&time);
+    record.milliseconds = (uint16_t)(microseconds / 1000U);
+    record.temperature = (int16_t)APP_SDCARD_Round(app_sdcardData.temperature * 100.0);
+    record.pressure = (uint32_t)APP_SDCARD_Round(app_sdcardData.pressure * 100.0);
+    record.humidity = (uint16_t)humidity;
+
+    if ((humidity & 0x10000U) != 0U)
+    {
+        record.milliseconds |= APP_FLASHLOG_HUMIDITY_BIT16;
+    }
+
+    APP_FLASHLOG_Write(&record);
+}
+
+static void APP_SDCARD_FlashTimeGet(const APP_FLASHLOG_RECORD* record, struct tm* time, uint32_t* microseconds)
+{
+    time_t seconds = (time_t)record->time;
+
+    *time = *gmtime(&seconds);
+    *microseconds = (uint32_t)(record->milliseconds & ~APP_FLASHLOG_HUMIDITY_BIT16) * 1000U;
+}
+
+/* Move up to APP_FLASHLOG_DRAIN_RECORDS records from the internal flash to
+ * the log. The flash blocks read are released once their records are on the
+ * card, so a reset repeats at most one block. */
+static bool APP_SDCARD_FlashDrain(void)
+{
+    APP_FLASHLOG_RECORD record;
+    APP_METEO_DATA derived;
+    struct tm time;
+    uint32_t microseconds;
+    uint32_t humidity;
+    uint32_t count;
+
+    for (count = 0; (count < APP_FLASHLOG_DRAIN_RECORDS) && (APP_FLASHLOG_Read(&record, true) == true); count++)
+    {
+        APP_SDCARD_FlashTimeGet(&record, &time, &microseconds);
+
+        humidity = record.humidity;
+
+        if ((record.milliseconds & APP_FLASHLOG_HUMIDITY_BIT16) != 0U)
+        {
+            humidity |= 0x10000U;
+        }
+
+        /* The pressure in 1/256 Pa, as the driver returns it */
+        APP_METEO_Compute(record.temperature, record.pressure * 256U, humidity, &derived);
+
+        if (APP_SDCARD_RecordLog(&time, microseconds, ((double) record.temperature) / 100.0,
+                                 ((double) record.pressure) / 100.0, ((double) humidity) / 1024.0,
+                                 &derived, false) == false)
+        {
+            return false;
+        }
+    }
+
+    if ((count > 0U) && (APP_SDCARD_JournalSync() == false))
+    {
+        return false;
+    }
+
+    APP_FLASHLOG_Release();
+    app_sdcardData.drainCount += count;
+
+    if ((APP_FLASHLOG_IsEmpty() == true) && (app_sdcardData.drainCount > 0U))
+    {
+        printf("%lu records moved from the internal flash to the log \r\n",
+               (unsigned long)app_sdcardData.drainCount);
+        app_sdcardData.drainCount = 0;
+    }
+
+    return true;
+}
+
 static void APP_SysFSEventHandler(SYS_FS_EVENT event,void* eventData,uintptr_t context)
 {
     switch(event)
@@ -96,6 +1090,7 @@ static void APP_SysFSEventHandler(SYS_FS_EVENT event,void* eventData,uintptr_t c
             {
                 /* Set SDCARD Mount flag */
                 app_sdcardData.sdCardMountFlag = true;
+                app_sdcardData.sdCardMounted = true;
             }
             break;
 
@@ -104,9 +1099,11 @@ static void APP_SysFSEventHandler(SYS_FS_EVENT event,void* eventData,uintptr_t c
             if(strcmp((const char *)eventData, SDCARD_MOUNT_NAME) == 0)
             {
                 app_sdcardData.sdCardMountFlag = false;
+                app_sdcardData.sdCardMounted = false;
             }
 
-            if (app_sdcardData.state != APP_SDCARD_STATE_IDLE)
+            if ((app_sdcardData.state != APP_SDCARD_STATE_IDLE) &&
+                (app_sdcardData.state != APP_SDCARD_STATE_MOUNT_WAIT))
             {
                 printf("!!! WARNING SDCARD Ejected Abruptly !!!\r\n\r\n");
 
@@ -149,9 +1146,27 @@ void APP_SDCARD_Initialize ( void )
     /* Intialize the app state to wait for media attach. */
     app_sdcardData.state                    = APP_SDCARD_STATE_MOUNT_WAIT;
 
-    app_sdcardData.isDataReady              = false;
+    app_sdcardData.sampleIn                 = 0;
+    app_sdcardData.sampleCount              = 0;
+
+    APP_POOL_Create(&app_sdcardData.samplePool, "samples", app_sdcardSamples, sizeof(app_sdcardSamples[0]),
+                    APP_SDCARD_SAMPLE_RECORDS);
+
+    app_sdcardData.session                  = 0;
+    app_sdcardData.sequence                 = 0;
+    app_sdcardData.syncRecords              = 0;
+    app_sdcardData.syncTimeUs               = 0;
+
+    app_sdcardData.fileHandle               = SYS_FS_HANDLE_INVALID;
+    app_sdcardData.fileName[0]              = '\0';
+    app_sdcardData.fileDate                 = 0;
+    app_sdcardData.indexOffset              = 0;
+    app_sdcardData.indexOldest              = 0;
+    app_sdcardData.recordTime               = 0;
+    app_sdcardData.drainCount               = 0;
    
     app_sdcardData.sdCardMountFlag          = false;
+    app_sdcardData.sdCardMounted            = false;
 
     /* calculate the system date and time from the build time */
     sscanf(__DATE__, "%s %d %d", s_month, &day, &year);
@@ -169,6 +1184,18 @@ void APP_SDCARD_Initialize ( void )
 
     /* Register the File System Event handler.*/
     SYS_FS_EventHandlerSet(APP_SysFSEventHandler,(uintptr_t)NULL);
+
+    /* Taken once, the log keeps it for good */
+    if (app_sdcardLogBuffer == NULL)
+    {
+        app_sdcardLogBuffer = APP_DMABUF_Acquire(APP_SDCARD_LOG_BUFFER_SIZE);
+    }
+
+    if (app_sdcardLogBuffer == NULL)
+    {
+        printf("SD card log: no staging buffer in the DMA pool \r\n");
+        app_sdcardData.state = APP_SDCARD_STATE_ERROR;
+    }
 }
 
 
@@ -183,8 +1210,8 @@ void APP_SDCARD_Initialize ( void )
 void APP_SDCARD_Tasks ( void )
 {
     struct tm sys_time = { 0 };
-    char log_date[30];
-    char log_data[128];
+    uint32_t sys_time_us = 0;
+    APP_FLASHLOG_RECORD record;
 
     switch (app_sdcardData.state)
     {
@@ -195,19 +1222,51 @@ void APP_SDCARD_Tasks ( void )
             {
                 app_sdcardData.state = APP_SDCARD_STATE_OPEN_FILE;
                 app_sdcardData.sdCardMountFlag = false;
+
+                /* The card may hold another index */
+                app_sdcardData.indexOldest = 0;
+            }
+
+            /* Keep the samples in the internal flash until then */
+            if (APP_SDCARD_SampleGet() == true)
+            {
+                APP_SDCARD_FlashStore();
+
+                /* No mount event comes for a card that failed while still
+                 * mounted: its log is opened again, once per sample until
+                 * the card works again */
+                if ((app_sdcardData.state == APP_SDCARD_STATE_MOUNT_WAIT) &&
+                    (app_sdcardData.sdCardMounted == true))
+                {
+                    app_sdcardData.state = APP_SDCARD_STATE_OPEN_FILE;
+                }
             }
             break;
         }
 
         case APP_SDCARD_STATE_OPEN_FILE:
         {
-            /* Open Temperature Log file. Here -----> Step #5 */
-            app_sdcardData.fileHandle = SYS_FS_FileOpen(SDCARD_MOUNT_NAME"/"SDCARD_FILE_NAME,
-                                                       (SYS_FS_FILE_OPEN_WRITE));
+            /* Open Temperature Log file. Here -----> Step #5 The records
+             * kept in the internal flash come first. */
+            if (APP_FLASHLOG_Read(&record, false) == true)
+            {
+                APP_SDCARD_FlashTimeGet(&record, &sys_time, &sys_time_us);
+            }
+            else
+            {
+                APP_SDCARD_TimeGet(APP_TIMESTAMP_US_Get(), &sys_time, &sys_time_us);
+            }
+
+            if ((APP_SDCARD_JOURNAL_ENABLE == true) && (APP_SDCARD_LogResume(&sys_time) == true))
+            {
+                app_sdcardData.state = APP_SDCARD_STATE_WRITE;
+                break;
+            }
+
+            APP_SDCARD_Retain();
 
-            if(app_sdcardData.fileHandle == SYS_FS_HANDLE_INVALID)
+            if (APP_SDCARD_LogCreate(&sys_time, true) == false)
             {
-                /* Could not open the file. Error out*/
                 app_sdcardData.state = APP_SDCARD_STATE_ERROR;
                 break;
             }
@@ -219,34 +1278,51 @@ void APP_SDCARD_Tasks ( void )
 
         case APP_SDCARD_STATE_WRITE:
         {
-            /* Check if temperature data is ready to be written to SDCARD. */
-            if (app_sdcardData.isDataReady == true)
+            /* Sync the journal when its record or time budget is spent */
+            if ((APP_SDCARD_JOURNAL_ENABLE == true) && (app_sdcardData.syncRecords > 0U) &&
+                ((app_sdcardData.syncRecords >= APP_CONFIG_Get(APP_CONFIG_KEY_SYNC_RECORDS)) ||
+                 ((APP_TIMESTAMP_US_Get() - app_sdcardData.syncTimeUs) >=
+                  ((uint64_t)APP_CONFIG_Get(APP_CONFIG_KEY_SYNC_MS) * 1000ULL))))
             {
-                app_sdcardData.isDataReady = false;
-
-                /* Get System Time from RTC */
-                RTC_RTCCTimeGet(&sys_time);
-                
-                sprintf(log_date, "[%04d/%02d/%02d %02d:%02d:%02d]", sys_time.tm_year + 1900, sys_time.tm_mon + 1,
-                        sys_time.tm_mday, sys_time.tm_hour, sys_time.tm_min, sys_time.tm_sec);
-                sprintf(log_data, "%s %6.2f %7.2f %5.1f", log_date, app_sdcardData.temperature,
-                        app_sdcardData.pressure, app_sdcardData.humidity);
-                
-                printf("%s\r\n", log_data);
-
-                /* Log System time and temperature value to log file. */
-                if(SYS_FS_FilePrintf(app_sdcardData.fileHandle, "%s\r\n", log_data)
-                                    == SYS_FS_RES_FAILURE)
+                if (APP_SDCARD_JournalSync() == false)
                 {
-                    /* There was an error while reading the file error out. */
                     app_sdcardData.state = APP_SDCARD_STATE_ERROR;
+                    break;
+                }
+            }
+
+            /* Check if temperature data is ready to be written to SDCARD. */
+            if (APP_SDCARD_SampleGet() == true)
+            {
+                if (APP_FLASHLOG_IsEmpty() == false)
+                {
+                    /* Keep the records in order behind those still in the
+                     * flash log */
+                    APP_SDCARD_FlashStore();
                 }
                 else
                 {
-                    /* The test was successful. */
-                    LED0_Toggle();
-                    app_sdcardData.state = APP_SDCARD_STATE_SWITCH_CHECK;
+                    /* Get the acquisition time of the sample */
+                    APP_SDCARD_TimeGet(app_sdcardData.timestamp, &sys_time, &sys_time_us);
+
+                    if (APP_SDCARD_RecordLog(&sys_time, sys_time_us, app_sdcardData.temperature,
+                                             app_sdcardData.pressure, app_sdcardData.humidity,
+                                             &app_sdcardData.derived, true) == false)
+                    {
+                        /* There was an error while writing the file error out. */
+                        app_sdcardData.state = APP_SDCARD_STATE_ERROR;
+                        break;
+                    }
                 }
+
+                /* The test was successful. */
+                LED0_Toggle();
+                app_sdcardData.state = APP_SDCARD_STATE_SWITCH_CHECK;
+            }
+            else if (((APP_FLASHLOG_IsEmpty() == false) || (app_sdcardData.drainCount > 0U)) &&
+                     (APP_SDCARD_FlashDrain() == false))
+            {
+                app_sdcardData.state = APP_SDCARD_STATE_ERROR;
             }
             break;
         }
@@ -268,7 +1344,7 @@ void APP_SDCARD_Tasks ( void )
 
         case APP_SDCARD_STATE_CLOSE_FILE:
         {
-            SYS_FS_FileClose(app_sdcardData.fileHandle);
+            APP_SDCARD_LogClose();
 
             printf("Logging temperature to SDCARD Stopped \r\n");
             printf("Safe to Eject SDCARD \r\n\r\n");
@@ -283,7 +1359,16 @@ void APP_SDCARD_Tasks ( void )
         case APP_SDCARD_STATE_ERROR:
         {
             printf("SDCARD Task Error \r\n\r\n");
-            app_sdcardData.state = APP_SDCARD_STATE_IDLE;
+
+            if (app_sdcardData.fileHandle != SYS_FS_HANDLE_INVALID)
+            {
+                SYS_FS_FileClose(app_sdcardData.fileHandle);
+                app_sdcardData.fileHandle = SYS_FS_HANDLE_INVALID;
+            }
+
+            /* Log to the internal flash until a card is mounted again, or
+             * until the next sample if the card is still mounted */
+            app_sdcardData.state = APP_SDCARD_STATE_MOUNT_WAIT;
             break;
         }
 
@@ -295,6 +1380,75 @@ void APP_SDCARD_Tasks ( void )
     }
 }
 
+/******************************************************************************
+  Function:
+    bool APP_SDCARD_IsIdle ( void )
+
+  Remarks:
+    See prototype in app_sdcard.h.
+ */
+
+bool APP_SDCARD_IsIdle ( void )
+{
+    switch (app_sdcardData.state)
+    {
+        case APP_SDCARD_STATE_WRITE:
+            return ((app_sdcardData.sampleCount == 0U) && (APP_FLASHLOG_IsEmpty() == true) &&
+                    (app_sdcardData.drainCount == 0U));
+
+        /* Without a card nothing happens until one is inserted, which the
+         * SDHC card insertion interrupt reports. A card that failed while
+         * mounted waits for the next sample. */
+        case APP_SDCARD_STATE_MOUNT_WAIT:
+            return ((app_sdcardData.sdCardMountFlag == false) && (app_sdcardData.sampleCount == 0U) &&
+                    ((SDHC1_IsCardAttached() == false) || (app_sdcardData.sdCardMounted == true)));
+
+        case APP_SDCARD_STATE_IDLE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    int32_t APP_SDCARD_LogRead ( const char* name, uint32_t offset,
+                                 void* buffer, uint32_t size )
+
+  Remarks:
+    See prototype in app_sdcard.h.
+ */
+
+int32_t APP_SDCARD_LogRead ( const char* name, uint32_t offset, void* buffer, uint32_t size )
+{
+    if (((app_sdcardData.state != APP_SDCARD_STATE_WRITE) &&
+         (app_sdcardData.state != APP_SDCARD_STATE_SWITCH_CHECK)) ||
+        (strcmp(name, app_sdcardData.fileName) != 0))
+    {
+        return -1;
+    }
+
+    if (offset >= app_sdcardData.validLength)
+    {
+        return 0;
+    }
+
+    if (size > (app_sdcardData.validLength - offset))
+    {
+        size = app_sdcardData.validLength - offset;
+    }
+
+    if ((SYS_FS_FileSeek(app_sdcardData.fileHandle, (int32_t)offset, SYS_FS_SEEK_SET) == -1) ||
+        (SYS_FS_FileRead(app_sdcardData.fileHandle, buffer, size) != size))
+    {
+        return -1;
+    }
+
+    return (int32_t)size;
+}
+
 
 /*******************************************************************************
  End of File
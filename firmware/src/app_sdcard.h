@@ -35,6 +35,8 @@
 #include <string.h>
 #include "system/fs/sys_fs.h"
 #include "configuration.h"
+#include "app_meteo.h"
+#include "app_pool.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -44,6 +46,17 @@ extern "C" {
 #endif
 // DOM-IGNORE-END
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Constants
+// *****************************************************************************
+// *****************************************************************************
+
+/* Tag that ends the first index entry after a reset, whether the log is
+ * resumed or a new file is started. The clock restarts with the reset, so
+ * times only increase from one such entry to the next. */
+#define APP_SDCARD_INDEX_RESET      "reset"
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Type Definitions
@@ -86,6 +99,27 @@ typedef enum
 } APP_SDCARD_STATES;
 
 
+// *****************************************************************************
+/* Sample
+
+  Summary:
+    Sample waiting for the SD card task
+*/
+
+typedef struct
+{
+    /* acquisition time of the values, in APP_TIMESTAMP microseconds */
+    uint64_t            timestamp;
+
+    double              temperature;
+    double              pressure;
+    double              humidity;
+
+    /* quantities derived from the values */
+    APP_METEO_DATA      derived;
+} APP_SDCARD_SAMPLE;
+
+
 // *****************************************************************************
 /* Application Data
 
@@ -107,16 +141,64 @@ typedef struct
     /* SYS_FS File Handle */
     SYS_FS_HANDLE      fileHandle;
 
+    /* Name of the log file, and its date as YYYYMMDD */
+    char               fileName[32];
+    uint32_t           fileDate;
+
+    /* Offset of the last index entry of the log file */
+    uint32_t           indexOffset;
+
+    /* Offset in the index of the first entry whose log file was still on the
+     * card when retention last looked, zero until it has on this card */
+    uint32_t           indexOldest;
+
+    /* Time of the last record, as YYYYMMDDhhmmss */
+    uint64_t           recordTime;
+
+    /* Records moved from the internal flash log since it was last empty */
+    uint32_t           drainCount;
+
     /* Indicates whether SD card is mounted or not */
     bool               sdCardMountFlag;
 
+    /* The volume is mounted, from its SYS_FS mount event to its unmount
+     * event. A log that fails while it stays mounted is opened again. */
+    bool               sdCardMounted;
+
+    /* Bytes of valid data in the log file, including the header */
+    uint32_t           validLength;
+
+    /* File offset of the first byte in the staging buffer, sector aligned */
+    uint32_t           bufferOffset;
+
+    /* Bytes in the staging buffer */
+    uint32_t           bufferLength;
+
+    /* Session number of the log file, and sequence number of the next record */
+    uint32_t           session;
+    uint32_t           sequence;
+
+    /* Records appended since the last sync, and time of the last sync in
+     * APP_TIMESTAMP microseconds */
+    uint32_t           syncRecords;
+    uint64_t           syncTimeUs;
+
+    /* acquisition time of the values, in APP_TIMESTAMP microseconds */
+    uint64_t            timestamp;
+
     /* values to be written to SDCARD */
     double              temperature;
     double              pressure;
     double              humidity;
 
-    /* Flag to indicate whether data is read from the BME280 sensor */
-    volatile bool isDataReady;
+    /* quantities derived from the values */
+    APP_METEO_DATA      derived;
+
+    /* Samples waiting to be logged, oldest first, in blocks of samplePool */
+    APP_POOL            samplePool;
+    APP_SDCARD_SAMPLE*  sampleQueue[APP_SDCARD_SAMPLE_RECORDS];
+    uint32_t            sampleIn;
+    uint32_t            sampleCount;
 } APP_SDCARD_DATA;
 
 // *****************************************************************************
@@ -201,15 +283,19 @@ void APP_SDCARD_Tasks( void );
 
 /*******************************************************************************
   Function:
-    void APP_SDCARD_Notify(uint8_t temperature)
+    void APP_SDCARD_Notify(uint64_t timestamp, double temperature,
+                           double pressure, double humidity,
+                           const APP_METEO_DATA* derived)
 
   Summary:
     MPLAB Harmony SDCARD application Notify function
 
   Description:
     This routine is used to update the temperature sensor value received from
-    I2C Temperature Sensor Task. It also updates the temperature ready flag
-    which is polled by SDCARD Task routine to write the received values to SDCARD.
+    I2C Temperature Sensor Task. The values are copied to a block of the
+    sample pool and queued for the SDCARD Task routine to write to SDCARD.
+    If APP_SDCARD_SAMPLE_RECORDS samples are already waiting, the sample is
+    dropped and counted as an exhaustion of the pool.
 
     This function will called by I2C Temperature Sensor Task.
 
@@ -217,20 +303,112 @@ void APP_SDCARD_Tasks( void );
     None
 
   Parameters:
+    timestamp   - Acquisition time of the sample, in APP_TIMESTAMP microseconds
     temperature - Temperature Sensor value
+    pressure    - Pressure Sensor value
+    humidity    - Humidity Sensor value
+    derived     - Quantities derived from the values, logged after them when
+                  APP_METEO_LOG_ENABLE is true
 
   Returns:
     None.
 
   Example:
     <code>
-    APP_SDCARD_Notify(temperature);
+    APP_SDCARD_Notify(timestamp, temperature, pressure, humidity, &derived);
     </code>
 
   Remarks:
     This routine must be called from SYS_Tasks() routine.
  */
-void APP_SDCARD_Notify(double temperature, double pressure, double humidity);
+void APP_SDCARD_Notify(uint64_t timestamp, double temperature, double pressure, double humidity,
+                       const APP_METEO_DATA* derived);
+
+
+/*******************************************************************************
+  Function:
+    bool APP_SDCARD_IsIdle ( void )
+
+  Summary:
+    Reports whether the SD card task is waiting for an event
+
+  Description:
+    The SD card task is idle when the log file is open and no record is
+    waiting to be written, when logging has stopped, or when no card is
+    inserted and no record is waiting to be kept in the internal flash. The
+    SDHC card insertion interrupt ends the sleep. While a card is being
+    detected and mounted the SDMMC driver polls, so the task reports busy.
+    A card that failed while still mounted is idle until the next sample,
+    which opens its log again.
+
+  Precondition:
+    APP_SDCARD_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if the task has no work until the next interrupt or timer event.
+
+  Example:
+    <code>
+    if (APP_SDCARD_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task. Call it with interrupts disabled so that the
+    result cannot change before the device goes to sleep.
+ */
+
+bool APP_SDCARD_IsIdle( void );
+
+
+/*******************************************************************************
+  Function:
+    int32_t APP_SDCARD_LogRead ( const char* name, uint32_t offset,
+                                 void* buffer, uint32_t size )
+
+  Summary:
+    Reads the log file being written
+
+  Description:
+    FatFs does not open a file a second time while it is open for writing,
+    so other tasks read the current log file through this function. The
+    read ends at the last record written to the card; records in the
+    staging buffer are not read.
+
+  Precondition:
+    APP_SDCARD_Initialize should have been called.
+
+  Parameters:
+    name    - Name of the log file, without the mount name
+    offset  - File offset to read from
+    buffer  - Receives the data
+    size    - Bytes to read
+
+  Returns:
+    The number of bytes read, 0 at the end of the records on the card, or -1
+    if the file is not the one being written or could not be read.
+
+  Example:
+    <code>
+    length = APP_SDCARD_LogRead(name, offset, buffer, sizeof(buffer));
+
+    if (length < 0)
+    {
+        handle = SYS_FS_FileOpen(path, SYS_FS_FILE_OPEN_READ);
+    }
+    </code>
+
+  Remarks:
+    Moves the file pointer of the log file, which the task sets again before
+    each write.
+ */
+
+int32_t APP_SDCARD_LogRead( const char* name, uint32_t offset, void* buffer, uint32_t size );
 
 
 //DOM-IGNORE-BEGIN
@@ -0,0 +1,361 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_timestamp.c
+
+  Summary:
+    This file contains the source code for the timestamp service.
+
+  Description:
+    This file anchors the SYS_TIME 64-bit counter to the RTC. At start up and
+    every APP_TIMESTAMP_RESYNC_MS the RTC is polled until its seconds field
+    changes. The counter value at that moment and the new RTC time form an
+    anchor pair. Between anchors, wall clock time is extrapolated from the
+    counter with a drift correction estimated from the previous resyncs.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "app_timestamp.h"
+#include "peripheral/rtc/plib_rtc.h"
+#include "system/int/sys_int.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_TIMESTAMP_US_PER_SECOND     1000000LL
+#define APP_TIMESTAMP_PPB               1000000000LL
+
+/* Days from 0000/03/01 to 1970/01/01 in the proleptic Gregorian calendar */
+#define APP_TIMESTAMP_DAYS_TO_1970      719468LL
+#define APP_TIMESTAMP_SECONDS_PER_DAY   86400LL
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds timestamp service data
+
+  Description:
+    This structure holds the timestamp service's data.
+
+  Remarks:
+    This structure should be initialized by the APP_TIMESTAMP_Initialize
+    function.
+*/
+
+APP_TIMESTAMP_DATA app_timestampData;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void APP_TIMESTAMP_ResyncTimerHandler(uintptr_t context)
+{
+    APP_TIMESTAMP_DATA* pTimestamp = (APP_TIMESTAMP_DATA*) context;
+
+    pTimestamp->resyncRequest = true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static int32_t APP_TIMESTAMP_Clamp(int64_t value, int64_t limit)
+{
+    if (value > limit)
+    {
+        value = limit;
+    }
+    else if (value < -limit)
+    {
+        value = -limit;
+    }
+
+    return (int32_t)value;
+}
+
+/* Wall clock microseconds for a monotonic timestamp, using the current
+ * anchor. Timestamps before the anchor extrapolate backwards. */
+static int64_t APP_TIMESTAMP_WallUsGet(uint64_t timestampUs)
+{
+    int64_t delta = (int64_t)(timestampUs - app_timestampData.anchorMonoUs);
+
+    return app_timestampData.anchorWallUs + delta +
+           ((delta * app_timestampData.ratePpb) / APP_TIMESTAMP_PPB);
+}
+
+static void APP_TIMESTAMP_Anchor(uint64_t monoUs, int64_t rtcWallUs)
+{
+    int64_t predictedUs;
+    int64_t errorUs;
+    int64_t intervalUs;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    if (app_timestampData.isSynced == false)
+    {
+        app_timestampData.anchorMonoUs = monoUs;
+        app_timestampData.anchorWallUs = rtcWallUs;
+        app_timestampData.driftPpb = 0;
+        app_timestampData.ratePpb = 0;
+        app_timestampData.isSynced = true;
+
+        SYS_INT_Restore(interruptState);
+        return;
+    }
+
+    intervalUs = (int64_t)(monoUs - app_timestampData.anchorMonoUs);
+    predictedUs = APP_TIMESTAMP_WallUsGet(monoUs);
+    errorUs = rtcWallUs - predictedUs;
+    app_timestampData.lastErrorUs = errorUs;
+
+    if ((intervalUs <= 0) ||
+        (errorUs > APP_TIMESTAMP_STEP_LIMIT_US) || (errorUs < -APP_TIMESTAMP_STEP_LIMIT_US))
+    {
+        /* The RTC was set or the counter was not compensated for a sleep.
+         * Slewing would take too long, so step to the RTC. */
+        app_timestampData.anchorMonoUs = monoUs;
+        app_timestampData.anchorWallUs = rtcWallUs;
+        app_timestampData.ratePpb = app_timestampData.driftPpb;
+        app_timestampData.stepCount++;
+
+        SYS_INT_Restore(interruptState);
+        return;
+    }
+
+    /* The offset accumulated because the frequency estimate was wrong by
+     * errorUs / intervalUs. Correct the estimate, and on top of it remove the
+     * offset over the next resync interval. The new anchor is the predicted
+     * time, so wall clock time stays continuous. */
+    app_timestampData.driftPpb = APP_TIMESTAMP_Clamp(app_timestampData.driftPpb +
+                                    ((errorUs * APP_TIMESTAMP_PPB) / intervalUs), APP_TIMESTAMP_MAX_RATE_PPB);
+
+    app_timestampData.ratePpb = APP_TIMESTAMP_Clamp(app_timestampData.driftPpb +
+                                    ((errorUs * APP_TIMESTAMP_PPB) / ((int64_t)APP_TIMESTAMP_RESYNC_MS * 1000)),
+                                    APP_TIMESTAMP_MAX_RATE_PPB);
+
+    app_timestampData.anchorMonoUs = monoUs;
+    app_timestampData.anchorWallUs = predictedUs;
+
+    SYS_INT_Restore(interruptState);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_TIMESTAMP_Initialize ( void )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+void APP_TIMESTAMP_Initialize ( void )
+{
+    app_timestampData.state = APP_TIMESTAMP_STATE_SYNC_START;
+    app_timestampData.resyncRequest = false;
+    app_timestampData.isSynced = false;
+    app_timestampData.anchorMonoUs = 0;
+    app_timestampData.anchorWallUs = 0;
+    app_timestampData.driftPpb = 0;
+    app_timestampData.ratePpb = 0;
+    app_timestampData.lastErrorUs = 0;
+    app_timestampData.stepCount = 0;
+
+    SYS_TIME_CallbackRegisterMS(APP_TIMESTAMP_ResyncTimerHandler, (uintptr_t) &app_timestampData,
+            APP_TIMESTAMP_RESYNC_MS, SYS_TIME_PERIODIC);
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_TIMESTAMP_Tasks ( void )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+void APP_TIMESTAMP_Tasks ( void )
+{
+    struct tm rtcTime = { 0 };
+    uint64_t count;
+
+    switch (app_timestampData.state)
+    {
+        case APP_TIMESTAMP_STATE_SYNC_START:
+        {
+            RTC_RTCCTimeGet(&rtcTime);
+            app_timestampData.syncSecond = rtcTime.tm_sec;
+            app_timestampData.state = APP_TIMESTAMP_STATE_SYNC_WAIT;
+            break;
+        }
+
+        case APP_TIMESTAMP_STATE_SYNC_WAIT:
+        {
+            /* Read the counter first so that it is never later than the edge */
+            count = SYS_TIME_Counter64Get();
+            RTC_RTCCTimeGet(&rtcTime);
+
+            if (rtcTime.tm_sec != app_timestampData.syncSecond)
+            {
+                APP_TIMESTAMP_Anchor(APP_TIMESTAMP_CountToUS(count),
+                                     APP_TIMESTAMP_TimeToSeconds(&rtcTime) * APP_TIMESTAMP_US_PER_SECOND);
+
+                app_timestampData.state = APP_TIMESTAMP_STATE_SYNCED;
+            }
+            break;
+        }
+
+        case APP_TIMESTAMP_STATE_SYNCED:
+        {
+            if (app_timestampData.resyncRequest == true)
+            {
+                app_timestampData.resyncRequest = false;
+                app_timestampData.state = APP_TIMESTAMP_STATE_SYNC_START;
+            }
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_TIMESTAMP_IsIdle ( void )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+bool APP_TIMESTAMP_IsIdle ( void )
+{
+    return (app_timestampData.state == APP_TIMESTAMP_STATE_SYNCED) &&
+           (app_timestampData.resyncRequest == false);
+}
+
+
+/******************************************************************************
+  Function:
+    uint64_t APP_TIMESTAMP_CountToUS ( uint64_t count )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+uint64_t APP_TIMESTAMP_CountToUS ( uint64_t count )
+{
+    uint64_t frequency = SYS_TIME_FrequencyGet();
+
+    /* Split the conversion so that count * 10^6 cannot overflow */
+    return ((count / frequency) * APP_TIMESTAMP_US_PER_SECOND) +
+           (((count % frequency) * APP_TIMESTAMP_US_PER_SECOND) / frequency);
+}
+
+
+/******************************************************************************
+  Function:
+    uint64_t APP_TIMESTAMP_US_Get ( void )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+uint64_t APP_TIMESTAMP_US_Get ( void )
+{
+    return APP_TIMESTAMP_CountToUS(SYS_TIME_Counter64Get());
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_TIMESTAMP_ToTime ( uint64_t timestampUs, struct tm * wallTime,
+                                uint32_t * microseconds )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+bool APP_TIMESTAMP_ToTime ( uint64_t timestampUs, struct tm * wallTime, uint32_t * microseconds )
+{
+    int64_t wallUs;
+    time_t seconds;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    if (app_timestampData.isSynced == false)
+    {
+        SYS_INT_Restore(interruptState);
+        return false;
+    }
+
+    wallUs = APP_TIMESTAMP_WallUsGet(timestampUs);
+
+    SYS_INT_Restore(interruptState);
+
+    seconds = (time_t)(wallUs / APP_TIMESTAMP_US_PER_SECOND);
+    *microseconds = (uint32_t)(wallUs % APP_TIMESTAMP_US_PER_SECOND);
+    *wallTime = *gmtime(&seconds);
+
+    return true;
+}
+
+
+/******************************************************************************
+  Function:
+    int64_t APP_TIMESTAMP_TimeToSeconds ( const struct tm * wallTime )
+
+  Remarks:
+    See prototype in app_timestamp.h.
+ */
+
+int64_t APP_TIMESTAMP_TimeToSeconds ( const struct tm * wallTime )
+{
+    int64_t year = (int64_t)wallTime->tm_year + 1900;
+    int64_t month = (int64_t)wallTime->tm_mon + 1;
+    int64_t days;
+
+    /* Count the years from March, so that the leap day ends them */
+    if (month <= 2)
+    {
+        year--;
+        month += 12;
+    }
+
+    days = (365 * year) + (year / 4) - (year / 100) + (year / 400) + (((153 * (month - 3)) + 2) / 5) +
+           (int64_t)wallTime->tm_mday - 1 - APP_TIMESTAMP_DAYS_TO_1970;
+
+    return (days * APP_TIMESTAMP_SECONDS_PER_DAY) + ((int64_t)wallTime->tm_hour * 3600) +
+           ((int64_t)wallTime->tm_min * 60) + (int64_t)wallTime->tm_sec;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,378 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_timestamp.h
+
+  Summary:
+    This header file provides prototypes and definitions for the timestamp
+    service.
+
+  Description:
+    The RTC provides wall clock time with one second resolution. The SYS_TIME
+    64-bit counter has sub-microsecond resolution but no wall clock base. This
+    service anchors the counter to RTC second boundaries and converts counter
+    values to monotonic microsecond timestamps and to wall clock time.
+*******************************************************************************/
+
+#ifndef _APP_TIMESTAMP_H
+#define _APP_TIMESTAMP_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "configuration.h"
+#include "system/time/sys_time.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Timestamp service states enumeration
+
+  Description:
+    This enumeration defines the valid timestamp service states.
+*/
+
+typedef enum
+{
+    /* Read the current RTC second */
+    APP_TIMESTAMP_STATE_SYNC_START,
+
+    /* Poll the RTC until the second changes, then anchor the counter */
+    APP_TIMESTAMP_STATE_SYNC_WAIT,
+
+    /* Anchored. Wait for the resync timer. */
+    APP_TIMESTAMP_STATE_SYNCED,
+} APP_TIMESTAMP_STATES;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds timestamp service data
+
+  Description:
+    The wall clock time of a monotonic timestamp t is
+
+        anchorWallUs + (t - anchorMonoUs) * (1 + ratePpb / 10^9)
+
+    ratePpb is the sum of the estimated frequency error of the SYS_TIME clock
+    against the RTC and a slew term that removes the offset seen at the last
+    resync over the following resync interval. Wall clock time therefore never
+    steps during normal operation.
+*/
+
+typedef struct
+{
+    /* Service's current state */
+    APP_TIMESTAMP_STATES    state;
+
+    /* RTC second seen when the sync started */
+    int                     syncSecond;
+
+    /* Set by the periodic resync timer */
+    volatile bool           resyncRequest;
+
+    /* True once the first anchor has been taken */
+    bool                    isSynced;
+
+    /* Anchor point: monotonic and wall clock microseconds */
+    uint64_t                anchorMonoUs;
+    int64_t                 anchorWallUs;
+
+    /* Estimated frequency error and current correction, in parts per 10^9 */
+    int32_t                 driftPpb;
+    int32_t                 ratePpb;
+
+    /* Offset found at the last resync, for diagnostics */
+    int64_t                 lastErrorUs;
+
+    /* Number of resyncs that stepped instead of slewed */
+    uint32_t                stepCount;
+} APP_TIMESTAMP_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_TIMESTAMP_Initialize ( void )
+
+  Summary:
+     Timestamp service initialization routine.
+
+  Description:
+    This function places the service in its initial state. The first anchor is
+    taken by APP_TIMESTAMP_Tasks at the next RTC second boundary.
+
+  Precondition:
+    RTC_Initialize and SYS_TIME_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_TIMESTAMP_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void APP_TIMESTAMP_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_TIMESTAMP_Tasks ( void )
+
+  Summary:
+    Timestamp service tasks function
+
+  Description:
+    Every APP_TIMESTAMP_RESYNC_MS this routine polls the RTC for a second
+    boundary, compares the wall clock time predicted from the counter with
+    the RTC and updates the drift correction.
+
+  Precondition:
+    APP_TIMESTAMP_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_TIMESTAMP_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine.
+ */
+
+void APP_TIMESTAMP_Tasks( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_TIMESTAMP_IsIdle ( void )
+
+  Summary:
+    Reports whether the timestamp service is waiting for an event
+
+  Description:
+    The service is busy while it polls the RTC for a second boundary.
+
+  Precondition:
+    APP_TIMESTAMP_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if no resync is in progress.
+
+  Example:
+    <code>
+    if (APP_TIMESTAMP_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task.
+ */
+
+bool APP_TIMESTAMP_IsIdle( void );
+
+
+/*******************************************************************************
+  Function:
+    uint64_t APP_TIMESTAMP_CountToUS ( uint64_t count )
+
+  Summary:
+    Converts a SYS_TIME 64-bit counter value to microseconds
+
+  Description:
+    Converts a value returned by SYS_TIME_Counter64Get, or captured from it by
+    a driver, to a monotonic timestamp in microseconds since boot.
+
+  Precondition:
+    SYS_TIME_Initialize should have been called.
+
+  Parameters:
+    count - SYS_TIME 64-bit counter value
+
+  Returns:
+    Microseconds since boot.
+
+  Example:
+    <code>
+    uint64_t us = APP_TIMESTAMP_CountToUS(SYS_TIME_Counter64Get());
+    </code>
+
+  Remarks:
+    Unlike SYS_TIME_CountToUS this does not overflow for counts above 32 bits.
+ */
+
+uint64_t APP_TIMESTAMP_CountToUS( uint64_t count );
+
+
+/*******************************************************************************
+  Function:
+    uint64_t APP_TIMESTAMP_US_Get ( void )
+
+  Summary:
+    Returns the current monotonic timestamp
+
+  Description:
+    Returns the number of microseconds since boot. The value never decreases.
+
+  Precondition:
+    SYS_TIME_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    Microseconds since boot.
+
+  Example:
+    <code>
+    uint64_t start = APP_TIMESTAMP_US_Get();
+    </code>
+
+  Remarks:
+    None.
+ */
+
+uint64_t APP_TIMESTAMP_US_Get( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_TIMESTAMP_ToTime ( uint64_t timestampUs, struct tm * wallTime,
+                                uint32_t * microseconds )
+
+  Summary:
+    Converts a monotonic timestamp to wall clock time
+
+  Description:
+    Converts a timestamp returned by APP_TIMESTAMP_US_Get or
+    APP_TIMESTAMP_CountToUS to calendar time in the RTC time zone, with the
+    fraction of the second in microseconds.
+
+  Precondition:
+    APP_TIMESTAMP_Initialize should have been called.
+
+  Parameters:
+    timestampUs  - Monotonic timestamp in microseconds
+    wallTime     - Receives the calendar time
+    microseconds - Receives the microseconds within the second
+
+  Returns:
+    true if the conversion succeeded, false if no anchor has been taken yet.
+
+  Example:
+    <code>
+    struct tm wallTime;
+    uint32_t us;
+
+    if (APP_TIMESTAMP_ToTime(APP_TIMESTAMP_US_Get(), &wallTime, &us) == true)
+    {
+        printf("%02d:%02d:%02d.%06lu\r\n", wallTime.tm_hour, wallTime.tm_min,
+               wallTime.tm_sec, us);
+    }
+    </code>
+
+  Remarks:
+    None.
+ */
+
+bool APP_TIMESTAMP_ToTime( uint64_t timestampUs, struct tm * wallTime, uint32_t * microseconds );
+
+
+/*******************************************************************************
+  Function:
+    int64_t APP_TIMESTAMP_TimeToSeconds ( const struct tm * wallTime )
+
+  Summary:
+    Converts wall clock time to seconds since 1970/01/01 00:00:00
+
+  Description:
+    The inverse of gmtime, which APP_TIMESTAMP_ToTime uses. Unlike mktime,
+    the result does not depend on the time zone or daylight saving rules of
+    the C library, and wallTime is not changed.
+
+  Precondition:
+    None.
+
+  Parameters:
+    wallTime - Calendar time with each field within its range, as the RTC
+               and gmtime give it; tm_wday, tm_yday and tm_isdst are ignored
+
+  Returns:
+    Seconds since 1970/01/01 00:00:00.
+
+  Example:
+    <code>
+    struct tm rtcTime;
+
+    RTC_RTCCTimeGet(&rtcTime);
+    printf("%lld\r\n", (long long)APP_TIMESTAMP_TimeToSeconds(&rtcTime));
+    </code>
+
+  Remarks:
+    None.
+ */
+
+int64_t APP_TIMESTAMP_TimeToSeconds( const struct tm * wallTime );
+
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_TIMESTAMP_H */
+
+/*******************************************************************************
+ End of File
+ */
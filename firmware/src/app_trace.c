@@ -0,0 +1,364 @@
+/*******************************************************************************
+  MPLAB Harmony Application Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_trace.c
+
+  Summary:
+    This file contains the source code for the BME280 raw data trace.
+
+  Description:
+    Recording formats each block passed to the driver's trace handler as a
+    console line. Replay parses the same lines from a file into an array of
+    records and hands it to the replay PLIB, which answers the driver's reads
+    from it. The application then reads samples back to back instead of on
+    its timer.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_trace.h"
+#include "app_sdcard.h"
+#include "app_timestamp.h"
+#include "driver/bme280/drv_bme280.h"
+#include "driver/bme280/drv_bme280_replay.h"
+#include "system/time/sys_time.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Data Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define APP_TRACE_LINE_TAG          "#BME280 "
+#define APP_TRACE_LINE_SIZE         128
+#define APP_TRACE_US_PER_SECOND     1000000U
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds trace data
+
+  Description:
+    This structure holds the trace's data.
+
+  Remarks:
+    This structure should be initialized by the APP_TRACE_Initialize function.
+*/
+
+APP_TRACE_DATA app_traceData;
+
+#if (DRV_BME280_REPLAY == 1)
+/* Records loaded from the trace file */
+static DRV_BME280_REPLAY_RECORD app_traceRecords[APP_TRACE_REPLAY_RECORDS_MAX];
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Callback Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static void APP_TRACE_RecordHandler(uint8_t reg, const uint8_t* data, uint8_t length,
+                                    uint64_t timestamp, uintptr_t context)
+{
+    char line[APP_TRACE_LINE_SIZE];
+    uint64_t timestampUs = APP_TIMESTAMP_CountToUS(timestamp);
+    int n;
+    uint8_t i;
+
+    n = sprintf(line, APP_TRACE_LINE_TAG "%lu.%06lu %02X ",
+                (unsigned long)(timestampUs / APP_TRACE_US_PER_SECOND),
+                (unsigned long)(timestampUs % APP_TRACE_US_PER_SECOND), reg);
+
+    for (i = 0; (i < length) && ((n + 2) < APP_TRACE_LINE_SIZE); i++)
+    {
+        n += sprintf(&line[n], "%02X", data[i]);
+    }
+
+    printf("%s\r\n", line);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+#if (DRV_BME280_REPLAY == 1)
+static int APP_TRACE_HexDigit(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+
+    return -1;
+}
+
+/* Parse a trace line. Other console output is rejected. */
+static bool APP_TRACE_LineParse(const char* line, DRV_BME280_REPLAY_RECORD* record)
+{
+    char* end;
+    unsigned long seconds;
+    unsigned long microseconds;
+    unsigned long reg;
+    int high;
+    int low;
+
+    line += strlen(APP_TRACE_LINE_TAG);
+
+    seconds = strtoul(line, &end, 10);
+    if ((end == line) || (*end != '.'))
+    {
+        return false;
+    }
+
+    line = end + 1;
+    microseconds = strtoul(line, &end, 10);
+    if ((end == line) || (microseconds >= APP_TRACE_US_PER_SECOND))
+    {
+        return false;
+    }
+
+    line = end;
+    reg = strtoul(line, &end, 16);
+    if ((end == line) || (reg > 0xFFU))
+    {
+        return false;
+    }
+
+    record->timestamp = ((uint64_t)seconds * APP_TRACE_US_PER_SECOND) + microseconds;
+    record->reg = (uint8_t)reg;
+    record->length = 0;
+
+    line = end;
+    while (*line == ' ')
+    {
+        line++;
+    }
+
+    high = APP_TRACE_HexDigit(line[0]);
+    while (high >= 0)
+    {
+        low = APP_TRACE_HexDigit(line[1]);
+
+        if ((low < 0) || (record->length == DRV_BME280_REPLAY_DATA_SIZE))
+        {
+            return false;
+        }
+
+        record->data[record->length++] = (uint8_t)((high << 4) | low);
+        line += 2;
+        high = APP_TRACE_HexDigit(line[0]);
+    }
+
+    return (record->length > 0U);
+}
+
+/* Close the trace file and start the replay */
+static void APP_TRACE_ReplayStart(void)
+{
+    SYS_FS_FileClose(app_traceData.fileHandle);
+
+    if (app_traceData.skipCount > 0U)
+    {
+        printf("Trace: %lu lines not loaded \r\n", (unsigned long)app_traceData.skipCount);
+    }
+
+    if (app_traceData.sampleCount == 0U)
+    {
+        printf("Trace: no samples to replay \r\n");
+        app_traceData.state = APP_TRACE_STATE_IDLE;
+        return;
+    }
+
+    printf("Trace: replaying %lu samples \r\n", (unsigned long)app_traceData.sampleCount);
+
+    app_traceData.startCount = SYS_TIME_Counter64Get();
+    app_traceData.startCycles = DRV_BME280_CompensationCyclesGet(DRV_BME280_INSTANCE_0);
+    app_traceData.passCount = 0;
+    DRV_BME280_REPLAY_RecordsSet(app_traceRecords, app_traceData.recordCount);
+    app_traceData.state = APP_TRACE_STATE_REPLAY;
+}
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_TRACE_Initialize ( void )
+
+  Remarks:
+    See prototype in app_trace.h.
+ */
+
+void APP_TRACE_Initialize ( void )
+{
+    app_traceData.fileHandle = SYS_FS_HANDLE_INVALID;
+    app_traceData.recordCount = 0;
+    app_traceData.sampleCount = 0;
+    app_traceData.skipCount = 0;
+    app_traceData.startCount = 0;
+    app_traceData.startCycles = 0;
+    app_traceData.passCount = 0;
+
+#if (DRV_BME280_REPLAY == 1)
+    app_traceData.state = APP_TRACE_STATE_OPEN_FILE;
+#else
+    app_traceData.state = APP_TRACE_STATE_IDLE;
+#endif
+
+    if (APP_TRACE_RECORD_ENABLE == true)
+    {
+        DRV_BME280_TraceHandlerSet(DRV_BME280_INSTANCE_0, APP_TRACE_RecordHandler, (uintptr_t) &app_traceData);
+    }
+}
+
+
+/******************************************************************************
+  Function:
+    void APP_TRACE_Tasks ( void )
+
+  Remarks:
+    See prototype in app_trace.h.
+ */
+
+void APP_TRACE_Tasks ( void )
+{
+#if (DRV_BME280_REPLAY == 1)
+    char line[APP_TRACE_LINE_SIZE];
+    DRV_BME280_REPLAY_RECORD* record;
+    uint64_t elapsedUs;
+
+    switch (app_traceData.state)
+    {
+        case APP_TRACE_STATE_OPEN_FILE:
+        {
+            /* Fails until the card has been mounted */
+            app_traceData.fileHandle = SYS_FS_FileOpen(SYS_FS_MEDIA_IDX0_MOUNT_NAME_VOLUME_IDX0"/"APP_TRACE_REPLAY_FILE,
+                                                      (SYS_FS_FILE_OPEN_READ));
+
+            if (app_traceData.fileHandle != SYS_FS_HANDLE_INVALID)
+            {
+                app_traceData.state = APP_TRACE_STATE_LOAD;
+            }
+            break;
+        }
+
+        case APP_TRACE_STATE_LOAD:
+        {
+            if ((SYS_FS_FileEOF(app_traceData.fileHandle) == true) ||
+                (SYS_FS_FileStringGet(app_traceData.fileHandle, line, sizeof(line)) != SYS_FS_RES_SUCCESS))
+            {
+                APP_TRACE_ReplayStart();
+                break;
+            }
+
+            if (strncmp(line, APP_TRACE_LINE_TAG, strlen(APP_TRACE_LINE_TAG)) != 0)
+            {
+                /* Weather records and other console output */
+                break;
+            }
+
+            if (app_traceData.recordCount == APP_TRACE_REPLAY_RECORDS_MAX)
+            {
+                app_traceData.skipCount++;
+                break;
+            }
+
+            record = &app_traceRecords[app_traceData.recordCount];
+
+            if (APP_TRACE_LineParse(line, record) == false)
+            {
+                app_traceData.skipCount++;
+                break;
+            }
+
+            app_traceData.recordCount++;
+
+            if (record->reg == DRV_BME280_REG_DATA_ADDR)
+            {
+                app_traceData.sampleCount++;
+            }
+            break;
+        }
+
+        case APP_TRACE_STATE_REPLAY:
+        {
+            app_traceData.passCount++;
+
+            /* Done once the last sample has been through the driver and the
+             * SD card task. Both run before this task. */
+            if ((DRV_BME280_REPLAY_IsComplete() == true) &&
+                (DRV_BME280_Status(DRV_BME280_INSTANCE_0) == SYS_STATUS_READY) &&
+                (APP_SDCARD_IsIdle() == true))
+            {
+                elapsedUs = APP_TIMESTAMP_CountToUS(SYS_TIME_Counter64Get() - app_traceData.startCount);
+
+                printf("Trace: %lu samples replayed in %lu us \r\n",
+                       (unsigned long)app_traceData.sampleCount, (unsigned long)elapsedUs);
+                printf("Trace: compensation %lu cycles per sample \r\n",
+                       (unsigned long)((DRV_BME280_CompensationCyclesGet(DRV_BME280_INSTANCE_0) -
+                                        app_traceData.startCycles) / app_traceData.sampleCount));
+                printf("Trace: superloop %lu cycles per pass, data cache %s \r\n",
+                       (unsigned long)((elapsedUs * (SYS_TIME_CPU_CLOCK_FREQUENCY / 1000000U)) / app_traceData.passCount),
+                       (SYS_DCACHE_ENABLE == true) ? "on" : "off");
+
+                app_traceData.state = APP_TRACE_STATE_IDLE;
+            }
+            break;
+        }
+
+        case APP_TRACE_STATE_IDLE:
+        default:
+        {
+            break;
+        }
+    }
+#endif
+}
+
+
+/******************************************************************************
+  Function:
+    bool APP_TRACE_IsIdle ( void )
+
+  Remarks:
+    See prototype in app_trace.h.
+ */
+
+bool APP_TRACE_IsIdle ( void )
+{
+    return (app_traceData.state == APP_TRACE_STATE_IDLE);
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,243 @@
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_trace.h
+
+  Summary:
+    This header file provides prototypes and definitions for the BME280 raw
+    data trace.
+
+  Description:
+    When APP_TRACE_RECORD_ENABLE is true, every calibration block and
+    measurement burst read by the BME280 driver is printed to the console as
+    a trace line:
+
+        #BME280 <seconds>.<microseconds> <register> <data>
+
+    The time is the monotonic APP_TIMESTAMP time of the read, the register is
+    the first register of the block in hex and the data is the raw bytes in
+    hex. The lines start with '#' so that they can be told apart from the
+    weather records that are printed with them.
+
+    When DRV_BME280_REPLAY is 1, a console capture saved as
+    APP_TRACE_REPLAY_FILE on the SD card is loaded at start up and replayed
+    through the driver, compensation and SD card log as fast as they run. The
+    elapsed time, the core clock cycles of a pass of the superloop and the
+    cycles spent in the compensation per sample are printed when the last
+    sample has been logged, with the state of the data cache
+    (SYS_DCACHE_ENABLE) they were measured with.
+*******************************************************************************/
+
+#ifndef _APP_TRACE_H
+#define _APP_TRACE_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "configuration.h"
+#include "system/fs/sys_fs.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Application states
+
+  Summary:
+    Trace states enumeration
+
+  Description:
+    This enumeration defines the valid trace states. Only replay uses states
+    other than idle.
+*/
+
+typedef enum
+{
+    /* Wait for the SD card and open the trace file */
+    APP_TRACE_STATE_OPEN_FILE,
+
+    /* Read the trace file one line at a time */
+    APP_TRACE_STATE_LOAD,
+
+    /* Replay in progress */
+    APP_TRACE_STATE_REPLAY,
+
+    /* Recording, or replay finished */
+    APP_TRACE_STATE_IDLE,
+} APP_TRACE_STATES;
+
+
+// *****************************************************************************
+/* Application Data
+
+  Summary:
+    Holds trace data
+
+  Description:
+    This structure holds the trace's data.
+
+  Remarks:
+    The replay records themselves are defined outside this structure.
+ */
+
+typedef struct
+{
+    /* Trace's current state */
+    APP_TRACE_STATES    state;
+
+    /* SYS_FS File Handle of the trace file */
+    SYS_FS_HANDLE       fileHandle;
+
+    /* Records loaded, and how many of them are measurements */
+    uint32_t            recordCount;
+    uint32_t            sampleCount;
+
+    /* Lines of the trace file that were not loaded */
+    uint32_t            skipCount;
+
+    /* SYS_TIME counter and driver compensation cycles when the replay
+     * started */
+    uint64_t            startCount;
+    uint32_t            startCycles;
+
+    /* Passes of the superloop during the replay */
+    uint32_t            passCount;
+} APP_TRACE_DATA;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Application Initialization and State Machine Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_TRACE_Initialize ( void )
+
+  Summary:
+     Trace initialization routine.
+
+  Description:
+    When recording, this function registers the trace handler with the BME280
+    driver. When replaying, it places the trace in the state that waits for
+    the trace file.
+
+  Precondition:
+    DRV_BME280_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_TRACE_Initialize();
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+void APP_TRACE_Initialize ( void );
+
+
+/*******************************************************************************
+  Function:
+    void APP_TRACE_Tasks ( void )
+
+  Summary:
+    Trace tasks function
+
+  Description:
+    When replaying, this routine loads the trace file, starts the replay and
+    reports the elapsed time once the last sample has been logged.
+
+  Precondition:
+    APP_TRACE_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    APP_TRACE_Tasks();
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks() routine, after the tasks of
+    the other applications.
+ */
+
+void APP_TRACE_Tasks( void );
+
+
+/*******************************************************************************
+  Function:
+    bool APP_TRACE_IsIdle ( void )
+
+  Summary:
+    Reports whether the trace is waiting for an event
+
+  Description:
+    The trace is busy while it loads and replays a trace file.
+
+  Precondition:
+    APP_TRACE_Initialize should have been called.
+
+  Parameters:
+    None.
+
+  Returns:
+    true if no replay is in progress.
+
+  Example:
+    <code>
+    if (APP_TRACE_IsIdle() == true)
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    Used by the low power task.
+ */
+
+bool APP_TRACE_IsIdle( void );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* _APP_TRACE_H */
+
+/*******************************************************************************
+ End of File
+ */
@@ -71,7 +71,9 @@ extern "C" {
 // Section: System Configuration
 // *****************************************************************************
 // *****************************************************************************
-
+/* Data cache of the CMCC, enabled by SYS_Initialize. It only caches the flash
+ * and the QSPI memory; set to false to compare the timings without it. */
+#define SYS_DCACHE_ENABLE                           true
 
 
 // *****************************************************************************
@@ -96,7 +98,9 @@ extern "C" {
 
 #define SYS_FS_AUTOMOUNT_ENABLE           true
 #define SYS_FS_CLIENT_NUMBER              1
-#define SYS_FS_MAX_FILES                  1
+/* The log index is written, a query reads the log and the trace replay reads
+ * its file while the data log is open */
+#define SYS_FS_MAX_FILES                  (3 + DRV_BME280_REPLAY)
 #define SYS_FS_MAX_FILE_SYSTEM_TYPE       1
 #define SYS_FS_MEDIA_MAX_BLOCK_SIZE       512
 #define SYS_FS_MEDIA_MANAGER_BUFFER_SIZE  2048
@@ -109,6 +113,7 @@ extern "C" {
 #define SYS_FS_FAT_READONLY               false
 #define SYS_FS_FAT_CODE_PAGE              437
 #define SYS_FS_FAT_MAX_SS                 SYS_FS_MEDIA_MAX_BLOCK_SIZE
+#define SYS_FS_FAT_WRITE_GATHER_SECTORS   8
 
 
 #define SYS_FS_MEDIA_TYPE_IDX0 				SYS_FS_MEDIA_TYPE_SD_CARD
@@ -130,12 +135,26 @@ extern "C" {
 #define DRV_BME280_INSTANCES_NUMBER         1
 #define DRV_BME280_INSTANCE_0               0    
 
+/* Set to 1 to run the BME280 driver against the simulated sensor in
+ * drv_bme280_sim.c instead of the SERCOM3 I2C PLIB */
+#define DRV_BME280_SIMULATION               0
+
+/* Set to 1 to answer the BME280 driver's reads from a recorded trace with
+ * drv_bme280_replay.c instead of the SERCOM3 I2C PLIB. See app_trace.h. */
+#define DRV_BME280_REPLAY                   0
+
+/* RAM Disk Driver Configuration Options. The driver is not instantiated by
+ * default. It stands in for the SD card when DRV_RAMDISK_Initialize is called
+ * from SYS_Initialize in place of DRV_SDMMC_Initialize. */
+#define DRV_RAMDISK_INSTANCES_NUMBER        1
+#define DRV_RAMDISK_INDEX_0                 0
+
 /*** SDMMC Driver Instance 0 Configuration ***/
 #define DRV_SDMMC_INDEX_0                                0
 #define DRV_SDMMC_CLIENTS_NUMBER_IDX0                    1
-#define DRV_SDMMC_QUEUE_SIZE_IDX0                        1
+#define DRV_SDMMC_QUEUE_SIZE_IDX0                        4
 #define DRV_SDMMC_PROTOCOL_SUPPORT_IDX0                  DRV_SDMMC_PROTOCOL_SD
-#define DRV_SDMMC_CONFIG_SPEED_MODE_IDX0                 DRV_SDMMC_SPEED_MODE_DEFAULT
+#define DRV_SDMMC_CONFIG_SPEED_MODE_IDX0                 DRV_SDMMC_SPEED_MODE_HIGH
 #define DRV_SDMMC_CONFIG_BUS_WIDTH_IDX0                  DRV_SDMMC_BUS_WIDTH_4_BIT
 #define DRV_SDMMC_CARD_DETECTION_METHOD_IDX0             DRV_SDMMC_CD_METHOD_USE_SDCD
 
@@ -153,6 +172,98 @@ extern "C" {
 // *****************************************************************************
 // *****************************************************************************
 
+/* Low power idle task */
+#define APP_POWER_IDLE_MIN_US               (100U)
+/* STANDBY stops GCLK1 and with it the SERCOM2 console, so characters typed
+ * in STANDBY are lost. Off by default; APP_POWER_StandbyEnable turns it on
+ * where nobody types on the console. */
+#define APP_POWER_STANDBY_ENABLE            false
+#define APP_POWER_STANDBY_MIN_MS            (2500U)
+#define APP_POWER_STANDBY_MAX_S             (59U)
+#define APP_POWER_STANDBY_WAKE_LATENCY_US   (60U)
+
+/* Record pools: most pools listed by the console command 4, and most blocks
+ * in a pool */
+#define APP_POOL_MAX                        (8U)
+#define APP_POOL_BLOCKS_MAX                 (32U)
+
+/* DMA buffer pool: room for the SD card staging buffer and a download read
+ * buffer with the 128 byte line before it, and the number of buffers */
+#define APP_DMABUF_POOL_SIZE                (APP_SDCARD_LOG_BUFFER_SIZE + 128U + APP_QUERY_READ_SIZE)
+#define APP_DMABUF_BUFFERS                  (4U)
+
+/* SD card log file: preallocated size and size of the record staging
+ * buffer. The buffer must hold at least two 512 byte sectors to be written
+ * to the card without a copy. */
+#define APP_SDCARD_LOG_EXTENT_SIZE          (1024U * 1024U)
+#define APP_SDCARD_LOG_BUFFER_SIZE          (1024U)
+
+/* Samples waiting for the SD card task. Their blocks come from a record
+ * pool; a sample that finds the pool exhausted is dropped. */
+#define APP_SDCARD_SAMPLE_RECORDS           (4U)
+
+/* Journaled SD card log: records carry a sequence number and a CRC, and the
+ * file is synced every APP_SDCARD_JOURNAL_SYNC_RECORDS records or
+ * APP_SDCARD_JOURNAL_SYNC_MS, whichever comes first, by default; the
+ * sync_records and sync_ms settings change them. An existing log is
+ * recovered up to its last valid record and continued when the card is
+ * mounted. */
+#define APP_SDCARD_JOURNAL_ENABLE           true
+#define APP_SDCARD_JOURNAL_SYNC_RECORDS     (12U)
+#define APP_SDCARD_JOURNAL_SYNC_MS          (60000U)
+
+/* Log rotation and retention: a new file, named data_YYYYMMDD_hhmmss.txt
+ * after the time of its first record, is started when the records would
+ * exceed APP_SDCARD_ROTATE_SIZE bytes or, if APP_SDCARD_ROTATE_DAILY is true,
+ * when their date changes. The start of every file and the record that
+ * follows every APP_SDCARD_INDEX_STRIDE bytes are listed in
+ * APP_SDCARD_INDEX_FILE, as is the first record after a reset. The oldest
+ * files are deleted while the free space on the card is below
+ * APP_SDCARD_RETAIN_FREE_MIN_KB. */
+#define APP_SDCARD_ROTATE_SIZE              APP_SDCARD_LOG_EXTENT_SIZE
+#define APP_SDCARD_ROTATE_DAILY             true
+#define APP_SDCARD_INDEX_FILE               "log_index.txt"
+#define APP_SDCARD_INDEX_STRIDE             (64U * 1024U)
+#define APP_SDCARD_RETAIN_FREE_MIN_KB       (16U * 1024U)
+
+/* Settings and counters kept in the SmartEEPROM: the time between two
+ * samples by default, and the longest time counters wait to be saved */
+#define APP_CONFIG_SAMPLE_PERIOD_MS         (5000U)
+#define APP_CONFIG_COUNTER_SAVE_MS          (900000U)
+
+/* Internal flash log: while no SD card is mounted, samples are kept in a
+ * ring of APP_FLASHLOG_BLOCKS 8 KB blocks of flash from
+ * APP_FLASHLOG_ADDRESS, 510 samples per block, and moved to the SD log
+ * APP_FLASHLOG_DRAIN_RECORDS at a time once a card is mounted. The region is
+ * kept out of the program by ROM_LENGTH in the xc32-ld preprocessor macros,
+ * which ATSAME54P20A.ld checks against its FLASHLOG_ORIGIN. Up to
+ * APP_FLASHLOG_QUEUE_RECORDS samples wait in RAM during a block erase. */
+#define APP_FLASHLOG_ADDRESS                (0x000C0000U)
+#define APP_FLASHLOG_BLOCKS                 (16U)
+#define APP_FLASHLOG_QUEUE_RECORDS          (4U)
+#define APP_FLASHLOG_DRAIN_RECORDS          (64U)
+
+/* Logged data download: the log is read in blocks of APP_QUERY_READ_SIZE
+ * bytes, a multiple of the 512 byte sector, and sent in frames of up to
+ * APP_QUERY_FRAME_RECORDS records. A frame holds at most 9. */
+#define APP_QUERY_READ_SIZE                 (4096U)
+#define APP_QUERY_FRAME_RECORDS             (9U)
+
+/* BME280 raw data trace: print every block read from the sensor, and the
+ * file and number of records loaded for replay */
+#define APP_TRACE_RECORD_ENABLE             false
+#define APP_TRACE_REPLAY_FILE               "trace.txt"
+#define APP_TRACE_REPLAY_RECORDS_MAX        (512U)
+
+/* Derived quantities: altitude of the station above sea level in m, for
+ * the sea-level pressure, and whether they are added to the log records */
+#define APP_METEO_STATION_ALTITUDE_M        (0)
+#define APP_METEO_LOG_ENABLE                true
+
+/* Timestamp service */
+#define APP_TIMESTAMP_RESYNC_MS             (600000U)
+#define APP_TIMESTAMP_STEP_LIMIT_US         (100000LL)
+#define APP_TIMESTAMP_MAX_RATE_PPB          (20000000LL)
 
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
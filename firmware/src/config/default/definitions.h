@@ -60,6 +60,7 @@
 #include "peripheral/cmcc/plib_cmcc.h"
 #include "peripheral/tc/plib_tc0.h"
 #include "peripheral/rtc/plib_rtc.h"
+#include "peripheral/pm/plib_pm.h"
 #include "peripheral/sdhc/plib_sdhc1.h"
 #include "system/time/sys_time.h"
 #include "system/fs/sys_fs.h"
@@ -74,8 +75,20 @@
 #include "system/debug/sys_debug.h"
 #include "app.h"
 #include "app_sdcard.h"
+#include "app_timestamp.h"
+#include "app_power.h"
+#include "app_trace.h"
+#include "app_meteo.h"
+#include "app_query.h"
+#include "app_flashlog.h"
+#include "app_config.h"
+#include "app_dmabuf.h"
+#include "app_pool.h"
+#include "app_memory.h"
 
 #include "driver/bme280/drv_bme280.h"
+#include "driver/bme280/drv_bme280_sim.h"
+#include "driver/bme280/drv_bme280_replay.h"
 
 
 // DOM-IGNORE-BEGIN
@@ -56,6 +56,7 @@
 */
 
 #include "device.h"
+#include "peripheral/cmcc/plib_cmcc.h"
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -72,18 +73,26 @@ extern "C" {
 // *****************************************************************************
 
 
-#define ICACHE_ENABLE()
-#define ICACHE_DISABLE()
-#define ICACHE_INVALIDATE()
+/* The CMCC caches the code region only: the flash and the QSPI memory. The
+ * SRAM, the SmartEEPROM and the peripherals are not cached, so buffers in
+ * SRAM need no maintenance. The CMCC does not keep written data, so there is
+ * nothing to clean; a range is invalidated line by line. */
+#define DCACHE_CACHEABLE_END     (0x20000000U)
 
-#define DCACHE_ENABLE()
-#define DCACHE_DISABLE()
-#define DCACHE_INVALIDATE()
+#define ICACHE_ENABLE()          CMCC_EnableICache()
+#define ICACHE_DISABLE()         CMCC_DisableICache()
+#define ICACHE_INVALIDATE()      CMCC_InvalidateAll()
+
+#define DCACHE_ENABLE()          CMCC_EnableDCache()
+#define DCACHE_DISABLE()         CMCC_DisableDCache()
+#define DCACHE_INVALIDATE()      CMCC_InvalidateAll()
 #define DCACHE_CLEAN()
-#define DCACHE_CLEAN_INVALIDATE()
+#define DCACHE_CLEAN_INVALIDATE() CMCC_InvalidateAll()
 #define DCACHE_CLEAN_BY_ADDR(addr,sz)
-#define DCACHE_INVALIDATE_BY_ADDR(addr,sz)
-#define DCACHE_CLEAN_INVALIDATE_BY_ADDR(addr,sz)
+#define DCACHE_INVALIDATE_BY_ADDR(addr,sz)  do { \
+        if ((uint32_t)(addr) < DCACHE_CACHEABLE_END) { CMCC_InvalidateByAddr((uint32_t)(addr), (uint32_t)(sz)); } \
+    } while (false)
+#define DCACHE_CLEAN_INVALIDATE_BY_ADDR(addr,sz) DCACHE_INVALIDATE_BY_ADDR(addr,sz)
 
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
@@ -172,6 +172,76 @@ typedef void (*DRV_BME280_APP_CALLBACK)(DRV_BME280_TRANSFER_STATUS event, uintpt
 
 typedef void (*DRV_BME280_EVENT_HANDLER )( DRV_BME280_TRANSFER_STATUS event, uintptr_t context );
 
+// *****************************************************************************
+/* BME280 Driver Trace Handler Function Pointer
+
+   Summary
+    Pointer to a BME280 driver raw data trace handler function
+
+   Description
+    This data type defines the required function signature for the trace
+    handler. It is called with the raw bytes of each calibration block and
+    each measurement burst read from the sensor, before they are parsed.
+
+    reg is the first register of the block and length the number of bytes
+    at data. timestamp is the SYS_TIME 64-bit counter value of the read; for
+    a measurement burst it is the value returned by DRV_BME280_Get_Timestamp.
+
+  Remarks:
+    The handler is called from DRV_BME280_Tasks. The data is only valid
+    during the call.
+*/
+
+typedef void (*DRV_BME280_TRACE_HANDLER)( uint8_t reg, const uint8_t* data, uint8_t length,
+                                          uint64_t timestamp, uintptr_t context );
+
+// *****************************************************************************
+/* BME280 Driver I2C Statistics
+
+   Summary:
+    Counters of the I2C transactions of a driver instance
+
+   Description:
+    A transaction is one write or write-read started through the PLIB
+    interface. It ends when the PLIB calls back, without error or with the
+    DRV_BME280_ERROR it reports. Its latency is counted in core clock cycles
+    from the start to the call back. The counters start at zero at
+    initialization and wrap around at 2^32.
+
+   Remarks:
+    transactionCount - (doneCount + nackCount + busErrorCount) transactions
+    are in progress; one that stays there means the bus is stuck.
+
+    refusedCount counts the starts refused because the driver or the PLIB
+    was busy. A refused DRV_BME280_Read returns false and is not retried;
+    a refused transfer of the initialization is started again by the next
+    pass of DRV_BME280_Tasks. A refused start changes nothing in the driver
+    and does not end, or change the latency of, the transaction in
+    progress.
+*/
+
+typedef struct
+{
+    /* Transactions started, and those refused as another was in progress */
+    uint32_t    transactionCount;
+    uint32_t    refusedCount;
+
+    /* Transactions ended, by DRV_BME280_ERROR */
+    uint32_t    doneCount;
+    uint32_t    nackCount;
+    uint32_t    busErrorCount;
+
+    /* Bytes written and read by the transactions started */
+    uint32_t    writeBytes;
+    uint32_t    readBytes;
+
+    /* Least, most and total cycles of the transactions ended. minCycles is
+     * UINT32_MAX until one has ended. */
+    uint32_t    minCycles;
+    uint32_t    maxCycles;
+    uint64_t    totalCycles;
+} DRV_BME280_STATISTICS;
+
 // *****************************************************************************
 /* Function:
     SYS_MODULE_OBJ DRV_BME280_Initialize(
@@ -261,6 +331,12 @@ SYS_MODULE_OBJ DRV_BME280_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS
 
     SYS_STATUS_UNINITIALIZED - Indicates the driver is not initialized.
 
+    SYS_STATUS_BUSY - Indicates the driver is initializing the sensor or
+                      reading a sample.
+
+    SYS_STATUS_ERROR - Indicates the sensor failed to initialize. The
+                       driver takes no more requests.
+
   Example:
     <code>
     SYS_STATUS status;
@@ -381,6 +457,11 @@ void DRV_BME280_Close(const DRV_HANDLE handle);
     the current status of the request OR the requesting client can register a
     callback function with the driver to get notified of the status.
 
+    The callback is called from DRV_BME280_Tasks once the new sample has been
+    compensated. A read that fails on the bus calls it with
+    DRV_BME280_TRANSFER_STATUS_ERROR instead, and the driver is ready for
+    the next read.
+
   Precondition:
     DRV_BME280_Open must have been called to obtain a valid opened device handle.
 
@@ -392,7 +473,9 @@ void DRV_BME280_Close(const DRV_HANDLE handle);
         - if the read request is accepted.
 
     false
-        - if handle is invalid
+        - if handle is invalid, or if the driver is not ready: it is
+          initializing, or a read is in progress or not yet processed, or
+          the PLIB refused the transfer. Nothing changes in the driver.
 
   Example:
     <code>
@@ -472,6 +555,90 @@ bool DRV_BME280_Get_Temperature(const DRV_HANDLE handle, int32_t* temperature);
 bool DRV_BME280_Get_Pressure(const DRV_HANDLE handle, uint32_t* pressure);
 bool DRV_BME280_Get_Humidity(const DRV_HANDLE handle, uint32_t* humidity);
 
+// *****************************************************************************
+/* Function:
+    bool DRV_BME280_Get_PressureQ8(const DRV_HANDLE handle, uint32_t* pressure);
+
+  Summary:
+    Returns the pressure of the last completed read in 1/256 Pa.
+
+  Description:
+    With configParams.pressureMode set to DRV_BME280_PRESSURE_MODE_64BIT the
+    value carries the full resolution of the 64-bit compensation and
+    DRV_BME280_Get_Pressure returns it rounded to 1 Pa. In the default 32-bit
+    mode it is the 1 Pa value scaled by 256.
+
+  Precondition:
+    DRV_BME280_Open must have been called to obtain a valid opened device handle.
+
+  Parameters:
+    handle         - A valid open-instance handle, returned from the driver's
+                      open routine
+    pressure       - Receives the pressure, in 1/256 Pa
+
+  Returns:
+    true
+        - if the pressure is returned.
+
+    false
+        - if handle is invalid
+
+  Example:
+    <code>
+    uint32_t pressure;
+
+    DRV_BME280_Get_PressureQ8(myHandle, &pressure);
+    printf("%.3f hPa\r\n", ((double) pressure) / 25600.0);
+    </code>
+
+  Remarks:
+    None.
+*/
+bool DRV_BME280_Get_PressureQ8(const DRV_HANDLE handle, uint32_t* pressure);
+
+// *****************************************************************************
+/* Function:
+    bool DRV_BME280_Get_Timestamp(const DRV_HANDLE handle, uint64_t* timestamp);
+
+  Summary:
+    Returns the acquisition time of the last completed read.
+
+  Description:
+    This function returns the SYS_TIME 64-bit counter value captured when the
+    I2C transfer of the last sample completed. It belongs to the values
+    returned by DRV_BME280_Get_Temperature, DRV_BME280_Get_Pressure and
+    DRV_BME280_Get_Humidity.
+
+  Precondition:
+    DRV_BME280_Open must have been called to obtain a valid opened device handle.
+
+  Parameters:
+    handle         - A valid open-instance handle, returned from the driver's
+                      open routine
+    timestamp      - Receives the counter value, in SYS_TIME_FrequencyGet units
+
+  Returns:
+    true
+        - if the timestamp is returned.
+
+    false
+        - if handle is invalid
+
+  Example:
+    <code>
+    uint64_t timestamp;
+
+    if (DRV_BME280_Get_Timestamp(myHandle, &timestamp) == true)
+    {
+        printf("sampled %lu ms after boot\r\n", SYS_TIME_CountToMS((uint32_t)timestamp));
+    }
+    </code>
+
+  Remarks:
+    The value is 0 until the first read has completed.
+*/
+bool DRV_BME280_Get_Timestamp(const DRV_HANDLE handle, uint64_t* timestamp);
+
 
 // *****************************************************************************
 /* Function:
@@ -528,6 +695,122 @@ void DRV_BME280_ClientEventHandlerSet(
     const uintptr_t context
 );
 
+// *****************************************************************************
+/* Function:
+    void DRV_BME280_TraceHandlerSet(
+        const SYS_MODULE_INDEX drvIndex,
+        const DRV_BME280_TRACE_HANDLER handler,
+        const uintptr_t context
+    )
+
+  Summary:
+    Registers a handler that receives the raw data read from the sensor.
+
+  Description:
+    Once set, the handler is called with every calibration block read during
+    initialization and every measurement burst, so that the data can be
+    recorded and replayed later through the same parsing and compensation.
+
+  Precondition:
+    DRV_BME280_Initialize must have been called.
+
+  Parameters:
+    drvIndex - Identifier for the instance
+    handler  - Trace handler, or NULL to stop tracing
+    context  - Passed back to the handler unchanged
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_BME280_TraceHandlerSet(DRV_BME280_INSTANCE_0, appTraceHandler, 0);
+    </code>
+
+  Remarks:
+    Set the handler before the first call to DRV_BME280_Tasks to see the
+    calibration blocks.
+*/
+
+void DRV_BME280_TraceHandlerSet(
+    const SYS_MODULE_INDEX drvIndex,
+    const DRV_BME280_TRACE_HANDLER handler,
+    const uintptr_t context
+);
+
+// *****************************************************************************
+/* Function:
+    uint32_t DRV_BME280_CompensationCyclesGet(const SYS_MODULE_INDEX drvIndex)
+
+  Summary:
+    Returns the core clock cycles spent compensating the samples.
+
+  Description:
+    The cycles are counted with the DWT cycle counter from the first sample
+    and wrap around at 2^32. The difference between two calls divided by the
+    samples taken in between gives the cost of the compensation per sample.
+
+  Precondition:
+    DRV_BME280_Initialize must have been called.
+
+  Parameters:
+    drvIndex - Identifier for the instance
+
+  Returns:
+    Cycles spent in the compensation, 0 for an invalid instance.
+
+  Example:
+    <code>
+    uint32_t start = DRV_BME280_CompensationCyclesGet(DRV_BME280_INSTANCE_0);
+    </code>
+
+  Remarks:
+    A debugger may stop or reset the cycle counter.
+*/
+
+uint32_t DRV_BME280_CompensationCyclesGet(const SYS_MODULE_INDEX drvIndex);
+
+// *****************************************************************************
+/* Function:
+    bool DRV_BME280_StatisticsGet(
+        const SYS_MODULE_INDEX drvIndex,
+        DRV_BME280_STATISTICS* stats
+    )
+
+  Summary:
+    Returns the counters of the I2C transactions.
+
+  Description:
+    The counters are copied together, with interrupts disabled, so that they
+    are consistent with each other.
+
+  Precondition:
+    DRV_BME280_Initialize must have been called.
+
+  Parameters:
+    drvIndex - Identifier for the instance
+    stats    - Receives the counters
+
+  Returns:
+    false for an invalid instance.
+
+  Example:
+    <code>
+    DRV_BME280_STATISTICS stats;
+
+    if (DRV_BME280_StatisticsGet(DRV_BME280_INSTANCE_0, &stats) == true)
+    {
+        printf("%lu NACK \r\n", (unsigned long)stats.nackCount);
+    }
+    </code>
+
+  Remarks:
+    The counting costs a few cycles per transaction and is always on. The
+    console command 5 prints the counters.
+*/
+
+bool DRV_BME280_StatisticsGet(const SYS_MODULE_INDEX drvIndex, DRV_BME280_STATISTICS* stats);
+
 void DRV_BME280_Tasks(
     SYS_MODULE_OBJ object
 );
@@ -536,7 +819,7 @@ void DRV_BME280_Tasks(
 }
 #endif
 
-#include "driver/BME280/src/drv_BME280_local.h"
+#include "driver/bme280/src/drv_bme280_local.h"
 
 #endif // #ifndef _DRV_BME280_H
 /*******************************************************************************
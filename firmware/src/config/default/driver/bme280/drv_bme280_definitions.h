@@ -85,10 +85,20 @@ typedef struct
     uint32_t clockSpeed;
 } DRV_BME280_TRANSFER_SETUP;
 
+/* Pressure compensation. The 32-bit algorithm resolves 1 Pa. The 64-bit
+ * algorithm resolves 1/256 Pa at the cost of 64-bit multiplies and a 64-bit
+ * divide per sample. */
+typedef enum
+{
+    DRV_BME280_PRESSURE_MODE_32BIT = 0,
+    DRV_BME280_PRESSURE_MODE_64BIT,
+} DRV_BME280_PRESSURE_MODE;
+
 typedef struct
 {
     uint8_t                         sensorAddr;
     DRV_BME280_TRANSFER_SETUP       transferParams;
+    DRV_BME280_PRESSURE_MODE        pressureMode;
 } DRV_BME280_CONFIG_PARAMS;
 
 typedef void (* DRV_BME280_PLIB_CALLBACK)( uintptr_t );
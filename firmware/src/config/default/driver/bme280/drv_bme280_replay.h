@@ -0,0 +1,212 @@
+/*******************************************************************************
+  DRV_BME280 Trace Replay Interface Definition
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_bme280_replay.h
+
+  Summary:
+    Replays recorded BME280 data through the BME280 driver.
+
+  Description:
+    This module replaces the SERCOM3 I2C PLIB in the BME280 driver's PLIB
+    interface table and answers the driver's reads from recorded data: the
+    calibration blocks and measurement bursts passed to a
+    DRV_BME280_TRACE_HANDLER. The driver parses and compensates the recorded
+    bytes exactly as it did when they were read from the sensor.
+
+    Transactions complete from DRV_BME280_REPLAY_Tasks rather than after
+    their bus time, so a recording is replayed as fast as the rest of the
+    system can consume it.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _DRV_BME280_REPLAY_H
+#define _DRV_BME280_REPLAY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "drv_bme280_definitions.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Largest block read by the driver: the pressure calibration */
+#define DRV_BME280_REPLAY_DATA_SIZE     (18U)
+
+// *****************************************************************************
+/* Replay Record
+
+  Summary:
+    One block of data read from the sensor.
+
+  Description:
+    A record holds what the driver's trace handler was passed: the first
+    register of the block, its raw bytes and the time of the read.
+*/
+
+typedef struct
+{
+    /* Time of the read, in the units of the recording */
+    uint64_t    timestamp;
+
+    /* First register of the block */
+    uint8_t     reg;
+
+    /* Number of valid bytes in data */
+    uint8_t     length;
+
+    uint8_t     data[DRV_BME280_REPLAY_DATA_SIZE];
+} DRV_BME280_REPLAY_RECORD;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Replay Control Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void DRV_BME280_REPLAY_RecordsSet ( const DRV_BME280_REPLAY_RECORD* records,
+                                        size_t nRecords )
+
+  Summary:
+    Sets the recording to replay.
+
+  Description:
+    Calibration reads are answered with the first record of the same
+    register, wherever it is in the recording. Measurement reads are answered
+    with the measurement records in order. Once they have all been served,
+    further measurement reads are not acknowledged.
+
+    Transactions started before the recording is set are held until it is.
+
+  Parameters:
+    records  - Recorded blocks, in the order they were read. The array is not
+               copied.
+    nRecords - Number of records
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+*/
+
+void DRV_BME280_REPLAY_RecordsSet( const DRV_BME280_REPLAY_RECORD* records, size_t nRecords );
+
+/*******************************************************************************
+  Function:
+    bool DRV_BME280_REPLAY_IsComplete ( void )
+
+  Summary:
+    Reports whether every measurement record has been served.
+
+  Parameters:
+    None.
+
+  Returns:
+    true once the last measurement record has been read by the driver.
+
+  Remarks:
+    None.
+*/
+
+bool DRV_BME280_REPLAY_IsComplete( void );
+
+/*******************************************************************************
+  Function:
+    void DRV_BME280_REPLAY_Tasks ( void )
+
+  Summary:
+    Completes the transaction in progress.
+
+  Description:
+    Serves the transaction started by the driver and calls its PLIB callback.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+  Remarks:
+    Must be called from SYS_Tasks, before DRV_BME280_Tasks.
+*/
+
+void DRV_BME280_REPLAY_Tasks( void );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Replay I2C PLIB Routines
+// *****************************************************************************
+// *****************************************************************************
+/* These routines have the signatures of the DRV_BME280_PLIB_INTERFACE
+ * members and are used in place of the SERCOM3 I2C PLIB.
+ */
+
+bool DRV_BME280_REPLAY_I2C_Read( uint16_t address, uint8_t* rdata, uint32_t rlength );
+
+bool DRV_BME280_REPLAY_I2C_Write( uint16_t address, uint8_t* wdata, uint32_t wlength );
+
+bool DRV_BME280_REPLAY_I2C_WriteRead( uint16_t address, uint8_t* wdata, uint32_t wlength, uint8_t* rdata, uint32_t rlength );
+
+DRV_BME280_ERROR DRV_BME280_REPLAY_I2C_ErrorGet( void );
+
+void DRV_BME280_REPLAY_I2C_CallbackRegister( DRV_BME280_PLIB_CALLBACK callback, uintptr_t context );
+
+bool DRV_BME280_REPLAY_I2C_TransferSetup( DRV_BME280_TRANSFER_SETUP* setup, uint32_t srcClkFreq );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif // #ifndef _DRV_BME280_REPLAY_H
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,284 @@
+/*******************************************************************************
+  DRV_BME280 Simulated Sensor Interface Definition
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_bme280_sim.h
+
+  Summary:
+    Simulated BME280 behind a simulated I2C master.
+
+  Description:
+    This model replaces the SERCOM3 I2C PLIB in the BME280 driver's PLIB
+    interface table. It implements the BME280 register map, calibration NVM,
+    soft reset, sleep, forced and normal modes, and the datasheet maximum
+    measurement time for each oversampling setting. Each I2C transaction
+    completes from a SYS_TIME callback after the time it would take on the bus
+    at the configured clock, so the driver sees the same interrupt-driven
+    completion as with the real peripheral.
+
+    The measured temperature, pressure and humidity follow a script of points
+    that are linearly interpolated. Each point is converted to raw ADC values
+    through the calibration data, so the driver's compensation returns the
+    scripted values to within one LSB. NACKs and bus errors can be injected
+    on chosen transactions.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _DRV_BME280_SIM_H
+#define _DRV_BME280_SIM_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "drv_bme280_definitions.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Size of the calibration NVM: 0x88..0xA1 followed by 0xE1..0xE7 */
+#define DRV_BME280_SIM_CALIB_SIZE       (33U)
+
+// *****************************************************************************
+/* Simulated Environment Point
+
+  Summary:
+    One point of the scripted environment.
+
+  Description:
+    Units are those of the driver's compensated outputs: 0.01 degC, Pa and
+    1/1024 %RH. Between two points every quantity changes linearly.
+*/
+
+typedef struct
+{
+    /* Time since the script was started */
+    uint32_t    timeMs;
+
+    int32_t     temperature;
+    uint32_t    pressure;
+    uint32_t    humidity;
+} DRV_BME280_SIM_POINT;
+
+// *****************************************************************************
+/* Simulated Bus Faults
+
+  Summary:
+    Errors that can be injected on the simulated I2C bus.
+*/
+
+typedef enum
+{
+    /* The sensor does not acknowledge its address */
+    DRV_BME280_SIM_FAULT_NACK = 0,
+
+    /* The transaction is aborted with a bus error after the address byte */
+    DRV_BME280_SIM_FAULT_BUS,
+} DRV_BME280_SIM_FAULT;
+
+// *****************************************************************************
+/* Simulation Statistics
+
+  Summary:
+    Counts the simulated bus activity.
+*/
+
+typedef struct
+{
+    /* Transactions started, including failed ones */
+    uint32_t    transactions;
+
+    /* Bytes transferred on the bus, including address bytes */
+    uint32_t    bytes;
+
+    /* Total time the bus was busy, in microseconds */
+    uint32_t    busTimeUs;
+
+    /* Transactions that ended with a NACK or a bus error */
+    uint32_t    nacks;
+    uint32_t    busErrors;
+
+    /* Measurements completed by the sensor */
+    uint32_t    measurements;
+} DRV_BME280_SIM_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void DRV_BME280_SIM_Initialize ( uint16_t address, const uint8_t* calibration )
+
+  Summary:
+    Powers up the simulated sensor.
+
+  Description:
+    Loads the calibration NVM, places the sensor in its power-on state and
+    restarts the environment script. The sensor answers on the given 7-bit
+    address.
+
+  Parameters:
+    address     - 7-bit I2C address of the sensor
+    calibration - DRV_BME280_SIM_CALIB_SIZE bytes of NVM, or NULL for the
+                  built-in set
+
+  Returns:
+    None.
+
+  Remarks:
+    Must be called after SYS_TIME_Initialize and before the first call to
+    DRV_BME280_Tasks.
+*/
+
+void DRV_BME280_SIM_Initialize( uint16_t address, const uint8_t* calibration );
+
+/*******************************************************************************
+  Function:
+    void DRV_BME280_SIM_ScriptSet ( const DRV_BME280_SIM_POINT* points,
+                                    size_t nPoints, bool repeat )
+
+  Summary:
+    Sets the environment seen by the sensor.
+
+  Description:
+    The script starts at the time of the call. Before the first point and
+    after the last the values are held, unless repeat is set, in which case
+    the script restarts after the last point. NULL restores the default
+    environment of 25 degC, 101325 Pa and 50 %RH.
+
+  Parameters:
+    points  - Points in increasing time order. The array is not copied.
+    nPoints - Number of points
+    repeat  - Whether the script loops
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+*/
+
+void DRV_BME280_SIM_ScriptSet( const DRV_BME280_SIM_POINT* points, size_t nPoints, bool repeat );
+
+/*******************************************************************************
+  Function:
+    void DRV_BME280_SIM_FaultSet ( DRV_BME280_SIM_FAULT fault,
+                                   uint32_t skipCount, uint32_t failCount )
+
+  Summary:
+    Injects bus errors.
+
+  Description:
+    After skipCount transactions complete normally, the next failCount
+    transactions fail with the given fault. A failCount of zero stops
+    injection.
+
+  Parameters:
+    fault     - Kind of error
+    skipCount - Transactions to let through first
+    failCount - Transactions to fail
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+*/
+
+void DRV_BME280_SIM_FaultSet( DRV_BME280_SIM_FAULT fault, uint32_t skipCount, uint32_t failCount );
+
+/*******************************************************************************
+  Function:
+    void DRV_BME280_SIM_StatisticsGet ( DRV_BME280_SIM_STATISTICS* stats )
+
+  Summary:
+    Returns the simulated bus counters.
+
+  Parameters:
+    stats - Destination of the counters
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+*/
+
+void DRV_BME280_SIM_StatisticsGet( DRV_BME280_SIM_STATISTICS* stats );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulated I2C PLIB Routines
+// *****************************************************************************
+// *****************************************************************************
+/* These routines have the signatures of the DRV_BME280_PLIB_INTERFACE
+ * members and are used in place of the SERCOM3 I2C PLIB.
+ */
+
+bool DRV_BME280_SIM_I2C_Read( uint16_t address, uint8_t* rdata, uint32_t rlength );
+
+bool DRV_BME280_SIM_I2C_Write( uint16_t address, uint8_t* wdata, uint32_t wlength );
+
+bool DRV_BME280_SIM_I2C_WriteRead( uint16_t address, uint8_t* wdata, uint32_t wlength, uint8_t* rdata, uint32_t rlength );
+
+DRV_BME280_ERROR DRV_BME280_SIM_I2C_ErrorGet( void );
+
+void DRV_BME280_SIM_I2C_CallbackRegister( DRV_BME280_PLIB_CALLBACK callback, uintptr_t context );
+
+bool DRV_BME280_SIM_I2C_TransferSetup( DRV_BME280_TRANSFER_SETUP* setup, uint32_t srcClkFreq );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif // #ifndef _DRV_BME280_SIM_H
+
+/*******************************************************************************
+ End of File
+*/
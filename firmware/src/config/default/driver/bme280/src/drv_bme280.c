@@ -47,6 +47,8 @@
 // *****************************************************************************
 #include "configuration.h"
 #include "driver/bme280/drv_bme280.h"
+#include "system/time/sys_time.h"
+#include "system/int/sys_int.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -101,124 +103,34 @@ static bool _DRV_BME280_ParseData(DRV_BME280_OBJ* dObj, volatile uint8_t* reg_da
     return true;
 }
 
-/* generate a compensated temperature reading  */
-static int32_t _DRV_BME280_Compensate_T(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
+/* count the end of a transaction and its latency */
+static void _DRV_BME280_TransferEnd(DRV_BME280_OBJ* dObj, DRV_BME280_ERROR error)
 {
-    int32_t var1;
-    int32_t var2;
-    int32_t temperature;
-    int32_t temperature_min = -4000;
-    int32_t temperature_max = 8500;
+    DRV_BME280_STATISTICS* stats = &dObj->stats;
+    uint32_t cycles = DWT->CYCCNT - dObj->transferStartCycle;
 
-    var1 = (int32_t)((uncompData->temperature / 8) - ((int32_t)calib_data->dig_T1 * 2));
-    var1 = (var1 * ((int32_t)calib_data->dig_T2)) / 2048;
-    var2 = (int32_t)((uncompData->temperature / 16) - ((int32_t)calib_data->dig_T1));
-    var2 = (((var2 * var2) / 4096) * ((int32_t)calib_data->dig_T3)) / 16384;
-    calib_data->t_fine = var1 + var2;
-    temperature = (calib_data->t_fine * 5 + 128) / 256;
-
-    if (temperature < temperature_min)
+    if (error == DRV_BME280_ERROR_NONE)
     {
-        temperature = temperature_min;
+        stats->doneCount++;
     }
-    else if (temperature > temperature_max)
+    else if (error == DRV_BME280_ERROR_NACK)
     {
-        temperature = temperature_max;
-    }
-
-    return temperature;
-}
-
-/* generate a compensated pressure reading  */
-static uint32_t _DRV_BME280_Compensate_P(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
-{
-    int32_t var1;
-    int32_t var2;
-    int32_t var3;
-    int32_t var4;
-    uint32_t var5;
-    uint32_t pressure;
-    uint32_t pressure_min = 30000;
-    uint32_t pressure_max = 110000;
-
-    var1 = (((int32_t)calib_data->t_fine) / 2) - (int32_t)64000;
-    var2 = (((var1 / 4) * (var1 / 4)) / 2048) * ((int32_t)calib_data->dig_P6);
-    var2 = var2 + ((var1 * ((int32_t)calib_data->dig_P5)) * 2);
-    var2 = (var2 / 4) + (((int32_t)calib_data->dig_P4) * 65536);
-    var3 = (calib_data->dig_P3 * (((var1 / 4) * (var1 / 4)) / 8192)) / 8;
-    var4 = (((int32_t)calib_data->dig_P2) * var1) / 2;
-    var1 = (var3 + var4) / 262144;
-    var1 = (((32768 + var1)) * ((int32_t)calib_data->dig_P1)) / 32768;
-
-    /* avoid exception caused by division by zero */
-    if (var1)
-    {
-        var5 = (uint32_t)((uint32_t)1048576) - uncompData->pressure;
-        pressure = ((uint32_t)(var5 - (uint32_t)(var2 / 4096))) * 3125;
-
-        if (pressure < 0x80000000)
-        {
-            pressure = (pressure << 1) / ((uint32_t)var1);
-        }
-        else
-        {
-            pressure = (pressure / (uint32_t)var1) * 2;
-        }
-
-        var1 = (((int32_t)calib_data->dig_P9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
-        var2 = (((int32_t)(pressure / 4)) * ((int32_t)calib_data->dig_P8)) / 8192;
-        pressure = (uint32_t)((int32_t)pressure + ((var1 + var2 + calib_data->dig_P7) / 16));
-
-        if (pressure < pressure_min)
-        {
-            pressure = pressure_min;
-        }
-        else if (pressure > pressure_max)
-        {
-            pressure = pressure_max;
-        }
+        stats->nackCount++;
     }
     else
     {
-        pressure = pressure_min;
+        stats->busErrorCount++;
     }
 
-    return pressure;
-}
-
-/* generate a compensated humidity reading  */
-static uint32_t _DRV_BME280_Compensate_H(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
-{
-    int32_t var1;
-    int32_t var2;
-    int32_t var3;
-    int32_t var4;
-    int32_t var5;
-    uint32_t humidity;
-    uint32_t humidity_max = 102400;
-
-    var1 = calib_data->t_fine - ((int32_t)76800);
-    var2 = (int32_t)(uncompData->humidity * 16384);
-    var3 = (int32_t)(((int32_t)calib_data->dig_H4) * 1048576);
-    var4 = ((int32_t)calib_data->dig_H5) * var1;
-    var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
-    var2 = (var1 * ((int32_t)calib_data->dig_H6)) / 1024;
-    var3 = (var1 * ((int32_t)calib_data->dig_H3)) / 2048;
-    var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
-    var2 = ((var4 * ((int32_t)calib_data->dig_H2)) + 8192) / 16384;
-    var3 = var5 * var2;
-    var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
-    var5 = var3 - ((var4 * ((int32_t)calib_data->dig_H1)) / 16);
-    var5 = (var5 < 0 ? 0 : var5);
-    var5 = (var5 > 419430400 ? 419430400 : var5);
-    humidity = (uint32_t)(var5 / 4096);
-
-    if (humidity > humidity_max)
-    {
-        humidity = humidity_max;
-    }
-
-    return humidity;
+    if (cycles < stats->minCycles)
+    {
+        stats->minCycles = cycles;
+    }
+    if (cycles > stats->maxCycles)
+    {
+        stats->maxCycles = cycles;
+    }
+    stats->totalCycles += cycles;
 }
 
 /* This function will be called by I2C PLIB when transfer is completed */
@@ -235,12 +147,25 @@ static void _DRV_BME280_PLIBEventHandler(uintptr_t context)
     
     clientObj = dObj->activeClient;
     error = dObj->plibInterface->errorGet(); 
+    _DRV_BME280_TransferEnd(dObj, error);
     
     if (error != DRV_BME280_ERROR_NONE)
     {
         dObj->status = SYS_STATUS_READY;
         dObj->activeClient = NULL;
-        dObj->taskState = DRV_BME280_TASK_STATE_ERROR;
+
+        /* a failed sample read leaves the sensor as it was: the task tells
+         * the client and the driver takes the next read. A failure while
+         * initializing stops the driver. */
+        if (clientObj != NULL)
+        {
+            dObj->readClient = clientObj;
+            dObj->taskState = DRV_BME280_TASK_STATE_READ_ERROR;
+        }
+        else
+        {
+            dObj->taskState = DRV_BME280_TASK_STATE_ERROR;
+        }
         return;
     }
     
@@ -263,13 +188,14 @@ static void _DRV_BME280_PLIBEventHandler(uintptr_t context)
         
         dObj->status = SYS_STATUS_READY;        
         dObj->activeClient = NULL;
-    }
-    
-    if (clientObj != NULL) 
-    {
-        if (clientObj->callback != NULL)
+
+        if (clientObj != NULL)
         {
-            clientObj->callback(DRV_BME280_TRANSFER_STATUS_COMPLETED, clientObj->context);
+            /* time stamp the sample at acquisition. The client is notified
+             * from the task once the data has been compensated, so that it
+             * never reads the previous sample's values */
+            dObj->sampleTimestamp = SYS_TIME_Counter64Get();
+            dObj->readClient = clientObj;
         }
     }
 }
@@ -307,9 +233,77 @@ static int32_t _DRV_BME280_FreeClientGet(DRV_BME280_OBJ* dObj)
     return -1;
 }
 
+/* pass the raw data of the last read to the trace handler */
+static void _DRV_BME280_Trace(DRV_BME280_OBJ* dObj, uint64_t timestamp)
+{
+    if (dObj->traceHandler != NULL)
+    {
+        dObj->traceHandler(dObj->writeBuffer[0], (const uint8_t*) dObj->readBuffer, dObj->readLength,
+                           timestamp, dObj->traceContext);
+    }
+}
+
+/* write writeLength bytes of the write buffer, then read readLength bytes
+ * unless it is 0, and count the transaction. The driver is set up for the
+ * PLIB callback only once the PLIB has accepted the start, before its
+ * interrupt can end the transaction; a refused start leaves the driver, and
+ * the transaction in progress if any, as they were. */
+static bool _DRV_BME280_TransferStart(
+    DRV_BME280_OBJ* dObj,
+    DRV_BME280_CLIENT_OBJ* clientObj,
+    DRV_BME280_TASK_STATES taskState,
+    DRV_BME280_TASK_STATES nextTaskState,
+    uint8_t writeLength,
+    uint8_t readLength
+)
+{
+    uint32_t startCycle = DWT->CYCCNT;
+    bool interruptState;
+    bool isStarted;
+
+    interruptState = SYS_INT_Disable();
+
+    if (readLength == 0U)
+    {
+        isStarted = dObj->plibInterface->write(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, writeLength);
+    }
+    else
+    {
+        isStarted = dObj->plibInterface->writeRead(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, writeLength,
+                                                   (void*) dObj->readBuffer, readLength);
+    }
+
+    if (isStarted == true)
+    {
+        /* pass this event to the peripheral callback when the transfer is
+         * completed, and mark the driver as BUSY until then */
+        dObj->activeClient = clientObj;
+        dObj->event = (readLength == 0U) ? DRV_BME280_EVENT_WRITE_DONE : DRV_BME280_EVENT_READ_DONE;
+        dObj->status = SYS_STATUS_BUSY;
+        dObj->taskState = taskState;
+        dObj->nextTaskState = nextTaskState;
+        dObj->readLength = readLength;
+
+        dObj->transferStartCycle = startCycle;
+        dObj->stats.transactionCount++;
+        dObj->stats.writeBytes += writeLength;
+        dObj->stats.readBytes += readLength;
+    }
+    else
+    {
+        dObj->stats.refusedCount++;
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return isStarted;
+}
+
 /* perform a writeRead of the specified register expecting length bytes back */
-/* Data will be returned via the device driver callback */
-static void _DRV_BME280_ReadReg(DRV_BME280_OBJ* dObj, uint8_t reg, uint8_t length)
+/* Data will be returned via the device driver callback, which then advances
+ * the task to nextTaskState. A refused read is started again by the next
+ * pass of the task. */
+static void _DRV_BME280_ReadReg(DRV_BME280_OBJ* dObj, uint8_t reg, uint8_t length, DRV_BME280_TASK_STATES nextTaskState)
 {
     if (dObj == NULL)
     {
@@ -317,15 +311,8 @@ static void _DRV_BME280_ReadReg(DRV_BME280_OBJ* dObj, uint8_t reg, uint8_t lengt
     }
     
     /* this function is used by the driver itself so there is no active client */
-    dObj->activeClient = NULL;
-    /* pass this event to the peripheral callback when the read is completed */
-    dObj->event = DRV_BME280_EVENT_READ_DONE;
-    /* mark the driver as BUSY */
-    dObj->status = SYS_STATUS_BUSY;
-            
-    /* send the request */
     dObj->writeBuffer[0] = reg;
-    dObj->plibInterface->writeRead(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, 1, (void*) dObj->readBuffer, length);      
+    (void) _DRV_BME280_TransferStart(dObj, NULL, dObj->taskState, nextTaskState, 1, length);
 }
 
 // *****************************************************************************
@@ -341,6 +328,7 @@ SYS_MODULE_OBJ DRV_BME280_Initialize(
 {
     DRV_BME280_OBJ* dObj = NULL;
     DRV_BME280_INIT *BME280Init = (DRV_BME280_INIT *)init;
+    const DRV_BME280_STATISTICS statsReset = { 0 };
 
     /* Validate the request */
     if(drvIndex >= DRV_BME280_INSTANCES_NUMBER)
@@ -367,9 +355,19 @@ SYS_MODULE_OBJ DRV_BME280_Initialize(
     dObj->configParams = BME280Init->configParams;
     dObj->clientObjPool = (DRV_BME280_CLIENT_OBJ*) BME280Init->clientObjPool;
     dObj->nClientsMax = BME280Init->maxClients;
+    dObj->readClient = NULL;
+    dObj->sampleTimestamp = 0;
+    dObj->traceHandler = NULL;
+    dObj->compensationCycles = 0;
+    dObj->stats = statsReset;
+    dObj->stats.minCycles = UINT32_MAX;
     dObj->plibInterface->callbackRegister(_DRV_BME280_PLIBEventHandler, (uintptr_t) dObj);
     dObj->taskState = DRV_BME280_TASK_STATE_INIT;
 
+    /* count core clock cycles for DRV_BME280_CompensationCyclesGet */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     /* set status */
     dObj->status = SYS_STATUS_READY;
     
@@ -389,6 +387,10 @@ SYS_STATUS DRV_BME280_Status( const SYS_MODULE_INDEX drvIndex )
     /* if the driver is still initializing or in the middle of a read 
      *  return a BUSY status to the application code rather than the true status */
     dObj = &gDrvBME280Obj[drvIndex];
+    if (dObj->taskState == DRV_BME280_TASK_STATE_ERROR)
+    {
+        return SYS_STATUS_ERROR;
+    }
     if (dObj->taskState != DRV_BME280_TASK_STATE_IDLE)
     {
         return SYS_STATUS_BUSY;
@@ -505,7 +507,28 @@ bool DRV_BME280_Get_Pressure(const DRV_HANDLE handle, uint32_t* pressure)
     
     dObj = &gDrvBME280Obj[clientObj->drvIndex];
     *pressure = dObj->compData.pressure;
-    return false;
+    return true;
+}
+
+bool DRV_BME280_Get_PressureQ8(const DRV_HANDLE handle, uint32_t* pressure)
+{
+    DRV_BME280_OBJ* dObj;
+    DRV_BME280_CLIENT_OBJ* clientObj = NULL;
+   
+    if (handle == DRV_HANDLE_INVALID)
+    {
+        return false;
+    }
+    
+    clientObj = _DRV_BME280_ClientObjGet(handle);
+    if ((clientObj == NULL) || (clientObj->drvIndex >= DRV_BME280_INSTANCES_NUMBER))
+    {
+        return false;
+    }
+    
+    dObj = &gDrvBME280Obj[clientObj->drvIndex];
+    *pressure = dObj->compData.pressureQ8;
+    return true;
 }
 
 bool DRV_BME280_Get_Humidity(const DRV_HANDLE handle, uint32_t* humidity)
@@ -526,7 +549,34 @@ bool DRV_BME280_Get_Humidity(const DRV_HANDLE handle, uint32_t* humidity)
     
     dObj = &gDrvBME280Obj[clientObj->drvIndex];
     *humidity = dObj->compData.humidity;
-    return false;
+    return true;
+}
+
+bool DRV_BME280_Get_Timestamp(const DRV_HANDLE handle, uint64_t* timestamp)
+{
+    DRV_BME280_OBJ* dObj;
+    DRV_BME280_CLIENT_OBJ* clientObj = NULL;
+    bool interruptState;
+
+    if (handle == DRV_HANDLE_INVALID)
+    {
+        return false;
+    }
+
+    clientObj = _DRV_BME280_ClientObjGet(handle);
+    if ((clientObj == NULL) || (clientObj->drvIndex >= DRV_BME280_INSTANCES_NUMBER))
+    {
+        return false;
+    }
+
+    dObj = &gDrvBME280Obj[clientObj->drvIndex];
+
+    /* the 64-bit value is written from the I2C interrupt */
+    interruptState = SYS_INT_Disable();
+    *timestamp = dObj->sampleTimestamp;
+    SYS_INT_Restore(interruptState);
+
+    return true;
 }
 
 /* request an asynchronous read of the BME280 sensor */
@@ -547,23 +597,65 @@ bool DRV_BME280_Read(const DRV_HANDLE handle)
     }
     
     dObj = &gDrvBME280Obj[clientObj->drvIndex];
-    dObj->status = SYS_STATUS_BUSY;
-    dObj->activeClient = clientObj;
-    dObj->taskState = DRV_BME280_TASK_STATE_READ;
-    dObj->nextTaskState = DRV_BME280_TASK_STATE_PROCESS_READ;
-    dObj->event = DRV_BME280_EVENT_READ_DONE;
+
+    /* the buffers belong to the initialization or the read in progress
+     * until it ends */
+    if (DRV_BME280_Status(clientObj->drvIndex) != SYS_STATUS_READY)
+    {
+        dObj->stats.refusedCount++;
+        return false;
+    }
 
     /* send the request */
     dObj->writeBuffer[0] = DRV_BME280_REG_DATA_ADDR;
-    dObj->plibInterface->writeRead(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, 1, (void*) dObj->readBuffer, DRV_BME280_REG_DATA_LEN);   
-    
-    return true;    
+    return _DRV_BME280_TransferStart(dObj, clientObj, DRV_BME280_TASK_STATE_READ,
+                                     DRV_BME280_TASK_STATE_PROCESS_READ, 1, DRV_BME280_REG_DATA_LEN);
+}
+
+void DRV_BME280_TraceHandlerSet(
+    const SYS_MODULE_INDEX drvIndex,
+    const DRV_BME280_TRACE_HANDLER handler,
+    const uintptr_t context
+)
+{
+    if (drvIndex < DRV_BME280_INSTANCES_NUMBER)
+    {
+        gDrvBME280Obj[drvIndex].traceContext = context;
+        gDrvBME280Obj[drvIndex].traceHandler = handler;
+    }
+}
+
+uint32_t DRV_BME280_CompensationCyclesGet(const SYS_MODULE_INDEX drvIndex)
+{
+    if (drvIndex >= DRV_BME280_INSTANCES_NUMBER)
+    {
+        return 0;
+    }
+
+    return gDrvBME280Obj[drvIndex].compensationCycles;
+}
+
+bool DRV_BME280_StatisticsGet(const SYS_MODULE_INDEX drvIndex, DRV_BME280_STATISTICS* stats)
+{
+    bool interruptState;
+
+    if ((drvIndex >= DRV_BME280_INSTANCES_NUMBER) || (stats == NULL))
+    {
+        return false;
+    }
+
+    interruptState = SYS_INT_Disable();
+    *stats = gDrvBME280Obj[drvIndex].stats;
+    SYS_INT_Restore(interruptState);
+
+    return true;
 }
 
 void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
 {
     DRV_BME280_OBJ* dObj = NULL;
     int16_t msb, lsb;
+    uint32_t startCycle;
     
     if ((object == SYS_MODULE_OBJ_INVALID) ||
         (object >= DRV_BME280_INSTANCES_NUMBER))
@@ -584,24 +676,19 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
         case DRV_BME280_TASK_STATE_INIT:
             /* perform a device reset */    
             /* after the reset we will automatically advance to the next state */
-            dObj->taskState = DRV_BME280_TASK_STATE_READ_ID;
-            dObj->activeClient = NULL;
-            dObj->event = DRV_BME280_EVENT_WRITE_DONE;
-            dObj->status = SYS_STATUS_BUSY;
-            
             /* configure the i2c interface */
             dObj->plibInterface->transferSetup(&dObj->configParams.transferParams, 0);
             
             /* send the request */
             dObj->writeBuffer[0] = DRV_BME280_REG_RESET;
             dObj->writeBuffer[1] = DRV_BME280_SOFT_RESET;
-            dObj->plibInterface->write(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, 2);
+            (void) _DRV_BME280_TransferStart(dObj, NULL, DRV_BME280_TASK_STATE_READ_ID,
+                                             DRV_BME280_TASK_STATE_ERROR, 2, 0);
             break;
         
         case DRV_BME280_TASK_STATE_READ_ID:
             /* read the device ID */        
-            _DRV_BME280_ReadReg(dObj, DRV_BME280_CHIP_ID_ADDR, 1);
-            dObj->nextTaskState = DRV_BME280_TASK_STATE_PROCESS_READ_ID;
+            _DRV_BME280_ReadReg(dObj, DRV_BME280_CHIP_ID_ADDR, 1, DRV_BME280_TASK_STATE_PROCESS_READ_ID);
             break;
             
         case DRV_BME280_TASK_STATE_PROCESS_READ_ID:
@@ -618,11 +705,11 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
         case DRV_BME280_TASK_STATE_READ_CALIBT:
             /* read the Temperature calibration data into the readBuffer */
             /* state will only be advanced once read has completed and cal data stored */
-            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_TEMP_DIG_T1_LSB_REG, 6);        
-            dObj->nextTaskState = DRV_BME280_TASK_STATE_PROCESS_READ_CALIBT;
+            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_TEMP_DIG_T1_LSB_REG, 6, DRV_BME280_TASK_STATE_PROCESS_READ_CALIBT);
             break;
 
         case DRV_BME280_TASK_STATE_PROCESS_READ_CALIBT:
+            _DRV_BME280_Trace(dObj, SYS_TIME_Counter64Get());
             /* record the temperature calibration data */
             dObj->calibData.dig_T1 = DRV_BME280_CONCAT_BYTES(dObj->readBuffer[1], dObj->readBuffer[0]);
             dObj->calibData.dig_T2 = (int16_t) DRV_BME280_CONCAT_BYTES(dObj->readBuffer[3], dObj->readBuffer[2]);
@@ -634,11 +721,11 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
         case DRV_BME280_TASK_STATE_READ_CALIBP:
             /* read the Pressure calibration data into the readBuffer */
             /* state will only be advanced once read has completed and cal data stored */ 
-            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_PRESS_DIG_P1_LSB_REG, 18);   
-            dObj->nextTaskState = DRV_BME280_TASK_STATE_PROCESS_READ_CALIBP;
+            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_PRESS_DIG_P1_LSB_REG, 18, DRV_BME280_TASK_STATE_PROCESS_READ_CALIBP);
             break;
             
         case DRV_BME280_TASK_STATE_PROCESS_READ_CALIBP:
+            _DRV_BME280_Trace(dObj, SYS_TIME_Counter64Get());
             /* record pressure calibration data */
             dObj->calibData.dig_P1 = DRV_BME280_CONCAT_BYTES(dObj->readBuffer[1], dObj->readBuffer[0]);
             dObj->calibData.dig_P2 = (int16_t) DRV_BME280_CONCAT_BYTES(dObj->readBuffer[3], dObj->readBuffer[2]);
@@ -657,11 +744,11 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
             /* read the Humidity calibration data into the readBuffer */
             /* performed in 2 steps because the data is not contiguous */
             /* state will only be advanced once read has completed and cal data stored */
-            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_HUM_DIG_H1_REG, 1); 
-            dObj->nextTaskState = DRV_BME280_TASK_STATE_PROCESS_READ_CALIBH1;
+            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_HUM_DIG_H1_REG, 1, DRV_BME280_TASK_STATE_PROCESS_READ_CALIBH1);
             break;
             
         case DRV_BME280_TASK_STATE_PROCESS_READ_CALIBH1:
+            _DRV_BME280_Trace(dObj, SYS_TIME_Counter64Get());
             /* record humidity calibration data */
             dObj->calibData.dig_H1 = dObj->readBuffer[0];
             /* advance the initialisation to the next state */
@@ -671,11 +758,11 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
         case DRV_BME280_TASK_STATE_READ_CALIBH2:
             /* read the Humidity calibration data into the readBuffer */
             /* state will only be advanced once read has completed and cal data stored */
-            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_HUM_DIG_H2_LSB_REG, 7);  
-            dObj->nextTaskState = DRV_BME280_TASK_STATE_PROCESS_READ_CALIBH2;
+            _DRV_BME280_ReadReg(dObj, DRV_BME280_CALIB_HUM_DIG_H2_LSB_REG, 7, DRV_BME280_TASK_STATE_PROCESS_READ_CALIBH2);
             break;
             
         case DRV_BME280_TASK_STATE_PROCESS_READ_CALIBH2:
+            _DRV_BME280_Trace(dObj, SYS_TIME_Counter64Get());
             dObj->calibData.dig_H2 = (int16_t) dObj->readBuffer[1] << 8;
             dObj->calibData.dig_H2 |= dObj->readBuffer[0];
             dObj->calibData.dig_H3 = dObj->readBuffer[2];
@@ -695,29 +782,21 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
         case DRV_BME280_TASK_STATE_SET_OVERSAMPLING1:
             /*set the power mode to normal sampling */
             /* this must occur before power mode set */
-            dObj->taskState = DRV_BME280_TASK_STATE_SET_POWERMODE;    
-            dObj->activeClient = NULL;
-            dObj->event = DRV_BME280_EVENT_WRITE_DONE;
-            dObj->status = SYS_STATUS_BUSY;
-            
             /* send the request */
             dObj->writeBuffer[0] = DRV_BME280_REG_CTRL_HUMIDITY;
             dObj->writeBuffer[1] = DRV_BME280_MODE_SAMPLING_H;
-            dObj->plibInterface->write(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, 2);
+            (void) _DRV_BME280_TransferStart(dObj, NULL, DRV_BME280_TASK_STATE_SET_POWERMODE,
+                                             DRV_BME280_TASK_STATE_ERROR, 2, 0);
             break;
 
         case DRV_BME280_TASK_STATE_SET_POWERMODE:
             /*set the power mode to normal sampling with x1 temp and pressure sampling*/
-            dObj->taskState = DRV_BME280_TASK_STATE_IDLE;    
-            dObj->activeClient = NULL;
-            dObj->event = DRV_BME280_EVENT_WRITE_DONE;
-            dObj->status = SYS_STATUS_BUSY;
-            
             /* send the request */
             dObj->writeBuffer[0] = DRV_BME280_REG_CTRL_MEAS;
             /* enable normal sampling, 1x pressure, 1x temperature*/
             dObj->writeBuffer[1] = DRV_BME280_MODE_SAMPLING_T | DRV_BME280_MODE_SAMPLING_P |DRV_BME280_MODE_NORMAL;
-            dObj->plibInterface->write(dObj->configParams.sensorAddr, (void*) dObj->writeBuffer, 2);
+            (void) _DRV_BME280_TransferStart(dObj, NULL, DRV_BME280_TASK_STATE_IDLE,
+                                             DRV_BME280_TASK_STATE_ERROR, 2, 0);
             break;
             
         case DRV_BME280_TASK_STATE_IDLE:
@@ -730,16 +809,45 @@ void DRV_BME280_Tasks(SYS_MODULE_OBJ object)
             break;       
             
         case DRV_BME280_TASK_STATE_PROCESS_READ:
+                _DRV_BME280_Trace(dObj, dObj->sampleTimestamp);
+
                 /* parse the read data from the sensor */
                 _DRV_BME280_ParseData(dObj, dObj->readBuffer);
                 
                 /* compensate the data */
+                startCycle = DWT->CYCCNT;
                 dObj->compData.temperature = _DRV_BME280_Compensate_T(&dObj->uncompData, &dObj->calibData);
-                dObj->compData.pressure = _DRV_BME280_Compensate_P(&dObj->uncompData, &dObj->calibData);
+                if (dObj->configParams.pressureMode == DRV_BME280_PRESSURE_MODE_64BIT)
+                {
+                    dObj->compData.pressureQ8 = _DRV_BME280_Compensate_P64(&dObj->uncompData, &dObj->calibData);
+                    dObj->compData.pressure = (dObj->compData.pressureQ8 + 128U) / 256U;
+                }
+                else
+                {
+                    dObj->compData.pressure = _DRV_BME280_Compensate_P(&dObj->uncompData, &dObj->calibData);
+                    dObj->compData.pressureQ8 = dObj->compData.pressure * 256U;
+                }
                 dObj->compData.humidity = _DRV_BME280_Compensate_H(&dObj->uncompData, &dObj->calibData);
+                dObj->compensationCycles += DWT->CYCCNT - startCycle;
                 dObj->taskState = DRV_BME280_TASK_STATE_IDLE;
+
+                if ((dObj->readClient != NULL) && (dObj->readClient->callback != NULL))
+                {
+                    dObj->readClient->callback(DRV_BME280_TRANSFER_STATUS_COMPLETED, dObj->readClient->context);
+                }
+                dObj->readClient = NULL;
             break;
             
+        case DRV_BME280_TASK_STATE_READ_ERROR:
+            dObj->taskState = DRV_BME280_TASK_STATE_IDLE;
+
+            if ((dObj->readClient != NULL) && (dObj->readClient->callback != NULL))
+            {
+                dObj->readClient->callback(DRV_BME280_TRANSFER_STATUS_ERROR, dObj->readClient->context);
+            }
+            dObj->readClient = NULL;
+            break;
+
         case DRV_BME280_TASK_STATE_ERROR:
             break;
     }
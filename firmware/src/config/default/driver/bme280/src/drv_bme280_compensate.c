@@ -0,0 +1,232 @@
+/*******************************************************************************
+  DRV_BME280 Compensation Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_bme280_compensate.c
+
+  Summary:
+    Converts the raw BME280 readings to temperature, pressure and humidity.
+
+  Description:
+    These are the integer compensation formulas of the BME280 datasheet. They
+    only depend on their arguments, so the host build tests and benchmarks
+    them on their own.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2018 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Include Files
+// *****************************************************************************
+// *****************************************************************************
+#include "configuration.h"
+#include "driver/bme280/drv_bme280.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: DRV_BME280 Compensation Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* generate a compensated temperature reading  */
+int32_t RAMFUNC _DRV_BME280_Compensate_T(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
+{
+    int32_t var1;
+    int32_t var2;
+    int32_t temperature;
+    int32_t temperature_min = -4000;
+    int32_t temperature_max = 8500;
+
+    var1 = (int32_t)((uncompData->temperature / 8) - ((int32_t)calib_data->dig_T1 * 2));
+    var1 = (var1 * ((int32_t)calib_data->dig_T2)) / 2048;
+    var2 = (int32_t)((uncompData->temperature / 16) - ((int32_t)calib_data->dig_T1));
+    var2 = (((var2 * var2) / 4096) * ((int32_t)calib_data->dig_T3)) / 16384;
+    calib_data->t_fine = var1 + var2;
+    temperature = (calib_data->t_fine * 5 + 128) / 256;
+
+    if (temperature < temperature_min)
+    {
+        temperature = temperature_min;
+    }
+    else if (temperature > temperature_max)
+    {
+        temperature = temperature_max;
+    }
+
+    return temperature;
+}
+
+/* generate a compensated pressure reading  */
+uint32_t RAMFUNC _DRV_BME280_Compensate_P(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
+{
+    int32_t var1;
+    int32_t var2;
+    int32_t var3;
+    int32_t var4;
+    uint32_t var5;
+    uint32_t pressure;
+    uint32_t pressure_min = 30000;
+    uint32_t pressure_max = 110000;
+
+    var1 = (((int32_t)calib_data->t_fine) / 2) - (int32_t)64000;
+    var2 = (((var1 / 4) * (var1 / 4)) / 2048) * ((int32_t)calib_data->dig_P6);
+    var2 = var2 + ((var1 * ((int32_t)calib_data->dig_P5)) * 2);
+    var2 = (var2 / 4) + (((int32_t)calib_data->dig_P4) * 65536);
+    var3 = (calib_data->dig_P3 * (((var1 / 4) * (var1 / 4)) / 8192)) / 8;
+    var4 = (((int32_t)calib_data->dig_P2) * var1) / 2;
+    var1 = (var3 + var4) / 262144;
+    var1 = (((32768 + var1)) * ((int32_t)calib_data->dig_P1)) / 32768;
+    var5 = (uint32_t)((uint32_t)1048576) - uncompData->pressure;
+
+    /* avoid exception caused by division by zero, and the difference below
+     * wrapping around for readings under the range of the sensor, which
+     * would clamp them to the maximum */
+    if ((var1 != 0) && ((int32_t)var5 > (var2 / 4096)))
+    {
+        pressure = ((uint32_t)(var5 - (uint32_t)(var2 / 4096))) * 3125;
+
+        if (pressure < 0x80000000)
+        {
+            pressure = (pressure << 1) / ((uint32_t)var1);
+        }
+        else
+        {
+            pressure = (pressure / (uint32_t)var1) * 2;
+        }
+
+        var1 = (((int32_t)calib_data->dig_P9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
+        var2 = (((int32_t)(pressure / 4)) * ((int32_t)calib_data->dig_P8)) / 8192;
+        pressure = (uint32_t)((int32_t)pressure + ((var1 + var2 + calib_data->dig_P7) / 16));
+
+        if (pressure < pressure_min)
+        {
+            pressure = pressure_min;
+        }
+        else if (pressure > pressure_max)
+        {
+            pressure = pressure_max;
+        }
+    }
+    else
+    {
+        pressure = pressure_min;
+    }
+
+    return pressure;
+}
+
+/* generate a compensated pressure reading in 1/256 Pa with the 64-bit
+ * algorithm. The limits are those of the 32-bit algorithm. */
+uint32_t RAMFUNC _DRV_BME280_Compensate_P64(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
+{
+    int64_t var1;
+    int64_t var2;
+    int64_t var3;
+    int64_t var4;
+    uint32_t pressure;
+    uint32_t pressure_min = 30000U * 256U;
+    uint32_t pressure_max = 110000U * 256U;
+
+    var1 = ((int64_t)calib_data->t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)calib_data->dig_P6;
+    var2 = var2 + ((var1 * (int64_t)calib_data->dig_P5) * 131072);
+    var2 = var2 + (((int64_t)calib_data->dig_P4) * 34359738368LL);
+    var1 = ((var1 * var1 * (int64_t)calib_data->dig_P3) / 256) + ((var1 * ((int64_t)calib_data->dig_P2) * 4096));
+    var3 = ((int64_t)1) * 140737488355328LL;
+    var1 = (var3 + var1) * ((int64_t)calib_data->dig_P1) / 8589934592LL;
+
+    /* avoid exception caused by division by zero */
+    if (var1 != 0)
+    {
+        var4 = 1048576 - (int64_t)uncompData->pressure;
+        var4 = (((var4 * 2147483648LL) - var2) * 3125) / var1;
+        var1 = (((int64_t)calib_data->dig_P9) * (var4 / 8192) * (var4 / 8192)) / 33554432;
+        var2 = (((int64_t)calib_data->dig_P8) * var4) / 524288;
+        var4 = ((var4 + var1 + var2) / 256) + (((int64_t)calib_data->dig_P7) * 16);
+
+        if (var4 < (int64_t)pressure_min)
+        {
+            pressure = pressure_min;
+        }
+        else if (var4 > (int64_t)pressure_max)
+        {
+            pressure = pressure_max;
+        }
+        else
+        {
+            pressure = (uint32_t)var4;
+        }
+    }
+    else
+    {
+        pressure = pressure_min;
+    }
+
+    return pressure;
+}
+
+/* generate a compensated humidity reading  */
+uint32_t RAMFUNC _DRV_BME280_Compensate_H(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data)
+{
+    int32_t var1;
+    int32_t var2;
+    int32_t var3;
+    int32_t var4;
+    int32_t var5;
+    uint32_t humidity;
+    uint32_t humidity_max = 102400;
+
+    var1 = calib_data->t_fine - ((int32_t)76800);
+    var2 = (int32_t)(uncompData->humidity * 16384);
+    var3 = (int32_t)(((int32_t)calib_data->dig_H4) * 1048576);
+    var4 = ((int32_t)calib_data->dig_H5) * var1;
+    var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
+    var2 = (var1 * ((int32_t)calib_data->dig_H6)) / 1024;
+    var3 = (var1 * ((int32_t)calib_data->dig_H3)) / 2048;
+    var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
+    var2 = ((var4 * ((int32_t)calib_data->dig_H2)) + 8192) / 16384;
+    var3 = var5 * var2;
+    var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
+    var5 = var3 - ((var4 * ((int32_t)calib_data->dig_H1)) / 16);
+    var5 = (var5 < 0 ? 0 : var5);
+    var5 = (var5 > 419430400 ? 419430400 : var5);
+    humidity = (uint32_t)(var5 / 4096);
+
+    if (humidity > humidity_max)
+    {
+        humidity = humidity_max;
+    }
+
+    return humidity;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -183,6 +183,9 @@ typedef struct
     uint32_t            pressure;
     int32_t             temperature;
     uint32_t            humidity;
+
+    /* pressure in 1/256 Pa */
+    uint32_t            pressureQ8;
 } DRV_BME280_COMP_DATA;
 
 /* Device states */
@@ -204,6 +207,7 @@ typedef enum
     DRV_BME280_TASK_STATE_IDLE,
     DRV_BME280_TASK_STATE_READ,
     DRV_BME280_TASK_STATE_PROCESS_READ,            
+    DRV_BME280_TASK_STATE_READ_ERROR,
     DRV_BME280_TASK_STATE_ERROR         
 } DRV_BME280_TASK_STATES;
 
@@ -293,8 +297,55 @@ typedef struct
     
     /* compensated data */
     DRV_BME280_COMP_DATA                compData;
+
+    /* SYS_TIME counter value when the I2C read of the last sample completed */
+    volatile uint64_t                   sampleTimestamp;
+
+    /* client to notify once the last sample has been compensated */
+    DRV_BME280_CLIENT_OBJ*              readClient;
+
+    /* number of bytes requested by the last read */
+    uint8_t                             readLength;
+
+    /* raw data trace handler and its context */
+    DRV_BME280_TRACE_HANDLER            traceHandler;
+    uintptr_t                           traceContext;
+
+    /* core clock cycles spent in the compensation of all samples */
+    uint32_t                            compensationCycles;
+
+    /* I2C transaction counters, and the cycle counter at the start of the
+     * last transaction */
+    DRV_BME280_STATISTICS               stats;
+    uint32_t                            transferStartCycle;
     
 } DRV_BME280_OBJ;
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+    extern "C" {
+#endif
+// DOM-IGNORE-END
+
+/* Compensation of drv_bme280_compensate.c. The temperature, in 0.01 degC,
+ * sets calib_data->t_fine, which the pressure and humidity use. The
+ * pressure is in Pa, or 1/256 Pa for the 64-bit algorithm, and the humidity
+ * in 1/1024 %RH. */
+int32_t RAMFUNC _DRV_BME280_Compensate_T(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data);
+uint32_t RAMFUNC _DRV_BME280_Compensate_P(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data);
+uint32_t RAMFUNC _DRV_BME280_Compensate_P64(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data);
+uint32_t RAMFUNC _DRV_BME280_Compensate_H(DRV_BME280_UNCOMP_DATA* uncompData, DRV_BME280_COMPENSATION_DATA* calib_data);
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+// DOM-IGNORE-END
 
 #endif //#ifndef _DRV_BME280C_LOCAL_H
@@ -0,0 +1,286 @@
+/*******************************************************************************
+  DRV_BME280 Trace Replay Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_bme280_replay.c
+
+  Summary:
+    Replays recorded BME280 data through the BME280 driver.
+
+  Description:
+    A transaction started by the driver is held until DRV_BME280_REPLAY_Tasks
+    runs, which answers it from the recording and calls the driver's PLIB
+    callback. The driver sets up its next state after starting a transaction,
+    so completion must never happen from within the PLIB call.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Include Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "configuration.h"
+#include "driver/bme280/drv_bme280.h"
+#include "driver/bme280/drv_bme280_replay.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    /* Recording */
+    const DRV_BME280_REPLAY_RECORD* records;
+    size_t                          nRecords;
+
+    /* Index of the next measurement record */
+    size_t                          nextData;
+
+    /* Bus */
+    DRV_BME280_PLIB_CALLBACK        callback;
+    uintptr_t                       context;
+    DRV_BME280_ERROR                error;
+
+    /* Transaction waiting for DRV_BME280_REPLAY_Tasks */
+    volatile bool                   isPending;
+    uint8_t                         reg;
+    bool                            isRead;
+    uint8_t*                        rdata;
+    uint32_t                        rlength;
+} DRV_BME280_REPLAY_OBJ;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global objects
+// *****************************************************************************
+// *****************************************************************************
+
+static DRV_BME280_REPLAY_OBJ gDrvBME280ReplayObj;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static size_t _DRV_BME280_REPLAY_DataRecordFind(DRV_BME280_REPLAY_OBJ* replay, size_t index)
+{
+    while ((index < replay->nRecords) && (replay->records[index].reg != DRV_BME280_REG_DATA_ADDR))
+    {
+        index++;
+    }
+
+    return index;
+}
+
+static const DRV_BME280_REPLAY_RECORD* _DRV_BME280_REPLAY_RecordGet(DRV_BME280_REPLAY_OBJ* replay)
+{
+    const DRV_BME280_REPLAY_RECORD* record = NULL;
+    size_t i;
+
+    if (replay->reg == DRV_BME280_REG_DATA_ADDR)
+    {
+        /* Measurements are served in order */
+        if (replay->nextData < replay->nRecords)
+        {
+            record = &replay->records[replay->nextData];
+            replay->nextData = _DRV_BME280_REPLAY_DataRecordFind(replay, replay->nextData + 1U);
+        }
+    }
+    else
+    {
+        /* Calibration may be read again after a reset, so the first block of
+         * the register is served each time */
+        for (i = 0; i < replay->nRecords; i++)
+        {
+            if (replay->records[i].reg == replay->reg)
+            {
+                record = &replay->records[i];
+                break;
+            }
+        }
+    }
+
+    if ((record != NULL) && (record->length < replay->rlength))
+    {
+        record = NULL;
+    }
+
+    return record;
+}
+
+static bool _DRV_BME280_REPLAY_TransferStart(uint8_t reg, bool isRead, uint8_t* rdata, uint32_t rlength)
+{
+    DRV_BME280_REPLAY_OBJ* replay = &gDrvBME280ReplayObj;
+
+    if (replay->isPending == true)
+    {
+        return false;
+    }
+
+    replay->reg = reg;
+    replay->isRead = isRead;
+    replay->rdata = rdata;
+    replay->rlength = rlength;
+    replay->isPending = true;
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Replay Control Routines
+// *****************************************************************************
+// *****************************************************************************
+
+void DRV_BME280_REPLAY_RecordsSet( const DRV_BME280_REPLAY_RECORD* records, size_t nRecords )
+{
+    DRV_BME280_REPLAY_OBJ* replay = &gDrvBME280ReplayObj;
+
+    replay->records = records;
+    replay->nRecords = (records == NULL) ? 0U : nRecords;
+    replay->nextData = _DRV_BME280_REPLAY_DataRecordFind(replay, 0);
+}
+
+bool DRV_BME280_REPLAY_IsComplete( void )
+{
+    return (gDrvBME280ReplayObj.records != NULL) &&
+           (gDrvBME280ReplayObj.nextData >= gDrvBME280ReplayObj.nRecords);
+}
+
+void DRV_BME280_REPLAY_Tasks( void )
+{
+    DRV_BME280_REPLAY_OBJ* replay = &gDrvBME280ReplayObj;
+    const DRV_BME280_REPLAY_RECORD* record;
+
+    if ((replay->isPending == false) || (replay->records == NULL))
+    {
+        return;
+    }
+
+    replay->error = DRV_BME280_ERROR_NONE;
+
+    if (replay->isRead == true)
+    {
+        if (replay->reg == DRV_BME280_REG_CHIP_ID)
+        {
+            /* The ID is not recorded */
+            (void) memset(replay->rdata, 0, replay->rlength);
+            replay->rdata[0] = DRV_BME280_CHIP_ID;
+        }
+        else
+        {
+            record = _DRV_BME280_REPLAY_RecordGet(replay);
+
+            if (record != NULL)
+            {
+                (void) memcpy(replay->rdata, record->data, replay->rlength);
+            }
+            else
+            {
+                replay->error = DRV_BME280_ERROR_NACK;
+            }
+        }
+    }
+
+    replay->isPending = false;
+
+    if (replay->callback != NULL)
+    {
+        replay->callback(replay->context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Replay I2C PLIB Routines
+// *****************************************************************************
+// *****************************************************************************
+
+bool DRV_BME280_REPLAY_I2C_Read( uint16_t address, uint8_t* rdata, uint32_t rlength )
+{
+    (void) address;
+    (void) rdata;
+    (void) rlength;
+
+    /* The driver always addresses a register before reading */
+    return false;
+}
+
+bool DRV_BME280_REPLAY_I2C_Write( uint16_t address, uint8_t* wdata, uint32_t wlength )
+{
+    (void) address;
+
+    /* Writes configure the sensor and have nothing to replay */
+    return _DRV_BME280_REPLAY_TransferStart((wlength == 0U) ? 0U : wdata[0], false, NULL, 0);
+}
+
+bool DRV_BME280_REPLAY_I2C_WriteRead( uint16_t address, uint8_t* wdata, uint32_t wlength, uint8_t* rdata, uint32_t rlength )
+{
+    (void) address;
+
+    if ((wlength == 0U) || (rlength > DRV_BME280_REPLAY_DATA_SIZE))
+    {
+        return false;
+    }
+
+    return _DRV_BME280_REPLAY_TransferStart(wdata[0], true, rdata, rlength);
+}
+
+DRV_BME280_ERROR DRV_BME280_REPLAY_I2C_ErrorGet( void )
+{
+    DRV_BME280_ERROR error = gDrvBME280ReplayObj.error;
+
+    gDrvBME280ReplayObj.error = DRV_BME280_ERROR_NONE;
+
+    return error;
+}
+
+void DRV_BME280_REPLAY_I2C_CallbackRegister( DRV_BME280_PLIB_CALLBACK callback, uintptr_t context )
+{
+    gDrvBME280ReplayObj.callback = callback;
+    gDrvBME280ReplayObj.context = context;
+}
+
+bool DRV_BME280_REPLAY_I2C_TransferSetup( DRV_BME280_TRANSFER_SETUP* setup, uint32_t srcClkFreq )
+{
+    (void) setup;
+    (void) srcClkFreq;
+
+    return true;
+}
+
+/*******************************************************************************
+ End of File
+*/
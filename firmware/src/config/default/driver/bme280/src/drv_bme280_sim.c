@@ -0,0 +1,839 @@
+/*******************************************************************************
+  DRV_BME280 Simulated Sensor Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_bme280_sim.c
+
+  Summary:
+    Simulated BME280 behind a simulated I2C master.
+
+  Description:
+    The sensor state is advanced lazily: whenever a transaction completes, the
+    model works out from the SYS_TIME counter which measurements have
+    finished since the last access and latches the most recent one into the
+    data registers. Register effects take place when the transaction
+    completes, which is also when the driver's callback is called.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Include Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "configuration.h"
+#include "driver/bme280/drv_bme280.h"
+#include "driver/bme280/drv_bme280_sim.h"
+#include "system/int/sys_int.h"
+#include "system/time/sys_time.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+#define DRV_BME280_SIM_STATUS_MEASURING     0x08U
+#define DRV_BME280_SIM_STATUS_IM_UPDATE     0x01U
+
+/* Time the sensor copies its NVM after power on or a soft reset */
+#define DRV_BME280_SIM_STARTUP_US           (2000U)
+
+/* Datasheet maximum measurement time: a fixed part, and per oversampled
+ * conversion, plus a settling time for pressure and humidity */
+#define DRV_BME280_SIM_MEAS_BASE_US         (1250U)
+#define DRV_BME280_SIM_MEAS_PER_SAMPLE_US   (2300U)
+#define DRV_BME280_SIM_MEAS_SETTLE_US       (575U)
+
+/* Value of a skipped measurement */
+#define DRV_BME280_SIM_SKIPPED_20BIT        (0x80000U)
+#define DRV_BME280_SIM_SKIPPED_16BIT        (0x8000U)
+
+/* An I2C byte is 8 data bits and an acknowledge */
+#define DRV_BME280_SIM_BITS_PER_BYTE        (9U)
+
+#define DRV_BME280_SIM_US_PER_SECOND        (1000000U)
+
+/* Default environment */
+#define DRV_BME280_SIM_DEFAULT_TEMPERATURE  (2500)
+#define DRV_BME280_SIM_DEFAULT_PRESSURE     (101325U)
+#define DRV_BME280_SIM_DEFAULT_HUMIDITY     (50U * 1024U)
+
+typedef int32_t (* DRV_BME280_SIM_COMPENSATE)(uint32_t adc, DRV_BME280_COMPENSATION_DATA* calib);
+
+typedef struct
+{
+    /* 7-bit address the sensor answers on */
+    uint16_t                    address;
+
+    /* Register map. Status is computed on read. */
+    uint8_t                     regs[256];
+
+    /* Register pointer for the next read */
+    uint8_t                     regPointer;
+
+    /* Settings latched by the last write to ctrl_meas */
+    uint8_t                     ctrlHum;
+    uint8_t                     ctrlMeas;
+
+    /* Time the current mode was entered and the number of measurements
+     * latched since */
+    uint64_t                    modeStartUs;
+    uint32_t                    measDone;
+
+    /* End of the NVM copy after reset */
+    uint64_t                    startupEndUs;
+
+    /* Environment script */
+    const DRV_BME280_SIM_POINT* points;
+    size_t                      nPoints;
+    bool                        repeat;
+    uint64_t                    scriptStartUs;
+
+    /* Bus */
+    uint32_t                    clockSpeed;
+    DRV_BME280_PLIB_CALLBACK    callback;
+    uintptr_t                   context;
+    volatile bool               isBusy;
+    DRV_BME280_ERROR            error;
+
+    /* Transaction in flight */
+    uint8_t*                    wdata;
+    uint32_t                    wlength;
+    uint8_t*                    rdata;
+    uint32_t                    rlength;
+    bool                        isAddressed;
+    DRV_BME280_ERROR            pendingError;
+
+    /* Fault injection */
+    DRV_BME280_SIM_FAULT        fault;
+    uint32_t                    faultSkip;
+    uint32_t                    faultCount;
+
+    DRV_BME280_SIM_STATISTICS   stats;
+} DRV_BME280_SIM_OBJ;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global objects
+// *****************************************************************************
+// *****************************************************************************
+
+static DRV_BME280_SIM_OBJ gDrvBME280SimObj;
+
+/* Calibration of a production part, in NVM order */
+static const uint8_t gDrvBME280SimDefaultCalib[DRV_BME280_SIM_CALIB_SIZE] =
+{
+    /* 0x88: dig_T1..dig_T3 */
+    0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC,
+    /* 0x8E: dig_P1..dig_P9 */
+    0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B, 0x8C, 0x00,
+    0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17,
+    /* 0xA0: reserved, 0xA1: dig_H1 */
+    0x00, 0x4B,
+    /* 0xE1: dig_H2, dig_H3, dig_H4, dig_H5, dig_H6 */
+    0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E,
+};
+
+static const uint32_t gDrvBME280SimStandbyUs[8] =
+{
+    500U, 62500U, 125000U, 250000U, 500000U, 1000000U, 10000U, 20000U
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Sensor Model Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static uint64_t _DRV_BME280_SIM_TimeUSGet(void)
+{
+    uint64_t count = SYS_TIME_Counter64Get();
+    uint64_t frequency = SYS_TIME_FrequencyGet();
+
+    return ((count / frequency) * DRV_BME280_SIM_US_PER_SECOND) +
+           (((count % frequency) * DRV_BME280_SIM_US_PER_SECOND) / frequency);
+}
+
+/* Number of conversions for an osrs_x field, 0 if skipped */
+static uint32_t _DRV_BME280_SIM_Samples(uint8_t osrs)
+{
+    return (osrs >= 5U) ? 16U : ((osrs == 0U) ? 0U : (1U << (osrs - 1U)));
+}
+
+static uint32_t _DRV_BME280_SIM_MeasurementTimeUs(DRV_BME280_SIM_OBJ* sim)
+{
+    uint32_t nT = _DRV_BME280_SIM_Samples((sim->ctrlMeas >> 5) & 0x07U);
+    uint32_t nP = _DRV_BME280_SIM_Samples((sim->ctrlMeas >> 2) & 0x07U);
+    uint32_t nH = _DRV_BME280_SIM_Samples(sim->ctrlHum & 0x07U);
+    uint32_t timeUs = DRV_BME280_SIM_MEAS_BASE_US + (nT * DRV_BME280_SIM_MEAS_PER_SAMPLE_US);
+
+    if (nP != 0U)
+    {
+        timeUs += (nP * DRV_BME280_SIM_MEAS_PER_SAMPLE_US) + DRV_BME280_SIM_MEAS_SETTLE_US;
+    }
+
+    if (nH != 0U)
+    {
+        timeUs += (nH * DRV_BME280_SIM_MEAS_PER_SAMPLE_US) + DRV_BME280_SIM_MEAS_SETTLE_US;
+    }
+
+    return timeUs;
+}
+
+static void _DRV_BME280_SIM_CalibGet(DRV_BME280_SIM_OBJ* sim, DRV_BME280_COMPENSATION_DATA* calib)
+{
+    const uint8_t* r = sim->regs;
+
+    calib->dig_T1 = DRV_BME280_CONCAT_BYTES(r[0x89], r[0x88]);
+    calib->dig_T2 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x8B], r[0x8A]);
+    calib->dig_T3 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x8D], r[0x8C]);
+    calib->dig_P1 = DRV_BME280_CONCAT_BYTES(r[0x8F], r[0x8E]);
+    calib->dig_P2 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x91], r[0x90]);
+    calib->dig_P3 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x93], r[0x92]);
+    calib->dig_P4 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x95], r[0x94]);
+    calib->dig_P5 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x97], r[0x96]);
+    calib->dig_P6 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x99], r[0x98]);
+    calib->dig_P7 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x9B], r[0x9A]);
+    calib->dig_P8 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x9D], r[0x9C]);
+    calib->dig_P9 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0x9F], r[0x9E]);
+    calib->dig_H1 = r[0xA1];
+    calib->dig_H2 = (int16_t) DRV_BME280_CONCAT_BYTES(r[0xE2], r[0xE1]);
+    calib->dig_H3 = r[0xE3];
+    calib->dig_H4 = (int16_t)(((int16_t)(int8_t)r[0xE4] * 16) | (int16_t)(r[0xE5] & 0x0FU));
+    calib->dig_H5 = (int16_t)(((int16_t)(int8_t)r[0xE6] * 16) | (int16_t)(r[0xE5] >> 4));
+    calib->dig_H6 = (int8_t)r[0xE7];
+    calib->t_fine = 0;
+}
+
+/* The forward compensation of the driver without the output limits. The
+ * model inverts these to find the ADC value that reads back as the
+ * scripted value. */
+static int32_t _DRV_BME280_SIM_CompensateT(uint32_t adc, DRV_BME280_COMPENSATION_DATA* calib)
+{
+    int32_t var1;
+    int32_t var2;
+
+    var1 = (int32_t)((adc / 8) - ((int32_t)calib->dig_T1 * 2));
+    var1 = (var1 * ((int32_t)calib->dig_T2)) / 2048;
+    var2 = (int32_t)((adc / 16) - ((int32_t)calib->dig_T1));
+    var2 = (((var2 * var2) / 4096) * ((int32_t)calib->dig_T3)) / 16384;
+    calib->t_fine = var1 + var2;
+
+    return (calib->t_fine * 5 + 128) / 256;
+}
+
+static int32_t _DRV_BME280_SIM_CompensateP(uint32_t adc, DRV_BME280_COMPENSATION_DATA* calib)
+{
+    int32_t var1;
+    int32_t var2;
+    int32_t var3;
+    int32_t var4;
+    uint32_t pressure;
+
+    var1 = (((int32_t)calib->t_fine) / 2) - (int32_t)64000;
+    var2 = (((var1 / 4) * (var1 / 4)) / 2048) * ((int32_t)calib->dig_P6);
+    var2 = var2 + ((var1 * ((int32_t)calib->dig_P5)) * 2);
+    var2 = (var2 / 4) + (((int32_t)calib->dig_P4) * 65536);
+    var3 = (calib->dig_P3 * (((var1 / 4) * (var1 / 4)) / 8192)) / 8;
+    var4 = (((int32_t)calib->dig_P2) * var1) / 2;
+    var1 = (var3 + var4) / 262144;
+    var1 = (((32768 + var1)) * ((int32_t)calib->dig_P1)) / 32768;
+
+    if (var1 == 0)
+    {
+        return 0;
+    }
+
+    pressure = ((uint32_t)((1048576U - adc) - (uint32_t)(var2 / 4096))) * 3125U;
+
+    if (pressure < 0x80000000U)
+    {
+        pressure = (pressure << 1) / ((uint32_t)var1);
+    }
+    else
+    {
+        pressure = (pressure / (uint32_t)var1) * 2U;
+    }
+
+    var1 = (((int32_t)calib->dig_P9) * ((int32_t)(((pressure / 8) * (pressure / 8)) / 8192))) / 4096;
+    var2 = (((int32_t)(pressure / 4)) * ((int32_t)calib->dig_P8)) / 8192;
+
+    return (int32_t)pressure + ((var1 + var2 + calib->dig_P7) / 16);
+}
+
+static int32_t _DRV_BME280_SIM_CompensateH(uint32_t adc, DRV_BME280_COMPENSATION_DATA* calib)
+{
+    int32_t var1;
+    int32_t var2;
+    int32_t var3;
+    int32_t var4;
+    int32_t var5;
+
+    var1 = calib->t_fine - ((int32_t)76800);
+    var2 = (int32_t)(adc * 16384);
+    var3 = (int32_t)(((int32_t)calib->dig_H4) * 1048576);
+    var4 = ((int32_t)calib->dig_H5) * var1;
+    var5 = (((var2 - var3) - var4) + (int32_t)16384) / 32768;
+    var2 = (var1 * ((int32_t)calib->dig_H6)) / 1024;
+    var3 = (var1 * ((int32_t)calib->dig_H3)) / 2048;
+    var4 = ((var2 * (var3 + (int32_t)32768)) / 1024) + (int32_t)2097152;
+    var2 = ((var4 * ((int32_t)calib->dig_H2)) + 8192) / 16384;
+    var3 = var5 * var2;
+    var4 = ((var3 / 32768) * (var3 / 32768)) / 128;
+    var5 = var3 - ((var4 * ((int32_t)calib->dig_H1)) / 16);
+    var5 = (var5 < 0 ? 0 : var5);
+    var5 = (var5 > 419430400 ? 419430400 : var5);
+
+    return var5 / 4096;
+}
+
+/* Binary search for the ADC value whose compensated reading is closest to
+ * target from above (rising) or below (falling). */
+static uint32_t _DRV_BME280_SIM_Invert(
+    DRV_BME280_SIM_COMPENSATE compensate,
+    DRV_BME280_COMPENSATION_DATA* calib,
+    int32_t target,
+    uint32_t maxAdc,
+    bool isRising
+)
+{
+    DRV_BME280_COMPENSATION_DATA work;
+    uint32_t low = 0;
+    uint32_t high = maxAdc;
+    uint32_t mid;
+    int32_t value;
+
+    while (low < high)
+    {
+        mid = low + ((high - low) / 2U);
+        work = *calib;
+        value = compensate(mid, &work);
+
+        if ((isRising == true) ? (value < target) : (value > target))
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static int32_t _DRV_BME280_SIM_Interpolate(int32_t a, int32_t b, uint32_t t, uint32_t ta, uint32_t tb)
+{
+    if (tb <= ta)
+    {
+        return b;
+    }
+
+    return a + (int32_t)(((int64_t)(b - a) * (int64_t)(t - ta)) / (int64_t)(tb - ta));
+}
+
+static void _DRV_BME280_SIM_EnvironmentGet(DRV_BME280_SIM_OBJ* sim, uint64_t timeUs, DRV_BME280_SIM_POINT* env)
+{
+    const DRV_BME280_SIM_POINT* p = sim->points;
+    size_t n = sim->nPoints;
+    uint32_t t;
+    size_t i;
+
+    if ((p == NULL) || (n == 0U))
+    {
+        env->temperature = DRV_BME280_SIM_DEFAULT_TEMPERATURE;
+        env->pressure = DRV_BME280_SIM_DEFAULT_PRESSURE;
+        env->humidity = DRV_BME280_SIM_DEFAULT_HUMIDITY;
+        return;
+    }
+
+    t = (uint32_t)((timeUs - sim->scriptStartUs) / 1000U);
+
+    if ((sim->repeat == true) && (p[n - 1U].timeMs > 0U))
+    {
+        t %= p[n - 1U].timeMs;
+    }
+
+    if ((t <= p[0].timeMs) || (n == 1U))
+    {
+        *env = p[0];
+        return;
+    }
+
+    for (i = 1; i < n; i++)
+    {
+        if (t < p[i].timeMs)
+        {
+            env->temperature = _DRV_BME280_SIM_Interpolate(p[i - 1U].temperature, p[i].temperature,
+                                                            t, p[i - 1U].timeMs, p[i].timeMs);
+            env->pressure = (uint32_t)_DRV_BME280_SIM_Interpolate((int32_t)p[i - 1U].pressure, (int32_t)p[i].pressure,
+                                                            t, p[i - 1U].timeMs, p[i].timeMs);
+            env->humidity = (uint32_t)_DRV_BME280_SIM_Interpolate((int32_t)p[i - 1U].humidity, (int32_t)p[i].humidity,
+                                                            t, p[i - 1U].timeMs, p[i].timeMs);
+            return;
+        }
+    }
+
+    *env = p[n - 1U];
+}
+
+/* Writes the result of a measurement that ended at timeUs to the data registers */
+static void _DRV_BME280_SIM_Measure(DRV_BME280_SIM_OBJ* sim, uint64_t timeUs)
+{
+    DRV_BME280_COMPENSATION_DATA calib;
+    DRV_BME280_SIM_POINT env;
+    uint32_t adcT;
+    uint32_t adcP = DRV_BME280_SIM_SKIPPED_20BIT;
+    uint32_t adcH = DRV_BME280_SIM_SKIPPED_16BIT;
+
+    _DRV_BME280_SIM_CalibGet(sim, &calib);
+    _DRV_BME280_SIM_EnvironmentGet(sim, timeUs, &env);
+
+    /* Pressure and humidity compensation depend on t_fine, so the
+     * temperature is always converted first */
+    adcT = _DRV_BME280_SIM_Invert(_DRV_BME280_SIM_CompensateT, &calib, env.temperature, 0xFFFFFU, true);
+    (void) _DRV_BME280_SIM_CompensateT(adcT, &calib);
+
+    if (((sim->ctrlMeas >> 2) & 0x07U) != 0U)
+    {
+        adcP = _DRV_BME280_SIM_Invert(_DRV_BME280_SIM_CompensateP, &calib, (int32_t)env.pressure, 0xFFFFFU, false);
+    }
+
+    if ((sim->ctrlHum & 0x07U) != 0U)
+    {
+        adcH = _DRV_BME280_SIM_Invert(_DRV_BME280_SIM_CompensateH, &calib, (int32_t)env.humidity, 0xFFFFU, true);
+    }
+
+    if (((sim->ctrlMeas >> 5) & 0x07U) == 0U)
+    {
+        adcT = DRV_BME280_SIM_SKIPPED_20BIT;
+    }
+
+    sim->regs[DRV_BME280_REG_PRESSURE_MSB] = (uint8_t)(adcP >> 12);
+    sim->regs[DRV_BME280_REG_PRESSURE_LSB] = (uint8_t)(adcP >> 4);
+    sim->regs[DRV_BME280_REG_PRESSURE_XLSB] = (uint8_t)(adcP << 4);
+    sim->regs[DRV_BME280_REG_TEMPERATURE_MSB] = (uint8_t)(adcT >> 12);
+    sim->regs[DRV_BME280_REG_TEMPERATURE_LSB] = (uint8_t)(adcT >> 4);
+    sim->regs[DRV_BME280_REG_TEMPERATURE_XLSB] = (uint8_t)(adcT << 4);
+    sim->regs[DRV_BME280_REG_HUMIDITY_MSB] = (uint8_t)(adcH >> 8);
+    sim->regs[DRV_BME280_REG_HUMIDITY_LSB] = (uint8_t)adcH;
+
+    sim->stats.measurements++;
+}
+
+/* Latches the most recent measurement that has ended by nowUs. Returns true
+ * while a measurement is in progress. */
+static bool _DRV_BME280_SIM_Update(DRV_BME280_SIM_OBJ* sim, uint64_t nowUs)
+{
+    uint8_t mode = sim->ctrlMeas & 0x03U;
+    uint64_t measUs = _DRV_BME280_SIM_MeasurementTimeUs(sim);
+    uint64_t periodUs;
+    uint64_t elapsedUs;
+    uint32_t completed;
+
+    if (mode == DRV_BME280_SLEEP_MODE)
+    {
+        return false;
+    }
+
+    if (nowUs < (sim->modeStartUs + measUs))
+    {
+        return true;
+    }
+
+    elapsedUs = nowUs - sim->modeStartUs - measUs;
+
+    if (mode != DRV_BME280_NORMAL_MODE)
+    {
+        /* Forced mode: one measurement, then back to sleep */
+        _DRV_BME280_SIM_Measure(sim, sim->modeStartUs + measUs);
+        sim->ctrlMeas &= (uint8_t)~0x03U;
+        sim->regs[DRV_BME280_REG_CTRL_MEAS] = sim->ctrlMeas;
+        return false;
+    }
+
+    periodUs = measUs + gDrvBME280SimStandbyUs[sim->regs[DRV_BME280_REG_CONFIG] >> 5];
+    completed = (uint32_t)(elapsedUs / periodUs) + 1U;
+
+    if (completed != sim->measDone)
+    {
+        /* Measurements nobody read are only counted */
+        sim->stats.measurements += completed - sim->measDone - 1U;
+        sim->measDone = completed;
+        _DRV_BME280_SIM_Measure(sim, sim->modeStartUs + measUs + ((uint64_t)(completed - 1U) * periodUs));
+    }
+
+    return ((elapsedUs % periodUs) >= (periodUs - measUs));
+}
+
+static void _DRV_BME280_SIM_Reset(DRV_BME280_SIM_OBJ* sim, uint64_t nowUs)
+{
+    sim->ctrlHum = 0;
+    sim->ctrlMeas = 0;
+    sim->measDone = 0;
+    sim->regPointer = 0;
+    sim->startupEndUs = nowUs + DRV_BME280_SIM_STARTUP_US;
+
+    sim->regs[DRV_BME280_REG_CTRL_HUMIDITY] = 0;
+    sim->regs[DRV_BME280_REG_CTRL_MEAS] = 0;
+    sim->regs[DRV_BME280_REG_CONFIG] = 0;
+    sim->regs[DRV_BME280_REG_PRESSURE_MSB] = 0x80;
+    sim->regs[DRV_BME280_REG_PRESSURE_LSB] = 0x00;
+    sim->regs[DRV_BME280_REG_PRESSURE_XLSB] = 0x00;
+    sim->regs[DRV_BME280_REG_TEMPERATURE_MSB] = 0x80;
+    sim->regs[DRV_BME280_REG_TEMPERATURE_LSB] = 0x00;
+    sim->regs[DRV_BME280_REG_TEMPERATURE_XLSB] = 0x00;
+    sim->regs[DRV_BME280_REG_HUMIDITY_MSB] = 0x80;
+    sim->regs[DRV_BME280_REG_HUMIDITY_LSB] = 0x00;
+}
+
+static void _DRV_BME280_SIM_RegisterWrite(DRV_BME280_SIM_OBJ* sim, uint8_t reg, uint8_t value, uint64_t nowUs)
+{
+    switch (reg)
+    {
+        case DRV_BME280_REG_RESET:
+            if (value == DRV_BME280_SOFT_RESET)
+            {
+                _DRV_BME280_SIM_Reset(sim, nowUs);
+            }
+            break;
+
+        case DRV_BME280_REG_CTRL_HUMIDITY:
+            /* Takes effect at the next write to ctrl_meas */
+            sim->regs[reg] = value & 0x07U;
+            break;
+
+        case DRV_BME280_REG_CTRL_MEAS:
+            sim->regs[reg] = value;
+            sim->ctrlMeas = value;
+            sim->ctrlHum = sim->regs[DRV_BME280_REG_CTRL_HUMIDITY];
+            sim->modeStartUs = nowUs;
+            sim->measDone = 0;
+            break;
+
+        case DRV_BME280_REG_CONFIG:
+            sim->regs[reg] = value & 0xFDU;
+            break;
+
+        default:
+            /* Read-only register */
+            break;
+    }
+}
+
+static uint8_t _DRV_BME280_SIM_RegisterRead(DRV_BME280_SIM_OBJ* sim, uint8_t reg, bool isMeasuring, uint64_t nowUs)
+{
+    uint8_t status = 0;
+
+    if (reg != DRV_BME280_REG_STATUS)
+    {
+        return sim->regs[reg];
+    }
+
+    if (isMeasuring == true)
+    {
+        status |= DRV_BME280_SIM_STATUS_MEASURING;
+    }
+
+    if (nowUs < sim->startupEndUs)
+    {
+        status |= DRV_BME280_SIM_STATUS_IM_UPDATE;
+    }
+
+    return status;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulated I2C Master Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+/* Called from the SYS_TIME interrupt when the bus time has elapsed */
+static void _DRV_BME280_SIM_TransferDone(uintptr_t context)
+{
+    DRV_BME280_SIM_OBJ* sim = (DRV_BME280_SIM_OBJ*) context;
+    uint64_t nowUs = _DRV_BME280_SIM_TimeUSGet();
+    bool isMeasuring;
+    uint32_t i;
+
+    if (sim->pendingError == DRV_BME280_ERROR_NONE)
+    {
+        isMeasuring = _DRV_BME280_SIM_Update(sim, nowUs);
+
+        if (sim->wlength > 0U)
+        {
+            sim->regPointer = sim->wdata[0];
+
+            /* Writes are register address and data pairs */
+            for (i = 0; (i + 1U) < sim->wlength; i += 2U)
+            {
+                _DRV_BME280_SIM_RegisterWrite(sim, sim->wdata[i], sim->wdata[i + 1U], nowUs);
+            }
+        }
+
+        /* Reads auto-increment the register address */
+        for (i = 0; i < sim->rlength; i++)
+        {
+            sim->rdata[i] = _DRV_BME280_SIM_RegisterRead(sim, sim->regPointer, isMeasuring, nowUs);
+
+            if (sim->regPointer != 0xFFU)
+            {
+                sim->regPointer++;
+            }
+        }
+    }
+
+    sim->error = sim->pendingError;
+    sim->isBusy = false;
+
+    if (sim->callback != NULL)
+    {
+        sim->callback(sim->context);
+    }
+}
+
+static bool _DRV_BME280_SIM_TransferStart(
+    uint16_t address,
+    uint8_t* wdata,
+    uint32_t wlength,
+    uint8_t* rdata,
+    uint32_t rlength
+)
+{
+    DRV_BME280_SIM_OBJ* sim = &gDrvBME280SimObj;
+    uint32_t bytes;
+    uint32_t bits;
+    uint32_t durationUs;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    if ((sim->isBusy == true) || (sim->clockSpeed == 0U))
+    {
+        SYS_INT_Restore(interruptState);
+        return false;
+    }
+
+    sim->isBusy = true;
+
+    SYS_INT_Restore(interruptState);
+
+    sim->wdata = wdata;
+    sim->wlength = wlength;
+    sim->rdata = rdata;
+    sim->rlength = rlength;
+    sim->pendingError = DRV_BME280_ERROR_NONE;
+
+    /* An address byte for each direction, and a START or repeated START
+     * and a STOP condition */
+    bytes = wlength + rlength + (((wlength > 0U) && (rlength > 0U)) ? 2U : 1U);
+    bits = (bytes * DRV_BME280_SIM_BITS_PER_BYTE) + (((wlength > 0U) && (rlength > 0U)) ? 3U : 2U);
+
+    if (address != sim->address)
+    {
+        sim->pendingError = DRV_BME280_ERROR_NACK;
+    }
+    else if (sim->faultCount > 0U)
+    {
+        if (sim->faultSkip > 0U)
+        {
+            sim->faultSkip--;
+        }
+        else
+        {
+            sim->faultCount--;
+            sim->pendingError = (sim->fault == DRV_BME280_SIM_FAULT_NACK) ?
+                                    DRV_BME280_ERROR_NACK : DRV_BME280_ERROR_BUS;
+        }
+    }
+
+    if (sim->pendingError != DRV_BME280_ERROR_NONE)
+    {
+        /* The transfer stops after the address byte */
+        bytes = 1U;
+        bits = DRV_BME280_SIM_BITS_PER_BYTE + 2U;
+
+        if (sim->pendingError == DRV_BME280_ERROR_NACK)
+        {
+            sim->stats.nacks++;
+        }
+        else
+        {
+            sim->stats.busErrors++;
+        }
+    }
+
+    durationUs = ((bits * DRV_BME280_SIM_US_PER_SECOND) + sim->clockSpeed - 1U) / sim->clockSpeed;
+
+    sim->stats.transactions++;
+    sim->stats.bytes += bytes;
+    sim->stats.busTimeUs += durationUs;
+
+    if (SYS_TIME_CallbackRegisterUS(_DRV_BME280_SIM_TransferDone, (uintptr_t) sim,
+            durationUs, SYS_TIME_SINGLE) == SYS_TIME_HANDLE_INVALID)
+    {
+        sim->isBusy = false;
+        return false;
+    }
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulation Control Routines
+// *****************************************************************************
+// *****************************************************************************
+
+void DRV_BME280_SIM_Initialize( uint16_t address, const uint8_t* calibration )
+{
+    DRV_BME280_SIM_OBJ* sim = &gDrvBME280SimObj;
+    uint64_t nowUs = _DRV_BME280_SIM_TimeUSGet();
+
+    if (calibration == NULL)
+    {
+        calibration = gDrvBME280SimDefaultCalib;
+    }
+
+    (void) memset(sim->regs, 0, sizeof(sim->regs));
+    (void) memcpy(&sim->regs[DRV_BME280_CALIB_TEMP_DIG_T1_LSB_REG], &calibration[0],
+                  (DRV_BME280_CALIB_HUM_DIG_H1_REG - DRV_BME280_CALIB_TEMP_DIG_T1_LSB_REG) + 1U);
+    (void) memcpy(&sim->regs[DRV_BME280_CALIB_HUM_DIG_H2_LSB_REG],
+                  &calibration[(DRV_BME280_CALIB_HUM_DIG_H1_REG - DRV_BME280_CALIB_TEMP_DIG_T1_LSB_REG) + 1U],
+                  (DRV_BME280_CALIB_HUM_DIG_H6_REG - DRV_BME280_CALIB_HUM_DIG_H2_LSB_REG) + 1U);
+    sim->regs[DRV_BME280_REG_CHIP_ID] = DRV_BME280_CHIP_ID;
+
+    sim->address = address;
+    sim->isBusy = false;
+    sim->error = DRV_BME280_ERROR_NONE;
+    sim->faultCount = 0;
+    sim->points = NULL;
+    sim->nPoints = 0;
+    sim->scriptStartUs = nowUs;
+
+    (void) memset(&sim->stats, 0, sizeof(sim->stats));
+
+    _DRV_BME280_SIM_Reset(sim, nowUs);
+}
+
+void DRV_BME280_SIM_ScriptSet( const DRV_BME280_SIM_POINT* points, size_t nPoints, bool repeat )
+{
+    DRV_BME280_SIM_OBJ* sim = &gDrvBME280SimObj;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    sim->points = points;
+    sim->nPoints = (points == NULL) ? 0U : nPoints;
+    sim->repeat = repeat;
+    sim->scriptStartUs = _DRV_BME280_SIM_TimeUSGet();
+
+    SYS_INT_Restore(interruptState);
+}
+
+void DRV_BME280_SIM_FaultSet( DRV_BME280_SIM_FAULT fault, uint32_t skipCount, uint32_t failCount )
+{
+    DRV_BME280_SIM_OBJ* sim = &gDrvBME280SimObj;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    sim->fault = fault;
+    sim->faultSkip = skipCount;
+    sim->faultCount = failCount;
+
+    SYS_INT_Restore(interruptState);
+}
+
+void DRV_BME280_SIM_StatisticsGet( DRV_BME280_SIM_STATISTICS* stats )
+{
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+    *stats = gDrvBME280SimObj.stats;
+    SYS_INT_Restore(interruptState);
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulated I2C PLIB Routines
+// *****************************************************************************
+// *****************************************************************************
+
+bool DRV_BME280_SIM_I2C_Read( uint16_t address, uint8_t* rdata, uint32_t rlength )
+{
+    return _DRV_BME280_SIM_TransferStart(address, NULL, 0, rdata, rlength);
+}
+
+bool DRV_BME280_SIM_I2C_Write( uint16_t address, uint8_t* wdata, uint32_t wlength )
+{
+    return _DRV_BME280_SIM_TransferStart(address, wdata, wlength, NULL, 0);
+}
+
+bool DRV_BME280_SIM_I2C_WriteRead( uint16_t address, uint8_t* wdata, uint32_t wlength, uint8_t* rdata, uint32_t rlength )
+{
+    return _DRV_BME280_SIM_TransferStart(address, wdata, wlength, rdata, rlength);
+}
+
+DRV_BME280_ERROR DRV_BME280_SIM_I2C_ErrorGet( void )
+{
+    DRV_BME280_ERROR error = gDrvBME280SimObj.error;
+
+    gDrvBME280SimObj.error = DRV_BME280_ERROR_NONE;
+
+    return error;
+}
+
+void DRV_BME280_SIM_I2C_CallbackRegister( DRV_BME280_PLIB_CALLBACK callback, uintptr_t context )
+{
+    gDrvBME280SimObj.callback = callback;
+    gDrvBME280SimObj.context = context;
+}
+
+bool DRV_BME280_SIM_I2C_TransferSetup( DRV_BME280_TRANSFER_SETUP* setup, uint32_t srcClkFreq )
+{
+    (void) srcClkFreq;
+
+    if ((setup == NULL) || (setup->clockSpeed == 0U))
+    {
+        return false;
+    }
+
+    gDrvBME280SimObj.clockSpeed = setup->clockSpeed;
+
+    return true;
+}
+
+/*******************************************************************************
+ End of File
+*/
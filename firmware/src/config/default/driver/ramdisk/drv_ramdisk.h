@@ -0,0 +1,859 @@
+/*******************************************************************************
+  RAM Disk Driver Interface Definition
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk.h
+
+  Summary:
+    RAM Disk Driver Interface Definition
+
+  Description:
+    The RAM disk driver is a block media driver with the same interface as the
+    SDMMC driver. It stores the disk in a RAM array or in an external backing
+    store and registers with the file system media manager, so that the file
+    system and the logging code can run without an SD card. Each request
+    completes in DRV_RAMDISK_Tasks after a configurable latency, and requests
+    can be made to fail on demand to exercise the error paths of the clients.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _DRV_RAMDISK_H
+#define _DRV_RAMDISK_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system/system.h"
+#include "driver/driver_common.h"
+#include "system/system_media.h"
+#include "driver/ramdisk/drv_ramdisk_definitions.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* RAM Disk Driver command handle.
+
+  Summary:
+    Handle identifying commands queued in the driver.
+
+  Description:
+    A command handle is returned by a call to the Read or Write functions. It
+    is also passed to the event handler when the command completes.
+
+  Remarks:
+    Refer sys_media.h for definition of SYS_MEDIA_BLOCK_COMMAND_HANDLE.
+*/
+
+typedef SYS_MEDIA_BLOCK_COMMAND_HANDLE DRV_RAMDISK_COMMAND_HANDLE;
+
+#define DRV_RAMDISK_COMMAND_HANDLE_INVALID  SYS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID
+
+// *****************************************************************************
+/* RAM Disk Driver Events
+
+   Summary
+    Identifies the possible events that can result from a request.
+
+   Description
+    One of these values is passed to the event handler when a request
+    completes.
+
+   Remarks:
+    Refer sys_media.h for SYS_MEDIA_XXX definitions.
+*/
+
+typedef enum
+{
+    /* Operation has been completed successfully. */
+    DRV_RAMDISK_EVENT_COMMAND_COMPLETE = SYS_MEDIA_EVENT_BLOCK_COMMAND_COMPLETE,
+
+    /* There was an error during the operation */
+    DRV_RAMDISK_EVENT_COMMAND_ERROR = SYS_MEDIA_EVENT_BLOCK_COMMAND_ERROR
+
+} DRV_RAMDISK_EVENT;
+
+// *****************************************************************************
+/* RAM Disk Driver Command Status
+
+   Summary
+    Identifies the possible status values of a request.
+
+   Description
+    One of these values is returned by the DRV_RAMDISK_CommandStatus routine.
+
+   Remarks:
+    Refer sys_media.h for SYS_MEDIA_XXX definitions.
+*/
+
+typedef enum
+{
+    /* Done OK and ready */
+    DRV_RAMDISK_COMMAND_COMPLETED          = SYS_MEDIA_COMMAND_COMPLETED,
+
+    /* Scheduled but not started */
+    DRV_RAMDISK_COMMAND_QUEUED             = SYS_MEDIA_COMMAND_QUEUED,
+
+    /* Waiting for the configured latency to elapse */
+    DRV_RAMDISK_COMMAND_IN_PROGRESS        = SYS_MEDIA_COMMAND_IN_PROGRESS,
+
+    /* Unknown Command, or the command failed */
+    DRV_RAMDISK_COMMAND_ERROR_UNKNOWN      = SYS_MEDIA_COMMAND_UNKNOWN,
+
+} DRV_RAMDISK_COMMAND_STATUS;
+
+// *****************************************************************************
+/* RAM Disk Driver Event Handler Function Pointer
+
+   Summary
+    Pointer to a RAM disk driver event handler function
+
+   Description
+    This data type defines the required function signature for the RAM disk
+    event handling callback function.
+
+   Remarks:
+    Refer sys_media.h for definition of SYS_MEDIA_EVENT_HANDLER.
+*/
+
+typedef SYS_MEDIA_EVENT_HANDLER DRV_RAMDISK_EVENT_HANDLER;
+
+// *****************************************************************************
+/* RAM Disk Driver Fault Operations
+
+   Summary
+    Selects the requests a fault applies to.
+
+   Description
+    The values can be ORed.
+
+   Remarks:
+    None.
+*/
+
+typedef enum
+{
+    DRV_RAMDISK_FAULT_READ  = 0x01,
+
+    DRV_RAMDISK_FAULT_WRITE = 0x02,
+
+} DRV_RAMDISK_FAULT_OPERATION;
+
+// *****************************************************************************
+/* RAM Disk Driver Fault
+
+   Summary
+    Describes the requests that are made to fail.
+
+   Description
+    After skipCount matching requests have completed normally, the next
+    failCount matching requests complete with DRV_RAMDISK_EVENT_COMMAND_ERROR.
+    A request matches if its operation is in operations and, when nBlock is
+    not zero, it touches a block in blockStart .. blockStart + nBlock - 1.
+
+    A failed write leaves the disk unchanged. A failed read leaves the
+    client's buffer unchanged.
+
+   Remarks:
+    A failCount of zero disables fault injection.
+*/
+
+typedef struct
+{
+    /* ORed DRV_RAMDISK_FAULT_OPERATION values */
+    uint32_t    operations;
+
+    /* Block range a request must touch to match, all blocks if nBlock is 0 */
+    uint32_t    blockStart;
+    uint32_t    nBlock;
+
+    /* Matching requests to let through before failing */
+    uint32_t    skipCount;
+
+    /* Matching requests to fail */
+    uint32_t    failCount;
+} DRV_RAMDISK_FAULT;
+
+// *****************************************************************************
+/* RAM Disk Driver Statistics
+
+   Summary
+    Counts the requests handled by the driver.
+
+   Description
+    This structure is filled by the DRV_RAMDISK_StatisticsGet routine.
+
+   Remarks:
+    None.
+*/
+
+typedef struct
+{
+    /* Completed requests, including failed ones */
+    uint32_t    readCommands;
+    uint32_t    writeCommands;
+
+    /* Blocks moved by successful requests */
+    uint32_t    blocksRead;
+    uint32_t    blocksWritten;
+
+    /* Requests failed by fault injection or by the backing store */
+    uint32_t    failedCommands;
+} DRV_RAMDISK_STATISTICS;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver System Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    SYS_MODULE_OBJ DRV_RAMDISK_Initialize (
+        const SYS_MODULE_INDEX drvIndex,
+        const SYS_MODULE_INIT* const init
+    )
+
+  Summary:
+    Initializes the RAM disk driver.
+
+  Description:
+    This routine initializes the driver instance and, if isFsEnabled is set,
+    registers it with the file system media manager. The disk contents are not
+    cleared, so a disk image loaded before initialization is preserved.
+
+  Precondition:
+    SYS_TIME_Initialize should have been called.
+
+  Parameters:
+    drvIndex - Identifier for the driver instance to be initialized
+
+    init     - Pointer to the DRV_RAMDISK_INIT data structure
+
+  Returns:
+    A valid handle to a driver object if successful, otherwise
+    SYS_MODULE_OBJ_INVALID.
+
+  Example:
+    <code>
+    static uint8_t ramDisk[64 * DRV_RAMDISK_BLOCK_SIZE];
+    static DRV_RAMDISK_CLIENT_OBJ ramDiskClients[1];
+    static DRV_RAMDISK_BUFFER_OBJ ramDiskBuffers[2];
+
+    const DRV_RAMDISK_INIT ramDiskInit =
+    {
+        .storage = ramDisk,
+        .store = NULL,
+        .numBlocks = 64,
+        .clientObjPool = (uintptr_t)&ramDiskClients[0],
+        .numClients = 1,
+        .bufferObjPool = (uintptr_t)&ramDiskBuffers[0],
+        .bufferObjPoolSize = 2,
+        .readLatencyUs = 500,
+        .writeLatencyUs = 2000,
+        .isFsEnabled = true,
+    };
+
+    objectHandle = DRV_RAMDISK_Initialize(DRV_RAMDISK_INDEX_0, (SYS_MODULE_INIT*)&ramDiskInit);
+    </code>
+
+  Remarks:
+    This routine must be called from the SYS_Initialize function.
+*/
+
+SYS_MODULE_OBJ DRV_RAMDISK_Initialize( const SYS_MODULE_INDEX drvIndex, const SYS_MODULE_INIT* const init );
+
+/*******************************************************************************
+  Function:
+    SYS_STATUS DRV_RAMDISK_Status ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Gets the current status of the RAM disk driver module.
+
+  Description:
+    Returns SYS_STATUS_READY once the instance has been initialized.
+
+  Precondition:
+    None.
+
+  Parameters:
+    object - Driver object handle, returned from DRV_RAMDISK_Initialize
+
+  Returns:
+    SYS_STATUS_READY or SYS_STATUS_UNINITIALIZED.
+
+  Example:
+    <code>
+    if (DRV_RAMDISK_Status(object) == SYS_STATUS_READY)
+    {
+        // Driver is ready to be opened
+    }
+    </code>
+
+  Remarks:
+    None.
+*/
+
+SYS_STATUS DRV_RAMDISK_Status( SYS_MODULE_OBJ object );
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_Tasks ( SYS_MODULE_OBJ object )
+
+  Summary:
+    Completes the queued requests whose latency has elapsed.
+
+  Description:
+    Requests are served in order, one at a time. A request starts when it
+    reaches the head of the queue and completes once its latency has elapsed,
+    at which point the data is copied and the client's event handler is
+    called.
+
+  Precondition:
+    DRV_RAMDISK_Initialize should have been called.
+
+  Parameters:
+    object - Driver object handle, returned from DRV_RAMDISK_Initialize
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_Tasks(object);
+    </code>
+
+  Remarks:
+    This routine must be called from SYS_Tasks(). The file system media
+    manager also calls it while waiting for a request.
+*/
+
+void DRV_RAMDISK_Tasks( SYS_MODULE_OBJ object );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver Client Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    DRV_HANDLE DRV_RAMDISK_Open (
+        const SYS_MODULE_INDEX drvIndex,
+        const DRV_IO_INTENT ioIntent
+    )
+
+  Summary:
+    Opens the specified RAM disk driver instance and returns a handle to it.
+
+  Description:
+    A client opened with DRV_IO_INTENT_READ only cannot write to the disk.
+
+  Precondition:
+    DRV_RAMDISK_Initialize should have been called.
+
+  Parameters:
+    drvIndex - Identifier for the instance to be opened
+
+    ioIntent - Zero or more of the values from DRV_IO_INTENT
+
+  Returns:
+    A valid handle, or DRV_HANDLE_INVALID if the instance is not ready or no
+    client object is free.
+
+  Example:
+    <code>
+    handle = DRV_RAMDISK_Open(DRV_RAMDISK_INDEX_0, DRV_IO_INTENT_READWRITE);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+DRV_HANDLE DRV_RAMDISK_Open( const SYS_MODULE_INDEX drvIndex, const DRV_IO_INTENT ioIntent );
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_Close ( const DRV_HANDLE handle )
+
+  Summary:
+    Closes an opened instance of the RAM disk driver.
+
+  Description:
+    Requests queued by the client are removed without calling its event
+    handler.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle - A valid open-instance handle, returned from DRV_RAMDISK_Open
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_Close(handle);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void DRV_RAMDISK_Close( const DRV_HANDLE handle );
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_AsyncRead (
+        const DRV_HANDLE handle,
+        DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+        void* targetBuffer,
+        uint32_t blockStart,
+        uint32_t nBlock
+    )
+
+  Summary:
+    Queues a read of blocks from the disk.
+
+  Description:
+    *commandHandle is set to DRV_RAMDISK_COMMAND_HANDLE_INVALID if the request
+    could not be queued: the handle or the block range is invalid, the buffer
+    is NULL or the queue is full.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle        - A valid open-instance handle
+    commandHandle - Receives the command handle
+    targetBuffer  - Buffer of nBlock * DRV_RAMDISK_BLOCK_SIZE bytes
+    blockStart    - First block to read
+    nBlock        - Number of blocks to read
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_AsyncRead(handle, &commandHandle, &buffer[0], 0, 1);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void DRV_RAMDISK_AsyncRead(
+    const DRV_HANDLE handle,
+    DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+    void* targetBuffer,
+    uint32_t blockStart,
+    uint32_t nBlock
+);
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_AsyncWrite (
+        const DRV_HANDLE handle,
+        DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+        void* sourceBuffer,
+        uint32_t blockStart,
+        uint32_t nBlock
+    )
+
+  Summary:
+    Queues a write of blocks to the disk.
+
+  Description:
+    As DRV_RAMDISK_AsyncRead. The request is also rejected if the client was
+    not opened for writing. The source buffer must stay valid until the
+    request completes.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle        - A valid open-instance handle
+    commandHandle - Receives the command handle
+    sourceBuffer  - Buffer of nBlock * DRV_RAMDISK_BLOCK_SIZE bytes
+    blockStart    - First block to write
+    nBlock        - Number of blocks to write
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_AsyncWrite(handle, &commandHandle, &buffer[0], 0, 1);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void DRV_RAMDISK_AsyncWrite(
+    const DRV_HANDLE handle,
+    DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+    void* sourceBuffer,
+    uint32_t blockStart,
+    uint32_t nBlock
+);
+
+/*******************************************************************************
+  Function:
+    DRV_RAMDISK_COMMAND_STATUS DRV_RAMDISK_CommandStatus (
+        const DRV_HANDLE handle,
+        const DRV_RAMDISK_COMMAND_HANDLE commandHandle
+    )
+
+  Summary:
+    Gets the current status of a command.
+
+  Description:
+    Returns the status of the request. A failed request reports
+    DRV_RAMDISK_COMMAND_ERROR_UNKNOWN.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle        - A valid open-instance handle
+    commandHandle - Handle returned by a read or write request
+
+  Returns:
+    A DRV_RAMDISK_COMMAND_STATUS value.
+
+  Example:
+    <code>
+    status = DRV_RAMDISK_CommandStatus(handle, commandHandle);
+    </code>
+
+  Remarks:
+    A request whose buffer object has been reused reports
+    DRV_RAMDISK_COMMAND_COMPLETED.
+*/
+
+DRV_RAMDISK_COMMAND_STATUS DRV_RAMDISK_CommandStatus(
+    const DRV_HANDLE handle,
+    const DRV_RAMDISK_COMMAND_HANDLE commandHandle
+);
+
+/*******************************************************************************
+  Function:
+    SYS_MEDIA_GEOMETRY* DRV_RAMDISK_GeometryGet ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns the geometry of the disk.
+
+  Description:
+    The disk has one read, write and erase region of numBlocks blocks of
+    DRV_RAMDISK_BLOCK_SIZE bytes.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle - A valid open-instance handle
+
+  Returns:
+    Pointer to the geometry, or NULL if the handle is invalid.
+
+  Example:
+    <code>
+    geometry = DRV_RAMDISK_GeometryGet(handle);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+SYS_MEDIA_GEOMETRY* DRV_RAMDISK_GeometryGet( const DRV_HANDLE handle );
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_EventHandlerSet (
+        const DRV_HANDLE handle,
+        const void* eventHandler,
+        const uintptr_t context
+    )
+
+  Summary:
+    Sets the event handler called when a request completes.
+
+  Description:
+    The handler is called from DRV_RAMDISK_Tasks.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle       - A valid open-instance handle
+    eventHandler - Pointer to a DRV_RAMDISK_EVENT_HANDLER, or NULL
+    context      - Passed back to the event handler
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_EventHandlerSet(handle, APP_RamDiskEventHandler, (uintptr_t)&appData);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void DRV_RAMDISK_EventHandlerSet(
+    const DRV_HANDLE handle,
+    const void* eventHandler,
+    const uintptr_t context
+);
+
+/*******************************************************************************
+  Function:
+    bool DRV_RAMDISK_IsAttached ( const DRV_HANDLE handle )
+
+  Summary:
+    Returns the attach status of the disk.
+
+  Description:
+    The disk is attached unless it has been detached with
+    DRV_RAMDISK_AttachSet.
+
+  Precondition:
+    DRV_RAMDISK_Open must have been called.
+
+  Parameters:
+    handle - A valid open-instance handle
+
+  Returns:
+    true if the disk is attached.
+
+  Example:
+    <code>
+    if (DRV_RAMDISK_IsAttached(handle) == true)
+    {
+    }
+    </code>
+
+  Remarks:
+    None.
+*/
+
+bool DRV_RAMDISK_IsAttached( const DRV_HANDLE handle );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver Test Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_AttachSet ( const SYS_MODULE_INDEX drvIndex, bool isAttached )
+
+  Summary:
+    Simulates insertion or removal of the disk.
+
+  Description:
+    While detached, queued and new requests fail. The media manager sees the
+    change on its next status poll and unmounts or mounts the volume.
+
+  Precondition:
+    DRV_RAMDISK_Initialize should have been called.
+
+  Parameters:
+    drvIndex   - Driver instance
+    isAttached - New attach state
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_AttachSet(DRV_RAMDISK_INDEX_0, false);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void DRV_RAMDISK_AttachSet( const SYS_MODULE_INDEX drvIndex, bool isAttached );
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_LatencySet (
+        const SYS_MODULE_INDEX drvIndex,
+        uint32_t readLatencyUs,
+        uint32_t writeLatencyUs
+    )
+
+  Summary:
+    Changes the time a request takes to complete.
+
+  Description:
+    The new latency applies to requests started after the call.
+
+  Precondition:
+    DRV_RAMDISK_Initialize should have been called.
+
+  Parameters:
+    drvIndex       - Driver instance
+    readLatencyUs  - Read latency in microseconds
+    writeLatencyUs - Write latency in microseconds
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    DRV_RAMDISK_LatencySet(DRV_RAMDISK_INDEX_0, 1000, 250000);
+    </code>
+
+  Remarks:
+    A latency of zero completes the request on the next call to
+    DRV_RAMDISK_Tasks.
+*/
+
+void DRV_RAMDISK_LatencySet( const SYS_MODULE_INDEX drvIndex, uint32_t readLatencyUs, uint32_t writeLatencyUs );
+
+/*******************************************************************************
+  Function:
+    void DRV_RAMDISK_FaultSet ( const SYS_MODULE_INDEX drvIndex,
+                                const DRV_RAMDISK_FAULT* fault )
+
+  Summary:
+    Makes the requests described by fault fail.
+
+  Description:
+    Replaces any fault set earlier. Pass NULL to stop failing requests.
+
+  Precondition:
+    DRV_RAMDISK_Initialize should have been called.
+
+  Parameters:
+    drvIndex - Driver instance
+    fault    - Fault description, or NULL
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    // Fail the third write to the first FAT sector
+    DRV_RAMDISK_FAULT fault =
+    {
+        .operations = DRV_RAMDISK_FAULT_WRITE,
+        .blockStart = fatSector,
+        .nBlock = 1,
+        .skipCount = 2,
+        .failCount = 1,
+    };
+
+    DRV_RAMDISK_FaultSet(DRV_RAMDISK_INDEX_0, &fault);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+void DRV_RAMDISK_FaultSet( const SYS_MODULE_INDEX drvIndex, const DRV_RAMDISK_FAULT* fault );
+
+/*******************************************************************************
+  Function:
+    bool DRV_RAMDISK_StatisticsGet ( const SYS_MODULE_INDEX drvIndex,
+                                     DRV_RAMDISK_STATISTICS* stats )
+
+  Summary:
+    Returns the request counters.
+
+  Description:
+    Copies the counters accumulated since initialization.
+
+  Precondition:
+    DRV_RAMDISK_Initialize should have been called.
+
+  Parameters:
+    drvIndex - Driver instance
+    stats    - Destination of the counters
+
+  Returns:
+    true if the instance is initialized.
+
+  Example:
+    <code>
+    DRV_RAMDISK_STATISTICS stats;
+
+    DRV_RAMDISK_StatisticsGet(DRV_RAMDISK_INDEX_0, &stats);
+    </code>
+
+  Remarks:
+    None.
+*/
+
+bool DRV_RAMDISK_StatisticsGet( const SYS_MODULE_INDEX drvIndex, DRV_RAMDISK_STATISTICS* stats );
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver File System Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+void DRV_RAMDISK_RegisterWithSysFs( const SYS_MODULE_INDEX drvIndex );
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#include "driver/ramdisk/src/drv_ramdisk_local.h"
+
+#endif // #ifndef _DRV_RAMDISK_H
+
+/*******************************************************************************
+ End of File
+*/
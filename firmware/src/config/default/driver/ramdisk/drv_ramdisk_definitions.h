@@ -0,0 +1,161 @@
+/*******************************************************************************
+  RAM Disk Driver Interface Definitions
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk_definitions.h
+
+  Summary:
+    RAM Disk Driver Definitions File
+
+  Description:
+    This file defines the initialization data of the RAM disk driver.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _DRV_RAMDISK_DEFINITIONS_H
+#define _DRV_RAMDISK_DEFINITIONS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: File includes
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+    extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Size of a RAM disk block in bytes. FAT needs 512 byte sectors. */
+#define DRV_RAMDISK_BLOCK_SIZE      (512U)
+
+typedef bool (* DRV_RAMDISK_STORE_READ)(uintptr_t context, uint8_t* buffer, uint32_t blockStart, uint32_t nBlock);
+
+typedef bool (* DRV_RAMDISK_STORE_WRITE)(uintptr_t context, const uint8_t* buffer, uint32_t blockStart, uint32_t nBlock);
+
+// *****************************************************************************
+/* RAM Disk Driver Backing Store Interface
+
+  Summary:
+    Defines the functions used to access an external backing store.
+
+  Description:
+    By default the disk contents are kept in the RAM array given in the
+    initialization data. A backing store replaces the array, for example with
+    a disk image file when the storage stack is built for a host. Both
+    functions are called from DRV_RAMDISK_Tasks and must complete the access
+    before returning. A false return fails the request.
+
+  Remarks:
+    None.
+*/
+
+typedef struct
+{
+    /* Reads nBlock blocks starting at blockStart into buffer */
+    DRV_RAMDISK_STORE_READ      read;
+
+    /* Writes nBlock blocks starting at blockStart from buffer */
+    DRV_RAMDISK_STORE_WRITE     write;
+
+    /* Passed back to both functions */
+    uintptr_t                   context;
+} DRV_RAMDISK_STORE_INTERFACE;
+
+// *****************************************************************************
+/* RAM Disk Driver Initialization Data
+
+  Summary:
+    Defines the data required to initialize the RAM disk driver
+
+  Description:
+    This data type defines the data required to initialize the RAM disk
+    driver. Exactly one of storage and store must be set.
+
+  Remarks:
+    None.
+*/
+
+typedef struct
+{
+    /* RAM array holding numBlocks * DRV_RAMDISK_BLOCK_SIZE bytes, or NULL */
+    uint8_t*                            storage;
+
+    /* External backing store, or NULL */
+    const DRV_RAMDISK_STORE_INTERFACE*  store;
+
+    /* Number of blocks on the disk */
+    uint32_t                            numBlocks;
+
+    /* Memory Pool for Client Objects */
+    uintptr_t                           clientObjPool;
+
+    /* Number of clients */
+    uint32_t                            numClients;
+
+    /* Pointer to the buffer pool */
+    uintptr_t                           bufferObjPool;
+
+    /* Size of buffer objects queue */
+    uint32_t                            bufferObjPoolSize;
+
+    /* Time each read and write request takes to complete, in microseconds */
+    uint32_t                            readLatencyUs;
+    uint32_t                            writeLatencyUs;
+
+    /* Whether the driver should register its services with the file system */
+    bool                                isFsEnabled;
+} DRV_RAMDISK_INIT;
+
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif // #ifndef _DRV_RAMDISK_DEFINITIONS_H
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,675 @@
+/*******************************************************************************
+  RAM Disk Driver Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk.c
+
+  Summary:
+    RAM Disk Driver Implementation
+
+  Description:
+    This file implements a block media driver whose disk is a RAM array or an
+    external backing store. Requests are queued and served one at a time in
+    DRV_RAMDISK_Tasks. Each request is held for the configured latency before
+    the data is copied, so the client sees the same asynchronous behaviour as
+    with the SDMMC driver. All routines must be called from task context.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Include Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include "driver/ramdisk/src/drv_ramdisk_local.h"
+#include "system/time/sys_time.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global objects
+// *****************************************************************************
+// *****************************************************************************
+
+static DRV_RAMDISK_OBJ gDrvRamdiskObj[DRV_RAMDISK_INSTANCES_NUMBER];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver Local Functions
+// *****************************************************************************
+// *****************************************************************************
+
+static inline uint32_t _DRV_RAMDISK_MAKE_HANDLE(uint16_t token, uint8_t drvIndex, uint8_t index)
+{
+    return (((uint32_t)token << 16) | ((uint32_t)drvIndex << 8) | index);
+}
+
+static inline uint16_t _DRV_RAMDISK_UPDATE_TOKEN(uint16_t token)
+{
+    token++;
+
+    if (token >= DRV_RAMDISK_TOKEN_MAX)
+    {
+        token = 1;
+    }
+
+    return token;
+}
+
+static DRV_RAMDISK_OBJ* _DRV_RAMDISK_InstanceGet(const SYS_MODULE_INDEX drvIndex)
+{
+    if ((drvIndex >= DRV_RAMDISK_INSTANCES_NUMBER) || (gDrvRamdiskObj[drvIndex].inUse == false))
+    {
+        return NULL;
+    }
+
+    return &gDrvRamdiskObj[drvIndex];
+}
+
+static DRV_RAMDISK_CLIENT_OBJ* _DRV_RAMDISK_DriverHandleValidate(DRV_HANDLE handle)
+{
+    uint32_t drvInstance;
+    DRV_RAMDISK_OBJ* dObj;
+    DRV_RAMDISK_CLIENT_OBJ* clientObj;
+
+    if ((handle == DRV_HANDLE_INVALID) || (handle == 0U))
+    {
+        return NULL;
+    }
+
+    drvInstance = ((handle & DRV_RAMDISK_INSTANCE_MASK) >> 8);
+    dObj = _DRV_RAMDISK_InstanceGet(drvInstance);
+
+    if ((dObj == NULL) || (dObj->status != SYS_STATUS_READY) ||
+        ((handle & DRV_RAMDISK_INDEX_MASK) >= dObj->nClientsMax))
+    {
+        return NULL;
+    }
+
+    clientObj = &((DRV_RAMDISK_CLIENT_OBJ *)dObj->clientObjPool)[handle & DRV_RAMDISK_INDEX_MASK];
+
+    if ((clientObj->inUse == false) || (clientObj->clientHandle != handle))
+    {
+        return NULL;
+    }
+
+    return clientObj;
+}
+
+static DRV_RAMDISK_BUFFER_OBJ* _DRV_RAMDISK_FreeBufferObjectGet(DRV_RAMDISK_OBJ* dObj, uint32_t drvIndex)
+{
+    uint32_t index;
+    DRV_RAMDISK_BUFFER_OBJ* pBufferObj = (DRV_RAMDISK_BUFFER_OBJ*)dObj->bufferObjPool;
+
+    for (index = 0; index < dObj->bufferObjPoolSize; index++)
+    {
+        if (pBufferObj[index].inUse == false)
+        {
+            pBufferObj[index].inUse = true;
+            pBufferObj[index].next = NULL;
+            pBufferObj[index].commandHandle = (DRV_RAMDISK_COMMAND_HANDLE)_DRV_RAMDISK_MAKE_HANDLE(
+                dObj->bufferToken, (uint8_t)drvIndex, (uint8_t)index);
+
+            dObj->bufferToken = _DRV_RAMDISK_UPDATE_TOKEN(dObj->bufferToken);
+
+            return &pBufferObj[index];
+        }
+    }
+
+    return NULL;
+}
+
+static void _DRV_RAMDISK_BufferObjectAddToList(DRV_RAMDISK_OBJ* dObj, DRV_RAMDISK_BUFFER_OBJ* bufferObj)
+{
+    DRV_RAMDISK_BUFFER_OBJ** pTail = &dObj->bufferObjList;
+
+    while (*pTail != NULL)
+    {
+        pTail = &((*pTail)->next);
+    }
+
+    *pTail = bufferObj;
+}
+
+static void _DRV_RAMDISK_Request(
+    const DRV_HANDLE handle,
+    DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+    void* buffer,
+    uint32_t blockStart,
+    uint32_t nBlock,
+    DRV_RAMDISK_OPERATION_TYPE opType
+)
+{
+    DRV_RAMDISK_CLIENT_OBJ* clientObj;
+    DRV_RAMDISK_OBJ* dObj;
+    DRV_RAMDISK_BUFFER_OBJ* bufferObj;
+    uint32_t numBlocks;
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = DRV_RAMDISK_COMMAND_HANDLE_INVALID;
+    }
+
+    clientObj = _DRV_RAMDISK_DriverHandleValidate(handle);
+
+    if ((clientObj == NULL) || (buffer == NULL) || (nBlock == 0U))
+    {
+        return;
+    }
+
+    if ((opType == DRV_RAMDISK_OPERATION_TYPE_WRITE) &&
+        ((clientObj->ioIntent & DRV_IO_INTENT_WRITE) == 0U))
+    {
+        return;
+    }
+
+    dObj = &gDrvRamdiskObj[clientObj->drvIndex];
+    numBlocks = dObj->mediaGeometryTable[SYS_MEDIA_GEOMETRY_TABLE_READ_ENTRY].numBlocks;
+
+    if ((dObj->isAttached == false) || (blockStart >= numBlocks) || (nBlock > (numBlocks - blockStart)))
+    {
+        return;
+    }
+
+    bufferObj = _DRV_RAMDISK_FreeBufferObjectGet(dObj, clientObj->drvIndex);
+
+    if (bufferObj == NULL)
+    {
+        return;
+    }
+
+    bufferObj->clientHandle = handle;
+    bufferObj->buffer       = (uint8_t*)buffer;
+    bufferObj->blockStart   = blockStart;
+    bufferObj->nBlock       = nBlock;
+    bufferObj->opType       = opType;
+    bufferObj->status       = DRV_RAMDISK_COMMAND_QUEUED;
+
+    if (commandHandle != NULL)
+    {
+        *commandHandle = bufferObj->commandHandle;
+    }
+
+    _DRV_RAMDISK_BufferObjectAddToList(dObj, bufferObj);
+}
+
+/* Returns true if the request is to be failed by the active fault */
+static bool _DRV_RAMDISK_FaultCheck(DRV_RAMDISK_OBJ* dObj, const DRV_RAMDISK_BUFFER_OBJ* bufferObj)
+{
+    DRV_RAMDISK_FAULT* fault = &dObj->fault;
+    uint32_t operation = (bufferObj->opType == DRV_RAMDISK_OPERATION_TYPE_READ) ?
+                            (uint32_t)DRV_RAMDISK_FAULT_READ : (uint32_t)DRV_RAMDISK_FAULT_WRITE;
+
+    if ((fault->failCount == 0U) || ((fault->operations & operation) == 0U))
+    {
+        return false;
+    }
+
+    if ((fault->nBlock != 0U) &&
+        ((bufferObj->blockStart >= (fault->blockStart + fault->nBlock)) ||
+         ((bufferObj->blockStart + bufferObj->nBlock) <= fault->blockStart)))
+    {
+        return false;
+    }
+
+    if (fault->skipCount > 0U)
+    {
+        fault->skipCount--;
+        return false;
+    }
+
+    fault->failCount--;
+    return true;
+}
+
+static bool _DRV_RAMDISK_Transfer(DRV_RAMDISK_OBJ* dObj, const DRV_RAMDISK_BUFFER_OBJ* bufferObj)
+{
+    uint32_t offset = bufferObj->blockStart * DRV_RAMDISK_BLOCK_SIZE;
+    uint32_t numBytes = bufferObj->nBlock * DRV_RAMDISK_BLOCK_SIZE;
+
+    if (dObj->store != NULL)
+    {
+        if (bufferObj->opType == DRV_RAMDISK_OPERATION_TYPE_READ)
+        {
+            return dObj->store->read(dObj->store->context, bufferObj->buffer,
+                                     bufferObj->blockStart, bufferObj->nBlock);
+        }
+
+        return dObj->store->write(dObj->store->context, bufferObj->buffer,
+                                  bufferObj->blockStart, bufferObj->nBlock);
+    }
+
+    if (bufferObj->opType == DRV_RAMDISK_OPERATION_TYPE_READ)
+    {
+        (void) memcpy(bufferObj->buffer, &dObj->storage[offset], numBytes);
+    }
+    else
+    {
+        (void) memcpy(&dObj->storage[offset], bufferObj->buffer, numBytes);
+    }
+
+    return true;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver System Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+SYS_MODULE_OBJ DRV_RAMDISK_Initialize(
+    const SYS_MODULE_INDEX drvIndex,
+    const SYS_MODULE_INIT* const init
+)
+{
+    DRV_RAMDISK_OBJ* dObj;
+    const DRV_RAMDISK_INIT* ramdiskInit = (const DRV_RAMDISK_INIT*)init;
+    uint32_t i;
+
+    if ((drvIndex >= DRV_RAMDISK_INSTANCES_NUMBER) || (ramdiskInit == NULL))
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    dObj = &gDrvRamdiskObj[drvIndex];
+
+    if (dObj->inUse == true)
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    /* Exactly one of the RAM array and the backing store must be given */
+    if ((ramdiskInit->numBlocks == 0U) ||
+        ((ramdiskInit->storage == NULL) == (ramdiskInit->store == NULL)) ||
+        (ramdiskInit->numClients == 0U) || (ramdiskInit->bufferObjPoolSize == 0U))
+    {
+        return SYS_MODULE_OBJ_INVALID;
+    }
+
+    (void) memset(dObj, 0, sizeof(DRV_RAMDISK_OBJ));
+
+    dObj->inUse             = true;
+    dObj->isAttached        = true;
+    dObj->storage           = ramdiskInit->storage;
+    dObj->store             = ramdiskInit->store;
+    dObj->clientObjPool     = ramdiskInit->clientObjPool;
+    dObj->nClientsMax       = ramdiskInit->numClients;
+    dObj->bufferObjPool     = ramdiskInit->bufferObjPool;
+    dObj->bufferObjPoolSize = ramdiskInit->bufferObjPoolSize;
+    dObj->bufferObjList     = NULL;
+    dObj->clientToken       = 1;
+    dObj->bufferToken       = 1;
+    dObj->readLatencyCount  = SYS_TIME_USToCount(ramdiskInit->readLatencyUs);
+    dObj->writeLatencyCount = SYS_TIME_USToCount(ramdiskInit->writeLatencyUs);
+
+    (void) memset((void*)dObj->clientObjPool, 0, sizeof(DRV_RAMDISK_CLIENT_OBJ) * dObj->nClientsMax);
+    (void) memset((void*)dObj->bufferObjPool, 0, sizeof(DRV_RAMDISK_BUFFER_OBJ) * dObj->bufferObjPoolSize);
+
+    for (i = 0; i <= SYS_MEDIA_GEOMETRY_TABLE_ERASE_ENTRY; i++)
+    {
+        dObj->mediaGeometryTable[i].blockSize = DRV_RAMDISK_BLOCK_SIZE;
+        dObj->mediaGeometryTable[i].numBlocks = ramdiskInit->numBlocks;
+    }
+
+    dObj->mediaGeometryObj.numReadRegions  = 1;
+    dObj->mediaGeometryObj.numWriteRegions = 1;
+    dObj->mediaGeometryObj.numEraseRegions = 1;
+    dObj->mediaGeometryObj.geometryTable   = dObj->mediaGeometryTable;
+
+    if (ramdiskInit->isFsEnabled == true)
+    {
+        DRV_RAMDISK_RegisterWithSysFs(drvIndex);
+    }
+
+    dObj->status = SYS_STATUS_READY;
+
+    return ((SYS_MODULE_OBJ)drvIndex);
+}
+
+SYS_STATUS DRV_RAMDISK_Status( SYS_MODULE_OBJ object )
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet((SYS_MODULE_INDEX)object);
+
+    if (dObj == NULL)
+    {
+        return SYS_STATUS_UNINITIALIZED;
+    }
+
+    return dObj->status;
+}
+
+void DRV_RAMDISK_Tasks( SYS_MODULE_OBJ object )
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet((SYS_MODULE_INDEX)object);
+    DRV_RAMDISK_BUFFER_OBJ* bufferObj;
+    DRV_RAMDISK_CLIENT_OBJ* clientObj;
+    uint32_t latency;
+    bool isSuccess;
+
+    if ((dObj == NULL) || (dObj->bufferObjList == NULL))
+    {
+        return;
+    }
+
+    bufferObj = dObj->bufferObjList;
+
+    if (bufferObj->opType == DRV_RAMDISK_OPERATION_TYPE_READ)
+    {
+        latency = dObj->readLatencyCount;
+    }
+    else
+    {
+        latency = dObj->writeLatencyCount;
+    }
+
+    if (bufferObj->status == DRV_RAMDISK_COMMAND_QUEUED)
+    {
+        bufferObj->status = DRV_RAMDISK_COMMAND_IN_PROGRESS;
+        bufferObj->startCount = SYS_TIME_CounterGet();
+    }
+
+    if ((SYS_TIME_CounterGet() - bufferObj->startCount) < latency)
+    {
+        return;
+    }
+
+    isSuccess = ((dObj->isAttached == true) &&
+                 (_DRV_RAMDISK_FaultCheck(dObj, bufferObj) == false) &&
+                 (_DRV_RAMDISK_Transfer(dObj, bufferObj) == true));
+
+    if (bufferObj->opType == DRV_RAMDISK_OPERATION_TYPE_READ)
+    {
+        dObj->stats.readCommands++;
+        dObj->stats.blocksRead += (isSuccess == true) ? bufferObj->nBlock : 0U;
+    }
+    else
+    {
+        dObj->stats.writeCommands++;
+        dObj->stats.blocksWritten += (isSuccess == true) ? bufferObj->nBlock : 0U;
+    }
+
+    if (isSuccess == false)
+    {
+        dObj->stats.failedCommands++;
+    }
+
+    bufferObj->status = (isSuccess == true) ? DRV_RAMDISK_COMMAND_COMPLETED : DRV_RAMDISK_COMMAND_ERROR_UNKNOWN;
+
+    /* Free the buffer object before the callback so the client can queue
+     * its next request from the event handler. */
+    dObj->bufferObjList = bufferObj->next;
+    bufferObj->inUse = false;
+
+    clientObj = &((DRV_RAMDISK_CLIENT_OBJ *)dObj->clientObjPool)[bufferObj->clientHandle & DRV_RAMDISK_INDEX_MASK];
+
+    if ((clientObj->inUse == true) && (clientObj->eventHandler != NULL))
+    {
+        clientObj->eventHandler(
+            (isSuccess == true) ? (SYS_MEDIA_BLOCK_EVENT)DRV_RAMDISK_EVENT_COMMAND_COMPLETE :
+                                  (SYS_MEDIA_BLOCK_EVENT)DRV_RAMDISK_EVENT_COMMAND_ERROR,
+            bufferObj->commandHandle, clientObj->context);
+    }
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver Client Routines
+// *****************************************************************************
+// *****************************************************************************
+
+DRV_HANDLE DRV_RAMDISK_Open(
+    const SYS_MODULE_INDEX drvIndex,
+    const DRV_IO_INTENT ioIntent
+)
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet(drvIndex);
+    DRV_RAMDISK_CLIENT_OBJ* clientObj;
+    uint32_t iClient;
+
+    if ((dObj == NULL) || (dObj->status != SYS_STATUS_READY))
+    {
+        return DRV_HANDLE_INVALID;
+    }
+
+    for (iClient = 0; iClient < dObj->nClientsMax; iClient++)
+    {
+        clientObj = &((DRV_RAMDISK_CLIENT_OBJ *)dObj->clientObjPool)[iClient];
+
+        if (clientObj->inUse == false)
+        {
+            clientObj->inUse        = true;
+            clientObj->drvIndex     = drvIndex;
+            clientObj->ioIntent     = ioIntent;
+            clientObj->eventHandler = NULL;
+            clientObj->context      = (uintptr_t)NULL;
+            clientObj->clientHandle = (DRV_HANDLE)_DRV_RAMDISK_MAKE_HANDLE(dObj->clientToken,
+                                                    (uint8_t)drvIndex, (uint8_t)iClient);
+
+            dObj->clientToken = _DRV_RAMDISK_UPDATE_TOKEN(dObj->clientToken);
+
+            return clientObj->clientHandle;
+        }
+    }
+
+    return DRV_HANDLE_INVALID;
+}
+
+void DRV_RAMDISK_Close( const DRV_HANDLE handle )
+{
+    DRV_RAMDISK_CLIENT_OBJ* clientObj = _DRV_RAMDISK_DriverHandleValidate(handle);
+    DRV_RAMDISK_OBJ* dObj;
+    DRV_RAMDISK_BUFFER_OBJ** pBufferObj;
+
+    if (clientObj == NULL)
+    {
+        return;
+    }
+
+    dObj = &gDrvRamdiskObj[clientObj->drvIndex];
+
+    /* Drop the client's queued requests */
+    pBufferObj = &dObj->bufferObjList;
+
+    while (*pBufferObj != NULL)
+    {
+        if ((*pBufferObj)->clientHandle == handle)
+        {
+            (*pBufferObj)->inUse = false;
+            *pBufferObj = (*pBufferObj)->next;
+        }
+        else
+        {
+            pBufferObj = &((*pBufferObj)->next);
+        }
+    }
+
+    clientObj->inUse = false;
+}
+
+void DRV_RAMDISK_AsyncRead(
+    const DRV_HANDLE handle,
+    DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+    void* targetBuffer,
+    uint32_t blockStart,
+    uint32_t nBlock
+)
+{
+    _DRV_RAMDISK_Request(handle, commandHandle, targetBuffer, blockStart, nBlock,
+                         DRV_RAMDISK_OPERATION_TYPE_READ);
+}
+
+void DRV_RAMDISK_AsyncWrite(
+    const DRV_HANDLE handle,
+    DRV_RAMDISK_COMMAND_HANDLE* commandHandle,
+    void* sourceBuffer,
+    uint32_t blockStart,
+    uint32_t nBlock
+)
+{
+    _DRV_RAMDISK_Request(handle, commandHandle, sourceBuffer, blockStart, nBlock,
+                         DRV_RAMDISK_OPERATION_TYPE_WRITE);
+}
+
+DRV_RAMDISK_COMMAND_STATUS DRV_RAMDISK_CommandStatus(
+    const DRV_HANDLE handle,
+    const DRV_RAMDISK_COMMAND_HANDLE commandHandle
+)
+{
+    DRV_RAMDISK_CLIENT_OBJ* clientObj = _DRV_RAMDISK_DriverHandleValidate(handle);
+    DRV_RAMDISK_OBJ* dObj;
+    DRV_RAMDISK_BUFFER_OBJ* bufferPool;
+    uint32_t bufferIndex;
+
+    if ((clientObj == NULL) || (commandHandle == DRV_RAMDISK_COMMAND_HANDLE_INVALID))
+    {
+        return DRV_RAMDISK_COMMAND_ERROR_UNKNOWN;
+    }
+
+    dObj = &gDrvRamdiskObj[clientObj->drvIndex];
+    bufferPool = (DRV_RAMDISK_BUFFER_OBJ*)dObj->bufferObjPool;
+    bufferIndex = commandHandle & DRV_RAMDISK_INDEX_MASK;
+
+    if (bufferIndex >= dObj->bufferObjPoolSize)
+    {
+        return DRV_RAMDISK_COMMAND_ERROR_UNKNOWN;
+    }
+
+    if (bufferPool[bufferIndex].commandHandle == commandHandle)
+    {
+        return bufferPool[bufferIndex].status;
+    }
+
+    /* The buffer object has been reused, so the command has completed */
+    return DRV_RAMDISK_COMMAND_COMPLETED;
+}
+
+SYS_MEDIA_GEOMETRY* DRV_RAMDISK_GeometryGet( const DRV_HANDLE handle )
+{
+    DRV_RAMDISK_CLIENT_OBJ* clientObj = _DRV_RAMDISK_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return NULL;
+    }
+
+    return &gDrvRamdiskObj[clientObj->drvIndex].mediaGeometryObj;
+}
+
+void DRV_RAMDISK_EventHandlerSet(
+    const DRV_HANDLE handle,
+    const void* eventHandler,
+    const uintptr_t context
+)
+{
+    DRV_RAMDISK_CLIENT_OBJ* clientObj = _DRV_RAMDISK_DriverHandleValidate(handle);
+
+    if (clientObj != NULL)
+    {
+        clientObj->eventHandler = (DRV_RAMDISK_EVENT_HANDLER)eventHandler;
+        clientObj->context = context;
+    }
+}
+
+bool DRV_RAMDISK_IsAttached( const DRV_HANDLE handle )
+{
+    DRV_RAMDISK_CLIENT_OBJ* clientObj = _DRV_RAMDISK_DriverHandleValidate(handle);
+
+    if (clientObj == NULL)
+    {
+        return false;
+    }
+
+    return gDrvRamdiskObj[clientObj->drvIndex].isAttached;
+}
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver Test Routines
+// *****************************************************************************
+// *****************************************************************************
+
+void DRV_RAMDISK_AttachSet( const SYS_MODULE_INDEX drvIndex, bool isAttached )
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet(drvIndex);
+
+    if (dObj != NULL)
+    {
+        dObj->isAttached = isAttached;
+    }
+}
+
+void DRV_RAMDISK_LatencySet( const SYS_MODULE_INDEX drvIndex, uint32_t readLatencyUs, uint32_t writeLatencyUs )
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet(drvIndex);
+
+    if (dObj != NULL)
+    {
+        dObj->readLatencyCount = SYS_TIME_USToCount(readLatencyUs);
+        dObj->writeLatencyCount = SYS_TIME_USToCount(writeLatencyUs);
+    }
+}
+
+void DRV_RAMDISK_FaultSet( const SYS_MODULE_INDEX drvIndex, const DRV_RAMDISK_FAULT* fault )
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet(drvIndex);
+
+    if (dObj == NULL)
+    {
+        return;
+    }
+
+    if (fault == NULL)
+    {
+        (void) memset(&dObj->fault, 0, sizeof(DRV_RAMDISK_FAULT));
+    }
+    else
+    {
+        dObj->fault = *fault;
+    }
+}
+
+bool DRV_RAMDISK_StatisticsGet( const SYS_MODULE_INDEX drvIndex, DRV_RAMDISK_STATISTICS* stats )
+{
+    DRV_RAMDISK_OBJ* dObj = _DRV_RAMDISK_InstanceGet(drvIndex);
+
+    if ((dObj == NULL) || (stats == NULL))
+    {
+        return false;
+    }
+
+    *stats = dObj->stats;
+
+    return true;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,93 @@
+/******************************************************************************
+  RAM Disk Driver File System Interface Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk_file_system.c
+
+  Summary:
+    RAM Disk Driver File System Interface Implementation
+
+  Description:
+    This file registers the RAM Disk Driver capabilities with the file system
+    interface.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Include Files
+// *****************************************************************************
+// *****************************************************************************
+// *****************************************************************************
+// Section: Include Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "driver/ramdisk/drv_ramdisk.h"
+#include "system/fs/sys_fs_media_manager.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global objects
+// *****************************************************************************
+// *****************************************************************************
+
+/* FS Function registration table. */
+typedef SYS_FS_MEDIA_COMMAND_STATUS (* RamdiskCommandStatusGetType)( DRV_HANDLE, SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE );
+
+static const SYS_FS_MEDIA_FUNCTIONS ramdiskMediaFunctions =
+{
+    .mediaStatusGet     = DRV_RAMDISK_IsAttached,
+    .mediaGeometryGet   = DRV_RAMDISK_GeometryGet,
+    .sectorRead         = DRV_RAMDISK_AsyncRead,
+    .sectorWrite        = DRV_RAMDISK_AsyncWrite,
+    .eventHandlerset    = DRV_RAMDISK_EventHandlerSet,
+    .commandStatusGet   = (RamdiskCommandStatusGetType)DRV_RAMDISK_CommandStatus,
+    .open               = DRV_RAMDISK_Open,
+    .close              = DRV_RAMDISK_Close,
+    .tasks              = DRV_RAMDISK_Tasks
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: RAM Disk Driver File system interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+void DRV_RAMDISK_RegisterWithSysFs( const SYS_MODULE_INDEX drvIndex )
+{
+    SYS_FS_MEDIA_MANAGER_Register
+    (
+        (SYS_MODULE_OBJ)drvIndex,
+        (SYS_MODULE_INDEX)drvIndex,
+        &ramdiskMediaFunctions,
+        SYS_FS_MEDIA_TYPE_RAM
+    );
+}
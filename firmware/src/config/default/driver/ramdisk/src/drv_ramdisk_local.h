@@ -0,0 +1,181 @@
+/*******************************************************************************
+  RAM Disk Driver Local Data Structures
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_ramdisk_local.h
+
+  Summary:
+    RAM Disk driver local declarations and definitions
+
+  Description:
+    This file contains the RAM disk driver's local declarations and
+    definitions.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2023 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _DRV_RAMDISK_LOCAL_H
+#define _DRV_RAMDISK_LOCAL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "configuration.h"
+#include "driver/ramdisk/drv_ramdisk.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Helper Macros
+// *****************************************************************************
+// *****************************************************************************
+
+/* RAM Disk Driver Handle Macros*/
+#define DRV_RAMDISK_INDEX_MASK                 (0x000000FF)
+#define DRV_RAMDISK_INSTANCE_MASK              (0x0000FF00)
+#define DRV_RAMDISK_TOKEN_MAX                  (0xFFFF)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Type Definitions
+// *****************************************************************************
+// *****************************************************************************
+
+typedef enum
+{
+    DRV_RAMDISK_OPERATION_TYPE_READ,
+
+    DRV_RAMDISK_OPERATION_TYPE_WRITE,
+
+} DRV_RAMDISK_OPERATION_TYPE;
+
+typedef struct
+{
+    /* Indicates whether the client object is in use */
+    bool                            inUse;
+
+    /* Index of the driver instance the client belongs to */
+    uint32_t                        drvIndex;
+
+    /* Client handle returned by DRV_RAMDISK_Open */
+    DRV_HANDLE                      clientHandle;
+
+    /* Intent the client was opened with */
+    DRV_IO_INTENT                   ioIntent;
+
+    /* Client's event handler and its context */
+    DRV_RAMDISK_EVENT_HANDLER       eventHandler;
+    uintptr_t                       context;
+
+} DRV_RAMDISK_CLIENT_OBJ;
+
+typedef struct _DRV_RAMDISK_BUFFER_OBJ
+{
+    /* Indicates whether the buffer object is in use */
+    bool                            inUse;
+
+    /* Handle of the client that queued the request */
+    DRV_HANDLE                      clientHandle;
+
+    /* Handle returned to the client */
+    DRV_RAMDISK_COMMAND_HANDLE      commandHandle;
+
+    /* Client's buffer */
+    uint8_t*                        buffer;
+
+    /* First block and number of blocks */
+    uint32_t                        blockStart;
+    uint32_t                        nBlock;
+
+    /* Read or write */
+    DRV_RAMDISK_OPERATION_TYPE      opType;
+
+    /* Current status of the request */
+    DRV_RAMDISK_COMMAND_STATUS      status;
+
+    /* SYS_TIME counter when the request reached the head of the queue */
+    uint32_t                        startCount;
+
+    /* Next request in the queue */
+    struct _DRV_RAMDISK_BUFFER_OBJ* next;
+
+} DRV_RAMDISK_BUFFER_OBJ;
+
+typedef struct
+{
+    /* Indicates whether the instance is in use */
+    bool                            inUse;
+
+    /* Status of the instance */
+    SYS_STATUS                      status;
+
+    /* Simulated card presence */
+    bool                            isAttached;
+
+    /* Disk contents, used when store is NULL */
+    uint8_t*                        storage;
+
+    /* External backing store */
+    const DRV_RAMDISK_STORE_INTERFACE* store;
+
+    /* Client object pool */
+    uintptr_t                       clientObjPool;
+    uint32_t                        nClientsMax;
+
+    /* Buffer object pool and request queue */
+    uintptr_t                       bufferObjPool;
+    uint32_t                        bufferObjPoolSize;
+    DRV_RAMDISK_BUFFER_OBJ*         bufferObjList;
+
+    /* Tokens used to build unique client and command handles */
+    uint16_t                        clientToken;
+    uint16_t                        bufferToken;
+
+    /* Latency of each request in SYS_TIME counts */
+    uint32_t                        readLatencyCount;
+    uint32_t                        writeLatencyCount;
+
+    /* Active fault, with skipCount and failCount counting down */
+    DRV_RAMDISK_FAULT               fault;
+
+    DRV_RAMDISK_STATISTICS          stats;
+
+    /* Media geometry, one region each for read, write and erase */
+    SYS_MEDIA_REGION_GEOMETRY       mediaGeometryTable[3];
+    SYS_MEDIA_GEOMETRY              mediaGeometryObj;
+
+} DRV_RAMDISK_OBJ;
+
+#endif // #ifndef _DRV_RAMDISK_LOCAL_H
+
+/*******************************************************************************
+ End of File
+*/
@@ -240,6 +240,42 @@ typedef enum
 */
 typedef SYS_MEDIA_EVENT_HANDLER DRV_SDMMC_EVENT_HANDLER;
 
+// *****************************************************************************
+/* SDMMC Driver Bus Information
+
+   Summary
+    Reports the negotiated bus mode and the measured throughput.
+
+   Description
+    This structure is filled by the DRV_SDMMC_BusInfoGet routine.
+
+    bytesPerSecond is computed from the data moved by all completed read and
+    write requests and the time from the start of their data transfer until
+    the card was ready again, so it includes the card's programming time.
+
+   Remarks:
+    None.
+*/
+typedef struct
+{
+    /* Bus mode in use: Default Speed or High Speed */
+    DRV_SDMMC_SPEED_MODE    speedMode;
+
+    /* Bus clock frequency in Hz */
+    uint32_t                busClock;
+
+    /* Number of times the card was switched back to Default Speed after
+     * failing in High Speed mode */
+    uint32_t                speedFallbacks;
+
+    /* Bytes moved by completed requests */
+    uint64_t                bytesTransferred;
+
+    /* Average throughput of completed requests, in bytes per second */
+    uint32_t                bytesPerSecond;
+
+} DRV_SDMMC_BUS_INFO;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Interface Routines - System Level
@@ -1066,6 +1102,67 @@ bool DRV_SDMMC_IsWriteProtected
     const DRV_HANDLE handle
 );
 
+// *****************************************************************************
+/* Function:
+    bool DRV_SDMMC_BusInfoGet (
+        const DRV_HANDLE handle,
+        DRV_SDMMC_BUS_INFO* busInfo
+    );
+
+  Summary:
+    Returns the bus mode and the measured throughput of the SDMMC.
+
+  Description:
+    This function returns the bus mode negotiated with the attached card, the
+    bus clock and the throughput measured over all completed requests.
+
+    When the driver is configured for High Speed mode, it switches the card
+    to High Speed with CMD6 if the card supports it. If the card then fails a
+    transfer with a CRC or timeout error, the driver reinitializes it at
+    Default Speed, retries the request and keeps the card at Default Speed
+    until it is removed.
+
+  Precondition:
+    The DRV_SDMMC_Initialize routine must have been called for the specified
+    SDMMC driver instance.
+
+    The DRV_SDMMC_Open routine must have been called to obtain a valid opened
+    device handle.
+
+  Parameters:
+    handle       - A valid open-instance handle, returned from the driver's
+                   open function
+
+    busInfo      - Pointer to the structure that receives the information
+
+  Returns:
+    Returns true if a card is attached and busInfo was updated.
+
+    Returns false if the handle is not valid or no card is attached.
+  Example:
+    <code>
+
+    DRV_SDMMC_BUS_INFO busInfo;
+
+    if (DRV_SDMMC_BusInfoGet(drvSDMMCHandle, &busInfo) == true)
+    {
+        printf("%s, %lu B/s\r\n",
+               (busInfo.speedMode == DRV_SDMMC_SPEED_MODE_HIGH) ? "HS" : "DS",
+               busInfo.bytesPerSecond);
+    }
+
+    </code>
+
+  Remarks:
+    None.
+*/
+
+bool DRV_SDMMC_BusInfoGet
+(
+    const DRV_HANDLE handle,
+    DRV_SDMMC_BUS_INFO* busInfo
+);
+
 #ifdef __cplusplus
 }
 #endif
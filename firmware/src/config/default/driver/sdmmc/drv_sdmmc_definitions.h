@@ -156,6 +156,14 @@ typedef struct
 
 }DRV_SDMMC_DataTransferFlags;
 
+/* One buffer of a scatter-gather transfer. Matches SDHC_DMA_SEGMENT. */
+typedef struct
+{
+    uint8_t*                              buffer;
+    uint32_t                              numBytes;
+
+}DRV_SDMMC_DMA_SEGMENT;
+
 typedef  void (*DRV_SDMMC_CALLBACK) (DRV_SDMMC_XFER_STATUS xferStatus, uintptr_t context);
 
 typedef void (*DRV_SDMMC_PLIB_CALLBACK_REGISTER)(DRV_SDMMC_CALLBACK callback, uintptr_t context);
@@ -176,6 +184,7 @@ typedef void (*DRV_SDMMC_PLIB_SET_BLOCK_SIZE)(uint16_t blockSize );
 typedef void (*DRV_SDMMC_PLIB_SET_BUS_WIDTH)(DRV_SDMMC_BUS_WIDTH busWidth);
 typedef void (*DRV_SDMMC_PLIB_SET_SPEED_MODE)(DRV_SDMMC_SPEED_MODE speedMode );
 typedef void (*DRV_SDMMC_PLIB_SETUP_DMA)( uint8_t* buffer, uint32_t numBytes, DRV_SDMMC_OPERATION_TYPE operation);
+typedef bool (*DRV_SDMMC_PLIB_SETUP_DMA_CHAIN)( const DRV_SDMMC_DMA_SEGMENT* segments, uint32_t numSegments, DRV_SDMMC_OPERATION_TYPE operation);
 typedef bool (*DRV_SDMMC_PLIB_IS_CARD_ATTACHED)( void );
 typedef bool (*DRV_SDMMC_PLIB_IS_WRITE_PROTECTED)( void );
 typedef uint16_t (*DRV_SDMMC_PLIB_GET_COMMAND_ERROR)(void);
@@ -210,6 +219,7 @@ typedef struct
     DRV_SDMMC_PLIB_SET_BUS_WIDTH                 sdhostSetBusWidth;
     DRV_SDMMC_PLIB_SET_SPEED_MODE                sdhostSetSpeedMode;
     DRV_SDMMC_PLIB_SETUP_DMA                     sdhostSetupDma;
+    DRV_SDMMC_PLIB_SETUP_DMA_CHAIN               sdhostSetupDmaChain;
     DRV_SDMMC_PLIB_IS_CARD_ATTACHED              sdhostIsCardAttached;
     DRV_SDMMC_PLIB_IS_WRITE_PROTECTED            sdhostIsWriteProtected;
     DRV_SDMMC_PLIB_GET_COMMAND_ERROR             sdhostGetCommandError;
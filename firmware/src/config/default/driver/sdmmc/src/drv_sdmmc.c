@@ -216,6 +216,127 @@ static void _DRV_SDMMC_RemoveBufferObjFromList(
     }
 }
 
+/* Merges the write requests queued behind bufferObj into its transfer, as
+ * long as they continue it on the card. Without DMA chain support they must
+ * also continue it in memory. The merged buffer objects stay in the list and
+ * are completed together with bufferObj. */
+static void _DRV_SDMMC_WriteMerge(
+    DRV_SDMMC_OBJ* dObj,
+    DRV_SDMMC_BUFFER_OBJ* bufferObj
+)
+{
+    DRV_SDMMC_BUFFER_OBJ* lastBufferObj = bufferObj;
+    DRV_SDMMC_BUFFER_OBJ* nextBufferObj = bufferObj->next;
+    uint32_t nSegments = 1;
+    bool isContiguous;
+
+    while ((nextBufferObj != NULL) &&
+           (nextBufferObj->status == DRV_SDMMC_COMMAND_QUEUED) &&
+           (nextBufferObj->opType == DRV_SDMMC_OPERATION_TYPE_WRITE) &&
+           (nextBufferObj->clientHandle == bufferObj->clientHandle) &&
+           (nextBufferObj->blockStart == (bufferObj->blockStart + bufferObj->xferBlocks)) &&
+           ((bufferObj->xferBlocks + nextBufferObj->nBlocks) <= DRV_SDMMC_MAX_XFER_BLOCKS))
+    {
+        isContiguous = (nextBufferObj->buffer == (lastBufferObj->buffer + (lastBufferObj->nBlocks << 9)));
+
+        if (isContiguous == false)
+        {
+            if ((dObj->sdmmcPlib->sdhostSetupDmaChain == NULL) ||
+                (nSegments >= DRV_SDMMC_MAX_DMA_SEGMENTS))
+            {
+                break;
+            }
+            nSegments++;
+        }
+
+        /* Keep the merged request from being removed as a queued one */
+        nextBufferObj->status = DRV_SDMMC_COMMAND_IN_PROGRESS;
+
+        bufferObj->xferBlocks += nextBufferObj->nBlocks;
+        bufferObj->nMerged++;
+
+        lastBufferObj = nextBufferObj;
+        nextBufferObj = nextBufferObj->next;
+    }
+}
+
+/* Describes the buffers of the current transfer to the PLIB as a DMA chain.
+ * Buffers that follow each other in memory share a segment. */
+static bool _DRV_SDMMC_SetupDmaChain(
+    DRV_SDMMC_OBJ* dObj,
+    DRV_SDMMC_BUFFER_OBJ* bufferObj
+)
+{
+    DRV_SDMMC_DMA_SEGMENT* segment = &dObj->dmaSegments[0];
+    DRV_SDMMC_OPERATION_TYPE opType = bufferObj->opType;
+    uint32_t nSegments = 1;
+    uint32_t nMerged = bufferObj->nMerged;
+
+    segment->buffer = bufferObj->buffer;
+    segment->numBytes = (bufferObj->nBlocks << 9);
+
+    for (bufferObj = bufferObj->next; (nMerged > 0) && (bufferObj != NULL); bufferObj = bufferObj->next)
+    {
+        if (bufferObj->buffer != (segment->buffer + segment->numBytes))
+        {
+            if (nSegments >= DRV_SDMMC_MAX_DMA_SEGMENTS)
+            {
+                return false;
+            }
+            segment++;
+            nSegments++;
+            segment->buffer = bufferObj->buffer;
+            segment->numBytes = 0;
+        }
+
+        segment->numBytes += (bufferObj->nBlocks << 9);
+        nMerged--;
+    }
+
+    return dObj->sdmmcPlib->sdhostSetupDmaChain (&dObj->dmaSegments[0], nSegments, opType);
+}
+
+/* Returns a request that failed at High Speed to the queue, undoing the
+ * changes made when it was started. */
+static void _DRV_SDMMC_BufferRequeue(
+    DRV_SDMMC_OBJ* dObj,
+    DRV_SDMMC_BUFFER_OBJ* bufferObj
+)
+{
+    DRV_SDMMC_BUFFER_OBJ* nextBufferObj = bufferObj->next;
+
+    while ((bufferObj->nMerged > 0) && (nextBufferObj != NULL))
+    {
+        nextBufferObj->status = DRV_SDMMC_COMMAND_QUEUED;
+        nextBufferObj = nextBufferObj->next;
+        bufferObj->nMerged--;
+    }
+
+    if (dObj->cardCtxt.cardType == DRV_SDMMC_CARD_TYPE_STANDARD)
+    {
+        /* Back from byte address to block address */
+        bufferObj->blockStart >>= 9;
+    }
+
+    bufferObj->xferBlocks = bufferObj->nBlocks;
+    bufferObj->nMerged = 0;
+    bufferObj->status = DRV_SDMMC_COMMAND_QUEUED;
+}
+
+/* Returns true if an error on a data transfer should make the driver fall
+ * back to Default Speed. Only CRC and timeout errors at High Speed do. */
+static bool _DRV_SDMMC_IsHighSpeedFailure(
+    DRV_SDMMC_OBJ* dObj,
+    bool isCrcOrTimeoutError
+)
+{
+    /* A removed card fails the same way. Leave that to detach handling. */
+    return ((isCrcOrTimeoutError == true) &&
+            (dObj->cardCtxt.currentSpeed > DRV_SDMMC_CLOCK_FREQ_DS_26_MHZ) &&
+            (dObj->cardDetectionMethod == DRV_SDMMC_CD_METHOD_USE_SDCD) &&
+            (dObj->sdmmcPlib->sdhostIsCardAttached () == true));
+}
+
 static void _DRV_SDMMC_RemoveClientBuffersFromList(
     DRV_SDMMC_OBJ* dObj,
     DRV_SDMMC_CLIENT_OBJ* clientObj
@@ -1169,7 +1290,8 @@ static void _DRV_SDMMC_MediaInitialize (
             /* SD card and Host supports HS mode */
             if ((dObj->protocol == DRV_SDMMC_PROTOCOL_SD) &&
                 (dObj->cardCtxt.scrBuffer[0] & 0x0F) &&
-                (dObj->speedMode == DRV_SDMMC_SPEED_MODE_HIGH))
+                (dObj->speedMode == DRV_SDMMC_SPEED_MODE_HIGH) &&
+                (dObj->isHighSpeedDisabled == false))
             {
                 /* Card follows SD Spec version 1.10 or higher */
                 dObj->cardCtxt.cmd6Mode = 0;
@@ -1220,7 +1342,8 @@ static void _DRV_SDMMC_MediaInitialize (
                 }
                 else
                 {
-                    /* Command execution failed. */
+                    /* Command execution failed. Start over without CMD6. */
+                    dObj->isHighSpeedDisabled = true;
                     dObj->initState = DRV_SDMMC_INIT_ERROR;
                 }
             }
@@ -1233,6 +1356,8 @@ static void _DRV_SDMMC_MediaInitialize (
                 /* Check if there are any data errors. */
                 if (dObj->cardCtxt.errorFlag & DRV_SDMMC_ANY_DATA_ERRORS)
                 {
+                    /* Start over without CMD6 */
+                    dObj->isHighSpeedDisabled = true;
                     dObj->initState = DRV_SDMMC_INIT_ERROR;
                 }
                 else
@@ -1248,7 +1373,8 @@ static void _DRV_SDMMC_MediaInitialize (
                         }
                         else
                         {
-                            dObj->initState = DRV_SDMMC_INIT_DONE;
+                            /* Stay at Default Speed */
+                            dObj->initState = DRV_SDMMC_INIT_SET_BLOCK_LENGTH;
                         }
                     }
                     else
@@ -1262,7 +1388,8 @@ static void _DRV_SDMMC_MediaInitialize (
                         }
                         else
                         {
-                            dObj->initState = DRV_SDMMC_INIT_DONE;
+                            /* Stay at Default Speed */
+                            dObj->initState = DRV_SDMMC_INIT_SET_BLOCK_LENGTH;
                         }
                     }
                 }
@@ -1308,6 +1435,9 @@ static void _DRV_SDMMC_MediaInitialize (
             }
             else
             {
+                /* The card is already in High Speed timing. Reset it and
+                 * start over at Default Speed. */
+                dObj->isHighSpeedDisabled = true;
                 dObj->initState = DRV_SDMMC_INIT_ERROR;
             }
             break;
@@ -1423,6 +1553,10 @@ SYS_MODULE_OBJ DRV_SDMMC_Initialize (
     dObj->isExclusive                       = false;
     dObj->isCmdTimerExpired                 = false;
     dObj->sleepWhenIdle                     = sdmmcInit->sleepWhenIdle;
+    dObj->isHighSpeedDisabled               = false;
+    dObj->speedFallbacks                    = 0;
+    dObj->bytesTransferred                  = 0;
+    dObj->xferBusyCount                     = 0;
 
     /* Register a callback with the underlying SDMMC PLIB */
     dObj->sdmmcPlib->sdhostCallbackRegister(_DRV_SDMMC_PlibCallbackHandler, (uintptr_t)dObj);
@@ -1645,6 +1779,8 @@ void DRV_SDMMC_SetupXfer(
         bufferObj->buffer        = buffer;
         bufferObj->blockStart    = blockStart;
         bufferObj->nBlocks       = nBlocks;
+        bufferObj->xferBlocks    = nBlocks;
+        bufferObj->nMerged       = 0;
         bufferObj->opType        = opType;
         bufferObj->status        = DRV_SDMMC_COMMAND_QUEUED;
 
@@ -1825,12 +1961,52 @@ bool DRV_SDMMC_IsWriteProtected (
     return isWriteProtected;
 }
 
+bool DRV_SDMMC_BusInfoGet (
+    const DRV_HANDLE handle,
+    DRV_SDMMC_BUS_INFO* busInfo
+)
+{
+    DRV_SDMMC_CLIENT_OBJ* clientObj = NULL;
+    DRV_SDMMC_OBJ* dObj = NULL;
+    uint64_t busyUs;
+
+    if (busInfo == NULL)
+    {
+        return false;
+    }
+
+    clientObj = _DRV_SDMMC_DriverHandleValidate (handle);
+    if (clientObj == NULL)
+    {
+        return false;
+    }
+
+    dObj = (DRV_SDMMC_OBJ* )&gDrvSDMMCObj[clientObj->drvIndex];
+    if (dObj->mediaState != SYS_MEDIA_ATTACHED)
+    {
+        return false;
+    }
+
+    busInfo->speedMode = (dObj->cardCtxt.currentSpeed > DRV_SDMMC_CLOCK_FREQ_DS_26_MHZ) ?
+                            DRV_SDMMC_SPEED_MODE_HIGH : DRV_SDMMC_SPEED_MODE_DEFAULT;
+    busInfo->busClock = dObj->cardCtxt.currentSpeed;
+    busInfo->speedFallbacks = dObj->speedFallbacks;
+    busInfo->bytesTransferred = dObj->bytesTransferred;
+
+    busyUs = (dObj->xferBusyCount * 1000000U) / SYS_TIME_FrequencyGet();
+    busInfo->bytesPerSecond = (busyUs == 0U) ? 0U : (uint32_t)((dObj->bytesTransferred * 1000000U) / busyUs);
+
+    return true;
+}
+
 void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
 {
     DRV_SDMMC_OBJ* dObj = NULL;
     DRV_SDMMC_CLIENT_OBJ* clientObj = NULL;
     DRV_SDMMC_BUFFER_OBJ* currentBufObj = NULL;
     DRV_SDMMC_EVENT evtStatus = DRV_SDMMC_EVENT_COMMAND_COMPLETE;
+    DRV_SDMMC_COMMAND_STATUS xferStatus = DRV_SDMMC_COMMAND_COMPLETED;
+    uint32_t nMerged = 0;
     uint32_t response = 0;
     static bool cardAttached = true;
 
@@ -1947,7 +2123,15 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                     /* SDCD# pin is available only on SDHC PLIB */
                     if (dObj->sdmmcPlib->sdhostIsCardAttached() == false)
                     {
-                        dObj->taskState = DRV_SDMMC_TASK_WAIT_FOR_DEVICE_ATTACH;
+                        if (dObj->mediaState == SYS_MEDIA_ATTACHED)
+                        {
+                            /* Removed while being reinitialized at Default Speed */
+                            dObj->taskState = DRV_SDMMC_TASK_HANDLE_CARD_DETACH;
+                        }
+                        else
+                        {
+                            dObj->taskState = DRV_SDMMC_TASK_WAIT_FOR_DEVICE_ATTACH;
+                        }
                     }
                     else
                     {
@@ -1985,6 +2169,15 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 }
 
                 currentBufObj->status = DRV_SDMMC_COMMAND_IN_PROGRESS;
+                currentBufObj->xferBlocks = currentBufObj->nBlocks;
+                currentBufObj->nMerged = 0;
+
+                if ((currentBufObj->opType == DRV_SDMMC_OPERATION_TYPE_WRITE) &&
+                    (dObj->cardCtxt.isWriteProtected == false))
+                {
+                    /* Send adjacent queued writes as one multi-block write */
+                    _DRV_SDMMC_WriteMerge (dObj, currentBufObj);
+                }
 
                 if (dObj->cardCtxt.cardType == DRV_SDMMC_CARD_TYPE_STANDARD)
                 {
@@ -1996,7 +2189,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 if (currentBufObj->opType == DRV_SDMMC_OPERATION_TYPE_READ)
                 {
                     dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_READ;
-                    if (currentBufObj->nBlocks == 1)
+                    if (currentBufObj->xferBlocks == 1)
                     {
                         currentBufObj->opCode = DRV_SDMMC_CMD_READ_SINGLE_BLOCK;
                         dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_SINGLE;
@@ -2019,7 +2212,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                     else
                     {
                         dObj->dataTransferFlags.transferDir = DRV_SDMMC_DATA_TRANSFER_DIR_WRITE;
-                        if (currentBufObj->nBlocks == 1)
+                        if (currentBufObj->xferBlocks == 1)
                         {
                             currentBufObj->opCode = DRV_SDMMC_CMD_WRITE_SINGLE_BLOCK;
                             dObj->dataTransferFlags.transferType = DRV_SDMMC_DATA_TRANSFER_TYPE_SINGLE;
@@ -2162,7 +2355,18 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
                 {
                     dObj->sdmmcPlib->sdhostReadResponse (DRV_SDMMC_READ_RESP_REG_0, &response);
-                    dObj->taskState = DRV_SDMMC_TASK_SETUP_XFER;
+
+                    if ((dObj->protocol == DRV_SDMMC_PROTOCOL_SD) && (currentBufObj != NULL) &&
+                        (currentBufObj->opCode == DRV_SDMMC_CMD_WRITE_MULTI_BLOCK))
+                    {
+                        /* Tell the card how many blocks follow so that it can
+                         * erase them ahead of the data (ACMD23). */
+                        dObj->taskState = DRV_SDMMC_TASK_PRE_ERASE_APP_CMD;
+                    }
+                    else
+                    {
+                        dObj->taskState = DRV_SDMMC_TASK_SETUP_XFER;
+                    }
                 }
                 else
                 {
@@ -2171,6 +2375,32 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             }
             break;
 
+        case DRV_SDMMC_TASK_PRE_ERASE_APP_CMD:
+
+            _DRV_SDMMC_CommandSend (dObj, DRV_SDMMC_CMD_APP_CMD, (dObj->cardCtxt.rca << 16), DRV_SDMMC_CMD_RESP_R1, &dObj->dataTransferFlags);
+            if (dObj->cmdState == DRV_SDMMC_CMD_EXEC_IS_COMPLETE)
+            {
+                if (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_SUCCESS)
+                {
+                    dObj->taskState = DRV_SDMMC_TASK_PRE_ERASE;
+                }
+                else
+                {
+                    /* The pre-erase count is only a hint. Write without it. */
+                    dObj->taskState = DRV_SDMMC_TASK_SETUP_XFER;
+                }
+            }
+            break;
+
+        case DRV_SDMMC_TASK_PRE_ERASE:
+
+            _DRV_SDMMC_CommandSend (dObj, DRV_SDMMC_CMD_SET_WR_BLK_ERASE_COUNT, currentBufObj->xferBlocks, DRV_SDMMC_CMD_RESP_R1, &dObj->dataTransferFlags);
+            if (dObj->cmdState == DRV_SDMMC_CMD_EXEC_IS_COMPLETE)
+            {
+                dObj->taskState = DRV_SDMMC_TASK_SETUP_XFER;
+            }
+            break;
+
         case DRV_SDMMC_TASK_SETUP_XFER:
 
             if (currentBufObj == NULL)
@@ -2179,7 +2409,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 break;
             }
 
-            if (currentBufObj->nBlocks == 1)
+            if (currentBufObj->xferBlocks == 1)
             {
                 /* For transfers involving only a single block of data the
                  * block count field needs to be set to zero. */
@@ -2189,7 +2419,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             {
                 /* Configure the Block Count register with the number of
                  * blocks to be transferred. */
-                dObj->sdmmcPlib->sdhostSetBlockCount (currentBufObj->nBlocks);
+                dObj->sdmmcPlib->sdhostSetBlockCount (currentBufObj->xferBlocks);
             }
 
             /* Block count has already been set. */
@@ -2197,7 +2427,21 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
 
 
             dObj->dataTransferFlags.isDataPresent = true;
-            dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->nBlocks << 9), currentBufObj->opType);
+            if (dObj->sdmmcPlib->sdhostSetupDmaChain != NULL)
+            {
+                if (_DRV_SDMMC_SetupDmaChain (dObj, currentBufObj) == false)
+                {
+                    /* Misaligned buffer or too many descriptors */
+                    dObj->dataTransferFlags.isDataPresent = false;
+                    dObj->taskState = DRV_SDMMC_TASK_ERROR;
+                    break;
+                }
+            }
+            else
+            {
+                dObj->sdmmcPlib->sdhostSetupDma (currentBufObj->buffer, (currentBufObj->xferBlocks << 9), currentBufObj->opType);
+            }
+            dObj->xferStartCount = SYS_TIME_CounterGet();
             dObj->taskState = DRV_SDMMC_TASK_XFER_COMMAND;
 
             /* Fall through to the next state */
@@ -2212,6 +2456,11 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 {
                     dObj->taskState = DRV_SDMMC_TASK_XFER_STATUS;
                 }
+                else if (_DRV_SDMMC_IsHighSpeedFailure (dObj, (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_CRC_ERROR) ||
+                                                              (dObj->commandStatus == DRV_SDMMC_COMMAND_STATUS_TIMEOUT_ERROR)) == true)
+                {
+                    dObj->taskState = DRV_SDMMC_TASK_SPEED_FALLBACK;
+                }
                 else
                 {
                     dObj->taskState = DRV_SDMMC_TASK_ERROR;
@@ -2227,7 +2476,15 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 /* Check if there are any data errors. */
                 if (dObj->cardCtxt.errorFlag & DRV_SDMMC_ANY_DATA_ERRORS)
                 {
-                    dObj->taskState = DRV_SDMMC_TASK_ERROR;
+                    if (_DRV_SDMMC_IsHighSpeedFailure (dObj, (dObj->cardCtxt.errorFlag &
+                            (DRV_SDMMC_DATA_CRC_ERROR | DRV_SDMMC_DATA_TIMEOUT_ERROR)) != 0) == true)
+                    {
+                        dObj->taskState = DRV_SDMMC_TASK_SPEED_FALLBACK;
+                    }
+                    else
+                    {
+                        dObj->taskState = DRV_SDMMC_TASK_ERROR;
+                    }
                 }
                 else
                 {
@@ -2237,7 +2494,7 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                          * transferred. CMD13 status check to ensure that
                          * there were no issues while performing the data
                          * transfer. */
-                        if (currentBufObj->nBlocks > 1)
+                        if (currentBufObj->xferBlocks > 1)
                         {
                             /* Send stop transmission command. */
                             dObj->taskState = DRV_SDMMC_TASK_SEND_STOP_TRANS_CMD;
@@ -2298,6 +2555,8 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             if (dObj->cmdState == DRV_SDMMC_CMD_EXEC_IS_COMPLETE)
             {
                 currentBufObj->status = DRV_SDMMC_COMMAND_COMPLETED;
+                dObj->bytesTransferred += (currentBufObj->xferBlocks << 9);
+                dObj->xferBusyCount += (SYS_TIME_CounterGet() - dObj->xferStartCount);
                 dObj->taskState = DRV_SDMMC_TASK_TRANSFER_COMPLETE;
             }
             break;
@@ -2334,6 +2593,15 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
 
             if (currentBufObj != NULL)
             {
+                /* Requests merged into the transfer share its outcome */
+                nMerged = currentBufObj->nMerged;
+                xferStatus = currentBufObj->status;
+            }
+
+            while (currentBufObj != NULL)
+            {
+                currentBufObj->status = xferStatus;
+
                 /* Get the client object that owns this buffer */
                 clientObj = &((DRV_SDMMC_CLIENT_OBJ *)dObj->clientObjPool)[currentBufObj->clientHandle & DRV_SDMMC_INDEX_MASK];
 
@@ -2356,6 +2624,14 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
                 }
                 /* Free the completed buffer */
                 _DRV_SDMMC_RemoveBufferObjFromList(dObj);
+
+                if (nMerged == 0)
+                {
+                    break;
+                }
+
+                nMerged--;
+                currentBufObj = _DRV_SDMMC_BufferListGet(dObj);
             }
 
             if (cardAttached)
@@ -2370,11 +2646,33 @@ void DRV_SDMMC_Tasks( SYS_MODULE_OBJ object )
             }
             break;
 
+        case DRV_SDMMC_TASK_SPEED_FALLBACK:
+
+            /* The card failed at High Speed. Put the request back in the
+             * queue and initialize the card again at Default Speed. */
+            if (currentBufObj != NULL)
+            {
+                _DRV_SDMMC_BufferRequeue (dObj, currentBufObj);
+            }
+
+            dObj->isHighSpeedDisabled = true;
+            dObj->speedFallbacks++;
+
+            _DRV_SDMMC_InitCardContext((uint32_t)object, &dObj->cardCtxt);
+            dObj->sdmmcPlib->sdhostInitModule();
+            dObj->cardCtxt.currentSpeed = DRV_SDMMC_CLOCK_FREQ_400_KHZ;
+            dObj->initState = DRV_SDMMC_INIT_SET_INIT_SPEED;
+            dObj->taskState = DRV_SDMMC_TASK_MEDIA_INIT;
+            break;
+
         case DRV_SDMMC_TASK_HANDLE_CARD_DETACH:
 
             // Remove the buffer objects queued by all clients on this driver instance
             _DRV_SDMMC_RemoveBufferObjects (dObj);
 
+            /* The next card gets a new chance at High Speed */
+            dObj->isHighSpeedDisabled = false;
+
             dObj->mediaState = SYS_MEDIA_DETACHED;
             dObj->taskState = DRV_SDMMC_TASK_WAIT_FOR_DEVICE_ATTACH;
             break;
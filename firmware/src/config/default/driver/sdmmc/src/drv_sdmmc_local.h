@@ -93,6 +93,12 @@
 #define DRV_SDMMC_SCR_BUFFER_LEN                 (CACHE_ALIGNED_SIZE_GET(8))
 #define DRV_SDMMC_SWITCH_STATUS_BUFFER_LEN       (64)
 
+/* Largest transfer built by merging queued writes (64 KB) */
+#define DRV_SDMMC_MAX_XFER_BLOCKS                (128U)
+
+/* Most buffers gathered into one transfer when the PLIB supports DMA chains */
+#define DRV_SDMMC_MAX_DMA_SEGMENTS               (8U)
+
 // Section: OCR register bits
 #define DRV_SDMMC_OCR_VDD_170_195     (1U <<  7)
 #define DRV_SDMMC_OCR_VDD_200_270     (0x7F1U << 8)
@@ -309,6 +315,8 @@ typedef enum
     DRV_SDMMC_TASK_SLEEP_WAKE_CARD,
     DRV_SDMMC_TASK_CHECK_CARD_DETACH,
     DRV_SDMMC_TASK_SELECT_CARD,
+    DRV_SDMMC_TASK_PRE_ERASE_APP_CMD,
+    DRV_SDMMC_TASK_PRE_ERASE,
     DRV_SDMMC_TASK_SETUP_XFER,
     DRV_SDMMC_TASK_XFER_COMMAND,
     DRV_SDMMC_TASK_XFER_STATUS,
@@ -317,6 +325,7 @@ typedef enum
     DRV_SDMMC_TASK_DESELECT_CARD,
     DRV_SDMMC_TASK_ERROR,
     DRV_SDMMC_TASK_TRANSFER_COMPLETE,
+    DRV_SDMMC_TASK_SPEED_FALLBACK,
     DRV_SDMMC_TASK_HANDLE_CARD_DETACH
 
 } DRV_SDMMC_TASK_STATES;
@@ -542,6 +551,13 @@ typedef struct DRV_SDMMC_BUFFER_OBJ
     /* Number of blocks */
     uint32_t                            nBlocks;
 
+    /* Number of blocks moved by the bus transfer. Larger than nBlocks when
+     * the buffer objects queued behind this one are merged into it. */
+    uint32_t                            xferBlocks;
+
+    /* Number of buffer objects following this one that complete with it */
+    uint32_t                            nMerged;
+
     /* Op code associated with the buffer object. */
     uint8_t                             opCode;
 
@@ -650,6 +666,23 @@ typedef struct
     /* Speed mode - Default Speed or High Speed mode of operation. */
     DRV_SDMMC_SPEED_MODE            speedMode;
 
+    /* Set when the card failed in High Speed mode. The card is then run at
+     * Default Speed until it is removed. */
+    bool                            isHighSpeedDisabled;
+
+    /* Number of times the driver fell back to Default Speed */
+    uint32_t                        speedFallbacks;
+
+    /* Buffers of the current transfer, for PLIBs with DMA chains */
+    DRV_SDMMC_DMA_SEGMENT           dmaSegments[DRV_SDMMC_MAX_DMA_SEGMENTS];
+
+    /* SYS_TIME counter at the start of the current data transfer */
+    uint32_t                        xferStartCount;
+
+    /* Data moved by completed transfers and the time they took */
+    uint64_t                        bytesTransferred;
+    uint64_t                        xferBusyCount;
+
     /* Bus width to be used for the card. */
     DRV_SDMMC_BUS_WIDTH             busWidth;
 
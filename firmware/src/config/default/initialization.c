@@ -59,8 +59,9 @@
 #pragma config BOD33_ACTION = RESET
 #pragma config BOD33_HYST = 0x2U
 #pragma config NVMCTRL_BOOTPROT = 0
-#pragma config NVMCTRL_SEESBLK = 0x0U
-#pragma config NVMCTRL_SEEPSZ = 0x0U
+/* SmartEEPROM of app_config.h; see there before changing it on deployed devices */
+#pragma config NVMCTRL_SEESBLK = 0x1U
+#pragma config NVMCTRL_SEEPSZ = 0x3U
 #pragma config RAMECC_ECCDIS = SET
 #pragma config WDT_ENABLE = CLEAR
 #pragma config WDT_ALWAYSON = CLEAR
@@ -79,12 +80,28 @@
 const DRV_BME280_PLIB_INTERFACE gDrvBME280PLIBIntf[1] =
 {
     {
+#if (DRV_BME280_SIMULATION == 1)
+        .read = (DRV_BME280_PLIB_READ) DRV_BME280_SIM_I2C_Read,
+        .write = (DRV_BME280_PLIB_WRITE) DRV_BME280_SIM_I2C_Write,
+        .writeRead = (DRV_BME280_PLIB_WRITE_READ) DRV_BME280_SIM_I2C_WriteRead,
+        .errorGet = (DRV_BME280_PLIB_ERROR_GET) DRV_BME280_SIM_I2C_ErrorGet,
+        .callbackRegister = (DRV_BME280_PLIB_CALLBACK_REGISTER) DRV_BME280_SIM_I2C_CallbackRegister,
+        .transferSetup = (DRV_BME280_PLIB_TRANSFER_SETUP) DRV_BME280_SIM_I2C_TransferSetup,
+#elif (DRV_BME280_REPLAY == 1)
+        .read = (DRV_BME280_PLIB_READ) DRV_BME280_REPLAY_I2C_Read,
+        .write = (DRV_BME280_PLIB_WRITE) DRV_BME280_REPLAY_I2C_Write,
+        .writeRead = (DRV_BME280_PLIB_WRITE_READ) DRV_BME280_REPLAY_I2C_WriteRead,
+        .errorGet = (DRV_BME280_PLIB_ERROR_GET) DRV_BME280_REPLAY_I2C_ErrorGet,
+        .callbackRegister = (DRV_BME280_PLIB_CALLBACK_REGISTER) DRV_BME280_REPLAY_I2C_CallbackRegister,
+        .transferSetup = (DRV_BME280_PLIB_TRANSFER_SETUP) DRV_BME280_REPLAY_I2C_TransferSetup,
+#else
         .read = (DRV_BME280_PLIB_READ) SERCOM3_I2C_Read,
         .write = (DRV_BME280_PLIB_WRITE) SERCOM3_I2C_Write, 
         .writeRead = (DRV_BME280_PLIB_WRITE_READ) SERCOM3_I2C_WriteRead,
         .errorGet = (DRV_BME280_PLIB_ERROR_GET) SERCOM3_I2C_ErrorGet,
         .callbackRegister = (DRV_BME280_PLIB_CALLBACK_REGISTER) SERCOM3_I2C_CallbackRegister,
         .transferSetup = (DRV_BME280_PLIB_TRANSFER_SETUP) SERCOM3_I2C_TransferSetup,
+#endif
     }
 };
 
@@ -96,6 +113,7 @@ const DRV_BME280_INIT gDrvBME280InitObj[1] =
         .plibInterface = &gDrvBME280PLIBIntf[0],
         .configParams.sensorAddr = DRV_BME280_I2C_ADDRESS,
         .configParams.transferParams.clockSpeed = 400000,
+        .configParams.pressureMode = DRV_BME280_PRESSURE_MODE_32BIT,
         .clientObjPool = (uintptr_t) gDrvBME280Sensor0ClientObjPool,
         .maxClients = 1,
     }
@@ -123,6 +141,7 @@ const DRV_SDMMC_PLIB_API drvSDMMC0PlibAPI = {
     .sdhostSetBusWidth = (DRV_SDMMC_PLIB_SET_BUS_WIDTH)SDHC1_BusWidthSet,
     .sdhostSetSpeedMode = (DRV_SDMMC_PLIB_SET_SPEED_MODE)SDHC1_SpeedModeSet,
     .sdhostSetupDma = (DRV_SDMMC_PLIB_SETUP_DMA)SDHC1_DmaSetup,
+    .sdhostSetupDmaChain = (DRV_SDMMC_PLIB_SETUP_DMA_CHAIN)SDHC1_DmaChainSetup,
     .sdhostGetCommandError = (DRV_SDMMC_PLIB_GET_COMMAND_ERROR)SDHC1_CommandErrorGet,
     .sdhostGetDataError = (DRV_SDMMC_PLIB_GET_DATA_ERROR)SDHC1_DataErrorGet,
     .sdhostClockEnable = (DRV_SDMMC_PLIB_CLOCK_ENABLE)SDHC1_ClockEnable,
@@ -214,7 +233,8 @@ const SYS_FS_FUNCTIONS FatFsFunctions =
     .testerror         = FATFS_error,
     .formatDisk        = (FORMAT_DISK)FATFS_mkfs,
     .partitionDisk     = FATFS_fdisk,
-    .getCluster        = FATFS_getclusters
+    .getCluster        = FATFS_getclusters,
+    .expand            = FATFS_expand
 };
 
 
@@ -306,6 +326,12 @@ void SYS_Initialize ( void* data )
 
     NVMCTRL_Initialize( );
 
+    /* The startup code enables the CMCC for instructions only */
+    if (SYS_DCACHE_ENABLE == true)
+    {
+        DCACHE_ENABLE();
+    }
+
     STDIO_BufferModeSet();
   
     PORT_Initialize();
@@ -322,6 +348,8 @@ void SYS_Initialize ( void* data )
 
     RTC_Initialize();
 
+    PM_Initialize();
+
 	SDHC1_Initialize();
 
     sysObj.drvBME280 = DRV_BME280_Initialize(DRV_BME280_INSTANCE_0, (SYS_MODULE_INIT*) &gDrvBME280InitObj[0]);
@@ -330,13 +358,35 @@ void SYS_Initialize ( void* data )
 
     sysObj.sysTime = SYS_TIME_Initialize(SYS_TIME_INDEX_0, (SYS_MODULE_INIT *)&sysTimeInitData);
 
+#if (DRV_BME280_SIMULATION == 1)
+    DRV_BME280_SIM_Initialize(DRV_BME280_I2C_ADDRESS, NULL);
+#endif
+
     /*** File System Service Initialization Code ***/
     SYS_FS_Initialize( (const void *) sysFSInit );
 
+    APP_POOL_Initialize();
+
+    APP_DMABUF_Initialize();
+
+    APP_CONFIG_Initialize();
+
     APP_Initialize();
     
+    APP_FLASHLOG_Initialize();
+
     APP_SDCARD_Initialize();
 
+    APP_TIMESTAMP_Initialize();
+
+    APP_TRACE_Initialize();
+
+    APP_METEO_Initialize();
+
+    APP_QUERY_Initialize();
+
+    APP_POWER_Initialize();
+
     NVIC_Initialize();
 
     /* MISRAC 2012 deviation block end */
@@ -67,6 +67,7 @@ void DebugMonitor_Handler (void);
 void SERCOM2_USART_InterruptHandler (void);
 void SERCOM3_I2C_InterruptHandler (void);
 void TC0_TimerInterruptHandler (void);
+void RTC_InterruptHandler (void);
 void SDHC1_InterruptHandler (void);
 
 
@@ -98,11 +98,56 @@ void CMCC_DisableDCache (void )
 
 void CMCC_InvalidateAll (void )
 {
+    /* The cache is enabled again only if it was */
+    bool isEnabled = ((CMCC_REGS->CMCC_SR & CMCC_SR_CSTS_Msk) == CMCC_SR_CSTS_Msk);
+
     CMCC_REGS->CMCC_CTRL &= (~CMCC_CTRL_CEN_Msk);
     while((CMCC_REGS->CMCC_SR & CMCC_SR_CSTS_Msk) == CMCC_SR_CSTS_Msk)
     {
         /*Wait for the operation to complete*/
     }
     CMCC_REGS->CMCC_MAINT0 = CMCC_MAINT0_INVALL_Msk;
+
+    if (isEnabled == true)
+    {
+        CMCC_REGS->CMCC_CTRL = (CMCC_CTRL_CEN_Msk);
+    }
+}
+
+void CMCC_InvalidateByAddr (uint32_t address, uint32_t size)
+{
+    bool isEnabled = ((CMCC_REGS->CMCC_SR & CMCC_SR_CSTS_Msk) == CMCC_SR_CSTS_Msk);
+    uint32_t line = address / CMCC_LINE_SIZE;
+    uint32_t lines = ((address + size + CMCC_LINE_SIZE - 1U) / CMCC_LINE_SIZE) - line;
+    uint32_t way;
+
+    /* A way or more covers every index */
+    if (lines >= CMCC_LINE_PER_WAY)
+    {
+        CMCC_InvalidateAll();
+        return;
+    }
+
+    CMCC_REGS->CMCC_CTRL &= (~CMCC_CTRL_CEN_Msk);
+    while((CMCC_REGS->CMCC_SR & CMCC_SR_CSTS_Msk) == CMCC_SR_CSTS_Msk)
+    {
+        /*Wait for the operation to complete*/
+    }
+
+    /* The line may be held in any way of its index */
+    for (; lines > 0U; lines--)
+    {
+        for (way = 0U; way < CMCC_NO_OF_WAYS; way++)
+        {
+            CMCC_REGS->CMCC_MAINT1 = CMCC_MAINT1_INDEX(line % CMCC_LINE_PER_WAY) | CMCC_MAINT1_WAY(way);
+        }
+
+        line++;
+    }
+
+    if (isEnabled == true)
+    {
+        CMCC_REGS->CMCC_CTRL = (CMCC_CTRL_CEN_Msk);
+    }
 }
 
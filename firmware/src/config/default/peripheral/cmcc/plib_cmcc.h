@@ -40,6 +40,8 @@
 #ifndef PLIB_CMCC_H    // Guards against multiple inclusion
 #define PLIB_CMCC_H
 
+#include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus // Provide C++ Compatibility
 	extern "C" {
@@ -66,6 +68,7 @@ void CMCC_EnableICache (void );
 void CMCC_DisableICache (void );
 
 void CMCC_InvalidateAll (void );
+void CMCC_InvalidateByAddr (uint32_t address, uint32_t size);
 
 #ifdef __cplusplus  // Provide C++ Compatibility
     }
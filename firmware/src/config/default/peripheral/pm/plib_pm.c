@@ -0,0 +1,100 @@
+/*******************************************************************************
+  Power Manager(PM) PLIB
+
+  Company
+    Microchip Technology Inc.
+
+  File Name
+    plib_pm.c
+
+  Summary
+    PM PLIB Implementation File.
+
+  Description
+    This file defines the interface to the PM peripheral library. This
+    library provides access to and control of the associated peripheral
+    instance.
+
+  Remarks:
+    None.
+
+*******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2019 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+/* This section lists the other files that are included in this file.
+*/
+
+#include "plib_pm.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: PM Implementation
+// *****************************************************************************
+// *****************************************************************************
+
+void PM_Initialize( void )
+{
+    /* Configure PM: keep all RAM retained in standby, no fast wakeup */
+    PM_REGS->PM_STDBYCFG = PM_STDBYCFG_RAMCFG(0x0U) | PM_STDBYCFG_FASTWKUP(0x0U);
+}
+
+void PM_IdleModeEnter( void )
+{
+    /* Configure Idle Sleep mode */
+    PM_REGS->PM_SLEEPCFG = PM_SLEEPCFG_SLEEPMODE_IDLE;
+
+    /* Ensure that SLEEPMODE bits are configured with the given value */
+    while ((PM_REGS->PM_SLEEPCFG & PM_SLEEPCFG_SLEEPMODE_Msk) != PM_SLEEPCFG_SLEEPMODE_IDLE)
+    {
+        /* Wait for the write to take effect */
+    }
+
+    /* Wait for interrupt instruction execution */
+    __DSB();
+    __WFI();
+}
+
+void PM_StandbyModeEnter( void )
+{
+    /* Configure Standby Sleep mode */
+    PM_REGS->PM_SLEEPCFG = PM_SLEEPCFG_SLEEPMODE_STANDBY;
+
+    /* Ensure that SLEEPMODE bits are configured with the given value */
+    while ((PM_REGS->PM_SLEEPCFG & PM_SLEEPCFG_SLEEPMODE_Msk) != PM_SLEEPCFG_SLEEPMODE_STANDBY)
+    {
+        /* Wait for the write to take effect */
+    }
+
+    /* Wait for interrupt instruction execution */
+    __DSB();
+    __WFI();
+}
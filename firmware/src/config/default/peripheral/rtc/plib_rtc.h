@@ -112,6 +112,32 @@ typedef enum
  #define   TAMPER_CHANNEL_4  (4U)
 typedef uint32_t TAMPER_CHANNEL;
 
+typedef enum
+{
+    RTC_ALARM_MASK_NONE = 0U,
+    RTC_ALARM_MASK_SS,
+    RTC_ALARM_MASK_MMSS,
+    RTC_ALARM_MASK_HHMMSS,
+    RTC_ALARM_MASK_DDHHMMSS,
+    RTC_ALARM_MASK_MMDDHHMMSS,
+    RTC_ALARM_MASK_YYMMDDHHMMSS
+} RTC_ALARM_MASK;
+
+typedef uint32_t RTC_CLOCK_INT_MASK;
+
+typedef void (*RTC_CALLBACK)( RTC_CLOCK_INT_MASK intCause, uintptr_t context );
+
+typedef struct
+{
+    /* RTC Clock Callback Object */
+    RTC_CALLBACK alarmCallback;
+
+    /* Interrupt causes that were active when the callback fired */
+    RTC_CLOCK_INT_MASK intCause;
+
+    uintptr_t context;
+} RTC_OBJECT;
+
 
 void RTC_Initialize(void);
 bool RTC_PeriodicIntervalHasCompleted ( RTC_PERIODIC_INT_MASK period );
@@ -123,6 +149,10 @@ void RTC_BackupRegisterSet( BACKUP_REGISTER reg, uint32_t value );
 uint32_t RTC_BackupRegisterGet( BACKUP_REGISTER reg );
 TAMPER_CHANNEL RTC_TamperSourceGet( void );
 void RTC_RTCCTimeStampGet( struct tm * timeStamp );
+bool RTC_RTCCAlarmSet ( struct tm * alarmTime, RTC_ALARM_MASK mask );
+void RTC_RTCCCallbackRegister ( RTC_CALLBACK callback, uintptr_t context );
+void RTC_RTCCInterruptEnable( RTC_CLOCK_INT_MASK interrupt );
+void RTC_RTCCInterruptDisable( RTC_CLOCK_INT_MASK interrupt );
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
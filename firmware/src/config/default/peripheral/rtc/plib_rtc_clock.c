@@ -69,6 +69,8 @@
 /* Adjust to tm structure month */
 #define ADJUST_TM_STRUCT_MONTH(mon) (mon - 1U)
 
+static RTC_OBJECT rtcObj;
+
 
 void RTC_Initialize(void)
 {
@@ -221,3 +223,65 @@ void RTC_RTCCTimeStampGet(  struct tm * timeStamp  )
    timeStamp->tm_mday = (int)timeMask; 
 }
 
+bool RTC_RTCCAlarmSet (struct tm * alarmTime, RTC_ALARM_MASK mask)
+{
+    /*
+     * Add 1900 to the tm_year member and the adjust for the RTC reference year
+     * Set YEAR(according to Reference Year), MONTH and DAY
+     * Set Hour, Minute and second
+     */
+    RTC_REGS->MODE2.RTC_ALARM0 = (uint32_t)((((TM_STRUCT_REFERENCE_YEAR + (uint32_t)alarmTime->tm_year) - REFERENCE_YEAR) << RTC_MODE2_CLOCK_YEAR_Pos) |
+                    (ADJUST_MONTH((uint32_t)alarmTime->tm_mon) << RTC_MODE2_CLOCK_MONTH_Pos) |
+                    ((uint32_t)alarmTime->tm_mday << RTC_MODE2_CLOCK_DAY_Pos) |
+                    ((uint32_t)alarmTime->tm_hour << RTC_MODE2_CLOCK_HOUR_Pos) |
+                    ((uint32_t)alarmTime->tm_min << RTC_MODE2_CLOCK_MINUTE_Pos) |
+                    ((uint32_t)alarmTime->tm_sec << RTC_MODE2_CLOCK_SECOND_Pos));
+
+    while((RTC_REGS->MODE2.RTC_SYNCBUSY & RTC_MODE2_SYNCBUSY_ALARM0_Msk) == RTC_MODE2_SYNCBUSY_ALARM0_Msk)
+    {
+        /* Synchronization after writing to ALARM register */
+    }
+
+    RTC_REGS->MODE2.RTC_MASK0 = (uint8_t)mask;
+
+    while((RTC_REGS->MODE2.RTC_SYNCBUSY & RTC_MODE2_SYNCBUSY_MASK0_Msk) == RTC_MODE2_SYNCBUSY_MASK0_Msk)
+    {
+        /* Synchronization after writing value to MASK Register */
+    }
+
+    /* Clear a stale alarm flag before arming the interrupt */
+    RTC_REGS->MODE2.RTC_INTFLAG = (uint16_t)RTC_MODE2_INTFLAG_ALARM0_Msk;
+    RTC_REGS->MODE2.RTC_INTENSET = (uint16_t)RTC_MODE2_INTENSET_ALARM0_Msk;
+
+    return true;
+}
+
+void RTC_RTCCCallbackRegister ( RTC_CALLBACK callback, uintptr_t context )
+{
+    rtcObj.alarmCallback = callback;
+    rtcObj.context       = context;
+}
+
+void RTC_RTCCInterruptEnable( RTC_CLOCK_INT_MASK interrupt )
+{
+    RTC_REGS->MODE2.RTC_INTFLAG = (uint16_t)interrupt;
+    RTC_REGS->MODE2.RTC_INTENSET = (uint16_t)interrupt;
+}
+
+void RTC_RTCCInterruptDisable( RTC_CLOCK_INT_MASK interrupt )
+{
+    RTC_REGS->MODE2.RTC_INTENCLR = (uint16_t)interrupt;
+}
+
+void RTC_InterruptHandler( void )
+{
+    /* Only report the causes which are enabled */
+    rtcObj.intCause = (RTC_CLOCK_INT_MASK)RTC_REGS->MODE2.RTC_INTFLAG & (RTC_CLOCK_INT_MASK)RTC_REGS->MODE2.RTC_INTENSET;
+    RTC_REGS->MODE2.RTC_INTFLAG = (uint16_t)RTC_MODE2_INTFLAG_Msk;
+
+    /* Invoke registered Callback function */
+    if(rtcObj.alarmCallback != NULL)
+    {
+        rtcObj.alarmCallback( rtcObj.intCause, rtcObj.context );
+    }
+}
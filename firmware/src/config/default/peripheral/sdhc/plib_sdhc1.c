@@ -50,10 +50,11 @@
 
 #include "plib_sdhc_common.h"
 
-#define SDHC1_DMA_NUM_DESCR_LINES        (1U)
+#define SDHC1_DMA_NUM_DESCR_LINES        (8U)
 #define SDHC1_BASE_CLOCK_FREQUENCY       (100000000U)
 #define SDHC1_MAX_BLOCK_SIZE             (0x200U)
-#define SDHC1_DMA_DESC_TABLE_SIZE	     (8U * 1)
+#define SDHC1_DMA_DESC_TABLE_SIZE	     (8U * SDHC1_DMA_NUM_DESCR_LINES)
+#define SDHC1_DMA_DESCR_MAX_LENGTH       (65536U)
 #define SDHC1_DMA_DESC_TABLE_SIZE_CACHE_ALIGN	 (SDHC1_DMA_DESC_TABLE_SIZE + ((SDHC1_DMA_DESC_TABLE_SIZE % CACHE_LINE_SIZE)? (CACHE_LINE_SIZE - (SDHC1_DMA_DESC_TABLE_SIZE % CACHE_LINE_SIZE)) : 0U))
 
 static CACHE_ALIGN SDHC_ADMA_DESCR sdhc1DmaDescrTable[(SDHC1_DMA_DESC_TABLE_SIZE_CACHE_ALIGN/8U)];
@@ -104,7 +105,7 @@ static void SDHC1_TransferModeSet ( uint32_t opcode )
     SDHC1_REGS->SDHC_TMR = transferMode;
 }
 
-void SDHC1_InterruptHandler(void)
+void RAMFUNC SDHC1_InterruptHandler(void)
 {
     uint16_t nistr = 0U;
     uint16_t eistr = 0U;
@@ -290,6 +291,26 @@ void SDHC1_DmaSetup (
     SDHC_DATA_TRANSFER_DIR direction
 )
 {
+    SDHC_DMA_SEGMENT segment;
+
+    segment.buffer = buffer;
+    segment.numBytes = numBytes;
+
+    (void) SDHC1_DmaChainSetup(&segment, 1U, direction);
+}
+
+bool SDHC1_DmaChainSetup (
+    const SDHC_DMA_SEGMENT* segments,
+    uint32_t numSegments,
+    SDHC_DATA_TRANSFER_DIR direction
+)
+{
+    uint32_t numLines = 0U;
+    uint32_t address;
+    uint32_t remaining;
+    uint32_t length;
+    uint32_t i;
+
     (void)direction;
 
     /* Each ADMA2 descriptor can transfer 65536 bytes (or 128 blocks) of data.
@@ -297,25 +318,59 @@ void SDHC1_DmaSetup (
      * limited to 65536 blocks. Hence, combined length of data that can be
      * transferred by all the descriptors is 512 bytes x 65536 blocks, assuming
      * a block size of 512 bytes.
+     *
+     * Each segment gets one descriptor line per 65536 bytes. The controller
+     * walks the lines in order, so the card sees one contiguous stream of
+     * blocks gathered from (or scattered to) all the segments.
      */
 
-    if (numBytes <= 65536U)
+    for (i = 0U; i < numSegments; i++)
     {
-        sdhc1DmaDescrTable[0].address = (uint32_t)(buffer);
-        sdhc1DmaDescrTable[0].length = (uint16_t)numBytes;
-        sdhc1DmaDescrTable[0].attribute = \
-            (SDHC_DESC_TABLE_ATTR_XFER_DATA | SDHC_DESC_TABLE_ATTR_VALID | SDHC_DESC_TABLE_ATTR_INTR);
+        address = (uint32_t)(segments[i].buffer);
+        remaining = segments[i].numBytes;
+
+        /* ADMA2 with 32-bit addressing needs word aligned data */
+        if (((address & 0x03U) != 0U) || (remaining == 0U))
+        {
+            return false;
+        }
 
+        while (remaining > 0U)
+        {
+            if (numLines >= SDHC1_DMA_NUM_DESCR_LINES)
+            {
+                return false;
+            }
 
-         /* The last descriptor line must indicate the end of the descriptor list */
-        sdhc1DmaDescrTable[0].attribute |= (uint16_t)(SDHC_DESC_TABLE_ATTR_END);
+            length = (remaining > SDHC1_DMA_DESCR_MAX_LENGTH) ? SDHC1_DMA_DESCR_MAX_LENGTH : remaining;
 
-        /* Clean the cache associated with the modified descriptors */
-        DCACHE_CLEAN_BY_ADDR((uint32_t*)(sdhc1DmaDescrTable), (sizeof(SDHC_ADMA_DESCR)));
+            /* A length of 0 stands for 65536 bytes */
+            sdhc1DmaDescrTable[numLines].address = address;
+            sdhc1DmaDescrTable[numLines].length = (uint16_t)length;
+            sdhc1DmaDescrTable[numLines].attribute = \
+                (SDHC_DESC_TABLE_ATTR_XFER_DATA | SDHC_DESC_TABLE_ATTR_VALID);
 
-        /* Set the starting address of the descriptor table */
-        SDHC1_REGS->SDHC_ASAR[0] = (uint32_t)(&sdhc1DmaDescrTable[0]);
+            address += length;
+            remaining -= length;
+            numLines++;
+        }
     }
+
+    if (numLines == 0U)
+    {
+        return false;
+    }
+
+    /* The last descriptor line must indicate the end of the descriptor list */
+    sdhc1DmaDescrTable[numLines - 1U].attribute |= (uint16_t)(SDHC_DESC_TABLE_ATTR_INTR | SDHC_DESC_TABLE_ATTR_END);
+
+    /* Clean the cache associated with the modified descriptors */
+    DCACHE_CLEAN_BY_ADDR((uint32_t*)(sdhc1DmaDescrTable), (numLines * sizeof(SDHC_ADMA_DESCR)));
+
+    /* Set the starting address of the descriptor table */
+    SDHC1_REGS->SDHC_ASAR[0] = (uint32_t)(&sdhc1DmaDescrTable[0]);
+
+    return true;
 }
 
 bool SDHC1_ClockSet ( uint32_t speed)
@@ -104,6 +104,12 @@ void SDHC1_DmaSetup (
     SDHC_DATA_TRANSFER_DIR direction
 );
 
+bool SDHC1_DmaChainSetup (
+    const SDHC_DMA_SEGMENT* segments,
+    uint32_t numSegments,
+    SDHC_DATA_TRANSFER_DIR direction
+);
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -243,6 +243,13 @@ typedef struct
     uint32_t                            address;
 } SDHC_ADMA_DESCR;
 
+/* One buffer of a scatter-gather transfer */
+typedef struct
+{
+    uint8_t*                            buffer;
+    uint32_t                            numBytes;
+} SDHC_DMA_SEGMENT;
+
 typedef  void (*SDHC_CALLBACK) (SDHC_XFER_STATUS xferStatus, uintptr_t context);
 
 typedef struct
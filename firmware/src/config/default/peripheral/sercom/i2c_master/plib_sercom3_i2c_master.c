@@ -50,6 +50,7 @@
 
 #include "interrupts.h"
 #include "plib_sercom3_i2c_master.h"
+#include "peripheral/nvic/plib_nvic.h"
 
 
 // *****************************************************************************
@@ -67,6 +68,9 @@
 
 static SERCOM_I2C_OBJ sercom3I2CObj;
 
+/* Transfer counters, from reset */
+static SERCOM_I2C_STATISTICS sercom3I2CStats;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: SERCOM3 I2C Implementation
@@ -260,7 +264,7 @@ void SERCOM3_I2C_CallbackRegister(SERCOM_I2C_CALLBACK callback, uintptr_t contex
 }
 
 
-static void SERCOM3_I2C_SendAddress(uint16_t address, bool dir)
+static void RAMFUNC SERCOM3_I2C_SendAddress(uint16_t address, bool dir)
 {
     /* If operation is I2C read */
     if(dir)
@@ -289,7 +293,7 @@ static void SERCOM3_I2C_SendAddress(uint16_t address, bool dir)
 
 }
 
-static void SERCOM3_I2C_InitiateTransfer(uint16_t address, bool dir)
+static void RAMFUNC SERCOM3_I2C_InitiateTransfer(uint16_t address, bool dir)
 {
     sercom3I2CObj.writeCount = 0U;
     sercom3I2CObj.readCount = 0U;
@@ -323,9 +327,12 @@ static bool SERCOM3_I2C_XferSetup(
     /* Check for ongoing transfer */
     if(sercom3I2CObj.state != SERCOM_I2C_STATE_IDLE)
     {
+        sercom3I2CStats.refusedCount++;
         return false;
     }
 
+    sercom3I2CStats.transferCount++;
+
     sercom3I2CObj.address        = address;
     sercom3I2CObj.readBuffer     = rdData;
     sercom3I2CObj.readSize       = rdLength;
@@ -377,6 +384,11 @@ SERCOM_I2C_ERROR SERCOM3_I2C_ErrorGet(void)
 
 void SERCOM3_I2C_TransferAbort( void )
 {
+    if (sercom3I2CObj.state != SERCOM_I2C_STATE_IDLE)
+    {
+        sercom3I2CStats.abortCount++;
+    }
+
     sercom3I2CObj.error = SERCOM_I2C_ERROR_NONE;
 
     // Reset the plib to IDLE state
@@ -410,7 +422,17 @@ void SERCOM3_I2C_TransferAbort( void )
     }
 }
 
-void SERCOM3_I2C_InterruptHandler(void)
+void SERCOM3_I2C_StatisticsGet( SERCOM_I2C_STATISTICS* stats )
+{
+    /* Copy the counters together, out of reach of the interrupt handler */
+    bool interruptState = NVIC_INT_Disable();
+
+    *stats = sercom3I2CStats;
+
+    NVIC_INT_Restore(interruptState);
+}
+
+void RAMFUNC SERCOM3_I2C_InterruptHandler(void)
 {
     if(SERCOM3_REGS->I2CM.SERCOM_INTENSET != 0U)
     {
@@ -420,6 +442,7 @@ void SERCOM3_I2C_InterruptHandler(void)
             /* Set Error status */
             sercom3I2CObj.state = SERCOM_I2C_STATE_ERROR;
             sercom3I2CObj.error = SERCOM_I2C_ERROR_BUS;
+            sercom3I2CStats.arbitrationLostCount++;
 
         }
         /* Check for Bus Error during transmission */
@@ -546,6 +569,17 @@ void SERCOM3_I2C_InterruptHandler(void)
         /* Error Status */
         if(sercom3I2CObj.state == SERCOM_I2C_STATE_ERROR)
         {
+            if (sercom3I2CObj.error == SERCOM_I2C_ERROR_NAK)
+            {
+                sercom3I2CStats.nakCount++;
+            }
+            else
+            {
+                sercom3I2CStats.busErrorCount++;
+            }
+            sercom3I2CStats.writeBytes += sercom3I2CObj.writeCount;
+            sercom3I2CStats.readBytes += sercom3I2CObj.readCount;
+
             /* Reset the PLib objects and Interrupts */
             sercom3I2CObj.state = SERCOM_I2C_STATE_IDLE;
 
@@ -569,6 +603,10 @@ void SERCOM3_I2C_InterruptHandler(void)
         /* Transfer Complete */
         else if(sercom3I2CObj.state == SERCOM_I2C_STATE_TRANSFER_DONE)
         {
+            sercom3I2CStats.doneCount++;
+            sercom3I2CStats.writeBytes += sercom3I2CObj.writeCount;
+            sercom3I2CStats.readBytes += sercom3I2CObj.readCount;
+
             /* Reset the PLib objects and interrupts */
             sercom3I2CObj.state = SERCOM_I2C_STATE_IDLE;
             sercom3I2CObj.error = SERCOM_I2C_ERROR_NONE;
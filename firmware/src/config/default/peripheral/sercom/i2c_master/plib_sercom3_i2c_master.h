@@ -92,6 +92,8 @@ bool SERCOM3_I2C_TransferSetup(SERCOM_I2C_TRANSFER_SETUP* setup, uint32_t srcClk
 
 void SERCOM3_I2C_TransferAbort( void );
 
+void SERCOM3_I2C_StatisticsGet( SERCOM_I2C_STATISTICS* stats );
+
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
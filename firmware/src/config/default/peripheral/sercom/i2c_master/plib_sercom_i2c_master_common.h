@@ -229,6 +229,42 @@ typedef struct
 
 } SERCOM_I2C_OBJ;
 
+// *****************************************************************************
+/* SERCOM I2C PLib Statistics
+
+   Summary:
+    Counters of the transfers of a SERCOM I2C PLib instance.
+
+   Description:
+    This data structure counts the transfers started, refused and ended, by
+    how they ended, and the bytes moved. Each counter wraps around at 2^32.
+
+   Remarks:
+    A transfer started and not yet ended is counted in transferCount only.
+*/
+
+typedef struct
+{
+    /* Transfers started, and refused because one was in progress */
+    uint32_t                    transferCount;
+    uint32_t                    refusedCount;
+
+    /* Transfers ended without error, with SERCOM_I2C_ERROR_NAK and with
+     * SERCOM_I2C_ERROR_BUS, of which the arbitrations lost */
+    uint32_t                    doneCount;
+    uint32_t                    nakCount;
+    uint32_t                    busErrorCount;
+    uint32_t                    arbitrationLostCount;
+
+    /* Transfers abandoned by the TransferAbort function */
+    uint32_t                    abortCount;
+
+    /* Bytes written and read, including those of failed transfers */
+    uint32_t                    writeBytes;
+    uint32_t                    readBytes;
+
+} SERCOM_I2C_STATISTICS;
+
 // *****************************************************************************
 /* Transaction Request Block
 
@@ -69,7 +69,7 @@ static SERCOM_USART_OBJECT sercom2USARTObj;
 // *****************************************************************************
 // *****************************************************************************
 
-void static SERCOM2_USART_ErrorClear( void )
+static void RAMFUNC SERCOM2_USART_ErrorClear( void )
 {
     uint8_t  u8dummyData = 0U;
     USART_ERROR errorStatus = (USART_ERROR) (SERCOM2_REGS->USART_INT.SERCOM_STATUS & (uint16_t)(SERCOM_USART_INT_STATUS_PERR_Msk | SERCOM_USART_INT_STATUS_FERR_Msk | SERCOM_USART_INT_STATUS_BUFOVF_Msk ));
@@ -423,7 +423,7 @@ void SERCOM2_USART_ReadCallbackRegister( SERCOM_USART_CALLBACK callback, uintptr
 }
 
 
-void static SERCOM2_USART_ISR_ERR_Handler( void )
+static void RAMFUNC SERCOM2_USART_ISR_ERR_Handler( void )
 {
     USART_ERROR errorStatus = USART_ERROR_NONE;
 
@@ -450,7 +450,7 @@ void static SERCOM2_USART_ISR_ERR_Handler( void )
     }
 }
 
-void static SERCOM2_USART_ISR_RX_Handler( void )
+static void RAMFUNC SERCOM2_USART_ISR_RX_Handler( void )
 {
     uint16_t temp;
 
@@ -491,7 +491,7 @@ void static SERCOM2_USART_ISR_RX_Handler( void )
     }
 }
 
-void static SERCOM2_USART_ISR_TX_Handler( void )
+static void RAMFUNC SERCOM2_USART_ISR_TX_Handler( void )
 {
     bool  dataRegisterEmpty= false;
     bool  dataAvailable = false;
@@ -533,7 +533,7 @@ void static SERCOM2_USART_ISR_TX_Handler( void )
     }
 }
 
-void SERCOM2_USART_InterruptHandler( void )
+void RAMFUNC SERCOM2_USART_InterruptHandler( void )
 {
     bool testCondition = false;
     if(SERCOM2_REGS->USART_INT.SERCOM_INTENSET != 0U)
@@ -206,7 +206,7 @@ void TC0_TimerCallbackRegister( TC_TIMER_CALLBACK callback, uintptr_t context )
 }
 
 /* Timer Interrupt handler */
-void TC0_TimerInterruptHandler( void )
+void RAMFUNC TC0_TimerInterruptHandler( void )
 {
     if (TC0_REGS->COUNT32.TC_INTENSET != 0U)
     {
@@ -62,7 +62,8 @@ int read(int handle, void *buffer, unsigned int len)
 int write(int handle, void * buffer, size_t count)
 {
    bool success = false;
-   if (handle == 1)
+   /* Console text is dropped while a download sends its frames */
+   if ((handle == 1) && (APP_QUERY_IsIdle() == true))
    {
        do
        {
@@ -56,51 +56,66 @@
 // *****************************************************************************
 void SYS_CACHE_EnableCaches (void)
 {
+    ICACHE_ENABLE();
+    DCACHE_ENABLE();
 }
 
 void SYS_CACHE_DisableCaches (void)
 {
+    ICACHE_DISABLE();
+    DCACHE_DISABLE();
 }
 void SYS_CACHE_EnableICache (void)
 {
+    ICACHE_ENABLE();
 }
 
 void SYS_CACHE_DisableICache (void)
 {
+    ICACHE_DISABLE();
 }
 
 void SYS_CACHE_InvalidateICache (void)
 {
+    ICACHE_INVALIDATE();
 }
 
 void SYS_CACHE_EnableDCache (void)
 {
+    DCACHE_ENABLE();
 }
 
 void SYS_CACHE_DisableDCache (void)
 {
+    DCACHE_DISABLE();
 }
 
 void SYS_CACHE_InvalidateDCache (void)
 {
+    DCACHE_INVALIDATE();
 }
 
 void SYS_CACHE_CleanDCache (void)
 {
+    DCACHE_CLEAN();
 }
 
 void SYS_CACHE_CleanInvalidateDCache (void)
 {
+    DCACHE_CLEAN_INVALIDATE();
 }
 
 void SYS_CACHE_InvalidateDCache_by_Addr (uint32_t *addr, int32_t size)
 {
+    DCACHE_INVALIDATE_BY_ADDR(addr, size);
 }
 
 void SYS_CACHE_CleanDCache_by_Addr (uint32_t *addr, int32_t size)
 {
+    DCACHE_CLEAN_BY_ADDR(addr, size);
 }
 
 void SYS_CACHE_CleanInvalidateDCache_by_Addr (uint32_t *addr, int32_t size)
 {
+    DCACHE_CLEAN_INVALIDATE_BY_ADDR(addr, size);
 }
@@ -6801,10 +6801,9 @@ static void ftoa (
 int f_printf (
 	FIL* fp,			/* Pointer to the file object */
 	const TCHAR* fmt,	/* Pointer to the format string */
-	va_list argList		/* Optional arguments... */
+	va_list arp			/* Optional arguments... */
 )
 {
-	va_list arp = argList;
 	putbuff pb;
 	UINT i, j, w, f, r;
 	int prec;
@@ -33,11 +33,11 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_FASTSEEK	0
+#define FF_USE_FASTSEEK	1
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_EXPAND	0
+#define FF_USE_EXPAND	1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 
@@ -262,10 +262,10 @@
 */
 
 
-#define	FF_FS_MAX_FILES	1
+#define	FF_FS_MAX_FILES	4
 /* The FF_FS_MAX_FILES option is added to control file/directory related data structures */
 
-#define	FF_FS_LOCK	1
+#define	FF_FS_LOCK	4
 /* The option FF_FS_LOCK switches file lock function to control duplicated file open
 /  and illegal operation to open objects. This option must be 0 when FF_FS_READONLY
 /  is 1.
@@ -19,6 +19,29 @@ typedef struct
 
 static SYS_FS_DISK_DATA CACHE_ALIGN gSysFsDiskData[SYS_FS_MEDIA_NUMBER];
 
+#if (SYS_FS_FAT_WRITE_GATHER_SECTORS > 1)
+/* FatFs writes one sector at a time while a file grows. Runs of consecutive
+ * sectors are collected here and sent to the media as one multi-sector write.
+ * The run is written out before any access that must see it: a write that
+ * does not continue it, a read that overlaps it and CTRL_SYNC.
+ *
+ * Multi-sector writes from a cache aligned buffer are already a single
+ * multi-block command. They bypass the run and go to the media without a
+ * copy, so a caller that writes whole aligned sectors gets zero-copy DMA. */
+typedef struct
+{
+    uint8_t CACHE_ALIGN buffer[SYS_FS_FAT_WRITE_GATHER_SECTORS * SYS_FS_FAT_MAX_SS];
+
+    /* First sector of the run */
+    uint32_t startSector;
+
+    /* Number of sectors in the run */
+    uint32_t numSectors;
+} SYS_FS_DISK_WRITE_GATHER;
+
+static SYS_FS_DISK_WRITE_GATHER CACHE_ALIGN gSysFsDiskGather[SYS_FS_MEDIA_NUMBER];
+#endif
+
 void diskEventHandler
 (
     SYS_FS_MEDIA_BLOCK_EVENT event,
@@ -70,6 +93,48 @@ static DRESULT disk_checkCommandStatus(uint8_t pdrv)
     return result;
 }
 
+static DRESULT disk_write_media
+(
+    uint8_t pdrv,       /* Physical drive nmuber (0..) */
+    const uint8_t *buff,/* Data to be written */
+    uint32_t sector,    /* Sector address (LBA) */
+    uint32_t count       /* Number of sectors to write */
+)
+{
+    gSysFsDiskData[pdrv].commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
+
+    gSysFsDiskData[pdrv].commandHandle = SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID;
+
+    /* Submit the write request to media */
+    gSysFsDiskData[pdrv].commandHandle = SYS_FS_MEDIA_MANAGER_SectorWrite(pdrv /* DISK Number */ ,
+            sector /* Destination Sector*/,
+            (uint8_t *)buff /* Source Buffer */,
+            count /* Number of Sectors */);
+
+    return disk_checkCommandStatus(pdrv);
+}
+
+#if (SYS_FS_FAT_WRITE_GATHER_SECTORS > 1)
+/* Writes the gathered run to the media. The run is dropped even if the write
+ * fails; FatFs reports the error and stops using the file. */
+static DRESULT disk_gather_flush
+(
+    uint8_t pdrv
+)
+{
+    SYS_FS_DISK_WRITE_GATHER *gather = &gSysFsDiskGather[pdrv];
+    DRESULT result = RES_OK;
+
+    if (gather->numSectors > 0)
+    {
+        result = disk_write_media(pdrv, gather->buffer, gather->startSector, gather->numSectors);
+        gather->numSectors = 0;
+    }
+
+    return result;
+}
+#endif
+
 /* Definitions of physical drive number for each drive */
 #define DEV_RAM     0   /* Example: Map Ramdisk to physical drive 0 */
 #define DEV_MMC     1   /* Example: Map MMC/SD card to physical drive 1 */
@@ -103,6 +168,14 @@ DSTATUS disk_initialize (
         break;
     }
 
+#if (SYS_FS_FAT_WRITE_GATHER_SECTORS > 1)
+    /* Data gathered for a previously mounted card must not reach this one */
+    if (pdrv < SYS_FS_MEDIA_NUMBER)
+    {
+        gSysFsDiskGather[pdrv].numSectors = 0;
+    }
+#endif
+
     SYS_FS_MEDIA_MANAGER_RegisterTransferHandler( (void *) diskEventHandler );
     return 0;
 }
@@ -145,6 +218,21 @@ DRESULT disk_read
 {
     DRESULT result = RES_ERROR;
 
+#if (SYS_FS_FAT_WRITE_GATHER_SECTORS > 1)
+    SYS_FS_DISK_WRITE_GATHER *gather = &gSysFsDiskGather[pdrv];
+
+    if ((gather->numSectors > 0) &&
+        (sector < (gather->startSector + gather->numSectors)) &&
+        (gather->startSector < (sector + count)))
+    {
+        /* The media does not have the latest data for these sectors yet */
+        if (disk_gather_flush(pdrv) != RES_OK)
+        {
+            return RES_ERROR;
+        }
+    }
+#endif
+
     {
         result = disk_read_aligned(pdrv, buff, sector, count);
     }
@@ -167,18 +255,44 @@ DRESULT disk_write
 {
     DRESULT result = RES_ERROR;
 
+#if (SYS_FS_FAT_WRITE_GATHER_SECTORS > 1)
+    SYS_FS_DISK_WRITE_GATHER *gather = &gSysFsDiskGather[pdrv];
+    bool isDirect = ((count > 1) && (((uint32_t)buff % CACHE_LINE_SIZE) == 0));
+
+    if ((gather->numSectors > 0) &&
+        ((isDirect == true) ||
+         (sector != (gather->startSector + gather->numSectors)) ||
+         ((gather->numSectors + count) > SYS_FS_FAT_WRITE_GATHER_SECTORS)))
+    {
+        /* The write does not continue the run or does not fit behind it */
+        if (disk_gather_flush(pdrv) != RES_OK)
+        {
+            return RES_ERROR;
+        }
+    }
+
+    if ((isDirect == false) && (count < SYS_FS_FAT_WRITE_GATHER_SECTORS))
     {
-        gSysFsDiskData[pdrv].commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
+        if (gather->numSectors == 0)
+        {
+            gather->startSector = sector;
+        }
 
-        gSysFsDiskData[pdrv].commandHandle = SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE_INVALID;
+        memcpy(&gather->buffer[gather->numSectors * SYS_FS_FAT_MAX_SS], buff, count * SYS_FS_FAT_MAX_SS);
+        SYS_FS_MEDIA_MANAGER_WriteCopyCountAdd(pdrv, count * SYS_FS_FAT_MAX_SS);
+        gather->numSectors += count;
 
-        /* Submit the write request to media */
-        gSysFsDiskData[pdrv].commandHandle = SYS_FS_MEDIA_MANAGER_SectorWrite(pdrv /* DISK Number */ ,
-                sector /* Destination Sector*/,
-                (uint8_t *)buff /* Source Buffer */,
-                count /* Number of Sectors */);
+        if (gather->numSectors < SYS_FS_FAT_WRITE_GATHER_SECTORS)
+        {
+            return RES_OK;
+        }
 
-        result = disk_checkCommandStatus(pdrv);
+        return disk_gather_flush(pdrv);
+    }
+#endif
+
+    {
+        result = disk_write_media(pdrv, buff, sector, count);
     }
 
     return result;
@@ -221,6 +335,13 @@ DRESULT disk_ioctl (
 
         *(uint32_t *)buff = numSectors;
     }
+#if (SYS_FS_FAT_WRITE_GATHER_SECTORS > 1)
+    else if (cmd == CTRL_SYNC)
+    {
+        /* Complete any pending write process */
+        return disk_gather_flush(pdrv);
+    }
+#endif
 
     return RES_OK;
 }
@@ -2528,6 +2528,77 @@ SYS_FS_RESULT SYS_FS_FileSync
     return (fileStatus == 0) ? SYS_FS_RES_SUCCESS : SYS_FS_RES_FAILURE;
 }
 
+//******************************************************************************
+/*Function:
+    SYS_FS_RESULT SYS_FS_FileExpand
+    (
+        SYS_FS_HANDLE handle,
+        uint32_t size
+    );
+
+  Summary:
+    Preallocates a contiguous block of storage for a file
+
+  Description:
+    This function allocates a contiguous block of clusters of the given size
+    to an empty file.
+
+  Remarks:
+    See sys_fs.h for usage information.
+***************************************************************************/
+
+SYS_FS_RESULT SYS_FS_FileExpand
+(
+    SYS_FS_HANDLE handle,
+    uint32_t size
+)
+{
+    int fileStatus = -1;
+    SYS_FS_OBJ *fileObj = (SYS_FS_OBJ *)handle;
+    OSAL_RESULT osalResult = OSAL_RESULT_FALSE;
+
+    /* Check if the handle is valid. */
+    if (handle == SYS_FS_HANDLE_INVALID)
+    {
+        errorValue = SYS_FS_ERROR_INVALID_OBJECT;
+        return SYS_FS_RES_FAILURE;
+    }
+
+    /* Check if the file object is in use. */
+    if (fileObj->inUse == 0)
+    {
+        errorValue = SYS_FS_ERROR_INVALID_OBJECT;
+        return SYS_FS_RES_FAILURE;
+    }
+
+    if (fileObj->mountPoint->fsFunctions->expand == NULL)
+    {
+        fileObj->errorValue = SYS_FS_ERROR_NOT_SUPPORTED_IN_NATIVE_FS;
+        return SYS_FS_RES_FAILURE;
+    }
+
+    /* Clear the error */
+    fileObj->errorValue = SYS_FS_ERROR_OK;
+
+    /* Acquire the volume mutex. */
+    osalResult = OSAL_MUTEX_Lock(&(fileObj->mountPoint->mutexDiskVolume), OSAL_WAIT_FOREVER);
+    if (osalResult == OSAL_RESULT_TRUE)
+    {
+        fileStatus = fileObj->mountPoint->fsFunctions->expand(fileObj->nativeFSFileObj, size);
+
+        /* Release the acquired mutex. */
+        OSAL_MUTEX_Unlock(&(fileObj->mountPoint->mutexDiskVolume));
+
+        fileObj->errorValue = (SYS_FS_ERROR)fileStatus;
+    }
+    else
+    {
+        fileObj->errorValue = SYS_FS_ERROR_DENIED;
+    }
+
+    return (fileStatus == 0) ? SYS_FS_RES_SUCCESS : SYS_FS_RES_FAILURE;
+}
+
 //******************************************************************************
 /*Function:
     SYS_FS_RESULT SYS_FS_FileTruncate
@@ -2775,7 +2846,7 @@ SYS_FS_RESULT SYS_FS_FilePrintf
     int fileStatus = SYS_FS_ERROR_NOT_READY;
     SYS_FS_OBJ *fileObj = (SYS_FS_OBJ *)handle;
     int res = 0;
-    va_list ap = (va_list){0};
+    va_list ap;
     OSAL_RESULT osalResult = OSAL_RESULT_FALSE;
 
     /* Validate the parameters. */
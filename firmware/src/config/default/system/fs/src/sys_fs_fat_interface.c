@@ -21,6 +21,7 @@
 * THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
  *******************************************************************************/
 
+#include <string.h>
 #include "system/fs/sys_fs_fat_interface.h"
 #include "system/fs/sys_fs.h"
 
@@ -30,10 +31,17 @@ typedef struct
     FATFS volObj;
 } FATFS_VOLUME_OBJECT;
 
+/* Cluster link map size in items. A map for a contiguous file needs four:
+ * table size, fragment length, fragment start and terminator. */
+#define FATFS_LINKMAP_ITEMS     8
+
 typedef struct
 {
     uint8_t inUse;
     FIL fileObj;
+#if FF_USE_FASTSEEK
+    DWORD linkMap[FATFS_LINKMAP_ITEMS];
+#endif
 } FATFS_FILE_OBJECT;
 
 typedef struct
@@ -49,6 +57,19 @@ static uint8_t startupflag = 0;
 
 typedef UINT(*STREAM_FUNC)(const BYTE*,UINT);
 
+/* In fast seek mode FatFs cannot extend a file. Drop the link map before a
+ * write goes past the preallocated size, so that the file grows by following
+ * the FAT as usual. */
+static void FATFS_linkmap_release (FIL *fp, uint32_t btw)
+{
+#if FF_USE_FASTSEEK
+    if ((fp->cltbl != NULL) && ((f_tell(fp) + btw) > f_size(fp)))
+    {
+        fp->cltbl = NULL;
+    }
+#endif
+}
+
 int FATFS_mount ( uint8_t vol )
 {
     FATFS *fs = NULL;
@@ -454,6 +475,8 @@ int FATFS_write (
     FATFS_FILE_OBJECT *ptr = (FATFS_FILE_OBJECT *)handle;
     FIL *fp = &ptr->fileObj;
 
+    FATFS_linkmap_release(fp, btw);
+
     res = f_write(fp, buff, (UINT)btw, (UINT *)bw);
 
     return ((int)res);
@@ -590,6 +613,8 @@ int FATFS_putc (
     FATFS_FILE_OBJECT *ptr = (FATFS_FILE_OBJECT *)handle;
     FIL *fp = &ptr->fileObj;
 
+    FATFS_linkmap_release(fp, 1);
+
     return (f_putc((TCHAR)c, fp));
 }
 
@@ -601,6 +626,8 @@ int FATFS_puts (
     FATFS_FILE_OBJECT *ptr = (FATFS_FILE_OBJECT *)handle;
     FIL *fp = &ptr->fileObj;
 
+    FATFS_linkmap_release(fp, strlen(str));
+
     return (f_puts((const TCHAR *)str, fp));
 }
 
@@ -695,6 +722,38 @@ int FATFS_getclusters (
     return ((int)res);
 }
 
+int FATFS_expand (
+    uintptr_t handle,   /* Pointer to the file object */
+    uint32_t size       /* File size to be expanded to */
+)
+{
+    FRESULT res = FR_INT_ERR;
+    FATFS_FILE_OBJECT *ptr = (FATFS_FILE_OBJECT *)handle;
+    FIL *fp = &ptr->fileObj;
+
+    /* Allocate a contiguous block of clusters. The file size is set to the
+     * allocated size. */
+    res = f_expand(fp, (FSIZE_t)size, 1);
+
+#if FF_USE_FASTSEEK
+    if (res == FR_OK)
+    {
+        /* With the link map in place, writes and seeks within the block
+         * locate clusters without reading the FAT. */
+        ptr->linkMap[0] = FATFS_LINKMAP_ITEMS;
+        fp->cltbl = ptr->linkMap;
+
+        res = f_lseek(fp, CREATE_LINKMAP);
+        if (res != FR_OK)
+        {
+            fp->cltbl = NULL;
+        }
+    }
+#endif
+
+    return ((int)res);
+}
+
 int FATFS_getfree (
     const char* path,  /* Path name of the logical drive number */
     uint32_t* nclst,        /* Pointer to a variable to return number of free clusters */
@@ -883,6 +883,62 @@ SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE SYS_FS_MEDIA_MANAGER_SectorRead
     return (mediaObj->commandHandle);
 }
 
+//*****************************************************************************
+/* Function:
+    void SYS_FS_MEDIA_MANAGER_WriteCopyCountAdd
+    (
+        uint16_t diskNum,
+        uint32_t numBytes
+    );
+
+    Summary:
+      Records data copied before a sector write.
+
+  Remarks:
+    See sys_fs_media_manager.h for usage information.
+***************************************************************************/
+void SYS_FS_MEDIA_MANAGER_WriteCopyCountAdd
+(
+    uint16_t diskNum,
+    uint32_t numBytes
+)
+{
+    if (diskNum < SYS_FS_MEDIA_NUMBER)
+    {
+        gSYSFSMediaManagerObj.mediaObj[diskNum].writeStats.bytesCopied += numBytes;
+    }
+}
+
+//*****************************************************************************
+/* Function:
+    bool SYS_FS_MEDIA_MANAGER_WriteStatisticsGet
+    (
+        uint16_t diskNum,
+        SYS_FS_MEDIA_WRITE_STATISTICS *stats
+    );
+
+    Summary:
+      Gets the write statistics of a media.
+
+  Remarks:
+    See sys_fs_media_manager.h for usage information.
+***************************************************************************/
+bool SYS_FS_MEDIA_MANAGER_WriteStatisticsGet
+(
+    uint16_t diskNum,
+    SYS_FS_MEDIA_WRITE_STATISTICS *stats
+)
+{
+    if ((diskNum >= SYS_FS_MEDIA_NUMBER) || (stats == NULL))
+    {
+        return false;
+    }
+
+    *stats = gSYSFSMediaManagerObj.mediaObj[diskNum].writeStats;
+
+    return true;
+}
+
 //*****************************************************************************
 /* Function:
     SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE SYS_FS_MEDIA_MANAGER_Read
@@ -1013,6 +1069,9 @@ SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE SYS_FS_MEDIA_MANAGER_SectorWrite
 
     if ((sectorsPerBlock == 1) || (blocksPerSector > 0))
     {
+        /* The driver transfers straight from the caller's buffer */
+        mediaObj->writeStats.bytesWritten += ((uint64_t)numSectors * mediaWriteBlockSize);
+
         mediaObj->commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
         mediaObj->driverFunctions->sectorWrite (mediaObj->driverHandle, &(mediaObj->commandHandle), dataBuffer, sector, numSectors);
         return (mediaObj->commandHandle);
@@ -1063,6 +1122,7 @@ SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE SYS_FS_MEDIA_MANAGER_SectorWrite
                 /* Multiply by the sector size */
                 sectorOffsetInBlock <<= 9;
                 memcpy ((void *)&gSYSFSMediaBlockBuffer[sectorOffsetInBlock], (const void *)dataBuffer, numSectorsToWrite << 9);
+                mediaObj->writeStats.bytesCopied += (numSectorsToWrite << 9);
 
                 data = gSYSFSMediaBlockBuffer;
             }
@@ -1080,6 +1140,7 @@ SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE SYS_FS_MEDIA_MANAGER_SectorWrite
             }
 
             /* Write the block to the media */
+            mediaObj->writeStats.bytesWritten += mediaWriteBlockSize;
             mediaObj->commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
             mediaObj->driverFunctions->sectorWrite (mediaObj->driverHandle, &(mediaObj->commandHandle), data, memoryBlock, 1);
             while (mediaObj->commandStatus == SYS_FS_MEDIA_COMMAND_IN_PROGRESS)
@@ -1110,6 +1171,7 @@ SYS_FS_MEDIA_BLOCK_COMMAND_HANDLE SYS_FS_MEDIA_MANAGER_SectorWrite
     /* Unmute the event notification */
     gSYSFSMediaManagerObj.muteEventNotification = false;
 
+    mediaObj->writeStats.bytesWritten += mediaWriteBlockSize;
     mediaObj->commandStatus = SYS_FS_MEDIA_COMMAND_IN_PROGRESS;
     mediaObj->driverFunctions->sectorWrite (mediaObj->driverHandle, &(mediaObj->commandHandle), data, memoryBlock, 1);
 
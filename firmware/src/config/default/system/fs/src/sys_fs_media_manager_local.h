@@ -117,6 +117,9 @@ typedef struct _SYS_FS_MEDIA
     /* Pointer to the media geometry */
     SYS_FS_MEDIA_GEOMETRY *mediaGeometry;
 
+    /* Bytes written to the media and bytes copied on the way */
+    SYS_FS_MEDIA_WRITE_STATISTICS writeStats;
+
 } SYS_FS_MEDIA;
 
 // *****************************************************************************
@@ -579,6 +579,9 @@ typedef struct
     /* Function pointer of native file system to get total sectors and free
      * sectors */
     int(*getCluster)(const char *path, uint32_t *tot_sec, uint32_t *free_sec);
+    /* Function pointer of native file system to preallocate a contiguous
+     * block for a file */
+    int(*expand)(uintptr_t handle, uint32_t size);
 } SYS_FS_FUNCTIONS;
 
 // *****************************************************************************
@@ -2787,6 +2790,68 @@ SYS_FS_RESULT SYS_FS_FileTruncate
     SYS_FS_HANDLE handle
 );
 
+//******************************************************************************
+/* Function:
+    SYS_FS_RESULT SYS_FS_FileExpand
+    (
+        SYS_FS_HANDLE handle,
+        uint32_t size
+    );
+
+    Summary:
+      Preallocates a contiguous block of storage for a file
+
+    Description:
+      This function allocates a contiguous block of clusters of the given size
+      to an empty file and sets the file size to it. Data written inside the
+      block does not require any cluster allocation, and where the native file
+      system supports it (FatFs fast seek) the cluster chain is not read either.
+      Writes past the block extend the file in the usual way.
+
+    Precondition:
+      A valid file handle has to be passed as input to the function. The file
+      has to be empty and opened in a mode where writes to file is possible.
+
+    Parameters:
+      handle - A valid handle which was obtained while opening the file.
+
+      size - Size of the block in bytes.
+
+    Returns:
+      SYS_FS_RES_SUCCESS - The block was allocated.
+      SYS_FS_RES_FAILURE - The block could not be allocated. The reason for the
+                           failure can be retrieved with SYS_FS_Error or
+                           SYS_FS_FileError. SYS_FS_ERROR_DENIED indicates that
+                           no contiguous free area of the requested size exists.
+
+    Example:
+      <code>
+        SYS_FS_HANDLE fileHandle;
+
+        fileHandle = SYS_FS_FileOpen("/mnt/myDrive/FILE.txt",
+                (SYS_FS_FILE_OPEN_WRITE));
+
+        if(fileHandle != SYS_FS_HANDLE_INVALID)
+        {
+            if (SYS_FS_FileExpand(fileHandle, 1024 * 1024) != SYS_FS_RES_SUCCESS)
+            {
+                // Continue without preallocation.
+            }
+        }
+      </code>
+
+    Remarks:
+      The file size reported by SYS_FS_FileSize is the size of the block, not
+      the amount of data written. The application has to track the valid length
+      itself, and can truncate the file to it before closing.
+*/
+
+SYS_FS_RESULT SYS_FS_FileExpand
+(
+    SYS_FS_HANDLE handle,
+    uint32_t size
+);
+
 //******************************************************************************
 /* Function:
     SYS_FS_RESULT SYS_FS_FileSync
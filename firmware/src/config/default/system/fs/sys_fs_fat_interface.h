@@ -106,6 +106,8 @@ int FATFS_fdisk (uint8_t pdrv, const uint32_t szt[], void* work);
 
 int FATFS_getclusters (const char *path, uint32_t *tot_sec, uint32_t *free_sec);
 
+int FATFS_expand (uintptr_t handle, uint32_t size);
+
 
 #ifdef __cplusplus
 }
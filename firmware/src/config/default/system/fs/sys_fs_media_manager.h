@@ -470,6 +470,32 @@ typedef struct
 */
 typedef SYS_MEDIA_EVENT_HANDLER SYS_FS_MEDIA_EVENT_HANDLER;
 
+// *****************************************************************************
+/* Media write statistics
+
+  Summary:
+    Counts the bytes written to a media and how many of them were copied.
+
+  Description:
+    bytesWritten counts every byte handed to the media driver for writing.
+    bytesCopied counts the bytes that were first copied into an intermediate
+    buffer on the way, by the media manager's read-modify-write of large
+    blocks or by the disk layer's write gathering. Data written straight from
+    the caller's buffer by the driver's DMA is bytesWritten - bytesCopied.
+
+  Remarks:
+    None.
+*/
+typedef struct
+{
+    /* Bytes handed to the media driver */
+    uint64_t bytesWritten;
+
+    /* Bytes copied into an intermediate buffer before being written */
+    uint64_t bytesCopied;
+
+} SYS_FS_MEDIA_WRITE_STATISTICS;
+
 //*****************************************************************************
 /* Function:
     SYS_FS_MEDIA_COMMAND_STATUS SYS_FS_MEDIA_MANAGER_CommandStatusGet
@@ -916,6 +942,70 @@ void SYS_FS_MEDIA_MANAGER_TransferTask
     uint8_t mediaIndex
 );
 
+//*****************************************************************************
+/* Function:
+    void SYS_FS_MEDIA_MANAGER_WriteCopyCountAdd
+    (
+        uint16_t diskNum,
+        uint32_t numBytes
+    );
+
+  Summary:
+    Records data copied before a sector write.
+
+  Description:
+    The disk io layer calls this function when it copies data into its own
+    buffer before writing it with SYS_FS_MEDIA_MANAGER_SectorWrite, so that
+    the copy shows in the write statistics.
+
+  Precondition:
+    None.
+
+  Parameters:
+    diskNum  - Media disk number.
+    numBytes - Number of bytes copied.
+
+  Returns:
+    None.
+*/
+void SYS_FS_MEDIA_MANAGER_WriteCopyCountAdd
+(
+    uint16_t diskNum,
+    uint32_t numBytes
+);
+
+//*****************************************************************************
+/* Function:
+    bool SYS_FS_MEDIA_MANAGER_WriteStatisticsGet
+    (
+        uint16_t diskNum,
+        SYS_FS_MEDIA_WRITE_STATISTICS *stats
+    );
+
+  Summary:
+    Gets the write statistics of a media.
+
+  Description:
+    This function returns the number of bytes written to the media and the
+    number of them that were copied on the way. A write path that is
+    zero-copy end to end leaves bytesCopied unchanged.
+
+  Precondition:
+    None.
+
+  Parameters:
+    diskNum - Media disk number.
+    stats   - Pointer to the structure that receives the statistics.
+
+  Returns:
+    true on Success else false.
+*/
+bool SYS_FS_MEDIA_MANAGER_WriteStatisticsGet
+(
+    uint16_t diskNum,
+    SYS_FS_MEDIA_WRITE_STATISTICS *stats
+);
+
 //*****************************************************************************
 /* Function:
     void SYS_FS_MEDIA_MANAGER_Tasks
@@ -153,7 +153,7 @@ static SYS_TIME_TIMER_OBJ* SYS_TIME_GetTimerObject(SYS_TIME_HANDLE handle)
     return NULL;
 }
 
-static void SYS_TIME_HwTimerCompareUpdate(void)
+static void RAMFUNC SYS_TIME_HwTimerCompareUpdate(void)
 {
     uint64_t nextHwCounterValue = 0;
     uint64_t currHwCounterValue;
@@ -319,15 +319,16 @@ static bool SYS_TIME_AddToList(SYS_TIME_TIMER_OBJ* newTimer)
     return isHeadTimerUpdated;
 }
 
-static uint32_t SYS_TIME_GetElapsedCount(uint32_t hwTimerCurrentValue)
+static uint32_t RAMFUNC SYS_TIME_GetElapsedCount(uint32_t hwTimerCurrentValue)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
     uint32_t elapsedCount = 0;
     uint32_t hwTimerPreviousValue = counterObj->hwTimerPreviousValue;
 
     /* Calculate the elapsed time since the last time the timers in the list
-     * were updated. */
-    if (hwTimerCurrentValue > hwTimerPreviousValue)
+     * were updated. Equal values mean no time has elapsed, not a full period,
+     * which matters when the counter period is less than 32 bits. */
+    if (hwTimerCurrentValue >= hwTimerPreviousValue)
     {
         elapsedCount = hwTimerCurrentValue - hwTimerPreviousValue;
     }
@@ -387,7 +388,7 @@ static uint32_t SYS_TIME_GetTotalElapsedCount(SYS_TIME_TIMER_OBJ* tmr)
     return elapsedCount;
 }
 
-static void SYS_TIME_UpdateTimerList(uint32_t elapsedCount)
+static void RAMFUNC SYS_TIME_UpdateTimerList(uint32_t elapsedCount)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
     SYS_TIME_TIMER_OBJ* tmr = NULL;
@@ -483,7 +484,7 @@ static void SYS_TIME_ClientNotify(void)
     }
 }
 
-static void SYS_TIME_UpdateTime(uint32_t elapsedCounts)
+static void RAMFUNC SYS_TIME_UpdateTime(uint32_t elapsedCounts)
 {
     uint8_t i;
 
@@ -517,7 +518,7 @@ static void SYS_TIME_UpdateTime(uint32_t elapsedCounts)
     }
 }
 
-static void SYS_TIME_PLIBCallback(uint32_t status, uintptr_t context)
+static void RAMFUNC SYS_TIME_PLIBCallback(uint32_t status, uintptr_t context)
 {
     SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
     SYS_TIME_TIMER_OBJ* tmrActive = counterObj->tmrActive;
@@ -1084,3 +1085,92 @@ SYS_TIME_HANDLE SYS_TIME_CallbackRegisterMS ( SYS_TIME_CALLBACK callback, uintpt
 
     return handle;
 }
+
+// *****************************************************************************
+// *****************************************************************************
+// Section:  SYS TIME Low Power Functions
+// *****************************************************************************
+// *****************************************************************************
+uint32_t SYS_TIME_DeadlineCountGet ( void )
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ* )&gSystemCounterObj;
+    SYS_TIME_TIMER_OBJ* tmrActive;
+    uint32_t deadline = SYS_TIME_DEADLINE_NONE;
+    uint32_t elapsedCount;
+    uint32_t relativeTimePending;
+    bool interruptState;
+
+    interruptState = SYS_INT_Disable();
+
+    tmrActive = counterObj->tmrActive;
+    if (tmrActive != NULL)
+    {
+        /* The head of the list holds the time left relative to the last list update */
+        elapsedCount = SYS_TIME_GetElapsedCount(counterObj->timePlib->timerCounterGet());
+        relativeTimePending = tmrActive->relativeTimePending;
+
+        if (relativeTimePending > elapsedCount)
+        {
+            deadline = relativeTimePending - elapsedCount;
+        }
+        else
+        {
+            deadline = 0;
+        }
+    }
+
+    SYS_INT_Restore(interruptState);
+
+    return deadline;
+}
+
+void SYS_TIME_SleepCompensate ( uint32_t count )
+{
+    SYS_TIME_COUNTER_OBJ* counterObj = (SYS_TIME_COUNTER_OBJ *)&gSystemCounterObj;
+    uint32_t elapsedCount;
+    uint32_t stepCount;
+    bool interruptState;
+
+    if (counterObj->status != SYS_STATUS_READY)
+    {
+        return;
+    }
+
+    /* Run with interrupts disabled so that this behaves exactly like the timer
+     * interrupt. Timer callbacks rely on the nesting count to skip the mutex. */
+    interruptState = SYS_INT_Disable();
+
+    counterObj->hwTimerCurrentValue = counterObj->timePlib->timerCounterGet();
+    elapsedCount = SYS_TIME_GetElapsedCount(counterObj->hwTimerCurrentValue);
+
+    do
+    {
+        /* Apply long sleeps in steps so that periodic timers are reloaded
+         * every time they expire and the pending counts never overflow */
+        stepCount = count;
+        if (stepCount > SYS_TIME_HW_COUNTER_HALF_PERIOD)
+        {
+            stepCount = SYS_TIME_HW_COUNTER_HALF_PERIOD;
+        }
+        count -= stepCount;
+        elapsedCount += stepCount;
+
+        counterObj->swCounter64 = counterObj->swCounter64 + elapsedCount;
+
+        if (counterObj->tmrActive != NULL)
+        {
+            counterObj->interruptNestingCount++;
+
+            SYS_TIME_UpdateTime(elapsedCount);
+
+            counterObj->interruptNestingCount--;
+        }
+
+        counterObj->hwTimerPreviousValue = counterObj->hwTimerCurrentValue;
+        elapsedCount = 0;
+    } while (count > 0U);
+
+    SYS_TIME_HwTimerCompareUpdate();
+
+    SYS_INT_Restore(interruptState);
+}
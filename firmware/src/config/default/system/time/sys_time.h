@@ -1424,6 +1424,91 @@ SYS_TIME_RESULT SYS_TIME_TimerStop ( SYS_TIME_HANDLE handle );
 bool SYS_TIME_TimerPeriodHasExpired ( SYS_TIME_HANDLE handle );
 
 
+// *****************************************************************************
+// *****************************************************************************
+// Section:  SYS TIME Low Power Interface Functions
+// *****************************************************************************
+// *****************************************************************************
+
+// *****************************************************************************
+/* Function:
+    uint32_t SYS_TIME_DeadlineCountGet ( void )
+
+  Summary:
+    Returns the number of counts until the next software timer expires.
+
+  Description:
+    This function returns the number of hardware counter counts left before the
+    earliest active software timer expires. An idle loop uses it to decide how
+    long the CPU may sleep without delaying any timer callback.
+
+  Precondition:
+    The SYS_TIME_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    None.
+
+  Returns:
+    Counts remaining until the next timer expiry, 0 if a timer is already due,
+    or SYS_TIME_DEADLINE_NONE if no software timer is running.
+
+  Example:
+    <code>
+    if (SYS_TIME_DeadlineCountGet() > SYS_TIME_MSToCount(2))
+    {
+        PM_IdleModeEnter();
+    }
+    </code>
+
+  Remarks:
+    The hardware compare is already programmed for this deadline, so sleeping in
+    a mode where the timer keeps running needs no further action.
+*/
+
+#define SYS_TIME_DEADLINE_NONE      (0xFFFFFFFFU)
+
+uint32_t SYS_TIME_DeadlineCountGet ( void );
+
+
+// *****************************************************************************
+/* Function:
+    void SYS_TIME_SleepCompensate ( uint32_t count )
+
+  Summary:
+    Accounts for time during which the hardware counter was stopped.
+
+  Description:
+    When the device enters a sleep mode that stops the hardware timer clock,
+    the 64-bit counter and the software timers fall behind real time. This
+    function adds the given number of counts, measured by another time base,
+    to the system counter, expires any software timers that became due and
+    reprograms the hardware compare.
+
+  Precondition:
+    The SYS_TIME_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    count  - Number of counts (at SYS_TIME_FrequencyGet) the timer was stopped.
+
+  Returns:
+    None.
+
+  Example:
+    <code>
+    PM_StandbyModeEnter();
+    SYS_TIME_SleepCompensate(sleepSeconds * SYS_TIME_FrequencyGet());
+    </code>
+
+  Remarks:
+    Callbacks of expired timers are called from within this function with
+    interrupts disabled, the same way they are called from the timer interrupt.
+*/
+
+void SYS_TIME_SleepCompensate ( uint32_t count );
+
+
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
 
@@ -76,6 +76,9 @@ void SYS_Tasks ( void )
     DRV_SDMMC_Tasks(sysObj.drvSDMMC0);
 
     /* Maintain Device Drivers */
+#if (DRV_BME280_REPLAY == 1)
+    DRV_BME280_REPLAY_Tasks();
+#endif
     DRV_BME280_Tasks(sysObj.drvBME280);
 
     /* Maintain Middleware & Other Libraries */
@@ -87,6 +90,24 @@ void SYS_Tasks ( void )
 
     /* Call Application task APP_SDCARD. */
     APP_SDCARD_Tasks();
+
+    /* Call Application task APP_FLASHLOG after APP_SDCARD. */
+    APP_FLASHLOG_Tasks();
+
+    /* Call Application task APP_QUERY after APP_SDCARD. */
+    APP_QUERY_Tasks();
+
+    /* Call Application task APP_CONFIG. */
+    APP_CONFIG_Tasks();
+
+    /* Call Application task APP_TIMESTAMP. */
+    APP_TIMESTAMP_Tasks();
+
+    /* Call Application task APP_TRACE after the tasks it follows. */
+    APP_TRACE_Tasks();
+
+    /* Call Application task APP_POWER last. It sleeps until the next event. */
+    APP_POWER_Tasks();
 }
 
 /*******************************************************************************
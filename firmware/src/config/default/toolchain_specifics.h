@@ -43,6 +43,18 @@ extern "C" {
 #define NO_INIT        __attribute__((section(".no_init")))
 #define SECTION(a)     __attribute__((__section__(a)))
 
+/* Functions copied to SRAM with the initialized data at startup and run from
+ * there, clear of the flash wait states and cache misses. They are listed in
+ * the .ramfunc sections of the map file; tools/ramfunc_check lists them from
+ * the map and checks that every RAMFUNC function is there. Define
+ * RAMFUNC_DISABLE to leave them in flash; console key 6 of app.c prints the
+ * interrupt cycles of either build. */
+#ifndef RAMFUNC_DISABLE
+#define RAMFUNC        __attribute__((ramfunc, long_call, noinline))
+#else
+#define RAMFUNC
+#endif
+
 #define CACHE_LINE_SIZE    (16u)
 #define CACHE_ALIGN        __ALIGNED(CACHE_LINE_SIZE)
 
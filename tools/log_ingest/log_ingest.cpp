@@ -0,0 +1,1068 @@
+/*******************************************************************************
+  Weather Log Ingester
+
+  File Name:
+    log_ingest.cpp
+
+  Summary:
+    Converts the weather logs of the SD card to a columnar binary file.
+
+  Description:
+    Reads the data_*.txt logs (and the older data_log.txt) written by the
+    firmware and writes their records to one columnar file for analysis.
+    The files are memory mapped and cut into chunks at line ends, and the
+    chunks are parsed in parallel, one thread per core by default. Line ends
+    are found with memchr, which the C library vectorizes; the fields are
+    read by a hand-written scanner that knows the record layout, without
+    sscanf or strtod.
+
+    Records, as written by APP_SDCARD_RecordLog:
+
+        [YYYY/MM/DD hh:mm:ss.mmm] T P H [Td AH Alt SLP] [*SSSSSSSS CCCC]
+
+    The milliseconds, the four derived quantities and the journal seal are
+    optional. A log that starts with the "#LOG len=" header is read up to
+    the valid length it gives. As the firmware does when it resumes a log,
+    the records that follow it are then taken while their seal is valid and
+    their sequence numbers continue. With a header, each seal is checked
+    against its CRC-16 and a record with a bad seal is rejected; lines that
+    do not parse are rejected too, and counted.
+
+    Output file, little endian:
+
+        file header     "HDCCOL01", uint32 column count, uint32 0, then per
+                        column char name[16], uint32 type, uint32 size
+        row groups      uint32 "RGRP", uint32 rows, uint32 log index,
+                        uint32 0, then each column as rows * size bytes
+        log table       uint32 count, then per log uint32 length and name
+        trailer         uint64 offset of the log table, "HDCEND01"
+
+    The columns are time_ms (int64, milliseconds since 1970 of the logged
+    time, which has no time zone), temperature (degC), pressure (hPa),
+    humidity (%RH), dew_point (degC), abs_humidity (g/m^3), altitude (m) and
+    sea_level (hPa) as float32, NaN for a derived quantity that was not
+    logged, and sequence (uint32, 0xFFFFFFFF without a seal). A row group
+    holds the records of one chunk of one log, in the order of the log; the
+    logs are taken in name order, which is time order.
+
+    Build:
+
+        c++ -O2 -std=c++17 -pthread -o log_ingest log_ingest.cpp
+
+    Use:
+
+        log_ingest [-j threads] [-o out.col] [--no-crc] <log or dir>...
+        log_ingest generate <dir> <megabytes> [logs]
+
+    The time taken and the throughput are printed after each conversion;
+    "generate" writes synthetic logs in the firmware's format to measure it
+    on logs of any size.
+*******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/* Log layout, as in app_sdcard.c */
+constexpr size_t      LOG_HEADER_LEN = 32;
+constexpr const char  LOG_HEADER_TAG[] = "#LOG len=";
+constexpr size_t      LOG_BUFFER_SIZE = 1024;
+constexpr size_t      LOG_RECORD_LEN = 128;
+
+/* Chunks are at least this long, so that small logs are not split */
+constexpr size_t      CHUNK_SIZE = 8U * 1024U * 1024U;
+
+constexpr uint32_t    NO_SEQUENCE = 0xFFFFFFFFU;
+
+enum Column
+{
+    COLUMN_TIME = 0,
+    COLUMN_TEMPERATURE,
+    COLUMN_PRESSURE,
+    COLUMN_HUMIDITY,
+    COLUMN_DEW_POINT,
+    COLUMN_ABS_HUMIDITY,
+    COLUMN_ALTITUDE,
+    COLUMN_SEA_LEVEL,
+    COLUMN_SEQUENCE,
+    COLUMNS
+};
+
+enum ColumnType : uint32_t
+{
+    TYPE_INT64 = 1,
+    TYPE_FLOAT32 = 2,
+    TYPE_UINT32 = 3,
+};
+
+struct ColumnInfo
+{
+    const char* name;
+    ColumnType  type;
+    uint32_t    size;
+};
+
+const ColumnInfo columnInfo[COLUMNS] =
+{
+    { "time_ms",      TYPE_INT64,   8 },
+    { "temperature",  TYPE_FLOAT32, 4 },
+    { "pressure",     TYPE_FLOAT32, 4 },
+    { "humidity",     TYPE_FLOAT32, 4 },
+    { "dew_point",    TYPE_FLOAT32, 4 },
+    { "abs_humidity", TYPE_FLOAT32, 4 },
+    { "altitude",     TYPE_FLOAT32, 4 },
+    { "sea_level",    TYPE_FLOAT32, 4 },
+    { "sequence",     TYPE_UINT32,  4 },
+};
+
+/* CRC-16/CCITT-FALSE, as the seal of the firmware. entries[k][b] is the CRC
+ * of the byte b followed by k zero bytes, so that eight bytes are taken at a
+ * time with independent lookups. */
+struct Crc16Table
+{
+    uint16_t entries[8][256];
+
+    Crc16Table()
+    {
+        for (uint32_t i = 0; i < 256U; i++)
+        {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc & 0x8000U) ? static_cast<uint16_t>((crc << 1) ^ 0x1021U) : static_cast<uint16_t>(crc << 1);
+            }
+            entries[0][i] = crc;
+        }
+
+        for (int k = 1; k < 8; k++)
+        {
+            for (uint32_t i = 0; i < 256U; i++)
+            {
+                const uint16_t crc = entries[k - 1][i];
+
+                entries[k][i] = static_cast<uint16_t>((crc << 8) ^ entries[0][crc >> 8]);
+            }
+        }
+    }
+};
+
+const Crc16Table crcTable;
+
+uint16_t Crc16(uint16_t crc, const uint8_t* data, size_t length)
+{
+    const uint16_t (*t)[256] = crcTable.entries;
+
+    while (length >= 8U)
+    {
+        crc = static_cast<uint16_t>(t[7][data[0] ^ (crc >> 8)] ^ t[6][data[1] ^ (crc & 0xFFU)] ^
+                                    t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^
+                                    t[1][data[6]] ^ t[0][data[7]]);
+        data += 8;
+        length -= 8U;
+    }
+
+    while (length-- > 0U)
+    {
+        crc = static_cast<uint16_t>((crc << 8) ^ t[0][((crc >> 8) ^ *data++) & 0xFFU]);
+    }
+
+    return crc;
+}
+
+uint16_t RecordCrc(uint32_t session, const char* record, size_t length)
+{
+    const uint8_t bytes[4] =
+    {
+        static_cast<uint8_t>(session >> 24), static_cast<uint8_t>(session >> 16),
+        static_cast<uint8_t>(session >> 8), static_cast<uint8_t>(session),
+    };
+
+    return Crc16(Crc16(0xFFFFU, bytes, sizeof(bytes)), reinterpret_cast<const uint8_t*>(record), length);
+}
+
+// *****************************************************************************
+// Scanner
+// *****************************************************************************
+
+struct Record
+{
+    int64_t     timeMs;
+    float       values[7];
+    uint32_t    sequence;
+};
+
+inline bool IsDigit(char c)
+{
+    return static_cast<unsigned char>(c - '0') <= 9U;
+}
+
+inline int Digits2(const char* p)
+{
+    return ((p[0] - '0') * 10) + (p[1] - '0');
+}
+
+inline int HexDigit(char c)
+{
+    if (IsDigit(c))
+    {
+        return c - '0';
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+bool HexParse(const char* p, int count, uint32_t* value)
+{
+    uint32_t v = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        int d = HexDigit(p[i]);
+
+        if (d < 0)
+        {
+            return false;
+        }
+        v = (v << 4) | static_cast<uint32_t>(d);
+    }
+
+    *value = v;
+    return true;
+}
+
+/* Days from 1970-01-01 to a civil date */
+int64_t DaysFromCivil(int y, int m, int d)
+{
+    y -= (m <= 2) ? 1 : 0;
+    const int era = ((y >= 0) ? y : (y - 399)) / 400;
+    const int yoe = y - (era * 400);
+    const int doy = (((153 * (m + ((m > 2) ? -3 : 9))) + 2) / 5) + d - 1;
+    const int doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+
+    return (static_cast<int64_t>(era) * 146097) + doe - 719468;
+}
+
+/* A decimal number as sprintf("%f") writes it */
+bool NumberParse(const char*& p, const char* end, float* value)
+{
+    static const double scale[] = { 1.0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9 };
+    bool isNegative = false;
+    int64_t mantissa = 0;
+    int fraction = 0;
+    int digits = 0;
+
+    if ((p < end) && (*p == '-'))
+    {
+        isNegative = true;
+        p++;
+    }
+
+    while ((p < end) && IsDigit(*p) && (digits < 18))
+    {
+        mantissa = (mantissa * 10) + (*p++ - '0');
+        digits++;
+    }
+
+    if ((p < end) && (*p == '.'))
+    {
+        p++;
+        while ((p < end) && IsDigit(*p) && (fraction < 9))
+        {
+            mantissa = (mantissa * 10) + (*p++ - '0');
+            fraction++;
+            digits++;
+        }
+    }
+
+    if ((digits == 0) || ((p < end) && IsDigit(*p)))
+    {
+        return false;
+    }
+
+    /* Rounded to float, the product is as exact as the quotient */
+    double v = static_cast<double>(mantissa) * scale[fraction];
+    *value = static_cast<float>(isNegative ? -v : v);
+    return true;
+}
+
+/* Parse one line, without its '\n'. sealStart receives the offset of the
+ * seal, or 0 if there is none. */
+bool LineParse(const char* line, const char* end, Record* record, size_t* sealStart)
+{
+    const char* p = line;
+    int fieldCount = 0;
+
+    if ((end > p) && (end[-1] == '\r'))
+    {
+        end--;
+    }
+
+    /* "[YYYY/MM/DD hh:mm:ss" */
+    if (((end - p) < 21) || (p[0] != '[') || (p[5] != '/') || (p[8] != '/') || (p[11] != ' ') ||
+        (p[14] != ':') || (p[17] != ':'))
+    {
+        return false;
+    }
+
+    for (int i : { 1, 2, 3, 4, 6, 7, 9, 10, 12, 13, 15, 16, 18, 19 })
+    {
+        if (!IsDigit(p[i]))
+        {
+            return false;
+        }
+    }
+
+    const int year = (Digits2(&p[1]) * 100) + Digits2(&p[3]);
+    const int month = Digits2(&p[6]);
+    const int day = Digits2(&p[9]);
+    int64_t ms = 0;
+
+    if ((month < 1) || (month > 12) || (day < 1) || (day > 31))
+    {
+        return false;
+    }
+
+    p += 20;
+
+    if (*p == '.')
+    {
+        if (((end - p) < 5) || !IsDigit(p[1]) || !IsDigit(p[2]) || !IsDigit(p[3]))
+        {
+            return false;
+        }
+        ms = ((p[1] - '0') * 100) + ((p[2] - '0') * 10) + (p[3] - '0');
+        p += 4;
+    }
+
+    if ((p >= end) || (*p != ']'))
+    {
+        return false;
+    }
+    p++;
+
+    /* The date changes once a day in a log, so the days are only computed
+     * again when it does */
+    static thread_local int lastDate = 0;
+    static thread_local int64_t lastDays = 0;
+    const int date = (year * 10000) + (month * 100) + day;
+
+    if (date != lastDate)
+    {
+        lastDate = date;
+        lastDays = DaysFromCivil(year, month, day);
+    }
+
+    record->timeMs = ((((lastDays * 24) + Digits2(&line[12])) * 60 + Digits2(&line[15])) * 60 +
+                      Digits2(&line[18])) * 1000 + ms;
+    record->sequence = NO_SEQUENCE;
+    *sealStart = 0;
+
+    while (true)
+    {
+        const char* field = p;
+
+        while ((p < end) && (*p == ' '))
+        {
+            p++;
+        }
+
+        if (p == end)
+        {
+            break;
+        }
+
+        if (p == field)
+        {
+            return false;
+        }
+
+        if (*p == '*')
+        {
+            /* " *SSSSSSSS CCCC" ends the record */
+            if (((end - p) != 14) || (p[9] != ' ') || !HexParse(&p[1], 8, &record->sequence))
+            {
+                return false;
+            }
+            *sealStart = static_cast<size_t>(p - 1 - line);
+            break;
+        }
+
+        if ((fieldCount == 7) || !NumberParse(p, end, &record->values[fieldCount]))
+        {
+            return false;
+        }
+        fieldCount++;
+    }
+
+    if ((fieldCount != 3) && (fieldCount != 7))
+    {
+        return false;
+    }
+
+    for (int i = fieldCount; i < 7; i++)
+    {
+        record->values[i] = std::nanf("");
+    }
+
+    return true;
+}
+
+bool SealCheck(const char* line, size_t sealStart, uint32_t session)
+{
+    uint32_t crc;
+
+    /* The CRC covers the record up to the end of the sequence number */
+    return HexParse(&line[sealStart + 11], 4, &crc) &&
+           (crc == RecordCrc(session, line, sealStart + 10));
+}
+
+// *****************************************************************************
+// Logs and chunks
+// *****************************************************************************
+
+struct Log
+{
+    std::string name;
+    const char* data = nullptr;
+    size_t      size = 0;
+
+    /* Records end before validEnd; a journal may continue after it */
+    size_t      dataStart = 0;
+    size_t      validEnd = 0;
+    bool        isJournal = false;
+    uint32_t    session = 0;
+};
+
+struct Chunk
+{
+    uint32_t    logIndex;
+    size_t      begin;
+    size_t      end;
+    bool        isLast;
+};
+
+struct Result
+{
+    uint32_t                logIndex = 0;
+    std::vector<int64_t>    times;
+    std::vector<float>      values[7];
+    std::vector<uint32_t>   sequences;
+    uint64_t                rejected = 0;
+
+    void Reserve(size_t rows)
+    {
+        times.reserve(rows);
+        for (std::vector<float>& column : values)
+        {
+            column.reserve(rows);
+        }
+        sequences.reserve(rows);
+    }
+
+    void Append(const Record& record)
+    {
+        times.push_back(record.timeMs);
+        for (int i = 0; i < 7; i++)
+        {
+            values[i].push_back(record.values[i]);
+        }
+        sequences.push_back(record.sequence);
+    }
+};
+
+struct Options
+{
+    unsigned    threads = 0;
+    std::string output = "weather.col";
+    bool        isCrcChecked = true;
+};
+
+bool LogOpen(Log& log)
+{
+    int fd = open(log.name.c_str(), O_RDONLY);
+    struct stat st;
+
+    if (fd < 0)
+    {
+        std::fprintf(stderr, "%s: %s\n", log.name.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    if (fstat(fd, &st) != 0)
+    {
+        std::fprintf(stderr, "%s: %s\n", log.name.c_str(), std::strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    log.size = static_cast<size_t>(st.st_size);
+
+    if (log.size > 0U)
+    {
+        void* map = mmap(nullptr, log.size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map == MAP_FAILED)
+        {
+            std::fprintf(stderr, "%s: %s\n", log.name.c_str(), std::strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        madvise(map, log.size, MADV_SEQUENTIAL | MADV_WILLNEED);
+        log.data = static_cast<const char*>(map);
+    }
+
+    close(fd);
+
+    log.dataStart = 0;
+    log.validEnd = log.size;
+
+    /* "#LOG len=NNNNNNNNNN s=XXXXXXXX\r\n" */
+    if ((log.size >= LOG_HEADER_LEN) &&
+        (std::memcmp(log.data, LOG_HEADER_TAG, sizeof(LOG_HEADER_TAG) - 1U) == 0))
+    {
+        size_t length = 0;
+        const char* p = log.data + sizeof(LOG_HEADER_TAG) - 1U;
+
+        for (int i = 0; i < 10; i++)
+        {
+            length = IsDigit(p[i]) ? ((length * 10U) + static_cast<size_t>(p[i] - '0')) : 0U;
+        }
+
+        log.dataStart = LOG_HEADER_LEN;
+        log.validEnd = std::min(std::max(length, LOG_HEADER_LEN), log.size);
+        log.isJournal = (p[10] == ' ') && (p[11] == 's') && (p[12] == '=') && HexParse(&p[13], 8, &log.session);
+    }
+
+    return true;
+}
+
+/* Cut the valid part of a log into chunks that start at a line */
+void ChunksMake(const Log& log, uint32_t logIndex, std::vector<Chunk>& chunks)
+{
+    size_t begin = log.dataStart;
+
+    while (true)
+    {
+        size_t end = begin + CHUNK_SIZE;
+
+        if (end >= log.validEnd)
+        {
+            chunks.push_back({ logIndex, begin, log.validEnd, true });
+            return;
+        }
+
+        const void* eol = std::memchr(log.data + end, '\n', log.validEnd - end);
+
+        if (eol == nullptr)
+        {
+            chunks.push_back({ logIndex, begin, log.validEnd, true });
+            return;
+        }
+
+        end = static_cast<size_t>(static_cast<const char*>(eol) - log.data) + 1U;
+        chunks.push_back({ logIndex, begin, end, end == log.validEnd });
+
+        if (end == log.validEnd)
+        {
+            return;
+        }
+        begin = end;
+    }
+}
+
+/* Parse the lines that end in [begin, end). The start of the first line not
+ * ended there is returned. */
+size_t LinesParse(const Log& log, size_t begin, size_t end, bool isCrcChecked, Result& result,
+                  uint32_t* lastSequence)
+{
+    const char* p = log.data + begin;
+    const char* stop = log.data + end;
+    Record record;
+    size_t sealStart;
+
+    while (p < stop)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(stop - p)));
+
+        if (eol == nullptr)
+        {
+            break;
+        }
+
+        if (LineParse(p, eol, &record, &sealStart) &&
+            (!log.isJournal || !isCrcChecked || (sealStart == 0U) || SealCheck(p, sealStart, log.session)))
+        {
+            result.Append(record);
+            *lastSequence = record.sequence;
+        }
+        else if (eol > p)
+        {
+            result.rejected++;
+        }
+
+        p = eol + 1;
+    }
+
+    return static_cast<size_t>(p - log.data);
+}
+
+/* After the valid length, take the records that continue the sequence with a
+ * valid seal, as the firmware recovers them */
+void JournalTailParse(const Log& log, size_t begin, uint32_t lastSequence, Result& result)
+{
+    const size_t end = std::min(log.size, log.validEnd + LOG_BUFFER_SIZE);
+    const char* p = log.data + begin;
+    const char* stop = log.data + end;
+    Record record;
+    size_t sealStart;
+
+    while (p < stop)
+    {
+        const size_t limit = std::min(static_cast<size_t>(stop - p), LOG_RECORD_LEN);
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', limit));
+
+        if ((eol == nullptr) || !LineParse(p, eol, &record, &sealStart) || (sealStart == 0U) ||
+            (record.sequence != (lastSequence + 1U)) || !SealCheck(p, sealStart, log.session))
+        {
+            return;
+        }
+
+        result.Append(record);
+        lastSequence = record.sequence;
+        p = eol + 1;
+    }
+}
+
+void ChunkParse(const Log& log, const Chunk& chunk, bool isCrcChecked, Result& result)
+{
+    uint32_t lastSequence = NO_SEQUENCE;
+    size_t next;
+
+    result.logIndex = chunk.logIndex;
+    result.Reserve((chunk.end - chunk.begin) / 64U);
+    next = LinesParse(log, chunk.begin, chunk.end, isCrcChecked, result, &lastSequence);
+
+    if (chunk.isLast && log.isJournal && (lastSequence != NO_SEQUENCE))
+    {
+        JournalTailParse(log, next, lastSequence, result);
+    }
+    else if (chunk.isLast && (next < chunk.end) && !log.isJournal)
+    {
+        /* A last line without its line end */
+        Record record;
+        size_t sealStart;
+
+        if (LineParse(log.data + next, log.data + chunk.end, &record, &sealStart))
+        {
+            result.Append(record);
+        }
+        else
+        {
+            result.rejected++;
+        }
+    }
+}
+
+// *****************************************************************************
+// Output
+// *****************************************************************************
+
+bool Write(FILE* file, const void* data, size_t size)
+{
+    return (size == 0U) || (std::fwrite(data, 1, size, file) == size);
+}
+
+template <typename T>
+bool WriteValue(FILE* file, T value)
+{
+    return Write(file, &value, sizeof(value));
+}
+
+bool HeaderWrite(FILE* file)
+{
+    bool isWritten = Write(file, "HDCCOL01", 8) && WriteValue<uint32_t>(file, COLUMNS) && WriteValue<uint32_t>(file, 0);
+
+    for (const ColumnInfo& column : columnInfo)
+    {
+        char name[16] = { 0 };
+
+        std::strncpy(name, column.name, sizeof(name) - 1U);
+        isWritten = isWritten && Write(file, name, sizeof(name)) &&
+                    WriteValue<uint32_t>(file, column.type) && WriteValue<uint32_t>(file, column.size);
+    }
+
+    return isWritten;
+}
+
+bool RowGroupWrite(FILE* file, const Result& result)
+{
+    const uint32_t rows = static_cast<uint32_t>(result.times.size());
+    bool isWritten;
+
+    if (rows == 0U)
+    {
+        return true;
+    }
+
+    isWritten = Write(file, "RGRP", 4) && WriteValue<uint32_t>(file, rows) &&
+                WriteValue<uint32_t>(file, result.logIndex) && WriteValue<uint32_t>(file, 0) &&
+                Write(file, result.times.data(), rows * sizeof(int64_t));
+
+    for (const std::vector<float>& values : result.values)
+    {
+        isWritten = isWritten && Write(file, values.data(), rows * sizeof(float));
+    }
+
+    return isWritten && Write(file, result.sequences.data(), rows * sizeof(uint32_t));
+}
+
+bool LogTableWrite(FILE* file, const std::vector<Log>& logs)
+{
+    const long offset = std::ftell(file);
+    bool isWritten = (offset >= 0) && WriteValue<uint32_t>(file, static_cast<uint32_t>(logs.size()));
+
+    for (const Log& log : logs)
+    {
+        const std::string name = fs::path(log.name).filename().string();
+
+        isWritten = isWritten && WriteValue<uint32_t>(file, static_cast<uint32_t>(name.size())) &&
+                    Write(file, name.data(), name.size());
+    }
+
+    return isWritten && WriteValue<uint64_t>(file, static_cast<uint64_t>(offset)) && Write(file, "HDCEND01", 8);
+}
+
+// *****************************************************************************
+// Commands
+// *****************************************************************************
+
+void LogsFind(const std::vector<std::string>& paths, std::vector<Log>& logs)
+{
+    std::vector<std::string> names;
+
+    for (const std::string& path : paths)
+    {
+        std::error_code error;
+
+        if (fs::is_directory(path, error))
+        {
+            for (const fs::directory_entry& entry : fs::recursive_directory_iterator(path, error))
+            {
+                const std::string name = entry.path().filename().string();
+
+                if (entry.is_regular_file() && (name.rfind("data_", 0) == 0) &&
+                    (entry.path().extension() == ".txt"))
+                {
+                    names.push_back(entry.path().string());
+                }
+            }
+        }
+        else
+        {
+            names.push_back(path);
+        }
+    }
+
+    std::sort(names.begin(), names.end());
+
+    for (const std::string& name : names)
+    {
+        Log log;
+
+        log.name = name;
+        logs.push_back(log);
+    }
+}
+
+int Ingest(const Options& options, const std::vector<std::string>& paths)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Log> logs;
+    std::vector<Chunk> chunks;
+    uint64_t bytes = 0;
+
+    LogsFind(paths, logs);
+
+    for (uint32_t i = 0; i < logs.size(); i++)
+    {
+        if (!LogOpen(logs[i]))
+        {
+            return 1;
+        }
+        bytes += logs[i].size;
+        ChunksMake(logs[i], i, chunks);
+    }
+
+    FILE* file = std::fopen(options.output.c_str(), "wb");
+
+    if ((file == nullptr) || !HeaderWrite(file))
+    {
+        std::fprintf(stderr, "%s: %s\n", options.output.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    /* Workers parse chunks in order and the results are written in the same
+     * order. A worker waits while it is too far ahead of the writer, which
+     * bounds the memory to a few chunks per thread. */
+    const unsigned threads = (options.threads > 0U) ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    const size_t window = static_cast<size_t>(threads) * 4U;
+    std::vector<std::unique_ptr<Result>> results(chunks.size());
+    std::atomic<size_t> nextChunk { 0 };
+    std::mutex mutex;
+    std::condition_variable resultReady;
+    std::condition_variable chunkWritten;
+    size_t writtenCount = 0;
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&]()
+        {
+            while (true)
+            {
+                const size_t index = nextChunk.fetch_add(1);
+
+                if (index >= chunks.size())
+                {
+                    return;
+                }
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    chunkWritten.wait(lock, [&]() { return index < (writtenCount + window); });
+                }
+
+                std::unique_ptr<Result> result(new Result());
+                ChunkParse(logs[chunks[index].logIndex], chunks[index], options.isCrcChecked, *result);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results[index] = std::move(result);
+                }
+                resultReady.notify_all();
+            }
+        });
+    }
+
+    uint64_t rows = 0;
+    uint64_t rejected = 0;
+    bool isWritten = true;
+
+    for (size_t index = 0; index < chunks.size(); index++)
+    {
+        std::unique_ptr<Result> result;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            resultReady.wait(lock, [&]() { return results[index] != nullptr; });
+            result = std::move(results[index]);
+        }
+
+        rows += result->times.size();
+        rejected += result->rejected;
+        isWritten = isWritten && RowGroupWrite(file, *result);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writtenCount = index + 1U;
+        }
+        chunkWritten.notify_all();
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    isWritten = isWritten && LogTableWrite(file, logs);
+    isWritten = (std::fclose(file) == 0) && isWritten;
+
+    for (const Log& log : logs)
+    {
+        if (log.data != nullptr)
+        {
+            munmap(const_cast<char*>(log.data), log.size);
+        }
+    }
+
+    if (!isWritten)
+    {
+        std::fprintf(stderr, "%s: write failed\n", options.output.c_str());
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%zu logs, %.1f MB, %llu records, %llu lines rejected, %u threads\n", logs.size(), bytes / 1e6,
+                static_cast<unsigned long long>(rows), static_cast<unsigned long long>(rejected), threads);
+    std::printf("%.3f s, %.2f GB/s, %.1f M records/s\n", seconds, (bytes / 1e9) / seconds, (rows / 1e6) / seconds);
+
+    return 0;
+}
+
+/* Synthetic logs in the format of the firmware: header, 7 values and a seal,
+ * a sample every 5 s with slowly varying values */
+int Generate(const std::string& directory, uint64_t megabytes, unsigned logCount)
+{
+    const uint64_t logSize = (megabytes * 1000000U) / logCount;
+    std::error_code error;
+    int64_t timeMs = DaysFromCivil(2026, 1, 1) * 86400000LL;
+    uint32_t seed = 12345U;
+
+    fs::create_directories(directory, error);
+
+    for (unsigned n = 0; n < logCount; n++)
+    {
+        const uint32_t session = n + 1U;
+        std::string text(LOG_HEADER_LEN, ' ');
+        char line[LOG_RECORD_LEN];
+        char name[64];
+        uint32_t sequence = 0;
+
+        text.reserve(logSize + LOG_RECORD_LEN);
+
+        while (text.size() < logSize)
+        {
+            const int64_t seconds = timeMs / 1000;
+            const int64_t days = seconds / 86400;
+            const int secondOfDay = static_cast<int>(seconds % 86400);
+            /* Civil date from days, inverse of DaysFromCivil */
+            const int64_t z = days + 719468;
+            const int64_t era = z / 146097;
+            const int64_t doe = z - (era * 146097);
+            const int64_t yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+            const int64_t doy = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+            const int64_t mp = ((5 * doy) + 2) / 153;
+            const int day = static_cast<int>(doy - (((153 * mp) + 2) / 5) + 1);
+            const int month = static_cast<int>((mp < 10) ? (mp + 3) : (mp - 9));
+            const int year = static_cast<int>(yoe + (era * 400) + ((month <= 2) ? 1 : 0));
+
+            seed = (seed * 1103515245U) + 12345U;
+            const double phase = static_cast<double>(secondOfDay) / 86400.0 * 6.283185307;
+            const double temperature = 12.0 + (8.0 * std::sin(phase)) + ((seed >> 16) % 100) / 1000.0;
+            const double pressure = 1013.25 + (5.0 * std::cos(phase / 7.0));
+            const double humidity = 60.0 - (20.0 * std::sin(phase));
+
+            int length = std::snprintf(line, sizeof(line),
+                                       "[%04d/%02d/%02d %02d:%02d:%02d.%03d] %6.2f %7.2f %5.1f %6.2f %6.2f %8.2f %7.2f",
+                                       year, month, day, secondOfDay / 3600, (secondOfDay / 60) % 60, secondOfDay % 60,
+                                       static_cast<int>(timeMs % 1000), temperature, pressure, humidity,
+                                       temperature - ((100.0 - humidity) / 5.0), humidity / 6.0, 110.88, pressure);
+            length += std::snprintf(&line[length], sizeof(line) - static_cast<size_t>(length), " *%08X",
+                                    static_cast<unsigned>(sequence++));
+            length += std::snprintf(&line[length], sizeof(line) - static_cast<size_t>(length), " %04X\r\n",
+                                    static_cast<unsigned>(RecordCrc(session, line, static_cast<size_t>(length))));
+
+            text.append(line, static_cast<size_t>(length));
+            timeMs += 5000;
+        }
+
+        std::snprintf(line, sizeof(line), "#LOG len=%010lu s=%08lX\r\n", static_cast<unsigned long>(text.size()),
+                      static_cast<unsigned long>(session));
+        text.replace(0, LOG_HEADER_LEN, line, LOG_HEADER_LEN);
+
+        std::snprintf(name, sizeof(name), "data_%06u.txt", n);
+        FILE* file = std::fopen((fs::path(directory) / name).string().c_str(), "wb");
+
+        if ((file == nullptr) || !Write(file, text.data(), text.size()) || (std::fclose(file) != 0))
+        {
+            std::fprintf(stderr, "%s: %s\n", name, std::strerror(errno));
+            return 1;
+        }
+    }
+
+    std::printf("%u logs, %llu MB written to %s\n", logCount, static_cast<unsigned long long>(megabytes),
+                directory.c_str());
+    return 0;
+}
+
+int Usage()
+{
+    std::fprintf(stderr,
+                 "usage: log_ingest [-j threads] [-o out.col] [--no-crc] <log or dir>...\n"
+                 "       log_ingest generate <dir> <megabytes> [logs]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::vector<std::string> paths;
+
+    if ((argc >= 4) && (std::strcmp(argv[1], "generate") == 0))
+    {
+        const uint64_t megabytes = std::strtoull(argv[3], nullptr, 10);
+        const unsigned logCount = (argc >= 5) ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 16U;
+
+        if ((megabytes == 0U) || (logCount == 0U))
+        {
+            return Usage();
+        }
+        return Generate(argv[2], megabytes, logCount);
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((std::strcmp(argv[i], "-j") == 0) && ((i + 1) < argc))
+        {
+            options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((std::strcmp(argv[i], "-o") == 0) && ((i + 1) < argc))
+        {
+            options.output = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--no-crc") == 0)
+        {
+            options.isCrcChecked = false;
+        }
+        else if (argv[i][0] == '-')
+        {
+            return Usage();
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.empty())
+    {
+        return Usage();
+    }
+
+    return Ingest(options, paths);
+}
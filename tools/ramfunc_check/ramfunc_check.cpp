@@ -0,0 +1,475 @@
+/*******************************************************************************
+  RAMFUNC Placement Check
+
+  File Name:
+    ramfunc_check.cpp
+
+  Summary:
+    Lists the functions the firmware runs from SRAM and checks that every
+    function marked RAMFUNC is among them.
+
+  Description:
+    Reads the map file of the XC32 build and lists the .ramfunc input
+    sections the linker placed, with the functions they hold, sorted by
+    address: address, size, function and object file, then the total. The
+    ATSAME54P20A is a Cortex-M4 without TCM, so RAMFUNC places functions
+    in SRAM (toolchain_specifics.h).
+
+    The sources given are then scanned for the functions marked RAMFUNC,
+    and each one is checked against the map:
+
+        SRAM        a .ramfunc section in SRAM holds it
+        static      a static function, which the map does not name; its
+                    object file has a .ramfunc section in SRAM
+        flash       the map places it outside SRAM
+        missing     the map does not have it, nor its object file in a
+                    .ramfunc section in SRAM
+
+    The map is read in the GNU ld layout, where an input section line that
+    is too long carries its address and size on the next line. A section
+    named .ramfunc.<name>, as with -ffunction-sections, also names its
+    function. A function's size runs to the next function of its section.
+
+    Build:
+
+        c++ -O2 -std=c++17 -o ramfunc_check ramfunc_check.cpp
+
+    Use, after building the MPLAB X project, from the firmware directory:
+
+        ramfunc_check [--ram origin:length]
+            HDC_weather_click_darren_wenn.X/dist/default/production/
+            HDC_weather_click_darren_wenn.X.production.map src
+
+    The exit status is 0 when every RAMFUNC function is in SRAM, 1 when
+    one is not, or when the map has no .ramfunc section at all, as after a
+    build with RAMFUNC_DISABLE, and 2 when a file cannot be read. The
+    default SRAM is that of ATSAME54P20A.ld, 256 KB at 0x20000000.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+/* RAM region of ATSAME54P20A.ld */
+constexpr uint64_t    RAM_ORIGIN = 0x20000000U;
+constexpr uint64_t    RAM_LENGTH = 0x40000U;
+
+constexpr const char  RAMFUNC_SECTION[] = ".ramfunc";
+
+struct Section
+{
+    std::string name;
+    std::string object;
+    uint64_t    address = 0;
+    uint64_t    size = 0;
+};
+
+struct Function
+{
+    std::string name;
+    std::string object;
+    uint64_t    address = 0;
+    uint64_t    size = 0;
+};
+
+struct Marked
+{
+    std::string name;
+    std::string source;
+    bool        isStatic = false;
+};
+
+struct Map
+{
+    std::vector<Section>  sections;
+    std::vector<Function> functions;
+
+    /* Every global symbol of the map, to tell flash from missing */
+    std::vector<Function> symbols;
+};
+
+bool IsRamfunc(const std::string& section)
+{
+    const size_t length = std::strlen(RAMFUNC_SECTION);
+
+    return (section.compare(0, length, RAMFUNC_SECTION) == 0) &&
+           ((section.size() == length) || (section[length] == '.'));
+}
+
+bool IsIdentifier(const std::string& text)
+{
+    if (text.empty() || (!std::isalpha(static_cast<unsigned char>(text[0])) && (text[0] != '_')))
+    {
+        return false;
+    }
+
+    return std::all_of(text.begin(), text.end(), [](char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || (c == '_');
+    });
+}
+
+std::string ObjectName(const std::string& path)
+{
+    return fs::path(path).filename().string();
+}
+
+bool Read(const std::string& path, std::string* text)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream stream;
+
+    if (!file)
+    {
+        return false;
+    }
+
+    stream << file.rdbuf();
+    *text = stream.str();
+    return true;
+}
+
+/* Sections and symbols of the memory map. An input section line starts with
+ * a space and its name; a symbol line is an address and a name. The sections
+ * the linker discarded are listed before the memory map, and skipped. */
+Map MapParse(const std::string& text)
+{
+    constexpr const char MEMORY_MAP[] = "Linker script and memory map";
+    const size_t start = text.find(MEMORY_MAP);
+    std::istringstream stream((start == std::string::npos) ? text : text.substr(start));
+    std::string line;
+    std::string pending;
+    size_t current = SIZE_MAX;
+    Map map;
+
+    while (std::getline(stream, line))
+    {
+        std::istringstream fields(line);
+        std::vector<std::string> tokens;
+        std::string token;
+
+        if (!line.empty() && (line.back() == '\r'))
+        {
+            line.pop_back();
+        }
+
+        while (fields >> token)
+        {
+            tokens.push_back(token);
+        }
+
+        if (!pending.empty())
+        {
+            /* The address and size of a long section name follow it */
+            tokens.insert(tokens.begin(), pending);
+            pending.clear();
+        }
+        else if (line.empty() || (line[0] != ' '))
+        {
+            current = SIZE_MAX;
+            continue;
+        }
+
+        if (tokens.empty())
+        {
+            continue;
+        }
+
+        if (tokens[0][0] == '.')
+        {
+            current = SIZE_MAX;
+
+            if (tokens.size() == 1U)
+            {
+                pending = tokens[0];
+            }
+            else if (IsRamfunc(tokens[0]) && (tokens.size() >= 4U))
+            {
+                Section section;
+
+                section.name = tokens[0];
+                section.address = std::strtoull(tokens[1].c_str(), nullptr, 16);
+                section.size = std::strtoull(tokens[2].c_str(), nullptr, 16);
+                section.object = ObjectName(tokens[3]);
+
+                if (section.size != 0U)
+                {
+                    current = map.sections.size();
+                    map.sections.push_back(section);
+
+                    if (section.name.size() > std::strlen(RAMFUNC_SECTION))
+                    {
+                        Function function;
+
+                        function.name = section.name.substr(std::strlen(RAMFUNC_SECTION) + 1U);
+                        function.object = section.object;
+                        function.address = section.address;
+                        map.functions.push_back(function);
+                    }
+                }
+            }
+        }
+        else if ((tokens.size() == 2U) && (tokens[0].compare(0, 2, "0x") == 0) && IsIdentifier(tokens[1]))
+        {
+            Function symbol;
+
+            symbol.name = tokens[1];
+            symbol.address = std::strtoull(tokens[0].c_str(), nullptr, 16);
+
+            if ((current != SIZE_MAX) && (symbol.address >= map.sections[current].address) &&
+                (symbol.address < (map.sections[current].address + map.sections[current].size)))
+            {
+                symbol.object = map.sections[current].object;
+
+                /* Named by its section already */
+                if (map.functions.empty() || (map.functions.back().name != symbol.name))
+                {
+                    map.functions.push_back(symbol);
+                }
+            }
+
+            map.symbols.push_back(symbol);
+        }
+    }
+
+    /* Code at the start of a section that no symbol names is static */
+    for (const Section& section : map.sections)
+    {
+        if (std::none_of(map.functions.begin(), map.functions.end(), [&](const Function& function)
+        {
+            return function.address == section.address;
+        }))
+        {
+            Function function;
+
+            function.name = "(static)";
+            function.object = section.object;
+            function.address = section.address;
+            map.functions.push_back(function);
+        }
+    }
+
+    /* Each function runs to the next one in its section, or to its end */
+    std::sort(map.functions.begin(), map.functions.end(), [](const Function& a, const Function& b)
+    {
+        return a.address < b.address;
+    });
+
+    for (size_t i = 0; i < map.functions.size(); i++)
+    {
+        Function& function = map.functions[i];
+
+        for (const Section& section : map.sections)
+        {
+            const uint64_t end = section.address + section.size;
+
+            if ((function.address >= section.address) && (function.address < end))
+            {
+                const bool isLast = ((i + 1U) == map.functions.size()) || (map.functions[i + 1U].address >= end);
+
+                function.size = (isLast ? end : map.functions[i + 1U].address) - function.address;
+            }
+        }
+    }
+
+    return map;
+}
+
+/* Functions defined with RAMFUNC in the C sources under path */
+void SourceScan(const fs::path& path, std::vector<Marked>* marked)
+{
+    static const std::regex definition(R"((^|\n)([^\n#]*)\bRAMFUNC\s+(\w+)\s*\()");
+    std::string text;
+
+    if (fs::is_directory(path))
+    {
+        std::vector<fs::path> files;
+
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator(path))
+        {
+            if (entry.is_regular_file() && (entry.path().extension() == ".c"))
+            {
+                files.push_back(entry.path());
+            }
+        }
+
+        std::sort(files.begin(), files.end());
+
+        for (const fs::path& file : files)
+        {
+            SourceScan(file, marked);
+        }
+        return;
+    }
+
+    if (!Read(path.string(), &text))
+    {
+        return;
+    }
+
+    for (std::sregex_iterator match(text.begin(), text.end(), definition), end; match != end; ++match)
+    {
+        Marked function;
+
+        function.name = (*match)[3].str();
+        function.source = path.filename().string();
+        function.isStatic = std::regex_search((*match)[2].str(), std::regex(R"(\bstatic\b)"));
+        marked->push_back(function);
+    }
+}
+
+bool IsInRam(uint64_t address, uint64_t origin, uint64_t length)
+{
+    return (address >= origin) && (address < (origin + length));
+}
+
+int Usage()
+{
+    std::fprintf(stderr, "usage: ramfunc_check [--ram origin:length] <map file> [<source or dir>...]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint64_t ramOrigin = RAM_ORIGIN;
+    uint64_t ramLength = RAM_LENGTH;
+    std::vector<std::string> paths;
+    std::vector<Marked> marked;
+    std::string text;
+    uint64_t total = 0;
+    int failures = 0;
+    int misplaced = 0;
+    Map map;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((std::strcmp(argv[i], "--ram") == 0) && ((i + 1) < argc))
+        {
+            char* end = nullptr;
+
+            ramOrigin = std::strtoull(argv[++i], &end, 0);
+            if (*end != ':')
+            {
+                return Usage();
+            }
+            ramLength = std::strtoull(end + 1, nullptr, 0);
+        }
+        else if (argv[i][0] == '-')
+        {
+            return Usage();
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.empty())
+    {
+        return Usage();
+    }
+
+    if (!Read(paths[0], &text))
+    {
+        std::fprintf(stderr, "ramfunc_check: cannot read %s\n", paths[0].c_str());
+        return 2;
+    }
+
+    map = MapParse(text);
+
+    std::printf("%-10s %6s  %-40s %s\n", "address", "bytes", "function", "object");
+
+    for (const Function& function : map.functions)
+    {
+        std::printf("0x%08llx %6llu  %-40s %s\n", static_cast<unsigned long long>(function.address),
+                    static_cast<unsigned long long>(function.size), function.name.c_str(), function.object.c_str());
+    }
+
+    for (const Section& section : map.sections)
+    {
+        total += section.size;
+
+        if (!IsInRam(section.address, ramOrigin, ramLength))
+        {
+            std::printf("%s of %s at 0x%08llx is outside SRAM\n", section.name.c_str(), section.object.c_str(),
+                        static_cast<unsigned long long>(section.address));
+            failures++;
+        }
+    }
+
+    std::printf("%zu sections, %llu bytes\n", map.sections.size(), static_cast<unsigned long long>(total));
+
+    if (map.sections.empty())
+    {
+        std::printf("no .ramfunc section: built with RAMFUNC_DISABLE?\n");
+        failures++;
+    }
+
+    for (size_t i = 1; i < paths.size(); i++)
+    {
+        SourceScan(paths[i], &marked);
+    }
+
+    for (const Marked& function : marked)
+    {
+        const std::string object = fs::path(function.source).stem().string() + ".o";
+        const char* placement = "missing";
+
+        auto named = std::find_if(map.symbols.begin(), map.symbols.end(), [&](const Function& symbol)
+        {
+            return symbol.name == function.name;
+        });
+        auto listed = std::find_if(map.functions.begin(), map.functions.end(), [&](const Function& f)
+        {
+            return f.name == function.name;
+        });
+
+        if (listed != map.functions.end())
+        {
+            placement = IsInRam(listed->address, ramOrigin, ramLength) ? "SRAM" : "flash";
+        }
+        else if (named != map.symbols.end())
+        {
+            placement = IsInRam(named->address, ramOrigin, ramLength) ? "SRAM" : "flash";
+        }
+        else if (function.isStatic &&
+                 std::any_of(map.sections.begin(), map.sections.end(), [&](const Section& section)
+                 {
+                     return (section.object == object) && IsInRam(section.address, ramOrigin, ramLength);
+                 }))
+        {
+            placement = "static";
+        }
+
+        if ((std::strcmp(placement, "SRAM") != 0) && (std::strcmp(placement, "static") != 0))
+        {
+            misplaced++;
+        }
+
+        std::printf("%-8s %-40s %s\n", placement, function.name.c_str(), function.source.c_str());
+    }
+
+    if (!marked.empty())
+    {
+        std::printf("%zu RAMFUNC functions, %d not in SRAM\n", marked.size(), misplaced);
+    }
+
+    return ((failures + misplaced) == 0) ? 0 : 1;
+}